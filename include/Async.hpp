@@ -0,0 +1,323 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_ASYNC_HPP
+#define REMODEL_ASYNC_HPP
+
+/**
+ * @file
+ * @brief Contains asynchronous reads of remote objects, batched per tick.
+ *
+ * `AsyncReader` collects reads requested by many independent tasks and submits all of them with
+ * one `MemoryBackend::readBatch` call (a single `process_vm_readv` with `ProcessMemory`) on each
+ * `tick`, then reports completion. With C++20 coroutines, the reads are awaitable:
+ * @code
+ *     AsyncTask visit(AsyncReader& reader, RemoteSnapshot<Dog>& dog)
+ *     {
+ *         auto age = co_await asyncLoad(reader, dog, &Dog::age);
+ *         if (age.hasValue()) { ... }
+ *     }
+ *
+ *     // I/O thread
+ *     while (reader.pending()) reader.tick();
+ * @endcode
+ * A few threads running ticks can thus keep thousands of traversals in flight, each of them
+ * written as straight-line code. Without coroutine support, `AsyncReader::enqueue` takes plain
+ * completion callbacks.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Memory.hpp"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#   include <coroutine>
+#   include <exception>
+#   define REMODEL_HAS_COROUTINES
+#endif
+
+namespace remodel
+{
+
+// ============================================================================================== //
+// [AsyncReader]                                                                                  //
+// ============================================================================================== //
+
+/**
+ * @brief   Queues reads from a memory backend and performs them in batches.
+ *
+ * Reads can be queued from any thread. `tick` takes all reads queued so far, reads them in one
+ * batch and invokes their completions on the calling thread; reads queued by completions go into
+ * the next tick. If the batch fails as a whole, e.g. because one of the addresses isn't mapped,
+ * the reads are retried one by one, so a single bad pointer doesn't fail the others.
+ */
+class AsyncReader : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   The completion callback, invoked with the context passed to `enqueue` and whether
+     *          the read succeeded.
+     */
+    using Completion = void (*)(void* context, bool success);
+private:
+    struct Request
+    {
+        platform::IoRange range;
+        Completion completion;
+        void* context;
+    };
+
+    MemoryBackend* m_memory;
+    mutable std::mutex m_mutex;
+    std::vector<Request> m_pending;
+    std::vector<Request> m_current;
+    std::vector<platform::IoRange> m_ranges;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   memory  The memory backend to read from.
+     */
+    explicit AsyncReader(MemoryBackend& memory)
+        : m_memory{&memory}
+    {}
+
+    /**
+     * @brief   Queues a read.
+     * @param   address     The address to read from, in the address space of the backend.
+     * @param   buffer      The buffer to read to, required to stay valid until completion.
+     * @param   size        The number of bytes to read.
+     * @param   completion  The callback to invoke once the read is done.
+     * @param   context     Passed to @c completion.
+     */
+    void enqueue(uintptr_t address, void* buffer, std::size_t size, Completion completion,
+        void* context)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_pending.push_back({{address, buffer, size}, completion, context});
+    }
+
+    /**
+     * @brief   Gets the number of reads queued for the next tick.
+     * @return  The number of reads.
+     */
+    std::size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_pending.size();
+    }
+
+    /**
+     * @brief   Performs all reads queued so far and invokes their completions.
+     * @return  The number of reads completed.
+     *
+     * Not to be called concurrently with itself.
+     */
+    std::size_t tick()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_current.clear();
+            m_current.swap(m_pending);
+        }
+        if (m_current.empty()) return 0;
+
+        m_ranges.clear();
+        m_ranges.reserve(m_current.size());
+        for (const auto& cur : m_current) m_ranges.push_back(cur.range);
+
+        // Completions may resume coroutines that queue new reads, which land in `m_pending`.
+        const auto count = m_current.size();
+        if (m_memory->readBatch(m_ranges.data(), m_ranges.size()))
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                m_current[i].completion(m_current[i].context, true);
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto& range = m_current[i].range;
+                const bool success = m_memory->read(range.address, range.buffer, range.size);
+                m_current[i].completion(m_current[i].context, success);
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief   Gets the memory backend used.
+     * @return  The memory backend.
+     */
+    MemoryBackend& memory() const { return *m_memory; }
+};
+
+#if defined(REMODEL_HAS_COROUTINES)
+
+// ============================================================================================== //
+// Coroutine support                                                                              //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [AsyncTask]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A minimal coroutine type for fire-and-forget tasks awaiting reads.
+ *
+ * The coroutine starts running right away and is destroyed when it finishes. Any coroutine type
+ * of an application can await the reads just as well.
+ */
+struct AsyncTask
+{
+    struct promise_type
+    {
+        AsyncTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [asyncRead] + [asyncLoad]                                                                      //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Awaitable read of a range, see `asyncRead`.
+ */
+class ReadAwaiter
+{
+    AsyncReader* m_reader;
+    platform::IoRange m_range;
+    std::coroutine_handle<> m_handle;
+    bool m_success = false;
+
+    static void complete(void* context, bool success)
+    {
+        auto self = static_cast<ReadAwaiter*>(context);
+        self->m_success = success;
+        self->m_handle.resume();
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   reader  The reader to queue the read in.
+     * @param   range   The range to read.
+     */
+    ReadAwaiter(AsyncReader& reader, platform::IoRange range)
+        : m_reader{&reader}
+        , m_range{range}
+    {}
+
+    bool await_ready() const noexcept { return !m_range.size; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+        m_reader->enqueue(m_range.address, m_range.buffer, m_range.size, &complete, this);
+    }
+
+    bool await_resume() const noexcept { return !m_range.size || m_success; }
+};
+
+/**
+ * @brief   Reads a range in the next tick of a reader.
+ * @param   reader  The reader.
+ * @param   address The address to read from, in the address space of the backend.
+ * @param   buffer  The buffer to read to.
+ * @param   size    The number of bytes to read.
+ * @return  An awaitable yielding @c true on success, else @c false.
+ */
+inline ReadAwaiter asyncRead(AsyncReader& reader, uintptr_t address, void* buffer,
+    std::size_t size)
+{
+    return {reader, {address, buffer, size}};
+}
+
+/**
+ * @brief   Awaitable read of a field of a remote object, see `asyncLoad`.
+ */
+template<typename WrapperT, typename FieldPtrT>
+class LoadAwaiter : public ReadAwaiter
+{
+    using Traits = internal::LoadTraitsOf<internal::FieldOf<WrapperT, FieldPtrT>>;
+
+    RemoteSnapshot<WrapperT>* m_snap;
+    FieldPtrT m_field;
+
+    static platform::IoRange rangeOf(RemoteSnapshot<WrapperT>& snap, FieldPtrT field)
+    {
+        auto obj = (snap.*field).addressOfObj();
+        auto offset = reinterpret_cast<uintptr_t>(obj)
+            - reinterpret_cast<uintptr_t>(snap.addressOfObj());
+        return {snap.source() + offset, const_cast<void*>(static_cast<const void*>(obj)),
+            sizeof(*obj)};
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   reader  The reader to queue the read in.
+     * @param   snap    The snapshot to read the field into.
+     * @param   field   Pointer to the field.
+     */
+    LoadAwaiter(AsyncReader& reader, RemoteSnapshot<WrapperT>& snap, FieldPtrT field)
+        : ReadAwaiter{reader, rangeOf(snap, field)}
+        , m_snap{std::addressof(snap)}
+        , m_field{field}
+    {}
+
+    zycore::Optional<typename Traits::Type> await_resume() const
+    {
+        if (!ReadAwaiter::await_resume()) return zycore::kEmpty;
+        return {zycore::kInPlace, Traits::load(*m_snap.*m_field)};
+    }
+};
+
+/**
+ * @brief   Reads a field of a remote object in the next tick of a reader.
+ * @param   reader  The reader.
+ * @param   snap    The snapshot to read the field into, its other fields are left untouched.
+ * @param   field   Pointer to the field, e.g. `&Dog::age`.
+ * @return  An awaitable yielding the value as with `load`, or nothing if the read failed.
+ */
+template<typename WrapperT, typename FieldPtrT>
+inline LoadAwaiter<WrapperT, FieldPtrT> asyncLoad(
+    AsyncReader& reader, RemoteSnapshot<WrapperT>& snap, FieldPtrT field)
+{
+    return {reader, snap, field};
+}
+
+#endif // REMODEL_HAS_COROUTINES
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_ASYNC_HPP
@@ -0,0 +1,286 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_CACHELINES_HPP
+#define REMODEL_CACHELINES_HPP
+
+/**
+ * @file
+ * @brief Contains the cache line report of layouts declared with `REMODEL_FIELDS`.
+ *
+ * `analyzeCacheLines` lists which fields of a wrapper share cache lines and which cross line
+ * boundaries. Fed with access counts, e.g. from the `REMODEL_PROFILE` counters or from traces of
+ * production runs, it also ranks the lines by the accesses touching them, the ones worth reading
+ * together, prefetching or keeping in a `Shadow`:
+ * @code
+ *     auto report = analyzeCacheLines<Dog>();
+ *     report.addProfile(profile::collect(), "Dog");
+ *     for (auto line : report.hottest()) ...
+ *     std::cout << report.toText();
+ * @endcode
+ * The same information is available at compile time via `Layout::At<idx>::firstLine()`,
+ * `lastLine()` and `Layout::numCrossingFields()`.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "remodel/Field.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [CacheLineReport]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A line of a wrapped object and the fields covering it.
+ */
+struct CacheLine
+{
+    /**
+     * @brief   The index of the line, the line starts at `index * lineSize` in the object.
+     */
+    std::size_t index;
+    /**
+     * @brief   The fields covering (parts of) the line, in declaration order.
+     */
+    std::vector<FieldInfo> fields;
+    /**
+     * @brief   The number of accesses touching the line, as added to the report.
+     */
+    uint64_t accesses;
+};
+
+/**
+ * @brief   Cache line layout of the fields of a class, see `analyzeCacheLines`.
+ *
+ * Lines are relative to the start of the object, so the report assumes objects aligned to the
+ * line size. Lines no field covers are only listed once accesses were added for them.
+ */
+class CacheLineReport
+{
+    std::size_t m_lineSize;
+    std::vector<FieldInfo> m_fields;
+    std::vector<FieldInfo> m_crossing;
+    // Sorted by index.
+    std::vector<CacheLine> m_lines;
+private:
+    CacheLine& lineAt(std::size_t index)
+    {
+        auto it = std::lower_bound(m_lines.begin(), m_lines.end(), index,
+            [](const CacheLine& line, std::size_t idx) { return line.index < idx; });
+        if (it == m_lines.end() || it->index != index)
+        {
+            it = m_lines.insert(it, CacheLine{index, {}, 0});
+        }
+        return *it;
+    }
+
+    std::size_t firstLine(const FieldInfo& field) const
+    {
+        return static_cast<std::size_t>(field.offset) / m_lineSize;
+    }
+
+    std::size_t lastLine(const FieldInfo& field) const
+    {
+        const auto end = static_cast<std::size_t>(field.offset) + field.size;
+        return (field.size ? end - 1 : end) / m_lineSize;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   fields      The fields, e.g. as returned by `fieldInfos()`. Fields at negative
+     *                      offsets are ignored.
+     * @param   numFields   The number of fields.
+     * @param   lineSize    The size of the lines, in bytes.
+     */
+    CacheLineReport(
+        const FieldInfo* fields, std::size_t numFields, std::size_t lineSize = simd::kCacheLineSize)
+        : m_lineSize{lineSize}
+    {
+        for (std::size_t i = 0; i < numFields; ++i)
+        {
+            const auto& field = fields[i];
+            if (field.offset < 0) continue;
+
+            m_fields.push_back(field);
+            if (firstLine(field) != lastLine(field)) m_crossing.push_back(field);
+            for (auto line = firstLine(field); line <= lastLine(field); ++line)
+            {
+                lineAt(line).fields.push_back(field);
+            }
+        }
+    }
+
+    /**
+     * @brief   Gets the size of the lines.
+     * @return  The size, in bytes.
+     */
+    std::size_t lineSize() const { return m_lineSize; }
+
+    /**
+     * @brief   Gets the lines covered by fields or touched by accesses.
+     * @return  The lines, ordered by index.
+     */
+    const std::vector<CacheLine>& lines() const { return m_lines; }
+
+    /**
+     * @brief   Gets the fields crossing line boundaries, each of their accesses touches two lines.
+     * @return  The fields, in declaration order.
+     */
+    const std::vector<FieldInfo>& crossing() const { return m_crossing; }
+
+    /**
+     * @brief   Gets the lines shared by multiple fields.
+     * @return  The lines, ordered by index.
+     */
+    std::vector<const CacheLine*> shared() const
+    {
+        std::vector<const CacheLine*> result;
+        for (const auto& line : m_lines)
+        {
+            if (line.fields.size() > 1) result.push_back(&line);
+        }
+        return result;
+    }
+
+    /**
+     * @brief   Adds accesses of the object.
+     * @param   offset  The accessed offset. Accesses of declared fields touch all lines of the
+     *                  field, others just the line of the offset.
+     * @param   count   The number of accesses.
+     * @return  @c false if the offset is negative and the accesses were dropped, else @c true.
+     */
+    bool addAccesses(std::ptrdiff_t offset, uint64_t count)
+    {
+        if (offset < 0) return false;
+
+        for (const auto& field : m_fields)
+        {
+            if (field.offset <= offset
+                && static_cast<std::size_t>(offset - field.offset) < field.size)
+            {
+                for (auto line = firstLine(field); line <= lastLine(field); ++line)
+                {
+                    lineAt(line).accesses += count;
+                }
+                return true;
+            }
+        }
+
+        lineAt(static_cast<std::size_t>(offset) / m_lineSize).accesses += count;
+        return true;
+    }
+
+#   if defined(REMODEL_PROFILE)
+    /**
+     * @brief   Adds the field accesses counted by the `REMODEL_PROFILE` mode.
+     * @param   entries The counters, as returned by `profile::collect`.
+     * @param   wrapper The type name of the wrapper to add the accesses of.
+     * @return  The number of accesses added.
+     */
+    uint64_t addProfile(const std::vector<profile::Entry>& entries, const std::string& wrapper)
+    {
+        uint64_t added = 0;
+        for (const auto& entry : entries)
+        {
+            if (entry.kind != profile::AccessKind::Field || entry.wrapper != wrapper) continue;
+            if (addAccesses(entry.offset, entry.count)) added += entry.count;
+        }
+        return added;
+    }
+#   endif
+
+    /**
+     * @brief   Gets the lines touched by accesses, hottest first.
+     * @return  The lines with accesses, ordered by the number of accesses.
+     */
+    std::vector<const CacheLine*> hottest() const
+    {
+        std::vector<const CacheLine*> result;
+        for (const auto& line : m_lines)
+        {
+            if (line.accesses) result.push_back(&line);
+        }
+        auto hotter = [](const CacheLine* lhs, const CacheLine* rhs) {
+            return lhs->accesses > rhs->accesses;
+        };
+        std::stable_sort(result.begin(), result.end(), hotter);
+        return result;
+    }
+
+    /**
+     * @brief   Formats the report as text, a line per cache line.
+     * @return  The report, e.g. `line 0 +0x0: race age* (12 accesses)`, where `*` marks fields
+     *          crossing line boundaries.
+     */
+    std::string toText() const
+    {
+        std::string text;
+        char buffer[64];
+        for (const auto& line : m_lines)
+        {
+            std::snprintf(buffer, sizeof(buffer), "line %zu +0x%zx:",
+                line.index, line.index * m_lineSize);
+            text += buffer;
+            for (const auto& field : line.fields)
+            {
+                text += ' ';
+                text += field.name;
+                if (firstLine(field) != lastLine(field)) text += '*';
+            }
+            if (line.accesses)
+            {
+                std::snprintf(buffer, sizeof(buffer), " (%llu accesses)",
+                    static_cast<unsigned long long>(line.accesses));
+                text += buffer;
+            }
+            text += '\n';
+        }
+        return text;
+    }
+};
+
+/**
+ * @brief   Creates the cache line report of a class declared with `REMODEL_FIELDS`.
+ * @tparam  WrapperT    The wrapper or class view.
+ * @param   lineSize    The size of the lines, in bytes, e.g. 4096 for pages.
+ * @return  The report.
+ */
+template<typename WrapperT>
+inline CacheLineReport analyzeCacheLines(std::size_t lineSize = simd::kCacheLineSize)
+{
+    return CacheLineReport{WrapperT::fieldInfos(), WrapperT::Layout::kNumFields, lineSize};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_CACHELINES_HPP
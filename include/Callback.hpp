@@ -0,0 +1,509 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_CALLBACK_HPP
+#define REMODEL_CALLBACK_HPP
+
+/**     
+ * @file
+ * @brief Contains machine code thunks passing capturing function objects as C callbacks.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "Platform.hpp"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#   define REMODEL_CALLBACK_X64
+#endif
+#if defined(REMODEL_CALLBACK_X64) || defined(_M_IX86) || defined(__i386__)
+#   define REMODEL_CALLBACK_SUPPORTED
+#endif
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [ThunkArena]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Pool of fixed size executable slots for callback thunks.
+ *          
+ * Blocks are allocated on demand and never released. Free slots form an intrusive list, so 
+ * acquiring and releasing a slot takes constant time and never touches the memory mappings.
+ */
+class ThunkArena : public zycore::NonCopyable
+{
+    static const std::size_t kBlockSize = 64 * 1024;
+
+    std::mutex m_mutex;
+    uint8_t* m_free = nullptr;
+
+    static uint8_t*& nextOf(uint8_t* slot) { return *reinterpret_cast<uint8_t**>(slot); }
+public:
+    /**
+     * @brief   The size of a slot, in bytes.
+     */
+    static const std::size_t kSlotSize = 192;
+
+    /**
+     * @brief   Gets the arena shared by all callbacks.
+     * @return  The arena.
+     */
+    static ThunkArena& global()
+    {
+        static ThunkArena arena;
+        return arena;
+    }
+
+    /**
+     * @brief   Acquires a slot.
+     * @return  A slot filled with `int3` or @c nullptr if no memory could be allocated.
+     */
+    uint8_t* acquire()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_free)
+        {
+            auto block = static_cast<uint8_t*>(platform::allocateCode(kBlockSize));
+            if (!block) return nullptr;
+            std::memset(block, 0xCC, kBlockSize);
+            for (std::size_t offset = kBlockSize / kSlotSize * kSlotSize; offset;)
+            {
+                offset -= kSlotSize;
+                nextOf(block + offset) = m_free;
+                m_free = block + offset;
+            }
+        }
+
+        auto slot = m_free;
+        m_free = nextOf(slot);
+        std::memset(slot, 0xCC, sizeof(uintptr_t));
+        return slot;
+    }
+
+    /**
+     * @brief   Releases a slot acquired with `acquire`.
+     * @param   slot    The slot.
+     */
+    void release(uint8_t* slot)
+    {
+        std::memset(slot, 0xCC, kSlotSize);
+        std::lock_guard<std::mutex> lock{m_mutex};
+        nextOf(slot) = m_free;
+        m_free = slot;
+    }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [Thunk code]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Gets the closure of the callback invoked last on the calling thread.
+ * @return  The closure.
+ *          
+ * Set by the thunks right before jumping to the invoker, which reads it before doing anything 
+ * else. Neither can be interrupted by another callback on the same thread, except by one 
+ * invoked from a signal handler.
+ */
+inline void*& currentClosure()
+{
+    static REMODEL_THREAD_LOCAL void* closure = nullptr;
+    return closure;
+}
+
+/**
+ * @internal
+ * @brief   Sets the closure read by the invoker, called from the thunks.
+ * @param   closure The closure.
+ */
+inline void setCurrentClosure(void* closure)
+{
+    currentClosure() = closure;
+}
+
+/**
+ * @internal
+ * @brief   Determines whether any of the types may be passed in vector registers.
+ * @tparam  ArgsT   The parameter types.
+ *          
+ * Everything but integers, enums, pointers and references counts, which errs on the side of 
+ * saving registers for class types passed in general purpose registers.
+ */
+template<typename... ArgsT>
+struct UsesVectorRegisters : std::false_type {};
+
+template<typename ArgT, typename... ArgsT>
+struct UsesVectorRegisters<ArgT, ArgsT...> 
+    : std::integral_constant<bool, 
+        !(std::is_integral<ArgT>::value || std::is_enum<ArgT>::value 
+            || std::is_pointer<ArgT>::value || std::is_reference<ArgT>::value)
+        || UsesVectorRegisters<ArgsT...>::value> 
+{};
+
+/**
+ * @internal
+ * @brief   Sequential writer for machine code.
+ */
+class CodeWriter
+{
+    uint8_t* m_cur;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   code    The first byte to write.
+     */
+    explicit CodeWriter(uint8_t* code) : m_cur{code} {}
+
+    /**
+     * @brief   Writes bytes.
+     * @param   bytes   The bytes.
+     * @return  This writer.
+     */
+    CodeWriter& operator () (std::initializer_list<uint8_t> bytes)
+    {
+        for (auto byte : bytes) *m_cur++ = byte;
+        return *this;
+    }
+
+    /**
+     * @brief   Writes a pointer sized immediate.
+     * @param   value   The value.
+     * @return  This writer.
+     */
+    CodeWriter& imm(uintptr_t value)
+    {
+        std::memcpy(m_cur, &value, sizeof(value));
+        m_cur += sizeof(value);
+        return *this;
+    }
+
+    /**
+     * @brief   Writes `movdqu` instructions saving or restoring consecutive `xmm` registers.
+     * @param   opcode  0x7F to store the registers to the stack, 0x6F to load them.
+     * @param   count   The number of registers, starting at `xmm0`.
+     * @param   offset  The offset of the first register's save area from the stack pointer.
+     * @return  This writer.
+     */
+    CodeWriter& vectors(uint8_t opcode, unsigned count, uint8_t offset)
+    {
+        for (unsigned i = 0; i < count; ++i, offset += 16)
+        {
+            const auto reg = static_cast<uint8_t>(i << 3);
+            if (offset)
+            {
+                (*this)({0xF3, 0x0F, opcode, static_cast<uint8_t>(0x44 | reg), 0x24, offset});
+            }
+            else
+            {
+                (*this)({0xF3, 0x0F, opcode, static_cast<uint8_t>(0x04 | reg), 0x24});
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief   Gets the position of the next byte.
+     * @return  The position.
+     */
+    uint8_t* cur() const { return m_cur; }
+};
+
+/**
+ * @internal
+ * @brief   Writes a thunk handing a closure to an invoker.
+ * @param   code            The slot to write to, `ThunkArena::kSlotSize` bytes.
+ * @param   closure         The closure.
+ * @param   invoker         The address of the invoker taking the callback's arguments.
+ * @param   saveVectors     If @c true, the vector argument registers are preserved as well.
+ * @return  The size of the thunk, in bytes.
+ *          
+ * The thunk saves the argument registers, passes @c closure to `setCurrentClosure`, restores the 
+ * registers and jumps to @c invoker with the stack left as the caller set it up, so any calling 
+ * convention without vector registers works unchanged.
+ */
+inline std::size_t emitThunk(uint8_t* code, void* closure, uintptr_t invoker, bool saveVectors)
+{
+    CodeWriter w{code};
+    const auto setter = reinterpret_cast<uintptr_t>(&setCurrentClosure);
+    const auto context = reinterpret_cast<uintptr_t>(closure);
+
+#   if defined(REMODEL_CALLBACK_X64) && defined(_WIN64)
+        // Microsoft x64: rcx, rdx, r8, r9, xmm0-3. Reserve the shadow space for the setter and 
+        // keep the stack 16 byte aligned.
+        const uint8_t frame = saveVectors ? 0x68 : 0x28;
+        w({0x51, 0x52, 0x41, 0x50, 0x41, 0x51});                // push rcx/rdx/r8/r9
+        w({0x48, 0x83, 0xEC, frame});                           // sub rsp, frame
+        if (saveVectors) w.vectors(0x7F, 4, 0x20);              // movdqu [rsp+...], xmm0-3
+        w({0x48, 0xB9}).imm(context);                           // mov rcx, closure
+        w({0x48, 0xB8}).imm(setter);                            // mov rax, setter
+        w({0xFF, 0xD0});                                        // call rax
+        if (saveVectors) w.vectors(0x6F, 4, 0x20);              // movdqu xmm0-3, [rsp+...]
+        w({0x48, 0x83, 0xC4, frame});                           // add rsp, frame
+        w({0x41, 0x59, 0x41, 0x58, 0x5A, 0x59});                // pop r9/r8/rdx/rcx
+        w({0x49, 0xBB}).imm(invoker);                           // mov r11, invoker
+        w({0x41, 0xFF, 0xE3});                                  // jmp r11
+#   elif defined(REMODEL_CALLBACK_X64)
+        // System V: rdi, rsi, rdx, rcx, r8, r9, xmm0-7 and al for variadic calls. Seven pushes 
+        // restore the 16 byte alignment the caller had.
+        w({0x57, 0x56, 0x52, 0x51, 0x41, 0x50, 0x41, 0x51, 0x50}); // push rdi/.../r9/rax
+        if (saveVectors)
+        {
+            w({0x48, 0x81, 0xEC, 0x80, 0x00, 0x00, 0x00});      // sub rsp, 0x80
+            w.vectors(0x7F, 8, 0);                              // movdqu [rsp+...], xmm0-7
+        }
+        w({0x48, 0xBF}).imm(context);                           // mov rdi, closure
+        w({0x48, 0xB8}).imm(setter);                            // mov rax, setter
+        w({0xFF, 0xD0});                                        // call rax
+        if (saveVectors)
+        {
+            w.vectors(0x6F, 8, 0);                              // movdqu xmm0-7, [rsp+...]
+            w({0x48, 0x81, 0xC4, 0x80, 0x00, 0x00, 0x00});      // add rsp, 0x80
+        }
+        w({0x58, 0x41, 0x59, 0x41, 0x58, 0x59, 0x5A, 0x5E, 0x5F}); // pop rax/r9/.../rdi
+        w({0x49, 0xBB}).imm(invoker);                           // mov r11, invoker
+        w({0x41, 0xFF, 0xE3});                                  // jmp r11
+#   else
+        // x86: arguments are on the stack except for ecx and edx with fastcall and thiscall. 
+        // Three pushes keep the stack 16 byte aligned for the call.
+        (void)saveVectors;
+        w({0x51, 0x52});                                        // push ecx/edx
+        w({0x68}).imm(context);                                 // push closure
+        w({0xB8}).imm(setter);                                  // mov eax, setter
+        w({0xFF, 0xD0});                                        // call eax
+        w({0x83, 0xC4, 0x04});                                  // add esp, 4
+        w({0x5A, 0x59});                                        // pop edx/ecx
+        w({0xB8}).imm(invoker);                                 // mov eax, invoker
+        w({0xFF, 0xE0});                                        // jmp eax
+#   endif
+
+    return static_cast<std::size_t>(w.cur() - code);
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [Callback]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Static function with the callback's signature calling the current closure.
+ * @tparam  T       The function pointer type of the callback.
+ * @tparam  FuncT   The type of the function object.
+ */
+template<typename T, typename FuncT>
+struct CallbackInvoker;
+
+#define REMODEL_DEF_CALLBACK_INVOKER(callingConv)                                                  \
+    template<typename FuncT, typename RetT, typename... ArgsT>                                     \
+    struct CallbackInvoker<RetT (callingConv*)(ArgsT...), FuncT>                                   \
+    {                                                                                              \
+        static const bool kUsesVectorRegisters = UsesVectorRegisters<ArgsT...>::value;             \
+                                                                                                   \
+        static RetT callingConv invoke(ArgsT... args)                                              \
+        {                                                                                          \
+            return (*static_cast<FuncT*>(currentClosure()))(std::forward<ArgsT>(args)...);         \
+        }                                                                                          \
+    }
+
+// `__thiscall` is reserved for member functions and `__vectorcall` passes arguments in more 
+// vector registers than the thunks preserve, so neither is supported.
+#ifdef ZYCORE_MSVC
+    REMODEL_DEF_CALLBACK_INVOKER(__cdecl);
+    REMODEL_DEF_CALLBACK_INVOKER(__stdcall);
+    REMODEL_DEF_CALLBACK_INVOKER(__fastcall);
+#elif defined(ZYCORE_GNUC)
+#   if defined(__i386__)
+    REMODEL_DEF_CALLBACK_INVOKER(__attribute__((cdecl)));
+    REMODEL_DEF_CALLBACK_INVOKER(__attribute__((stdcall)));
+    REMODEL_DEF_CALLBACK_INVOKER(__attribute__((fastcall)));
+#   else
+    REMODEL_DEF_CALLBACK_INVOKER();
+#   endif
+#endif
+
+#undef REMODEL_DEF_CALLBACK_INVOKER
+
+} // namespace internal
+
+/**
+ * @brief   Function object callable through a plain function pointer.
+ * @tparam  T   The function pointer type of the callback, e.g. `void (__cdecl*)(Horse::Weak*)`.
+ *          
+ * Each callback owns a small machine code thunk from a pooled executable arena that makes its 
+ * function object available to a static invoker and jumps there, so APIs taking only a function 
+ * pointer can be given per call context without global state.
+ *              
+ * @code
+ *     int numOld = 0;
+ *     auto visitor = makeCallback<Stable::HorseVisitor>([&](Horse::Weak* horse) {
+ *         if (horse->toStrong().age > 20) ++numOld;
+ *     });
+ *     stable.traverseHorses(visitor.get());
+ * @endcode
+ * 
+ * The thunk is only valid while the callback lives. Only x86 and x86-64 are supported, 
+ * callbacks taking arguments in vector registers with `__vectorcall` are not.
+ */
+template<typename T>
+class Callback
+{
+    uint8_t* m_thunk = nullptr;
+    void* m_closure = nullptr;
+    void (*m_destroy)(void*) = nullptr;
+
+    template<typename FuncT>
+    static void destroy(void* closure)
+    {
+        delete static_cast<FuncT*>(closure);
+    }
+public:
+    /**
+     * @brief   Default constructor, creates an invalid callback.
+     */
+    Callback() {}
+
+    /**
+     * @brief   Constructor.
+     * @param   func    The function object, which is moved into the callback.
+     */
+    template<typename FuncT, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<FuncT>::type, Callback>::value>::type>
+    explicit Callback(FuncT func)
+    {
+#       if defined(REMODEL_CALLBACK_SUPPORTED)
+            using InvokerT = internal::CallbackInvoker<T, FuncT>;
+            m_thunk = internal::ThunkArena::global().acquire();
+            if (!m_thunk) return;
+            m_closure = new FuncT(std::move(func));
+            m_destroy = &destroy<FuncT>;
+            auto size = internal::emitThunk(m_thunk, m_closure, 
+                reinterpret_cast<uintptr_t>(&InvokerT::invoke), InvokerT::kUsesVectorRegisters);
+            platform::flushCode(m_thunk, size);
+#       else
+            (void)func;
+#       endif
+    }
+
+    /**
+     * @brief   Move constructor.
+     * @param   other   The callback to take over, invalid afterwards.
+     */
+    Callback(Callback&& other)
+        : m_thunk{other.m_thunk}
+        , m_closure{other.m_closure}
+        , m_destroy{other.m_destroy}
+    {
+        other.m_thunk = nullptr;
+        other.m_closure = nullptr;
+        other.m_destroy = nullptr;
+    }
+
+    /**
+     * @brief   Move assignment operator.
+     * @param   other   The callback to take over, invalid afterwards.
+     * @return  This instance.
+     */
+    Callback& operator = (Callback&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            std::swap(m_thunk, other.m_thunk);
+            std::swap(m_closure, other.m_closure);
+            std::swap(m_destroy, other.m_destroy);
+        }
+        return *this;
+    }
+
+    Callback(const Callback&) = delete;
+    Callback& operator = (const Callback&) = delete;
+
+    /**
+     * @brief   Destructor, releases the thunk and the function object.
+     */
+    ~Callback() { reset(); }
+
+    /**
+     * @brief   Releases the thunk and the function object, making the callback invalid.
+     */
+    void reset()
+    {
+        if (!m_thunk) return;
+        internal::ThunkArena::global().release(m_thunk);
+        m_destroy(m_closure);
+        m_thunk = nullptr;
+        m_closure = nullptr;
+        m_destroy = nullptr;
+    }
+
+    /**
+     * @brief   Determines whether the callback has a thunk.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_thunk != nullptr; }
+
+    /**
+     * @brief   Gets the function pointer calling the function object.
+     * @return  The thunk or @c nullptr if the callback is invalid.
+     */
+    T get() const { return reinterpret_cast<T>(m_thunk); }
+};
+
+/**
+ * @brief   Creates a callback calling a function object.
+ * @tparam  T       The function pointer type of the callback.
+ * @param   func    The function object, e.g. a capturing lambda.
+ * @return  The callback.
+ */
+template<typename T, typename FuncT>
+Callback<T> makeCallback(FuncT&& func)
+{
+    return Callback<T>{typename std::decay<FuncT>::type{std::forward<FuncT>(func)}};
+}
+
+} // namespace remodel
+
+#endif // REMODEL_CALLBACK_HPP
@@ -0,0 +1,403 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_CODECACHE_HPP
+#define REMODEL_CODECACHE_HPP
+
+/**
+ * @file
+ * @brief Contains a host-wide cache of the read-only sections of modules of other processes.
+ *
+ * Attaching to many instances of the same binary would read and scan the same code pages again
+ * for every instance. `CodeCache` stores each section once per host, in files shared by all
+ * processes using the same directory and kept between runs, and serves them as read-only
+ * mappings. Combined with a `SignatureCache` keyed by the same identity, a binary is scanned
+ * once per host:
+ * @code
+ *     CodeCache code{"/var/cache/mytool"};
+ *     SignatureCache signatures{identity};
+ *     signatures.load(path);
+ *     std::vector<uintptr_t> results;
+ *     code.resolve(signatures, process, base, textSections, patterns, results);
+ *     signatures.save(path);
+ * @endcode
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Memory.hpp"
+#include "Pattern.hpp"
+#include "Platform.hpp"
+#include "SignatureCache.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [CodeCache]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Content-addressed, persistent cache of read-only module sections.
+ *
+ * Sections are looked up by the identity of their module (see `platform::obtainModuleIdentity`,
+ * e.g. the GNU build-id) and their location relative to the module base, so they are found for
+ * every process running the same build, wherever the module is loaded. The bytes are stored by
+ * their hash, so equal sections of different keys share a file. In the cache directory:
+ * @code
+ *  <identity>-<rva>-<size>.key     // uint64_t hash of the contents
+ *  <hash>.bin                      // the contents
+ * @endcode
+ * Files are written to temporary files first and then renamed, so processes sharing the
+ * directory never observe partially written files. Loaded sections are verified against their
+ * hash and mapped copy-on-write, so untouched pages are shared with the other processes mapping
+ * them. Only sections that never change, i.e. code and constants, may be cached.
+ *
+ * Instances are thread-safe. Sections stay valid as long as references to them are held, even
+ * beyond the lifetime of the cache.
+ */
+class CodeCache : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   A cached section, mapped into memory.
+     */
+    class Section : public zycore::NonCopyable
+    {
+        platform::MappedFile m_file;
+        std::vector<uint8_t> m_data;
+        uint64_t m_hash;
+    public:
+        /**
+         * @brief   Constructor.
+         * @param   file    The mapped file holding the contents, unmapped on destruction.
+         * @param   hash    The hash of the contents.
+         */
+        Section(platform::MappedFile file, uint64_t hash)
+            : m_file(file)
+            , m_hash{hash}
+        {}
+
+        /**
+         * @brief   Constructor for sections that couldn't be stored in the directory.
+         * @param   data    The contents.
+         * @param   hash    The hash of the contents.
+         */
+        Section(std::vector<uint8_t> data, uint64_t hash)
+            : m_data(std::move(data))
+            , m_hash{hash}
+        {}
+
+        /**
+         * @brief   Destructor.
+         */
+        ~Section()
+        {
+            platform::unmapFile(m_file);
+        }
+
+        /**
+         * @brief   Gets the contents of the section.
+         * @return  The first byte.
+         */
+        const uint8_t* data() const
+        {
+            return m_file.data ? static_cast<const uint8_t*>(m_file.data) : m_data.data();
+        }
+
+        /**
+         * @brief   Gets the size of the section.
+         * @return  The size, in bytes.
+         */
+        std::size_t size() const { return m_file.data ? m_file.size : m_data.size(); }
+
+        /**
+         * @brief   Gets the hash of the contents, the key of the contents in the cache.
+         * @return  The hash, FNV-1a.
+         */
+        uint64_t hash() const { return m_hash; }
+    };
+
+    /**
+     * @brief   Cache statistics.
+     */
+    struct Stats
+    {
+        /**
+         * @brief   Sections already loaded by this cache.
+         */
+        std::size_t hits = 0;
+        /**
+         * @brief   Sections loaded from the directory, e.g. cached by other processes.
+         */
+        std::size_t loads = 0;
+        /**
+         * @brief   Sections read from the target, as they weren't cached yet.
+         */
+        std::size_t reads = 0;
+    };
+private:
+    std::string m_directory;
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::shared_ptr<const Section>> m_sections;
+    std::map<uint64_t, std::weak_ptr<const Section>> m_contents;
+    Stats m_stats;
+private:
+    static uint64_t hashOf(const uint8_t* data, std::size_t size)
+    {
+        uint64_t hash = 0xCBF29CE484222325;
+        for (std::size_t i = 0; i < size; ++i) hash = (hash ^ data[i]) * 0x100000001B3;
+        return hash;
+    }
+
+    static std::string hex(uint64_t value)
+    {
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%llx", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    std::string keyOf(const std::vector<uint8_t>& identity, const platform::MemoryRegion& section)
+        const
+    {
+        std::string key;
+        char buffer[3];
+        for (auto cur : identity)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%02x", cur);
+            key += buffer;
+        }
+        return key + '-' + hex(section.address) + '-' + hex(section.size);
+    }
+
+    std::string pathOf(const std::string& name) const { return m_directory + '/' + name; }
+
+    /**
+     * @brief   Writes a file via a temporary file, replacing an existing one.
+     */
+    static bool writeFile(const std::string& path, const void* data, std::size_t size)
+    {
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            const auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#       else
+            const auto pid = static_cast<unsigned long>(getpid());
+#       endif
+        const auto tmpPath = path + ".tmp" + std::to_string(pid);
+        auto file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) return false;
+        const bool written = std::fwrite(data, 1, size, file) == size;
+        if (std::fclose(file) != 0 || !written)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            const bool replaced =
+                MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#       else
+            const bool replaced = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+#       endif
+        if (!replaced) std::remove(tmpPath.c_str());
+        return replaced;
+    }
+
+    /**
+     * @brief   Gets the mapped contents of a hash, from memory or the directory.
+     */
+    std::shared_ptr<const Section> loadContents(uint64_t hash, std::size_t size)
+    {
+        auto it = m_contents.find(hash);
+        if (it != m_contents.end())
+        {
+            if (auto section = it->second.lock()) return section;
+        }
+
+        auto file = platform::mapFile(pathOf(hex(hash) + ".bin").c_str());
+        if (!file.data) return nullptr;
+        auto section = std::make_shared<const Section>(file, hash);
+        if (section->size() != size || hashOf(section->data(), size) != hash) return nullptr;
+        m_contents[hash] = section;
+        return section;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   directory   The existing directory holding the cached sections, shared by all
+     *                      processes that should share sections.
+     */
+    explicit CodeCache(std::string directory)
+        : m_directory(std::move(directory))
+    {}
+
+    /**
+     * @brief   Gets a section of a module, reading it from the target only if not cached.
+     * @param   memory      The backend of the process the module is loaded in.
+     * @param   identity    The identity of the module, empty ones can't be cached.
+     * @param   base        The base address of the module in the process.
+     * @param   section     The section, `address` being relative to the module base.
+     * @return  The section, or @c nullptr if the module has no identity or reading the section
+     *          failed. Failing to store the section in the directory isn't fatal.
+     */
+    std::shared_ptr<const Section> obtain(MemoryBackend& memory,
+        const std::vector<uint8_t>& identity, uintptr_t base, const platform::MemoryRegion& section)
+    {
+        if (identity.empty()) return nullptr;
+
+        const auto key = keyOf(identity, section);
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto it = m_sections.find(key);
+        if (it != m_sections.end())
+        {
+            ++m_stats.hits;
+            return it->second;
+        }
+
+        // Cached by another process or an earlier run?
+        uint64_t hash;
+        if (auto file = std::fopen(pathOf(key + ".key").c_str(), "rb"))
+        {
+            const bool read = std::fread(&hash, sizeof(hash), 1, file) == 1;
+            std::fclose(file);
+            if (read)
+            {
+                if (auto cached = loadContents(hash, section.size))
+                {
+                    ++m_stats.loads;
+                    m_sections.emplace(key, cached);
+                    return cached;
+                }
+            }
+        }
+
+        std::vector<uint8_t> data(section.size);
+        if (!memory.read(base + section.address, data.data(), data.size())) return nullptr;
+        ++m_stats.reads;
+
+        hash = hashOf(data.data(), data.size());
+        auto cached = loadContents(hash, data.size());
+        if (!cached)
+        {
+            writeFile(pathOf(hex(hash) + ".bin"), data.data(), data.size());
+            cached = loadContents(hash, data.size());
+        }
+        if (cached)
+        {
+            writeFile(pathOf(key + ".key"), &hash, sizeof(hash));
+        }
+        else
+        {
+            // The directory isn't writable, keep the section to ourselves.
+            cached = std::make_shared<const Section>(std::move(data), hash);
+            m_contents[hash] = cached;
+        }
+        m_sections.emplace(key, cached);
+        return cached;
+    }
+
+    /**
+     * @brief   Searches sections of a module for a set of patterns, using the cached sections.
+     * @param   memory      The backend of the process the module is loaded in.
+     * @param   identity    The identity of the module.
+     * @param   base        The base address of the module in the process.
+     * @param   sections    The sections to search, relative to the module base.
+     * @param   patterns    The patterns.
+     * @param   results     Receives the address of the first match of every pattern in the
+     *                      process, or @c 0 if not found, indexed like the patterns.
+     * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+     * @return  @c true if all sections could be obtained, else @c false.
+     */
+    bool findPatterns(MemoryBackend& memory, const std::vector<uint8_t>& identity,
+        uintptr_t base, const std::vector<platform::MemoryRegion>& sections,
+        const PatternSet& patterns, std::vector<uintptr_t>& results, unsigned numThreads = 0)
+    {
+        std::vector<std::shared_ptr<const Section>> cached;
+        std::vector<platform::MemoryRegion> regions;
+        for (const auto& section : sections)
+        {
+            cached.push_back(obtain(memory, identity, base, section));
+            if (!cached.back()) return false;
+            regions.push_back(
+                {reinterpret_cast<uintptr_t>(cached.back()->data()), cached.back()->size()});
+        }
+
+        std::vector<const uint8_t*> matches;
+        patterns.find(regions.data(), regions.size(), matches, numThreads);
+        results.assign(patterns.size(), 0);
+        for (std::size_t i = 0; i < matches.size(); ++i)
+        {
+            if (!matches[i]) continue;
+            for (std::size_t j = 0; j < cached.size(); ++j)
+            {
+                const auto offset = static_cast<std::size_t>(matches[i] - cached[j]->data());
+                if (matches[i] >= cached[j]->data() && offset < cached[j]->size())
+                {
+                    results[i] = base + sections[j].address + offset;
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Resolves a set of patterns in a module of another process, searching the cached
+     *          sections for the patterns not in a `SignatureCache`.
+     * @param   signatures  The results of earlier searches, keyed by the identity of the module.
+     * @copydetails findPatterns
+     */
+    bool resolve(SignatureCache& signatures, MemoryBackend& memory, uintptr_t base,
+        const std::vector<platform::MemoryRegion>& sections, const PatternSet& patterns,
+        std::vector<uintptr_t>& results, unsigned numThreads = 0)
+    {
+        return signatures.resolve(base, patterns, results,
+            [&](const PatternSet& missing, std::vector<uintptr_t>& matches)
+            {
+                return findPatterns(memory, signatures.identity(), base, sections, missing,
+                    matches, numThreads);
+            });
+    }
+
+    /**
+     * @brief   Gets the cache statistics.
+     * @return  The statistics.
+     */
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_stats;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_CODECACHE_HPP
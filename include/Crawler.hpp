@@ -0,0 +1,558 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_CRAWLER_HPP
+#define REMODEL_CRAWLER_HPP
+
+/**
+ * @file
+ * @brief Contains a parallel crawler following pointers through object graphs.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Memory.hpp"
+
+namespace remodel
+{
+
+namespace internal
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [ConcurrentAddressSet]                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Lock-free set of non-zero addresses with a fixed capacity.
+ *
+ * Open addressing with linear probing over twice as many slots as the capacity, claimed by CAS.
+ * Addresses can only be added, never removed, which is what keeps it simple.
+ */
+class ConcurrentAddressSet : public zycore::NonCopyable
+{
+    std::unique_ptr<std::atomic<uintptr_t>[]> m_slots;
+    std::size_t m_mask;
+    std::size_t m_capacity;
+    std::atomic<std::size_t> m_size{0};
+
+    static std::size_t hash(uintptr_t address)
+    {
+        // Finalizer of MurmurHash3, spreading the mostly aligned addresses.
+        uint64_t h = address;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
+    }
+public:
+    /**
+     * @brief   The result of `insert`.
+     */
+    enum class Insert
+    {
+        Added,
+        Present,
+        Full,
+    };
+
+    /**
+     * @brief   Constructor.
+     * @param   capacity    The maximum number of addresses.
+     */
+    explicit ConcurrentAddressSet(std::size_t capacity)
+        : m_capacity{capacity}
+    {
+        std::size_t numSlots = 16;
+        while (numSlots < capacity * 2) numSlots *= 2;
+        m_slots.reset(new std::atomic<uintptr_t>[numSlots]);
+        for (std::size_t i = 0; i < numSlots; ++i) m_slots[i].store(0, std::memory_order_relaxed);
+        m_mask = numSlots - 1;
+    }
+
+    /**
+     * @brief   Adds an address.
+     * @param   address The address, required to be non-zero.
+     * @return  Whether it was added, was present already or the set is full.
+     */
+    Insert insert(uintptr_t address)
+    {
+        for (auto i = hash(address) & m_mask;; i = (i + 1) & m_mask)
+        {
+            auto cur = m_slots[i].load(std::memory_order_acquire);
+            if (cur == address) return Insert::Present;
+            if (cur) continue;
+
+            if (m_size.fetch_add(1, std::memory_order_relaxed) >= m_capacity)
+            {
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                return Insert::Full;
+            }
+            if (m_slots[i].compare_exchange_strong(cur, address, std::memory_order_acq_rel))
+            {
+                return Insert::Added;
+            }
+            // Lost the slot to another thread, which may have added the same address.
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            if (cur == address) return Insert::Present;
+        }
+    }
+
+    /**
+     * @brief   Determines whether an address was added.
+     * @param   address The address.
+     * @return  @c true if present, else @c false.
+     */
+    bool contains(uintptr_t address) const
+    {
+        for (auto i = hash(address) & m_mask;; i = (i + 1) & m_mask)
+        {
+            auto cur = m_slots[i].load(std::memory_order_acquire);
+            if (cur == address) return address != 0;
+            if (!cur) return false;
+        }
+    }
+
+    /**
+     * @brief   Gets the number of addresses.
+     * @return  The number of addresses.
+     */
+    std::size_t size() const { return m_size.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @internal
+ * @brief   The object size of a wrapper type, 0 if unknown (not an `AdvancedClassWrapper`).
+ */
+template<typename WrapperT, typename = void>
+struct ObjSizeOf : std::integral_constant<std::size_t, 0> {};
+
+template<typename WrapperT>
+struct ObjSizeOf<WrapperT, typename WrapperT::IsAdvWrapper /* manual SFINAE */>
+    : std::integral_constant<std::size_t, WrapperT::kObjSize> {};
+
+/**
+ * @internal
+ * @brief   Gets a unique tag for a type, without RTTI.
+ */
+template<typename T>
+inline const void* typeTag()
+{
+    static const char tag = 0;
+    return &tag;
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [Crawler]                                                                                      //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Parallel traversal of object graphs, following pointers from a set of roots.
+ *
+ * Each wrapper type taking part gets a visitor via `on`, which is called with a wrapper for
+ * every object of that type reached and reports the outgoing pointers through an `Edges`
+ * instance:
+ * @code
+ *     Crawler crawler;
+ *     crawler.on<Dog>([](Dog& dog, Crawler::Edges& edges)
+ *     {
+ *         edges.follow<Dog>(dog.mother);
+ *         edges.follow<Flea>(dog.fleas);
+ *     });
+ *     crawler.on<Flea>([](Flea& flea, Crawler::Edges& edges) { ... });
+ *     crawler.addRoot<Dog>(firstDog);
+ *     auto reached = crawler.run();
+ * @endcode
+ *
+ * Every worker thread owns a queue of pending objects, working on its newest entries while idle
+ * workers steal the oldest ones of others, so wide graphs spread over all cores while deep
+ * chains stay on one. Visited objects are recorded in a lock-free set keyed by address, so every
+ * address is visited once, as the type it was first reached as.
+ *
+ * Given a `MemoryBackend`, objects are read into worker-local buffers instead, up to
+ * `kBatchSize` of them with a single `MemoryBackend::readBatch` call. The types then need a known
+ * size (`AdvancedClassWrapper`) and the backend has to allow concurrent reads (`ProcessMemory`
+ * does, `CachedMemory` doesn't). Objects that can't be read are skipped and counted.
+ *
+ * Visitors are called concurrently from all workers and have to synchronize shared state.
+ */
+class Crawler : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   The maximum number of objects a worker takes (and reads) at once.
+     */
+    static const std::size_t kBatchSize = 64;
+
+    class Edges;
+private:
+    struct Node
+    {
+        uintptr_t address;
+        uint32_t type;
+    };
+
+    struct Type
+    {
+        std::function<void (void* obj, Edges& edges)> visit;
+        std::size_t objSize;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Node> nodes;
+        // Keeps the queues of different workers off each other's cache lines.
+        uint8_t padding[simd::kCacheLineSize];
+    };
+
+    MemoryBackend* m_memory;
+    internal::ConcurrentAddressSet m_visited;
+    std::vector<Type> m_types;
+    std::unordered_map<const void*, uint32_t> m_typeIndex;
+    std::vector<Node> m_roots;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::atomic<std::size_t> m_outstanding{0};
+    std::atomic<std::size_t> m_failed{0};
+    std::atomic<bool> m_truncated{false};
+public:
+    /**
+     * @brief   Collects the outgoing pointers of a visited object.
+     */
+    class Edges
+    {
+        friend class Crawler;
+
+        Crawler* m_crawler;
+        Queue* m_queue;
+
+        Edges(Crawler& crawler, Queue& queue)
+            : m_crawler{&crawler}
+            , m_queue{&queue}
+        {}
+    public:
+        /**
+         * @brief   Adds an object to crawl.
+         * @tparam  WrapperT    The wrapper type of the object, required to be registered via `on`.
+         * @param   address     The address of the object, 0 is ignored.
+         * @return  @c true if the object is new and was queued, else @c false.
+         */
+        template<typename WrapperT>
+        bool add(uintptr_t address)
+        {
+            return m_crawler->push<WrapperT>(*m_queue, address);
+        }
+
+        /**
+         * @copydoc add(uintptr_t)
+         */
+        template<typename WrapperT>
+        bool add(const void* address)
+        {
+            return add<WrapperT>(reinterpret_cast<uintptr_t>(address));
+        }
+
+        /**
+         * @brief   Adds the object a pointer field points to.
+         * @tparam  WrapperT    The wrapper type of the object, required to be registered via `on`.
+         * @param   field       The pointer field.
+         * @return  @c true if the object is new and was queued, else @c false.
+         */
+        template<typename WrapperT, typename FieldT>
+        bool follow(const FieldT& field)
+        {
+            return add<WrapperT>(static_cast<const void*>(*field.addressOfObj()));
+        }
+    };
+
+    /**
+     * @brief   Constructor.
+     * @param   maxObjects  The maximum number of objects to visit, see `isTruncated`.
+     * @param   memory      The memory backend to read objects with or @c nullptr to access them
+     *                      in place.
+     */
+    explicit Crawler(std::size_t maxObjects = 1 << 20, MemoryBackend* memory = nullptr)
+        : m_memory{memory}
+        , m_visited{maxObjects}
+    {}
+
+    /**
+     * @brief   Registers the visitor of a wrapper type.
+     * @tparam  WrapperT    The wrapper type.
+     * @param   visit       Called as `visit(WrapperT&, Edges&)` for every object of the type.
+     * @return  @c true on success, @c false if objects are read with a backend and the size of
+     *          the type is unknown.
+     */
+    template<typename WrapperT, typename FuncT>
+    bool on(FuncT visit)
+    {
+        const auto objSize = internal::ObjSizeOf<WrapperT>::value;
+        if (m_memory && !objSize) return false;
+
+        Type type{[visit](void* obj, Edges& edges) mutable
+        {
+            auto wrapper = wrapper_cast<WrapperT>(obj);
+            visit(wrapper, edges);
+        }, objSize};
+
+        auto it = m_typeIndex.find(internal::typeTag<WrapperT>());
+        if (it != m_typeIndex.end())
+        {
+            m_types[it->second] = std::move(type);
+        }
+        else
+        {
+            const auto index = static_cast<uint32_t>(m_types.size());
+            m_typeIndex.emplace(internal::typeTag<WrapperT>(), index);
+            m_types.push_back(std::move(type));
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Adds an object to start crawling at.
+     * @tparam  WrapperT    The wrapper type of the object, required to be registered via `on`.
+     * @param   address     The address of the object.
+     * @return  @c true if the object is new, else @c false.
+     */
+    template<typename WrapperT>
+    bool addRoot(uintptr_t address)
+    {
+        auto type = typeOf<WrapperT>();
+        if (!address || type < 0 || !visit(address)) return false;
+        m_roots.push_back({address, static_cast<uint32_t>(type)});
+        return true;
+    }
+
+    /**
+     * @copydoc addRoot(uintptr_t)
+     */
+    template<typename WrapperT>
+    bool addRoot(const void* address)
+    {
+        return addRoot<WrapperT>(reinterpret_cast<uintptr_t>(address));
+    }
+
+    /**
+     * @brief   Crawls from all roots added since the last run.
+     * @param   numThreads  The number of threads, 0 to use the hardware concurrency. The calling
+     *                      thread is one of them.
+     * @return  The total number of objects reached so far, including earlier runs.
+     *
+     * Objects visited by earlier runs aren't visited again, so runs can be continued by adding
+     * further roots.
+     */
+    std::size_t run(unsigned numThreads = 0)
+    {
+        if (!numThreads) numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        m_queues.clear();
+        for (unsigned i = 0; i < numThreads; ++i) m_queues.emplace_back(new Queue);
+        for (std::size_t i = 0; i < m_roots.size(); ++i)
+        {
+            m_queues[i % numThreads]->nodes.push_back(m_roots[i]);
+        }
+        m_outstanding.store(m_roots.size());
+        m_roots.clear();
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < numThreads; ++i) threads.emplace_back([this, i] { work(i); });
+        work(0);
+        for (auto& cur : threads) cur.join();
+
+        return m_visited.size();
+    }
+
+    /**
+     * @brief   Determines whether an address was reached.
+     * @param   address The address.
+     * @return  @c true if reached, else @c false.
+     */
+    bool contains(uintptr_t address) const { return m_visited.contains(address); }
+
+    /**
+     * @brief   Gets the number of objects reached.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_visited.size(); }
+
+    /**
+     * @brief   Gets the number of objects that couldn't be read from the backend.
+     * @return  The number of objects.
+     */
+    std::size_t failed() const { return m_failed.load(); }
+
+    /**
+     * @brief   Determines whether objects were dropped because `maxObjects` was reached.
+     * @return  @c true if truncated, else @c false.
+     */
+    bool isTruncated() const { return m_truncated.load(); }
+private:
+    template<typename WrapperT>
+    int64_t typeOf() const
+    {
+        auto it = m_typeIndex.find(internal::typeTag<WrapperT>());
+        return it == m_typeIndex.end() ? -1 : it->second;
+    }
+
+    bool visit(uintptr_t address)
+    {
+        switch (m_visited.insert(address))
+        {
+            case internal::ConcurrentAddressSet::Insert::Added:
+                return true;
+            case internal::ConcurrentAddressSet::Insert::Full:
+                m_truncated.store(true);
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    template<typename WrapperT>
+    bool push(Queue& queue, uintptr_t address)
+    {
+        auto type = typeOf<WrapperT>();
+        if (!address || type < 0 || !visit(address)) return false;
+
+        // Counted before the current node is finished, so the count can't drop to 0 early.
+        m_outstanding.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.nodes.push_back({address, static_cast<uint32_t>(type)});
+        return true;
+    }
+
+    /**
+     * @brief   Takes the newest nodes of the own queue or else the oldest of another one.
+     */
+    void take(std::size_t self, std::vector<Node>& out)
+    {
+        {
+            auto& own = *m_queues[self];
+            std::lock_guard<std::mutex> lock{own.mutex};
+            while (!own.nodes.empty() && out.size() < kBatchSize)
+            {
+                out.push_back(own.nodes.back());
+                own.nodes.pop_back();
+            }
+        }
+        if (!out.empty()) return;
+
+        for (std::size_t i = 1; i < m_queues.size() && out.empty(); ++i)
+        {
+            auto& victim = *m_queues[(self + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock{victim.mutex};
+            // Half of the victim's nodes, so a single stolen subtree doesn't starve others.
+            const auto count = (std::min)((victim.nodes.size() + 1) / 2, std::size_t{kBatchSize});
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                out.push_back(victim.nodes.front());
+                victim.nodes.pop_front();
+            }
+        }
+    }
+
+    void work(std::size_t self)
+    {
+        Edges edges{*this, *m_queues[self]};
+        std::vector<Node> nodes;
+        std::vector<uint8_t> buffer;
+        std::vector<std::size_t> offsets;
+        std::vector<platform::IoRange> ranges;
+
+        for (;;)
+        {
+            nodes.clear();
+            take(self, nodes);
+            if (nodes.empty())
+            {
+                if (!m_outstanding.load()) return;
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (!m_memory)
+            {
+                for (const auto& cur : nodes)
+                {
+                    m_types[cur.type].visit(reinterpret_cast<void*>(cur.address), edges);
+                }
+            }
+            else
+            {
+                // Objects are placed 16 byte aligned, enough for all fundamental types.
+                offsets.clear();
+                std::size_t size = 0;
+                for (const auto& cur : nodes)
+                {
+                    offsets.push_back(size);
+                    size += (m_types[cur.type].objSize + 15) & ~std::size_t{15};
+                }
+                buffer.resize(size + 15);
+                auto base = reinterpret_cast<uint8_t*>(
+                    (reinterpret_cast<uintptr_t>(buffer.data()) + 15) & ~uintptr_t{15});
+
+                ranges.clear();
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                {
+                    ranges.push_back({
+                        nodes[i].address, base + offsets[i], m_types[nodes[i].type].objSize});
+                }
+
+                const bool batchRead = m_memory->readBatch(ranges.data(), ranges.size());
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                {
+                    const auto& range = ranges[i];
+                    if (!batchRead && !m_memory->read(range.address, range.buffer, range.size))
+                    {
+                        m_failed.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    m_types[nodes[i].type].visit(range.buffer, edges);
+                }
+            }
+
+            m_outstanding.fetch_sub(nodes.size());
+        }
+    }
+};
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_CRAWLER_HPP
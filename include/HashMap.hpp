@@ -0,0 +1,267 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_HASHMAP_HPP
+#define REMODEL_HASHMAP_HPP
+
+/**
+ * @file
+ * @brief Contains an adapter doing lookups in foreign hash tables.
+ *
+ * Instead of scanning every bucket of a target's hash table, the adapter hashes the key with the
+ * target's own hash function and only visits the entries of the matching bucket:
+ * @code
+ *     class Registry : public AdvancedClassWrapper<32>
+ *     {
+ *         REMODEL_ADV_WRAPPER(Registry)
+ *     public:
+ *         Field<Entity**> buckets   {this, 0x10};
+ *         Field<uint32_t> numBuckets{this, 0x18};
+ *     };
+ *
+ *     Function<uint32_t(__cdecl*)(const char*)> hashName{0x00401230};
+ *     auto entities = makeChainedHashMap<WrapEntity>(
+ *         registry.buckets, registry.numBuckets, offsetof(Entity, next), hashName,
+ *         [](WrapEntity& entity, const char* name) { return entity.name->ref() == name; });
+ *
+ *     if (auto player = entities.find("player")) player.value().health = 100;
+ * @endcode
+ *
+ * The bucket array and its size are read on every lookup, so the adapter stays valid when the
+ * target grows its table.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Remodel.hpp"
+
+namespace remodel
+{
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Probing policy of tables with buckets of singly linked entries.
+ *
+ * The bucket array holds pointers to the first entry of each bucket.
+ */
+struct ChainedProbe
+{
+    std::ptrdiff_t nextOffset;
+
+    template<typename EntryWrapperT, typename PredT>
+    void* find(void* table, std::size_t, std::size_t index, PredT pred) const
+    {
+        auto entry = static_cast<void**>(table)[index];
+        auto wrapper = wrapper_cast<EntryWrapperT>(entry);
+        for (; entry; entry = *reinterpret_cast<void**>(static_cast<uint8_t*>(entry) + nextOffset))
+        {
+            wrapper.rebind(entry);
+            if (pred(wrapper)) return entry;
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Probing policy of open addressing tables with entries stored inline, probed linearly.
+ * @tparam  EmptyT  The type of the predicate telling whether a slot is empty.
+ *
+ * Probing ends at the first empty slot or after visiting every slot once.
+ */
+template<typename EmptyT>
+struct LinearProbe
+{
+    EmptyT isEmpty;
+
+    template<typename EntryWrapperT, typename PredT>
+    void* find(void* table, std::size_t count, std::size_t index, PredT pred) const
+    {
+        auto wrapper = wrapper_cast<EntryWrapperT>(table);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto slot = static_cast<uint8_t*>(table) + index * EntryWrapperT::kObjSize;
+            wrapper.rebind(slot);
+            if (isEmpty(wrapper)) return nullptr;
+            if (pred(wrapper)) return slot;
+            if (++index == count) index = 0;
+        }
+        return nullptr;
+    }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [ForeignHashMap]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Lookup adapter for hash tables of the target.
+ * @tparam  EntryWrapperT   The wrapper type of the entries.
+ * @tparam  ProbeT          The probing policy, depending on the layout of the table.
+ * @tparam  HashT           The type of the hash function, e.g. a `Function` of the target.
+ *                          Reference types refer to the hash function rather than copying it.
+ * @tparam  EqualT          The type of the predicate comparing an entry to a key.
+ * @tparam  CountT          The type the target stores the number of buckets as.
+ *
+ * Buckets are selected by the hash modulo the number of buckets, which matches tables with
+ * power-of-two sizes masking the hash as well. Create instances with `makeChainedHashMap` or
+ * `makeOpenHashMap`.
+ */
+template<typename EntryWrapperT, typename ProbeT, typename HashT, typename EqualT,
+    typename CountT>
+class ForeignHashMap
+{
+    static_assert(std::is_integral<CountT>::value, "the number of buckets must be integral");
+
+    void* const* m_table;
+    const CountT* m_count;
+    ProbeT m_probe;
+    HashT m_hash;
+    EqualT m_equal;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   table   The raw pointer of the target's pointer to the bucket array.
+     * @param   count   The raw pointer of the target's number of buckets.
+     * @param   probe   The probing policy.
+     * @param   hash    The hash function.
+     * @param   equal   The predicate comparing an entry to a key.
+     */
+    ForeignHashMap(void* const* table, const CountT* count, ProbeT probe, HashT&& hash,
+            EqualT equal)
+        : m_table{table}
+        , m_count{count}
+        , m_probe(probe) // MSVC12 requires parentheses here
+        , m_hash(std::forward<HashT>(hash))
+        , m_equal(equal)
+    {}
+
+    /**
+     * @brief   Looks up an entry.
+     * @param   key The key to look up.
+     * @return  If found, a wrapper for the entry, else an empty optional.
+     */
+    template<typename KeyT>
+    zycore::Optional<EntryWrapperT> find(const KeyT& key) const
+    {
+        auto table = *m_table;
+        auto count = static_cast<std::size_t>(*m_count);
+        if (!table || !count) return zycore::kEmpty;
+
+        auto hash = static_cast<std::size_t>(m_hash(key));
+        auto index = count & (count - 1) ? hash % count : hash & (count - 1);
+        auto entry = m_probe.template find<EntryWrapperT>(table, count, index,
+            [&](EntryWrapperT& candidate) { return m_equal(candidate, key); });
+        if (!entry) return zycore::kEmpty;
+        return {zycore::kInPlace, wrapper_cast<EntryWrapperT>(entry)};
+    }
+
+    /**
+     * @brief   Determines whether the table contains an entry.
+     * @param   key The key to look up.
+     * @return  @c true if found, else @c false.
+     */
+    template<typename KeyT>
+    bool contains(const KeyT& key) const
+    {
+        return find(key).hasValue();
+    }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Gets the raw pointer of a pointer field as a pointer to a type-erased pointer.
+ * @param   field   The field.
+ * @return  The raw pointer.
+ */
+template<typename FieldT>
+inline void* const* addressOfPtrField(FieldT& field)
+{
+    static_assert(std::is_pointer<std::remove_pointer_t<decltype(field.addressOfObj())>>::value,
+        "the bucket array field must be a pointer");
+    return reinterpret_cast<void* const*>(field.addressOfObj());
+}
+
+} // namespace internal
+
+/**
+ * @brief   Creates an adapter for a hash table with buckets of singly linked entries.
+ * @tparam  EntryWrapperT   The wrapper type of the entries.
+ * @param   buckets         The target's field pointing to the array of bucket heads.
+ * @param   numBuckets      The target's field holding the number of buckets.
+ * @param   nextOffset      The offset of the pointer to the next entry inside of the entries.
+ * @param   hash            The hash function, called with the keys passed to `find`. Function
+ *                          wrappers aren't copyable and are only referenced, so they have to
+ *                          outlive the adapter.
+ * @param   equal           The predicate comparing an entry to a key.
+ * @return  The adapter.
+ */
+template<typename EntryWrapperT, typename BucketsT, typename CountT, typename CountGetterT,
+    typename HashT, typename EqualT>
+inline ForeignHashMap<EntryWrapperT, internal::ChainedProbe, HashT, EqualT, CountT>
+makeChainedHashMap(BucketsT& buckets, Field<CountT, CountGetterT>& numBuckets,
+    std::ptrdiff_t nextOffset, HashT&& hash, EqualT equal)
+{
+    return {internal::addressOfPtrField(buckets), numBuckets.addressOfObj(),
+        internal::ChainedProbe{nextOffset}, std::forward<HashT>(hash),
+        equal};
+}
+
+/**
+ * @brief   Creates an adapter for an open addressing hash table with inline entries.
+ * @tparam  EntryWrapperT   The wrapper type of the entries.
+ * @param   slots           The target's field pointing to the slot array.
+ * @param   numSlots        The target's field holding the number of slots.
+ * @param   hash            The hash function, called with the keys passed to `find`. Function
+ *                          wrappers aren't copyable and are only referenced, so they have to
+ *                          outlive the adapter.
+ * @param   equal           The predicate comparing an entry to a key.
+ * @param   isEmpty         The predicate telling whether a slot is empty. Tombstones of deleted
+ *                          entries must not be considered empty.
+ * @return  The adapter.
+ */
+template<typename EntryWrapperT, typename SlotsT, typename CountT, typename CountGetterT,
+    typename HashT, typename EqualT, typename EmptyT>
+inline ForeignHashMap<EntryWrapperT, internal::LinearProbe<EmptyT>, HashT, EqualT, CountT>
+makeOpenHashMap(SlotsT& slots, Field<CountT, CountGetterT>& numSlots, HashT&& hash,
+    EqualT equal, EmptyT isEmpty)
+{
+    return {internal::addressOfPtrField(slots), numSlots.addressOfObj(),
+        internal::LinearProbe<EmptyT>{isEmpty}, std::forward<HashT>(hash),
+        equal};
+}
+
+} // namespace remodel
+
+#endif // REMODEL_HASHMAP_HPP
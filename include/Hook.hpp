@@ -0,0 +1,1633 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_HOOK_HPP
+#define REMODEL_HOOK_HPP
+
+/**     
+ * @file
+ * @brief Contains inline function hooks (detours), import hooks and shadow vftables.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Platform.hpp"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#   define REMODEL_HOOK_X64
+#endif
+#if defined(REMODEL_HOOK_X64) || defined(_M_IX86) || defined(__i386__)
+#   define REMODEL_HOOK_SUPPORTED
+#endif
+
+namespace remodel
+{
+
+class HookTransaction;
+
+// ---------------------------------------------------------------------------------------------- //
+// [Instruction decoder]                                                                          //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   The maximum length of an x86 instruction, in bytes.
+ */
+const std::size_t kMaxInstructionLength = 15;
+
+/**
+ * @internal
+ * @brief   Properties of a decoded x86 instruction relevant for relocating it.
+ */
+struct Instruction
+{
+    /**
+     * @brief   Values that represent kinds of relative branches.
+     */
+    enum class Branch : uint8_t
+    {
+        None,
+        Jump,
+        Conditional,
+        Call,
+    };
+
+    /**
+     * @brief   The length of the instruction, in bytes.
+     */
+    std::size_t length = 0;
+    /**
+     * @brief   The offset of a RIP-relative 32 bit displacement, 0 if there is none.
+     */
+    std::size_t ripOffset = 0;
+    /**
+     * @brief   The kind of relative branch.
+     */
+    Branch branch = Branch::None;
+    /**
+     * @brief   The size of the branch displacement ending the instruction (1 or 4), if a branch.
+     */
+    std::size_t relSize = 0;
+    /**
+     * @brief   The condition code of conditional branches.
+     */
+    uint8_t condition = 0;
+    /**
+     * @brief   Whether execution never continues with the next instruction (jumps, returns).
+     */
+    bool terminates = false;
+};
+
+/**
+ * @internal
+ * @brief   Flags describing the operands of an opcode.
+ */
+enum : uint16_t
+{
+    kOpModRm    = 1 << 0,
+    kOpImm8     = 1 << 1,
+    kOpImm16    = 1 << 2,
+    /** 16 or 32 bit immediate, by operand size. */
+    kOpImmZ     = 1 << 3,
+    /** 16, 32 or 64 bit immediate, by operand size. */
+    kOpImmV     = 1 << 4,
+    /** Address sized memory offset. */
+    kOpMoffs    = 1 << 5,
+    kOpRel8     = 1 << 6,
+    kOpRel32    = 1 << 7,
+    /** `test` takes an immediate, the other instructions of the group don't. */
+    kOpGroup3   = 1 << 8,
+    /** `jmp` through memory terminates, `call` doesn't. */
+    kOpGroup5   = 1 << 9,
+    kOpStop     = 1 << 10,
+    /** Invalid in 64 bit mode. */
+    kOpNo64     = 1 << 11,
+    /** Unsupported, rare in function prologues. */
+    kOpBad      = 1 << 12,
+};
+
+/**
+ * @internal
+ * @brief   Decodes the length and branch properties of an x86 instruction.
+ * @param   code    The instruction.
+ * @param   insn    Receives the decoded properties.
+ * @return  @c true if decoded, @c false if the instruction isn't supported.
+ *          
+ * Covers the general purpose, x87, SSE and VEX encoded AVX instructions found in compiler
+ * generated code. Address size overrides, EVEX, 3DNow!, far branches and `loop`/`jcxz` are 
+ * rejected, as they can't be relocated or never show up in function prologues.
+ */
+inline bool decodeInstruction(const uint8_t* code, Instruction& insn)
+{
+    const uint16_t N  = 0;
+    const uint16_t M  = kOpModRm;
+    const uint16_t I  = kOpImm8;
+    const uint16_t MI = kOpModRm | kOpImm8;
+    const uint16_t Z  = kOpImmZ;
+    const uint16_t MZ = kOpModRm | kOpImmZ;
+    const uint16_t V  = kOpImmV;
+    const uint16_t A  = kOpMoffs;
+    const uint16_t R  = kOpRel8;
+    const uint16_t J  = kOpRel32;
+    const uint16_t S  = kOpStop;
+    const uint16_t O  = kOpNo64;
+    const uint16_t X  = kOpBad;
+    const uint16_t W  = kOpImm16;
+    const uint16_t T  = kOpModRm | kOpGroup3;
+    const uint16_t F  = kOpModRm | kOpGroup5;
+
+    static const uint16_t kOneByte[256] = {
+        M,    M,    M,    M,    I,    Z,    O,    O,    M,    M,    M,    M,    I,    Z,    O,    X,
+        M,    M,    M,    M,    I,    Z,    O,    O,    M,    M,    M,    M,    I,    Z,    O,    O,
+        M,    M,    M,    M,    I,    Z,    N,    O,    M,    M,    M,    M,    I,    Z,    N,    O,
+        M,    M,    M,    M,    I,    Z,    N,    O,    M,    M,    M,    M,    I,    Z,    N,    O,
+        N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,
+        N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    N,
+        O,    O,    X,    M,    N,    N,    N,    N,    Z,    MZ,   I,    MI,   N,    N,    N,    N,
+        R,    R,    R,    R,    R,    R,    R,    R,    R,    R,    R,    R,    R,    R,    R,    R,
+        MI,   MZ,   MI|O, MI,   M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        N,    N,    N,    N,    N,    N,    N,    N,    N,    N,    X,    N,    N,    N,    N,    N,
+        A,    A,    A,    A,    N,    N,    N,    N,    I,    Z,    N,    N,    N,    N,    N,    N,
+        I,    I,    I,    I,    I,    I,    I,    I,    V,    V,    V,    V,    V,    V,    V,    V,
+        MI,   MI,   W|S,  S,    M|O,  M|O,  MI,   MZ,   W|I,  N,    W|S,  S,    S,    I,    O,    S,
+        M,    M,    M,    M,    I|O,  I|O,  X,    N,    M,    M,    M,    M,    M,    M,    M,    M,
+        X,    X,    X,    X,    I,    I,    I,    I,    J,    J|S,  X,    R|S,  N,    N,    N,    N,
+        N,    N,    N,    N,    N,    N,    T,    T,    N,    N,    N,    N,    N,    N,    M,    F,
+    };
+
+    static const uint16_t kTwoByte[256] = {
+        M,    M,    M,    M,    X,    N,    N,    N,    N,    N,    X,    N,    X,    M,    N,    X,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        M,    M,    M,    M,    X,    X,    X,    X,    M,    M,    M,    M,    M,    M,    M,    M,
+        N,    N,    N,    N,    N,    N,    X,    N,    X,    X,    X,    X,    X,    X,    X,    X,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        MI,   MI,   MI,   MI,   M,    M,    M,    N,    M,    M,    X,    X,    M,    M,    M,    M,
+        J,    J,    J,    J,    J,    J,    J,    J,    J,    J,    J,    J,    J,    J,    J,    J,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        N,    N,    N,    M,    MI,   M,    X,    X,    N,    N,    N,    M,    MI,   M,    M,    M,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    MI,   M,    M,    M,    M,    M,
+        M,    M,    MI,   M,    MI,   MI,   MI,   M,    N,    N,    N,    N,    N,    N,    N,    N,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+        M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,    M,
+    };
+
+    insn = Instruction{};
+    std::size_t i = 0;
+    bool operandSize16 = false;
+    bool rexW = false;
+
+    // Legacy prefixes, in any order.
+    for (;; ++i)
+    {
+        if (i == kMaxInstructionLength) return false;
+        switch (code[i])
+        {
+            case 0x66: 
+                operandSize16 = true;
+                continue;
+            case 0xF0: case 0xF2: case 0xF3:
+            case 0x26: case 0x2E: case 0x36: case 0x3E: case 0x64: case 0x65:
+                continue;
+            case 0x67:
+                return false;
+        }
+        break;
+    }
+
+#   if defined(REMODEL_HOOK_X64)
+        if ((code[i] & 0xF0) == 0x40) rexW = (code[i++] & 0x08) != 0;
+        const bool vex = code[i] == 0xC4 || code[i] == 0xC5;
+#   else
+        // In 32 bit mode, C4 and C5 are only VEX prefixes if they can't be `les`/`lds`.
+        const bool vex = (code[i] == 0xC4 || code[i] == 0xC5) && (code[i + 1] & 0xC0) == 0xC0;
+#   endif
+
+    const uint8_t opcode = code[i++];
+    uint16_t flags;
+    if (opcode == 0x0F)
+    {
+        const uint8_t opcode2 = code[i++];
+        if (opcode2 == 0x38)
+        {
+            ++i;
+            flags = kOpModRm;
+        }
+        else if (opcode2 == 0x3A)
+        {
+            ++i;
+            flags = kOpModRm | kOpImm8;
+        }
+        else
+        {
+            flags = kTwoByte[opcode2];
+            if ((opcode2 & 0xF0) == 0x80) 
+            {
+                insn.branch    = Instruction::Branch::Conditional;
+                insn.condition = opcode2 & 0x0F;
+            }
+        }
+    }
+    else if (vex)
+    {
+        // The map selects the opcode table, as if the VEX prefix was 0F, 0F 38 or 0F 3A.
+        unsigned map = 1;
+        if (opcode == 0xC4) map = code[i++] & 0x1F;
+        ++i;
+        const uint8_t vexOpcode = code[i++];
+        switch (map)
+        {
+            case 1:  flags = kTwoByte[vexOpcode]; break;
+            case 2:  flags = kOpModRm; break;
+            case 3:  flags = kOpModRm | kOpImm8; break;
+            default: return false;
+        }
+        if (flags & kOpRel32) return false;
+    }
+    else
+    {
+        flags = kOneByte[opcode];
+        if ((opcode & 0xF0) == 0x70)
+        {
+            insn.branch    = Instruction::Branch::Conditional;
+            insn.condition = opcode & 0x0F;
+        }
+        else if (opcode == 0xE8)
+        {
+            insn.branch = Instruction::Branch::Call;
+        }
+        else if (opcode == 0xE9 || opcode == 0xEB)
+        {
+            insn.branch = Instruction::Branch::Jump;
+        }
+    }
+
+    if (flags & kOpBad) return false;
+#   if defined(REMODEL_HOOK_X64)
+        if (flags & kOpNo64) return false;
+#   endif
+
+    if (flags & kOpModRm)
+    {
+        const uint8_t modRm = code[i++];
+        const unsigned mod  = modRm >> 6;
+        const unsigned reg  = (modRm >> 3) & 7;
+        const unsigned rm   = modRm & 7;
+        if (mod != 3)
+        {
+            if (rm == 4)
+            {
+                // SIB byte, without base register for mod 0 and base 5.
+                if (mod == 0 && (code[i] & 7) == 5) i += 4;
+                ++i;
+            }
+            else if (mod == 0 && rm == 5)
+            {
+#               if defined(REMODEL_HOOK_X64)
+                    insn.ripOffset = i;
+#               endif
+                i += 4;
+            }
+            if (mod == 1) i += 1;
+            if (mod == 2) i += 4;
+        }
+        if ((flags & kOpGroup3) && reg < 2) flags |= opcode == 0xF6 ? kOpImm8 : kOpImmZ;
+        if ((flags & kOpGroup5) && (reg == 4 || reg == 5)) flags |= kOpStop;
+    }
+
+    const std::size_t immZ = operandSize16 ? 2 : 4;
+    if (flags & kOpImm8)  i += 1;
+    if (flags & kOpImm16) i += 2;
+    if (flags & kOpImmZ)  i += immZ;
+    if (flags & kOpImmV)  i += rexW ? 8 : immZ;
+    if (flags & kOpMoffs) i += sizeof(void*);
+    if (flags & kOpRel8)  insn.relSize = 1;
+    if (flags & kOpRel32)
+    {
+        if (operandSize16) return false;
+        insn.relSize = 4;
+    }
+    i += insn.relSize;
+
+    if (i > kMaxInstructionLength) return false;
+    insn.length     = i;
+    insn.terminates = (flags & kOpStop) != 0;
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Code relocation]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   The maximum size of a branch emitted by `emitBranch`, in bytes.
+ */
+const std::size_t kMaxBranchSize = 16;
+
+/**
+ * @internal
+ * @brief   Determines whether a 32 bit displacement reaches from one address to another.
+ * @param   from    The address the displacement is relative to (the end of the instruction).
+ * @param   to      The target address.
+ * @return  @c true if the target is in reach, else @c false.
+ */
+inline bool fitsRel32(uintptr_t from, uintptr_t to)
+{
+#   if defined(REMODEL_HOOK_X64)
+        const auto distance = static_cast<intptr_t>(to - from);
+        return distance == static_cast<int32_t>(distance);
+#   else
+        // Displacements wrap around the 32 bit address space, everything is in reach.
+        (void)from;
+        (void)to;
+        return true;
+#   endif
+}
+
+/**
+ * @internal
+ * @brief   Writes a 32 bit displacement.
+ * @param   code    The location of the displacement.
+ * @param   from    The address the displacement is relative to (the end of the instruction).
+ * @param   to      The target address.
+ */
+inline void writeRel32(uint8_t* code, uintptr_t from, uintptr_t to)
+{
+    const auto displacement = static_cast<uint32_t>(to - from);
+    std::memcpy(code, &displacement, sizeof(displacement));
+}
+
+/**
+ * @internal
+ * @brief   Emits a branch to an absolute address.
+ * @param   code        The location of the branch, at its final address.
+ * @param   branch      The kind of branch.
+ * @param   condition   The condition code of conditional branches.
+ * @param   target      The target address.
+ * @return  The size of the emitted code, at most `kMaxBranchSize` bytes.
+ *          
+ * Branches are emitted with a 32 bit displacement if the target is in reach, otherwise through
+ * an absolute address stored inline.
+ */
+inline std::size_t emitBranch(
+    uint8_t* code, Instruction::Branch branch, uint8_t condition, uintptr_t target)
+{
+    const auto address = reinterpret_cast<uintptr_t>(code);
+    const uint64_t absolute = target;
+    switch (branch)
+    {
+        case Instruction::Branch::Conditional:
+            if (fitsRel32(address + 6, target))
+            {
+                code[0] = 0x0F;
+                code[1] = 0x80 | condition;
+                writeRel32(code + 2, address + 6, target);
+                return 6;
+            }
+            // Inverted short branch over an absolute jump.
+            code[0] = 0x70 | (condition ^ 1);
+            code[1] = 14;
+            return 2 + emitBranch(code + 2, Instruction::Branch::Jump, 0, target);
+        case Instruction::Branch::Call:
+            if (fitsRel32(address + 5, target))
+            {
+                code[0] = 0xE8;
+                writeRel32(code + 1, address + 5, target);
+                return 5;
+            }
+            // call [rip + 2]; jmp $ + 10; dq target
+            std::memcpy(code, "\xFF\x15\x02\x00\x00\x00\xEB\x08", 8);
+            std::memcpy(code + 8, &absolute, 8);
+            return 16;
+        default:
+            if (fitsRel32(address + 5, target))
+            {
+                code[0] = 0xE9;
+                writeRel32(code + 1, address + 5, target);
+                return 5;
+            }
+            // jmp [rip]; dq target
+            std::memcpy(code, "\xFF\x25\x00\x00\x00\x00", 6);
+            std::memcpy(code + 6, &absolute, 8);
+            return 14;
+    }
+}
+
+/**
+ * @internal
+ * @brief   Copies whole instructions from the start of a function to another address, adjusting
+ *          relative branches and RIP-relative operands.
+ * @param   source      The code to copy.
+ * @param   minLength   The number of bytes to copy at least.
+ * @param   dest        The destination, at its final address.
+ * @param   capacity    The size of @c dest, in bytes.
+ * @param   copied      Receives the number of bytes copied from @c source.
+ * @param   offsets     If non-null, receives the offset in @c dest of the instruction starting 
+ *                      at each of the first @c minLength offsets in @c source; offsets inside an
+ *                      instruction are left as they are.
+ * @return  The number of bytes written to @c dest, 0 if the code can't be relocated.
+ *          
+ * A jump to the instruction following the copied ones is appended, unless the last copied 
+ * instruction ends control flow. Code ending before @c minLength bytes and code referring to the
+ * copied bytes (short loops, for example) is rejected.
+ */
+inline std::size_t relocateCode(
+    const uint8_t* source, std::size_t minLength, uint8_t* dest, std::size_t capacity, 
+    std::size_t& copied, std::size_t* offsets = nullptr)
+{
+    Instruction insns[kMaxInstructionLength];
+    std::size_t numInsns = 0;
+    std::size_t length   = 0;
+    while (length < minLength)
+    {
+        if (numInsns == kMaxInstructionLength) return 0;
+        auto& insn = insns[numInsns++];
+        if (!decodeInstruction(source + length, insn)) return 0;
+        length += insn.length;
+        if (insn.terminates && length < minLength) return 0;
+    }
+
+    const auto begin = reinterpret_cast<uintptr_t>(source);
+    const auto end   = begin + length;
+    auto refersToCopied = [&](uintptr_t target) { return target >= begin && target < end; };
+
+    std::size_t written = 0;
+    std::size_t offset  = 0;
+    for (std::size_t k = 0; k < numInsns; ++k)
+    {
+        const auto& insn = insns[k];
+        const auto next  = begin + offset + insn.length;
+        uint8_t* out     = dest + written;
+        if (capacity - written < kMaxBranchSize + kMaxInstructionLength) return 0;
+        if (offsets && offset < minLength) offsets[offset] = written;
+
+        if (insn.branch != Instruction::Branch::None)
+        {
+            const uint8_t* rel = source + offset + insn.length - insn.relSize;
+            int32_t displacement;
+            if (insn.relSize == 1)
+            {
+                displacement = static_cast<int8_t>(*rel);
+            }
+            else
+            {
+                std::memcpy(&displacement, rel, sizeof(displacement));
+            }
+            const uintptr_t target = next + static_cast<intptr_t>(displacement);
+            if (refersToCopied(target)) return 0;
+            written += emitBranch(out, insn.branch, insn.condition, target);
+        }
+        else
+        {
+            std::memcpy(out, source + offset, insn.length);
+            if (insn.ripOffset)
+            {
+                int32_t displacement;
+                std::memcpy(&displacement, out + insn.ripOffset, sizeof(displacement));
+                const uintptr_t target = next + static_cast<intptr_t>(displacement);
+                const auto outNext = reinterpret_cast<uintptr_t>(out) + insn.length;
+                if (refersToCopied(target) || !fitsRel32(outNext, target)) return 0;
+                writeRel32(out + insn.ripOffset, outNext, target);
+            }
+            written += insn.length;
+        }
+        offset += insn.length;
+    }
+
+    if (!insns[numInsns - 1].terminates)
+    {
+        if (capacity - written < kMaxBranchSize) return 0;
+        written += emitBranch(dest + written, Instruction::Branch::Jump, 0, end);
+    }
+    copied = length;
+    return written;
+}
+
+/**
+ * @internal
+ * @brief   Overwrites code.
+ * @param   code    The code to overwrite.
+ * @param   bytes   The new bytes.
+ * @param   size    The number of bytes to write.
+ * @return  @c true if written, @c false if the code couldn't be made writable.
+ *          
+ * If the bytes don't cross an 8-byte boundary, they are written with a single aligned store, so
+ * threads executing the code see either the old or the new bytes.
+ */
+inline bool patchCode(uint8_t* code, const uint8_t* bytes, std::size_t size)
+{
+    if (!platform::protectCode(code, size, true)) return false;
+
+    const auto misalignment = reinterpret_cast<uintptr_t>(code) & 7;
+    if (misalignment + size <= 8)
+    {
+        auto word = reinterpret_cast<std::atomic<uint64_t>*>(code - misalignment);
+        uint64_t value = word->load(std::memory_order_relaxed);
+        std::memcpy(reinterpret_cast<uint8_t*>(&value) + misalignment, bytes, size);
+        word->store(value, std::memory_order_release);
+    }
+    else
+    {
+        std::memcpy(code, bytes, size);
+    }
+
+    platform::protectCode(code, size, false);
+    platform::flushCode(code, size);
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [TrampolinePool]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Allocator of hook trampolines within reach of 32 bit branches from the hooked code.
+ *          
+ * Memory is allocated in blocks close to the hooked code and cut into slots of `kSlotSize` 
+ * bytes. Released slots are reused, blocks are never freed.
+ */
+class TrampolinePool : public zycore::NonCopyable
+{
+    static const std::size_t kBlockSize = 64 * 1024;
+
+    std::mutex m_mutex;
+    std::vector<uint8_t*> m_free;
+
+    static bool isNear(const uint8_t* slot, uintptr_t address)
+    {
+        const auto p = reinterpret_cast<uintptr_t>(slot);
+        return p >= address ? p - address <= kMaxDistance - kSlotSize : address - p <= kMaxDistance;
+    }
+public:
+    /**
+     * @brief   The size of a slot, in bytes.
+     */
+    static const std::size_t kSlotSize = 64;
+
+#   if defined(REMODEL_HOOK_X64)
+        /**
+         * @brief   The maximum distance of a slot from the hooked code.
+         */
+        static const uintptr_t kMaxDistance = 0x7FF00000;
+#   else
+        static const uintptr_t kMaxDistance = ~uintptr_t{0};
+#   endif
+
+    /**
+     * @brief   Gets the pool shared by all hooks.
+     * @return  The pool.
+     */
+    static TrampolinePool& global()
+    {
+        static TrampolinePool pool;
+        return pool;
+    }
+
+    /**
+     * @brief   Acquires a slot.
+     * @param   address The address of the hooked code.
+     * @return  A slot filled with `int3` within `kMaxDistance` of @c address or @c nullptr if 
+     *          no memory could be allocated there.
+     */
+    uint8_t* acquire(uintptr_t address)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (auto it = m_free.begin(); it != m_free.end(); ++it)
+        {
+            if (isNear(*it, address))
+            {
+                auto slot = *it;
+                m_free.erase(it);
+                return slot;
+            }
+        }
+
+        auto block = static_cast<uint8_t*>(
+            platform::allocateCodeNear(address, kBlockSize, kMaxDistance));
+        if (!block) return nullptr;
+        std::memset(block, 0xCC, kBlockSize);
+        for (std::size_t offset = kBlockSize - kSlotSize; offset; offset -= kSlotSize)
+        {
+            m_free.push_back(block + offset);
+        }
+        return block;
+    }
+
+    /**
+     * @brief   Releases a slot acquired with `acquire`.
+     * @param   slot    The slot.
+     */
+    void release(uint8_t* slot)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::memset(slot, 0xCC, kSlotSize);
+        m_free.push_back(slot);
+    }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [Hook]                                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Base class of `Hook`, independent of the hooked function's type.
+ */
+class HookBase : public zycore::NonCopyable
+{
+    friend class remodel::HookTransaction;
+protected:
+    static const std::size_t kPatchSize = 5;
+    static const std::size_t kRelaySize = 16;
+    static const std::size_t kNoOffset  = ~std::size_t{0};
+
+    uint8_t* m_target;
+    uint8_t* m_slot = nullptr;
+    uint8_t m_savedCode[kPatchSize];
+    uint8_t m_jump[kPatchSize];
+    std::size_t m_trampolineOffsets[kPatchSize];
+    bool m_installed = false;
+
+    /**
+     * @brief   Constructor, preparing relay and trampoline.
+     * @param   target  The function to hook.
+     * @param   detour  The address of the function to call instead.
+     */
+    HookBase(void* target, const void* detour)
+        : m_target{static_cast<uint8_t*>(target)}
+    {
+#       if defined(REMODEL_HOOK_SUPPORTED)
+            const auto targetAddress = reinterpret_cast<uintptr_t>(m_target);
+            auto& pool = TrampolinePool::global();
+            auto slot = m_target && detour ? pool.acquire(targetAddress) : nullptr;
+            if (!slot) return;
+
+            // The slot holds the relay to the detour followed by the trampoline.
+            std::size_t copied;
+            const std::size_t noOffset = kNoOffset;
+            std::fill(m_trampolineOffsets, m_trampolineOffsets + kPatchSize, noOffset);
+            if (!fitsRel32(targetAddress + kPatchSize, reinterpret_cast<uintptr_t>(slot))
+                || !relocateCode(m_target, kPatchSize, slot + kRelaySize, 
+                    TrampolinePool::kSlotSize - kRelaySize, copied, m_trampolineOffsets))
+            {
+                pool.release(slot);
+                return;
+            }
+            emitBranch(slot, Instruction::Branch::Jump, 0, reinterpret_cast<uintptr_t>(detour));
+            platform::flushCode(slot, TrampolinePool::kSlotSize);
+
+            std::memcpy(m_savedCode, m_target, kPatchSize);
+            m_jump[0] = 0xE9;
+            writeRel32(m_jump + 1, targetAddress + kPatchSize, reinterpret_cast<uintptr_t>(slot));
+            m_slot = slot;
+#       else
+            (void)detour;
+#       endif
+    }
+
+    /**
+     * @brief   Destructor, removing the hook.
+     */
+    ~HookBase()
+    {
+        remove();
+        if (m_slot) TrampolinePool::global().release(m_slot);
+    }
+
+    /**
+     * @brief   Gets the trampoline continuing with the original function.
+     * @return  The trampoline or @c nullptr if invalid.
+     */
+    uint8_t* trampoline() const { return m_slot ? m_slot + kRelaySize : nullptr; }
+public:
+    /**
+     * @brief   Determines whether the function could be prepared for hooking.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_slot != nullptr; }
+
+    /**
+     * @brief   Determines whether the hook is installed.
+     * @return  @c true if installed, else @c false.
+     */
+    bool isInstalled() const { return m_installed; }
+
+    /**
+     * @brief   Installs the hook, redirecting calls to the detour.
+     * @return  @c true if installed, @c false if invalid or the code couldn't be written.
+     */
+    bool install()
+    {
+        if (!m_slot) return false;
+        if (m_installed) return true;
+        m_installed = patchCode(m_target, m_jump, kPatchSize);
+        return m_installed;
+    }
+
+    /**
+     * @brief   Removes the hook, restoring the original code.
+     * @return  @c true if not installed anymore, @c false if the code couldn't be written.
+     */
+    bool remove()
+    {
+        if (!m_installed) return true;
+        m_installed = !patchCode(m_target, m_savedCode, kPatchSize);
+        return !m_installed;
+    }
+
+    /**
+     * @brief   Maps an address inside the code overwritten by the jump to the trampoline.
+     * @param   address The address, usually the instruction pointer of a suspended thread.
+     * @return  The corresponding trampoline address, or @c address itself if it's not the start
+     *          of an overwritten instruction following the first one.
+     */
+    uintptr_t relocatedAddress(uintptr_t address) const
+    {
+        const auto target = reinterpret_cast<uintptr_t>(m_target);
+        if (!m_slot || address <= target || address - target >= kPatchSize) return address;
+        const auto offset = m_trampolineOffsets[address - target];
+        if (offset == kNoOffset) return address;
+        return reinterpret_cast<uintptr_t>(trampoline()) + offset;
+    }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Inline hook (detour) of a function.
+ * @tparam  T   The function pointer type of the hooked function, e.g. `int (__cdecl*)(int)`.
+ *          
+ * Installing the hook replaces the first instructions of the function with a jump to a relay
+ * jumping on to the detour, so calls to the function take two jumps. The replaced instructions 
+ * are relocated into a trampoline continuing with the rest of the function, which is called 
+ * through `original`:
+ * @code
+ *     Hook<int (*)(int)>* hook;
+ *     int detour(int x) { return hook->original()(x) * 2; }
+ *     // ...
+ *     Hook<int (*)(int)> doubled{Function<int (*)(int)>{0x401000}, &detour};
+ *     hook = &doubled;
+ *     doubled.install();
+ * @endcode
+ * 
+ * Relay and trampoline are placed within 2 GiB of the hooked function and prepared on
+ * construction, installing and removing the hook just writes the jump. Only x86 and x86-64 code
+ * is supported; functions shorter than the jump or branching back into their first five bytes 
+ * can't be hooked (`isValid` returns @c false).
+ *
+ * @note    Installing and removing hooks isn't synchronized with other threads. The jump is
+ *          written atomically if it doesn't cross an 8-byte boundary; otherwise, make sure no 
+ *          thread executes the start of the function meanwhile, or install the hook with a 
+ *          `HookTransaction`. Also make sure no thread is still executing the trampoline when 
+ *          destroying the hook.
+ */
+template<typename T>
+class Hook : public internal::HookBase
+{
+    Function<T, AbsGetter> m_original;
+
+    static void* addressOf(T function)
+    {
+        // See the `Function` constructor on why this is required.
+        return *reinterpret_cast<void**>(&function);
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   target  The function to hook.
+     * @param   detour  The function to call instead.
+     */
+    Hook(void* target, T detour)
+        : internal::HookBase{target, addressOf(detour)}
+        , m_original{AbsGetter{m_slot ? static_cast<void*>(trampoline()) : target}}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   target  The address of the function to hook.
+     * @param   detour  The function to call instead.
+     */
+    Hook(uintptr_t target, T detour)
+        : Hook{reinterpret_cast<void*>(target), detour}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   target  The function to hook.
+     * @param   detour  The function to call instead.
+     */
+    template<typename PtrGetterT>
+    Hook(const Function<T, PtrGetterT>& target, T detour)
+        : Hook{addressOf(target.get()), detour}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   target  The function to hook.
+     * @param   detour  The function to call instead.
+     */
+    Hook(T target, T detour)
+        : Hook{addressOf(target), detour}
+    {}
+
+    /**
+     * @brief   Gets the original function, callable while the hook is installed.
+     * @return  The original function (the trampoline, if valid).
+     */
+    const Function<T, AbsGetter>& original() const { return m_original; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ShadowVfTable]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Copy of a class' vftable with selected entries replaced, hooking objects by swapping
+ *          their vftable-pointer.
+ *
+ * One shadow table is shared by all objects of the class, so hooking an object is a single 
+ * pointer write and no code is patched. Entries are indexed like `VirtualFunction`'s
+ * `vftableIdx`, the `vftableOffset` of the hooked objects is passed on attaching them:
+ * @code
+ *     static ShadowVfTable shadow{addressOfObj(player), player.vftable, 32};
+ *     shadow.replace(7, &takeDamageDetour); // int (__thiscall*)(void*, int)
+ *     for (auto& p : players) shadow.attach(addressOfObj(p), p.vftable);
+ * @endcode
+ * 
+ * Detours take `this` as their first argument and call the original through 
+ * `original<T>(vftableIdx)`. Replacing or restoring entries affects all attached objects at once;
+ * `VirtualFunction`s using a `VfTableCache` remember entries, though, so invalidate their caches.
+ * 
+ * The entries in front of the vftable (RTTI; `numPrefix`, by default one for MSVC and two for 
+ * Itanium ABI compilers) are copied as well, so `typeid` and `dynamic_cast` keep working on 
+ * hooked objects.
+ * 
+ * @note    Detach all objects before destroying the shadow table; objects destroyed meanwhile 
+ *          don't need to be detached. Objects reached through `VirtualFunction`s with an 
+ *          `AssumeStable` `VfTableCache` should be attached with the cache, which invalidates it.
+ */
+class ShadowVfTable : public zycore::NonCopyable
+{
+public:
+#   if defined(ZYCORE_MSVC)
+        /**
+         * @brief   The default number of entries in front of the vftable.
+         */
+        static const std::size_t kDefaultPrefix = 1;
+#   else
+        static const std::size_t kDefaultPrefix = 2;
+#   endif
+private:
+    const void* const* m_original;
+    std::size_t m_numPrefix;
+    std::vector<const void*> m_entries;
+
+    static const void** vftablePtrOf(const void* object, std::size_t vftableOffset)
+    {
+        return reinterpret_cast<const void**>(
+            reinterpret_cast<uintptr_t>(object) + vftableOffset);
+    }
+
+    template<typename T>
+    static const void* addressOf(T function)
+    {
+        static_assert(sizeof(T) == sizeof(void*), "expected a function pointer type");
+        // See the `Function` constructor on why this is required.
+        return *reinterpret_cast<void**>(&function);
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   vftable     The original vftable.
+     * @param   numEntries  The number of vftable entries to copy (at least the highest replaced 
+     *                      index plus one).
+     * @param   numPrefix   The number of entries in front of the vftable to copy.
+     */
+    ShadowVfTable(
+        const void* const* vftable, std::size_t numEntries, std::size_t numPrefix = kDefaultPrefix)
+        : m_original{vftable}
+        , m_numPrefix{numPrefix}
+        , m_entries(vftable - numPrefix, vftable + numEntries)
+    {}
+
+    /**
+     * @brief   Constructs a shadow of the vftable of an object.
+     * @param   object      The object.
+     * @param   cache       The vftable-pointer cache of the object's wrapper.
+     * @param   numEntries  The number of vftable entries to copy (at least the highest replaced 
+     *                      index plus one).
+     * @param   numPrefix   The number of entries in front of the vftable to copy.
+     */
+    ShadowVfTable(const void* object, const VfTableCache& cache, std::size_t numEntries, 
+            std::size_t numPrefix = kDefaultPrefix)
+        : ShadowVfTable{cache.vftable(object), numEntries, numPrefix}
+    {}
+
+    /**
+     * @brief   Gets the original vftable.
+     * @return  The original vftable.
+     */
+    const void* const* originalVfTable() const { return m_original; }
+
+    /**
+     * @brief   Gets the shadow vftable, as seen by attached objects.
+     * @return  The shadow vftable.
+     */
+    const void* const* vftable() const { return m_entries.data() + m_numPrefix; }
+
+    /**
+     * @brief   Gets the number of copied vftable entries.
+     * @return  The number of entries.
+     */
+    std::size_t size() const { return m_entries.size() - m_numPrefix; }
+
+    /**
+     * @brief   Replaces an entry.
+     * @tparam  T           The function pointer type of the detour.
+     * @param   vftableIdx  The index of the entry.
+     * @param   detour      The function to call instead.
+     */
+    template<typename T>
+    void replace(std::size_t vftableIdx, T detour)
+    {
+        m_entries[m_numPrefix + vftableIdx] = addressOf(detour);
+    }
+
+    /**
+     * @brief   Restores the original entry.
+     * @param   vftableIdx  The index of the entry.
+     */
+    void restore(std::size_t vftableIdx)
+    {
+        m_entries[m_numPrefix + vftableIdx] = m_original[vftableIdx];
+    }
+
+    /**
+     * @brief   Determines whether an entry is replaced.
+     * @param   vftableIdx  The index of the entry.
+     * @return  @c true if replaced, else @c false.
+     */
+    bool isReplaced(std::size_t vftableIdx) const
+    {
+        return m_entries[m_numPrefix + vftableIdx] != m_original[vftableIdx];
+    }
+
+    /**
+     * @brief   Gets the original function of an entry.
+     * @tparam  T           The function pointer type of the entry, including `this`.
+     * @param   vftableIdx  The index of the entry.
+     * @return  The original function.
+     */
+    template<typename T>
+    T original(std::size_t vftableIdx) const
+    {
+        static_assert(sizeof(T) == sizeof(void*), "expected a function pointer type");
+        auto entry = const_cast<void*>(m_original[vftableIdx]);
+        return *reinterpret_cast<T*>(&entry);
+    }
+
+    /**
+     * @brief   Makes an object use the shadow vftable.
+     * @param   object          The object.
+     * @param   vftableOffset   Offset of the vftable-pointer in the object.
+     * @return  @c true if the object uses the shadow vftable, @c false if it neither used the 
+     *          original nor the shadow vftable (and wasn't changed).
+     */
+    bool attach(void* object, std::size_t vftableOffset = 0) const
+    {
+        auto vftablePtr = vftablePtrOf(object, vftableOffset);
+        if (*vftablePtr == vftable()) return true;
+        if (*vftablePtr != m_original) return false;
+        *vftablePtr = vftable();
+        return true;
+    }
+
+    /**
+     * @brief   Makes an object use the shadow vftable.
+     * @param   object  The object.
+     * @param   cache   The vftable-pointer cache of the object's wrapper, invalidated.
+     * @return  @c true if the object uses the shadow vftable, @c false if it neither used the 
+     *          original nor the shadow vftable (and wasn't changed).
+     */
+    bool attach(void* object, const VfTableCache& cache) const
+    {
+        cache.invalidate();
+        return attach(object, cache.vftableOffset());
+    }
+
+    /**
+     * @brief   Makes an object use the original vftable again.
+     * @param   object          The object.
+     * @param   vftableOffset   Offset of the vftable-pointer in the object.
+     * @return  @c true if the object uses the original vftable, @c false if it neither used the
+     *          original nor the shadow vftable (and wasn't changed).
+     */
+    bool detach(void* object, std::size_t vftableOffset = 0) const
+    {
+        auto vftablePtr = vftablePtrOf(object, vftableOffset);
+        if (*vftablePtr == m_original) return true;
+        if (*vftablePtr != vftable()) return false;
+        *vftablePtr = m_original;
+        return true;
+    }
+
+    /**
+     * @brief   Makes an object use the original vftable again.
+     * @param   object  The object.
+     * @param   cache   The vftable-pointer cache of the object's wrapper, invalidated.
+     * @return  @c true if the object uses the original vftable, @c false if it neither used the
+     *          original nor the shadow vftable (and wasn't changed).
+     */
+    bool detach(void* object, const VfTableCache& cache) const
+    {
+        cache.invalidate();
+        return detach(object, cache.vftableOffset());
+    }
+
+    /**
+     * @brief   Determines whether an object uses the shadow vftable.
+     * @param   object          The object.
+     * @param   vftableOffset   Offset of the vftable-pointer in the object.
+     * @return  @c true if attached, else @c false.
+     */
+    bool isAttached(const void* object, std::size_t vftableOffset = 0) const
+    {
+        return *vftablePtrOf(object, vftableOffset) == vftable();
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ImportHook]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Base class of `ImportHook`, independent of the hooked function's type.
+ */
+class ImportHookBase : public zycore::NonCopyable
+{
+    friend class remodel::HookTransaction;
+protected:
+    struct SlotWrite
+    {
+        std::atomic<uintptr_t>* slot;
+        uintptr_t value;
+    };
+
+    std::atomic<uintptr_t>* m_slot = nullptr;
+    uintptr_t m_originalAddress = 0;
+    uintptr_t m_detour;
+    bool m_installed = false;
+
+    /**
+     * @brief   Constructor.
+     * @param   slot    The address of the IAT or GOT entry, 0 if not found.
+     * @param   detour  The address of the function to call instead.
+     * @param   name    The name of the imported symbol, if known.
+     */
+    ImportHookBase(uintptr_t slot, const void* detour, const char* name)
+        : m_detour{reinterpret_cast<uintptr_t>(detour)}
+    {
+        if (!slot || !detour) return;
+        m_slot = reinterpret_cast<std::atomic<uintptr_t>*>(slot);
+        m_originalAddress = m_slot->load(std::memory_order_acquire);
+
+#       if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+            // With lazy binding, unresolved GOT entries point to the PLT of their own module.
+            // Calling through that would resolve the symbol and overwrite the hook, so the
+            // symbol is resolved right away.
+            auto owner = ModuleRegistry::global().findByAddress(reinterpret_cast<void*>(slot));
+            if (name && owner && m_originalAddress - owner->base < owner->size)
+            {
+                if (auto resolved = dlsym(RTLD_DEFAULT, name))
+                {
+                    m_originalAddress = reinterpret_cast<uintptr_t>(resolved);
+                }
+            }
+#       else
+            (void)name;
+#       endif
+    }
+
+    /**
+     * @brief   Destructor, removing the hook.
+     */
+    ~ImportHookBase() { remove(); }
+
+    /**
+     * @brief   Writes IAT or GOT entries.
+     * @param   writes  The entries and their new values.
+     * @return  @c true if written, @c false if an entry couldn't be made writable; then, nothing
+     *          was written.
+     *
+     * Pages that aren't writable already are made writable once before and restored once after
+     * writing all entries on them.
+     */
+    static bool writeSlots(const std::vector<SlotWrite>& writes)
+    {
+        const uintptr_t pageMask = ~uintptr_t{4096 - 1};
+        std::vector<uintptr_t> pages;
+        for (const auto& write : writes)
+        {
+            pages.push_back(reinterpret_cast<uintptr_t>(write.slot) & pageMask);
+        }
+        std::sort(pages.begin(), pages.end());
+        pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+        struct Restore
+        {
+            void* page;
+            unsigned protection;
+        };
+        std::vector<Restore> restores;
+        auto restoreAll = [&restores]
+        {
+            for (const auto& cur : restores)
+            {
+                platform::protectMemory(cur.page, 4096, cur.protection);
+            }
+        };
+
+        for (auto page : pages)
+        {
+            auto address = reinterpret_cast<void*>(page);
+            unsigned protection;
+            if (!platform::queryProtection(address, 4096, protection))
+            {
+                restoreAll();
+                return false;
+            }
+            if (protection & platform::kMappingWritable) continue;
+            if (!platform::protectMemory(address, 4096, protection | platform::kMappingWritable))
+            {
+                restoreAll();
+                return false;
+            }
+            restores.push_back({address, protection});
+        }
+
+        for (const auto& write : writes) write.slot->store(write.value, std::memory_order_release);
+        restoreAll();
+        return true;
+    }
+public:
+    /**
+     * @brief   Determines whether the import was found.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_slot != nullptr; }
+
+    /**
+     * @brief   Determines whether the hook is installed.
+     * @return  @c true if installed, else @c false.
+     */
+    bool isInstalled() const { return m_installed; }
+
+    /**
+     * @brief   Installs the hook, redirecting calls to the detour.
+     * @return  @c true if installed, @c false if invalid or the entry couldn't be written.
+     */
+    bool install()
+    {
+        if (!m_slot) return false;
+        if (m_installed) return true;
+        m_installed = writeSlots({{m_slot, m_detour}});
+        return m_installed;
+    }
+
+    /**
+     * @brief   Removes the hook, restoring the original entry.
+     * @return  @c true if not installed anymore, @c false if the entry couldn't be written.
+     */
+    bool remove()
+    {
+        if (!m_installed) return true;
+        m_installed = !writeSlots({{m_slot, m_originalAddress}});
+        return !m_installed;
+    }
+
+    /**
+     * @brief   Gets the hooked IAT or GOT entry.
+     * @return  The address of the entry or 0 if invalid.
+     */
+    uintptr_t slot() const { return reinterpret_cast<uintptr_t>(m_slot); }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Hook of a function imported by a module, replacing its IAT (PE) or GOT (ELF) entry.
+ * @tparam  T   The function pointer type of the hooked function, e.g. `int (__cdecl*)(int)`.
+ *
+ * Only calls made by the hooking module through the entry are redirected, no code is patched. 
+ * This makes import hooks cheap for library calls such as allocators and I/O:
+ * @code
+ *     ImportHook<decltype(&ReadFile)>* hook;
+ *     BOOL WINAPI detour(HANDLE file, LPVOID buf, DWORD size, LPDWORD read, LPOVERLAPPED ov)
+ *     {
+ *         return hook->original()(file, buf, size, read, ov);
+ *     }
+ *     // ...
+ *     ImportHook<decltype(&ReadFile)> readFile{Module::getModule(nullptr).value(), 
+ *         "kernel32.dll", "ReadFile", &detour};
+ *     hook = &readFile;
+ *     readFile.install();
+ * @endcode
+ *
+ * Many hooks are best installed with a `HookTransaction`, which changes the protection of each
+ * page once. The original is the entry's value at construction; with lazy binding (ELF), entries
+ * not resolved yet are resolved with `dlsym`.
+ *
+ * @note    Pointers to the function obtained before installing the hook (e.g. by `dlsym`,
+ *          `GetProcAddress` or from entries of other modules) keep calling the original.
+ */
+template<typename T>
+class ImportHook : public internal::ImportHookBase
+{
+    Function<T, AbsGetter> m_original;
+
+    static void* addressOf(T function)
+    {
+        // See the `Function` constructor on why this is required.
+        return *reinterpret_cast<void**>(&function);
+    }
+
+    static uintptr_t slotOf(const Module& module, const char* importModule, const char* name)
+    {
+        auto slot = module.importSlot(importModule, name);
+        return slot.hasValue() ? slot.value() : 0;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   module          The module whose calls to hook.
+     * @param   importModule    The name of the module imported from, e.g. `kernel32.dll`.
+     *                          Ignored on ELF platforms.
+     * @param   name            The name of the imported function.
+     * @param   detour          The function to call instead.
+     */
+    ImportHook(const Module& module, const char* importModule, const char* name, T detour)
+        : internal::ImportHookBase{slotOf(module, importModule, name), addressOf(detour), name}
+        , m_original{AbsGetter{reinterpret_cast<void*>(m_originalAddress)}}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   slot    The address of the IAT or GOT entry to hook.
+     * @param   detour  The function to call instead.
+     */
+    ImportHook(uintptr_t slot, T detour)
+        : internal::ImportHookBase{slot, addressOf(detour), nullptr}
+        , m_original{AbsGetter{reinterpret_cast<void*>(m_originalAddress)}}
+    {}
+
+    /**
+     * @brief   Gets the original function, callable while the hook is installed.
+     * @return  The original function.
+     */
+    const Function<T, AbsGetter>& original() const { return m_original; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [HookTransaction]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Batch of hook changes applied while all other threads are suspended once.
+ *
+ * Collects inline hooks to install or remove and objects to attach to or detach from shadow
+ * vftables. `commit` then suspends all other threads, applies all changes, moves threads whose 
+ * instruction pointer is inside code overwritten by a jump into the trampoline, flushes the 
+ * instruction cache and resumes the threads:
+ * @code
+ *     HookTransaction transaction;
+ *     for (auto& hook : hooks) transaction.install(hook);
+ *     for (auto& p : players) transaction.attach(shadow, addressOfObj(p), p.vftable);
+ *     transaction.commit();
+ * @endcode
+ * 
+ * Import hooks are applied as well, changing the protection of every page with hooked IAT or
+ * GOT entries once. Transactions consisting of import hooks only don't suspend threads, as the
+ * entries are written atomically.
+ *
+ * Changes refer to the hooks, shadow vftables and caches passed, which must outlive the commit.
+ * Thread suspension is only supported on Windows and Linux, see `platform::SuspendedThreads`.
+ */
+class HookTransaction : public zycore::NonCopyable
+{
+    struct CodeChange
+    {
+        internal::HookBase* hook;
+        bool install;
+    };
+
+    struct VfTableChange
+    {
+        const ShadowVfTable* shadow;
+        void* object;
+        std::size_t vftableOffset;
+        const VfTableCache* cache;
+        bool attach;
+    };
+
+    struct Range
+    {
+        uintptr_t begin;
+        uintptr_t end;
+    };
+
+    struct ImportChange
+    {
+        internal::ImportHookBase* hook;
+        bool install;
+    };
+
+    std::vector<CodeChange> m_code;
+    std::vector<VfTableChange> m_vftables;
+    std::vector<ImportChange> m_imports;
+
+    bool applyImports(bool rollback)
+    {
+        std::vector<internal::ImportHookBase::SlotWrite> writes;
+        for (const auto& change : m_imports)
+        {
+            auto hook = change.hook;
+            if (!hook->isValid() || hook->m_installed == change.install) continue;
+            const bool install = change.install != rollback;
+            writes.push_back({hook->m_slot, install ? hook->m_detour : hook->m_originalAddress});
+        }
+        return writes.empty() || internal::ImportHookBase::writeSlots(writes);
+    }
+
+    static bool protect(const std::vector<Range>& ranges, std::size_t count, bool writable)
+    {
+        bool ok = true;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ok &= platform::protectCode(reinterpret_cast<void*>(ranges[i].begin), 
+                ranges[i].end - ranges[i].begin, writable);
+        }
+        return ok;
+    }
+public:
+    /**
+     * @brief   Adds the installation of an inline hook.
+     * @param   hook    The hook.
+     */
+    void install(internal::HookBase& hook) { m_code.push_back({&hook, true}); }
+
+    /**
+     * @brief   Adds the removal of an inline hook.
+     * @param   hook    The hook.
+     */
+    void remove(internal::HookBase& hook) { m_code.push_back({&hook, false}); }
+
+    /**
+     * @brief   Adds the installation of an import hook.
+     * @param   hook    The hook.
+     */
+    void install(internal::ImportHookBase& hook) { m_imports.push_back({&hook, true}); }
+
+    /**
+     * @brief   Adds the removal of an import hook.
+     * @param   hook    The hook.
+     */
+    void remove(internal::ImportHookBase& hook) { m_imports.push_back({&hook, false}); }
+
+    /**
+     * @brief   Adds attaching an object to a shadow vftable.
+     * @param   shadow          The shadow vftable.
+     * @param   object          The object.
+     * @param   vftableOffset   Offset of the vftable-pointer in the object.
+     */
+    void attach(const ShadowVfTable& shadow, void* object, std::size_t vftableOffset = 0)
+    {
+        m_vftables.push_back({&shadow, object, vftableOffset, nullptr, true});
+    }
+
+    /**
+     * @brief   Adds attaching an object to a shadow vftable.
+     * @param   shadow  The shadow vftable.
+     * @param   object  The object.
+     * @param   cache   The vftable-pointer cache of the object's wrapper, invalidated on commit.
+     */
+    void attach(const ShadowVfTable& shadow, void* object, const VfTableCache& cache)
+    {
+        m_vftables.push_back({&shadow, object, cache.vftableOffset(), &cache, true});
+    }
+
+    /**
+     * @brief   Adds detaching an object from a shadow vftable.
+     * @param   shadow          The shadow vftable.
+     * @param   object          The object.
+     * @param   vftableOffset   Offset of the vftable-pointer in the object.
+     */
+    void detach(const ShadowVfTable& shadow, void* object, std::size_t vftableOffset = 0)
+    {
+        m_vftables.push_back({&shadow, object, vftableOffset, nullptr, false});
+    }
+
+    /**
+     * @brief   Adds detaching an object from a shadow vftable.
+     * @param   shadow  The shadow vftable.
+     * @param   object  The object.
+     * @param   cache   The vftable-pointer cache of the object's wrapper, invalidated on commit.
+     */
+    void detach(const ShadowVfTable& shadow, void* object, const VfTableCache& cache)
+    {
+        m_vftables.push_back({&shadow, object, cache.vftableOffset(), &cache, false});
+    }
+
+    /**
+     * @brief   Gets the number of pending changes.
+     * @return  The number of changes.
+     */
+    std::size_t size() const { return m_code.size() + m_vftables.size() + m_imports.size(); }
+
+    /**
+     * @brief   Discards all pending changes.
+     */
+    void clear()
+    {
+        m_code.clear();
+        m_vftables.clear();
+        m_imports.clear();
+    }
+
+    /**
+     * @brief   Applies all pending changes.
+     * @param   timeoutMs   How long to wait for threads to be suspended, see 
+     *                      `platform::SuspendedThreads`.
+     * @return  @c true if applied and cleared. @c false if a hook to install is invalid, the code
+     *          or an import entry couldn't be made writable or the threads couldn't be suspended;
+     *          then, nothing was applied and the changes are kept.
+     *          
+     * Objects neither using the original nor the shadow vftable are left alone, like with
+     * `ShadowVfTable::attach`.
+     */
+    bool commit(uint32_t timeoutMs = 1000)
+    {
+        for (const auto& change : m_imports)
+        {
+            if (change.install && !change.hook->isValid()) return false;
+        }
+        if (!applyImports(false)) return false;
+        const bool committed = commitCode(timeoutMs);
+        for (const auto& change : m_imports)
+        {
+            if (committed && change.hook->isValid()) change.hook->m_installed = change.install;
+        }
+        if (committed)
+        {
+            clear();
+        }
+        else
+        {
+            applyImports(true);
+        }
+        return committed;
+    }
+private:
+    bool commitCode(uint32_t timeoutMs)
+    {
+        if (m_code.empty() && m_vftables.empty()) return true;
+
+        // Everything requiring memory is done before suspending threads, as they may hold the 
+        // heap lock.
+        std::vector<internal::HookBase*> installs;
+        std::vector<Range> ranges;
+        for (const auto& change : m_code)
+        {
+            if (change.install && !change.hook->isValid()) return false;
+            if (change.install) installs.push_back(change.hook);
+            const auto target = reinterpret_cast<uintptr_t>(change.hook->m_target);
+            if (change.hook->isValid())
+            {
+                ranges.push_back({target, target + internal::HookBase::kPatchSize});
+            }
+        }
+
+        // Change protection once per run of pages.
+        const uintptr_t pageMask = ~uintptr_t{4096 - 1};
+        for (auto& range : ranges)
+        {
+            range.begin &= pageMask;
+            range.end = (range.end + 4096 - 1) & pageMask;
+        }
+        std::sort(ranges.begin(), ranges.end(), 
+            [](const Range& a, const Range& b) { return a.begin < b.begin; });
+        std::size_t numRanges = 0;
+        for (const auto& range : ranges)
+        {
+            if (numRanges && range.begin <= ranges[numRanges - 1].end)
+            {
+                ranges[numRanges - 1].end = (std::max)(ranges[numRanges - 1].end, range.end);
+            }
+            else
+            {
+                ranges[numRanges++] = range;
+            }
+        }
+        if (!protect(ranges, numRanges, true))
+        {
+            protect(ranges, numRanges, false);
+            return false;
+        }
+
+        {
+            platform::SuspendedThreads threads{timeoutMs};
+            if (!threads.isValid())
+            {
+                protect(ranges, numRanges, false);
+                return false;
+            }
+
+            for (const auto& change : m_code)
+            {
+                auto hook = change.hook;
+                if (!hook->isValid() || hook->m_installed == change.install) continue;
+                std::memcpy(hook->m_target, change.install ? hook->m_jump : hook->m_savedCode, 
+                    internal::HookBase::kPatchSize);
+                hook->m_installed = change.install;
+            }
+            threads.forEachInstructionPointer([&](uintptr_t& ip)
+            {
+                for (auto hook : installs)
+                {
+                    if (hook->m_installed) ip = hook->relocatedAddress(ip);
+                }
+            });
+            for (const auto& change : m_vftables)
+            {
+                if (change.attach)
+                {
+                    change.shadow->attach(change.object, change.vftableOffset);
+                }
+                else
+                {
+                    change.shadow->detach(change.object, change.vftableOffset);
+                }
+            }
+            for (std::size_t i = 0; i < numRanges; ++i)
+            {
+                platform::flushCode(reinterpret_cast<void*>(ranges[i].begin), 
+                    ranges[i].end - ranges[i].begin);
+            }
+        }
+
+        protect(ranges, numRanges, false);
+        for (const auto& change : m_vftables)
+        {
+            if (change.cache) change.cache->invalidate();
+        }
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_HOOK_HPP
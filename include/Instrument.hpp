@@ -0,0 +1,422 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_INSTRUMENT_HPP
+#define REMODEL_INSTRUMENT_HPP
+
+/**
+ * @file
+ * @brief Contains profiler instrumentation (Tracy zones, ETW events, perf maps) for wrapped
+ *        functions.
+ *
+ * Backends are selected at compile time:
+ * - `REMODEL_INSTRUMENT_TRACY`: every call is a Tracy zone. Requires `tracy/TracyC.h` on the
+ *   include path and `TRACY_ENABLE`, as with Tracy itself.
+ * - `REMODEL_INSTRUMENT_ETW`: every call emits a TraceLogging start and stop event through the
+ *   provider named by `REMODEL_INSTRUMENT_ETW_PROVIDER`, which the application defines via
+ *   `TRACELOGGING_DEFINE_PROVIDER` and registers.
+ * - On Linux, `PerfMap` additionally names the called code in `/tmp/perf-<pid>.map`, so `perf`
+ *   attributes samples in target code to the zone name. It's enabled at runtime.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "Remodel.hpp"
+
+#if defined(REMODEL_INSTRUMENT_TRACY)
+#   include "tracy/TracyC.h"
+#   if defined(TRACY_ENABLE)
+#       define REMODEL_INSTRUMENT_TRACY_ACTIVE
+#   endif
+#endif
+
+#if defined(REMODEL_INSTRUMENT_ETW)
+#   if !defined(REMODEL_INSTRUMENT_ETW_PROVIDER)
+#       error "REMODEL_INSTRUMENT_ETW requires REMODEL_INSTRUMENT_ETW_PROVIDER to be defined"
+#   endif
+#   include <windows.h>
+#   include <TraceLoggingProvider.h>
+#   include <evntrace.h>
+    TRACELOGGING_DECLARE_PROVIDER(REMODEL_INSTRUMENT_ETW_PROVIDER);
+#endif
+
+#if defined(__linux__)
+#   include <unistd.h>
+#   define REMODEL_PERF_MAP_SUPPORTED
+#endif
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [ZoneSite]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The static description of an instrumented function, shared by all its calls.
+ *
+ * Profilers refer to sites after the fact (Tracy keeps pointers to the source location), so
+ * sites live until the process exits. Obtain them via `ZoneSite::intern`.
+ */
+class ZoneSite : public zycore::NonCopyable
+{
+    std::string m_name;
+    std::size_t m_codeSize;
+    std::atomic<const void*> m_mappedCode{nullptr};
+#   if defined(REMODEL_INSTRUMENT_TRACY_ACTIVE)
+    ___tracy_source_location_data m_srcloc;
+#   endif
+public:
+    /**
+     * @brief   Constructor, use `intern` instead.
+     * @param   name        The name of the zone.
+     * @param   codeSize    The size of the function's code, see `PerfMap`.
+     */
+    ZoneSite(std::string name, std::size_t codeSize)
+        : m_name{std::move(name)}
+        , m_codeSize{codeSize}
+    {
+#       if defined(REMODEL_INSTRUMENT_TRACY_ACTIVE)
+            m_srcloc = {m_name.c_str(), m_name.c_str(), "", 0, 0};
+#       endif
+    }
+
+    /**
+     * @brief   Gets the site of a name, creating it on first use.
+     * @param   name        The name of the zone, e.g. `Dog::giveGoodie`.
+     * @param   codeSize    The size of the function's code, see `PerfMap`. Only used when the
+     *                      site is created.
+     * @return  The site, valid until the process exits.
+     */
+    static const ZoneSite& intern(const std::string& name, std::size_t codeSize = 0)
+    {
+        // Never destroyed, as profilers may still refer to sites while exiting.
+        static std::mutex& mutex = *new std::mutex;
+        static auto& sites = *new std::deque<ZoneSite>;
+        static auto& byName = *new std::unordered_map<std::string, const ZoneSite*>;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        auto it = byName.find(name);
+        if (it != byName.end()) return *it->second;
+        sites.emplace_back(name, codeSize);
+        return *(byName[name] = &sites.back());
+    }
+
+    /**
+     * @brief   Gets the name of the zone.
+     * @return  The name.
+     */
+    const std::string& name() const { return m_name; }
+
+    /**
+     * @brief   Gets the size of the function's code.
+     * @return  The size, 0 if unknown.
+     */
+    std::size_t codeSize() const { return m_codeSize; }
+
+#   if defined(REMODEL_INSTRUMENT_TRACY_ACTIVE)
+    /**
+     * @brief   Gets the Tracy source location of the zone.
+     * @return  The source location.
+     */
+    const ___tracy_source_location_data* srcloc() const { return &m_srcloc; }
+#   endif
+
+    /**
+     * @brief   Notes the code called for the site.
+     * @param   code    The address of the code.
+     * @return  @c true if the code differs from the previously noted one, else @c false.
+     */
+    bool noteCode(const void* code) const
+    {
+        auto& mapped = const_cast<std::atomic<const void*>&>(m_mappedCode);
+        if (mapped.load(std::memory_order_relaxed) == code) return false;
+        return mapped.exchange(code, std::memory_order_relaxed) != code;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [PerfMap]                                                                                      //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Writer of `perf` symbol maps (`/tmp/perf-<pid>.map`).
+ *
+ * `perf report` and flame graph scripts resolve addresses without symbols through this file, the
+ * same way they do for JIT compiled code. Every instrumented function is added on its first call
+ * (and again if its code moved), spanning `ZoneSite::codeSize` bytes, so samples anywhere in the
+ * function are attributed to it. Sites with an unknown code size are skipped.
+ */
+class PerfMap : public zycore::NonCopyable
+{
+    std::mutex m_mutex;
+    std::FILE* m_file = nullptr;
+    std::atomic<bool> m_enabled{false};
+
+    PerfMap() = default;
+public:
+    ~PerfMap() { disable(); }
+
+    /**
+     * @brief   Gets the global instance.
+     * @return  The instance.
+     */
+    static PerfMap& global()
+    {
+        static PerfMap instance;
+        return instance;
+    }
+
+    /**
+     * @brief   Starts writing the map.
+     * @param   path    The path of the map, defaults to `/tmp/perf-<pid>.map`, where `perf`
+     *                  looks for it. Existing maps are appended to.
+     * @return  @c true if the map is written, @c false if it couldn't be opened or the platform
+     *          isn't supported.
+     */
+    bool enable(std::string path = {})
+    {
+#       if defined(REMODEL_PERF_MAP_SUPPORTED)
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_file) return true;
+            if (path.empty()) path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+            m_file = std::fopen(path.c_str(), "a");
+            m_enabled.store(m_file != nullptr, std::memory_order_release);
+            return m_file != nullptr;
+#       else
+            (void)path;
+            return false;
+#       endif
+    }
+
+    /**
+     * @brief   Stops writing the map, closing the file.
+     */
+    void disable()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_enabled.store(false, std::memory_order_relaxed);
+        if (m_file) std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    /**
+     * @brief   Determines whether the map is written.
+     * @return  @c true if enabled, else @c false.
+     */
+    bool isEnabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+    /**
+     * @brief   Adds a symbol.
+     * @param   code    The address of the code.
+     * @param   size    The size of the code, in bytes.
+     * @param   name    The name of the symbol.
+     * @return  @c true if added, @c false if disabled.
+     */
+    bool add(const void* code, std::size_t size, const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_file) return false;
+        std::fprintf(m_file, "%llx %llx %s\n",
+            static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(code)),
+            static_cast<unsigned long long>(size), name.c_str());
+        std::fflush(m_file);
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ZoneScope]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A profiler zone from construction until destruction, in all compiled-in backends.
+ *
+ * Meant for detours and other code calling functions not wrapped with `instrumented`:
+ * @code
+ *     int detour(int x)
+ *     {
+ *         static const auto& site = ZoneSite::intern("Dog::giveGoodie");
+ *         ZoneScope zone{site};
+ *         return hook->original()(x);
+ *     }
+ * @endcode
+ */
+class ZoneScope : public zycore::NonCopyable
+{
+#   if defined(REMODEL_INSTRUMENT_TRACY_ACTIVE)
+    ___tracy_c_zone_context m_tracyZone; // `TracyCZoneCtx` is const
+#   endif
+#   if defined(REMODEL_INSTRUMENT_ETW)
+    const ZoneSite& m_site;
+#   endif
+public:
+    /**
+     * @brief   Constructor, entering the zone.
+     * @param   site    The site of the zone.
+     * @param   code    If non-null, the address of the called code, added to the `PerfMap`.
+     */
+    explicit ZoneScope(const ZoneSite& site, const void* code = nullptr)
+#       if defined(REMODEL_INSTRUMENT_ETW)
+        : m_site{site}
+#       endif
+    {
+        if (code && site.codeSize() && PerfMap::global().isEnabled() && site.noteCode(code))
+        {
+            PerfMap::global().add(code, site.codeSize(), site.name());
+        }
+#       if defined(REMODEL_INSTRUMENT_TRACY_ACTIVE)
+            m_tracyZone = ___tracy_emit_zone_begin(site.srcloc(), 1);
+#       endif
+#       if defined(REMODEL_INSTRUMENT_ETW)
+            TraceLoggingWrite(REMODEL_INSTRUMENT_ETW_PROVIDER, "RemodelCall",
+                TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                TraceLoggingString(site.name().c_str(), "Name"),
+                TraceLoggingPointer(code, "Code"));
+#       endif
+    }
+
+    /**
+     * @brief   Destructor, leaving the zone.
+     */
+    ~ZoneScope()
+    {
+#       if defined(REMODEL_INSTRUMENT_ETW)
+            TraceLoggingWrite(REMODEL_INSTRUMENT_ETW_PROVIDER, "RemodelCall",
+                TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                TraceLoggingString(m_site.name().c_str(), "Name"));
+#       endif
+#       if defined(REMODEL_INSTRUMENT_TRACY_ACTIVE)
+            ___tracy_emit_zone_end(m_tracyZone);
+#       endif
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [Instrumented]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Gets the code called by a function wrapper (`Function`, `MemberFunction`, ...).
+ */
+template<typename FuncT>
+inline auto instrumentedCodeOf(const FuncT& func, int)
+    -> decltype(reinterpret_cast<const void*>(func.get()))
+{
+    return reinterpret_cast<const void*>(func.get());
+}
+
+/**
+ * @internal
+ * @brief   Gets the code called by a function pointer.
+ */
+template<typename FuncT>
+inline std::enable_if_t<std::is_pointer<FuncT>::value, const void*>
+    instrumentedCodeOf(const FuncT& func, long)
+{
+    return reinterpret_cast<const void*>(func);
+}
+
+/**
+ * @internal
+ * @brief   Other callables don't expose their code.
+ */
+inline const void* instrumentedCodeOf(...) { return nullptr; }
+
+} // namespace internal
+
+/**
+ * @brief   Callable entering a profiler zone for each call of another callable.
+ * @tparam  FuncT   The type of the instrumented callable, e.g. a `Function` or `MemberFunction`.
+ *
+ * Create instances with `instrumented`.
+ */
+template<typename FuncT>
+class Instrumented
+{
+    const FuncT* m_func;
+    const ZoneSite* m_site;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   func    The instrumented callable, must outlive the instance.
+     * @param   site    The site of the zone.
+     */
+    Instrumented(const FuncT& func, const ZoneSite& site)
+        : m_func{&func}
+        , m_site{&site}
+    {}
+
+    /**
+     * @brief   Gets the site of the zone.
+     * @return  The site.
+     */
+    const ZoneSite& site() const { return *m_site; }
+
+    template<typename... ArgsT>
+    auto operator () (ArgsT&&... args) const
+        -> decltype(std::declval<const FuncT&>()(std::forward<ArgsT>(args)...))
+    {
+        ZoneScope zone{*m_site, internal::instrumentedCodeOf(*m_func, 0)};
+        return (*m_func)(std::forward<ArgsT>(args)...);
+    }
+};
+
+/**
+ * @brief   Wraps a callable to enter a profiler zone for each call.
+ * @param   func        The callable, e.g. a `Function`, `MemberFunction`, `VirtualFunction` or
+ *                      `Hook::original()`. Must outlive the result.
+ * @param   name        The zone name, conventionally `Wrapper::field`.
+ * @param   codeSize    The size of the function's code, for `PerfMap`. 0 if unknown.
+ * @return  The wrapped callable.
+ *
+ * @code
+ *     auto giveGoodie = instrumented(dog.giveGoodie, "Dog::giveGoodie", 0x5A);
+ *     giveGoodie(7); // shows up as Dog::giveGoodie in Tracy, WPA or perf
+ * @endcode
+ */
+template<typename FuncT>
+inline Instrumented<FuncT> instrumented(
+    const FuncT& func, const std::string& name, std::size_t codeSize = 0)
+{
+    return Instrumented<FuncT>{func, ZoneSite::intern(name, codeSize)};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_INSTRUMENT_HPP
@@ -0,0 +1,1715 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_MEMORY_HPP
+#define REMODEL_MEMORY_HPP
+
+/**     
+ * @file
+ * @brief Contains memory backends allowing to use wrappers on objects outside of our own address
+ *        space.
+ *        
+ * Fields resolve to references into the memory of the wrapped objects, which obviously doesn't
+ * work for objects living in another process. Instead, objects are transferred into local 
+ * storage with a `MemoryBackend` (see `RemoteSnapshot`), where they can be accessed with just 
+ * the same wrapper definitions, and written back afterwards.
+ */
+
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Platform.hpp"
+
+namespace remodel
+{
+
+// ============================================================================================== //
+// Memory backends                                                                                //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [MemoryBackend]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Interface for classes providing access to an address space.
+ */
+class MemoryBackend : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   Destructor.
+     */
+    virtual ~MemoryBackend() = default;
+
+    /**
+     * @brief   Reads memory.
+     * @param   address The address to read from.
+     * @param   out     The buffer receiving the data.
+     * @param   size    The number of bytes to read.
+     * @return  @c true if all bytes were read, else @c false.
+     */
+    virtual bool read(uintptr_t address, void* out, std::size_t size) = 0;
+
+    /**
+     * @brief   Writes memory.
+     * @param   address The address to write to.
+     * @param   in      The data to write.
+     * @param   size    The number of bytes to write.
+     * @return  @c true if all bytes were written, else @c false.
+     */
+    virtual bool write(uintptr_t address, const void* in, std::size_t size) = 0;
+
+    /**
+     * @brief   Reads multiple ranges of memory.
+     * @param   ranges  The ranges to read.
+     * @param   count   The number of ranges.
+     * @return  @c true if all ranges were read, else @c false.
+     *          
+     * The default implementation calls `read` for every range, backends that can do better 
+     * (e.g. with a single syscall) override this.
+     */
+    virtual bool readBatch(const platform::IoRange* ranges, std::size_t count)
+    {
+        bool success = true;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            success &= read(ranges[i].address, ranges[i].buffer, ranges[i].size);
+        }
+        return success;
+    }
+
+    /**
+     * @brief   Writes multiple ranges of memory, in the given order.
+     * @param   ranges  The ranges to write.
+     * @param   count   The number of ranges.
+     * @return  @c true if all ranges were written, else @c false.
+     * @copydetails readBatch
+     */
+    virtual bool writeBatch(const platform::IoRange* ranges, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!write(ranges[i].address, ranges[i].buffer, ranges[i].size)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Starts tracking writes to a range of memory anew.
+     * @param   address The start of the range.
+     * @param   size    The size of the range, in bytes.
+     * @return  @c true if writes are tracked from now on, else @c false.
+     * @see     platform::resetDirtyPages
+     *          
+     * The default implementation doesn't support tracking.
+     */
+    virtual bool resetDirtyPages(uintptr_t address, std::size_t size)
+    {
+        (void)address; (void)size;
+        return false;
+    }
+
+    /**
+     * @brief   Determines the pages written to since the last `resetDirtyPages`.
+     * @param   address The start of the range, page aligned.
+     * @param   size    The size of the range, in bytes.
+     * @param   pages   Receives the addresses of the written pages, in ascending order.
+     * @return  @c true on success, @c false if writes aren't tracked.
+     * @see     platform::queryDirtyPages
+     * @copydetails resetDirtyPages
+     */
+    virtual bool queryDirtyPages(uintptr_t address, std::size_t size, 
+        std::vector<uintptr_t>& pages)
+    {
+        (void)address; (void)size;
+        pages.clear();
+        return false;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [LocalMemory]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory backend accessing our own address space.
+ */
+class LocalMemory : public MemoryBackend
+{
+public:
+    bool read(uintptr_t address, void* out, std::size_t size) override
+    {
+        std::memcpy(out, reinterpret_cast<const void*>(address), size);
+        return true;
+    }
+
+    bool write(uintptr_t address, const void* in, std::size_t size) override
+    {
+        std::memcpy(reinterpret_cast<void*>(address), in, size);
+        return true;
+    }
+
+    bool resetDirtyPages(uintptr_t address, std::size_t size) override
+    {
+        return platform::resetDirtyPages(platform::currentProcess(), address, size);
+    }
+
+    bool queryDirtyPages(uintptr_t address, std::size_t size, 
+        std::vector<uintptr_t>& pages) override
+    {
+        return platform::queryDirtyPages(platform::currentProcess(), address, size, pages);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ProcessMemory]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory backend accessing the address space of another process.
+ *          
+ * Uses `process_vm_readv` / `process_vm_writev` on Linux and `ReadProcessMemory` / 
+ * `WriteProcessMemory` on Windows. Other platforms (OS X) are not supported, `isValid` always
+ * returns @c false there.
+ */
+class ProcessMemory : public MemoryBackend
+{
+    platform::ProcessHandle m_process;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   pid The ID of the process to access.
+     */
+    explicit ProcessMemory(uint32_t pid)
+        : m_process{platform::openProcess(pid)}
+    {}
+
+    /**
+     * @brief   Destructor.
+     */
+    ~ProcessMemory()
+    {
+        platform::closeProcess(m_process);
+    }
+
+    /**
+     * @brief   Determines whether the process was opened successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_process != platform::kInvalidProcess; }
+
+    /**
+     * @brief   Gets the handle of the process.
+     * @return  The process handle.
+     */
+    platform::ProcessHandle process() const { return m_process; }
+
+    bool read(uintptr_t address, void* out, std::size_t size) override
+    {
+        return platform::readProcessMemory(m_process, address, out, size) == size;
+    }
+
+    bool write(uintptr_t address, const void* in, std::size_t size) override
+    {
+        return platform::writeProcessMemory(m_process, address, in, size) == size;
+    }
+
+    bool readBatch(const platform::IoRange* ranges, std::size_t count) override
+    {
+        return platform::readProcessMemoryBatch(m_process, ranges, count);
+    }
+
+    bool writeBatch(const platform::IoRange* ranges, std::size_t count) override
+    {
+        return platform::writeProcessMemoryBatch(m_process, ranges, count);
+    }
+
+    bool resetDirtyPages(uintptr_t address, std::size_t size) override
+    {
+        return platform::resetDirtyPages(m_process, address, size);
+    }
+
+    bool queryDirtyPages(uintptr_t address, std::size_t size, 
+        std::vector<uintptr_t>& pages) override
+    {
+        return platform::queryDirtyPages(m_process, address, size, pages);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [DumpMemory]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory backend serving the address space captured in an ELF core dump or a Windows 
+ *          minidump.
+ *          
+ * The dump is mapped copy-on-write and a sorted table translating virtual addresses to offsets
+ * into the file is built once. Other than with other backends, objects don't need to be copied
+ * out of the dump: `translate` returns pointers right into the mapping, which can be used with 
+ * `wrapper_cast` directly. Writes only modify the mapping, never the dump file itself.
+ * 
+ * @code
+ *     DumpMemory dump{"game.core"};
+ *     if (auto dogPtr = dump.translate(dogAddress, Dog::kObjSize))
+ *     {
+ *         auto dog = wrapper_cast<Dog>(dogPtr);
+ *         std::cout << dog.age << std::endl;
+ *     }
+ * @endcode
+ */
+class DumpMemory : public MemoryBackend
+{
+public:
+    /**
+     * @brief   Supported dump formats.
+     */
+    enum class Format
+    {
+        Invalid,
+        ElfCore,
+        Minidump,
+    };
+
+    /**
+     * @brief   A range of the captured address space.
+     */
+    struct Segment
+    {
+        uintptr_t address;
+        std::size_t size;
+        std::size_t fileOffset;
+    };
+private:
+    platform::MappedFile m_file;
+    Format m_format = Format::Invalid;
+    std::vector<Segment> m_segments;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   path    The path of the dump file.
+     */
+    explicit DumpMemory(const char* path)
+        : m_file{platform::mapFile(path)}
+    {
+        if (!m_file.data) return;
+        if (!parseElfCore())
+        {
+            m_segments.clear();
+            if (!parseMinidump())
+            {
+                m_segments.clear();
+                platform::unmapFile(m_file);
+                return;
+            }
+        }
+
+        std::sort(m_segments.begin(), m_segments.end(), 
+            [](const Segment& a, const Segment& b) { return a.address < b.address; });
+    }
+
+    /**
+     * @brief   Destructor.
+     */
+    ~DumpMemory()
+    {
+        platform::unmapFile(m_file);
+    }
+
+    /**
+     * @brief   Determines whether the dump was loaded successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_format != Format::Invalid; }
+
+    /**
+     * @brief   Gets the format of the dump.
+     * @return  The format.
+     */
+    Format format() const { return m_format; }
+
+    /**
+     * @brief   Gets the segments captured in the dump, sorted by address.
+     * @return  The segments.
+     */
+    const std::vector<Segment>& segments() const { return m_segments; }
+
+    /**
+     * @brief   Translates an address of the captured address space to a pointer into the 
+     *          mapped dump.
+     * @param   address The address to translate.
+     * @param   size    The number of bytes that are required to be captured from @c address on.
+     * @return  If completely captured (in a single segment), the pointer, else @c nullptr.
+     */
+    void* translate(uintptr_t address, std::size_t size = 1) const
+    {
+        auto it = std::upper_bound(m_segments.begin(), m_segments.end(), address, 
+            [](uintptr_t addr, const Segment& seg) { return addr < seg.address; });
+        if (it == m_segments.begin()) return nullptr;
+        --it;
+
+        const std::size_t offs = address - it->address;
+        if (offs >= it->size || it->size - offs < size) return nullptr;
+        return static_cast<uint8_t*>(m_file.data) + it->fileOffset + offs;
+    }
+
+    bool read(uintptr_t address, void* out, std::size_t size) override
+    {
+        // Separate segments may well be contiguous in the address space, so walk them.
+        auto dst = static_cast<uint8_t*>(out);
+        while (size)
+        {
+            auto src = static_cast<uint8_t*>(translate(address));
+            if (!src) return false;
+
+            const std::size_t avail = segmentRemaining(address);
+            const std::size_t chunk = size < avail ? size : avail;
+            std::memcpy(dst, src, chunk);
+
+            address += chunk;
+            dst     += chunk;
+            size    -= chunk;
+        }
+        return true;
+    }
+
+    bool write(uintptr_t address, const void* in, std::size_t size) override
+    {
+        auto src = static_cast<const uint8_t*>(in);
+        while (size)
+        {
+            auto dst = static_cast<uint8_t*>(translate(address));
+            if (!dst) return false;
+
+            const std::size_t avail = segmentRemaining(address);
+            const std::size_t chunk = size < avail ? size : avail;
+            std::memcpy(dst, src, chunk);
+
+            address += chunk;
+            src     += chunk;
+            size    -= chunk;
+        }
+        return true;
+    }
+private:
+    std::size_t segmentRemaining(uintptr_t address) const
+    {
+        auto it = std::prev(std::upper_bound(m_segments.begin(), m_segments.end(), address, 
+            [](uintptr_t addr, const Segment& seg) { return addr < seg.address; }));
+        return it->size - (address - it->address);
+    }
+
+    template<typename T>
+    bool load(std::size_t offset, T& out) const
+    {
+        if (offset > m_file.size || m_file.size - offset < sizeof(T)) return false;
+        std::memcpy(&out, static_cast<const uint8_t*>(m_file.data) + offset, sizeof(T));
+        return true;
+    }
+
+    bool addSegment(uint64_t address, uint64_t size, uint64_t fileOffset)
+    {
+        if (fileOffset > m_file.size || m_file.size - fileOffset < size) return false;
+        if (size) 
+        {
+            m_segments.push_back({static_cast<uintptr_t>(address), 
+                static_cast<std::size_t>(size), static_cast<std::size_t>(fileOffset)});
+        }
+        return true;
+    }
+
+    bool parseElfCore()
+    {
+        // We only support little endian dumps of the bitness we were compiled for.
+        static const uint8_t kElfClass = sizeof(void*) == 8 ? 2 : 1;
+        static const uint16_t kEtCore  = 4;
+        static const uint32_t kPtLoad  = 1;
+
+        uint8_t ident[16];
+        if (!load(0, ident) || std::memcmp(ident, "\x7F" "ELF", 4) != 0 
+            || ident[4] != kElfClass || ident[5] != 1 /* little endian */)
+        {
+            return false;
+        }
+
+        uint16_t type, phentsize, phnum;
+        uint64_t phoff;
+        if (kElfClass == 2)
+        {
+            if (!load(16, type) || !load(32, phoff) || !load(54, phentsize) || !load(56, phnum))
+                return false;
+        }
+        else
+        {
+            uint32_t phoff32;
+            if (!load(16, type) || !load(28, phoff32) || !load(42, phentsize) || !load(44, phnum))
+                return false;
+            phoff = phoff32;
+        }
+        if (type != kEtCore) return false;
+
+        for (uint16_t i = 0; i < phnum; ++i)
+        {
+            const std::size_t ph = static_cast<std::size_t>(phoff) + i * phentsize;
+            uint32_t ptype;
+            uint64_t offset, vaddr, filesz;
+            if (kElfClass == 2)
+            {
+                if (!load(ph, ptype) || !load(ph + 8, offset) || !load(ph + 16, vaddr) 
+                    || !load(ph + 32, filesz))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                uint32_t offset32, vaddr32, filesz32;
+                if (!load(ph, ptype) || !load(ph + 4, offset32) || !load(ph + 8, vaddr32) 
+                    || !load(ph + 16, filesz32))
+                {
+                    return false;
+                }
+                offset = offset32; vaddr = vaddr32; filesz = filesz32;
+            }
+
+            // Only the file-backed part of a segment is captured.
+            if (ptype == kPtLoad && !addSegment(vaddr, filesz, offset)) return false;
+        }
+
+        m_format = Format::ElfCore;
+        return true;
+    }
+
+    bool parseMinidump()
+    {
+        static const uint32_t kSignature          = 0x504D444D; // 'MDMP'
+        static const uint32_t kMemoryListStream   = 5;
+        static const uint32_t kMemory64ListStream = 9;
+
+        uint32_t signature, numStreams, dirRva;
+        if (!load(0, signature) || signature != kSignature 
+            || !load(8, numStreams) || !load(12, dirRva))
+        {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < numStreams; ++i)
+        {
+            const std::size_t dir = dirRva + i * 12;
+            uint32_t streamType, rva;
+            if (!load(dir, streamType) || !load(dir + 8, rva)) return false;
+
+            if (streamType == kMemory64ListStream)
+            {
+                uint64_t numRanges, dataRva;
+                if (!load(rva, numRanges) || !load(rva + 8, dataRva)) return false;
+                for (uint64_t j = 0; j < numRanges; ++j)
+                {
+                    uint64_t start, size;
+                    const std::size_t desc = rva + 16 + static_cast<std::size_t>(j) * 16;
+                    if (!load(desc, start) || !load(desc + 8, size) 
+                        || !addSegment(start, size, dataRva))
+                    {
+                        return false;
+                    }
+                    dataRva += size;
+                }
+            }
+            else if (streamType == kMemoryListStream)
+            {
+                uint32_t numRanges;
+                if (!load(rva, numRanges)) return false;
+                for (uint32_t j = 0; j < numRanges; ++j)
+                {
+                    uint64_t start;
+                    uint32_t size, dataRva;
+                    const std::size_t desc = rva + 4 + j * 16;
+                    if (!load(desc, start) || !load(desc + 8, size) || !load(desc + 12, dataRva)
+                        || !addSegment(start, size, dataRva))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        m_format = Format::Minidump;
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [SharedMemory]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory backend serving a named shared memory region.
+ *
+ * Meant for an agent inside of the target and a tool outside of it exchanging objects without
+ * copying them: the agent places objects (or copies of them) into the region and the tool maps
+ * the same region and wraps them where they are. As the region is mapped at different addresses
+ * in each process, addresses of this backend are offsets into the region, which `translate` 
+ * turns into pointers usable with `wrapper_cast`. Offsets of objects can be published with a
+ * `SpscChannel` placed in the region as well.
+ * @code
+ *     // Tool
+ *     SharedMemory shm{"/dogs"};
+ *     auto channel = SpscChannel<uint64_t, 1024>::attach(shm.translate(0, kChannelSize));
+ *     uint64_t offset;
+ *     while (channel->pop(offset))
+ *     {
+ *         auto dog = wrapper_cast<Dog>(shm.translate(offset, Dog::kObjSize));
+ *         std::cout << dog.age << std::endl;
+ *     }
+ * @endcode
+ */
+class SharedMemory : public MemoryBackend
+{
+    platform::SharedMapping m_mapping;
+public:
+    /**
+     * @brief   Constructor, creates or opens the region.
+     * @param   name    The name of the region.
+     * @param   size    The size of the region, @c 0 to open an existing one.
+     * @see     platform::mapSharedMemory
+     */
+    explicit SharedMemory(const char* name, std::size_t size = 0)
+        : m_mapping{platform::mapSharedMemory(name, size)}
+    {}
+
+    /**
+     * @brief   Destructor.
+     */
+    ~SharedMemory()
+    {
+        platform::unmapSharedMemory(m_mapping);
+    }
+
+    /**
+     * @brief   Determines whether the region was mapped successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_mapping.data != nullptr; }
+
+    /**
+     * @brief   Gets the size of the region.
+     * @return  The size, in bytes.
+     */
+    std::size_t size() const { return m_mapping.size; }
+
+    /**
+     * @brief   Translates an offset into the region to a pointer into our mapping of it.
+     * @param   offset  The offset.
+     * @param   size    The number of bytes that are required to be inside the region.
+     * @return  If inside the region, the pointer, else @c nullptr.
+     */
+    void* translate(uintptr_t offset, std::size_t size = 1) const
+    {
+        if (offset > m_mapping.size || m_mapping.size - offset < size) return nullptr;
+        return static_cast<uint8_t*>(m_mapping.data) + offset;
+    }
+
+    bool read(uintptr_t address, void* out, std::size_t size) override
+    {
+        auto ptr = translate(address, size);
+        if (!ptr) return false;
+        std::memcpy(out, ptr, size);
+        return true;
+    }
+
+    bool write(uintptr_t address, const void* in, std::size_t size) override
+    {
+        auto ptr = translate(address, size);
+        if (!ptr) return false;
+        std::memcpy(ptr, in, size);
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [SpscChannel]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Lock-free queue for a single producer and a single consumer, placed in memory shared 
+ *          by both of them (e.g. a `SharedMemory` region).
+ * @tparam  T           The type of the values, trivially copyable (e.g. offsets of objects).
+ * @tparam  capacityT   The maximum number of values queued, a power of two.
+ *
+ * The channel only consists of two indices and its slots, without any pointers, so it works in
+ * mappings at different addresses. One side places it in the memory with `create`, the other 
+ * side uses `attach`.
+ */
+template<typename T, std::size_t capacityT>
+class SpscChannel
+{
+    static_assert(std::is_trivially_copyable<T>::value, "values are required to be trivial");
+    static_assert(capacityT && !(capacityT & (capacityT - 1)), 
+        "capacity is required to be a power of two");
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, 
+        "lock-free atomics are required to share them between processes");
+
+    // Separate cache lines, so the sides don't contend for them.
+    alignas(64) std::atomic<uint32_t> m_head; // Next slot to write to, owned by the producer.
+    alignas(64) std::atomic<uint32_t> m_tail; // Next slot to read from, owned by the consumer.
+    alignas(64) T m_slots[capacityT];
+
+    SpscChannel() : m_head{0}, m_tail{0} {}
+public:
+    static const std::size_t kCapacity = capacityT;
+
+    /**
+     * @brief   Places an empty channel in memory.
+     * @param   memory  The memory, @c sizeof(SpscChannel) bytes aligned to 64 bytes.
+     * @return  The channel.
+     */
+    static SpscChannel* create(void* memory)
+    {
+        return new (memory) SpscChannel;
+    }
+
+    /**
+     * @brief   Uses a channel placed in memory with `create`, e.g. by another process.
+     * @param   memory  The memory.
+     * @return  The channel.
+     */
+    static SpscChannel* attach(void* memory)
+    {
+        return static_cast<SpscChannel*>(memory);
+    }
+
+    /**
+     * @brief   Queues a value, to be called by the producer.
+     * @param   value   The value.
+     * @return  @c true if queued, @c false if the channel is full.
+     */
+    bool push(const T& value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == capacityT) return false;
+        m_slots[head & (capacityT - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Dequeues a value, to be called by the consumer.
+     * @param   value   Receives the value.
+     * @return  @c true if dequeued, @c false if the channel is empty.
+     */
+    bool pop(T& value)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        value = m_slots[tail & (capacityT - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Gets the number of values queued, only a snapshot while the other side is active.
+     * @return  The number of values.
+     */
+    std::size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+};
+
+template<typename T, std::size_t capacityT>
+const std::size_t SpscChannel<T, capacityT>::kCapacity;
+
+// ---------------------------------------------------------------------------------------------- //
+// [CachedMemory]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory backend decorator caching reads from another backend in pages.
+ *          
+ * Reads are served from a LRU cache of 4 KiB pages, so many small reads of nearby data cost a
+ * single read from the underlying backend per page. Writes are passed through and update the
+ * cached pages. As the cache can't know when the other side changes the memory, it has to be
+ * invalidated explicitly, e.g. once per frame or tick.
+ */
+class CachedMemory : public MemoryBackend
+{
+public:
+    static const std::size_t kPageSize = 0x1000;
+
+    /**
+     * @brief   Cache statistics.
+     */
+    struct Stats
+    {
+        std::size_t hits   = 0;
+        std::size_t misses = 0;
+    };
+private:
+    struct Page
+    {
+        uintptr_t base;
+        uint8_t data[kPageSize];
+    };
+
+    MemoryBackend* m_backend;
+    std::size_t m_maxPages;
+    std::list<Page> m_lru; // most recently used first
+    std::unordered_map<uintptr_t, std::list<Page>::iterator> m_pages;
+    Stats m_stats;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   backend     The backend to read from.
+     * @param   maxPages    The maximum number of pages kept in the cache.
+     */
+    explicit CachedMemory(MemoryBackend& backend, std::size_t maxPages = 256)
+        : m_backend{&backend}
+        , m_maxPages{maxPages ? maxPages : 1}
+    {}
+
+    bool read(uintptr_t address, void* out, std::size_t size) override
+    {
+        auto dst = static_cast<uint8_t*>(out);
+        while (size)
+        {
+            const uintptr_t base = address & ~static_cast<uintptr_t>(kPageSize - 1);
+            const std::size_t offs  = address - base;
+            const std::size_t chunk = size < kPageSize - offs ? size : kPageSize - offs;
+
+            auto page = fetchPage(base);
+            if (page)
+            {
+                std::memcpy(dst, page->data + offs, chunk);
+            }
+            // Pages that can't be read as a whole (e.g. at the end of a mapping) aren't cached.
+            else if (!m_backend->read(address, dst, chunk))
+            {
+                return false;
+            }
+
+            address += chunk;
+            dst     += chunk;
+            size    -= chunk;
+        }
+
+        return true;
+    }
+
+    bool write(uintptr_t address, const void* in, std::size_t size) override
+    {
+        if (!m_backend->write(address, in, size)) 
+        {
+            invalidate(address, size);
+            return false;
+        }
+
+        // Keep cached pages in sync.
+        auto src = static_cast<const uint8_t*>(in);
+        while (size)
+        {
+            const uintptr_t base = address & ~static_cast<uintptr_t>(kPageSize - 1);
+            const std::size_t offs  = address - base;
+            const std::size_t chunk = size < kPageSize - offs ? size : kPageSize - offs;
+
+            auto it = m_pages.find(base);
+            if (it != m_pages.end())
+            {
+                std::memcpy(it->second->data + offs, src, chunk);
+            }
+
+            address += chunk;
+            src     += chunk;
+            size    -= chunk;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief   Drops all cached pages.
+     */
+    void invalidate()
+    {
+        m_pages.clear();
+        m_lru.clear();
+    }
+
+    /**
+     * @brief   Drops all cached pages overlapping a range.
+     * @param   address The start of the range.
+     * @param   size    The size of the range, in bytes.
+     */
+    void invalidate(uintptr_t address, std::size_t size)
+    {
+        if (!size) return;
+        const uintptr_t last = (address + size - 1) & ~static_cast<uintptr_t>(kPageSize - 1);
+        for (uintptr_t base = address & ~static_cast<uintptr_t>(kPageSize - 1); ; 
+                base += kPageSize)
+        {
+            auto it = m_pages.find(base);
+            if (it != m_pages.end())
+            {
+                m_lru.erase(it->second);
+                m_pages.erase(it);
+            }
+            if (base == last) break;
+        }
+    }
+
+    /**
+     * @brief   Gets the cache statistics.
+     * @return  The statistics.
+     */
+    const Stats& stats() const { return m_stats; }
+
+    /**
+     * @brief   Resets the cache statistics.
+     */
+    void resetStats() { m_stats = Stats{}; }
+private:
+    Page* fetchPage(uintptr_t base)
+    {
+        auto it = m_pages.find(base);
+        if (it != m_pages.end())
+        {
+            ++m_stats.hits;
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return &*it->second;
+        }
+
+        ++m_stats.misses;
+
+        // Recycle the least recently used page if the cache is full.
+        if (m_pages.size() >= m_maxPages)
+        {
+            m_pages.erase(m_lru.back().base);
+            m_lru.splice(m_lru.begin(), m_lru, std::prev(m_lru.end()));
+        }
+        else
+        {
+            m_lru.emplace_front();
+        }
+
+        auto& page = m_lru.front();
+        if (!m_backend->read(base, page.data, kPageSize))
+        {
+            m_lru.pop_front();
+            return nullptr;
+        }
+
+        page.base = base;
+        m_pages.emplace(base, m_lru.begin());
+        return &page;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [WriteCombiningMemory]                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory backend decorator buffering writes to another backend until committed.
+ *          
+ * Writes are collected in a buffer of disjoint ranges, overlapping and adjacent writes are 
+ * merged (later writes win). Reads see pending writes. On `commit`, all ranges are passed to 
+ * `MemoryBackend::writeBatch` at once, in ascending address order. The commit is not atomic:
+ * if it fails, a prefix of the ranges may have been written already. The buffer is cleared
+ * either way.
+ */
+class WriteCombiningMemory : public MemoryBackend
+{
+    MemoryBackend* m_backend;
+    std::map<uintptr_t, std::vector<uint8_t>> m_pending;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   backend The backend to write to.
+     */
+    explicit WriteCombiningMemory(MemoryBackend& backend)
+        : m_backend{&backend}
+    {}
+
+    bool read(uintptr_t address, void* out, std::size_t size) override
+    {
+        if (!m_backend->read(address, out, size)) return false;
+
+        // Overlay pending writes.
+        const uintptr_t end = address + size;
+        auto it = m_pending.upper_bound(address);
+        if (it != m_pending.begin()) --it;
+        for (; it != m_pending.end() && it->first < end; ++it)
+        {
+            const uintptr_t lo = std::max(address, it->first);
+            const uintptr_t hi = std::min(end, it->first + it->second.size());
+            if (lo < hi)
+            {
+                std::memcpy(static_cast<uint8_t*>(out) + (lo - address), 
+                    it->second.data() + (lo - it->first), hi - lo);
+            }
+        }
+
+        return true;
+    }
+
+    bool write(uintptr_t address, const void* in, std::size_t size) override
+    {
+        if (!size) return true;
+
+        uintptr_t start = address;
+        uintptr_t end   = address + size;
+
+        // Find all pending ranges overlapping or adjacent to the new one.
+        auto first = m_pending.upper_bound(address);
+        if (first != m_pending.begin() && std::prev(first)->first 
+                + std::prev(first)->second.size() >= address)
+        {
+            --first;
+        }
+        auto last = first;
+        for (; last != m_pending.end() && last->first <= end; ++last)
+        {
+            start = std::min(start, last->first);
+            end   = std::max(end, last->first + last->second.size());
+        }
+
+        // Merge them, applying the new data last.
+        std::vector<uint8_t> merged(end - start);
+        for (auto it = first; it != last; ++it)
+        {
+            std::memcpy(merged.data() + (it->first - start), it->second.data(), it->second.size());
+        }
+        std::memcpy(merged.data() + (address - start), in, size);
+
+        m_pending.erase(first, last);
+        m_pending.emplace(start, std::move(merged));
+        return true;
+    }
+
+    /**
+     * @brief   Writes all pending data to the backend.
+     * @return  @c true on success, else @c false.
+     */
+    bool commit()
+    {
+        std::vector<platform::IoRange> ranges;
+        ranges.reserve(m_pending.size());
+        for (auto& cur : m_pending)
+        {
+            ranges.push_back({cur.first, cur.second.data(), cur.second.size()});
+        }
+
+        const bool success = m_backend->writeBatch(ranges.data(), ranges.size());
+        m_pending.clear();
+        return success;
+    }
+
+    /**
+     * @brief   Drops all pending writes.
+     */
+    void discard() { m_pending.clear(); }
+
+    /**
+     * @brief   Gets the number of disjoint ranges pending.
+     * @return  The number of ranges.
+     */
+    std::size_t pendingRanges() const { return m_pending.size(); }
+};
+
+// ============================================================================================== //
+// Wrappers for objects in other address spaces                                                   //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [RemoteSnapshot]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Wrapper for a local copy of an object read from a memory backend.
+ * @tparam  WrapperT    Wrapper type, required to be derived from `AdvancedClassWrapper`.
+ *                      
+ * Fields of the wrapper access the local copy. Pointers stored in the object still refer to the
+ * address space of the backend and have to be read with another `RemoteSnapshot`. Functions 
+ * can't be invoked on remote objects.
+ * 
+ * @code
+ *     ProcessMemory game{gamePid};
+ *     auto dog = readRemote<Dog>(game, dogAddress);
+ *     if (dog)
+ *     {
+ *         ++dog.value().age;
+ *         dog.value().flush();
+ *     }
+ * @endcode
+ */
+template<typename WrapperT>
+class RemoteSnapshot : public WrapperT
+{
+    union
+    {
+        uint8_t m_data[WrapperT::kObjSize];
+        typename std::aligned_storage<1, WrapperT::kObjAlign>::type m_alignment;
+    };
+    MemoryBackend* m_memory;
+    uintptr_t m_source;
+public:
+    /**
+     * @brief   Constructor. Doesn't read the object yet, see `refresh`.
+     * @param   memory  The memory backend to use.
+     * @param   source  The address of the object in the address space of the backend.
+     */
+    RemoteSnapshot(MemoryBackend& memory, uintptr_t source)
+        : WrapperT{&m_data}
+        , m_memory{&memory}
+        , m_source{source}
+    {
+        std::memset(m_data, 0, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Copy constructor.
+     * @param   other   The instance to copy from.
+     */
+    RemoteSnapshot(const RemoteSnapshot& other)
+        : WrapperT{&m_data}
+        , m_memory{other.m_memory}
+        , m_source{other.m_source}
+    {
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Assignment operator.
+     * @param   other   The instance to assign from.
+     * @return  `*this`.
+     */
+    RemoteSnapshot& operator = (const RemoteSnapshot& other)
+    {
+        m_memory = other.m_memory;
+        m_source = other.m_source;
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+        return *this;
+    }
+
+    /**
+     * @brief   Reads the current state of the object from the backend.
+     * @return  @c true on success, else @c false.
+     */
+    bool refresh()
+    {
+        return m_memory->read(m_source, m_data, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Writes the local copy back to the object.
+     * @return  @c true on success, else @c false.
+     */
+    bool flush()
+    {
+        return m_memory->write(m_source, m_data, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Writes a single field of the local copy back to the object.
+     * @param   field   The field to write, required to be a field of this snapshot.
+     * @return  @c true on success, else @c false.
+     */
+    template<typename FieldT>
+    bool flush(FieldT& field)
+    {
+        auto local = reinterpret_cast<const uint8_t*>(field.addressOfObj());
+        return m_memory->write(m_source + (local - m_data), local, sizeof(*field.addressOfObj()));
+    }
+
+    /**
+     * @brief   Gets the address of the object in the address space of the backend.
+     * @return  The address.
+     */
+    uintptr_t source() const { return m_source; }
+
+    /**
+     * @brief   Gets the memory backend used.
+     * @return  The memory backend.
+     */
+    MemoryBackend& memory() const { return *m_memory; }
+};
+
+/**
+ * @brief   Reads an object from a memory backend.
+ * @tparam  WrapperT    Wrapper type, required to be derived from `AdvancedClassWrapper`.
+ * @param   memory      The memory backend to use.
+ * @param   address     The address of the object in the address space of the backend.
+ * @return  If the object could be read, a snapshot of it, else an empty optional.
+ */
+template<typename WrapperT>
+inline zycore::Optional<RemoteSnapshot<WrapperT>> readRemote(
+    MemoryBackend& memory, uintptr_t address)
+{
+    RemoteSnapshot<WrapperT> snap{memory, address};
+    if (!snap.refresh()) return zycore::kEmpty;
+    return {zycore::kInPlace, snap};
+}
+
+/**
+ * @brief   Reads an object from a memory backend.
+ * @copydetails readRemote(MemoryBackend&, uintptr_t)
+ */
+template<typename WrapperT>
+inline zycore::Optional<RemoteSnapshot<WrapperT>> readRemote(
+    MemoryBackend& memory, const void* address)
+{
+    return readRemote<WrapperT>(memory, reinterpret_cast<uintptr_t>(address));
+}
+
+/**
+ * @brief   Reads an object referenced by a pointer of the target.
+ * @copydetails readRemote(MemoryBackend&, uintptr_t)
+ */
+template<typename WrapperT, typename AddrT>
+inline zycore::Optional<RemoteSnapshot<WrapperT>> readRemote(
+    MemoryBackend& memory, TargetPtr<WrapperT, AddrT> address)
+{
+    return readRemote<WrapperT>(memory, static_cast<uintptr_t>(address.address()));
+}
+
+/**
+ * @brief   Reads a trivial object (e.g. another pointer) referenced by a pointer of the target.
+ * @param   memory  The memory backend to use.
+ * @param   ptr     The pointer to the object in the address space of the backend.
+ * @return  If the object could be read, its value, else an empty optional.
+ */
+template<typename T, typename AddrT>
+inline zycore::Optional<T> readTarget(MemoryBackend& memory, TargetPtr<T, AddrT> ptr)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "only trivial objects can be read");
+    T value;
+    if (!memory.read(static_cast<uintptr_t>(ptr.address()), &value, sizeof(value)))
+    {
+        return zycore::kEmpty;
+    }
+    return {zycore::kInPlace, value};
+}
+
+/**
+ * @brief   Looks up a virtual function of an object in the target, like `VfTableGetter` does for
+ *          objects in our own address space.
+ * @tparam  AddrT           The unsigned integer type of the target's pointers.
+ * @param   memory          The memory backend to use.
+ * @param   object          The address of the object in the address space of the backend.
+ * @param   vftableIdx      Index of the function inside the table.
+ * @param   vftableOffset   Offset of the vftable-pointer in the class.
+ * @return  If the table could be read, the address of the function, else an empty optional.
+ */
+template<typename AddrT>
+inline zycore::Optional<uint64_t> readVirtualFunction(MemoryBackend& memory, uint64_t object,
+    std::size_t vftableIdx, std::size_t vftableOffset = 0)
+{
+    auto vftable = readTarget(memory, TargetPtr<TargetPtr<void, AddrT>, AddrT>{
+        object + vftableOffset});
+    if (!vftable) return zycore::kEmpty;
+    auto func = readTarget(memory, TargetPtr<TargetPtr<void, AddrT>, AddrT>{
+        vftable.value().address()} + static_cast<std::ptrdiff_t>(vftableIdx));
+    if (!func) return zycore::kEmpty;
+    return {zycore::kInPlace, func.value().address()};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [ReadBatch]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Collects many small reads and submits them to a memory backend at once.
+ *          
+ * On submission, queued reads are sorted by address and adjacent or overlapping ones are merged
+ * into a single range. All ranges are then passed to `MemoryBackend::readBatch` in one go, which
+ * for `ProcessMemory` on Linux means a single `process_vm_readv` call (per 1024 ranges). 
+ * Batches can be submitted repeatedly, e.g. once per tick.
+ * 
+ * @code
+ *     ReadBatch batch{game};
+ *     batch.add(dog, dog.age);
+ *     batch.add(cat, cat.gender);
+ *     batch.submit();
+ * @endcode
+ */
+class ReadBatch
+{
+    struct Entry
+    {
+        uintptr_t address;
+        void* out;
+        std::size_t size;
+    };
+
+    MemoryBackend* m_memory;
+    std::vector<Entry> m_entries;
+    // Scratch state reused across submissions.
+    std::vector<platform::IoRange> m_ranges;
+    std::vector<uint8_t> m_staging;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   memory  The memory backend to read from.
+     */
+    explicit ReadBatch(MemoryBackend& memory)
+        : m_memory{&memory}
+    {}
+
+    /**
+     * @brief   Queues a read.
+     * @param   address The address to read from.
+     * @param   out     The buffer receiving the data.
+     * @param   size    The number of bytes to read.
+     */
+    void add(uintptr_t address, void* out, std::size_t size)
+    {
+        if (size) m_entries.push_back({address, out, size});
+    }
+
+    /**
+     * @brief   Queues a read of a whole object.
+     * @param   snap    The snapshot to refresh.
+     */
+    template<typename WrapperT>
+    void add(RemoteSnapshot<WrapperT>& snap)
+    {
+        add(snap.source(), snap.addressOfObj(), WrapperT::kObjSize);
+    }
+
+    /**
+     * @brief   Queues a read of a single field of an object.
+     * @param   snap    The snapshot the field belongs to.
+     * @param   field   The field to read.
+     */
+    template<typename WrapperT, typename FieldT>
+    void add(RemoteSnapshot<WrapperT>& snap, FieldT& field)
+    {
+        auto local = reinterpret_cast<uint8_t*>(field.addressOfObj());
+        add(snap.source() + (local - static_cast<uint8_t*>(snap.addressOfObj())), 
+            local, sizeof(*field.addressOfObj()));
+    }
+
+    /**
+     * @brief   Gets the number of queued reads.
+     * @return  The number of queued reads.
+     */
+    std::size_t size() const { return m_entries.size(); }
+
+    /**
+     * @brief   Removes all queued reads.
+     */
+    void clear() { m_entries.clear(); }
+
+    /**
+     * @brief   Performs all queued reads.
+     * @return  @c true if all reads succeeded, else @c false.
+     */
+    bool submit()
+    {
+        std::sort(m_entries.begin(), m_entries.end(), 
+            [](const Entry& a, const Entry& b) { return a.address < b.address; });
+
+        // Pass 1: determine merged ranges and the amount of staging memory required.
+        m_ranges.clear();
+        std::size_t stagingSize = 0;
+        for (std::size_t i = 0, j; i < m_entries.size(); i = j)
+        {
+            uintptr_t end = m_entries[i].address + m_entries[i].size;
+            bool direct = true;
+            for (j = i + 1; j < m_entries.size() && m_entries[j].address <= end; ++j)
+            {
+                // Entries contiguous both locally and remotely can be read in place.
+                direct &= m_entries[j].address == end && static_cast<uint8_t*>(
+                    m_entries[j - 1].out) + m_entries[j - 1].size == m_entries[j].out;
+                end = std::max(end, m_entries[j].address + m_entries[j].size);
+            }
+
+            const std::size_t size = end - m_entries[i].address;
+            m_ranges.push_back({m_entries[i].address, direct ? m_entries[i].out : nullptr, size});
+            if (!direct) stagingSize += size;
+        }
+
+        // Pass 2: assign staging memory and read.
+        m_staging.resize(stagingSize);
+        std::size_t stagingOffs = 0;
+        for (auto& cur : m_ranges)
+        {
+            if (!cur.buffer)
+            {
+                cur.buffer = m_staging.data() + stagingOffs;
+                stagingOffs += cur.size;
+            }
+        }
+
+        if (!m_memory->readBatch(m_ranges.data(), m_ranges.size())) return false;
+
+        // Pass 3: distribute staged data.
+        std::size_t rangeIdx = 0;
+        for (const auto& cur : m_entries)
+        {
+            while (cur.address >= m_ranges[rangeIdx].address + m_ranges[rangeIdx].size)
+            {
+                ++rangeIdx;
+            }
+
+            const auto& range = m_ranges[rangeIdx];
+            auto src = static_cast<uint8_t*>(range.buffer) + (cur.address - range.address);
+            if (src != cur.out) std::memcpy(cur.out, src, cur.size);
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @brief   Queues reads of fields of a remote object, the counterpart of the local `prefetch`.
+ * @param   batch   The batch to queue the reads in, the data arrives on `ReadBatch::submit`.
+ * @param   snap    The snapshot the fields belong to.
+ * @param   fields  Pointers to the fields to read, e.g. `&Dog::age`.
+ *
+ * Iteration code can thus hide the latency of both local and remote memory the same way:
+ * @code
+ *     prefetch(batch, dogs[i + 1], &Dog::age, &Dog::name);
+ * @endcode
+ */
+template<typename WrapperT, typename... FieldPtrsT>
+inline void prefetch(ReadBatch& batch, RemoteSnapshot<WrapperT>& snap, FieldPtrsT... fields)
+{
+    using Expand = int[];
+    (void)Expand{0, (batch.add(snap, snap.*fields), 0)...};
+}
+
+/**
+ * @brief   Reads multiple fields of a remote object into a tuple.
+ * @tparam  WrapperT    The wrapper type, an `AdvancedClassWrapper`.
+ * @param   memory      The memory backend to read from.
+ * @param   address     The address of the object.
+ * @param   fields      Pointers to the fields to read, e.g. `&Cat::age`.
+ * @return  The values as with the local `load`, or nothing if any of the reads failed.
+ *
+ * The reads go through a `ReadBatch`, so they're sorted by address and coalesced into as few
+ * ranges as possible, all read with a single `MemoryBackend::readBatch` call.
+ * @code
+ *     auto cat = load<Cat>(game, catAddress, &Cat::age, &Cat::gender, &Cat::fleas);
+ *     if (cat.hasValue()) feed(std::get<0>(cat.value()));
+ * @endcode
+ */
+template<typename WrapperT, typename... FieldPtrsT>
+inline zycore::Optional<LoadResult<WrapperT, FieldPtrsT...>> load(
+    MemoryBackend& memory, uintptr_t address, FieldPtrsT... fields)
+{
+    RemoteSnapshot<WrapperT> snap{memory, address};
+    ReadBatch batch{memory};
+    prefetch(batch, snap, fields...);
+    if (!batch.submit()) return zycore::kEmpty;
+    return {zycore::kInPlace, load(static_cast<const WrapperT&>(snap), fields...)};
+}
+
+/**
+ * @brief   Queues a read of a whole remote object.
+ * @param   batch   The batch to queue the read in, the data arrives on `ReadBatch::submit`.
+ * @param   snap    The snapshot to refresh.
+ */
+template<typename WrapperT>
+inline void prefetch(ReadBatch& batch, RemoteSnapshot<WrapperT>& snap)
+{
+    batch.add(snap);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Shadow]                                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A local copy-on-write shadow of an object, read lazily and flushed by the byte.
+ * @tparam  WrapperT    Wrapper type, required to be derived from `AdvancedClassWrapper`.
+ * @tparam  kLineSize   The granularity of lazy reads, in bytes, a power of two. Defaults to a
+ *                      cache line, pass e.g. 4096 to read whole pages.
+ *
+ * Unlike `RemoteSnapshot`, nothing is read up front: `operator []` and `ensure` read the lines
+ * covering the requested fields that weren't read yet, all missing ones in a single
+ * `MemoryBackend::readBatch` call. Reads and writes then go to local memory only, so hot
+ * read-modify-write code never touches the backend. `flush` compares the shadow against the
+ * state last read or flushed and writes exactly the changed bytes, again in one batch.
+ *
+ * Fields can't notice plain member accesses, so `shadow.age` only sees the remote value if its
+ * line was read before, via `shadow[&Dog::age]`, `ensure` or `loadAll`. Lines never read hold
+ * zeros; writing to them without reading first is fine, only the written bytes are flushed.
+ *
+ * @code
+ *     Shadow<Dog> dog{game, dogAddress};
+ *     for (int i = 0; i < 100; ++i) dog[&Dog::age] += 1;
+ *     dog.flush(); // one write of one byte
+ * @endcode
+ *
+ * With `LocalMemory`, the same code batches in-process writes, e.g. to objects shared with other
+ * threads or guarded pages.
+ */
+template<typename WrapperT, std::size_t kLineSize = simd::kCacheLineSize>
+class Shadow : public WrapperT, zycore::NonCopyable
+{
+    static_assert(kLineSize && !(kLineSize & (kLineSize - 1)), "line size must be a power of 2");
+
+    static const std::size_t kNumLines = (WrapperT::kObjSize + kLineSize - 1) / kLineSize;
+    static const std::size_t kNumWords = (kNumLines + 63) / 64;
+
+    union
+    {
+        uint8_t m_data[WrapperT::kObjSize];
+        typename std::aligned_storage<1, WrapperT::kObjAlign>::type m_alignment;
+    };
+    uint8_t m_original[WrapperT::kObjSize];
+    uint64_t m_loaded[kNumWords];
+    MemoryBackend* m_memory;
+    uintptr_t m_source;
+    bool m_failed;
+private:
+    bool isLoaded(std::size_t line) const
+    {
+        return (m_loaded[line / 64] >> (line % 64)) & 1;
+    }
+
+    /**
+     * @brief   Appends a range to a list of ranges, merging it with the last one if adjacent.
+     */
+    void addRange(std::vector<platform::IoRange>& ranges, std::size_t offset, std::size_t size)
+    {
+        if (!ranges.empty())
+        {
+            auto& last = ranges.back();
+            if (last.address + last.size == m_source + offset)
+            {
+                last.size += size;
+                return;
+            }
+        }
+        ranges.push_back({m_source + offset, m_data + offset, size});
+    }
+public:
+    /**
+     * @brief   Constructor. Doesn't read anything yet.
+     * @param   memory  The memory backend to use.
+     * @param   source  The address of the object in the address space of the backend.
+     */
+    Shadow(MemoryBackend& memory, uintptr_t source)
+        : WrapperT{&m_data}
+        , m_memory{&memory}
+        , m_source{source}
+        , m_failed{false}
+    {
+        std::memset(m_data, 0, sizeof(m_data));
+        std::memset(m_original, 0, sizeof(m_original));
+        std::memset(m_loaded, 0, sizeof(m_loaded));
+    }
+
+    /**
+     * @brief   Makes sure a byte range of the object is read.
+     * @param   offset  The offset of the range in the object.
+     * @param   size    The size of the range, in bytes.
+     * @return  @c true on success, else @c false.
+     */
+    bool ensure(std::size_t offset, std::size_t size)
+    {
+        if (!size) return true;
+        const auto last = std::min((offset + size - 1) / kLineSize, kNumLines - 1);
+
+        std::vector<platform::IoRange> ranges;
+        for (auto line = offset / kLineSize; line <= last; ++line)
+        {
+            if (isLoaded(line)) continue;
+            const auto begin = line * kLineSize;
+            addRange(ranges, begin, std::min(kLineSize, WrapperT::kObjSize - begin));
+        }
+        if (ranges.empty()) return true;
+        if (!m_memory->readBatch(ranges.data(), ranges.size()))
+        {
+            m_failed = true;
+            return false;
+        }
+
+        for (const auto& cur : ranges)
+        {
+            const auto begin = cur.address - m_source;
+            std::memcpy(m_original + begin, m_data + begin, cur.size);
+            for (auto line = begin / kLineSize; line * kLineSize < begin + cur.size; ++line)
+            {
+                m_loaded[line / 64] |= uint64_t{1} << (line % 64);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Makes sure the given fields are read.
+     * @param   fields  Pointers to the fields, e.g. `&Dog::age`.
+     * @return  @c true on success, else @c false.
+     */
+    template<typename... FieldPtrsT>
+    bool ensureFields(FieldPtrsT... fields)
+    {
+        bool success = true;
+        using Expand = int[];
+        (void)Expand{0, (success &= ensureField(this->*fields), 0)...};
+        return success;
+    }
+
+    /**
+     * @brief   Makes sure a field of this shadow is read.
+     * @param   field   The field, required to be a field of this shadow.
+     * @return  @c true on success, else @c false.
+     */
+    template<typename FieldT>
+    bool ensureField(const FieldT& field)
+    {
+        auto obj = field.addressOfObj();
+        auto local = reinterpret_cast<const uint8_t*>(obj);
+        return ensure(static_cast<std::size_t>(local - m_data), sizeof(*obj));
+    }
+
+    /**
+     * @brief   Reads a field if required and returns it.
+     * @param   field   Pointer to the field, e.g. `&Dog::age`.
+     * @return  The field. If the read failed, it holds zeros and `hasFailed` returns @c true.
+     */
+    template<typename FieldPtrT>
+    auto operator [] (FieldPtrT field) -> decltype(this->*field)
+    {
+        ensureField(this->*field);
+        return this->*field;
+    }
+
+    /**
+     * @brief   Reads all lines not read yet.
+     * @return  @c true on success, else @c false.
+     */
+    bool loadAll()
+    {
+        return ensure(0, WrapperT::kObjSize);
+    }
+
+    /**
+     * @brief   Determines whether a line was read.
+     * @param   line    The index of the line.
+     * @return  @c true if read, else @c false.
+     */
+    bool isLineLoaded(std::size_t line) const
+    {
+        return line < kNumLines && isLoaded(line);
+    }
+
+    /**
+     * @brief   Determines whether any lazy read failed since construction or `invalidate`.
+     * @return  @c true if a read failed, else @c false.
+     */
+    bool hasFailed() const { return m_failed; }
+
+    /**
+     * @brief   Determines whether the shadow holds changes not flushed yet.
+     * @return  @c true if dirty, else @c false.
+     */
+    bool isDirty() const
+    {
+        return std::memcmp(m_data, m_original, sizeof(m_data)) != 0;
+    }
+
+    /**
+     * @brief   Writes all changed bytes back to the object, in a single batch.
+     * @return  @c true on success (or if nothing changed), else @c false.
+     *
+     * Changed bytes are found with `simd::forEachMismatch` and merged into contiguous ranges, so
+     * unchanged bytes in between are never written and can't overwrite concurrent changes of the
+     * target. On failure, the changes are kept and can be flushed again.
+     */
+    bool flush()
+    {
+        std::vector<platform::IoRange> ranges;
+        simd::forEachMismatch(m_data, m_original, sizeof(m_data),
+            [&](std::size_t offset, uint32_t mask)
+        {
+            while (mask)
+            {
+                const auto begin = simd::countTrailingZeros(mask);
+                const auto rest = ~(mask >> begin);
+                const auto run = rest ? simd::countTrailingZeros(rest) : 32 - begin;
+                addRange(ranges, offset + begin, run);
+                mask = run + begin >= 32 ? 0 : mask & ~(((uint32_t{1} << run) - 1) << begin);
+            }
+        });
+        if (ranges.empty()) return true;
+        if (!m_memory->writeBatch(ranges.data(), ranges.size())) return false;
+
+        for (const auto& cur : ranges)
+        {
+            const auto begin = cur.address - m_source;
+            std::memcpy(m_original + begin, m_data + begin, cur.size);
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Reverts all changes not flushed yet.
+     */
+    void discard()
+    {
+        std::memcpy(m_data, m_original, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Forgets everything read, so the next accesses read the object again.
+     *
+     * Changes not flushed yet are lost.
+     */
+    void invalidate()
+    {
+        std::memset(m_data, 0, sizeof(m_data));
+        std::memset(m_original, 0, sizeof(m_original));
+        std::memset(m_loaded, 0, sizeof(m_loaded));
+        m_failed = false;
+    }
+
+    /**
+     * @brief   Gets the address of the object in the address space of the backend.
+     * @return  The address.
+     */
+    uintptr_t source() const { return m_source; }
+
+    /**
+     * @brief   Gets the memory backend used.
+     * @return  The memory backend.
+     */
+    MemoryBackend& memory() const { return *m_memory; }
+};
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_MEMORY_HPP
@@ -0,0 +1,251 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_MULTILAYOUT_HPP
+#define REMODEL_MULTILAYOUT_HPP
+
+/**
+ * @file
+ * @brief Contains wrappers supporting several layouts of a class, selected once at runtime.
+ *
+ * When a class changes its layout between versions of the target, its wrapper can declare the
+ * offsets of all known versions in a `MultiLayout`, pick the one of the running version once
+ * when attaching and then access the fields without checking the version again:
+ * @code
+ *     class Dog : public ClassWrapper
+ *     {
+ *         REMODEL_WRAPPER(Dog)
+ *
+ *         enum { kAge, kName, kNumFields };
+ *         static MultiLayout<kNumFields>& layouts()
+ *         {
+ *             static MultiLayout<kNumFields> layouts{
+ *                 {"1.0", "", {{0x7C, 0x04}}},
+ *                 {"1.1", "3f6a9c...", {{0x84, 0x04}}}, // matched by build identity, too
+ *             };
+ *             return layouts;
+ *         }
+ *     public:
+ *         Field<uint8_t, LayoutGetter>      age {this, layouts().getter(kAge)};
+ *         Field<CustomString, LayoutGetter> name{this, layouts().getter(kName)};
+ *     };
+ *
+ *     // On attach
+ *     Dog::layouts().select(Module::getModule(nullptr).value());
+ * @endcode
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "zycore/Utils.hpp"
+#include "Platform.hpp"
+#include "remodel/Module.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [LayoutGetter]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor adding an offset taken from the selected layout of a
+ *          `MultiLayout`.
+ *
+ * Refers to the offset table of the selected layout through the `MultiLayout`, so an access
+ * costs two dependent loads (the table, then the offset) and no comparisons, and selecting
+ * another layout affects existing wrappers, too.
+ */
+class LayoutGetter
+{
+    const std::ptrdiff_t* const* m_table;
+    std::size_t m_index;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   table   Pointer to the pointer to the selected offset table.
+     * @param   index   The index of the field in the table.
+     * @see     MultiLayout::getter
+     */
+    LayoutGetter(const std::ptrdiff_t* const* table, std::size_t index)
+        : m_table{table}
+        , m_index{index}
+    {}
+
+    void* operator () (void* raw) const
+    {
+        return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(raw) + (*m_table)[m_index]);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [MultiLayout]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The offsets of the fields of a class in several versions of the target.
+ * @tparam  numFieldsT  The number of fields (or other values, e.g. vftable indices) per layout.
+ *
+ * Layouts are identified by a name (e.g. the version of the target) and optionally by the
+ * build identity of the module (see `platform::obtainModuleIdentity`), as a hex string. The
+ * first layout is used until another one is selected. Select layouts before accessing fields
+ * using them on other threads; typically that happens once, when attaching to the target.
+ */
+template<std::size_t numFieldsT>
+class MultiLayout : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   A layout.
+     */
+    struct Layout
+    {
+        /// The name of the layout, e.g. the version of the target.
+        const char* name;
+        /// The build identity of the module as hex string, empty if unknown.
+        const char* identity;
+        /// The offsets of the fields.
+        std::array<std::ptrdiff_t, numFieldsT> offsets;
+    };
+private:
+    std::vector<Layout> m_layouts;
+    const std::ptrdiff_t* m_selected;
+    std::size_t m_selectedIndex = 0;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   layouts The layouts, at least one.
+     */
+    MultiLayout(std::initializer_list<Layout> layouts)
+        : m_layouts{layouts}
+    {
+        assert(m_layouts.size());
+        m_selected = m_layouts[0].offsets.data();
+    }
+
+    /**
+     * @brief   Creates a `PtrGetter` for a field.
+     * @param   index   The index of the field.
+     * @return  The getter.
+     */
+    LayoutGetter getter(std::size_t index) const
+    {
+        assert(index < numFieldsT);
+        return LayoutGetter{&m_selected, index};
+    }
+
+    /**
+     * @brief   Gets a value of the selected layout, e.g. a vftable index.
+     * @param   index   The index of the value.
+     * @return  The value.
+     */
+    std::ptrdiff_t value(std::size_t index) const
+    {
+        assert(index < numFieldsT);
+        return m_selected[index];
+    }
+
+    /**
+     * @brief   Selects a layout by index.
+     * @param   index   The index of the layout.
+     * @return  @c true on success, @c false if there's no such layout.
+     */
+    bool select(std::size_t index)
+    {
+        if (index >= m_layouts.size()) return false;
+        m_selected = m_layouts[index].offsets.data();
+        m_selectedIndex = index;
+        return true;
+    }
+
+    /**
+     * @brief   Selects a layout by name.
+     * @param   name    The name of the layout.
+     * @return  @c true on success, @c false if there's no such layout.
+     */
+    bool select(const char* name)
+    {
+        for (std::size_t i = 0; i < m_layouts.size(); ++i)
+        {
+            if (!std::strcmp(m_layouts[i].name, name)) return select(i);
+        }
+        return false;
+    }
+
+    /**
+     * @brief   Selects the layout matching the build identity of a module.
+     * @param   module  The module.
+     * @return  @c true on success, @c false if the module has no identity or no layout matches.
+     */
+    bool select(const Module& module)
+    {
+        std::vector<uint8_t> identity;
+        if (!platform::obtainModuleIdentity(module.addressOfObj(), identity)) return false;
+
+        static const char kDigits[] = "0123456789abcdef";
+        std::string hex;
+        for (auto byte : identity)
+        {
+            hex += kDigits[byte >> 4];
+            hex += kDigits[byte & 0xF];
+        }
+
+        for (std::size_t i = 0; i < m_layouts.size(); ++i)
+        {
+            const auto cur = m_layouts[i].identity;
+            if (cur && *cur && hex.size() == std::strlen(cur)
+                && std::equal(hex.begin(), hex.end(), cur, [](char lhs, char rhs)
+                    { return lhs == (rhs >= 'A' && rhs <= 'F' ? rhs - 'A' + 'a' : rhs); }))
+            {
+                return select(i);
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief   Gets the selected layout.
+     * @return  The layout.
+     */
+    const Layout& selected() const { return m_layouts[m_selectedIndex]; }
+
+    /**
+     * @brief   Gets all layouts.
+     * @return  The layouts.
+     */
+    const std::vector<Layout>& layouts() const { return m_layouts; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_MULTILAYOUT_HPP
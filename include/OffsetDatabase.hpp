@@ -0,0 +1,632 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_OFFSETDATABASE_HPP
+#define REMODEL_OFFSETDATABASE_HPP
+
+/**
+ * @file
+ * @brief Contains a binary database of offsets, loaded at runtime and looked up by name.
+ *
+ * Targets with many versions change their layouts with every build. Rather than compiling the
+ * offsets of each version into the wrappers, fields, vftable indices and function addresses
+ * can be declared by name and looked up in a database file of the running version:
+ * @code
+ *     // Tooling, once per target version
+ *     OffsetDatabaseWriter writer;
+ *     writer.add("Dog::age", 0x7C);
+ *     writer.add("Dog::giveGoodie", 1); // vftable index
+ *     writer.add("kick", 0x1234);       // RVA
+ *     writer.save("offsets-1.2.3.bin");
+ *
+ *     // Startup
+ *     OffsetDatabase::global().open("offsets-1.2.3.bin");
+ *
+ *     class Dog : public ClassWrapper
+ *     {
+ *         REMODEL_WRAPPER(Dog)
+ *     public:
+ *         Field<uint8_t, NamedOffsGetter> age{this, NamedOffsGetter{"Dog::age"}};
+ *         VirtualFunction<void (*)(int)> giveGoodie{
+ *             this, "Dog::giveGoodie", OffsetDatabase::global()};
+ *     };
+ *
+ *     Function<void (*)(int), NamedRvaGetter> kick{NamedRvaGetter{mainModule, "kick"}};
+ * @endcode
+ *
+ * The file is mapped into memory as is, without parsing, and looked up with a perfect hash, so
+ * opening it costs microseconds and every lookup probes exactly one slot. Opening another file
+ * later replaces the offsets while the host keeps running, named getters pick the new ones up
+ * on their next access.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zycore/Optional.hpp"
+#include "zycore/Utils.hpp"
+#include "Platform.hpp"
+#include "remodel/Wrapper.hpp"
+#include "remodel/Module.hpp"
+
+namespace remodel
+{
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Computes the slot of a key in the perfect hash of an offset database.
+ * @param   key         The hash of the key, see `OffsetDatabase::hash`.
+ * @param   seed        The seed of the key's bucket.
+ * @param   numSlots    The number of slots.
+ * @return  The slot index.
+ */
+inline uint32_t offsetDatabaseSlot(uint64_t key, uint32_t seed, uint32_t numSlots)
+{
+    // splitmix64 finalizer, mixing in the seed.
+    auto x = key ^ (seed * 0x9E3779B97F4A7C15ull);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return static_cast<uint32_t>(x % numSlots);
+}
+
+/**
+ * @internal
+ * @brief   Header of an offset database file.
+ */
+struct OffsetDatabaseHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t numBuckets;
+    uint32_t numSlots;
+    uint32_t reserved;
+};
+
+/**
+ * @internal
+ * @brief   Slot of an offset database file.
+ */
+struct OffsetDatabaseSlot
+{
+    uint64_t key;
+    int64_t value;
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [OffsetDatabase]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Read-only database of named offsets, mapped from a file written by
+ *          `OffsetDatabaseWriter`.
+ *
+ * Keys are names like `"Dog::age"`, values are signed 64 bit integers: field offsets, vftable
+ * indices, RVAs of functions, ... Only the 64 bit hashes of the keys are stored, a lookup
+ * hashes the name, picks the seed of the key's bucket and compares the single slot the seed
+ * leads to (hash and displace).
+ *
+ * File layout (host byte order):
+ * @code
+ *  char     magic[4];              // "RMOD"
+ *  uint32_t version;
+ *  uint32_t numEntries;
+ *  uint32_t numBuckets;
+ *  uint32_t numSlots;
+ *  uint32_t reserved;
+ *  uint32_t seeds[numBuckets];     // padded to a multiple of 2
+ *  struct { uint64_t key; int64_t value; } slots[numSlots]; // empty slots have key 0
+ * @endcode
+ */
+class OffsetDatabase : public VfIndexResolver, public zycore::NonCopyable
+{
+    friend class OffsetDatabaseWriter;
+    static const uint32_t kVersion = 1;
+
+    // Immutable once published, so lookups need no locks.
+    struct Table
+    {
+        platform::MappedFile file;
+        const uint32_t* seeds = nullptr;
+        const internal::OffsetDatabaseSlot* slots = nullptr;
+        uint32_t numEntries = 0;
+        uint32_t numBuckets = 0;
+        uint32_t numSlots = 0;
+
+        ~Table() { platform::unmapFile(file); }
+    };
+
+    std::atomic<const Table*> m_current{nullptr};
+    // Lookups on other threads may still use replaced tables, they're kept until `close`.
+    std::vector<std::unique_ptr<Table>> m_tables;
+    std::mutex m_mutex;
+    Epoch m_epoch;
+
+    static std::size_t seedsSize(uint32_t numBuckets)
+    {
+        return (numBuckets + (numBuckets & 1)) * sizeof(uint32_t);
+    }
+
+    static std::unique_ptr<Table> load(const char* path)
+    {
+        std::unique_ptr<Table> table{new Table};
+        table->file = platform::mapFile(path);
+        if (!table->file.data) return nullptr;
+
+        const auto data = static_cast<const uint8_t*>(table->file.data);
+        const auto size = table->file.size;
+        internal::OffsetDatabaseHeader header;
+        if (size < sizeof(header)) return nullptr;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, "RMOD", 4) || header.version != kVersion
+            || header.numEntries > header.numSlots || !header.numBuckets)
+        {
+            return nullptr;
+        }
+
+        const auto slotsPos = sizeof(header) + seedsSize(header.numBuckets);
+        if (size < slotsPos || (size - slotsPos) / sizeof(internal::OffsetDatabaseSlot)
+            != header.numSlots || (size - slotsPos) % sizeof(internal::OffsetDatabaseSlot))
+        {
+            return nullptr;
+        }
+
+        table->seeds = reinterpret_cast<const uint32_t*>(data + sizeof(header));
+        table->slots = reinterpret_cast<const internal::OffsetDatabaseSlot*>(data + slotsPos);
+        table->numEntries = header.numEntries;
+        table->numBuckets = header.numBuckets;
+        table->numSlots = header.numSlots;
+        return table;
+    }
+public:
+    /**
+     * @brief   Default constructor, creating an empty database.
+     */
+    OffsetDatabase() = default;
+
+    /**
+     * @brief   Constructor opening a database file.
+     * @param   path    The path of the file.
+     */
+    explicit OffsetDatabase(const char* path)
+    {
+        open(path);
+    }
+
+    /**
+     * @brief   Gets the database used by `NamedOffsGetter` by default.
+     * @return  The global database.
+     */
+    static OffsetDatabase& global()
+    {
+        static OffsetDatabase database;
+        return database;
+    }
+
+    /**
+     * @brief   Hashes a key, as stored in database files.
+     * @param   key The key.
+     * @return  The 64 bit FNV-1a hash of the key, never 0.
+     */
+    static constexpr uint64_t hash(const char* key)
+    {
+        uint64_t result = 0xCBF29CE484222325ull;
+        for (; *key; ++key)
+        {
+            result = (result ^ static_cast<uint8_t>(*key)) * 0x100000001B3ull;
+        }
+        return result ? result : 1;
+    }
+
+    /**
+     * @brief   Opens a database file, replacing the current contents.
+     * @param   path    The path of the file.
+     * @return  @c true on success, else @c false (the current contents are kept then).
+     *
+     * Safe to call while other threads look offsets up, which makes hot-reloading offsets of
+     * a patched target possible: the new table is published with a single atomic swap and the
+     * epoch of the database is bumped, so `NamedOffsGetter`s and `NamedRvaGetter`s re-resolve on
+     * their next access. Lookups still running on the old table finish on it, the old file stays
+     * mapped until `close` or destruction.
+     */
+    bool open(const char* path)
+    {
+        auto table = load(path);
+        if (!table) return false;
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_current.store(table.get(), std::memory_order_release);
+        m_tables.push_back(std::move(table));
+        m_epoch.bump();
+        return true;
+    }
+
+    /**
+     * @brief   Closes all database files, leaving the database empty.
+     *
+     * Unlike `open`, must not be called while other threads look offsets up.
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_current.store(nullptr, std::memory_order_release);
+        m_tables.clear();
+        m_epoch.bump();
+    }
+
+    /**
+     * @brief   Gets the epoch bumped whenever the contents change.
+     * @return  The epoch, e.g. for tracking `Function` wrappers.
+     */
+    const Epoch& epoch() const { return m_epoch; }
+
+    /**
+     * @brief   Determines whether a database file is open.
+     * @return  @c true if open, else @c false.
+     */
+    bool isOpen() const { return m_current.load(std::memory_order_acquire) != nullptr; }
+
+    /**
+     * @brief   Gets the number of entries.
+     * @return  The number of entries.
+     */
+    std::size_t size() const
+    {
+        auto table = m_current.load(std::memory_order_acquire);
+        return table ? table->numEntries : 0;
+    }
+
+    /**
+     * @brief   Looks up an entry by the hash of its key.
+     * @param   key The hash of the key, see `hash`.
+     * @return  The value, or nothing if there's no such entry.
+     */
+    zycore::Optional<int64_t> find(uint64_t key) const
+    {
+        auto table = m_current.load(std::memory_order_acquire);
+        if (!table || !table->numSlots) return zycore::kEmpty;
+        const auto& slot = table->slots[internal::offsetDatabaseSlot(
+            key, table->seeds[key % table->numBuckets], table->numSlots)];
+        if (slot.key != key) return zycore::kEmpty;
+        return {zycore::kInPlace, slot.value};
+    }
+
+    /**
+     * @brief   Looks up an entry.
+     * @param   key The key.
+     * @return  The value, or nothing if there's no such entry.
+     */
+    zycore::Optional<int64_t> find(const char* key) const
+    {
+        return find(hash(key));
+    }
+
+    /**
+     * @brief   Looks up an entry, falling back to a default value.
+     * @tparam  T           The type to convert the value to (e.g. `std::size_t` for vftable
+     *                      indices).
+     * @param   key         The key.
+     * @param   fallback    The value returned if there's no such entry.
+     * @return  The value.
+     */
+    template<typename T = int64_t>
+    T get(const char* key, T fallback = T{}) const
+    {
+        auto value = find(key);
+        return value.hasValue() ? static_cast<T>(value.value()) : fallback;
+    }
+
+    /**
+     * @brief   Looks up the vftable index of a virtual function.
+     * @param   name    The key of the index, e.g. `Dog::giveGoodie`.
+     * @return  The index, or nothing if there's no such entry or it is negative.
+     * @see     VirtualFunction
+     */
+    zycore::Optional<std::size_t> vftableIndex(const char* name) const override
+    {
+        auto value = find(name);
+        if (!value.hasValue() || value.value() < 0) return zycore::kEmpty;
+        return {zycore::kInPlace, static_cast<std::size_t>(value.value())};
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [OffsetDatabaseWriter]                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Builds database files for `OffsetDatabase`.
+ *
+ * Computes the perfect hash of the keys on `serialize`, which takes a few milliseconds for
+ * tens of thousands of entries. Meant to run in tooling, not on startup.
+ */
+class OffsetDatabaseWriter
+{
+    std::map<uint64_t, std::pair<std::string, int64_t>> m_entries;
+public:
+    /**
+     * @brief   Adds an entry, replacing an existing one with the same key.
+     * @param   key     The key.
+     * @param   value   The value.
+     * @return  @c true on success, @c false if the hash of the key collides with that of a
+     *          different key (rename one of them).
+     */
+    bool add(const std::string& key, int64_t value)
+    {
+        auto& entry = m_entries[OffsetDatabase::hash(key.c_str())];
+        if (!entry.first.empty() && entry.first != key) return false;
+        entry = {key, value};
+        return true;
+    }
+
+    /**
+     * @brief   Gets the number of entries.
+     * @return  The number of entries.
+     */
+    std::size_t size() const { return m_entries.size(); }
+
+    /**
+     * @brief   Serializes the entries into the file format of `OffsetDatabase`.
+     * @return  The file contents.
+     */
+    std::vector<uint8_t> serialize() const
+    {
+        const auto numEntries = static_cast<uint32_t>(m_entries.size());
+        const uint32_t numBuckets = numEntries / 4 + 1;
+        std::vector<std::vector<uint64_t>> buckets(numBuckets);
+        for (const auto& cur : m_entries) buckets[cur.first % numBuckets].push_back(cur.first);
+
+        // Place the largest buckets first, while most slots are still free.
+        std::vector<uint32_t> order(numBuckets);
+        for (uint32_t i = 0; i < numBuckets; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+        {
+            return buckets[lhs].size() > buckets[rhs].size();
+        });
+
+        std::vector<uint32_t> seeds;
+        std::vector<internal::OffsetDatabaseSlot> slots;
+        for (uint32_t numSlots = numEntries + numEntries / 4 + 1;; numSlots += numEntries / 8 + 1)
+        {
+            seeds.assign(numBuckets, 0);
+            slots.assign(numSlots, internal::OffsetDatabaseSlot{0, 0});
+            bool placed = true;
+            std::vector<uint32_t> taken;
+            for (auto bucket : order)
+            {
+                const auto& keys = buckets[bucket];
+                if (keys.empty()) break;
+
+                placed = false;
+                for (uint32_t seed = 0; seed < (1u << 16) && !placed; ++seed)
+                {
+                    taken.clear();
+                    for (auto key : keys)
+                    {
+                        const auto slot = internal::offsetDatabaseSlot(key, seed, numSlots);
+                        if (slots[slot].key
+                            || std::find(taken.begin(), taken.end(), slot) != taken.end())
+                        {
+                            break;
+                        }
+                        taken.push_back(slot);
+                    }
+                    if (taken.size() != keys.size()) continue;
+
+                    seeds[bucket] = seed;
+                    for (std::size_t i = 0; i < keys.size(); ++i)
+                    {
+                        slots[taken[i]] = {keys[i], m_entries.at(keys[i]).second};
+                    }
+                    placed = true;
+                }
+                if (!placed) break;
+            }
+            if (placed) break;
+        }
+
+        std::vector<uint8_t> data;
+        auto write = [&data](const void* in, std::size_t size)
+        {
+            auto bytes = static_cast<const uint8_t*>(in);
+            data.insert(data.end(), bytes, bytes + size);
+        };
+
+        internal::OffsetDatabaseHeader header{{'R', 'M', 'O', 'D'}, OffsetDatabase::kVersion,
+            numEntries, numBuckets, static_cast<uint32_t>(slots.size()), 0};
+        write(&header, sizeof(header));
+        write(seeds.data(), seeds.size() * sizeof(uint32_t));
+        data.resize(sizeof(header) + OffsetDatabase::seedsSize(numBuckets));
+        write(slots.data(), slots.size() * sizeof(slots[0]));
+        return data;
+    }
+
+    /**
+     * @brief   Writes a database file.
+     * @param   path    The path of the file.
+     * @return  @c true if saved, else @c false.
+     *
+     * The data is written to a temporary file first, which then replaces the target, so readers
+     * never observe a partially written database.
+     */
+    bool save(const char* path) const
+    {
+        const auto data = serialize();
+        const std::string tmpPath = std::string{path} + ".tmp";
+        auto file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) return false;
+        const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (std::fclose(file) != 0 || !written)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            const bool replaced =
+                MoveFileExA(tmpPath.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#       else
+            const bool replaced = std::rename(tmpPath.c_str(), path) == 0;
+#       endif
+        if (!replaced) std::remove(tmpPath.c_str());
+        return replaced;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [NamedOffsGetter]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor adding an offset looked up by name in an `OffsetDatabase`.
+ *
+ * The offset is looked up on the first access rather than on construction, so wrappers may be
+ * created before the database is opened, and again after the database was reloaded (see
+ * `OffsetDatabase::open`), which costs accesses a comparison with the stamp of its epoch.
+ * Accesses of fields missing from the database return @c nullptr.
+ *
+ * @code
+ *     Field<uint8_t, NamedOffsGetter> age{this, NamedOffsGetter{"Dog::age"}};
+ * @endcode
+ *
+ * @note    The cached offset is not synchronized, don't share one getter between threads.
+ */
+class NamedOffsGetter
+{
+    const OffsetDatabase* m_database;
+    uint64_t m_key;
+    mutable std::ptrdiff_t m_offs = 0;
+    mutable uint64_t m_stamp = 0;
+    mutable bool m_found = false;
+
+    void resolve(uint64_t stamp) const
+    {
+        auto offs = m_database->find(m_key);
+        m_found = offs.hasValue();
+        m_offs = m_found ? static_cast<std::ptrdiff_t>(offs.value()) : 0;
+        m_stamp = stamp;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   key         The key of the offset, e.g. `"Dog::age"`.
+     * @param   database    The database, must outlive the getter.
+     */
+    explicit NamedOffsGetter(const char* key,
+            const OffsetDatabase& database = OffsetDatabase::global())
+        : m_database{&database}
+        , m_key{OffsetDatabase::hash(key)}
+    {}
+
+    /**
+     * @brief   Determines whether the offset is in the database.
+     * @return  @c true if found, else @c false.
+     */
+    bool isValid() const
+    {
+        resolve(m_database->epoch().stamp());
+        return m_found;
+    }
+
+    void* operator () (void* raw) const
+    {
+        const auto stamp = m_database->epoch().stamp();
+        if (stamp != m_stamp) resolve(stamp);
+        if (!m_found) return nullptr;
+        return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(raw) + m_offs);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [NamedRvaGetter]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor returning a module's base plus an RVA looked up by name in an
+ *          `OffsetDatabase`, e.g. for functions and globals.
+ *
+ * Resolved like `NamedOffsGetter`: on the first call and again after the database was
+ * reloaded. Calls of functions missing from the database go to @c nullptr.
+ *
+ * @code
+ *     Function<void (*)(int), NamedRvaGetter> kick{NamedRvaGetter{mainModule, "kick"}};
+ *     Field<int32_t, NamedRvaGetter> playerCount{nullptr, NamedRvaGetter{mainModule, "players"}};
+ * @endcode
+ *
+ * @note    The cached address is not synchronized, don't share one getter between threads.
+ */
+class NamedRvaGetter
+{
+    const OffsetDatabase* m_database;
+    uintptr_t m_base;
+    uint64_t m_key;
+    mutable void* m_ptr = nullptr;
+    mutable uint64_t m_stamp = 0;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   module      The module the RVA is relative to.
+     * @param   key         The key of the RVA, e.g. `"kick"`.
+     * @param   database    The database, must outlive the getter.
+     */
+    NamedRvaGetter(const Module& module, const char* key,
+            const OffsetDatabase& database = OffsetDatabase::global())
+        : m_database{&database}
+        , m_base{reinterpret_cast<uintptr_t>(module.addressOfObj())}
+        , m_key{OffsetDatabase::hash(key)}
+    {}
+
+    void* operator () (void*) const
+    {
+        const auto stamp = m_database->epoch().stamp();
+        if (stamp != m_stamp)
+        {
+            auto rva = m_database->find(m_key);
+            m_ptr = rva.hasValue()
+                ? reinterpret_cast<void*>(m_base + static_cast<uintptr_t>(rva.value())) : nullptr;
+            m_stamp = stamp;
+        }
+        return m_ptr;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_OFFSETDATABASE_HPP
@@ -0,0 +1,307 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_PACKET_HPP
+#define REMODEL_PACKET_HPP
+
+/**
+ * @file
+ * @brief Contains helpers overlaying wrappers on captured network frames without copying them.
+ *
+ * Frames are processed in batches: a single wrapper is rebound to one frame after another right
+ * where the frames are stored, e.g. in a receive ring shared with the kernel or a NIC, so parsing
+ * involves neither copies nor the construction of wrappers per packet.
+ * @code
+ *     class EthernetHeader : public AdvancedClassWrapper<14>
+ *     {
+ *         REMODEL_ADV_WRAPPER(EthernetHeader)
+ *     public:
+ *         StaticField<BigEndian<uint16_t>, 12> etherType{this};
+ *     };
+ *
+ *     PacketRing ring{"eth0"};
+ *     while (ring.isValid())
+ *     {
+ *         ring.processBlock<EthernetHeader>([&](EthernetHeader& eth, const Frame& frame) {
+ *             if (eth.etherType == 0x0800) parseIpv4(frame.data + 14, frame.length - 14);
+ *         });
+ *     }
+ * @endcode
+ *
+ * Frames of other sources (e.g. the mbufs of a DPDK burst) are processed by collecting their
+ * data pointers into an array of `Frame`s passed to `forEachFrame`.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+
+#include "Remodel.hpp"
+
+#if defined(__linux__)
+#   include <arpa/inet.h>
+#   include <linux/if_ether.h>
+#   include <linux/if_packet.h>
+#   include <net/if.h>
+#   include <poll.h>
+#   include <sys/mman.h>
+#   include <sys/socket.h>
+#   include <unistd.h>
+#   define REMODEL_PACKET_RING_SUPPORTED
+#endif
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [Frame] + [forEachFrame]                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A captured frame.
+ */
+struct Frame
+{
+    /// The first byte of the frame.
+    uint8_t* data;
+    /// The number of captured bytes.
+    std::size_t length;
+};
+
+/**
+ * @brief   Overlays a wrapper on every frame in an array.
+ * @tparam  WrapperT    The wrapper type, required to be derived from `AdvancedClassWrapper`.
+ * @param   frames      The frames.
+ * @param   count       The number of frames.
+ * @param   func        Function called with the wrapper and the frame for every frame.
+ * @return  The number of frames passed to @c func.
+ *
+ * Frames shorter than `WrapperT::kObjSize` are skipped.
+ */
+template<typename WrapperT, typename FuncT>
+inline std::size_t forEachFrame(const Frame* frames, std::size_t count, FuncT func)
+{
+    auto wrapper = wrapper_cast<WrapperT>(nullptr);
+    std::size_t numProcessed = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (frames[i].length < WrapperT::kObjSize) continue;
+        wrapper.rebind(frames[i].data);
+        func(wrapper, frames[i]);
+        ++numProcessed;
+    }
+    return numProcessed;
+}
+
+#if defined(REMODEL_PACKET_RING_SUPPORTED)
+
+// ---------------------------------------------------------------------------------------------- //
+// [forEachBlockFrame]                                                                            //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Overlays a wrapper on every frame in a block of a `TPACKET_V3` receive ring.
+ * @tparam  WrapperT    The wrapper type, required to be derived from `AdvancedClassWrapper`.
+ * @param   block       The block, starting with its `tpacket_block_desc`.
+ * @param   func        Function called with the wrapper and the frame for every frame.
+ * @return  The number of frames passed to @c func.
+ *
+ * Frames shorter than `WrapperT::kObjSize` are skipped. The header of the next frame is 
+ * prefetched while a frame is processed.
+ */
+template<typename WrapperT, typename FuncT>
+inline std::size_t forEachBlockFrame(void* block, FuncT func)
+{
+    const auto& desc = static_cast<tpacket_block_desc*>(block)->hdr.bh1;
+    auto cur = static_cast<uint8_t*>(block) + desc.offset_to_first_pkt;
+
+    auto wrapper = wrapper_cast<WrapperT>(nullptr);
+    std::size_t numProcessed = 0;
+    for (uint32_t i = 0; i < desc.num_pkts; ++i)
+    {
+        auto hdr = reinterpret_cast<tpacket3_hdr*>(cur);
+        cur += hdr->tp_next_offset;
+        if (i + 1 < desc.num_pkts) __builtin_prefetch(cur);
+
+        const Frame frame{reinterpret_cast<uint8_t*>(hdr) + hdr->tp_mac, hdr->tp_snaplen};
+        if (frame.length < WrapperT::kObjSize) continue;
+        wrapper.rebind(frame.data);
+        func(wrapper, frame);
+        ++numProcessed;
+    }
+    return numProcessed;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [PacketRing]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Receive ring of a Linux `AF_PACKET` socket, using `PACKET_MMAP` with `TPACKET_V3`.
+ *
+ * The kernel writes frames straight into memory shared with us and hands it over in blocks of 
+ * many frames, so a block costs at most one `poll` no matter how many frames it holds. Capturing
+ * requires `CAP_NET_RAW`.
+ */
+class PacketRing
+{
+    int m_socket = -1;
+    uint8_t* m_ring = nullptr;
+    std::size_t m_blockSize;
+    std::size_t m_numBlocks;
+    std::size_t m_current = 0;
+
+    tpacket_hdr_v1& descOf(std::size_t idx) 
+    { 
+        return reinterpret_cast<tpacket_block_desc*>(m_ring + idx * m_blockSize)->hdr.bh1;
+    }
+
+    bool isUserBlock(std::size_t idx)
+    {
+        auto status = static_cast<volatile uint32_t&>(descOf(idx).block_status);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (status & TP_STATUS_USER) != 0;
+    }
+public:
+    /**
+     * @brief   Opens a ring capturing all frames received on an interface.
+     * @param   interfaceName   The name of the interface, e.g. `eth0`.
+     * @param   blockSize       The size of a block, a multiple of the page size.
+     * @param   numBlocks       The number of blocks.
+     * @param   frameSize       The maximum size of a frame including its header.
+     * @param   timeoutMs       The time after which the kernel hands over blocks that aren't 
+     *                          full yet, in milliseconds.
+     *
+     * Use `isValid` to check whether opening the ring succeeded.
+     */
+    explicit PacketRing(const char* interfaceName, std::size_t blockSize = 1 << 22, 
+            std::size_t numBlocks = 64, unsigned frameSize = 1 << 11, unsigned timeoutMs = 10)
+        : m_blockSize{blockSize}
+        , m_numBlocks{numBlocks}
+    {
+        const auto ifIndex = if_nametoindex(interfaceName);
+        if (!ifIndex) return;
+        m_socket = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+        if (m_socket < 0) return;
+
+        int version = TPACKET_V3;
+        tpacket_req3 req{};
+        req.tp_block_size       = static_cast<unsigned>(blockSize);
+        req.tp_block_nr         = static_cast<unsigned>(numBlocks);
+        req.tp_frame_size       = frameSize;
+        req.tp_frame_nr         = static_cast<unsigned>(blockSize / frameSize * numBlocks);
+        req.tp_retire_blk_tov   = timeoutMs;
+        sockaddr_ll addr{};
+        addr.sll_family         = AF_PACKET;
+        addr.sll_protocol       = htons(ETH_P_ALL);
+        addr.sll_ifindex        = static_cast<int>(ifIndex);
+
+        void* ring = MAP_FAILED;
+        if (setsockopt(m_socket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == 0
+            && setsockopt(m_socket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == 0)
+        {
+            ring = mmap(nullptr, blockSize * numBlocks, PROT_READ | PROT_WRITE, 
+                MAP_SHARED | MAP_LOCKED, m_socket, 0);
+        }
+        if (ring == MAP_FAILED
+            || bind(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            if (ring != MAP_FAILED) munmap(ring, blockSize * numBlocks);
+            close(m_socket);
+            m_socket = -1;
+            return;
+        }
+        m_ring = static_cast<uint8_t*>(ring);
+    }
+
+    PacketRing(const PacketRing&) = delete;
+    PacketRing& operator = (const PacketRing&) = delete;
+
+    /**
+     * @brief   Destructor, closing the ring.
+     */
+    ~PacketRing()
+    {
+        if (m_ring) munmap(m_ring, m_blockSize * m_numBlocks);
+        if (m_socket >= 0) close(m_socket);
+    }
+
+    /**
+     * @brief   Determines whether the ring was opened successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_ring != nullptr; }
+
+    /**
+     * @brief   Waits for the next block handed over by the kernel.
+     * @param   timeoutMs   The maximum time to wait, in milliseconds, or -1 to wait forever.
+     * @return  The block, starting with its `tpacket_block_desc`, or @c nullptr on timeout.
+     *
+     * The block has to be returned with `releaseBlock` before the next one is requested.
+     */
+    void* nextBlock(int timeoutMs = -1)
+    {
+        if (!isValid()) return nullptr;
+        if (!isUserBlock(m_current))
+        {
+            pollfd fd{m_socket, POLLIN | POLLERR, 0};
+            if (poll(&fd, 1, timeoutMs) <= 0 || !isUserBlock(m_current)) return nullptr;
+        }
+        return m_ring + m_current * m_blockSize;
+    }
+
+    /**
+     * @brief   Hands the block returned by the last `nextBlock` back to the kernel.
+     */
+    void releaseBlock()
+    {
+        std::atomic_thread_fence(std::memory_order_release);
+        static_cast<volatile uint32_t&>(descOf(m_current).block_status) = TP_STATUS_KERNEL;
+        m_current = (m_current + 1) % m_numBlocks;
+    }
+
+    /**
+     * @brief   Overlays a wrapper on every frame of the next block and releases it.
+     * @tparam  WrapperT    The wrapper type, required to be derived from `AdvancedClassWrapper`.
+     * @param   func        Function called with the wrapper and the frame for every frame.
+     * @param   timeoutMs   The maximum time to wait for a block, in milliseconds, or -1 to wait
+     *                      forever.
+     * @return  The number of frames passed to @c func, 0 on timeout.
+     * @see     forEachBlockFrame
+     */
+    template<typename WrapperT, typename FuncT>
+    std::size_t processBlock(FuncT func, int timeoutMs = -1)
+    {
+        auto block = nextBlock(timeoutMs);
+        if (!block) return 0;
+        auto numProcessed = forEachBlockFrame<WrapperT>(block, func);
+        releaseBlock();
+        return numProcessed;
+    }
+};
+
+#endif // REMODEL_PACKET_RING_SUPPORTED
+
+} // namespace remodel
+
+#endif // REMODEL_PACKET_HPP
@@ -0,0 +1,291 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_PARALLEL_HPP
+#define REMODEL_PARALLEL_HPP
+
+/**     
+ * @file
+ * @brief Contains parallel iteration over ranges of wrapped objects.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Remodel.hpp"
+
+namespace remodel
+{
+
+/**
+ * @brief   Granularity in which `parallelForEach` distributes objects over threads, in bytes.
+ *
+ * Chunks start with the first object at or behind a page boundary, so threads only ever write to
+ * the same cache line where an object straddles a chunk boundary.
+ */
+const std::size_t kParallelChunkSize = 0x1000;
+
+namespace internal
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [ChunkLayout]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Splits equally spaced objects into chunks of `kParallelChunkSize` bytes.
+ */
+class ChunkLayout
+{
+    uintptr_t m_first;
+    uintptr_t m_base;
+    std::size_t m_count;
+    std::size_t m_stride;
+    std::size_t m_numChunks;
+public:
+    ChunkLayout(const void* first, std::size_t count, std::size_t stride)
+        : m_first{reinterpret_cast<uintptr_t>(first)}
+        , m_base{m_first & ~uintptr_t{kParallelChunkSize - 1}}
+        , m_count{count}
+        , m_stride{stride}
+        , m_numChunks{count 
+            ? (m_first + count * stride - m_base + kParallelChunkSize - 1) / kParallelChunkSize 
+            : 0}
+    {
+        assert(stride);
+    }
+
+    std::size_t numChunks() const { return m_numChunks; }
+
+    /**
+     * @brief   Gets the index of the first object of a chunk.
+     * @param   chunk   The index of the chunk, `numChunks()` for the end of the last one.
+     * @return  The object index. Chunks may be empty if objects are larger than chunks.
+     */
+    std::size_t boundary(std::size_t chunk) const
+    {
+        if (chunk >= m_numChunks) return m_count;
+        const uintptr_t address = m_base + chunk * kParallelChunkSize;
+        if (address <= m_first) return 0;
+        return std::min(m_count, (address - m_first + m_stride - 1) / m_stride);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [parallelForChunks]                                                                            //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   The chunks still to be processed by a worker, `[begin, end)` packed into one word.
+ */
+struct alignas(64) StealRange
+{
+    std::atomic<uint64_t> bounds;
+
+    static uint64_t pack(uint64_t begin, uint64_t end) { return begin << 32 | end; }
+
+    /**
+     * @brief   Takes the first chunk, done by the owning worker.
+     */
+    bool popFront(std::size_t& chunk)
+    {
+        auto cur = bounds.load(std::memory_order_relaxed);
+        while ((cur >> 32) < (cur & 0xFFFFFFFF))
+        {
+            if (bounds.compare_exchange_weak(cur, cur + (uint64_t{1} << 32)))
+            {
+                chunk = static_cast<std::size_t>(cur >> 32);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief   Takes the back half of the chunks, done by other workers running out of work.
+     */
+    bool stealHalf(uint64_t& begin, uint64_t& end)
+    {
+        auto cur = bounds.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const uint64_t b = cur >> 32, e = cur & 0xFFFFFFFF;
+            if (b >= e) return false;
+            const uint64_t mid = b + (e - b) / 2;
+            if (bounds.compare_exchange_weak(cur, pack(b, mid)))
+            {
+                begin = mid;
+                end   = e;
+                return true;
+            }
+        }
+    }
+};
+
+/**
+ * @internal
+ * @brief   Runs a task for every chunk in `[0, numChunks)` on a set of work-stealing threads.
+ * @tparam  FuncT       Type of the task, callable as `void(std::size_t)`.
+ * @param   numChunks   The number of chunks.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ * @param   func        The task.
+ *
+ * Each worker starts with a contiguous share of the chunks and processes it front to back, so
+ * neighbouring chunks are usually handled by the same thread. Workers running out of chunks 
+ * steal the back half of the remaining chunks of another worker. The calling thread takes part 
+ * in the work.
+ */
+template<typename FuncT>
+void parallelForChunks(std::size_t numChunks, unsigned numThreads, const FuncT& func)
+{
+    assert(numChunks <= 0xFFFFFFFF);
+    if (!numThreads) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    // MSVC12 requires parentheses here (min macro).
+    numThreads = static_cast<unsigned>((std::min)(std::size_t{numThreads}, numChunks));
+    if (numThreads <= 1)
+    {
+        for (std::size_t i = 0; i < numChunks; ++i) func(i);
+        return;
+    }
+
+    // Plain `new` doesn't honor the over-alignment before C++17, so we align the storage by hand.
+    const std::size_t alignment = alignof(StealRange);
+    std::unique_ptr<uint8_t[]> storage{new uint8_t[numThreads * sizeof(StealRange) + alignment]};
+    const auto raw = reinterpret_cast<uintptr_t>(storage.get());
+    const auto ranges = reinterpret_cast<StealRange*>((raw + alignment - 1) & ~(alignment - 1));
+    static_assert(std::is_trivially_destructible<StealRange>::value,
+        "ranges are released without running destructors");
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        new (&ranges[i]) StealRange;
+        ranges[i].bounds.store(StealRange::pack(
+            uint64_t{numChunks} * i / numThreads, uint64_t{numChunks} * (i + 1) / numThreads));
+    }
+
+    auto worker = [&](unsigned self)
+    {
+        for (;;)
+        {
+            std::size_t chunk;
+            while (ranges[self].popFront(chunk)) func(chunk);
+
+            bool stolen = false;
+            for (unsigned i = 1; i < numThreads && !stolen; ++i)
+            {
+                uint64_t begin, end;
+                if (ranges[(self + i) % numThreads].stealHalf(begin, end))
+                {
+                    // Nobody steals from an empty range, so we can just publish the new one.
+                    ranges[self].bounds.store(StealRange::pack(begin, end));
+                    stolen = true;
+                }
+            }
+            if (!stolen) return;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < numThreads; ++i) threads.emplace_back(worker, i);
+    worker(0);
+    for (auto& cur : threads) cur.join();
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [parallelForEach]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Invokes a function for every object of a range, distributed over multiple threads.
+ * @tparam  WrapperT    The wrapper type of the range.
+ * @tparam  FuncT       Type of the function, callable as `void(WrapperT&)`.
+ * @param   range       The range of objects.
+ * @param   func        The function, invoked concurrently.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency. The 
+ *                      calling thread is one of them.
+ *
+ * The objects are split into chunks of `kParallelChunkSize` bytes, which are distributed over
+ * threads with work stealing. Every chunk is processed with one wrapper, rebound from object to
+ * object like when iterating the range, so no wrappers are created per object.
+ * @code
+ *     parallelForEach(WrapperRange<Dog>{dogArray, 1000000}, [](Dog& dog)
+ *     {
+ *         dog.fluffiness = dog.age * 3;
+ *     });
+ * @endcode
+ */
+template<typename WrapperT, typename FuncT>
+inline void parallelForEach(const WrapperRange<WrapperT>& range, const FuncT& func,
+    unsigned numThreads = 0)
+{
+    const internal::ChunkLayout layout{range.first(), range.size(), range.stride()};
+    internal::parallelForChunks(layout.numChunks(), numThreads, [&](std::size_t chunk)
+    {
+        const auto begin = layout.boundary(chunk);
+        const auto end = layout.boundary(chunk + 1);
+        if (begin == end) return;
+        auto first = static_cast<uint8_t*>(range.first()) + begin * range.stride();
+        for (auto& cur : WrapperRange<WrapperT>{first, end - begin, range.stride()}) func(cur);
+    });
+}
+
+/**
+ * @brief   Invokes a function for every field of a span, distributed over multiple threads.
+ * @tparam  T           The type of the fields.
+ * @tparam  FuncT       Type of the function, callable as `void(T&)`.
+ * @param   span        The span of fields.
+ * @param   func        The function, invoked concurrently.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ *
+ * Chunks are formed just like for ranges of objects.
+ */
+template<typename T, typename FuncT>
+inline void parallelForEach(const FieldSpan<T>& span, const FuncT& func, unsigned numThreads = 0)
+{
+    if (!span.size()) return;
+    const internal::ChunkLayout layout{&span[0], span.size(), span.stride()};
+    internal::parallelForChunks(layout.numChunks(), numThreads, [&](std::size_t chunk)
+    {
+        const auto end = span.begin() + static_cast<std::ptrdiff_t>(layout.boundary(chunk + 1));
+        for (auto cur = span.begin() + static_cast<std::ptrdiff_t>(layout.boundary(chunk)); 
+            cur != end; ++cur)
+        {
+            func(*cur);
+        }
+    });
+}
+
+} // namespace remodel
+
+#endif // REMODEL_PARALLEL_HPP
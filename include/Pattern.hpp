@@ -0,0 +1,561 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_PATTERN_HPP
+#define REMODEL_PATTERN_HPP
+
+/**     
+ * @file
+ * @brief Contains a vectorized byte-pattern (signature) scanner.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "Platform.hpp"
+#include "Simd.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <immintrin.h>
+#   define REMODEL_PATTERN_SSE2
+#endif
+
+namespace remodel
+{
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Runs a task for every index in `[0, numTasks)` on a set of worker threads.
+ * @tparam  FuncT       Type of the task, callable as `void(std::size_t)`.
+ * @param   numTasks    The number of tasks.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ * @param   func        The task.
+ *
+ * Workers pull indices from a shared counter, so tasks are started in ascending order. The
+ * calling thread takes part in the work; no threads are spawned if only one would be used.
+ */
+template<typename FuncT>
+void parallelFor(std::size_t numTasks, unsigned numThreads, const FuncT& func)
+{
+    if (!numThreads) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    // MSVC12 requires parentheses here (min macro).
+    numThreads = static_cast<unsigned>((std::min)(std::size_t{numThreads}, numTasks));
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]
+    {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < numTasks;)
+        {
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < numThreads; ++i) threads.emplace_back(worker);
+    worker();
+    for (auto& cur : threads) cur.join();
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [Pattern]                                                                                      //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Byte pattern with wildcards, e.g. `48 8B ?? ?? E8`.
+ */
+class Pattern
+{
+    std::vector<uint8_t> m_bytes;
+    std::vector<uint8_t> m_mask; // 0xFF for bytes to compare, 0x00 for wildcards
+    std::size_t m_firstFixed = 0;
+    std::size_t m_lastFixed = 0;
+    bool m_valid = false;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   pattern Space separated hex bytes, `?` or `??` for wildcards.
+     */
+    explicit Pattern(const char* pattern)
+    {
+        auto hexVal = [](char c) -> int
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+
+        for (const char* cur = pattern; *cur;)
+        {
+            if (*cur == ' ') 
+            {
+                ++cur;
+                continue;
+            }
+
+            if (*cur == '?')
+            {
+                cur += cur[1] == '?' ? 2 : 1;
+                m_bytes.push_back(0);
+                m_mask.push_back(0x00);
+            }
+            else
+            {
+                const int hi = hexVal(cur[0]);
+                const int lo = hi < 0 ? -1 : hexVal(cur[1]);
+                if (lo < 0) return;
+                cur += 2;
+                m_bytes.push_back(static_cast<uint8_t>(hi << 4 | lo));
+                m_mask.push_back(0xFF);
+            }
+
+            if (*cur && *cur != ' ') return;
+        }
+
+        // Patterns need at least one fixed byte to anchor the search.
+        std::size_t i = 0;
+        while (i < m_mask.size() && !m_mask[i]) ++i;
+        if (i == m_mask.size()) return;
+        m_firstFixed = i;
+        for (m_lastFixed = m_mask.size() - 1; !m_mask[m_lastFixed]; --m_lastFixed);
+        m_valid = true;
+    }
+
+    /**
+     * @brief   Determines whether the pattern was parsed successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_valid; }
+
+    /**
+     * @brief   Gets the length of the pattern, in bytes.
+     * @return  The length.
+     */
+    std::size_t size() const { return m_bytes.size(); }
+
+    const uint8_t* bytes() const { return m_bytes.data(); }
+    const uint8_t* mask() const { return m_mask.data(); }
+    std::size_t firstFixed() const { return m_firstFixed; }
+    std::size_t lastFixed() const { return m_lastFixed; }
+
+    /**
+     * @brief   Formats the pattern in its canonical form, e.g. `48 8B ?? ?? E8`.
+     * @return  The formatted pattern.
+     */
+    std::string toString() const
+    {
+        static const char kHexDigits[] = "0123456789ABCDEF";
+
+        std::string result;
+        for (std::size_t i = 0; i < m_bytes.size(); ++i)
+        {
+            if (i) result += ' ';
+            result += m_mask[i] ? kHexDigits[m_bytes[i] >> 4] : '?';
+            result += m_mask[i] ? kHexDigits[m_bytes[i] & 0xF] : '?';
+        }
+        return result;
+    }
+
+    /**
+     * @brief   Determines whether the pattern matches at a location.
+     * @param   data    The location, at least `size()` bytes long.
+     * @return  @c true if it matches, else @c false.
+     */
+    bool matches(const uint8_t* data) const
+    {
+        for (std::size_t i = 0; i < m_bytes.size(); ++i)
+        {
+            if ((data[i] & m_mask[i]) != m_bytes[i]) return false;
+        }
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [findPattern]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Searches a range of memory for a pattern.
+ * @param   data    The start of the range.
+ * @param   size    The size of the range, in bytes.
+ * @param   pattern The pattern to search for.
+ * @return  The first match or @c nullptr if not found.
+ *          
+ * Candidates are filtered by comparing the first and the last fixed byte of the pattern for 32 
+ * (AVX2) or 16 (SSE2) locations at once; only locations where both match are compared in full.
+ */
+inline const uint8_t* findPattern(const void* data, std::size_t size, const Pattern& pattern)
+{
+    if (!pattern.isValid() || pattern.size() > size) return nullptr;
+
+    const auto begin = static_cast<const uint8_t*>(data);
+    const auto first = pattern.firstFixed();
+    const auto last  = pattern.lastFixed();
+    const uint8_t firstByte = pattern.bytes()[first];
+    const uint8_t lastByte  = pattern.bytes()[last];
+    const std::size_t numPos = size - pattern.size() + 1;
+    std::size_t i = 0;
+
+#   if defined(__AVX2__)
+        const __m256i vFirst = _mm256_set1_epi8(static_cast<char>(firstByte));
+        const __m256i vLast  = _mm256_set1_epi8(static_cast<char>(lastByte));
+        for (; i + 32 <= numPos; i += 32)
+        {
+            auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(
+                _mm256_cmpeq_epi8(vFirst, _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(begin + i + first))),
+                _mm256_cmpeq_epi8(vLast, _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(begin + i + last))))));
+            while (bits)
+            {
+                const std::size_t pos = i + simd::countTrailingZeros(bits);
+                if (pattern.matches(begin + pos)) return begin + pos;
+                bits &= bits - 1;
+            }
+        }
+#   elif defined(REMODEL_PATTERN_SSE2)
+        const __m128i vFirst = _mm_set1_epi8(static_cast<char>(firstByte));
+        const __m128i vLast  = _mm_set1_epi8(static_cast<char>(lastByte));
+        for (; i + 16 <= numPos; i += 16)
+        {
+            auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+                _mm_cmpeq_epi8(vFirst, _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(begin + i + first))),
+                _mm_cmpeq_epi8(vLast, _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(begin + i + last))))));
+            for (std::size_t bit = 0; bits; ++bit, bits >>= 1)
+            {
+                if ((bits & 1) && pattern.matches(begin + i + bit)) return begin + i + bit;
+            }
+        }
+#   endif
+
+    for (; i < numPos; ++i)
+    {
+        if (begin[i + first] == firstByte && begin[i + last] == lastByte 
+            && pattern.matches(begin + i))
+        {
+            return begin + i;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief   Searches a range of memory for a pattern.
+ * @copydetails findPattern(const void*, std::size_t, const Pattern&)
+ */
+inline const uint8_t* findPattern(const void* data, std::size_t size, const char* pattern)
+{
+    return findPattern(data, size, Pattern{pattern});
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [PatternSet]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Set of patterns that are searched for in a single pass.
+ *
+ * Every pattern is anchored at its first pair of adjacent fixed bytes (or, lacking one, at its 
+ * first fixed byte). The scanner looks each location's byte pair up in a 64 KiB-bit filter and
+ * only verifies the patterns sharing that anchor, so the cost of a scan barely depends on the 
+ * number of patterns. The data is split into chunks that are scanned on multiple threads; a
+ * chunk owns the match positions in its range, but reads past its end, so matches straddling 
+ * chunk boundaries are found as well.
+ */
+class PatternSet
+{
+    std::vector<Pattern> m_patterns;
+public:
+    /**
+     * @brief   Adds a pattern to the set.
+     * @param   pattern The pattern.
+     * @return  The index of the pattern, used to look up its result.
+     */
+    std::size_t add(Pattern pattern)
+    {
+        m_patterns.push_back(std::move(pattern));
+        return m_patterns.size() - 1;
+    }
+
+    /**
+     * @brief   Adds a pattern to the set.
+     * @param   pattern The pattern, e.g. `48 8B ?? ?? E8`.
+     * @return  The index of the pattern, used to look up its result.
+     */
+    std::size_t add(const char* pattern)
+    {
+        return add(Pattern{pattern});
+    }
+
+    /**
+     * @brief   Gets the number of patterns in the set.
+     * @return  The number of patterns.
+     */
+    std::size_t size() const { return m_patterns.size(); }
+
+    /**
+     * @brief   Accesses a pattern by index.
+     * @param   idx The index, as returned by @c add.
+     * @return  The pattern.
+     */
+    const Pattern& operator [] (std::size_t idx) const { return m_patterns[idx]; }
+
+    /**
+     * @brief   Searches a list of memory regions for all patterns at once.
+     * @param   regions     The regions to search.
+     * @param   numRegions  The number of regions.
+     * @param   results     Receives the first match of every pattern (in region order), or 
+     *                      @c nullptr if not found, indexed like the patterns.
+     * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+     */
+    void find(const platform::MemoryRegion* regions, std::size_t numRegions, 
+        std::vector<const uint8_t*>& results, unsigned numThreads = 0) const;
+
+    /**
+     * @brief   Searches a range of memory for all patterns at once.
+     * @param   data        The start of the range.
+     * @param   size        The size of the range, in bytes.
+     * @param   results     Receives the first match of every pattern, or @c nullptr if not found,
+     *                      indexed like the patterns.
+     * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+     */
+    void find(const void* data, std::size_t size, std::vector<const uint8_t*>& results, 
+        unsigned numThreads = 0) const
+    {
+        const platform::MemoryRegion region{reinterpret_cast<uintptr_t>(data), size};
+        find(&region, 1, results, numThreads);
+    }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Anchor lookup tables for a @c PatternSet.
+ */
+class PatternIndex
+{
+public:
+    struct Entry
+    {
+        uint32_t pattern;
+        uint32_t anchor; // offset of the anchor within the pattern
+    };
+private:
+    const PatternSet& m_set;
+    std::vector<uint64_t> m_pairFilter;
+    std::vector<uint32_t> m_pairStart;
+    std::vector<Entry> m_pairEntries;
+    std::vector<uint32_t> m_byteStart;
+    std::vector<Entry> m_byteEntries;
+    std::size_t m_maxAnchor = 0;
+
+    static void buildBuckets(std::vector<std::pair<uint32_t, Entry>>& keyed, 
+        std::size_t numKeys, std::vector<uint32_t>& start, std::vector<Entry>& entries)
+    {
+        std::stable_sort(keyed.begin(), keyed.end(), 
+            [](const std::pair<uint32_t, Entry>& a, const std::pair<uint32_t, Entry>& b)
+        {
+            return a.first < b.first;
+        });
+
+        start.assign(numKeys + 1, 0);
+        entries.reserve(keyed.size());
+        for (const auto& cur : keyed)
+        {
+            ++start[cur.first + 1];
+            entries.push_back(cur.second);
+        }
+        for (std::size_t i = 1; i <= numKeys; ++i) start[i] += start[i - 1];
+    }
+public:
+    explicit PatternIndex(const PatternSet& set)
+        : m_set(set)
+        , m_pairFilter(0x10000 / 64)
+    {
+        std::vector<std::pair<uint32_t, Entry>> pairs, bytes;
+        for (std::size_t i = 0; i < set.size(); ++i)
+        {
+            const auto& pattern = set[i];
+            if (!pattern.isValid()) continue;
+
+            std::size_t a = pattern.firstFixed();
+            while (a < pattern.lastFixed() && !(pattern.mask()[a] && pattern.mask()[a + 1])) ++a;
+            const Entry entry{static_cast<uint32_t>(i), static_cast<uint32_t>(a)};
+
+            if (a < pattern.lastFixed())
+            {
+                const uint32_t key = pattern.bytes()[a] | pattern.bytes()[a + 1] << 8;
+                m_pairFilter[key / 64] |= uint64_t{1} << key % 64;
+                pairs.emplace_back(key, entry);
+            }
+            else
+            {
+                a = pattern.firstFixed();
+                bytes.emplace_back(pattern.bytes()[a], Entry{entry.pattern, uint32_t(a)});
+            }
+            m_maxAnchor = std::max(m_maxAnchor, a);
+        }
+
+        buildBuckets(pairs, 0x10000, m_pairStart, m_pairEntries);
+        buildBuckets(bytes, 0x100, m_byteStart, m_byteEntries);
+    }
+
+    /**
+     * @brief   Scans the match positions `[begin, end)` of a range.
+     * @param   data    The start of the range.
+     * @param   size    The size of the range, in bytes.
+     * @param   begin   The first match position to consider.
+     * @param   end     The match position to stop at.
+     * @param   skip    Called with a pattern index, returns whether the pattern can be skipped.
+     * @param   found   Called with the pattern index and the match, at most once per pattern.
+     */
+    template<typename SkipT, typename FoundT>
+    void scan(const uint8_t* data, std::size_t size, std::size_t begin, std::size_t end,
+        const SkipT& skip, const FoundT& found) const
+    {
+        std::vector<bool> done(m_set.size());
+
+        auto check = [&](const Entry* first, const Entry* last, std::size_t pos)
+        {
+            for (auto cur = first; cur != last; ++cur)
+            {
+                if (pos < cur->anchor) continue;
+                const std::size_t start = pos - cur->anchor;
+                const auto& pattern = m_set[cur->pattern];
+                if (start < begin || start >= end || start + pattern.size() > size) continue;
+                if (done[cur->pattern] || skip(cur->pattern)) continue;
+                if (!pattern.matches(data + start)) continue;
+                done[cur->pattern] = true;
+                found(cur->pattern, data + start);
+            }
+        };
+
+        // MSVC12 requires parentheses here (min macro).
+        const std::size_t last = (std::min)(end + m_maxAnchor, size);
+        const bool haveBytes = !m_byteEntries.empty();
+        for (std::size_t pos = begin; pos < last; ++pos)
+        {
+            if (pos + 1 < size)
+            {
+                const uint32_t key = data[pos] | data[pos + 1] << 8;
+                if (m_pairFilter[key / 64] >> key % 64 & 1)
+                {
+                    check(&m_pairEntries[0] + m_pairStart[key], 
+                        &m_pairEntries[0] + m_pairStart[key + 1], pos);
+                }
+            }
+            if (haveBytes)
+            {
+                const auto key = data[pos];
+                check(&m_byteEntries[0] + m_byteStart[key], 
+                    &m_byteEntries[0] + m_byteStart[key + 1], pos);
+            }
+        }
+    }
+};
+
+} // namespace internal
+
+inline void PatternSet::find(const platform::MemoryRegion* regions, std::size_t numRegions,
+    std::vector<const uint8_t*>& results, unsigned numThreads) const
+{
+    const std::size_t kChunkSize = 0x40000;
+
+    struct Chunk
+    {
+        std::size_t region;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::vector<Chunk> chunks;
+    for (std::size_t i = 0; i < numRegions; ++i)
+    {
+        for (std::size_t offs = 0; offs < regions[i].size; offs += kChunkSize)
+        {
+            // MSVC12 requires parentheses here (min macro).
+            chunks.push_back({i, offs, (std::min)(offs + kChunkSize, regions[i].size)});
+        }
+    }
+
+    const internal::PatternIndex index{*this};
+
+    // Lowest chunk with a match per pattern, lets later chunks skip patterns already found.
+    std::unique_ptr<std::atomic<std::size_t>[]> bestChunk{new std::atomic<std::size_t>[size()]};
+    for (std::size_t i = 0; i < size(); ++i) bestChunk[i].store(chunks.size());
+
+    std::vector<std::vector<std::pair<std::size_t, const uint8_t*>>> found(chunks.size());
+    internal::parallelFor(chunks.size(), numThreads, [&](std::size_t chunkIdx)
+    {
+        const auto& chunk = chunks[chunkIdx];
+        const auto& region = regions[chunk.region];
+        index.scan(reinterpret_cast<const uint8_t*>(region.address), region.size, 
+            chunk.begin, chunk.end,
+            [&](std::size_t pattern)
+            {
+                return bestChunk[pattern].load(std::memory_order_relaxed) < chunkIdx;
+            },
+            [&](std::size_t pattern, const uint8_t* match)
+            {
+                found[chunkIdx].emplace_back(pattern, match);
+                auto best = bestChunk[pattern].load(std::memory_order_relaxed);
+                while (chunkIdx < best && !bestChunk[pattern].compare_exchange_weak(
+                    best, chunkIdx, std::memory_order_relaxed));
+            });
+    });
+
+    results.assign(size(), nullptr);
+    for (const auto& chunkResults : found)
+    {
+        for (const auto& cur : chunkResults)
+        {
+            if (!results[cur.first]) results[cur.first] = cur.second;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_PATTERN_HPP
@@ -29,12 +29,60 @@
  * @brief Contains wrappers for platform-specific functions.
  */
 
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "zycore/Config.hpp"
+#include "zycore/Utils.hpp"
 
 #if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
 #   include <Windows.h>
+#   include <TlHelp32.h>
 #elif defined(ZYCORE_POSIX)
 #   include <dlfcn.h>
+#   include <unistd.h>
+#   include <fcntl.h>
+#   include <sys/types.h>
+#   include <sys/stat.h>
+#   include <sys/mman.h>
+#   include <errno.h>
+#   include <setjmp.h>
+#   include <signal.h>
+#   if defined(__APPLE__)
+#       include <pthread.h>
+#       include <mach-o/dyld.h>
+#       include <mach-o/loader.h>
+#   else
+#       include <link.h>
+#   endif
+#   if defined(__linux__)
+#       include <sys/uio.h>
+#       include <sys/syscall.h>
+#       include <limits.h>
+#       include <dirent.h>
+#       include <sched.h>
+#       include <time.h>
+#       include <ucontext.h>
+#   endif
+#endif
+
+#if defined(ZYCORE_MSVC) && _MSC_VER < 1900
+    // MSVC12 lacks `thread_local`, its own attribute works for pointers.
+#   define REMODEL_THREAD_LOCAL __declspec(thread)
+#else
+#   define REMODEL_THREAD_LOCAL thread_local
 #endif
 
 namespace remodel
@@ -42,6 +90,983 @@ namespace remodel
 namespace platform
 {
     
+// ---------------------------------------------------------------------------------------------- //
+// [MemoryRegion] + [obtainCodeRegions] + [obtainModuleIdentity]                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines whether an image is an ELF image matching our pointer size.
+ * @param   base    Pointer to the image's first byte.
+ * @return  @c true if it is, else @c false.
+ */
+inline bool isElfImage(const uint8_t* base)
+{
+    return base[0] == 0x7F && base[1] == 'E' && base[2] == 'L' && base[3] == 'F'
+        && (base[4] == 2) == (sizeof(void*) == 8);
+}
+
+/**
+ * @internal
+ * @brief   Invokes a callback for every program header of a loaded ELF image.
+ * @tparam  FuncT   Type of the callback, callable as 
+ *                  `void(uint32_t type, uint32_t flags, uintptr_t address, std::size_t size)`.
+ * @param   base    Pointer to the image's first byte, must satisfy @c isElfImage.
+ * @param   func    The callback, receives the segments' addresses with the load bias applied.
+ * @param   biasOut If not @c nullptr, receives the load bias.
+ * @return  @c true if a loadable segment was found, else @c false.
+ */
+template<typename FuncT>
+bool forEachElfSegment(const uint8_t* base, const FuncT& func, uintptr_t* biasOut = nullptr)
+{
+    static const uint32_t kPtLoad = 1;
+    const bool is64 = base[4] == 2;
+    auto load = [base](std::size_t offs, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, base + offs, size); 
+    };
+
+    uint64_t phoff;
+    uint16_t phentsize, phnum;
+    if (is64)
+    {
+        load(32, &phoff, 8);
+        load(54, &phentsize, 2);
+        load(56, &phnum, 2);
+    }
+    else
+    {
+        uint32_t phoff32;
+        load(28, &phoff32, 4);
+        load(42, &phentsize, 2);
+        load(44, &phnum, 2);
+        phoff = phoff32;
+    }
+
+    struct Segment
+    {
+        uint32_t type, flags;
+        uint64_t vaddr, memsz;
+    };
+
+    // The header is mapped at the start of the first loadable segment, which lets us calculate 
+    // the load bias (0 for non-PIE executables). Program headers preceding it (PT_PHDR, 
+    // PT_INTERP) are buffered until it is known.
+    std::vector<Segment> segments;
+    bool haveBias = false;
+    uintptr_t bias = 0;
+    for (uint16_t i = 0; i < phnum; ++i)
+    {
+        const std::size_t ph = static_cast<std::size_t>(phoff) + i * phentsize;
+        Segment seg;
+        uint64_t align;
+        load(ph, &seg.type, 4);
+        if (is64)
+        {
+            load(ph + 4,  &seg.flags, 4);
+            load(ph + 16, &seg.vaddr, 8);
+            load(ph + 40, &seg.memsz, 8);
+            load(ph + 48, &align, 8);
+        }
+        else
+        {
+            uint32_t vaddr32, memsz32, align32;
+            load(ph + 8,  &vaddr32,   4);
+            load(ph + 20, &memsz32,   4);
+            load(ph + 24, &seg.flags, 4);
+            load(ph + 28, &align32,   4);
+            seg.vaddr = vaddr32; seg.memsz = memsz32; align = align32;
+        }
+        segments.push_back(seg);
+
+        if (!haveBias && seg.type == kPtLoad)
+        {
+            const uint64_t alignedVaddr = align > 1 ? seg.vaddr & ~(align - 1) : seg.vaddr;
+            bias = reinterpret_cast<uintptr_t>(base) - static_cast<uintptr_t>(alignedVaddr);
+            haveBias = true;
+        }
+    }
+
+    if (!haveBias) return false;
+    if (biasOut) *biasOut = bias;
+    for (const auto& cur : segments)
+    {
+        func(cur.type, cur.flags, bias + static_cast<uintptr_t>(cur.vaddr), 
+            static_cast<std::size_t>(cur.memsz));
+    }
+    return true;
+}
+
+} // namespace internal
+
+/**
+ * @brief   A range of memory.
+ */
+struct MemoryRegion
+{
+    uintptr_t address;
+    std::size_t size;
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Obtains the executable or the non-executable regions of a loaded module.
+ * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+ * @param   regions     Receives the regions.
+ * @param   executable  @c true for the executable regions, @c false for the readable data.
+ * @return  @c true if the image format was recognized, else @c false.
+ */
+inline bool obtainImageRegions(const void* imageBase, std::vector<MemoryRegion>& regions,
+    bool executable)
+{
+    regions.clear();
+    if (!imageBase) return false;
+
+    auto base = static_cast<const uint8_t*>(imageBase);
+    auto load = [base](std::size_t offs, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, base + offs, size); 
+    };
+
+    // PE image?
+    if (base[0] == 'M' && base[1] == 'Z')
+    {
+        static const uint32_t kScnMemExecute = 0x20000000;
+        static const uint32_t kScnMemRead    = 0x40000000;
+
+        uint32_t ntOffs, signature;
+        uint16_t numSections, optHeaderSize;
+        load(0x3C, &ntOffs, 4);
+        load(ntOffs, &signature, 4);
+        if (signature != 0x00004550) return false; // 'PE\0\0'
+        load(ntOffs + 6, &numSections, 2);
+        load(ntOffs + 20, &optHeaderSize, 2);
+
+        const std::size_t sections = ntOffs + 24 + optHeaderSize;
+        for (uint16_t i = 0; i < numSections; ++i)
+        {
+            uint32_t virtualSize, virtualAddress, characteristics;
+            load(sections + i * 40 + 8,  &virtualSize,     4);
+            load(sections + i * 40 + 12, &virtualAddress,  4);
+            load(sections + i * 40 + 36, &characteristics, 4);
+            const bool matches = executable
+                ? (characteristics & kScnMemExecute) != 0
+                : (characteristics & (kScnMemExecute | kScnMemRead)) == kScnMemRead;
+            if (matches)
+            {
+                regions.push_back({reinterpret_cast<uintptr_t>(base) + virtualAddress, 
+                    virtualSize});
+            }
+        }
+        return true;
+    }
+
+    // ELF image?
+    if (isElfImage(base))
+    {
+        static const uint32_t kPtLoad = 1;
+        static const uint32_t kPfX    = 1;
+        static const uint32_t kPfR    = 4;
+
+        return forEachElfSegment(base, 
+            [&](uint32_t type, uint32_t flags, uintptr_t address, std::size_t size)
+        {
+            if (type != kPtLoad) return;
+            const bool matches = executable
+                ? (flags & kPfX) != 0
+                : (flags & (kPfX | kPfR)) == kPfR;
+            if (matches) regions.push_back({address, size});
+        });
+    }
+
+    return false;
+}
+
+} // namespace internal
+
+/**
+ * @brief   Obtains the executable regions of a module loaded into our address space.
+ * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+ * @param   regions     Receives the regions.
+ * @return  @c true if the image format was recognized, else @c false.
+ *          
+ * Both PE (executable sections) and ELF (executable `PT_LOAD` segments) images are supported,
+ * independent of the host platform.
+ */
+inline bool obtainCodeRegions(const void* imageBase, std::vector<MemoryRegion>& regions)
+{
+    return internal::obtainImageRegions(imageBase, regions, true);
+}
+
+/**
+ * @brief   Obtains the readable, non-executable regions of a module loaded into our address space,
+ *          holding its constants, vtables and global variables.
+ * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+ * @param   regions     Receives the regions.
+ * @return  @c true if the image format was recognized, else @c false.
+ */
+inline bool obtainDataRegions(const void* imageBase, std::vector<MemoryRegion>& regions)
+{
+    return internal::obtainImageRegions(imageBase, regions, false);
+}
+
+/**
+ * @brief   Obtains bytes identifying the build of a module loaded into our address space.
+ * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+ * @param   identity    Receives the identity.
+ * @return  @c true if an identity was found, else @c false.
+ *          
+ * For PE images, the identity consists of the link timestamp, the checksum and the image size 
+ * from the headers; for ELF images, it is the GNU build-id note. ELF images linked without
+ * `--build-id` have no identity.
+ */
+inline bool obtainModuleIdentity(const void* imageBase, std::vector<uint8_t>& identity)
+{
+    identity.clear();
+    if (!imageBase) return false;
+
+    auto base = static_cast<const uint8_t*>(imageBase);
+    auto load = [](const uint8_t* ptr, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, ptr, size); 
+    };
+
+    // PE image?
+    if (base[0] == 'M' && base[1] == 'Z')
+    {
+        uint32_t ntOffs, signature;
+        load(base + 0x3C, &ntOffs, 4);
+        load(base + ntOffs, &signature, 4);
+        if (signature != 0x00004550) return false; // 'PE\0\0'
+
+        // TimeDateStamp (file header), SizeOfImage and CheckSum (optional header, same offsets 
+        // for PE32 and PE32+).
+        const uint8_t* fields[] = {base + ntOffs + 8, base + ntOffs + 24 + 56, 
+            base + ntOffs + 24 + 64};
+        for (auto cur : fields) identity.insert(identity.end(), cur, cur + 4);
+        return true;
+    }
+
+    // ELF image?
+    if (internal::isElfImage(base))
+    {
+        static const uint32_t kPtNote       = 4;
+        static const uint32_t kNtGnuBuildId = 3;
+
+        internal::forEachElfSegment(base, 
+            [&](uint32_t type, uint32_t, uintptr_t address, std::size_t size)
+        {
+            if (type != kPtNote || !identity.empty()) return;
+
+            auto note = reinterpret_cast<const uint8_t*>(address);
+            for (auto end = note + size; note + 12 <= end;)
+            {
+                uint32_t nameSize, descSize, noteType;
+                load(note,     &nameSize, 4);
+                load(note + 4, &descSize, 4);
+                load(note + 8, &noteType, 4);
+                const auto name = note + 12;
+                const auto desc = name + ((nameSize + 3) & ~3u);
+                if (noteType == kNtGnuBuildId && nameSize == 4 && !std::memcmp(name, "GNU", 4))
+                {
+                    identity.assign(desc, desc + descSize);
+                    return;
+                }
+                note = desc + ((descSize + 3) & ~3u);
+            }
+        });
+        return !identity.empty();
+    }
+
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [SymbolInfo] + [obtainExports]                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A symbol exported by a module.
+ */
+struct SymbolInfo
+{
+    /**
+     * @brief   The name, pointing into the module's string table.
+     */
+    const char* name;
+    /**
+     * @brief   The address.
+     */
+    uintptr_t address;
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Invokes a callback for every entry of the dynamic section of a loaded ELF image.
+ * @tparam  FuncT   Type of the callback, callable as `void(int64_t tag, uint64_t value)`.
+ * @param   base    Pointer to the image's first byte, must satisfy @c isElfImage.
+ * @param   func    The callback.
+ * @param   bias    Receives the load bias.
+ * @return  @c true if the image has a dynamic section, else @c false.
+ *
+ * Values are passed as stored. glibc relocates pointers in-place, other loaders (and the vDSO)
+ * don't, see `relocateElfPointer`.
+ */
+template<typename FuncT>
+bool forEachElfDynamicEntry(const uint8_t* base, const FuncT& func, uintptr_t& bias)
+{
+    static const uint32_t kPtDynamic = 2;
+    static const int64_t kDtNull     = 0;
+
+    const bool is64 = sizeof(void*) == 8;
+    auto load = [](uintptr_t addr, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, reinterpret_cast<const void*>(addr), size); 
+    };
+
+    uintptr_t dynamic = 0;
+    bias = 0;
+    forEachElfSegment(base, [&](uint32_t type, uint32_t, uintptr_t address, std::size_t)
+    {
+        if (type == kPtDynamic) dynamic = address;
+    }, &bias);
+    if (!dynamic) return false;
+
+    for (uintptr_t cur = dynamic;; cur += is64 ? 16 : 8)
+    {
+        int64_t tag = 0;
+        uint64_t val = 0;
+        if (is64)
+        {
+            load(cur, &tag, 8);
+            load(cur + 8, &val, 8);
+        }
+        else
+        {
+            int32_t tag32;
+            uint32_t val32;
+            load(cur, &tag32, 4);
+            load(cur + 4, &val32, 4);
+            tag = tag32; val = val32;
+        }
+        if (tag == kDtNull) break;
+        func(tag, val);
+    }
+    return true;
+}
+
+/**
+ * @internal
+ * @brief   Converts a pointer stored in the dynamic section into an address.
+ * @param   base    Pointer to the image's first byte.
+ * @param   bias    The load bias.
+ * @param   value   The stored value, relocated by the loader or not.
+ * @return  The address.
+ */
+inline uintptr_t relocateElfPointer(const uint8_t* base, uintptr_t bias, uint64_t value)
+{
+    auto ptr = static_cast<uintptr_t>(value);
+    return ptr < reinterpret_cast<uintptr_t>(base) ? ptr + bias : ptr;
+}
+
+/**
+ * @internal
+ * @brief   Collects the defined function and object symbols from an ELF image's `.dynsym`.
+ * @param   base    Pointer to the image's first byte, must satisfy @c isElfImage.
+ * @param   symbols Receives the symbols.
+ * @return  @c true if the image has a dynamic symbol table, else @c false.
+ */
+inline bool obtainElfExports(const uint8_t* base, std::vector<SymbolInfo>& symbols)
+{
+    static const int64_t kDtHash      = 4;
+    static const int64_t kDtStrTab    = 5;
+    static const int64_t kDtSymTab    = 6;
+    static const int64_t kDtGnuHash   = 0x6FFFFEF5;
+    static const int64_t kDtVerSym    = 0x6FFFFFF0;
+    static const uint8_t kSttObject   = 1;
+    static const uint8_t kSttFunc     = 2;
+    static const uint16_t kShnUndef   = 0;
+    static const uint16_t kVerHidden  = 0x8000;
+
+    const bool is64 = sizeof(void*) == 8;
+    auto load = [](uintptr_t addr, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, reinterpret_cast<const void*>(addr), size); 
+    };
+
+    uintptr_t bias, hash = 0, gnuHash = 0, strTab = 0, symTab = 0, verSym = 0;
+    const bool haveDynamic = forEachElfDynamicEntry(base, [&](int64_t tag, uint64_t val)
+    {
+        const auto ptr = relocateElfPointer(base, bias, val);
+        switch (tag)
+        {
+            case kDtHash:    hash    = ptr; break;
+            case kDtGnuHash: gnuHash = ptr; break;
+            case kDtStrTab:  strTab  = ptr; break;
+            case kDtSymTab:  symTab  = ptr; break;
+            case kDtVerSym:  verSym  = ptr; break;
+            default: break;
+        }
+    }, bias);
+    if (!haveDynamic || !strTab || !symTab || (!hash && !gnuHash)) return false;
+
+    // The symbol count is only stored in the SysV hash table, with GNU hashes we have to find
+    // the end of the last hash chain.
+    uint32_t numSymbols = 0;
+    if (hash)
+    {
+        load(hash + 4, &numSymbols, 4);
+    }
+    else
+    {
+        uint32_t numBuckets, symOffset, bloomSize;
+        load(gnuHash,     &numBuckets, 4);
+        load(gnuHash + 4, &symOffset,  4);
+        load(gnuHash + 8, &bloomSize,  4);
+        const uintptr_t buckets = gnuHash + 16 + bloomSize * sizeof(void*);
+        const uintptr_t chains  = buckets + numBuckets * 4;
+
+        uint32_t last = 0;
+        for (uint32_t i = 0; i < numBuckets; ++i)
+        {
+            uint32_t bucket;
+            load(buckets + i * 4, &bucket, 4);
+            last = std::max(last, bucket);
+        }
+        if (last >= symOffset)
+        {
+            for (uint32_t chain = 0; !(chain & 1); ++last)
+            {
+                load(chains + (last - symOffset) * 4, &chain, 4);
+            }
+        }
+        numSymbols = std::max(last, symOffset);
+    }
+
+    for (uint32_t i = 1; i < numSymbols; ++i)
+    {
+        uint32_t nameOffs;
+        uint8_t info;
+        uint16_t shndx;
+        uint64_t value;
+        const uintptr_t sym = symTab + i * (is64 ? 24 : 16);
+        load(sym, &nameOffs, 4);
+        if (is64)
+        {
+            load(sym + 4, &info, 1);
+            load(sym + 6, &shndx, 2);
+            load(sym + 8, &value, 8);
+        }
+        else
+        {
+            uint32_t value32;
+            load(sym + 4,  &value32, 4);
+            load(sym + 12, &info, 1);
+            load(sym + 14, &shndx, 2);
+            value = value32;
+        }
+
+        const auto type = static_cast<uint8_t>(info & 0xF);
+        if (shndx == kShnUndef || (type != kSttFunc && type != kSttObject)) continue;
+        if (verSym)
+        {
+            // Skip non-default versions (`foo@VER` rather than `foo@@VER`).
+            uint16_t version;
+            load(verSym + i * 2, &version, 2);
+            if (version & kVerHidden) continue;
+        }
+
+        symbols.push_back({reinterpret_cast<const char*>(strTab + nameOffs), 
+            bias + static_cast<uintptr_t>(value)});
+    }
+    return true;
+}
+
+} // namespace internal
+
+/**
+ * @brief   Obtains the symbols exported by a module loaded into our address space.
+ * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+ * @param   symbols     Receives the symbols.
+ * @return  @c true if the image format was recognized, else @c false.
+ *          
+ * For PE images, the named entries of the export directory are returned, excluding forwarders. 
+ * For ELF images, the defined function and object symbols of the dynamic symbol table are 
+ * returned (in their default version); `STT_GNU_IFUNC` symbols are skipped, as their address
+ * is that of the resolver.
+ */
+inline bool obtainExports(const void* imageBase, std::vector<SymbolInfo>& symbols)
+{
+    symbols.clear();
+    if (!imageBase) return false;
+
+    auto base = static_cast<const uint8_t*>(imageBase);
+    auto load = [base](std::size_t offs, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, base + offs, size); 
+    };
+
+    // PE image?
+    if (base[0] == 'M' && base[1] == 'Z')
+    {
+        static const uint16_t kPe32PlusMagic = 0x20B;
+
+        uint32_t ntOffs, signature;
+        uint16_t magic;
+        load(0x3C, &ntOffs, 4);
+        load(ntOffs, &signature, 4);
+        if (signature != 0x00004550) return false; // 'PE\0\0'
+        load(ntOffs + 24, &magic, 2);
+
+        uint32_t dirRva, dirSize;
+        const std::size_t dataDirs = ntOffs + 24 + (magic == kPe32PlusMagic ? 112 : 96);
+        load(dataDirs,     &dirRva,  4);
+        load(dataDirs + 4, &dirSize, 4);
+        if (!dirRva) return true;
+
+        uint32_t numNames, functions, names, ordinals;
+        load(dirRva + 24, &numNames,  4);
+        load(dirRva + 28, &functions, 4);
+        load(dirRva + 32, &names,     4);
+        load(dirRva + 36, &ordinals,  4);
+        for (uint32_t i = 0; i < numNames; ++i)
+        {
+            uint32_t nameRva, funcRva;
+            uint16_t ordinal;
+            load(names + i * 4, &nameRva, 4);
+            load(ordinals + i * 2, &ordinal, 2);
+            load(functions + ordinal * 4, &funcRva, 4);
+
+            // Forwarders point to a string (`dll.name`) inside the export directory.
+            if (funcRva >= dirRva && funcRva < dirRva + dirSize) continue;
+            symbols.push_back({reinterpret_cast<const char*>(base + nameRva),
+                reinterpret_cast<uintptr_t>(base) + funcRva});
+        }
+        return true;
+    }
+
+    // ELF image?
+    if (internal::isElfImage(base)) return internal::obtainElfExports(base, symbols);
+
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [ImportInfo] + [obtainImports]                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A symbol imported by a module.
+ */
+struct ImportInfo
+{
+    /**
+     * @brief   The name of the module imported from (e.g. `kernel32.dll`), pointing into the
+     *          importing module. @c nullptr for ELF images, which import symbols from any module.
+     */
+    const char* module;
+    /**
+     * @brief   The name of the symbol, pointing into the importing module.
+     */
+    const char* name;
+    /**
+     * @brief   The address of the pointer the module calls the symbol through (its IAT or GOT
+     *          entry).
+     */
+    uintptr_t slot;
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Collects the GOT entries of an ELF image referring to named symbols.
+ * @param   base    Pointer to the image's first byte, must satisfy @c isElfImage.
+ * @param   imports Receives the imports.
+ * @return  @c true if the image has a dynamic section, else @c false.
+ */
+inline bool obtainElfImports(const uint8_t* base, std::vector<ImportInfo>& imports)
+{
+    static const int64_t kDtPltRelSz = 2;
+    static const int64_t kDtStrTab   = 5;
+    static const int64_t kDtSymTab   = 6;
+    static const int64_t kDtRela     = 7;
+    static const int64_t kDtRelaSz   = 8;
+    static const int64_t kDtRel      = 17;
+    static const int64_t kDtRelSz    = 18;
+    static const int64_t kDtPltRel   = 20;
+    static const int64_t kDtJmpRel   = 23;
+
+#   if defined(__x86_64__) || defined(__i386__)
+        static const uint32_t kGlobDat = 6, kJumpSlot = 7;
+#   elif defined(__aarch64__)
+        static const uint32_t kGlobDat = 1025, kJumpSlot = 1026;
+#   elif defined(__arm__)
+        static const uint32_t kGlobDat = 21, kJumpSlot = 22;
+#   else
+        static const uint32_t kGlobDat = ~0u, kJumpSlot = ~0u;
+#   endif
+
+    const bool is64 = sizeof(void*) == 8;
+    auto load = [](uintptr_t addr, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, reinterpret_cast<const void*>(addr), size); 
+    };
+
+    uintptr_t bias, strTab = 0, symTab = 0, rela = 0, rel = 0, jmpRel = 0;
+    uint64_t relaSize = 0, relSize = 0, jmpRelSize = 0, pltRel = kDtRela;
+    const bool haveDynamic = forEachElfDynamicEntry(base, [&](int64_t tag, uint64_t val)
+    {
+        const auto ptr = relocateElfPointer(base, bias, val);
+        switch (tag)
+        {
+            case kDtStrTab:   strTab     = ptr; break;
+            case kDtSymTab:   symTab     = ptr; break;
+            case kDtRela:     rela       = ptr; break;
+            case kDtRelaSz:   relaSize   = val; break;
+            case kDtRel:      rel        = ptr; break;
+            case kDtRelSz:    relSize    = val; break;
+            case kDtJmpRel:   jmpRel     = ptr; break;
+            case kDtPltRelSz: jmpRelSize = val; break;
+            case kDtPltRel:   pltRel     = val; break;
+            default: break;
+        }
+    }, bias);
+    if (!haveDynamic || !strTab || !symTab) return false;
+
+    auto collect = [&](uintptr_t table, uint64_t size, bool withAddend)
+    {
+        const std::size_t entrySize = (is64 ? 16 : 8) + (withAddend ? (is64 ? 8 : 4) : 0);
+        for (uintptr_t cur = table; table && cur + entrySize <= table + size; cur += entrySize)
+        {
+            uint64_t offset;
+            uint32_t type, symbol;
+            if (is64)
+            {
+                uint64_t info;
+                load(cur, &offset, 8);
+                load(cur + 8, &info, 8);
+                type = static_cast<uint32_t>(info);
+                symbol = static_cast<uint32_t>(info >> 32);
+            }
+            else
+            {
+                uint32_t offset32, info;
+                load(cur, &offset32, 4);
+                load(cur + 4, &info, 4);
+                offset = offset32;
+                type = info & 0xFF;
+                symbol = info >> 8;
+            }
+            if ((type != kGlobDat && type != kJumpSlot) || !symbol) continue;
+
+            uint32_t nameOffs;
+            load(symTab + symbol * (is64 ? 24 : 16), &nameOffs, 4);
+            const auto name = reinterpret_cast<const char*>(strTab + nameOffs);
+            if (*name) imports.push_back({nullptr, name, bias + static_cast<uintptr_t>(offset)});
+        }
+    };
+    collect(rela, relaSize, true);
+    collect(rel, relSize, false);
+    collect(jmpRel, jmpRelSize, pltRel == kDtRela);
+    return true;
+}
+
+} // namespace internal
+
+/**
+ * @brief   Obtains the symbols imported by a module loaded into our address space.
+ * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+ * @param   imports     Receives the imports.
+ * @return  @c true if the image format was recognized, else @c false.
+ *
+ * For PE images, the entries of the import directory imported by name are returned, with their
+ * IAT entries. For ELF images, the GOT entries of `GLOB_DAT` and `JUMP_SLOT` relocations are 
+ * returned; a symbol can occur twice if its address is taken and it is called, too.
+ */
+inline bool obtainImports(const void* imageBase, std::vector<ImportInfo>& imports)
+{
+    imports.clear();
+    if (!imageBase) return false;
+
+    auto base = static_cast<const uint8_t*>(imageBase);
+    auto load = [base](std::size_t offs, void* out, std::size_t size) 
+    { 
+        std::memcpy(out, base + offs, size); 
+    };
+
+    // PE image?
+    if (base[0] == 'M' && base[1] == 'Z')
+    {
+        static const uint16_t kPe32PlusMagic = 0x20B;
+
+        uint32_t ntOffs, signature;
+        uint16_t magic;
+        load(0x3C, &ntOffs, 4);
+        load(ntOffs, &signature, 4);
+        if (signature != 0x00004550) return false; // 'PE\0\0'
+        load(ntOffs + 24, &magic, 2);
+
+        const bool is64 = magic == kPe32PlusMagic;
+        const std::size_t thunkSize = is64 ? 8 : 4;
+        const uint64_t ordinalFlag = uint64_t{1} << (thunkSize * 8 - 1);
+        uint32_t dirRva;
+        load(ntOffs + 24 + (is64 ? 112 : 96) + 8, &dirRva, 4);
+        if (!dirRva) return true;
+
+        for (uint32_t desc = dirRva;; desc += 20)
+        {
+            uint32_t lookupRva, nameRva, iatRva;
+            load(desc,      &lookupRva, 4);
+            load(desc + 12, &nameRva,   4);
+            load(desc + 16, &iatRva,    4);
+            if (!nameRva) break;
+
+            // Without a lookup table, the names are read from the IAT, which only works as 
+            // long as it isn't bound.
+            if (!lookupRva) lookupRva = iatRva;
+            for (std::size_t i = 0;; ++i)
+            {
+                uint64_t thunk = 0;
+                load(lookupRva + i * thunkSize, &thunk, thunkSize);
+                if (!thunk) break;
+                if (thunk & ordinalFlag) continue;
+
+                // Skips the hint preceding the name.
+                imports.push_back({reinterpret_cast<const char*>(base + nameRva),
+                    reinterpret_cast<const char*>(base + static_cast<uint32_t>(thunk) + 2),
+                    reinterpret_cast<uintptr_t>(base) + iatRva + i * thunkSize});
+            }
+        }
+        return true;
+    }
+
+    // ELF image?
+    if (internal::isElfImage(base)) return internal::obtainElfImports(base, imports);
+
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [ModuleInfo] + [enumerateModules]                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Information about a module loaded into our address space.
+ */
+struct ModuleInfo
+{
+    /**
+     * @brief   The file name of the module, e.g. `libc.so.6`.
+     */
+    std::string name;
+    /**
+     * @brief   The path of the module, as reported by the loader.
+     */
+    std::string path;
+    /**
+     * @brief   Pointer to the module's first byte.
+     */
+    uintptr_t base;
+    /**
+     * @brief   The size of the mapped image, in bytes.
+     */
+    std::size_t size;
+    /**
+     * @brief   The executable regions, see @c obtainCodeRegions.
+     */
+    std::vector<MemoryRegion> codeRegions;
+    /**
+     * @brief   The build identity, see @c obtainModuleIdentity.
+     */
+    std::vector<uint8_t> identity;
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Gets the file name component of a path.
+ * @param   path    The path.
+ * @return  The file name.
+ */
+inline std::string fileNameOf(const std::string& path)
+{
+    const auto pos = path.find_last_of("/\\");
+    return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+/**
+ * @internal
+ * @brief   `dl_iterate_phdr` callback collecting module base and size.
+ */
+inline int collectModule(dl_phdr_info* info, std::size_t, void* context)
+{
+    static const uint32_t kPtLoad = 1;
+    auto& modules = *static_cast<std::vector<ModuleInfo>*>(context);
+
+    uintptr_t lo = ~uintptr_t{0}, hi = 0;
+    for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
+    {
+        const auto& ph = info->dlpi_phdr[i];
+        if (ph.p_type != kPtLoad) continue;
+        const uintptr_t align = ph.p_align > 1 ? static_cast<uintptr_t>(ph.p_align) : 1;
+        lo = std::min(lo, static_cast<uintptr_t>(ph.p_vaddr) & ~(align - 1));
+        hi = std::max(hi, static_cast<uintptr_t>(ph.p_vaddr + ph.p_memsz));
+    }
+    if (lo > hi) return 0;
+
+    ModuleInfo module;
+    module.path = info->dlpi_name ? info->dlpi_name : "";
+#   if defined(__linux__)
+        // The main executable is reported first, without a name.
+        if (module.path.empty() && modules.empty())
+        {
+            char buf[PATH_MAX];
+            const auto len = readlink("/proc/self/exe", buf, sizeof(buf));
+            if (len > 0) module.path.assign(buf, static_cast<std::size_t>(len));
+        }
+#   endif
+    module.name = fileNameOf(module.path);
+    module.base = static_cast<uintptr_t>(info->dlpi_addr) + lo;
+    module.size = hi - lo;
+    modules.push_back(std::move(module));
+    return 0;
+}
+#endif
+
+} // namespace internal
+
+/**
+ * @brief   Enumerates the modules loaded into our address space.
+ * @param   modules Receives the modules, the main executable first.
+ * @return  @c true if succeeded, else @c false.
+ *          
+ * Uses Toolhelp on Windows, `dl_iterate_phdr` on ELF platforms and the dyld image list on OS X;
+ * none of these increments the reference count of a module. Code regions and identities are
+ * filled in for PE and ELF images.
+ */
+inline bool enumerateModules(std::vector<ModuleInfo>& modules)
+{
+    modules.clear();
+
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        HANDLE snapshot = CreateToolhelp32Snapshot(
+            TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, GetCurrentProcessId());
+        if (snapshot == INVALID_HANDLE_VALUE) return false;
+
+        auto toUtf8 = [](const wchar_t* str)
+        {
+            std::string result;
+            const int len = WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr);
+            if (len <= 1) return result;
+            result.resize(static_cast<std::size_t>(len));
+            WideCharToMultiByte(CP_UTF8, 0, str, -1, &result[0], len, nullptr, nullptr);
+            result.resize(static_cast<std::size_t>(len - 1));
+            return result;
+        };
+
+        MODULEENTRY32W entry;
+        entry.dwSize = sizeof(entry);
+        const auto mainBase = reinterpret_cast<uintptr_t>(GetModuleHandleW(nullptr));
+        for (BOOL ok = Module32FirstW(snapshot, &entry); ok; ok = Module32NextW(snapshot, &entry))
+        {
+            ModuleInfo module;
+            module.name = toUtf8(entry.szModule);
+            module.path = toUtf8(entry.szExePath);
+            module.base = reinterpret_cast<uintptr_t>(entry.modBaseAddr);
+            module.size = entry.modBaseSize;
+            modules.push_back(std::move(module));
+            if (modules.back().base == mainBase) std::swap(modules.front(), modules.back());
+        }
+        CloseHandle(snapshot);
+#   elif defined(__APPLE__)
+#       if defined(__LP64__)
+            using MachHeader = mach_header_64;
+            using SegmentCommand = segment_command_64;
+            const uint32_t kLcSegment = LC_SEGMENT_64;
+#       else
+            using MachHeader = mach_header;
+            using SegmentCommand = segment_command;
+            const uint32_t kLcSegment = LC_SEGMENT;
+#       endif
+
+        for (uint32_t i = 0; i < _dyld_image_count(); ++i)
+        {
+            auto header = reinterpret_cast<const MachHeader*>(_dyld_get_image_header(i));
+            if (!header) continue;
+
+            // The image spans its segments, except for the inaccessible `__PAGEZERO`.
+            const uintptr_t slide = static_cast<uintptr_t>(_dyld_get_image_vmaddr_slide(i));
+            uintptr_t lo = ~uintptr_t{0}, hi = 0;
+            auto cmd = reinterpret_cast<const load_command*>(header + 1);
+            for (uint32_t j = 0; j < header->ncmds; ++j)
+            {
+                if (cmd->cmd == kLcSegment)
+                {
+                    auto seg = reinterpret_cast<const SegmentCommand*>(cmd);
+                    const auto segBase = static_cast<uintptr_t>(seg->vmaddr) + slide;
+                    if (seg->initprot)
+                    {
+                        lo = std::min(lo, segBase);
+                        hi = std::max(hi, segBase + static_cast<uintptr_t>(seg->vmsize));
+                    }
+                }
+                cmd = reinterpret_cast<const load_command*>(
+                    reinterpret_cast<const uint8_t*>(cmd) + cmd->cmdsize);
+            }
+
+            ModuleInfo module;
+            module.path = _dyld_get_image_name(i);
+            module.name = internal::fileNameOf(module.path);
+            module.base = reinterpret_cast<uintptr_t>(header);
+            module.size = lo > hi ? 0 : hi - module.base;
+            modules.push_back(std::move(module));
+        }
+#   elif defined(ZYCORE_POSIX)
+        dl_iterate_phdr(&internal::collectModule, &modules);
+#   else
+#       error "Platform not supported"
+#   endif
+
+    for (auto& cur : modules)
+    {
+        obtainCodeRegions(reinterpret_cast<const void*>(cur.base), cur.codeRegions);
+        obtainModuleIdentity(reinterpret_cast<const void*>(cur.base), cur.identity);
+    }
+
+    return !modules.empty();
+}
+
+/**
+ * @brief   Determines whether a module matches a name as accepted by @c obtainModuleHandle.
+ * @param   module      The module.
+ * @param   moduleName  The file name or, if it contains a path separator, the path.
+ * @return  @c true if it matches, else @c false.
+ */
+inline bool matchesModuleName(const ModuleInfo& module, const char* moduleName)
+{
+    const bool isPath = std::strpbrk(moduleName, "/\\") != nullptr;
+    const auto& str = isPath ? module.path : module.name;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        return _stricmp(str.c_str(), moduleName) == 0;
+#   else
+        return str == moduleName;
+#   endif
+}
+
 // ---------------------------------------------------------------------------------------------- //
 // [obtainModuleHandle]                                                                           //
 // ---------------------------------------------------------------------------------------------- //
@@ -56,15 +1081,1890 @@ inline void* obtainModuleHandle(const char* moduleName)
 #   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
         return GetModuleHandleA(moduleName);
 #   elif defined(ZYCORE_POSIX)
-        return dlopen(moduleName, RTLD_NOLOAD);
+        // `dlopen` would hand out a loader handle (and a reference) instead of the image base.
+        std::vector<ModuleInfo> modules;
+        if (!enumerateModules(modules)) return nullptr;
+        if (!moduleName) return reinterpret_cast<void*>(modules.front().base);
+        for (const auto& cur : modules)
+        {
+            if (matchesModuleName(cur, moduleName)) return reinterpret_cast<void*>(cur.base);
+        }
+        return nullptr;
 #   else
 #       error "Platform not supported"
 #   endif
 }
 
 // ---------------------------------------------------------------------------------------------- //
+// [ProcessHandle] + helper functions                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+#if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+/**
+ * @brief   Handle referring to another process.
+ */
+using ProcessHandle = HANDLE;
+#elif defined(ZYCORE_POSIX)
+using ProcessHandle = pid_t;
+#endif
+
+/**
+ * @brief   Value of `ProcessHandle` returned by `openProcess` on failure.
+ */
+const ProcessHandle kInvalidProcess = 0;
+
+/**
+ * @brief   Opens a process for reading and writing its memory.
+ * @param   pid The ID of the process.
+ * @return  The process handle or `kInvalidProcess` on failure.
+ *
+ * Accessing other processes is supported on Windows and Linux only. On other POSIX platforms
+ * (OS X), this always fails.
+ */
+inline ProcessHandle openProcess(uint32_t pid)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        return OpenProcess(PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_VM_OPERATION 
+            | PROCESS_QUERY_INFORMATION, FALSE, pid);
+#   elif defined(__linux__)
+        // Linux doesn't have process handles, we just keep the PID.
+        return static_cast<pid_t>(pid);
+#   elif defined(ZYCORE_POSIX)
+        // Unsupported: OS X would require task ports (`task_for_pid`) and Mach VM calls.
+        (void)pid;
+        return kInvalidProcess;
+#   else
+#       error "Platform not supported"
+#   endif
+}
+
+/**
+ * @brief   Closes a process handle obtained from `openProcess`.
+ * @param   process The process handle.
+ */
+inline void closeProcess(ProcessHandle process)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        if (process) CloseHandle(process);
+#   else
+        (void)process;
+#   endif
+}
+
+/**
+ * @brief   Reads memory of another process.
+ * @param   process The process to read from.
+ * @param   address The address to read from, in the address space of @c process.
+ * @param   out     The buffer receiving the data.
+ * @param   size    The number of bytes to read.
+ * @return  The number of bytes read.
+ */
+inline std::size_t readProcessMemory(
+    ProcessHandle process, uintptr_t address, void* out, std::size_t size)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        SIZE_T read = 0;
+        ReadProcessMemory(process, reinterpret_cast<LPCVOID>(address), out, size, &read);
+        return read;
+#   elif defined(__linux__)
+        iovec local {out, size};
+        iovec remote{reinterpret_cast<void*>(address), size};
+        auto read = process_vm_readv(process, &local, 1, &remote, 1, 0);
+        return read < 0 ? 0 : static_cast<std::size_t>(read);
+#   else
+        // Unsupported, `openProcess` never hands out handles here.
+        (void)process; (void)address; (void)out; (void)size;
+        return 0;
+#   endif
+}
+
+/**
+ * @brief   Range of memory to transfer from or to another process.
+ */
+struct IoRange
+{
+    /**
+     * @brief   The address in the address space of the other process.
+     */
+    uintptr_t address;
+    /**
+     * @brief   The local buffer.
+     */
+    void* buffer;
+    /**
+     * @brief   The size of the range, in bytes.
+     */
+    std::size_t size;
+};
+
+/**
+ * @brief   Reads multiple ranges of memory of another process.
+ * @param   process The process to read from.
+ * @param   ranges  The ranges to read.
+ * @param   count   The number of ranges.
+ * @return  @c true if all ranges were read completely, else @c false.
+ *          
+ * On Linux, this issues one `process_vm_readv` call per 1024 ranges.
+ */
+inline bool readProcessMemoryBatch(ProcessHandle process, const IoRange* ranges, std::size_t count)
+{
+#   if defined(__linux__)
+        static const std::size_t kMaxIovecs = IOV_MAX < 1024 ? IOV_MAX : 1024;
+        iovec local [kMaxIovecs];
+        iovec remote[kMaxIovecs];
+        while (count)
+        {
+            const std::size_t n = count < kMaxIovecs ? count : kMaxIovecs;
+            std::size_t expected = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                local [i] = {ranges[i].buffer, ranges[i].size};
+                remote[i] = {reinterpret_cast<void*>(ranges[i].address), ranges[i].size};
+                expected += ranges[i].size;
+            }
+
+            auto read = process_vm_readv(process, local, n, remote, n, 0);
+            if (read < 0 || static_cast<std::size_t>(read) != expected) return false;
 
+            ranges += n;
+            count  -= n;
+        }
+        return true;
+#   else
+        // No vectored API available, fall back to one call per range.
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (readProcessMemory(process, ranges[i].address, ranges[i].buffer, ranges[i].size) 
+                    != ranges[i].size)
+            {
+                return false;
+            }
+        }
+        return true;
+#   endif
 }
+
+/**
+ * @brief   Writes memory of another process.
+ * @param   process The process to write to.
+ * @param   address The address to write to, in the address space of @c process.
+ * @param   in      The data to write.
+ * @param   size    The number of bytes to write.
+ * @return  The number of bytes written.
+ */
+inline std::size_t writeProcessMemory(
+    ProcessHandle process, uintptr_t address, const void* in, std::size_t size)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        SIZE_T written = 0;
+        WriteProcessMemory(process, reinterpret_cast<LPVOID>(address), in, size, &written);
+        return written;
+#   elif defined(__linux__)
+        iovec local {const_cast<void*>(in), size};
+        iovec remote{reinterpret_cast<void*>(address), size};
+        auto written = process_vm_writev(process, &local, 1, &remote, 1, 0);
+        return written < 0 ? 0 : static_cast<std::size_t>(written);
+#   else
+        // Unsupported, `openProcess` never hands out handles here.
+        (void)process; (void)address; (void)in; (void)size;
+        return 0;
+#   endif
+}
+
+/**
+ * @brief   Writes multiple ranges of memory of another process.
+ * @param   process The process to write to.
+ * @param   ranges  The ranges to write, in this order.
+ * @param   count   The number of ranges.
+ * @return  @c true if all ranges were written completely, else @c false.
+ *          
+ * On Linux, this issues one `process_vm_writev` call per 1024 ranges.
+ */
+inline bool writeProcessMemoryBatch(
+    ProcessHandle process, const IoRange* ranges, std::size_t count)
+{
+#   if defined(__linux__)
+        static const std::size_t kMaxIovecs = IOV_MAX < 1024 ? IOV_MAX : 1024;
+        iovec local [kMaxIovecs];
+        iovec remote[kMaxIovecs];
+        while (count)
+        {
+            const std::size_t n = count < kMaxIovecs ? count : kMaxIovecs;
+            std::size_t expected = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                local [i] = {ranges[i].buffer, ranges[i].size};
+                remote[i] = {reinterpret_cast<void*>(ranges[i].address), ranges[i].size};
+                expected += ranges[i].size;
+            }
+
+            auto written = process_vm_writev(process, local, n, remote, n, 0);
+            if (written < 0 || static_cast<std::size_t>(written) != expected) return false;
+
+            ranges += n;
+            count  -= n;
+        }
+        return true;
+#   else
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (writeProcessMemory(process, ranges[i].address, ranges[i].buffer, ranges[i].size) 
+                    != ranges[i].size)
+            {
+                return false;
+            }
+        }
+        return true;
+#   endif
+}
+
+#if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+/**
+ * @brief   Runs a function in another process on a new thread and waits for it to return.
+ * @param   pid         The ID of the process.
+ * @param   entry       The function to run, in the address space of the process, taking a single
+ *                      pointer-sized argument.
+ * @param   argument    The argument passed to @c entry.
+ * @return  @c true if the thread was created and returned, else @c false.
+ *
+ * Only available on Windows (`CreateRemoteThread`). Other platforms have no API for creating
+ * threads in other processes.
+ */
+inline bool runRemoteThread(uint32_t pid, uintptr_t entry, uintptr_t argument)
+{
+    HANDLE process = OpenProcess(PROCESS_CREATE_THREAD | PROCESS_QUERY_INFORMATION 
+        | PROCESS_VM_OPERATION | PROCESS_VM_READ | PROCESS_VM_WRITE, FALSE, pid);
+    if (!process) return false;
+    HANDLE thread = CreateRemoteThread(process, nullptr, 0, 
+        reinterpret_cast<LPTHREAD_START_ROUTINE>(entry), reinterpret_cast<LPVOID>(argument),
+        0, nullptr);
+    CloseHandle(process);
+    if (!thread) return false;
+    const bool done = WaitForSingleObject(thread, INFINITE) == WAIT_OBJECT_0;
+    CloseHandle(thread);
+    return done;
+}
+#endif
+
+/**
+ * @brief   Gets a handle to our own process, usable with the other process functions.
+ * @return  The process handle, not to be closed.
+ */
+inline ProcessHandle currentProcess()
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        return GetCurrentProcess();
+#   elif defined(ZYCORE_POSIX)
+        return getpid();
+#   else
+#       error "Platform not supported"
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Dirty page tracking] + helper functions                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The size of the pages tracked by `queryDirtyPages`.
+ */
+const std::size_t kDirtyPageSize = 0x1000;
+
+#if defined(__linux__)
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Writes to `/proc/<pid>/clear_refs`.
+ */
+inline bool writeClearRefs(pid_t process, const char* value)
+{
+    const auto path = "/proc/" + std::to_string(process) + "/clear_refs";
+    int fd = open(path.c_str(), O_WRONLY);
+    if (fd < 0) return false;
+    const auto length = static_cast<ssize_t>(std::strlen(value));
+    const bool done = write(fd, value, static_cast<std::size_t>(length)) == length;
+    close(fd);
+    return done;
+}
+
+/**
+ * @internal
+ * @brief   Reads the soft-dirty bits of a range of pages from `/proc/<pid>/pagemap`.
+ * @param   dirty   Invoked with the address of every dirty page.
+ */
+template<typename FuncT>
+inline bool readSoftDirtyBits(pid_t process, uintptr_t first, std::size_t numPages, 
+    const FuncT& dirty)
+{
+    const auto path = "/proc/" + std::to_string(process) + "/pagemap";
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    const uint64_t kSoftDirty = uint64_t{1} << 55;
+    uint64_t entries[512];
+    bool success = true;
+    for (std::size_t done = 0; done < numPages && success;)
+    {
+        const std::size_t count = std::min<std::size_t>(512, numPages - done);
+        const auto offset = static_cast<off_t>((first / kDirtyPageSize + done) * sizeof(uint64_t));
+        const auto bytes = static_cast<ssize_t>(count * sizeof(uint64_t));
+        success = pread(fd, entries, static_cast<std::size_t>(bytes), offset) == bytes;
+        for (std::size_t i = 0; success && i < count; ++i)
+        {
+            if (entries[i] & kSoftDirty) dirty(first + (done + i) * kDirtyPageSize);
+        }
+        done += count;
+    }
+    close(fd);
+    return success;
+}
+
+/**
+ * @internal
+ * @brief   Determines whether the kernel tracks soft-dirty bits, probed once on a page of ours.
+ *
+ * Without `CONFIG_MEM_SOFT_DIRTY`, the bits read as clear and changes would go unnoticed.
+ */
+inline bool softDirtySupported()
+{
+    static const bool supported = []
+    {
+        auto page = static_cast<volatile uint8_t*>(mmap(nullptr, kDirtyPageSize, 
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (page == MAP_FAILED) return false;
+        page[0] = 1;
+
+        bool dirty = false;
+        const auto address = reinterpret_cast<uintptr_t>(page);
+        const bool result = writeClearRefs(getpid(), "4") 
+            && (page[0] = 2, readSoftDirtyBits(getpid(), address, 1, [&](uintptr_t) 
+            { 
+                dirty = true; 
+            }))
+            && dirty;
+        munmap(const_cast<uint8_t*>(page), kDirtyPageSize);
+        return result;
+    }();
+    return supported;
+}
+
+} // namespace internal
+
+#endif // defined(__linux__)
+
+/**
+ * @brief   Starts tracking writes to a range of memory of a process anew.
+ * @param   process The process.
+ * @param   address The start of the range.
+ * @param   size    The size of the range, in bytes.
+ * @return  @c true if writes are tracked from now on, else @c false.
+ *
+ * On Linux, this clears the soft-dirty bits of all pages of the process (`clear_refs`), which
+ * requires a kernel built with `CONFIG_MEM_SOFT_DIRTY`. On Windows, only memory of our own 
+ * process allocated with `MEM_WRITE_WATCH` can be tracked (`ResetWriteWatch`).
+ */
+inline bool resetDirtyPages(ProcessHandle process, uintptr_t address, std::size_t size)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        if (GetProcessId(process) != GetCurrentProcessId()) return false;
+        return ResetWriteWatch(reinterpret_cast<LPVOID>(address), size) == 0;
+#   elif defined(__linux__)
+        (void)address; (void)size;
+        return internal::softDirtySupported() && internal::writeClearRefs(process, "4");
+#   else
+        (void)process; (void)address; (void)size;
+        return false;
+#   endif
+}
+
+/**
+ * @brief   Determines the pages written to since the last `resetDirtyPages`.
+ * @param   process The process.
+ * @param   address The start of the range, page aligned.
+ * @param   size    The size of the range, in bytes.
+ * @param   pages   Receives the addresses of the written pages, in ascending order.
+ * @return  @c true on success, @c false if writes aren't tracked.
+ *
+ * Pages may be reported dirty without having changed, but no written page is missed.
+ */
+inline bool queryDirtyPages(ProcessHandle process, uintptr_t address, std::size_t size,
+    std::vector<uintptr_t>& pages)
+{
+    pages.clear();
+    const std::size_t numPages = (size + kDirtyPageSize - 1) / kDirtyPageSize;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        if (GetProcessId(process) != GetCurrentProcessId()) return false;
+        std::vector<PVOID> addresses(numPages);
+        ULONG_PTR count = addresses.size();
+        ULONG granularity;
+        if (GetWriteWatch(0, reinterpret_cast<PVOID>(address), size, addresses.data(), &count,
+            &granularity) != 0 || granularity != kDirtyPageSize)
+        {
+            return false;
+        }
+        for (ULONG_PTR i = 0; i < count; ++i)
+        {
+            pages.push_back(reinterpret_cast<uintptr_t>(addresses[i]));
+        }
+        return true;
+#   elif defined(__linux__)
+        if (!internal::softDirtySupported()) return false;
+        return internal::readSoftDirtyBits(process, address, numPages, 
+            [&](uintptr_t page) { pages.push_back(page); });
+#   else
+        (void)process; (void)address; (void)numPages;
+        return false;
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Code memory] + helper functions                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Obtains the granularity of code allocations.
+ * @return  The allocation granularity, in bytes.
+ */
+inline std::size_t codeAllocationGranularity()
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#   elif defined(ZYCORE_POSIX)
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#   else
+#       error "Platform not supported"
+#   endif
+}
+
+/**
+ * @brief   Allocates readable, writable and executable memory anywhere.
+ * @param   size    The size of the allocation, in bytes.
+ * @return  The allocation or @c nullptr on failure.
+ *          
+ * Release the allocation with `freeCode`.
+ */
+inline void* allocateCode(std::size_t size)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+#   elif defined(ZYCORE_POSIX)
+        auto result = mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, 
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return result == MAP_FAILED ? nullptr : result;
+#   else
+#       error "Platform not supported"
+#   endif
+}
+
+/**
+ * @brief   Allocates readable, writable and executable memory close to an address.
+ * @param   address     The address the memory should be close to.
+ * @param   size        The size of the allocation, in bytes.
+ * @param   maxDistance The maximum distance of any byte of the allocation from @c address.
+ * @return  The allocation or @c nullptr if no free memory was found within @c maxDistance.
+ *          
+ * Used for trampolines reachable from @c address with 32 bit relative branches. Release the 
+ * allocation with `freeCode`.
+ */
+inline void* allocateCodeNear(uintptr_t address, std::size_t size, uintptr_t maxDistance)
+{
+    const uintptr_t granularity = codeAllocationGranularity();
+    size = (size + granularity - 1) & ~(granularity - 1);
+    if (size > maxDistance) return nullptr;
+
+    const uintptr_t lowest  = address > maxDistance ? address - maxDistance : granularity;
+    const uintptr_t highest = ~uintptr_t{0} - address > maxDistance 
+        ? address + maxDistance - size : ~uintptr_t{0} - size;
+    auto inRange = [&](uintptr_t p) { return p >= lowest && p <= highest; };
+
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        // Walk the address space from @c address downwards, then upwards, trying every 
+        // granularity step of free regions and skipping over allocated ones.
+        auto walk = [&](uintptr_t p, bool down) -> void*
+        {
+            MEMORY_BASIC_INFORMATION mbi;
+            while (inRange(p) && VirtualQuery(reinterpret_cast<LPCVOID>(p), &mbi, sizeof(mbi)))
+            {
+                auto next = p;
+                if (mbi.State == MEM_FREE)
+                {
+                    if (auto result = VirtualAlloc(reinterpret_cast<LPVOID>(p), size, 
+                        MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE))
+                    {
+                        return result;
+                    }
+                    next = down ? p - granularity : p + granularity;
+                }
+                else if (down)
+                {
+                    auto regionBase = reinterpret_cast<uintptr_t>(mbi.AllocationBase);
+                    next = (regionBase - granularity) & ~(granularity - 1);
+                }
+                else
+                {
+                    auto regionEnd = reinterpret_cast<uintptr_t>(mbi.BaseAddress) + mbi.RegionSize;
+                    next = (regionEnd + granularity - 1) & ~(granularity - 1);
+                }
+                if (down ? next >= p : next <= p) break;
+                p = next;
+            }
+            return nullptr;
+        };
+
+        const uintptr_t base = address & ~(granularity - 1);
+        if (auto result = walk(base, true)) return result;
+        if (auto result = walk(base + granularity, false)) return result;
+        return nullptr;
+#   elif defined(ZYCORE_POSIX)
+        auto tryAlloc = [&](uintptr_t p) -> void*
+        {
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#           if defined(MAP_FIXED_NOREPLACE)
+                flags |= MAP_FIXED_NOREPLACE;
+#           endif
+            auto result = mmap(reinterpret_cast<void*>(p), size, 
+                PROT_READ | PROT_WRITE | PROT_EXEC, flags, -1, 0);
+            if (result == MAP_FAILED) return nullptr;
+            // Without MAP_FIXED_NOREPLACE, the address is just a hint the kernel may ignore.
+            if (inRange(reinterpret_cast<uintptr_t>(result))) return result;
+            munmap(result, size);
+            return nullptr;
+        };
+
+        // The kernel takes the hint whenever that range is free, so probe in steps of 16 MiB 
+        // alternating below and above @c address.
+        const uintptr_t step = uintptr_t{1} << 24;
+        const uintptr_t base = address & ~(granularity - 1);
+        for (uintptr_t distance = 0;; distance += step)
+        {
+            if (base >= distance && inRange(base - distance))
+            {
+                if (auto result = tryAlloc(base - distance)) return result;
+            }
+            if (distance && UINTPTR_MAX - base >= distance && inRange(base + distance))
+            {
+                if (auto result = tryAlloc(base + distance)) return result;
+            }
+            if (maxDistance - distance < step) break;
+        }
+        return nullptr;
+#   else
+#       error "Platform not supported"
+#   endif
+}
+
+/**
+ * @brief   Releases memory allocated with `allocateCode` or `allocateCodeNear`.
+ * @param   code    The allocation.
+ * @param   size    The size passed to the allocating function.
+ */
+inline void freeCode(void* code, std::size_t size)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        (void)size;
+        VirtualFree(code, 0, MEM_RELEASE);
+#   elif defined(ZYCORE_POSIX)
+        const uintptr_t granularity = codeAllocationGranularity();
+        munmap(code, (size + granularity - 1) & ~(granularity - 1));
+#   endif
+}
+
+/**
+ * @brief   Changes whether existing code may be written to.
+ * @param   address     The first byte of the code.
+ * @param   size        The size of the code, in bytes.
+ * @param   writable    If @c true, the code is made writable, otherwise it is made read-only.
+ * @return  @c true if the protection was changed, else @c false.
+ *          
+ * The code stays executable in both cases, all pages overlapping the range are changed.
+ */
+inline bool protectCode(void* address, std::size_t size, bool writable)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        DWORD oldProtection;
+        return VirtualProtect(address, size, 
+            writable ? PAGE_EXECUTE_READWRITE : PAGE_EXECUTE_READ, &oldProtection) != FALSE;
+#   elif defined(ZYCORE_POSIX)
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto first = reinterpret_cast<uintptr_t>(address) & ~(pageSize - 1);
+        const auto last  = reinterpret_cast<uintptr_t>(address) + size;
+        return mprotect(reinterpret_cast<void*>(first), last - first, 
+            PROT_READ | PROT_EXEC | (writable ? PROT_WRITE : 0)) == 0;
+#   else
+#       error "Platform not supported"
+#   endif
+}
+
+/**
+ * @brief   Makes sure modified code is seen by the processor.
+ * @param   address The first modified byte.
+ * @param   size    The number of modified bytes.
+ */
+inline void flushCode(void* address, std::size_t size)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        FlushInstructionCache(GetCurrentProcess(), address, size);
+#   elif defined(ZYCORE_GNUC)
+        auto first = static_cast<char*>(address);
+        __builtin___clear_cache(first, first + size);
+#   else
+        (void)address;
+        (void)size;
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Thread helper functions]                                                                      //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Obtains the ID of the calling thread, as shown by debuggers and system tools.
+ * @return  The thread ID.
+ */
+inline uint32_t currentThreadId()
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        return GetCurrentThreadId();
+#   elif defined(__linux__)
+        return static_cast<uint32_t>(syscall(SYS_gettid));
+#   elif defined(__APPLE__)
+        uint64_t id = 0;
+        pthread_threadid_np(nullptr, &id);
+        return static_cast<uint32_t>(id);
+#   else
+        return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [SuspendedThreads]                                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+#if defined(__linux__)
+
+#   if !defined(REMODEL_SUSPEND_SIGNAL)
+        /**
+         * @brief   The real-time signal used to suspend threads on Linux.
+         */
+#       define REMODEL_SUSPEND_SIGNAL (SIGRTMIN + 7)
+#   endif
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   A thread waiting in `suspendHandler`.
+ */
+struct SuspendSlot
+{
+    std::atomic<bool> ready{false};
+    void* context = nullptr;
+};
+
+/**
+ * @internal
+ * @brief   State shared by `SuspendedThreads` and the signal handler of the suspended threads.
+ */
+struct SuspendState
+{
+    std::atomic<bool> active{false};
+    std::atomic<bool> release{false};
+    std::atomic<std::size_t> arrived{0};
+    std::atomic<std::size_t> departed{0};
+    std::unique_ptr<SuspendSlot[]> slots;
+    std::size_t capacity = 0;
+
+    static SuspendState& global()
+    {
+        static SuspendState state;
+        return state;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Signal handler parking a thread until it's released.
+ * 
+ * Only uses atomics and system calls, so it's safe to run whatever the thread was doing.
+ */
+inline void suspendHandler(int, siginfo_t*, void* context)
+{
+    auto& state = SuspendState::global();
+    if (!state.active.load(std::memory_order_acquire)) return;
+
+    const auto index = state.arrived.fetch_add(1, std::memory_order_acq_rel);
+    if (index < state.capacity)
+    {
+        state.slots[index].context = context;
+        state.slots[index].ready.store(true, std::memory_order_release);
+    }
+    while (!state.release.load(std::memory_order_acquire)) sched_yield();
+    state.departed.fetch_add(1, std::memory_order_release);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @internal
+ * @brief   Gets the instruction pointer stored in a signal context.
+ * @param   context The context passed to the signal handler.
+ * @return  A reference to the instruction pointer.
+ */
+inline greg_t& instructionPointerOf(void* context)
+{
+    auto& mcontext = static_cast<ucontext_t*>(context)->uc_mcontext;
+#   if defined(__x86_64__)
+        return mcontext.gregs[REG_RIP];
+#   else
+        return mcontext.gregs[REG_EIP];
+#   endif
+}
+#endif
+
+/**
+ * @internal
+ * @brief   Gets the time since an unspecified point, in milliseconds.
+ * @return  The time.
+ */
+inline uint64_t monotonicMilliseconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000 + static_cast<uint64_t>(now.tv_nsec) / 1000000;
+}
+
+} // namespace internal
+
+#endif // defined(__linux__)
+
+/**
+ * @brief   Suspends all other threads of the current process for its lifetime, giving access to
+ *          their instruction pointers.
+ *          
+ * Suspended threads may hold locks (like the heap lock), so don't allocate memory or call into 
+ * libraries that might take locks while threads are suspended. Threads started during the 
+ * suspension aren't suspended.
+ *          
+ * On Windows, threads are suspended with `SuspendThread`. On Linux, they are sent
+ * `REMODEL_SUSPEND_SIGNAL` and wait in its handler; the handler stays installed afterwards, so 
+ * the signal must not be used for anything else. Only supported for x86 and x86-64 on Windows 
+ * and Linux, `isValid` returns @c false elsewhere.
+ */
+class SuspendedThreads : public zycore::NonCopyable
+{
+    bool m_valid = false;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        std::vector<HANDLE> m_threads;
+        std::vector<CONTEXT> m_contexts;
+#   elif defined(__linux__)
+        std::unique_lock<std::mutex> m_lock;
+        std::size_t m_count = 0;
+#   endif
+
+#   if defined(__linux__)
+        static std::mutex& suspensionMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+#   endif
+public:
+    /**
+     * @brief   Constructor, suspending the threads.
+     * @param   timeoutMs   On Linux, how long to wait for threads to enter the signal handler.
+     */
+    explicit SuspendedThreads(uint32_t timeoutMs = 1000)
+#   if defined(__linux__)
+        : m_lock{suspensionMutex()}
+#   endif
+    {
+#       if (defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)) \
+            && (defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64))
+            (void)timeoutMs;
+            auto snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+            if (snapshot == INVALID_HANDLE_VALUE) return;
+
+            // Collect everything requiring memory before suspending the first thread.
+            const auto pid  = GetCurrentProcessId();
+            const auto self = GetCurrentThreadId();
+            std::vector<DWORD> ids;
+            THREADENTRY32 entry;
+            entry.dwSize = sizeof(entry);
+            for (auto ok = Thread32First(snapshot, &entry); ok; ok = Thread32Next(snapshot, &entry))
+            {
+                if (entry.th32OwnerProcessID == pid && entry.th32ThreadID != self)
+                {
+                    ids.push_back(entry.th32ThreadID);
+                }
+            }
+            CloseHandle(snapshot);
+            m_threads.reserve(ids.size());
+            m_contexts.resize(ids.size());
+
+            for (auto id : ids)
+            {
+                auto thread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT 
+                    | THREAD_SET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, id);
+                if (!thread) continue; // Exited meanwhile.
+                if (SuspendThread(thread) == static_cast<DWORD>(-1))
+                {
+                    CloseHandle(thread);
+                    continue;
+                }
+
+                // Also waits for the suspension to complete.
+                auto& context = m_contexts[m_threads.size()];
+                context.ContextFlags = CONTEXT_CONTROL;
+                m_threads.push_back(thread);
+                if (!GetThreadContext(thread, &context)) return;
+            }
+            m_contexts.resize(m_threads.size());
+            m_valid = true;
+#       elif defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+            // Collect everything requiring memory before suspending the first thread.
+            std::vector<pid_t> tids;
+            const auto self = static_cast<pid_t>(syscall(SYS_gettid));
+            if (auto dir = opendir("/proc/self/task"))
+            {
+                while (auto entry = readdir(dir))
+                {
+                    auto tid = static_cast<pid_t>(atoi(entry->d_name));
+                    if (tid > 0 && tid != self) tids.push_back(tid);
+                }
+                closedir(dir);
+            }
+            else
+            {
+                return;
+            }
+
+            static std::once_flag installed;
+            std::call_once(installed, [] 
+            {
+                struct sigaction action;
+                std::memset(&action, 0, sizeof(action));
+                action.sa_sigaction = &internal::suspendHandler;
+                action.sa_flags     = SA_SIGINFO | SA_RESTART;
+                sigfillset(&action.sa_mask);
+                sigaction(REMODEL_SUSPEND_SIGNAL, &action, nullptr);
+            });
+
+            auto& state = internal::SuspendState::global();
+            state.capacity = tids.size();
+            state.slots.reset(new internal::SuspendSlot[tids.size() ? tids.size() : 1]);
+            state.arrived.store(0);
+            state.departed.store(0);
+            state.release.store(false);
+            state.active.store(true, std::memory_order_release);
+
+            std::size_t expected = 0;
+            for (auto tid : tids)
+            {
+                // Threads that exited meanwhile fail with ESRCH.
+                if (syscall(SYS_tgkill, getpid(), tid, REMODEL_SUSPEND_SIGNAL) == 0) ++expected;
+            }
+
+            const auto deadline = internal::monotonicMilliseconds() + timeoutMs;
+            auto allReady = [&]
+            {
+                if (state.arrived.load(std::memory_order_acquire) < expected) return false;
+                for (std::size_t i = 0; i < expected; ++i)
+                {
+                    if (!state.slots[i].ready.load(std::memory_order_acquire)) return false;
+                }
+                return true;
+            };
+            while (!allReady())
+            {
+                if (internal::monotonicMilliseconds() > deadline) return;
+                sched_yield();
+            }
+            m_count = expected;
+            m_valid = true;
+#       else
+            (void)timeoutMs;
+#       endif
+    }
+
+    /**
+     * @brief   Destructor, resuming the threads.
+     */
+    ~SuspendedThreads()
+    {
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            for (auto thread : m_threads)
+            {
+                ResumeThread(thread);
+                CloseHandle(thread);
+            }
+#       elif defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+            auto& state = internal::SuspendState::global();
+            if (!state.active.load()) return;
+            state.release.store(true, std::memory_order_release);
+
+            // Threads still in the handler refer to the state.
+            const auto deadline = internal::monotonicMilliseconds() + 1000;
+            while (state.departed.load(std::memory_order_acquire) 
+                < state.arrived.load(std::memory_order_acquire)
+                && internal::monotonicMilliseconds() < deadline)
+            {
+                sched_yield();
+            }
+            state.active.store(false, std::memory_order_release);
+#       endif
+    }
+
+    /**
+     * @brief   Determines whether all threads were suspended.
+     * @return  @c true if suspended, else @c false.
+     */
+    bool isValid() const { return m_valid; }
+
+    /**
+     * @brief   Gets the number of suspended threads.
+     * @return  The number of threads.
+     */
+    std::size_t size() const
+    {
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            return m_threads.size();
+#       elif defined(__linux__)
+            return m_count;
+#       else
+            return 0;
+#       endif
+    }
+
+    /**
+     * @brief   Calls a function with the instruction pointer of every suspended thread.
+     * @tparam  FuncT   The function type, `void(uintptr_t& ip)`.
+     * @param   func    The function, may change the instruction pointer. Must not allocate.
+     */
+    template<typename FuncT>
+    void forEachInstructionPointer(FuncT func)
+    {
+        if (!m_valid) return;
+#       if (defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)) \
+            && (defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64))
+            for (std::size_t i = 0; i < m_threads.size(); ++i)
+            {
+                auto& context = m_contexts[i];
+#               if defined(_M_IX86)
+                    uintptr_t ip = context.Eip;
+                    func(ip);
+                    if (ip == context.Eip) continue;
+                    context.Eip = static_cast<DWORD>(ip);
+#               else
+                    uintptr_t ip = context.Rip;
+                    func(ip);
+                    if (ip == context.Rip) continue;
+                    context.Rip = ip;
+#               endif
+                SetThreadContext(m_threads[i], &context);
+            }
+#       elif defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+            // The contexts live in the signal frames and are restored when the handler returns.
+            auto& state = internal::SuspendState::global();
+            for (std::size_t i = 0; i < size(); ++i)
+            {
+                auto& reg = internal::instructionPointerOf(state.slots[i].context);
+                auto ip = static_cast<uintptr_t>(reg);
+                func(ip);
+                reg = static_cast<greg_t>(ip);
+            }
+#       else
+            (void)func;
+#       endif
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [MappedFile] + helper functions                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A file mapped into memory.
+ */
+struct MappedFile
+{
+    /**
+     * @brief   The first byte of the mapping or @c nullptr if not mapped.
+     */
+    void* data = nullptr;
+    /**
+     * @brief   The size of the mapping, in bytes.
+     */
+    std::size_t size = 0;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        HANDLE file    = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#   endif
+};
+
+/**
+ * @brief   Maps a file into memory.
+ * @param   path    The path of the file.
+ * @return  The mapping. On failure, `data` is @c nullptr.
+ *          
+ * The file is mapped copy-on-write: the mapping can be written to, but changes are private to
+ * the mapping and never written back to the file.
+ */
+inline MappedFile mapFile(const char* path)
+{
+    MappedFile mapped;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        mapped.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mapped.file == INVALID_HANDLE_VALUE) return mapped;
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(mapped.file, &size) && size.QuadPart)
+        {
+            mapped.mapping = CreateFileMappingA(
+                mapped.file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (mapped.mapping)
+            {
+                mapped.data = MapViewOfFile(mapped.mapping, FILE_MAP_COPY, 0, 0, 0);
+                mapped.size = static_cast<std::size_t>(size.QuadPart);
+            }
+        }
+        if (!mapped.data) mapped.size = 0;
+#   elif defined(ZYCORE_POSIX)
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return mapped;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            auto data = mmap(nullptr, static_cast<std::size_t>(st.st_size), 
+                PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                mapped.data = data;
+                mapped.size = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        // The mapping keeps the file referenced.
+        close(fd);
+#   else
+#       error "Platform not supported"
+#   endif
+    return mapped;
+}
+
+/**
+ * @brief   Unmaps a file mapped with `mapFile`.
+ * @param   mapped  The mapping. Reset to the unmapped state.
+ */
+inline void unmapFile(MappedFile& mapped)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        if (mapped.data) UnmapViewOfFile(mapped.data);
+        if (mapped.mapping) CloseHandle(mapped.mapping);
+        if (mapped.file != INVALID_HANDLE_VALUE) CloseHandle(mapped.file);
+#   elif defined(ZYCORE_POSIX)
+        if (mapped.data) munmap(mapped.data, mapped.size);
+#   endif
+    mapped = MappedFile{};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [SharedMapping] + helper functions                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A named shared memory region mapped into memory.
+ */
+struct SharedMapping
+{
+    /**
+     * @brief   The first byte of the mapping or @c nullptr if not mapped.
+     */
+    void* data = nullptr;
+    /**
+     * @brief   The size of the mapping, in bytes.
+     */
+    std::size_t size = 0;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        HANDLE mapping = nullptr;
+#   endif
+};
+
+/**
+ * @brief   Creates a named shared memory region, or opens it if it already exists, and maps it.
+ * @param   name    The name of the region, starting with a slash on POSIX systems.
+ * @param   size    The size of the region, in bytes, if @c 0 an existing region is opened with
+ *                  its size.
+ * @return  The mapping. On failure, `data` is @c nullptr.
+ *          
+ * New regions are zero-filled. On POSIX systems (`shm_open`), regions persist until removed with
+ * `removeSharedMemory`, on Windows (`CreateFileMapping`), until the last mapping is closed.
+ */
+inline SharedMapping mapSharedMemory(const char* name, std::size_t size = 0)
+{
+    SharedMapping mapped;
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        if (size)
+        {
+            const auto size64 = static_cast<uint64_t>(size);
+            mapped.mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 
+                static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), name);
+        }
+        else
+        {
+            mapped.mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+        }
+        if (!mapped.mapping) return mapped;
+
+        mapped.data = MapViewOfFile(mapped.mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info;
+        if (mapped.data && VirtualQuery(mapped.data, &info, sizeof(info)))
+        {
+            mapped.size = size ? size : info.RegionSize;
+        }
+        else
+        {
+            if (mapped.data) UnmapViewOfFile(mapped.data);
+            CloseHandle(mapped.mapping);
+            mapped = SharedMapping{};
+        }
+#   elif defined(ZYCORE_POSIX)
+        int fd = shm_open(name, size ? O_RDWR | O_CREAT : O_RDWR, 0600);
+        if (fd < 0) return mapped;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 
+            && (static_cast<std::size_t>(st.st_size) >= size 
+                || ftruncate(fd, static_cast<off_t>(size)) == 0))
+        {
+            if (!size) size = static_cast<std::size_t>(st.st_size);
+            auto data = size 
+                ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            if (data != MAP_FAILED)
+            {
+                mapped.data = data;
+                mapped.size = size;
+            }
+        }
+        close(fd);
+#   else
+#       error "Platform not supported"
+#   endif
+    return mapped;
+}
+
+/**
+ * @brief   Unmaps a region mapped with `mapSharedMemory`.
+ * @param   mapped  The mapping. Reset to the unmapped state.
+ */
+inline void unmapSharedMemory(SharedMapping& mapped)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        if (mapped.data) UnmapViewOfFile(mapped.data);
+        if (mapped.mapping) CloseHandle(mapped.mapping);
+#   elif defined(ZYCORE_POSIX)
+        if (mapped.data) munmap(mapped.data, mapped.size);
+#   endif
+    mapped = SharedMapping{};
+}
+
+/**
+ * @brief   Removes the name of a shared memory region, existing mappings stay valid.
+ * @param   name    The name of the region.
+ * @return  @c true on success, else @c false.
+ *          
+ * A no-op on Windows, where regions go away with their last mapping.
+ */
+inline bool removeSharedMemory(const char* name)
+{
+#   if defined(ZYCORE_POSIX)
+        return shm_unlink(name) == 0;
+#   else
+        (void)name;
+        return true;
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Mapping] + [enumerateMappings] + [obtainWritableRegions] + [protectMemory]                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Protection flags of a `Mapping`.
+ */
+enum MappingProtection : unsigned
+{
+    kMappingReadable   = 1 << 0,
+    kMappingWritable   = 1 << 1,
+    kMappingExecutable = 1 << 2,
+};
+
+/**
+ * @brief   A mapped range of our address space.
+ */
+struct Mapping
+{
+    uintptr_t address;
+    std::size_t size;
+    /**
+     * @brief   Combination of `MappingProtection` flags.
+     */
+    unsigned protection;
+};
+
+/**
+ * @brief   Enumerates the mappings of our address space.
+ * @param   mappings    Receives the mappings, sorted by address.
+ * @return  @c true on success, else @c false.
+ *
+ * On Windows, only committed memory is reported and guard pages count as inaccessible. On Linux,
+ * `/proc/self/maps` is parsed, skipping the kernel's `[vvar]` and `[vsyscall]` pages, which
+ * can't be read reliably.
+ */
+inline bool enumerateMappings(std::vector<Mapping>& mappings)
+{
+    mappings.clear();
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        SYSTEM_INFO sysInfo;
+        GetSystemInfo(&sysInfo);
+        auto cur = reinterpret_cast<uintptr_t>(sysInfo.lpMinimumApplicationAddress);
+        const auto end = reinterpret_cast<uintptr_t>(sysInfo.lpMaximumApplicationAddress);
+
+        MEMORY_BASIC_INFORMATION info;
+        while (cur < end && VirtualQuery(reinterpret_cast<void*>(cur), &info, sizeof(info)))
+        {
+            const auto next = reinterpret_cast<uintptr_t>(info.BaseAddress) + info.RegionSize;
+            if (info.State == MEM_COMMIT && !(info.Protect & (PAGE_GUARD | PAGE_NOACCESS)))
+            {
+                const DWORD kReadable = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY
+                    | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+                const DWORD kWritable = PAGE_READWRITE | PAGE_WRITECOPY
+                    | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+                const DWORD kExecutable = PAGE_EXECUTE | PAGE_EXECUTE_READ
+                    | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+                unsigned protection = 0;
+                if (info.Protect & kReadable) protection |= kMappingReadable;
+                if (info.Protect & kWritable) protection |= kMappingWritable;
+                if (info.Protect & kExecutable) protection |= kMappingExecutable;
+                mappings.push_back({reinterpret_cast<uintptr_t>(info.BaseAddress),
+                    info.RegionSize, protection});
+            }
+            cur = next;
+        }
+        return true;
+#   elif defined(__linux__)
+        int fd = open("/proc/self/maps", O_RDONLY);
+        if (fd < 0) return false;
+
+        // Read completely first: allocating while parsing could change the maps being read.
+        std::string text;
+        char buffer[4096];
+        for (ssize_t num; (num = read(fd, buffer, sizeof(buffer))) > 0;)
+        {
+            text.append(buffer, static_cast<std::size_t>(num));
+        }
+        close(fd);
+
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            auto lineEnd = text.find('\n', pos);
+            if (lineEnd == std::string::npos) lineEnd = text.size();
+            const auto line = text.c_str() + pos;
+
+            // "begin-end perms offset dev inode path"
+            char* cur;
+            const auto begin = std::strtoull(line, &cur, 16);
+            const auto end = std::strtoull(cur + 1, &cur, 16);
+            ++cur;
+            unsigned protection = 0;
+            if (cur[0] == 'r') protection |= kMappingReadable;
+            if (cur[1] == 'w') protection |= kMappingWritable;
+            if (cur[2] == 'x') protection |= kMappingExecutable;
+
+            const auto path = text.find_last_of(' ', lineEnd);
+            const bool special = path != std::string::npos && path > pos
+                && (text.compare(path + 1, 6, "[vvar]") == 0
+                    || text.compare(path + 1, 10, "[vsyscall]") == 0);
+            if (!special && end > begin)
+            {
+                mappings.push_back({static_cast<uintptr_t>(begin),
+                    static_cast<std::size_t>(end - begin), protection});
+            }
+            pos = lineEnd + 1;
+        }
+        return true;
+#   else
+        return false;
+#   endif
+}
+
+/**
+ * @brief   Obtains the readable and writable regions of our address space, the heaps, stacks
+ *          and data sections where objects live.
+ * @param   regions Receives the regions, sorted by address.
+ * @return  @c true on success, else @c false.
+ */
+inline bool obtainWritableRegions(std::vector<MemoryRegion>& regions)
+{
+    regions.clear();
+    std::vector<Mapping> mappings;
+    if (!enumerateMappings(mappings)) return false;
+
+    const unsigned kReadWrite = kMappingReadable | kMappingWritable;
+    for (const auto& cur : mappings)
+    {
+        if ((cur.protection & kReadWrite) == kReadWrite) regions.push_back({cur.address, cur.size});
+    }
+    return true;
+}
+
+/**
+ * @brief   Determines the protection of the pages overlapping a range.
+ * @param   address     The first byte of the range.
+ * @param   size        The size of the range, in bytes.
+ * @param   protection  Receives the combination of `MappingProtection` flags shared by all pages.
+ * @return  @c true on success, @c false if part of the range isn't mapped.
+ */
+inline bool queryProtection(const void* address, std::size_t size, unsigned& protection)
+{
+    std::vector<Mapping> mappings;
+    if (!enumerateMappings(mappings)) return false;
+
+    protection = kMappingReadable | kMappingWritable | kMappingExecutable;
+    auto cur = reinterpret_cast<uintptr_t>(address);
+    const auto end = cur + (size ? size : 1);
+    auto it = std::upper_bound(mappings.begin(), mappings.end(), cur,
+        [](uintptr_t val, const Mapping& mapping) { return val < mapping.address; });
+    if (it == mappings.begin()) return false;
+    for (--it; cur < end; ++it)
+    {
+        if (it == mappings.end() || cur < it->address || cur - it->address >= it->size)
+        {
+            return false;
+        }
+        protection &= it->protection;
+        cur = it->address + it->size;
+    }
+    return true;
+}
+
+/**
+ * @brief   Changes the protection of the pages overlapping a range.
+ * @param   address     The first byte of the range.
+ * @param   size        The size of the range, in bytes.
+ * @param   protection  Combination of `MappingProtection` flags.
+ * @return  @c true if the protection was changed, else @c false.
+ */
+inline bool protectMemory(void* address, std::size_t size, unsigned protection)
+{
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+        static const DWORD kProtections[] = {
+            PAGE_NOACCESS, PAGE_READONLY, PAGE_READWRITE, PAGE_READWRITE,
+            PAGE_EXECUTE, PAGE_EXECUTE_READ, PAGE_EXECUTE_READWRITE, PAGE_EXECUTE_READWRITE,
+        };
+        DWORD oldProtection;
+        return VirtualProtect(address, size, kProtections[protection & 7], &oldProtection) 
+            != FALSE;
+#   elif defined(ZYCORE_POSIX)
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto first = reinterpret_cast<uintptr_t>(address) & ~(pageSize - 1);
+        const auto last  = reinterpret_cast<uintptr_t>(address) + size;
+        return mprotect(reinterpret_cast<void*>(first), last - first,
+            (protection & kMappingReadable ? PROT_READ : 0)
+            | (protection & kMappingWritable ? PROT_WRITE : 0)
+            | (protection & kMappingExecutable ? PROT_EXEC : 0)) == 0;
+#   else
+        (void)address;
+        (void)size;
+        (void)protection;
+        return false;
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [AddressSpaceMap]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Cached map of our address space for fast pointer validity checks.
+ *
+ * Querying the OS per pointer (`VirtualQuery`, parsing `/proc/self/maps`) costs microseconds
+ * to milliseconds. The map keeps a sorted array of mappings instead, with adjacent mappings of
+ * equal protection merged, and answers lookups with a binary search on an immutable snapshot,
+ * without locks.
+ *
+ * The OS doesn't report changes, so the map is refreshed on demand: when a lookup fails and
+ * the snapshot is older than the refresh interval, it is rebuilt and the lookup repeated. New
+ * mappings thus show up after at most one interval; memory unmapped since the last refresh is
+ * still reported as mapped until the next one (call `refresh` after known unmaps).
+ *
+ * Lookups register as readers for the duration of the binary search. Replaced snapshots are
+ * retired and freed as soon as no lookup is running, by the next refresh or by the last reader
+ * leaving, so only snapshots possibly still in use are kept.
+ */
+class AddressSpaceMap : public zycore::NonCopyable
+{
+    struct Snapshot
+    {
+        std::vector<Mapping> mappings;
+        std::chrono::steady_clock::time_point time;
+        uint64_t generation;
+    };
+
+    /**
+     * @brief   Keeps the current snapshot alive while a lookup uses it.
+     */
+    class ReadGuard : public zycore::NonCopyable
+    {
+        const AddressSpaceMap& m_map;
+    public:
+        explicit ReadGuard(const AddressSpaceMap& map)
+            : m_map{map}
+        {
+            m_map.m_readers.fetch_add(1);
+        }
+
+        ~ReadGuard()
+        {
+            if (m_map.m_readers.fetch_sub(1) == 1 && m_map.m_numRetired.load()) m_map.reclaim();
+        }
+
+        // Sequentially consistent with the counter: a refresh seeing no readers after
+        // publishing a snapshot knows that later lookups pick up the new one.
+        const Snapshot* snapshot() const { return m_map.m_current.load(); }
+    };
+
+    std::atomic<const Snapshot*> m_current{nullptr};
+    mutable std::atomic<std::size_t> m_readers{0};
+    mutable std::atomic<std::size_t> m_numRetired{0};
+    // The snapshots are owned here, guarded by the mutex.
+    std::unique_ptr<Snapshot> m_owned;
+    mutable std::vector<std::unique_ptr<Snapshot>> m_retired;
+    mutable std::mutex m_mutex;
+    uint64_t m_generation = 0;
+    std::atomic<int64_t> m_intervalUs{100000};
+
+    const Mapping* lookup(const Snapshot& snap, uintptr_t address) const
+    {
+        const auto& mappings = snap.mappings;
+        auto it = std::upper_bound(mappings.begin(), mappings.end(), address,
+            [](uintptr_t lhs, const Mapping& rhs) { return lhs < rhs.address; });
+        if (it == mappings.begin()) return nullptr;
+        --it;
+        return address - it->address < it->size ? &*it : nullptr;
+    }
+
+    bool covers(const Snapshot& snap, uintptr_t address, std::size_t size,
+        unsigned protection) const
+    {
+        const auto end = address + size;
+        if (end < address) return false;
+        for (auto cur = address;;)
+        {
+            auto mapping = lookup(snap, cur);
+            if (!mapping || (mapping->protection & protection) != protection) return false;
+            cur = mapping->address + mapping->size;
+            if (cur >= end) return true;
+        }
+    }
+
+    /**
+     * @brief   Rebuilds the map unless it has changed since @c generation or is younger than
+     *          the refresh interval.
+     * @return  @c true if the map changed, so the lookup is worth repeating, else @c false.
+     */
+    bool refreshIfOlder(uint64_t generation, std::chrono::steady_clock::time_point time)
+    {
+        const auto interval = std::chrono::microseconds{m_intervalUs.load()};
+        if (generation && std::chrono::steady_clock::now() - time < interval) return false;
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        // Another thread may have refreshed meanwhile.
+        if (m_generation != generation) return true;
+        return refreshLocked();
+    }
+
+    bool refreshLocked()
+    {
+        std::unique_ptr<Snapshot> snap{new Snapshot};
+        if (!enumerateMappings(snap->mappings)) return false;
+        snap->time = std::chrono::steady_clock::now();
+        snap->generation = ++m_generation;
+
+        auto& mappings = snap->mappings;
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < mappings.size(); ++i)
+        {
+            if (out && mappings[out - 1].address + mappings[out - 1].size == mappings[i].address
+                && mappings[out - 1].protection == mappings[i].protection)
+            {
+                mappings[out - 1].size += mappings[i].size;
+            }
+            else
+            {
+                mappings[out++] = mappings[i];
+            }
+        }
+        mappings.resize(out);
+
+        m_current.store(snap.get());
+        if (m_owned)
+        {
+            m_retired.push_back(std::move(m_owned));
+            m_numRetired.store(m_retired.size());
+        }
+        m_owned = std::move(snap);
+        reclaimLocked();
+        return true;
+    }
+
+    void reclaim() const
+    {
+        std::unique_lock<std::mutex> lock{m_mutex, std::try_to_lock};
+        // Whoever holds the lock is refreshing and reclaims on its own.
+        if (lock.owns_lock()) reclaimLocked();
+    }
+
+    void reclaimLocked() const
+    {
+        // Retired snapshots were replaced before this load, lookups starting later can't see
+        // them anymore.
+        if (m_retired.empty() || m_readers.load()) return;
+        m_retired.clear();
+        m_numRetired.store(0);
+    }
+public:
+    /**
+     * @brief   Gets the map shared by `isReadable` and `isWritable`.
+     * @return  The map.
+     */
+    static AddressSpaceMap& global()
+    {
+        // Leaked, so checks during static destruction still work.
+        static AddressSpaceMap& map = *new AddressSpaceMap;
+        return map;
+    }
+
+    /**
+     * @brief   Rebuilds the map right away.
+     * @return  @c true on success, else @c false.
+     */
+    bool refresh()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return refreshLocked();
+    }
+
+    /**
+     * @brief   Rebuilds the map if it is older than the refresh interval.
+     * @return  @c true if the map was rebuilt, else @c false.
+     */
+    bool refreshIfStale()
+    {
+        uint64_t generation = 0;
+        std::chrono::steady_clock::time_point time;
+        {
+            ReadGuard guard{*this};
+            if (auto snap = guard.snapshot())
+            {
+                generation = snap->generation;
+                time = snap->time;
+            }
+        }
+        return refreshIfOlder(generation, time);
+    }
+
+    /**
+     * @brief   Sets the minimum age of the map before a failed lookup refreshes it.
+     * @param   interval    The interval, 0 to refresh on every failed lookup.
+     */
+    void setRefreshInterval(std::chrono::microseconds interval)
+    {
+        m_intervalUs.store(interval.count());
+    }
+
+    /**
+     * @brief   Gets the minimum age of the map before a failed lookup refreshes it.
+     * @return  The interval.
+     */
+    std::chrono::microseconds refreshInterval() const
+    {
+        return std::chrono::microseconds{m_intervalUs.load()};
+    }
+
+    /**
+     * @brief   Determines whether a range is mapped with the given protection.
+     * @param   address     The start of the range.
+     * @param   size        The size of the range, in bytes.
+     * @param   protection  Combination of required `MappingProtection` flags.
+     * @return  @c true if the range is accessible, else @c false.
+     */
+    bool check(uintptr_t address, std::size_t size, unsigned protection)
+    {
+        uint64_t generation = 0;
+        std::chrono::steady_clock::time_point time;
+        {
+            ReadGuard guard{*this};
+            auto snap = guard.snapshot();
+            if (snap && covers(*snap, address, size, protection)) return true;
+            if (snap)
+            {
+                generation = snap->generation;
+                time = snap->time;
+            }
+        }
+        // Outside of the guard, so the refresh can free the snapshot right away.
+        if (!refreshIfOlder(generation, time)) return false;
+
+        ReadGuard guard{*this};
+        auto snap = guard.snapshot();
+        return snap && covers(*snap, address, size, protection);
+    }
+
+    /**
+     * @brief   Gets the mapping containing an address, without refreshing.
+     * @param   address The address.
+     * @param   mapping Receives the mapping (merged with adjacent ones of equal protection).
+     * @return  @c true if the address is mapped, else @c false.
+     */
+    bool find(uintptr_t address, Mapping& mapping) const
+    {
+        ReadGuard guard{*this};
+        auto snap = guard.snapshot();
+        auto found = snap ? lookup(*snap, address) : nullptr;
+        if (found) mapping = *found;
+        return found != nullptr;
+    }
+
+    /**
+     * @brief   Gets the number of (merged) mappings.
+     * @return  The number of mappings.
+     */
+    std::size_t size() const
+    {
+        ReadGuard guard{*this};
+        auto snap = guard.snapshot();
+        return snap ? snap->mappings.size() : 0;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [safeRead]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+#   if defined(ZYCORE_POSIX)
+
+/**
+ * @internal
+ * @brief   Gets the jump buffer of the `safeRead` running on this thread, if any.
+ * @return  The desired buffer pointer.
+ */
+inline sigjmp_buf*& safeReadGuard()
+{
+    static REMODEL_THREAD_LOCAL sigjmp_buf* guard = nullptr;
+    return guard;
+}
+
+/**
+ * @internal
+ * @brief   The actions that were installed before ours, chained to for faults outside of
+ *          `safeRead`.
+ */
+struct PreviousFaultActions
+{
+    struct sigaction segv;
+    struct sigaction bus;
+
+    static PreviousFaultActions& global()
+    {
+        static PreviousFaultActions actions;
+        return actions;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Handler for `SIGSEGV` and `SIGBUS` jumping back into a faulting `safeRead`.
+ */
+inline void safeReadHandler(int sig, siginfo_t* info, void* context)
+{
+    if (auto guard = safeReadGuard())
+    {
+        safeReadGuard() = nullptr;
+        siglongjmp(*guard, 1);
+    }
+
+    // Not ours: hand the fault to whoever was there before. Default actions are restored and
+    // the faulting instruction re-executed, terminating the process as it would have without us.
+    auto& previous = sig == SIGBUS
+        ? PreviousFaultActions::global().bus : PreviousFaultActions::global().segv;
+    if (previous.sa_flags & SA_SIGINFO)
+    {
+        previous.sa_sigaction(sig, info, context);
+    }
+    else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN)
+    {
+        previous.sa_handler(sig);
+    }
+    else
+    {
+        signal(sig, SIG_DFL);
+    }
+}
+
+/**
+ * @internal
+ * @brief   Installs `safeReadHandler`, once.
+ */
+inline void installSafeReadHandler()
+{
+    static std::once_flag installed;
+    std::call_once(installed, []
+    {
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_sigaction = &safeReadHandler;
+        // Jumping out of the handler doesn't restore the signal mask, so don't block ours.
+        action.sa_flags     = SA_SIGINFO | SA_NODEFER | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        auto& previous = PreviousFaultActions::global();
+        sigaction(SIGSEGV, &action, &previous.segv);
+        sigaction(SIGBUS, &action, &previous.bus);
+    });
+}
+
+#   elif defined(ZYCORE_MSVC)
+
+/**
+ * @internal
+ * @brief   Copies memory, catching access violations with SEH.
+ * @return  @c true on success, @c false if the copy faulted.
+ *
+ * Kept separate since functions using `__try` can't have objects requiring unwinding.
+ */
+inline bool sehCopy(void* dst, const void* src, std::size_t size)
+{
+    __try
+    {
+        std::memcpy(dst, src, size);
+        return true;
+    }
+    __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
+        ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return false;
+    }
+}
+
+#   endif
+
+} // namespace internal
+
+/**
+ * @brief   Copies memory of our own process that may not be mapped, without crashing.
+ * @param   dst     The destination buffer.
+ * @param   src     The memory to read.
+ * @param   size    The number of bytes to read.
+ * @return  @c true on success, @c false if (part of) the memory isn't readable.
+ *
+ * Ranges `AddressSpaceMap::global()` knows to be readable are copied with a plain `memcpy`
+ * guarded by `sigsetjmp` (POSIX) or SEH (MSVC), costing a few nanoseconds on top of the map
+ * lookup. Ranges missing from the map (unmapped, or mapped since its last refresh) are read with
+ * `process_vm_readv` on ourselves on Linux, which fails without faulting, elsewhere with the
+ * guarded copy. Only reads that actually fault, e.g. of memory unmapped since the last refresh,
+ * take the slow path through the fault handler, which then also refreshes the map once it is
+ * older than its refresh interval.
+ *
+ * On POSIX systems, handlers for `SIGSEGV` and `SIGBUS` are installed on first use, chaining
+ * to previously installed ones for faults outside of `safeRead`. Handlers installed later must
+ * chain to ours in turn.
+ */
+inline bool safeRead(void* dst, const void* src, std::size_t size)
+{
+    if (!size) return true;
+    auto& map = AddressSpaceMap::global();
+#   if defined(__linux__)
+    if (!map.check(reinterpret_cast<uintptr_t>(src), size, kMappingReadable))
+    {
+        iovec local{dst, size};
+        iovec remote{const_cast<void*>(src), size};
+        const auto read = process_vm_readv(getpid(), &local, 1, &remote, 1, 0);
+        if (read == static_cast<ssize_t>(size)) return true;
+        // Unavailable (e.g. filtered by seccomp) rather than failed, try the guarded copy.
+        if (read >= 0 || errno == EFAULT) return false;
+    }
+#   endif
+
+#   if defined(ZYCORE_POSIX)
+    internal::installSafeReadHandler();
+    sigjmp_buf env;
+    if (sigsetjmp(env, 0))
+    {
+        // Rate limited, faulting in a loop mustn't rebuild the map on every read.
+        map.refreshIfStale();
+        return false;
+    }
+    internal::safeReadGuard() = &env;
+    std::memcpy(dst, src, size);
+    internal::safeReadGuard() = nullptr;
+    return true;
+#   elif defined(ZYCORE_MSVC)
+    if (internal::sehCopy(dst, src, size)) return true;
+    map.refreshIfStale();
+    return false;
+#   elif defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+    SIZE_T read = 0;
+    return ReadProcessMemory(GetCurrentProcess(), src, dst, size, &read) && read == size;
+#   else
+    std::memcpy(dst, src, size);
+    return true;
+#   endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace platform
+
+// ---------------------------------------------------------------------------------------------- //
+// [isReadable] + [isWritable]                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Determines whether memory can be read, e.g. before following an untrusted pointer.
+ * @param   ptr     The start of the memory.
+ * @param   size    The size of the memory, in bytes.
+ * @return  @c true if readable, else @c false.
+ *
+ * Looks the range up in `platform::AddressSpaceMap::global()`, so the answer can lag behind
+ * recent unmaps by up to the refresh interval of the map.
+ */
+inline bool isReadable(const void* ptr, std::size_t size = 1)
+{
+    return platform::AddressSpaceMap::global().check(
+        reinterpret_cast<uintptr_t>(ptr), size, platform::kMappingReadable);
+}
+
+/**
+ * @brief   Determines whether memory can be written.
+ * @copydetails isReadable
+ */
+inline bool isWritable(const void* ptr, std::size_t size = 1)
+{
+    return platform::AddressSpaceMap::global().check(reinterpret_cast<uintptr_t>(ptr), size,
+        platform::kMappingReadable | platform::kMappingWritable);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
 } // namespace remodel
 
 #endif // REMODEL_PLATFORM_HPP
@@ -0,0 +1,549 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_POOL_HPP
+#define REMODEL_POOL_HPP
+
+/**     
+ * @file
+ * @brief Contains a slab allocator for instances of wrapped objects and a per-thread arena for
+ *        temporaries passed to target functions.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Platform.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [InstantiablePool]                                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Slab allocator for `Instantiable`s of an advanced wrapper.
+ * @tparam  WrapperT    The wrapper type, derived from `AdvancedClassWrapper`.
+ *          
+ * Instances are placed in cache line aligned slots of large slabs instead of separate heap 
+ * allocations. Each thread keeps its own list of free slots and only takes the pool's lock to 
+ * exchange batches of slots with it, so creating and destroying instances is usually just a few 
+ * pointer operations. The wrapper's `construct` and `destruct` routines run as with any other 
+ * `Instantiable`, and `weakPtr` stays valid until the instance is destroyed.
+ * @code
+ *     InstantiablePool<Cat> cats;
+ *     for (auto i = 0; i < 1000000; ++i)
+ *     {
+ *         auto cat = cats.create(3, Cat::Male, nullptr);
+ *         feed(cat->weakPtr());
+ *         cats.destroy(cat);
+ *     }
+ * @endcode
+ */
+template<typename WrapperT>
+class InstantiablePool : public zycore::NonCopyable
+{
+public:
+    using Instantiable = typename WrapperT::Instantiable;
+
+    /**
+     * @brief   The alignment of the slots, in bytes: a cache line or the object's alignment.
+     */
+    static const std::size_t kSlotAlignment = WrapperT::kObjAlign > 64 ? WrapperT::kObjAlign : 64;
+
+    /**
+     * @brief   The size of a slot, in bytes: the instance and a flag marking it as live.
+     */
+    static const std::size_t kSlotSize = 
+        (sizeof(Instantiable) + 1 + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+private:
+    static const std::size_t kBatchSize = 32;
+
+    struct FreeSlot
+    {
+        FreeSlot* next;
+    };
+
+    struct ThreadCache
+    {
+        uint32_t threadId;
+        FreeSlot* free;
+        std::size_t size;
+    };
+
+    uint64_t m_id;
+    std::size_t m_slotsPerSlab;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<uint8_t[]>> m_memory;
+    std::vector<uint8_t*> m_slabs;
+    std::size_t m_numUsedSlabs = 0;
+    std::size_t m_numCarved = 0;
+    FreeSlot* m_free = nullptr;
+    std::vector<std::unique_ptr<ThreadCache>> m_caches;
+
+    static uint64_t nextId()
+    {
+        static std::atomic<uint64_t> lastId{0};
+        return ++lastId;
+    }
+
+    static bool& liveFlag(void* slot)
+    {
+        return *reinterpret_cast<bool*>(static_cast<uint8_t*>(slot) + sizeof(Instantiable));
+    }
+
+    ThreadCache& registerThread()
+    {
+        // Caches of exited threads are reused by new threads with the same ID.
+        const auto threadId = platform::currentThreadId();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (const auto& cache : m_caches)
+        {
+            if (cache->threadId == threadId) return *cache;
+        }
+        m_caches.emplace_back(new ThreadCache{threadId, nullptr, 0});
+        return *m_caches.back();
+    }
+
+    ThreadCache& cache()
+    {
+        // Cached per thread, for the pool used last. Pools are told apart by ID rather than 
+        // address, as a new pool may reuse the address of a destroyed one.
+        static REMODEL_THREAD_LOCAL uint64_t cachedPool = 0;
+        static REMODEL_THREAD_LOCAL ThreadCache* cachedCache = nullptr;
+        if (cachedPool != m_id)
+        {
+            cachedCache = &registerThread();
+            cachedPool  = m_id;
+        }
+        return *cachedCache;
+    }
+
+    void push(ThreadCache& cache, void* slot)
+    {
+        auto freeSlot = static_cast<FreeSlot*>(slot);
+        freeSlot->next = cache.free;
+        cache.free = freeSlot;
+        ++cache.size;
+    }
+
+    void refill(ThreadCache& cache)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (std::size_t i = 0; i < kBatchSize && m_free; ++i)
+        {
+            auto slot = m_free;
+            m_free = slot->next;
+            push(cache, slot);
+        }
+        if (cache.free) return;
+
+        // Nothing to recycle, carve a batch from the current slab, moving on to the next one 
+        // (allocating it if required) once it is used up.
+        for (std::size_t i = 0; i < kBatchSize; ++i)
+        {
+            if (!m_numUsedSlabs || m_numCarved == m_slotsPerSlab)
+            {
+                if (m_numUsedSlabs == m_slabs.size())
+                {
+                    const std::size_t alignment = kSlotAlignment;
+                    m_memory.emplace_back(new uint8_t[m_slotsPerSlab * kSlotSize + alignment]);
+                    const auto raw = reinterpret_cast<uintptr_t>(m_memory.back().get());
+                    m_slabs.push_back(reinterpret_cast<uint8_t*>(
+                        (raw + alignment - 1) & ~(alignment - 1)));
+                }
+                ++m_numUsedSlabs;
+                m_numCarved = 0;
+            }
+            auto slot = m_slabs[m_numUsedSlabs - 1] + m_numCarved++ * kSlotSize;
+            liveFlag(slot) = false;
+            push(cache, slot);
+        }
+    }
+
+    void spill(ThreadCache& cache)
+    {
+        auto first = cache.free;
+        auto last = first;
+        for (std::size_t i = 1; i < kBatchSize; ++i) last = last->next;
+        cache.free = last->next;
+        cache.size -= kBatchSize;
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        last->next = m_free;
+        m_free = first;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   slotsPerSlab    The number of instances per slab.
+     */
+    explicit InstantiablePool(std::size_t slotsPerSlab = 64 * 1024 / kSlotSize + 1)
+        : m_id{nextId()}
+        , m_slotsPerSlab{slotsPerSlab ? slotsPerSlab : 1}
+    {}
+
+    /**
+     * @brief   Destructor, destroying all remaining instances.
+     */
+    ~InstantiablePool() { reset(); }
+
+    /**
+     * @brief   Creates an instance.
+     * @tparam  ArgsT   Constructor argument types.
+     * @param   args    Arguments passed to the wrapper's `construct` routine.
+     * @return  The instance, owned by the pool.
+     */
+    template<typename... ArgsT>
+    Instantiable* create(ArgsT&&... args)
+    {
+        auto& threadCache = cache();
+        if (!threadCache.free) refill(threadCache);
+
+        void* slot = threadCache.free;
+        threadCache.free = threadCache.free->next;
+        --threadCache.size;
+
+        auto instance = new (slot) Instantiable(std::forward<ArgsT>(args)...);
+        liveFlag(slot) = true;
+        return instance;
+    }
+
+    /**
+     * @brief   Destroys an instance, calling the wrapper's `destruct` routine.
+     * @param   instance    The instance, created by this pool on any thread.
+     */
+    void destroy(Instantiable* instance)
+    {
+        instance->~Instantiable();
+        liveFlag(instance) = false;
+
+        auto& threadCache = cache();
+        push(threadCache, instance);
+        if (threadCache.size > 2 * kBatchSize) spill(threadCache);
+    }
+
+    /**
+     * @brief   Destroys all instances at once and recycles every slot.
+     *          
+     * The slabs are kept for further instances. Must not run concurrently with other calls on 
+     * the pool.
+     */
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (std::size_t i = 0; i < m_numUsedSlabs; ++i)
+        {
+            const auto numSlots = i + 1 == m_numUsedSlabs ? m_numCarved : m_slotsPerSlab;
+            for (std::size_t j = 0; j < numSlots; ++j)
+            {
+                auto slot = m_slabs[i] + j * kSlotSize;
+                if (!liveFlag(slot)) continue;
+                reinterpret_cast<Instantiable*>(slot)->~Instantiable();
+                liveFlag(slot) = false;
+            }
+        }
+
+        m_numUsedSlabs = 0;
+        m_numCarved = 0;
+        m_free = nullptr;
+        for (const auto& threadCache : m_caches)
+        {
+            threadCache->free = nullptr;
+            threadCache->size = 0;
+        }
+    }
+
+    /**
+     * @brief   Gets the number of slabs allocated so far.
+     * @return  The number of slabs.
+     */
+    std::size_t numSlabs() const { return m_slabs.size(); }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [CallScope]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Per-thread bump allocator backing `CallScope`s.
+ */
+class CallArena : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   The size of a chunk, in bytes, unless a larger allocation requires more.
+     */
+    static const std::size_t kChunkSize = 64 * 1024;
+
+    /**
+     * @brief   An object to destroy when the arena rewinds past it.
+     */
+    struct Cleanup
+    {
+        void (*destroy)(void* object);
+        void* object;
+        Cleanup* next;
+    };
+
+    /**
+     * @brief   A position in the arena to rewind to.
+     */
+    struct Mark
+    {
+        std::size_t chunk;
+        std::size_t offset;
+        Cleanup* cleanups;
+    };
+private:
+    uint32_t m_threadId;
+    std::vector<std::unique_ptr<uint8_t[]>> m_chunks;
+    std::vector<std::size_t> m_sizes;
+    std::size_t m_chunk = 0;
+    std::size_t m_offset = 0;
+    Cleanup* m_cleanups = nullptr;
+
+    explicit CallArena(uint32_t threadId)
+        : m_threadId{threadId}
+    {}
+public:
+    /**
+     * @brief   Gets the arena of the calling thread.
+     * @return  The arena.
+     */
+    static CallArena& current()
+    {
+        static REMODEL_THREAD_LOCAL CallArena* cached = nullptr;
+        if (cached) return *cached;
+
+        // Arenas of exited threads are reused by new threads with the same ID. Scopes can't
+        // outlive their thread, so these are always empty.
+        static std::mutex mutex;
+        static std::vector<std::unique_ptr<CallArena>> arenas;
+        const auto threadId = platform::currentThreadId();
+        std::lock_guard<std::mutex> lock{mutex};
+        for (const auto& arena : arenas)
+        {
+            if (arena->m_threadId == threadId) return *(cached = arena.get());
+        }
+        arenas.emplace_back(new CallArena{threadId});
+        return *(cached = arenas.back().get());
+    }
+
+    /**
+     * @brief   Allocates memory, valid until the arena rewinds past it.
+     * @param   size        The size, in bytes.
+     * @param   alignment   The alignment, a power of two.
+     * @return  The memory.
+     */
+    void* allocate(std::size_t size, std::size_t alignment)
+    {
+        for (;;)
+        {
+            if (m_chunk < m_chunks.size())
+            {
+                const auto base = reinterpret_cast<uintptr_t>(m_chunks[m_chunk].get());
+                const auto start = (base + m_offset + alignment - 1) & ~(alignment - 1);
+                if (start + size <= base + m_sizes[m_chunk])
+                {
+                    m_offset = start + size - base;
+                    return reinterpret_cast<void*>(start);
+                }
+
+                // Chunks of earlier scopes are kept, continue with the next one.
+                if (m_chunk + 1 < m_chunks.size())
+                {
+                    ++m_chunk;
+                    m_offset = 0;
+                    continue;
+                }
+            }
+
+            const auto chunkSize = size + alignment > kChunkSize ? size + alignment : kChunkSize;
+            m_chunks.emplace_back(new uint8_t[chunkSize]);
+            m_sizes.push_back(chunkSize);
+            m_chunk = m_chunks.size() - 1;
+            m_offset = 0;
+        }
+    }
+
+    /**
+     * @brief   Registers an object to destroy when the arena rewinds past the current position.
+     * @param   destroy The routine destroying the object.
+     * @param   object  The object.
+     */
+    void defer(void (*destroy)(void*), void* object)
+    {
+        auto cleanup = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+        *cleanup = Cleanup{destroy, object, m_cleanups};
+        m_cleanups = cleanup;
+    }
+
+    /**
+     * @brief   Gets the current position.
+     * @return  The position.
+     */
+    Mark mark() const { return Mark{m_chunk, m_offset, m_cleanups}; }
+
+    /**
+     * @brief   Destroys the objects registered after a position, in reverse order, and frees all
+     *          memory allocated after it.
+     * @param   mark    The position, obtained from `mark`.
+     */
+    void rewind(const Mark& mark)
+    {
+        while (m_cleanups != mark.cleanups)
+        {
+            auto cleanup = m_cleanups;
+            m_cleanups = cleanup->next;
+            cleanup->destroy(cleanup->object);
+        }
+        m_chunk = mark.chunk;
+        m_offset = mark.offset;
+    }
+
+    /**
+     * @brief   Gets the number of chunks allocated so far.
+     * @return  The number of chunks.
+     */
+    std::size_t numChunks() const { return m_chunks.size(); }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Scope for temporaries passed to target functions, allocated from a per-thread arena.
+ *
+ * Temporary `Instantiable`s and out-parameters of calls are bump-allocated from an arena kept by
+ * each thread instead of the heap. When the scope ends, the `destruct` routines of the
+ * temporaries run and all of the memory is reclaimed at once by resetting the arena to where the
+ * scope started. Scopes nest, the inner one reusing the memory after the outer one. A scope has
+ * to end on the thread that created it, and the memory it hands out is only valid until then.
+ * @code
+ *     {
+ *         CallScope scope;
+ *         stable.addHorse(scope.make<Horse>(3)->weakPtr());
+ *         auto numHorses = scope.out<uint32_t>();
+ *         stable.countHorses(numHorses);
+ *     } // Horse's destruct routine runs here.
+ * @endcode
+ */
+class CallScope : public zycore::NonCopyable
+{
+    internal::CallArena& m_arena;
+    internal::CallArena::Mark m_mark;
+
+    template<typename T>
+    static void destroy(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+public:
+    /**
+     * @brief   Constructor, opening a scope on the calling thread.
+     */
+    CallScope()
+        : m_arena(internal::CallArena::current())
+        , m_mark(m_arena.mark())
+    {}
+
+    /**
+     * @brief   Destructor, destroying the temporaries and reclaiming their memory.
+     */
+    ~CallScope() { m_arena.rewind(m_mark); }
+
+    /**
+     * @brief   Creates a temporary instance of an advanced wrapper.
+     * @tparam  WrapperT    The wrapper type, derived from `AdvancedClassWrapper`.
+     * @tparam  ArgsT       Constructor argument types.
+     * @param   args        Arguments passed to the wrapper's `construct` routine.
+     * @return  The instance, destroyed when the scope ends.
+     */
+    template<typename WrapperT, typename... ArgsT>
+    typename WrapperT::Instantiable* make(ArgsT&&... args)
+    {
+        using Instantiable = typename WrapperT::Instantiable;
+        auto instance = new (m_arena.allocate(sizeof(Instantiable), alignof(Instantiable)))
+            Instantiable(std::forward<ArgsT>(args)...);
+        m_arena.defer(&destroy<Instantiable>, instance);
+        return instance;
+    }
+
+    /**
+     * @brief   Creates an out-parameter.
+     * @tparam  T       The type of the parameter, trivially destructible.
+     * @param   value   The initial value.
+     * @return  A pointer to the parameter, valid until the scope ends.
+     */
+    template<typename T>
+    T* out(const T& value = T{})
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+            "out-parameters are never destroyed, use make for wrapped objects");
+        return new (m_arena.allocate(sizeof(T), alignof(T))) T(value);
+    }
+
+    /**
+     * @brief   Creates zeroed storage for an object the target constructs, e.g. a returned
+     *          structure.
+     * @tparam  WrapperT    The wrapper type, derived from `AdvancedClassWrapper`.
+     * @return  A weak pointer to the storage, valid until the scope ends. Neither `construct` nor
+     *          `destruct` routines run for it.
+     */
+    template<typename WrapperT>
+    typename WrapperT::Weak* outObj()
+    {
+        auto data = m_arena.allocate(WrapperT::kObjSize, WrapperT::kObjAlign);
+        std::memset(data, 0, WrapperT::kObjSize);
+        return static_cast<typename WrapperT::Weak*>(data);
+    }
+
+    /**
+     * @brief   Allocates raw memory.
+     * @param   size        The size, in bytes.
+     * @param   alignment   The alignment, a power of two.
+     * @return  The memory, valid until the scope ends.
+     */
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        return m_arena.allocate(size, alignment);
+    }
+};
+
+} // namespace remodel
+
+#endif // REMODEL_POOL_HPP
@@ -0,0 +1,282 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_QUERY_HPP
+#define REMODEL_QUERY_HPP
+
+/**     
+ * @file
+ * @brief Contains column-wise filtering of arrays of objects.
+ *
+ * Predicates are formed by comparing a `FieldSpan` with a constant and combined into a `Query`,
+ * which evaluates them one column at a time into a bitmask with one bit per object:
+ * @code
+ *     WrapperRange<Entity> entities{entityArray, entityCount};
+ *     auto span = [&](auto field) { return makeFieldSpan(entities, field); };
+ *
+ *     auto weakAllies = where(span(&Entity::hp) < 10).and_(span(&Entity::team) == 2);
+ *     weakAllies.forEach(entities, [](Entity& cur) { cur.hp = 100; });
+ * @endcode
+ */
+
+#include <stdint.h>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Simd.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [SpanPredicate]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Comparison of all fields of a `FieldSpan` with a constant.
+ * @tparam  T   The type of the fields, arithmetic or an enum.
+ */
+template<typename T>
+class SpanPredicate
+{
+public:
+    using ValueType = std::remove_cv_t<T>;
+private:
+    FieldSpan<T> m_span;
+    simd::CompareOp m_op;
+    ValueType m_value;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   span    The fields to compare.
+     * @param   op      The comparison.
+     * @param   value   The constant to compare with.
+     */
+    SpanPredicate(const FieldSpan<T>& span, simd::CompareOp op, ValueType value)
+        : m_span{span}
+        , m_op{op}
+        , m_value{value}
+    {}
+
+    /**
+     * @brief   Gets the number of objects covered.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_span.size(); }
+
+    /**
+     * @brief   Evaluates the predicate for a block of up to 64 objects.
+     * @param   block   The index of the block, covering objects `[block * 64, block * 64 + 64)`.
+     * @return  The bitmask of objects satisfying the predicate.
+     *
+     * The fields are gathered into a contiguous buffer (see `simd::gatherStrided`) and compared
+     * with `simd::compareMask`.
+     */
+    uint64_t evaluate(std::size_t block) const
+    {
+        const std::size_t first = block * 64;
+        const std::size_t count = (std::min)(std::size_t{64}, m_span.size() - first);
+        ValueType values[64];
+        simd::gatherStrided(values, &m_span[first], m_span.stride(), count);
+        return simd::compareMask(values, count, m_op, m_value);
+    }
+};
+
+#define REMODEL_SPAN_PREDICATE_OPERATOR(op, compareOp)                                             \
+    template<typename T, typename = std::enable_if_t<                                             \
+        std::is_arithmetic<T>::value || std::is_enum<T>::value>>                                   \
+    inline SpanPredicate<T> operator op (const FieldSpan<T>& span, std::remove_cv_t<T> value)     \
+    {                                                                                              \
+        return {span, simd::CompareOp::compareOp, value};                                          \
+    }
+
+REMODEL_SPAN_PREDICATE_OPERATOR(< , Less        )
+REMODEL_SPAN_PREDICATE_OPERATOR(<=, LessEqual   )
+REMODEL_SPAN_PREDICATE_OPERATOR(> , Greater     )
+REMODEL_SPAN_PREDICATE_OPERATOR(>=, GreaterEqual)
+REMODEL_SPAN_PREDICATE_OPERATOR(==, Equal       )
+REMODEL_SPAN_PREDICATE_OPERATOR(!=, NotEqual    )
+
+#undef REMODEL_SPAN_PREDICATE_OPERATOR
+
+// ---------------------------------------------------------------------------------------------- //
+// [Query]                                                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Set of objects of an array matching a combination of predicates.
+ *
+ * Predicates are evaluated eagerly, one column at a time in blocks of 64 objects. Blocks already
+ * decided (no matches left for `and_`, all matching for `or_`) aren't evaluated again.
+ */
+class Query
+{
+    std::vector<uint64_t> m_words;
+    std::size_t m_size;
+public:
+    /**
+     * @brief   Constructor, evaluates the first predicate.
+     * @param   pred    The predicate.
+     */
+    template<typename T>
+    explicit Query(const SpanPredicate<T>& pred)
+        : m_words((pred.size() + 63) / 64)
+        , m_size{pred.size()}
+    {
+        for (std::size_t i = 0; i < m_words.size(); ++i) m_words[i] = pred.evaluate(i);
+    }
+
+    /**
+     * @brief   Restricts the matches to objects also satisfying another predicate.
+     * @param   pred    The predicate, over the same objects.
+     * @return  This instance.
+     */
+    template<typename T>
+    Query& and_(const SpanPredicate<T>& pred)
+    {
+        assert(pred.size() == m_size);
+        for (std::size_t i = 0; i < m_words.size(); ++i)
+        {
+            if (m_words[i]) m_words[i] &= pred.evaluate(i);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief   Extends the matches by objects satisfying another predicate.
+     * @param   pred    The predicate, over the same objects.
+     * @return  This instance.
+     */
+    template<typename T>
+    Query& or_(const SpanPredicate<T>& pred)
+    {
+        assert(pred.size() == m_size);
+        for (std::size_t i = 0; i < m_words.size(); ++i)
+        {
+            if (m_words[i] != fullWord(i)) m_words[i] |= pred.evaluate(i);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief   Determines whether an object matches.
+     * @param   idx The index of the object.
+     * @return  @c true if matching, else @c false.
+     */
+    bool matches(std::size_t idx) const
+    {
+        assert(idx < m_size);
+        return (m_words[idx / 64] >> (idx % 64)) & 1;
+    }
+
+    /**
+     * @brief   Counts the matching objects.
+     * @return  The number of matches.
+     */
+    std::size_t count() const
+    {
+        std::size_t result = 0;
+        for (auto cur : m_words)
+        {
+            for (; cur; cur &= cur - 1) ++result;
+        }
+        return result;
+    }
+
+    /**
+     * @brief   Invokes a function for the index of every matching object, in ascending order.
+     * @param   func    The function, callable as `void(std::size_t)`.
+     */
+    template<typename FuncT>
+    void forEachIndex(FuncT&& func) const
+    {
+        for (std::size_t i = 0; i < m_words.size(); ++i)
+        {
+            for (auto cur = m_words[i]; cur; cur &= cur - 1)
+            {
+                func(i * 64 + countTrailingZeros64(cur));
+            }
+        }
+    }
+
+    /**
+     * @brief   Gets the indices of all matching objects.
+     * @return  The indices, in ascending order.
+     */
+    std::vector<std::size_t> indices() const
+    {
+        std::vector<std::size_t> result;
+        result.reserve(count());
+        forEachIndex([&](std::size_t idx) { result.push_back(idx); });
+        return result;
+    }
+
+    /**
+     * @brief   Invokes a function for every matching object, using a single rebound wrapper.
+     * @param   range   The objects the predicates were formed for.
+     * @param   func    The function, callable as `void(WrapperT&)`.
+     */
+    template<typename WrapperT, typename FuncT>
+    void forEach(const WrapperRange<WrapperT>& range, FuncT&& func) const
+    {
+        assert(range.size() == m_size);
+        auto wrapper = wrapper_cast<WrapperT>(range.first());
+        auto first = static_cast<uint8_t*>(range.first());
+        forEachIndex([&](std::size_t idx)
+        {
+            wrapper.rebind(first + idx * range.stride());
+            func(wrapper);
+        });
+    }
+private:
+    uint64_t fullWord(std::size_t word) const
+    {
+        const std::size_t bits = (std::min)(std::size_t{64}, m_size - word * 64);
+        return bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    }
+
+    static unsigned countTrailingZeros64(uint64_t val)
+    {
+        const auto low = static_cast<uint32_t>(val);
+        return low ? simd::countTrailingZeros(low) 
+            : 32 + simd::countTrailingZeros(static_cast<uint32_t>(val >> 32));
+    }
+};
+
+/**
+ * @brief   Creates a query from its first predicate.
+ * @param   pred    The predicate.
+ * @return  The query.
+ */
+template<typename T>
+inline Query where(const SpanPredicate<T>& pred)
+{
+    return Query{pred};
+}
+
+} // namespace remodel
+
+#endif // REMODEL_QUERY_HPP
@@ -0,0 +1,520 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_RECORDER_HPP
+#define REMODEL_RECORDER_HPP
+
+/**
+ * @file
+ * @brief Contains a columnar time-series recorder for fields of many objects.
+ *
+ * Every `sample` appends the current values of the recorded fields of all objects to one column
+ * per field. Columns are split into blocks of a fixed number of ticks, which are delta and varint
+ * encoded once complete and kept in a bounded ring, so recording can run for hours:
+ * @code
+ *     Recorder<Entity> recorder{entities, 64};         // keep the last 64 blocks per column
+ *     auto hp = recorder.record(&Entity::hp);
+ *     recorder.setSink([&](const RecorderBlock& block) { writeBlock(file, block); });
+ *
+ *     // Once per frame.
+ *     recorder.sample();
+ *
+ *     std::vector<int32_t> history;
+ *     recorder.query(hp, 42, recorder.ticks() - 600, recorder.ticks(), history);
+ * @endcode
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "Remodel.hpp"
+
+namespace remodel
+{
+namespace internal
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [Varint]                                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Appends an unsigned LEB128 encoded integer.
+ */
+inline void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @internal
+ * @brief   Reads an unsigned LEB128 encoded integer, advancing @c cur.
+ */
+inline uint64_t readVarint(const uint8_t*& cur)
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7)
+    {
+        const uint8_t byte = *cur++;
+        value |= uint64_t{byte & 0x7Fu} << shift;
+        if (!(byte & 0x80))
+        {
+            return value;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [RecorderTraits]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Converts recorded values to their raw 64 bit representation and encodes changes.
+ *
+ * Integers are sign or zero extended and stored as zigzag encoded differences to the previous
+ * tick. Floating point values are stored as the XOR of their bit patterns, which is small when
+ * sign, exponent and high mantissa bits stay the same.
+ */
+template<typename T, typename = void>
+struct RecorderTraits
+{
+    using IntT = std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>,
+        std::common_type<T>>;
+    using RawT = std::conditional_t<std::is_signed<typename IntT::type>::value, int64_t, uint64_t>;
+
+    static uint64_t toBits(T value)
+    {
+        return static_cast<uint64_t>(static_cast<RawT>(value));
+    }
+
+    static T fromBits(uint64_t bits)
+    {
+        return static_cast<T>(static_cast<typename IntT::type>(bits));
+    }
+
+    static uint64_t encode(uint64_t prev, uint64_t cur)
+    {
+        const auto delta = static_cast<int64_t>(cur - prev);
+        return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+    }
+
+    static uint64_t decode(uint64_t prev, uint64_t code)
+    {
+        return prev + ((code >> 1) ^ (0 - (code & 1)));
+    }
+};
+
+template<typename T>
+struct RecorderTraits<T, std::enable_if_t<std::is_floating_point<T>::value>>
+{
+    using BitsT = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    static_assert(sizeof(T) == sizeof(BitsT), "unsupported floating point type");
+
+    static uint64_t toBits(T value)
+    {
+        BitsT bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static T fromBits(uint64_t bits)
+    {
+        const auto narrow = static_cast<BitsT>(bits);
+        T value;
+        std::memcpy(&value, &narrow, sizeof(value));
+        return value;
+    }
+
+    static uint64_t encode(uint64_t prev, uint64_t cur) { return prev ^ cur; }
+    static uint64_t decode(uint64_t prev, uint64_t code) { return prev ^ code; }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [RecorderBlock]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A completed, encoded block of one column of a `Recorder`.
+ *
+ * The values of each object are stored consecutively, starting at `data[offsets[object]]`, as
+ * one varint per tick. Blocks don't depend on each other, the first value of every object is
+ * encoded relative to zero.
+ */
+struct RecorderBlock
+{
+    /**
+     * @brief   The index of the column, in the order of `Recorder::record` calls.
+     */
+    std::size_t column;
+    /**
+     * @brief   The tick of the first sample in the block.
+     */
+    uint64_t firstTick;
+    /**
+     * @brief   The number of samples in the block.
+     */
+    std::size_t numTicks;
+    /**
+     * @brief   The start of the values of each object in @c data, plus the end of the data.
+     */
+    std::vector<uint32_t> offsets;
+    /**
+     * @brief   The encoded values.
+     */
+    std::vector<uint8_t> data;
+
+    /**
+     * @brief   Gets the number of objects in the block.
+     * @return  The number of objects.
+     */
+    std::size_t numObjects() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [Recorder]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A column of a `Recorder`, returned by `Recorder::record`.
+ * @tparam  T   The type of the recorded values.
+ */
+template<typename T>
+struct RecorderColumn
+{
+    /**
+     * @brief   The index of the column.
+     */
+    std::size_t index;
+};
+
+/**
+ * @brief   Records fields of a fixed set of objects over time.
+ * @tparam  WrapperT    The wrapper type of the objects.
+ *
+ * Samples of the current block are kept raw, 8 bytes per object and field. Completed blocks are
+ * encoded, handed to the sink (if any) and kept until more than `maxBlocks` blocks of the column
+ * are retained, so memory is bounded by the block size times the number of blocks.
+ */
+template<typename WrapperT>
+class Recorder
+{
+public:
+    /**
+     * @brief   Receives every completed block, e.g. to write it to disk.
+     */
+    using Sink = std::function<void(const RecorderBlock& block)>;
+private:
+    struct Column
+    {
+        virtual ~Column() = default;
+
+        virtual void sample(WrapperT& wrapper, const std::vector<void*>& objects,
+            uint64_t* out) const = 0;
+
+        uint64_t (*encode)(uint64_t prev, uint64_t cur);
+        uint64_t (*decode)(uint64_t prev, uint64_t code);
+        std::vector<uint64_t> pending;
+        std::deque<RecorderBlock> blocks;
+    };
+
+    template<typename FieldPtrT>
+    struct FieldColumn : Column
+    {
+        using LoadTraitsT = internal::LoadTraitsOf<internal::FieldOf<WrapperT, FieldPtrT>>;
+        using ValueT = typename LoadTraitsT::Type;
+
+        FieldPtrT field;
+
+        void sample(WrapperT& wrapper, const std::vector<void*>& objects,
+            uint64_t* out) const override
+        {
+            for (std::size_t i = 0; i < objects.size(); ++i)
+            {
+                wrapper.rebind(objects[i]);
+                out[i] = internal::RecorderTraits<ValueT>::toBits(
+                    LoadTraitsT::load(wrapper.*field));
+            }
+        }
+    };
+
+    std::vector<void*> m_objects;
+    std::size_t m_maxBlocks;
+    std::size_t m_blockTicks;
+    std::vector<std::unique_ptr<Column>> m_columns;
+    uint64_t m_ticks = 0;
+    uint64_t m_blockStart = 0;
+    Sink m_sink;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   objects     The raw pointers of the objects to record.
+     * @param   maxBlocks   The number of completed blocks to retain per column.
+     * @param   blockTicks  The number of samples per block.
+     */
+    Recorder(std::vector<void*> objects, std::size_t maxBlocks, std::size_t blockTicks = 64)
+        : m_objects{std::move(objects)}
+        , m_maxBlocks{maxBlocks}
+        , m_blockTicks{blockTicks}
+    {
+        assert(blockTicks);
+    }
+
+    /**
+     * @brief   Constructor recording all objects of a range.
+     * @copydetails Recorder(std::vector<void*>, std::size_t, std::size_t)
+     */
+    Recorder(const WrapperRange<WrapperT>& objects, std::size_t maxBlocks,
+            std::size_t blockTicks = 64)
+        : Recorder{std::vector<void*>{}, maxBlocks, blockTicks}
+    {
+        m_objects.reserve(objects.size());
+        for (std::size_t i = 0; i < objects.size(); ++i)
+        {
+            m_objects.push_back(static_cast<uint8_t*>(objects.first()) + i * objects.stride());
+        }
+    }
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator = (const Recorder&) = delete;
+
+    /**
+     * @brief   Adds a field to record.
+     * @param   field   Pointer to the field, e.g. `&Entity::hp`. Its values must be arithmetic
+     *                  or enums, values in foreign byte order are converted.
+     * @return  The column, used to query the recorded values.
+     * @note    Columns must be added before the first `sample`.
+     */
+    template<typename FieldPtrT>
+    auto record(FieldPtrT field)
+    {
+        using ColumnT = FieldColumn<FieldPtrT>;
+        using ValueT = typename ColumnT::ValueT;
+        static_assert(std::is_arithmetic<ValueT>::value || std::is_enum<ValueT>::value,
+            "only arithmetic and enum fields can be recorded");
+        assert(!m_ticks);
+
+        std::unique_ptr<ColumnT> column{new ColumnT};
+        column->field = field;
+        column->encode = &internal::RecorderTraits<ValueT>::encode;
+        column->decode = &internal::RecorderTraits<ValueT>::decode;
+        column->pending.resize(m_blockTicks * m_objects.size());
+        m_columns.push_back(std::move(column));
+        return RecorderColumn<ValueT>{m_columns.size() - 1};
+    }
+
+    /**
+     * @brief   Sets the receiver of completed blocks.
+     * @param   sink    The sink, or an empty function.
+     */
+    void setSink(Sink sink) { m_sink = std::move(sink); }
+
+    /**
+     * @brief   Records the current values of all columns.
+     */
+    void sample()
+    {
+        const std::size_t tick = static_cast<std::size_t>(m_ticks - m_blockStart);
+        if (!m_objects.empty())
+        {
+            auto wrapper = wrapper_cast<WrapperT>(m_objects.front());
+            for (auto& column : m_columns)
+            {
+                column->sample(wrapper, m_objects, &column->pending[tick * m_objects.size()]);
+            }
+        }
+
+        if (++m_ticks - m_blockStart == m_blockTicks)
+        {
+            flush();
+        }
+    }
+
+    /**
+     * @brief   Completes the current block early, e.g. before the recording ends.
+     */
+    void flush()
+    {
+        const auto numTicks = static_cast<std::size_t>(m_ticks - m_blockStart);
+        if (!numTicks)
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i < m_columns.size(); ++i)
+        {
+            auto& column = *m_columns[i];
+            column.blocks.push_back(encodeBlock(i, numTicks));
+            if (m_sink)
+            {
+                m_sink(column.blocks.back());
+            }
+            if (column.blocks.size() > m_maxBlocks)
+            {
+                column.blocks.pop_front();
+            }
+        }
+        m_blockStart = m_ticks;
+    }
+
+    /**
+     * @brief   Reads the recorded values of an object.
+     * @param   column      The column.
+     * @param   object      The index of the object.
+     * @param   firstTick   The first tick to read.
+     * @param   endTick     The tick after the last one to read.
+     * @param   out         Receives the values, appended in tick order.
+     * @return  @c true if the whole range is retained, else @c false and @c out is unchanged.
+     *
+     * Only blocks overlapping the range are decoded, and of those only the values of @c object.
+     */
+    template<typename T>
+    bool query(RecorderColumn<T> column, std::size_t object, uint64_t firstTick,
+        uint64_t endTick, std::vector<T>& out) const
+    {
+        assert(column.index < m_columns.size() && object < m_objects.size());
+        if (firstTick > endTick || endTick > m_ticks || firstTick < firstRetainedTick())
+        {
+            return false;
+        }
+
+        const auto& col = *m_columns[column.index];
+        out.reserve(out.size() + static_cast<std::size_t>(endTick - firstTick));
+        for (const auto& block : col.blocks)
+        {
+            const uint64_t blockEnd = block.firstTick + block.numTicks;
+            if (blockEnd <= firstTick || block.firstTick >= endTick)
+            {
+                continue;
+            }
+
+            const uint8_t* cur = block.data.data() + block.offsets[object];
+            uint64_t value = 0;
+            for (uint64_t tick = block.firstTick; tick < blockEnd && tick < endTick; ++tick)
+            {
+                value = col.decode(value, internal::readVarint(cur));
+                if (tick >= firstTick)
+                {
+                    out.push_back(internal::RecorderTraits<T>::fromBits(value));
+                }
+            }
+        }
+
+        for (uint64_t tick = (std::max)(firstTick, m_blockStart); tick < endTick; ++tick)
+        {
+            const auto idx = static_cast<std::size_t>(tick - m_blockStart);
+            out.push_back(internal::RecorderTraits<T>::fromBits(
+                col.pending[idx * m_objects.size() + object]));
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Gets the number of samples taken.
+     * @return  The number of ticks.
+     */
+    uint64_t ticks() const { return m_ticks; }
+
+    /**
+     * @brief   Gets the oldest tick that can still be queried.
+     * @return  The tick.
+     */
+    uint64_t firstRetainedTick() const
+    {
+        if (m_columns.empty() || m_columns.front()->blocks.empty())
+        {
+            return m_blockStart;
+        }
+        return m_columns.front()->blocks.front().firstTick;
+    }
+
+    /**
+     * @brief   Gets the number of recorded objects.
+     * @return  The number of objects.
+     */
+    std::size_t numObjects() const { return m_objects.size(); }
+
+    /**
+     * @brief   Gets the number of bytes used by recorded samples.
+     * @return  The number of bytes.
+     */
+    std::size_t memoryUsage() const
+    {
+        std::size_t bytes = 0;
+        for (const auto& column : m_columns)
+        {
+            bytes += column->pending.size() * sizeof(uint64_t);
+            for (const auto& block : column->blocks)
+            {
+                bytes += block.data.size() + block.offsets.size() * sizeof(uint32_t);
+            }
+        }
+        return bytes;
+    }
+private:
+    RecorderBlock encodeBlock(std::size_t index, std::size_t numTicks) const
+    {
+        const auto& column = *m_columns[index];
+        const std::size_t numObjects = m_objects.size();
+
+        RecorderBlock block;
+        block.column = index;
+        block.firstTick = m_blockStart;
+        block.numTicks = numTicks;
+        block.offsets.reserve(numObjects + 1);
+        block.data.reserve(numObjects * numTicks);
+        for (std::size_t object = 0; object < numObjects; ++object)
+        {
+            block.offsets.push_back(static_cast<uint32_t>(block.data.size()));
+            uint64_t prev = 0;
+            for (std::size_t tick = 0; tick < numTicks; ++tick)
+            {
+                const uint64_t cur = column.pending[tick * numObjects + object];
+                internal::writeVarint(block.data, column.encode(prev, cur));
+                prev = cur;
+            }
+        }
+        block.offsets.push_back(static_cast<uint32_t>(block.data.size()));
+        return block;
+    }
+};
+
+} // namespace remodel
+
+#endif // REMODEL_RECORDER_HPP
@@ -0,0 +1,358 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_REMOTECALL_HPP
+#define REMODEL_REMOTECALL_HPP
+
+/**     
+ * @file
+ * @brief Contains batched invocation of functions in another process.
+ *
+ * Calling a function of another process requires running code in it, usually by creating a 
+ * remote thread, which is far more expensive than the call itself. `RemoteCallBatch` instead 
+ * writes many call records into a buffer in the target and has a single executor run all of 
+ * them, then reads the results back from the same buffer: a thousand calls cost one write, one
+ * thread and one read.
+ *
+ * The executor, `runRemoteCallBatch`, has to be present in the target, e.g. in a module injected 
+ * into it that exports a thread entry forwarding to it:
+ * @code
+ *     // Injected module
+ *     extern "C" __declspec(dllexport) DWORD WINAPI executeBatch(LPVOID buffer)
+ *     {
+ *         return remodel::runRemoteCallBatch(buffer);
+ *     }
+ *
+ *     // Tool
+ *     ProcessMemory memory{pid};
+ *     RemoteCallBatch batch{memory, bufferAddress, 1000, 
+ *         RemoteCallBatch::threadExecutor(pid, executeBatchAddress)};
+ *     for (auto dog : dogAddresses) batch.add(calculateFluffinessAddress, dog);
+ *     if (batch.run())
+ *     {
+ *         for (std::size_t i = 0; i < batch.size(); ++i) use(batch.result(i));
+ *     }
+ * @endcode
+ *
+ * `threadExecutor` is only available on Windows, since other platforms have no API for creating
+ * threads in another process. Elsewhere, the executor has to be provided by the tool, e.g. by
+ * signalling a thread of the injected module that runs `runRemoteCallBatch`.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Memory.hpp"
+#include "Platform.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [RemoteCallRecord]                                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The maximum number of arguments of remotely invoked functions.
+ */
+const std::size_t kMaxRemoteCallArgs = 6;
+
+/**
+ * @brief   Header of a call batch buffer, followed by `count` records.
+ *
+ * All members have fixed sizes, so the layout is the same for the tool and the target no matter
+ * their pointer widths.
+ */
+struct RemoteCallHeader
+{
+    uint32_t count;
+    /**
+     * @brief   The number of calls performed, written by the executor.
+     */
+    uint32_t completed;
+};
+
+/**
+ * @brief   A single call in a call batch buffer.
+ */
+struct RemoteCallRecord
+{
+    uint64_t function;
+    uint64_t args[kMaxRemoteCallArgs];
+    /**
+     * @brief   The return value of the function, written by the executor.
+     */
+    uint64_t result;
+    uint32_t argCount;
+    uint32_t reserved;
+};
+
+// Verify assumptions about these structures.
+static_assert(sizeof(RemoteCallHeader) == 8 && sizeof(RemoteCallRecord) == 72, 
+    "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [runRemoteCallBatch]                                                                           //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Performs all calls of a call batch buffer, to be run inside of the target.
+ * @param   buffer  The buffer, starting with a `RemoteCallHeader`.
+ * @return  The number of calls performed.
+ *          
+ * Functions are called with the platform's default calling convention, passing all arguments as 
+ * pointer-sized integers (on 32 bit x86, that restricts calls to `__cdecl` functions).
+ */
+inline uint32_t runRemoteCallBatch(void* buffer)
+{
+    auto header  = static_cast<RemoteCallHeader*>(buffer);
+    auto records = reinterpret_cast<RemoteCallRecord*>(header + 1);
+
+    using A = uintptr_t;
+    for (uint32_t i = 0; i < header->count; ++i)
+    {
+        auto& cur = records[i];
+        const auto func = static_cast<uintptr_t>(cur.function);
+        const auto arg = [&cur](std::size_t idx) { return static_cast<A>(cur.args[idx]); };
+
+        A result = 0;
+        switch (cur.argCount)
+        {
+            case 0:
+                result = reinterpret_cast<A (*)()>(func)();
+                break;
+            case 1:
+                result = reinterpret_cast<A (*)(A)>(func)(arg(0));
+                break;
+            case 2:
+                result = reinterpret_cast<A (*)(A, A)>(func)(arg(0), arg(1));
+                break;
+            case 3:
+                result = reinterpret_cast<A (*)(A, A, A)>(func)(arg(0), arg(1), arg(2));
+                break;
+            case 4:
+                result = reinterpret_cast<A (*)(A, A, A, A)>(func)(
+                    arg(0), arg(1), arg(2), arg(3));
+                break;
+            case 5:
+                result = reinterpret_cast<A (*)(A, A, A, A, A)>(func)(
+                    arg(0), arg(1), arg(2), arg(3), arg(4));
+                break;
+            case 6:
+                result = reinterpret_cast<A (*)(A, A, A, A, A, A)>(func)(
+                    arg(0), arg(1), arg(2), arg(3), arg(4), arg(5));
+                break;
+            default:
+                return header->completed = i;
+        }
+        cur.result = result;
+    }
+    return header->completed = header->count;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [RemoteCallBatch]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Converts an argument of a remote call to its representation in the call record.
+ */
+template<typename T, std::enable_if_t<std::is_integral<T>::value 
+    || std::is_enum<T>::value, int> = 0>
+inline uint64_t toRemoteCallArg(T value)
+{
+    return static_cast<uint64_t>(value);
+}
+
+/**
+ * @internal
+ * @copydoc toRemoteCallArg
+ */
+template<typename T, typename AddrT>
+inline uint64_t toRemoteCallArg(TargetPtr<T, AddrT> value)
+{
+    return value.address();
+}
+
+/**
+ * @internal
+ * @copydoc toRemoteCallArg
+ */
+inline uint64_t toRemoteCallArg(std::nullptr_t)
+{
+    return 0;
+}
+
+} // namespace internal
+
+/**
+ * @brief   Collects calls of functions in another process and performs them at once.
+ *
+ * Functions and arguments are addresses and integers in the target (pointers of our own address
+ * space make no sense there, use `uintptr_t` or `TargetPtr`). The buffer in the target has to 
+ * hold `bufferSize(capacity)` bytes and isn't used by anything else while the batch runs.
+ */
+class RemoteCallBatch : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   Runs `runRemoteCallBatch` in the target, on the buffer at the address passed.
+     */
+    using Executor = std::function<bool(uintptr_t buffer)>;
+private:
+    MemoryBackend* m_memory;
+    uintptr_t m_buffer;
+    std::size_t m_capacity;
+    Executor m_executor;
+    std::vector<RemoteCallRecord> m_records;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   memory      The memory backend of the target.
+     * @param   buffer      The address of the call buffer, in the address space of the target.
+     * @param   capacity    The maximum number of calls per batch.
+     * @param   executor    Runs the calls in the target.
+     */
+    RemoteCallBatch(MemoryBackend& memory, uintptr_t buffer, std::size_t capacity, 
+            Executor executor)
+        : m_memory{&memory}
+        , m_buffer{buffer}
+        , m_capacity{capacity}
+        , m_executor{std::move(executor)}
+    {
+        m_records.reserve(capacity);
+    }
+
+    /**
+     * @brief   Determines the size of the call buffer required for a number of calls.
+     * @param   capacity    The maximum number of calls per batch.
+     * @return  The size, in bytes.
+     */
+    static constexpr std::size_t bufferSize(std::size_t capacity)
+    {
+        return sizeof(RemoteCallHeader) + capacity * sizeof(RemoteCallRecord);
+    }
+
+#   if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+    /**
+     * @brief   Creates an executor running a function of the target on a new remote thread.
+     * @param   pid     The ID of the target process.
+     * @param   entry   The thread entry in the target, forwarding to `runRemoteCallBatch`.
+     * @return  The executor.
+     * @note    Only available on Windows.
+     * @see     platform::runRemoteThread
+     */
+    static Executor threadExecutor(uint32_t pid, uintptr_t entry)
+    {
+        return [pid, entry](uintptr_t buffer)
+        {
+            return platform::runRemoteThread(pid, entry, buffer);
+        };
+    }
+#   endif
+
+    /**
+     * @brief   Adds a call to the batch.
+     * @param   function    The address of the function, in the address space of the target.
+     * @param   args        The arguments, integers, enums or `TargetPtr`s.
+     * @return  @c true if added, @c false if the batch is full.
+     */
+    template<typename... ArgsT>
+    bool add(uintptr_t function, ArgsT... args)
+    {
+        static_assert(sizeof...(args) <= kMaxRemoteCallArgs, "too many arguments");
+        if (m_records.size() == m_capacity) return false;
+
+        RemoteCallRecord record{};
+        record.function = function;
+        record.argCount = static_cast<uint32_t>(sizeof...(args));
+        std::size_t idx = 0;
+        (void)idx;
+        (void)std::initializer_list<int>{
+            (record.args[idx++] = internal::toRemoteCallArg(args), 0)...};
+        m_records.push_back(record);
+        return true;
+    }
+
+    /**
+     * @brief   Gets the number of calls in the batch.
+     * @return  The number of calls.
+     */
+    std::size_t size() const { return m_records.size(); }
+
+    /**
+     * @brief   Performs all calls of the batch.
+     * @return  @c true if all calls were performed, else @c false.
+     *
+     * Transfers the batch with one write, runs the executor once and reads the results with one 
+     * read. The calls stay in the batch until `clear` is called, so it can be run again.
+     */
+    bool run()
+    {
+        RemoteCallHeader header{static_cast<uint32_t>(m_records.size()), 0};
+        platform::IoRange ranges[] = {
+            {m_buffer, &header, sizeof(header)},
+            {m_buffer + sizeof(header), m_records.data(), 
+                m_records.size() * sizeof(RemoteCallRecord)},
+        };
+        const std::size_t count = m_records.empty() ? 1 : 2;
+
+        if (!m_memory->writeBatch(ranges, count)) return false;
+        if (!m_executor(m_buffer)) return false;
+        if (!m_memory->readBatch(ranges, count)) return false;
+        return header.completed == header.count;
+    }
+
+    /**
+     * @brief   Gets the return value of a call, after `run`.
+     * @param   index   The index of the call, in order of `add`.
+     * @return  The return value, zero-extended from the target's pointer width.
+     */
+    uint64_t result(std::size_t index) const
+    {
+        assert(index < m_records.size());
+        return m_records[index].result;
+    }
+
+    /**
+     * @brief   Removes all calls from the batch.
+     */
+    void clear()
+    {
+        m_records.clear();
+    }
+};
+
+} // namespace remodel
+
+#endif // REMODEL_REMOTECALL_HPP
@@ -0,0 +1,642 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_RTTI_HPP
+#define REMODEL_RTTI_HPP
+
+/**
+ * @file
+ * @brief Contains an index of the polymorphic classes of a module, built from its RTTI.
+ *
+ * Both RTTI formats are understood: the Complete Object Locators MSVC places in front of every
+ * vtable and the `std::type_info` pointers of the Itanium ABI used by GCC and Clang. The module
+ * is expected to be loaded into our address space.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Pattern.hpp"
+#include "Platform.hpp"
+
+#if defined(__GNUC__)
+#   include <cxxabi.h>
+#   include <typeinfo>
+#endif
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [ClassInfo]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A vtable of a class.
+ */
+struct VtableInfo
+{
+    /**
+     * @brief   The address of the vtable, as stored in the objects' vtable pointers.
+     */
+    uintptr_t address;
+    /**
+     * @brief   The offset of the vtable pointer in the object, 0 for the primary vtable.
+     */
+    std::ptrdiff_t offset;
+};
+
+/**
+ * @brief   A direct base class of a class.
+ */
+struct BaseClassInfo
+{
+    /**
+     * @brief   The name of the base class.
+     */
+    std::string name;
+    /**
+     * @brief   The offset of the base in the object. For virtual bases, the offset of the
+     *          virtual base offset in the vtable (Itanium) or the vbtable (MSVC) instead.
+     */
+    std::ptrdiff_t offset;
+    /**
+     * @brief   Whether the base is virtual.
+     */
+    bool isVirtual;
+};
+
+/**
+ * @brief   Information about a polymorphic class.
+ */
+struct ClassInfo
+{
+    /**
+     * @brief   The demangled name, e.g. `game::Dog`. Names that can't be demangled are kept in
+     *          their mangled form.
+     */
+    std::string name;
+    /**
+     * @brief   The address of the `std::type_info` (Itanium) or `TypeDescriptor` (MSVC).
+     */
+    uintptr_t typeInfo = 0;
+    /**
+     * @brief   The vtables, the primary one first.
+     */
+    std::vector<VtableInfo> vtables;
+    /**
+     * @brief   The direct base classes (MSVC: all base classes).
+     */
+    std::vector<BaseClassInfo> bases;
+
+    /**
+     * @brief   Gets the primary vtable.
+     * @return  The address of the vtable or 0 if none was found.
+     */
+    uintptr_t vtable() const
+    {
+        return !vtables.empty() && !vtables.front().offset ? vtables.front().address : 0;
+    }
+
+    /**
+     * @brief   Gets a virtual function of the primary vtable.
+     * @param   index   The index of the function.
+     * @return  The address of the function or 0 if there's no primary vtable.
+     *
+     * The index isn't checked, vtables don't record their length.
+     */
+    uintptr_t virtualFunction(std::size_t index) const
+    {
+        const auto table = vtable();
+        return table ? reinterpret_cast<const uintptr_t*>(table)[index] : 0;
+    }
+};
+
+namespace internal
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [RTTI parsing] helpers                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Reads a value from unaligned memory.
+ */
+template<typename T>
+inline T loadUnaligned(uintptr_t address)
+{
+    T value;
+    std::memcpy(&value, reinterpret_cast<const void*>(address), sizeof(value));
+    return value;
+}
+
+/**
+ * @internal
+ * @brief   Demangles an Itanium type name, e.g. `N4game3DogE`.
+ */
+inline std::string demangleItanium(const char* name)
+{
+    // Names of types local to a translation unit are prefixed by GCC.
+    if (*name == '*') ++name;
+#   if defined(__GNUC__)
+        int status;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (demangled)
+        {
+            std::string result{demangled};
+            std::free(demangled);
+            return result;
+        }
+#   endif
+    return name;
+}
+
+/**
+ * @internal
+ * @brief   Demangles a MSVC type descriptor name, e.g. `.?AVDog@game@@`.
+ *
+ * Only plain (possibly nested) class names are handled, template instances and other special
+ * names are returned as they are.
+ */
+inline std::string demangleMsvc(const char* name)
+{
+    const auto length = std::strlen(name);
+    if (length < 6 || std::strncmp(name, ".?A", 3) != 0 || (name[3] != 'V' && name[3] != 'U')
+        || std::strcmp(name + length - 2, "@@") != 0 || std::strchr(name, '?') != name + 1
+        || std::strchr(name + 4, '$'))
+    {
+        return name;
+    }
+
+    // Components are listed innermost first.
+    std::string result;
+    for (auto end = name + length - 2; end > name + 4;)
+    {
+        auto begin = end;
+        while (begin > name + 4 && begin[-1] != '@') --begin;
+        if (!result.empty()) result += "::";
+        result.append(begin, end);
+        end = begin - 1;
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief   The vtable pointers identifying `std::type_info` objects of the Itanium ABI.
+ */
+struct ItaniumTypeInfoKinds
+{
+    uintptr_t classType = 0;   // __class_type_info, no bases
+    uintptr_t siClassType = 0; // __si_class_type_info, a single public non-virtual base at 0
+    uintptr_t vmiClassType = 0; // __vmi_class_type_info, everything else
+
+    static const ItaniumTypeInfoKinds& get()
+    {
+        static const ItaniumTypeInfoKinds kinds = []
+        {
+            ItaniumTypeInfoKinds result;
+#           if defined(ZYCORE_POSIX)
+                // The address point follows the offset to top and the type_info pointer.
+                auto resolve = [](const char* symbol)
+                {
+                    auto vtable = reinterpret_cast<uintptr_t>(dlsym(RTLD_DEFAULT, symbol));
+                    return vtable ? vtable + 2 * sizeof(void*) : 0;
+                };
+                result.classType = resolve("_ZTVN10__cxxabiv117__class_type_infoE");
+                result.siClassType = resolve("_ZTVN10__cxxabiv120__si_class_type_infoE");
+                result.vmiClassType = resolve("_ZTVN10__cxxabiv121__vmi_class_type_infoE");
+#           endif
+            return result;
+        }();
+        return kinds;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Calls a function for every aligned word of the given regions, in parallel.
+ * @param   func    Called as `func(uintptr_t address)`, concurrently.
+ */
+template<typename WordT, typename FuncT>
+inline void forEachWordParallel(const std::vector<platform::MemoryRegion>& regions,
+    unsigned numThreads, const FuncT& func)
+{
+    const std::size_t kChunkSize = 0x10000;
+
+    std::vector<platform::MemoryRegion> chunks;
+    for (const auto& region : regions)
+    {
+        const auto begin = (region.address + sizeof(WordT) - 1) & ~(sizeof(WordT) - 1);
+        const auto end = (region.address + region.size) & ~(sizeof(WordT) - 1);
+        for (auto cur = begin; cur < end; cur += kChunkSize)
+        {
+            // MSVC12 requires parentheses here (min macro).
+            chunks.push_back({cur, static_cast<std::size_t>((std::min)(end - cur,
+                uintptr_t{kChunkSize}))});
+        }
+    }
+
+    parallelFor(chunks.size(), numThreads, [&](std::size_t i)
+    {
+        const auto end = chunks[i].address + chunks[i].size;
+        for (auto cur = chunks[i].address; cur < end; cur += sizeof(WordT)) func(cur);
+    });
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [ClassIndex]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Index of the polymorphic classes of modules, by demangled name.
+ *
+ * `analyze` scans the data sections of a module once, in parallel, for RTTI structures and
+ * their vtables. Afterwards, classes are found in constant time:
+ * @code
+ *     ClassIndex index;
+ *     index.analyze(Module::getModule("game.exe").value());
+ *     auto dog = index.find("game::Dog");
+ *     auto dogs = findInstances<Dog>({dog->vtable()});
+ * @endcode
+ *
+ * Only classes with RTTI are found: MSVC builds with `/GR-` and GCC or Clang builds with
+ * `-fno-rtti` don't emit any. Classes with the same name in different modules (e.g. inline
+ * templates instantiated in each) are merged.
+ */
+class ClassIndex
+{
+    std::unordered_map<std::string, ClassInfo> m_classes;
+    std::unordered_map<uintptr_t, std::string> m_byTypeInfo;
+
+    ClassInfo& classFor(uintptr_t typeInfo, std::string name)
+    {
+        auto& info = m_classes[name];
+        if (!info.typeInfo)
+        {
+            info.typeInfo = typeInfo;
+            info.name = name;
+        }
+        m_byTypeInfo.emplace(typeInfo, std::move(name));
+        return info;
+    }
+
+    static void sortVtables(ClassInfo& info)
+    {
+        std::sort(info.vtables.begin(), info.vtables.end(),
+            [](const VtableInfo& a, const VtableInfo& b)
+        {
+            return a.offset != b.offset ? a.offset < b.offset : a.address < b.address;
+        });
+        info.vtables.erase(std::unique(info.vtables.begin(), info.vtables.end(),
+            [](const VtableInfo& a, const VtableInfo& b)
+        {
+            return a.address == b.address;
+        }), info.vtables.end());
+    }
+
+    bool analyzeItanium(const std::vector<platform::MemoryRegion>& regions, unsigned numThreads);
+    bool analyzeMsvc(uintptr_t imageBase, const std::vector<platform::MemoryRegion>& regions,
+        unsigned numThreads);
+public:
+    /**
+     * @brief   Adds the classes of a module to the index.
+     * @param   imageBase   Pointer to the module's first byte (its PE or ELF header).
+     * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+     * @return  @c true if the module could be analyzed, else @c false.
+     */
+    bool analyze(const void* imageBase, unsigned numThreads = 0)
+    {
+        std::vector<platform::MemoryRegion> regions;
+        if (!platform::obtainDataRegions(imageBase, regions)) return false;
+
+        auto base = static_cast<const uint8_t*>(imageBase);
+        if (base[0] == 'M' && base[1] == 'Z')
+        {
+            return analyzeMsvc(reinterpret_cast<uintptr_t>(imageBase), regions, numThreads);
+        }
+        return analyzeItanium(regions, numThreads);
+    }
+
+    /**
+     * @brief   Adds the classes of a module to the index.
+     * @copydetails analyze(const void*, unsigned)
+     */
+    bool analyze(const Module& module, unsigned numThreads = 0)
+    {
+        return analyze(module.addressOfObj(), numThreads);
+    }
+
+    /**
+     * @brief   Finds a class by its demangled name.
+     * @param   name    The name, e.g. `game::Dog`.
+     * @return  The class or @c nullptr if not found.
+     */
+    const ClassInfo* find(const std::string& name) const
+    {
+        auto it = m_classes.find(name);
+        return it != m_classes.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief   Finds a class by the address of its RTTI type descriptor.
+     * @param   typeInfo    The address of the `std::type_info` or `TypeDescriptor`.
+     * @return  The class or @c nullptr if not found.
+     */
+    const ClassInfo* findByTypeInfo(uintptr_t typeInfo) const
+    {
+        auto it = m_byTypeInfo.find(typeInfo);
+        return it != m_byTypeInfo.end() ? find(it->second) : nullptr;
+    }
+
+    /**
+     * @brief   Finds the index of a function in the primary vtable of a class, e.g. to construct
+     *          a @c VirtualFunction from the address of an exported implementation.
+     * @param   name        The name of the class, e.g. `game::Dog`.
+     * @param   function    The address of the function.
+     * @param   maxEntries  The maximum number of entries searched.
+     * @return  The index, or nothing if not found.
+     *
+     * Vtables don't record their length, the search stops at the first null entry or after
+     * @p maxEntries entries.
+     */
+    zycore::Optional<std::size_t> vftableIndex(const std::string& name, uintptr_t function,
+        std::size_t maxEntries = 1024) const
+    {
+        auto info = find(name);
+        const auto table = info ? reinterpret_cast<const uintptr_t*>(info->vtable()) : nullptr;
+        if (!table) return zycore::kEmpty;
+
+        for (std::size_t i = 0; i < maxEntries && table[i]; ++i)
+        {
+            if (table[i] == function) return {zycore::kInPlace, i};
+        }
+        return zycore::kEmpty;
+    }
+
+    /**
+     * @brief   Gets all classes.
+     * @return  The classes, by name.
+     */
+    const std::unordered_map<std::string, ClassInfo>& classes() const { return m_classes; }
+
+    /**
+     * @brief   Gets the number of classes.
+     * @return  The number of classes.
+     */
+    std::size_t size() const { return m_classes.size(); }
+};
+
+inline bool ClassIndex::analyzeItanium(const std::vector<platform::MemoryRegion>& regions,
+    unsigned numThreads)
+{
+    const auto& kinds = internal::ItaniumTypeInfoKinds::get();
+    if (!kinds.classType) return false;
+    const auto kPtr = sizeof(uintptr_t);
+
+    // Pass 1: type_info objects, recognized by their vtable pointer.
+    struct TypeInfo
+    {
+        uintptr_t address;
+        uintptr_t kind;
+    };
+    auto inRegions = [&](uintptr_t address, std::size_t size)
+    {
+        return std::any_of(regions.begin(), regions.end(), [&](const platform::MemoryRegion& cur)
+        {
+            return address >= cur.address && address + size <= cur.address + cur.size;
+        });
+    };
+
+    std::mutex mutex;
+    std::vector<TypeInfo> typeInfos;
+    internal::forEachWordParallel<uintptr_t>(regions, numThreads, [&](uintptr_t address)
+    {
+        const auto word = *reinterpret_cast<const uintptr_t*>(address);
+        if (word != kinds.classType && word != kinds.siClassType && word != kinds.vmiClassType)
+        {
+            return;
+        }
+        // The name is emitted along with the type_info, which rules out other copies of the
+        // vtable address, e.g. in the GOT.
+        if (!inRegions(address, 2 * kPtr)) return;
+        const auto name = *reinterpret_cast<const uintptr_t*>(address + kPtr);
+        if (!inRegions(name, 1)) return;
+        std::lock_guard<std::mutex> lock{mutex};
+        typeInfos.push_back({address, word});
+    });
+
+    // The fields of type_infos point to other type_infos as well, which must not be mistaken for
+    // vtables: remember their extents.
+    std::unordered_set<uintptr_t> known;
+    std::vector<std::pair<uintptr_t, uintptr_t>> extents;
+    for (const auto& cur : typeInfos)
+    {
+        known.insert(cur.address);
+        std::size_t size = 2 * kPtr;
+        if (cur.kind == kinds.siClassType) size = 3 * kPtr;
+        if (cur.kind == kinds.vmiClassType)
+        {
+            const auto count = *reinterpret_cast<const uint32_t*>(cur.address + 2 * kPtr + 4);
+            size = 2 * kPtr + 8 + count * 2 * kPtr;
+        }
+        extents.emplace_back(cur.address, cur.address + size);
+    }
+    std::sort(extents.begin(), extents.end());
+    auto insideTypeInfo = [&](uintptr_t address)
+    {
+        auto it = std::upper_bound(extents.begin(), extents.end(),
+            std::make_pair(address, ~uintptr_t{0}));
+        return it != extents.begin() && address < (it - 1)->second;
+    };
+
+    // Pass 2: vtables, `[offset to top][type_info*][functions...]`.
+    std::vector<std::pair<uintptr_t, VtableInfo>> vtables;
+    internal::forEachWordParallel<uintptr_t>(regions, numThreads, [&](uintptr_t address)
+    {
+        const auto word = *reinterpret_cast<const uintptr_t*>(address);
+        if (!known.count(word) || insideTypeInfo(address)) return;
+        const bool hasOffsetToTop = std::any_of(regions.begin(), regions.end(),
+            [&](const platform::MemoryRegion& cur)
+        {
+            return address >= cur.address + kPtr && address < cur.address + cur.size;
+        });
+        if (!hasOffsetToTop) return;
+
+        const auto offsetToTop = *reinterpret_cast<const std::ptrdiff_t*>(address - kPtr);
+        if (offsetToTop > 0 || offsetToTop < -(std::ptrdiff_t{1} << 24)) return;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        vtables.push_back({word, {address + kPtr, -offsetToTop}});
+    });
+
+    // Bases may live in other modules, they're only followed into mapped memory.
+    std::vector<platform::Mapping> mappings;
+    platform::enumerateMappings(mappings);
+    auto isReadable = [&](uintptr_t address)
+    {
+        auto it = std::upper_bound(mappings.begin(), mappings.end(), address,
+            [](uintptr_t lhs, const platform::Mapping& rhs) { return lhs < rhs.address; });
+        return it != mappings.begin() && address - (it - 1)->address < (it - 1)->size
+            && ((it - 1)->protection & platform::kMappingReadable);
+    };
+    auto nameOf = [&](uintptr_t typeInfo) -> std::string
+    {
+        if (!known.count(typeInfo) && !(isReadable(typeInfo) && isReadable(typeInfo + kPtr)
+            && isReadable(*reinterpret_cast<const uintptr_t*>(typeInfo + kPtr))))
+        {
+            return {};
+        }
+        return internal::demangleItanium(*reinterpret_cast<const char* const*>(typeInfo + kPtr));
+    };
+
+    for (const auto& cur : typeInfos)
+    {
+        auto& info = classFor(cur.address, nameOf(cur.address));
+        if (!info.bases.empty()) continue;
+
+        if (cur.kind == kinds.siClassType)
+        {
+            const auto base = *reinterpret_cast<const uintptr_t*>(cur.address + 2 * kPtr);
+            info.bases.push_back({nameOf(base), 0, false});
+        }
+        else if (cur.kind == kinds.vmiClassType)
+        {
+            const auto count = *reinterpret_cast<const uint32_t*>(cur.address + 2 * kPtr + 4);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const auto entry = cur.address + 2 * kPtr + 8 + i * 2 * kPtr;
+                const auto base = *reinterpret_cast<const uintptr_t*>(entry);
+                const auto offsetFlags = *reinterpret_cast<const std::ptrdiff_t*>(entry + kPtr);
+                info.bases.push_back({nameOf(base), offsetFlags >> 8, (offsetFlags & 1) != 0});
+            }
+        }
+    }
+    for (const auto& cur : vtables)
+    {
+        auto& info = m_classes[m_byTypeInfo[cur.first]];
+        info.vtables.push_back(cur.second);
+    }
+    for (auto& cur : m_classes) sortVtables(cur.second);
+    return true;
+}
+
+inline bool ClassIndex::analyzeMsvc(uintptr_t imageBase,
+    const std::vector<platform::MemoryRegion>& regions, unsigned numThreads)
+{
+    const bool is64 = sizeof(void*) == 8;
+    auto inImage = [&](uintptr_t address)
+    {
+        for (const auto& cur : regions)
+        {
+            if (address >= cur.address && address < cur.address + cur.size) return true;
+        }
+        return false;
+    };
+    // Pointers in RTTI structures are image relative on x64 and absolute on x86.
+    auto resolve = [&](uintptr_t field)
+    {
+        const auto value = internal::loadUnaligned<uint32_t>(field);
+        return is64 ? imageBase + value : static_cast<uintptr_t>(value);
+    };
+    auto isTypeDescriptor = [&](uintptr_t address)
+    {
+        if (!inImage(address)) return false;
+        auto name = reinterpret_cast<const char*>(address + 2 * sizeof(void*));
+        return inImage(reinterpret_cast<uintptr_t>(name) + 4) && std::strncmp(name, ".?A", 3) == 0;
+    };
+
+    // Complete Object Locator:
+    // `signature, offset, cdOffset, typeDescriptor, classDescriptor[, self]`, pointed to by the
+    // word in front of every vtable.
+    auto isLocator = [&](uintptr_t address)
+    {
+        if (!inImage(address) || !inImage(address + (is64 ? 24 : 20) - 1)) return false;
+        if (internal::loadUnaligned<uint32_t>(address) != (is64 ? 1u : 0u)) return false;
+        if (is64 && internal::loadUnaligned<uint32_t>(address + 20) != address - imageBase)
+        {
+            return false;
+        }
+        return isTypeDescriptor(resolve(address + 12)) && inImage(resolve(address + 16));
+    };
+
+    std::mutex mutex;
+    std::vector<std::pair<uintptr_t, uintptr_t>> found; // (locator, vtable)
+    internal::forEachWordParallel<uintptr_t>(regions, numThreads, [&](uintptr_t address)
+    {
+        const auto word = *reinterpret_cast<const uintptr_t*>(address);
+        if (!isLocator(word)) return;
+        std::lock_guard<std::mutex> lock{mutex};
+        found.emplace_back(word, address + sizeof(void*));
+    });
+
+    for (const auto& cur : found)
+    {
+        const auto locator = cur.first;
+        const auto typeDescriptor = resolve(locator + 12);
+        auto& info = classFor(typeDescriptor, internal::demangleMsvc(
+            reinterpret_cast<const char*>(typeDescriptor + 2 * sizeof(void*))));
+        const auto offset = internal::loadUnaligned<uint32_t>(locator + 4);
+        info.vtables.push_back({cur.second, static_cast<std::ptrdiff_t>(offset)});
+
+        if (!info.bases.empty()) continue;
+        // Class Hierarchy Descriptor: `signature, attributes, numBaseClasses, baseClassArray`.
+        const auto hierarchy = resolve(locator + 16);
+        const auto numBases = internal::loadUnaligned<uint32_t>(hierarchy + 8);
+        const auto baseArray = resolve(hierarchy + 12);
+        // The first Base Class Descriptor is the class itself.
+        for (uint32_t i = 1; i < numBases && inImage(baseArray + i * 4); ++i)
+        {
+            // `typeDescriptor, numContainedBases, mdisp, pdisp, vdisp, attributes`
+            const auto base = resolve(baseArray + i * 4);
+            if (!inImage(base)) break;
+            const auto baseType = resolve(base);
+            if (!isTypeDescriptor(baseType)) break;
+            const auto mdisp = internal::loadUnaligned<int32_t>(base + 8);
+            const auto pdisp = internal::loadUnaligned<int32_t>(base + 12);
+            const auto vdisp = internal::loadUnaligned<int32_t>(base + 16);
+            info.bases.push_back({internal::demangleMsvc(
+                reinterpret_cast<const char*>(baseType + 2 * sizeof(void*))),
+                pdisp == -1 ? mdisp : vdisp, pdisp != -1});
+        }
+    }
+    for (auto& cur : m_classes) sortVtables(cur.second);
+    return true;
+}
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_RTTI_HPP
@@ -0,0 +1,204 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_SAFE_HPP
+#define REMODEL_SAFE_HPP
+
+/**
+ * @file
+ * @brief Contains fault-tolerant reads of fields, for following untrusted pointers.
+ *
+ * Reading through a dangling pointer of the target normally crashes our process. `safeLoad`
+ * and `SafeField` copy the value through `platform::safeRead` instead and return an empty
+ * optional if the memory isn't readable:
+ * @code
+ *     auto age = safeLoad(dog, &Dog::age);
+ *     if (age.hasValue()) ...
+ * @endcode
+ * Reads of valid memory cost a lookup in the cached `platform::AddressSpaceMap` plus a guarded
+ * copy, only reads that actually fault take the slow recovery path.
+ */
+
+#include <cstring>
+#include <type_traits>
+
+#include "zycore/Optional.hpp"
+#include "Platform.hpp"
+#include "remodel/Field.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [safeLoad]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Converts the bytes of a field read with `safeRead` to the value `load` returns.
+ * @tparam  ObjT    The type of the field in memory.
+ * @tparam  TypeT   The type of the loaded value.
+ */
+template<typename ObjT, typename TypeT, typename = void>
+struct SafeLoadConvert
+{
+    // Plain values and arrays (copied into `std::array`s) share the representation in memory.
+    static_assert(sizeof(ObjT) == sizeof(TypeT), "unexpected size of the loaded value");
+
+    static TypeT convert(const void* bytes)
+    {
+        TypeT value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Values in foreign byte order are converted to native values.
+ * @copydetails SafeLoadConvert
+ */
+template<typename ObjT, typename TypeT>
+struct SafeLoadConvert<ObjT, TypeT, std::enable_if_t<IsEndianValue<ObjT>::value>>
+{
+    static TypeT convert(const void* bytes)
+    {
+        ObjT value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value.get();
+    }
+};
+
+/**
+ * @internal
+ * @brief   The result of `safeLoad` for a field type.
+ */
+template<typename FieldT>
+using SafeLoadResult = zycore::Optional<typename LoadTraitsOf<FieldT>::Type>;
+
+/**
+ * @internal
+ * @brief   Reads the object of a field at a given address, see `safeLoad`.
+ * @tparam  FieldT  The type of the field.
+ * @param   address The address of the object.
+ * @return  The value, or nothing if the memory isn't readable.
+ */
+template<typename FieldT>
+inline SafeLoadResult<FieldT> safeLoadAt(const void* address)
+{
+    using ObjT = std::remove_cv_t<
+        std::remove_pointer_t<decltype(std::declval<const FieldT&>().addressOfObj())>>;
+    using Type = typename LoadTraitsOf<FieldT>::Type;
+    static_assert(!std::is_base_of<WrapperBase, std::remove_all_extents_t<ObjT>>::value,
+        "safeLoad copies plain values, fields of wrapper types can't be loaded");
+    static_assert(std::is_trivially_copyable<ObjT>::value,
+        "safeLoad requires trivially copyable field types");
+
+    std::aligned_storage_t<sizeof(ObjT), alignof(ObjT)> bytes;
+    if (!platform::safeRead(&bytes, address, sizeof(ObjT))) return zycore::kEmpty;
+    return {zycore::kInPlace, SafeLoadConvert<ObjT, Type>::convert(&bytes)};
+}
+
+} // namespace internal
+
+/**
+ * @brief   Copies the value of a field, failing gracefully if its memory isn't readable.
+ * @param   field   The field, of a trivially copyable type.
+ * @return  The value as with `load`, or nothing if the memory isn't readable.
+ *
+ * Arrays are returned as `std::array`s and values in foreign byte order are converted. The
+ * parent of the field must be valid (readable or not), reference fields must be `SafeField`s
+ * so the pointer to the referenced object is read safely, too.
+ */
+template<typename FieldT>
+inline internal::SafeLoadResult<FieldT> safeLoad(const FieldT& field)
+{
+    return internal::safeLoadAt<FieldT>(field.addressOfObj());
+}
+
+/**
+ * @brief   Copies the value of a field of a wrapper, failing gracefully if it isn't readable.
+ * @param   wrapper The wrapper.
+ * @param   field   Pointer to the field to load, e.g. `&Dog::age`.
+ * @return  The value as with `load`, or nothing if the memory isn't readable.
+ */
+template<typename WrapperT, typename FieldPtrT>
+inline internal::SafeLoadResult<internal::FieldOf<WrapperT, FieldPtrT>> safeLoad(
+    const WrapperT& wrapper, FieldPtrT field)
+{
+    return safeLoad(wrapper.*field);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [SafeField]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `Field` additionally offering fault-tolerant reads.
+ * @copydetails Field
+ *
+ * Behaves exactly like `Field`, `load` reads the value like `safeLoad`. For reference fields
+ * (`SafeField<Dog&>`), the stored pointer is read safely before following it:
+ * @code
+ *     SafeField<uint32_t> hunger{this, 0x10};
+ *     // ..
+ *     auto hunger = dog.hunger.load();
+ *     if (!hunger.hasValue()) forget(dog);
+ * @endcode
+ */
+template<
+    typename T,
+    typename PtrGetterT = internal::FieldBase::PtrGetter,
+    typename AccessT = access::Plain>
+class SafeField : public Field<T, PtrGetterT, AccessT>
+{
+    using Base = Field<T, PtrGetterT, AccessT>;
+public:
+    /// The type of the loaded value.
+    using ValueType = typename internal::LoadTraitsOf<Base>::Type;
+
+    using Base::Base;
+    using Base::operator=;
+
+    /**
+     * @brief   Copies the value of the field, failing gracefully if it isn't readable.
+     * @return  The value as with `load`, or nothing if the memory isn't readable.
+     */
+    zycore::Optional<ValueType> load() const
+    {
+        if (!std::is_reference<T>::value) return internal::safeLoadAt<Base>(this->crawPtr());
+
+        const void* obj;
+        if (!platform::safeRead(&obj, this->crawPtr(), sizeof(obj))) return zycore::kEmpty;
+        return internal::safeLoadAt<Base>(obj);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_SAFE_HPP
@@ -0,0 +1,271 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_SCAN_HPP
+#define REMODEL_SCAN_HPP
+
+/**
+ * @file
+ * @brief Contains scanners finding live objects in memory.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Pattern.hpp"
+#include "Platform.hpp"
+#include "Simd.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [InstanceRange]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Range of objects found by a scan, iterated as wrappers.
+ * @tparam  WrapperT    The wrapper type of the objects.
+ *
+ * Like with `ListRange`, the iterators rebind a wrapper rather than creating one per object.
+ *
+ * @note    Dereferencing an iterator yields a reference to the wrapper stored inside of the
+ *          iterator, which stays valid only until the iterator is advanced or destroyed.
+ */
+template<typename WrapperT>
+class InstanceRange
+{
+    std::vector<void*> m_objects;
+public:
+    /**
+     * @brief   Iterator type of the range.
+     */
+    class Iterator
+    {
+        WrapperT m_wrapper;
+        void* const* m_cur;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = WrapperT;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = WrapperT*;
+        using reference         = WrapperT&;
+
+        /**
+         * @brief   Constructor.
+         * @param   cur Pointer to the entry of the current object in the range.
+         * @param   end Pointer to the end of the entries.
+         */
+        Iterator(void* const* cur, void* const* end)
+            : m_wrapper{wrapper_cast<WrapperT>(cur != end ? *cur : nullptr)}
+            , m_cur{cur}
+        {}
+
+        WrapperT& operator * () { return m_wrapper; }
+        WrapperT* operator -> () { return m_wrapper.addressOfWrapper(); }
+
+        Iterator& operator ++ ()
+        {
+            ++m_cur;
+            // The entry past the last one is never dereferenced, the wrapper is only rebound.
+            m_wrapper.rebind(*m_cur);
+            return *this;
+        }
+
+        bool operator == (const Iterator& rhs) const { return m_cur == rhs.m_cur; }
+        bool operator != (const Iterator& rhs) const { return !(*this == rhs); }
+    };
+
+    /**
+     * @brief   Constructor.
+     * @param   objects The raw pointers of the objects.
+     */
+    explicit InstanceRange(std::vector<void*> objects)
+        : m_objects(std::move(objects))
+    {
+        // Terminator read by the last increment of an iterator.
+        m_objects.push_back(nullptr);
+    }
+
+    Iterator begin() const { return {m_objects.data(), m_objects.data() + size()}; }
+    Iterator end() const { return {m_objects.data() + size(), m_objects.data() + size()}; }
+
+    /**
+     * @brief   Gets the number of objects.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_objects.size() - 1; }
+
+    /**
+     * @brief   Determines whether no objects were found.
+     * @return  @c true if empty, else @c false.
+     */
+    bool empty() const { return !size(); }
+
+    /**
+     * @brief   Gets a wrapper for an object.
+     * @param   index   The index of the object.
+     * @return  The wrapper.
+     */
+    WrapperT operator [] (std::size_t index) const
+    {
+        return wrapper_cast<WrapperT>(m_objects[index]);
+    }
+
+    /**
+     * @brief   Gets the raw pointers of the objects, sorted by address.
+     * @return  The raw pointers.
+     */
+    std::vector<void*> objects() const
+    {
+        return {m_objects.begin(), m_objects.end() - 1};
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [findInstances]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Finds all objects of a polymorphic class by scanning memory for its vtable pointers.
+ * @tparam  WrapperT    The wrapper type of the objects.
+ * @param   vtables     The addresses of the vtables of the class, e.g. of the class itself and of
+ *                      derived classes that should be found as well.
+ * @param   numVtables  The number of vtables.
+ * @param   regions     The memory to scan, e.g. from `platform::obtainWritableRegions`.
+ * @param   numRegions  The number of regions.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ * @return  The objects, sorted by address.
+ *
+ * Every pointer-aligned word is compared against the vtables, with AVX-512 or AVX2 where
+ * available at compile time (see `simd::forEachWordMatch`), and regions are split into chunks
+ * scanned in parallel. Objects are expected to start with their vtable pointer, as is the case
+ * for the primary vtable with both MSVC and Itanium ABIs.
+ *
+ * Any word holding a vtable address is reported, so copies of it, e.g. in local variables or
+ * stale memory of freed objects, are found as well. The copy in @c vtables itself is skipped.
+ * The regions must stay mapped during the scan.
+ */
+template<typename WrapperT>
+inline InstanceRange<WrapperT> findInstances(const uintptr_t* vtables, std::size_t numVtables,
+    const platform::MemoryRegion* regions, std::size_t numRegions, unsigned numThreads = 0)
+{
+    using WordT = std::conditional_t<sizeof(uintptr_t) == 8, uint64_t, uint32_t>;
+    const std::size_t kChunkSize = 0x100000;
+
+    struct Chunk
+    {
+        const WordT* words;
+        std::size_t count;
+    };
+
+    std::vector<Chunk> chunks;
+    for (std::size_t i = 0; i < numRegions; ++i)
+    {
+        const auto begin = (regions[i].address + sizeof(WordT) - 1) & ~(sizeof(WordT) - 1);
+        const auto end = (regions[i].address + regions[i].size) & ~(sizeof(WordT) - 1);
+        for (auto cur = begin; cur < end; cur += kChunkSize)
+        {
+            // MSVC12 requires parentheses here (min macro).
+            const auto size = (std::min)(end - cur, uintptr_t{kChunkSize});
+            chunks.push_back({reinterpret_cast<const WordT*>(cur), size / sizeof(WordT)});
+        }
+    }
+
+    std::vector<WordT> values(vtables, vtables + numVtables);
+    const auto skipBegin = reinterpret_cast<const void*>(vtables);
+    const auto skipEnd = reinterpret_cast<const void*>(vtables + numVtables);
+    std::vector<std::vector<void*>> found(chunks.size());
+    internal::parallelFor(chunks.size(), numThreads, [&](std::size_t chunkIdx)
+    {
+        const auto& chunk = chunks[chunkIdx];
+        simd::forEachWordMatch(chunk.words, chunk.count, values.data(), values.size(),
+            [&](std::size_t index)
+            {
+                void* object = const_cast<WordT*>(chunk.words + index);
+                if (object >= skipBegin && object < skipEnd) return;
+                if (object >= static_cast<const void*>(values.data())
+                    && object < static_cast<const void*>(values.data() + values.size())) return;
+                found[chunkIdx].push_back(object);
+            });
+    });
+
+    std::vector<void*> objects;
+    for (auto& cur : found)
+    {
+        // Multiple passes (more than 4 vtables) report matches out of order.
+        if (numVtables > simd::internal::kWordMatchValues) std::sort(cur.begin(), cur.end());
+        objects.insert(objects.end(), cur.begin(), cur.end());
+    }
+    return InstanceRange<WrapperT>{std::move(objects)};
+}
+
+/**
+ * @brief   Finds all objects of a polymorphic class in the writable memory of our process.
+ * @param   vtables     The addresses of the vtables of the class.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ * @return  The objects, sorted by address.
+ *
+ * @copydetails findInstances(const uintptr_t*, std::size_t, const platform::MemoryRegion*,
+ *              std::size_t, unsigned)
+ *
+ * @code
+ *     for (auto& dog : findInstances<Dog>({dogVtable, puppyVtable}))
+ *     {
+ *         dog.hatesKittehz = false;
+ *     }
+ * @endcode
+ */
+template<typename WrapperT>
+inline InstanceRange<WrapperT> findInstances(std::initializer_list<uintptr_t> vtables,
+    unsigned numThreads = 0)
+{
+    std::vector<platform::MemoryRegion> regions;
+    platform::obtainWritableRegions(regions);
+    return findInstances<WrapperT>(vtables.begin(), vtables.size(), regions.data(),
+        regions.size(), numThreads);
+}
+
+/**
+ * @brief   Finds all objects of a polymorphic class in the given memory regions.
+ * @copydetails findInstances(std::initializer_list<uintptr_t>, unsigned)
+ * @param   regions The memory to scan.
+ */
+template<typename WrapperT>
+inline InstanceRange<WrapperT> findInstances(std::initializer_list<uintptr_t> vtables,
+    const std::vector<platform::MemoryRegion>& regions, unsigned numThreads = 0)
+{
+    return findInstances<WrapperT>(vtables.begin(), vtables.size(), regions.data(),
+        regions.size(), numThreads);
+}
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_SCAN_HPP
@@ -0,0 +1,420 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_SIGNATURECACHE_HPP
+#define REMODEL_SIGNATURECACHE_HPP
+
+/**     
+ * @file
+ * @brief Contains a persistent cache for signature scan results.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Platform.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [SignatureCache]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Cache of signature scan results, stored in a file and keyed by the module's identity.
+ *          
+ * Results are stored as offsets relative to the module base, so they stay valid when the module
+ * is relocated. A cache file is only accepted if it was written for the same build of the module
+ * (see @c platform::obtainModuleIdentity); patterns that were not found are cached as well.
+ * Resolved addresses can be passed to @c Function, @c MemberFunction or @c AbsGetter as usual.
+ *
+ * File layout (host byte order):
+ * @code
+ *  char     magic[4];              // "RMSC"
+ *  uint32_t version;
+ *  uint32_t identitySize;
+ *  uint8_t  identity[identitySize];
+ *  uint32_t numEntries;
+ *  struct { uint32_t keySize; char key[keySize]; uint64_t offset; } entries[numEntries];
+ *  uint32_t checksum;              // FNV-1a of everything above
+ * @endcode
+ */
+class SignatureCache
+{
+    static const uint32_t kVersion = 1;
+    static const uint64_t kNotFound = ~uint64_t{0};
+
+    std::vector<uint8_t> m_identity;
+    std::map<std::string, uint64_t> m_offsets;
+    bool m_dirty = false;
+
+    static uint32_t checksum(const uint8_t* data, std::size_t size)
+    {
+        uint32_t hash = 0x811C9DC5;
+        for (std::size_t i = 0; i < size; ++i) hash = (hash ^ data[i]) * 0x01000193;
+        return hash;
+    }
+
+    static uintptr_t moduleBase(const Module& module)
+    {
+        return reinterpret_cast<uintptr_t>(module.addressOfObj());
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   identity    The identity of the module the results belong to.
+     */
+    explicit SignatureCache(std::vector<uint8_t> identity)
+        : m_identity(std::move(identity))
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   module  The module the results belong to.
+     */
+    explicit SignatureCache(const Module& module)
+    {
+        platform::obtainModuleIdentity(module.addressOfObj(), m_identity);
+    }
+
+    /**
+     * @brief   Determines whether the module has an identity, which is required for @c load and
+     *          @c save to succeed.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return !m_identity.empty(); }
+
+    /**
+     * @brief   Gets the identity of the module.
+     * @return  The identity.
+     */
+    const std::vector<uint8_t>& identity() const { return m_identity; }
+
+    /**
+     * @brief   Gets the number of cached results.
+     * @return  The number of results.
+     */
+    std::size_t size() const { return m_offsets.size(); }
+    
+    /**
+     * @brief   Determines whether results were added since the cache was loaded or saved.
+     * @return  @c true if dirty, else @c false.
+     */
+    bool isDirty() const { return m_dirty; }
+
+    /**
+     * @brief   Removes all results.
+     */
+    void clear()
+    {
+        m_dirty = m_dirty || !m_offsets.empty();
+        m_offsets.clear();
+    }
+
+    /**
+     * @brief   Looks up a result.
+     * @param   key The key, usually the canonical form of a pattern.
+     * @return  The offset relative to the module base, or an empty optional if the result is not 
+     *          cached or the pattern was not found (see @c contains).
+     */
+    zycore::Optional<uint64_t> lookup(const std::string& key) const
+    {
+        auto it = m_offsets.find(key);
+        if (it == m_offsets.end() || it->second == kNotFound) return zycore::kEmpty;
+        return {zycore::kInPlace, it->second};
+    }
+
+    /**
+     * @brief   Determines whether a result is cached, including negative ones.
+     * @param   key The key.
+     * @return  @c true if cached, else @c false.
+     */
+    bool contains(const std::string& key) const { return m_offsets.count(key) != 0; }
+
+    /**
+     * @brief   Stores a result.
+     * @param   key     The key, usually the canonical form of a pattern.
+     * @param   offset  The offset relative to the module base, empty if the pattern was not found.
+     */
+    void store(const std::string& key, const zycore::Optional<uint64_t>& offset)
+    {
+        m_offsets[key] = offset.hasValue() ? offset.value() : kNotFound;
+        m_dirty = true;
+    }
+
+    /**
+     * @brief   Resolves a pattern, scanning the module only if the result is not cached.
+     * @param   module  The module, must be the one the cache belongs to.
+     * @param   pattern The pattern.
+     * @return  If found, the address of the first match, else an empty optional.
+     */
+    zycore::Optional<uintptr_t> resolve(const Module& module, const Pattern& pattern)
+    {
+        const auto key = pattern.toString();
+        if (!contains(key))
+        {
+            auto match = module.findPattern(pattern);
+            if (match.hasValue())
+            {
+                store(key, {zycore::kInPlace, match.value() - moduleBase(module)});
+            }
+            else
+            {
+                store(key, zycore::kEmpty);
+            }
+        }
+
+        auto offset = lookup(key);
+        if (!offset.hasValue()) return zycore::kEmpty;
+        return {zycore::kInPlace, moduleBase(module) + static_cast<uintptr_t>(offset.value())};
+    }
+
+    /**
+     * @brief   Resolves a pattern, scanning the module only if the result is not cached.
+     * @param   module  The module, must be the one the cache belongs to.
+     * @param   pattern The pattern, e.g. `48 8B ?? ?? E8`.
+     * @copydetails resolve(const Module&, const Pattern&)
+     */
+    zycore::Optional<uintptr_t> resolve(const Module& module, const char* pattern)
+    {
+        return resolve(module, Pattern{pattern});
+    }
+
+    /**
+     * @brief   Resolves a set of patterns, scanning the module once for those not cached.
+     * @param   module      The module, must be the one the cache belongs to.
+     * @param   patterns    The patterns.
+     * @param   results     Receives the address of the first match of every pattern, or @c 0 if
+     *                      not found, indexed like the patterns.
+     * @param   numThreads  The maximum number of threads used for scanning, 0 to use the 
+     *                      hardware concurrency.
+     * @return  @c true if all patterns could be resolved, @c false if the module's sections 
+     *          could not be determined.
+     */
+    bool resolve(const Module& module, const PatternSet& patterns, 
+        std::vector<uintptr_t>& results, unsigned numThreads = 0)
+    {
+        return resolve(moduleBase(module), patterns, results,
+            [&](const PatternSet& missing, std::vector<uintptr_t>& matches)
+            {
+                return module.findPatterns(missing, matches, numThreads);
+            });
+    }
+
+    /**
+     * @brief   Resolves a set of patterns, searching the module once for those not cached.
+     * @tparam  FindT       Type of the search function.
+     * @param   base        The base address of the module the cache belongs to.
+     * @param   patterns    The patterns.
+     * @param   results     Receives the address of the first match of every pattern, or @c 0 if
+     *                      not found, indexed like the patterns.
+     * @param   find        Called as `bool(const PatternSet& missing, std::vector<uintptr_t>&
+     *                      matches)` to search for the patterns not cached, e.g. in a module of
+     *                      another process. Fills @c matches like `Module::findPatterns`.
+     * @return  @c true if all patterns could be resolved, @c false if @c find failed.
+     */
+    template<typename FindT>
+    bool resolve(uintptr_t base, const PatternSet& patterns, std::vector<uintptr_t>& results,
+        FindT&& find)
+    {
+        std::vector<std::string> keys;
+        keys.reserve(patterns.size());
+        PatternSet missing;
+        std::vector<std::size_t> missingIdx;
+        for (std::size_t i = 0; i < patterns.size(); ++i)
+        {
+            keys.push_back(patterns[i].toString());
+            if (!contains(keys.back()))
+            {
+                missing.add(patterns[i]);
+                missingIdx.push_back(i);
+            }
+        }
+
+        if (missing.size())
+        {
+            std::vector<uintptr_t> matches;
+            if (!find(missing, matches)) return false;
+            for (std::size_t i = 0; i < missing.size(); ++i)
+            {
+                if (matches[i])
+                {
+                    store(keys[missingIdx[i]], {zycore::kInPlace, matches[i] - base});
+                }
+                else
+                {
+                    store(keys[missingIdx[i]], zycore::kEmpty);
+                }
+            }
+        }
+
+        results.resize(patterns.size());
+        for (std::size_t i = 0; i < patterns.size(); ++i)
+        {
+            auto offset = lookup(keys[i]);
+            results[i] = offset.hasValue() ? base + static_cast<uintptr_t>(offset.value()) : 0;
+        }
+        return true;
+    }
+
+    /**
+     * @brief   Replaces the cached results with the ones stored in a file.
+     * @param   path    The path of the file.
+     * @return  @c true if the file was loaded, @c false if it doesn't exist, is corrupted or was
+     *          written for a different build of the module. The cache is unchanged on failure.
+     */
+    bool load(const char* path)
+    {
+        if (!isValid()) return false;
+
+        std::vector<uint8_t> data;
+        if (auto file = std::fopen(path, "rb"))
+        {
+            uint8_t buf[4096];
+            for (std::size_t n; (n = std::fread(buf, 1, sizeof(buf), file)) > 0;)
+            {
+                data.insert(data.end(), buf, buf + n);
+            }
+            std::fclose(file);
+        }
+        if (data.size() < 4) return false;
+
+        uint32_t fileChecksum;
+        std::memcpy(&fileChecksum, &data[data.size() - 4], 4);
+        if (fileChecksum != checksum(data.data(), data.size() - 4)) return false;
+
+        std::size_t pos = 0;
+        const std::size_t end = data.size() - 4;
+        auto read = [&](void* out, std::size_t size)
+        {
+            if (end - pos < size) return false;
+            std::memcpy(out, &data[pos], size);
+            pos += size;
+            return true;
+        };
+
+        char magic[4];
+        uint32_t version, identitySize, numEntries;
+        if (!read(magic, 4) || std::memcmp(magic, "RMSC", 4)) return false;
+        if (!read(&version, 4) || version != kVersion) return false;
+        if (!read(&identitySize, 4) || identitySize != m_identity.size()) return false;
+        if (end - pos < identitySize 
+            || std::memcmp(&data[pos], m_identity.data(), identitySize)) return false;
+        pos += identitySize;
+        if (!read(&numEntries, 4)) return false;
+
+        std::map<std::string, uint64_t> offsets;
+        for (uint32_t i = 0; i < numEntries; ++i)
+        {
+            uint32_t keySize;
+            uint64_t offset;
+            if (!read(&keySize, 4) || end - pos < keySize) return false;
+            std::string key(reinterpret_cast<const char*>(&data[pos]), keySize);
+            pos += keySize;
+            if (!read(&offset, 8)) return false;
+            offsets.emplace(std::move(key), offset);
+        }
+        if (pos != end) return false;
+
+        m_offsets.swap(offsets);
+        m_dirty = false;
+        return true;
+    }
+
+    /**
+     * @brief   Stores the cached results in a file.
+     * @param   path    The path of the file.
+     * @return  @c true if saved, else @c false.
+     *          
+     * The data is written to a temporary file first, which then replaces the target, so readers
+     * never observe a partially written cache.
+     */
+    bool save(const char* path)
+    {
+        if (!isValid()) return false;
+
+        std::vector<uint8_t> data;
+        auto write = [&data](const void* in, std::size_t size)
+        {
+            auto bytes = static_cast<const uint8_t*>(in);
+            data.insert(data.end(), bytes, bytes + size);
+        };
+
+        const uint32_t version = kVersion;
+        const auto identitySize = static_cast<uint32_t>(m_identity.size());
+        const auto numEntries = static_cast<uint32_t>(m_offsets.size());
+        write("RMSC", 4);
+        write(&version, 4);
+        write(&identitySize, 4);
+        write(m_identity.data(), m_identity.size());
+        write(&numEntries, 4);
+        for (const auto& cur : m_offsets)
+        {
+            const auto keySize = static_cast<uint32_t>(cur.first.size());
+            write(&keySize, 4);
+            write(cur.first.data(), cur.first.size());
+            write(&cur.second, 8);
+        }
+        const uint32_t sum = checksum(data.data(), data.size());
+        write(&sum, 4);
+
+        const std::string tmpPath = std::string{path} + ".tmp";
+        auto file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) return false;
+        const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (std::fclose(file) != 0 || !written)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            const bool replaced = 
+                MoveFileExA(tmpPath.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#       else
+            const bool replaced = std::rename(tmpPath.c_str(), path) == 0;
+#       endif
+        if (!replaced)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+        m_dirty = false;
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_SIGNATURECACHE_HPP
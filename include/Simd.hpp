@@ -0,0 +1,1008 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_SIMD_HPP
+#define REMODEL_SIMD_HPP
+
+/**
+ * @file
+ * @brief Contains vectorized kernels used for bulk field access, byte order conversion and
+ *        buffer comparison.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX__) || defined(__AVX2__) || defined(__AVX512F__)
+#   include <immintrin.h>
+#elif defined(__SSSE3__)
+#   include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define REMODEL_SIMD_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#   include <stdlib.h>
+#   include <intrin.h>
+#endif
+
+#if defined(__GNUC__)
+#   define REMODEL_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64))
+#   include <xmmintrin.h>
+#   define REMODEL_PREFETCH(address) \
+        _mm_prefetch(static_cast<const char*>(static_cast<const void*>(address)), _MM_HINT_T0)
+#else
+#   define REMODEL_PREFETCH(address) ((void)(address))
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#   define REMODEL_BIG_ENDIAN_HOST
+#endif
+
+namespace remodel
+{
+namespace simd
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [gatherStrided] + [scatterStrided] helpers                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Scalar kernel, also handling the tails of the vectorized kernels.
+ * @tparam  T   The element type.
+ */
+template<typename T>
+struct ScalarKernel
+{
+    static void gather(T* out, const uint8_t* first, std::size_t stride, std::size_t count)
+    {
+        std::size_t i = 0;
+        // Unrolled, so the loads of independent elements can be issued back to back.
+        for (; i + 4 <= count; i += 4, first += 4 * stride)
+        {
+            std::memcpy(out + i + 0, first + 0 * stride, sizeof(T));
+            std::memcpy(out + i + 1, first + 1 * stride, sizeof(T));
+            std::memcpy(out + i + 2, first + 2 * stride, sizeof(T));
+            std::memcpy(out + i + 3, first + 3 * stride, sizeof(T));
+        }
+        for (; i < count; ++i, first += stride)
+        {
+            std::memcpy(out + i, first, sizeof(T));
+        }
+    }
+
+    static void scatter(uint8_t* first, std::size_t stride, const T* in, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4, first += 4 * stride)
+        {
+            std::memcpy(first + 0 * stride, in + i + 0, sizeof(T));
+            std::memcpy(first + 1 * stride, in + i + 1, sizeof(T));
+            std::memcpy(first + 2 * stride, in + i + 2, sizeof(T));
+            std::memcpy(first + 3 * stride, in + i + 3, sizeof(T));
+        }
+        for (; i < count; ++i, first += stride)
+        {
+            std::memcpy(first, in + i, sizeof(T));
+        }
+    }
+};
+
+/**
+ * @internal
+ * @brief   Kernel selected by element size, falling back to the scalar kernel.
+ * @tparam  T       The element type.
+ * @tparam  sizeT   The size of the element type.
+ */
+template<typename T, std::size_t sizeT = sizeof(T)>
+struct Kernel : ScalarKernel<T> {};
+
+/**
+ * @internal
+ * @brief   Kernel for 4 byte elements.
+ * @copydetails Kernel
+ */
+template<typename T>
+struct Kernel<T, 4>
+{
+    static void gather(T* out, const uint8_t* first, std::size_t stride, std::size_t count)
+    {
+        std::size_t i = 0;
+#       if defined(__AVX2__)
+            // Lane offsets are 32 bit signed integers, so huge strides take the scalar path.
+            if (stride <= INT32_MAX / 8)
+            {
+                const auto s = static_cast<int32_t>(stride);
+                const __m256i idx = _mm256_setr_epi32(
+                    0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+                for (; i + 8 <= count; i += 8, first += 8 * stride)
+                {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_i32gather_epi32(reinterpret_cast<const int*>(first), idx, 1));
+                }
+            }
+#       endif
+        ScalarKernel<T>::gather(out + i, first, stride, count - i);
+    }
+
+    static void scatter(uint8_t* first, std::size_t stride, const T* in, std::size_t count)
+    {
+        std::size_t i = 0;
+#       if defined(__AVX512F__)
+            if (stride <= INT32_MAX / 16)
+            {
+                const auto s = static_cast<int32_t>(stride);
+                const __m512i idx = _mm512_mullo_epi32(_mm512_set1_epi32(s), _mm512_setr_epi32(
+                    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+                for (; i + 16 <= count; i += 16, first += 16 * stride)
+                {
+                    _mm512_i32scatter_epi32(first, idx, _mm512_loadu_si512(in + i), 1);
+                }
+            }
+#       endif
+        ScalarKernel<T>::scatter(first, stride, in + i, count - i);
+    }
+};
+
+/**
+ * @internal
+ * @brief   Kernel for 8 byte elements.
+ * @copydetails Kernel
+ */
+template<typename T>
+struct Kernel<T, 8>
+{
+    static void gather(T* out, const uint8_t* first, std::size_t stride, std::size_t count)
+    {
+        std::size_t i = 0;
+#       if defined(__AVX2__)
+            const auto s = static_cast<long long>(stride);
+            const __m256i idx = _mm256_setr_epi64x(0, s, 2 * s, 3 * s);
+            for (; i + 4 <= count; i += 4, first += 4 * stride)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                    _mm256_i64gather_epi64(reinterpret_cast<const long long*>(first), idx, 1));
+            }
+#       endif
+        ScalarKernel<T>::gather(out + i, first, stride, count - i);
+    }
+
+    static void scatter(uint8_t* first, std::size_t stride, const T* in, std::size_t count)
+    {
+        std::size_t i = 0;
+#       if defined(__AVX512F__)
+            const auto s = static_cast<long long>(stride);
+            const __m512i idx = _mm512_setr_epi64(
+                0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+            for (; i + 8 <= count; i += 8, first += 8 * stride)
+            {
+                _mm512_i64scatter_epi64(first, idx, _mm512_loadu_si512(in + i), 1);
+            }
+#       endif
+        ScalarKernel<T>::scatter(first, stride, in + i, count - i);
+    }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [gatherStrided] + [scatterStrided]                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Copies equally spaced elements into a contiguous buffer.
+ * @tparam  T       The element type, required to be trivially copyable.
+ * @param   out     The destination buffer, at least @c count elements.
+ * @param   first   Pointer to the first element.
+ * @param   stride  The distance between two elements, in bytes.
+ * @param   count   The number of elements.
+ *
+ * Uses hardware gathers (AVX2) for 4 and 8 byte elements where available at compile time.
+ * Other targets (including NEON, which has no gather instructions) use an unrolled scalar loop.
+ */
+template<typename T>
+inline void gatherStrided(T* out, const void* first, std::size_t stride, std::size_t count)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T is required to be trivially copyable");
+    internal::Kernel<T>::gather(out, static_cast<const uint8_t*>(first), stride, count);
+}
+
+/**
+ * @brief   Copies a contiguous buffer to equally spaced elements.
+ * @tparam  T       The element type, required to be trivially copyable.
+ * @param   first   Pointer to the first element.
+ * @param   stride  The distance between two elements, in bytes. Elements must not overlap.
+ * @param   in      The source buffer, at least @c count elements.
+ * @param   count   The number of elements.
+ *
+ * Uses hardware scatters (AVX-512) for 4 and 8 byte elements where available at compile time,
+ * an unrolled scalar loop otherwise.
+ */
+template<typename T>
+inline void scatterStrided(void* first, std::size_t stride, const T* in, std::size_t count)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T is required to be trivially copyable");
+    internal::Kernel<T>::scatter(static_cast<uint8_t*>(first), stride, in, count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [byteSwap] + [byteSwapArray]                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Maps a size to the unsigned integer type of that size.
+ * @tparam  sizeT   The size, in bytes.
+ */
+template<std::size_t sizeT> struct UIntOfSize;
+template<> struct UIntOfSize<1> { using Type = uint8_t;  };
+template<> struct UIntOfSize<2> { using Type = uint16_t; };
+template<> struct UIntOfSize<4> { using Type = uint32_t; };
+template<> struct UIntOfSize<8> { using Type = uint64_t; };
+
+} // namespace internal
+
+/**
+ * @brief   Reverses the byte order of an integer.
+ * @param   value   The integer.
+ * @return  The integer with reversed byte order.
+ *
+ * Compiles to `bswap` (or `movbe`, when loading from or storing to memory on targets supporting
+ * it) on x86, `rev` on ARM.
+ */
+inline uint8_t byteSwap(uint8_t value) { return value; }
+
+/**
+ * @copydoc byteSwap(uint8_t)
+ */
+inline uint16_t byteSwap(uint16_t value)
+{
+#   if defined(_MSC_VER)
+        return _byteswap_ushort(value);
+#   elif defined(__GNUC__)
+        return __builtin_bswap16(value);
+#   else
+        return static_cast<uint16_t>(value << 8 | value >> 8);
+#   endif
+}
+
+/**
+ * @copydoc byteSwap(uint8_t)
+ */
+inline uint32_t byteSwap(uint32_t value)
+{
+#   if defined(_MSC_VER)
+        return _byteswap_ulong(value);
+#   elif defined(__GNUC__)
+        return __builtin_bswap32(value);
+#   else
+        return (value << 24) | ((value << 8) & 0x00FF0000)
+            | ((value >> 8) & 0x0000FF00) | (value >> 24);
+#   endif
+}
+
+/**
+ * @copydoc byteSwap(uint8_t)
+ */
+inline uint64_t byteSwap(uint64_t value)
+{
+#   if defined(_MSC_VER)
+        return _byteswap_uint64(value);
+#   elif defined(__GNUC__)
+        return __builtin_bswap64(value);
+#   else
+        return static_cast<uint64_t>(byteSwap(static_cast<uint32_t>(value))) << 32
+            | byteSwap(static_cast<uint32_t>(value >> 32));
+#   endif
+}
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Kernel reversing the byte order of each element of an array.
+ * @tparam  sizeT   The size of the elements.
+ */
+template<std::size_t sizeT>
+struct SwapKernel
+{
+    static void run(uint8_t* data, std::size_t count)
+    {
+        std::size_t i = 0;
+#       if defined(__SSSE3__)
+            // Byte j of a vector is taken from the mirrored position inside of its element.
+            int8_t order[16];
+            for (int j = 0; j < 16; ++j)
+            {
+                order[j] = static_cast<int8_t>(j / sizeT * sizeT + sizeT - 1 - j % sizeT);
+            }
+            const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(order));
+#           if defined(__AVX2__)
+                // Shuffles operate within 128 bit lanes, so both lanes use the same order.
+                const __m256i shuffle2 = _mm256_broadcastsi128_si256(shuffle);
+                for (; i + 32 / sizeT <= count; i += 32 / sizeT)
+                {
+                    auto vec = reinterpret_cast<__m256i*>(data + i * sizeT);
+                    _mm256_storeu_si256(
+                        vec, _mm256_shuffle_epi8(_mm256_loadu_si256(vec), shuffle2));
+                }
+#           endif
+            for (; i + 16 / sizeT <= count; i += 16 / sizeT)
+            {
+                auto vec = reinterpret_cast<__m128i*>(data + i * sizeT);
+                _mm_storeu_si128(vec, _mm_shuffle_epi8(_mm_loadu_si128(vec), shuffle));
+            }
+#       endif
+        for (; i < count; ++i)
+        {
+            typename UIntOfSize<sizeT>::Type value;
+            std::memcpy(&value, data + i * sizeT, sizeT);
+            value = byteSwap(value);
+            std::memcpy(data + i * sizeT, &value, sizeT);
+        }
+    }
+};
+
+/**
+ * @internal
+ * @brief   Single bytes have no byte order.
+ * @copydetails SwapKernel
+ */
+template<>
+struct SwapKernel<1>
+{
+    static void run(uint8_t*, std::size_t) {}
+};
+
+} // namespace internal
+
+/**
+ * @brief   Reverses the byte order of each element of an array, in place.
+ * @tparam  T       The element type, required to be trivially copyable and 1, 2, 4 or 8 bytes.
+ * @param   data    The elements.
+ * @param   count   The number of elements.
+ *
+ * Uses `pshufb` (SSSE3, AVX2) on 16 or 32 bytes at a time where available at compile time, a
+ * scalar loop of `byteSwap`s otherwise.
+ */
+template<typename T>
+inline void byteSwapArray(T* data, std::size_t count)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T is required to be trivially copyable");
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+        "byte swaps are only supported for elements of 1, 2, 4 or 8 bytes");
+    internal::SwapKernel<sizeof(T)>::run(reinterpret_cast<uint8_t*>(data), count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [countTrailingZeros] + [forEachMismatch]                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Counts the trailing zero bits of a non-zero value.
+ * @param   val The value.
+ * @return  The number of trailing zero bits.
+ */
+inline unsigned countTrailingZeros(uint32_t val)
+{
+#   if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanForward(&idx, val);
+        return idx;
+#   else
+        return static_cast<unsigned>(__builtin_ctz(val));
+#   endif
+}
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines the differing bytes of two blocks of up to 32 bytes.
+ * @param   lhs     The first block.
+ * @param   rhs     The second block.
+ * @param   size    The size of the blocks, in bytes.
+ * @return  Bit @c i set if byte @c i differs.
+ */
+inline uint32_t mismatchMaskScalar(const uint8_t* lhs, const uint8_t* rhs, std::size_t size)
+{
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (lhs[i] != rhs[i]) mask |= uint32_t{1} << i;
+    }
+    return mask;
+}
+
+/**
+ * @internal
+ * @brief   Determines the differing bytes of two blocks of 32 bytes.
+ * @copydetails mismatchMaskScalar
+ */
+inline uint32_t mismatchMask32(const uint8_t* lhs, const uint8_t* rhs)
+{
+#   if defined(__AVX2__)
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs)))));
+#   elif defined(REMODEL_SIMD_SSE2)
+        auto half = [](const uint8_t* a, const uint8_t* b)
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)))));
+        };
+        return ~(half(lhs, rhs) | half(lhs + 16, rhs + 16) << 16);
+#   else
+        // Most blocks are equal, so they are ruled out word-wise first.
+        uint64_t a[4], b[4];
+        std::memcpy(a, lhs, 32);
+        std::memcpy(b, rhs, 32);
+        if (((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0) return 0;
+        return mismatchMaskScalar(lhs, rhs, 32);
+#   endif
+}
+
+} // namespace internal
+
+/**
+ * @brief   Compares two buffers and reports where they differ, in blocks of 32 bytes.
+ * @param   lhs     The first buffer.
+ * @param   rhs     The second buffer.
+ * @param   size    The size of the buffers, in bytes.
+ * @param   func    Called as `func(std::size_t offset, uint32_t mask)` for every block starting
+ *                  at @c offset that contains differing bytes. Bit @c i of @c mask is set if
+ *                  byte `offset + i` differs.
+ *
+ * Uses one compare per 32 bytes (AVX2) or 16 bytes (SSE2) where available at compile time, a
+ * word-wise scalar comparison otherwise. Equal blocks cost no call.
+ */
+template<typename FuncT>
+inline void forEachMismatch(const void* lhs, const void* rhs, std::size_t size, FuncT&& func)
+{
+    auto a = static_cast<const uint8_t*>(lhs);
+    auto b = static_cast<const uint8_t*>(rhs);
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        if (auto mask = internal::mismatchMask32(a + i, b + i)) func(i, mask);
+    }
+    if (i < size)
+    {
+        if (auto mask = internal::mismatchMaskScalar(a + i, b + i, size - i)) func(i, mask);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [forEachWordMatch]                                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   The number of values `forEachWordMatch` compares against in one pass.
+ */
+const std::size_t kWordMatchValues = 4;
+
+/**
+ * @internal
+ * @brief   Compares words against up to `kWordMatchValues` values.
+ * @param   words   The words.
+ * @param   count   The number of words, at most 32.
+ * @param   values  The values, exactly `kWordMatchValues` (duplicates pad shorter lists).
+ * @return  Bit @c i set if word @c i equals one of the values.
+ */
+template<typename WordT>
+inline uint32_t wordMatchMaskScalar(const WordT* words, std::size_t count, const WordT* values)
+{
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto word = words[i];
+        if (word == values[0] || word == values[1] || word == values[2] || word == values[3])
+        {
+            mask |= uint32_t{1} << i;
+        }
+    }
+    return mask;
+}
+
+#if defined(__AVX2__)
+
+/**
+ * @internal
+ * @brief   Compares a block of 256 bits against the values, see `wordMatchMaskScalar`.
+ */
+inline uint32_t wordMatchMask256(const uint64_t* words, const __m256i* values)
+{
+    const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+    const auto eq01 = _mm256_or_si256(
+        _mm256_cmpeq_epi64(block, values[0]), _mm256_cmpeq_epi64(block, values[1]));
+    const auto eq23 = _mm256_or_si256(
+        _mm256_cmpeq_epi64(block, values[2]), _mm256_cmpeq_epi64(block, values[3]));
+    const auto eq = _mm256_or_si256(eq01, eq23);
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+}
+
+/**
+ * @internal
+ * @copydoc wordMatchMask256(const uint64_t*, const __m256i*)
+ */
+inline uint32_t wordMatchMask256(const uint32_t* words, const __m256i* values)
+{
+    const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+    const auto eq01 = _mm256_or_si256(
+        _mm256_cmpeq_epi32(block, values[0]), _mm256_cmpeq_epi32(block, values[1]));
+    const auto eq23 = _mm256_or_si256(
+        _mm256_cmpeq_epi32(block, values[2]), _mm256_cmpeq_epi32(block, values[3]));
+    const auto eq = _mm256_or_si256(eq01, eq23);
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+}
+
+inline __m256i broadcastWord(uint64_t value)
+{
+    return _mm256_set1_epi64x(static_cast<long long>(value));
+}
+
+inline __m256i broadcastWord(uint32_t value)
+{
+    return _mm256_set1_epi32(static_cast<int>(value));
+}
+
+#endif
+
+#if defined(__AVX512F__)
+
+/**
+ * @internal
+ * @brief   Compares a block of 512 bits against the values, see `wordMatchMaskScalar`.
+ */
+inline uint32_t wordMatchMask512(const uint64_t* words, const __m512i* values)
+{
+    const auto block = _mm512_loadu_si512(words);
+    return _mm512_cmpeq_epi64_mask(block, values[0]) | _mm512_cmpeq_epi64_mask(block, values[1])
+        | _mm512_cmpeq_epi64_mask(block, values[2]) | _mm512_cmpeq_epi64_mask(block, values[3]);
+}
+
+/**
+ * @internal
+ * @copydoc wordMatchMask512(const uint64_t*, const __m512i*)
+ */
+inline uint32_t wordMatchMask512(const uint32_t* words, const __m512i* values)
+{
+    const auto block = _mm512_loadu_si512(words);
+    return _mm512_cmpeq_epi32_mask(block, values[0]) | _mm512_cmpeq_epi32_mask(block, values[1])
+        | _mm512_cmpeq_epi32_mask(block, values[2]) | _mm512_cmpeq_epi32_mask(block, values[3]);
+}
+
+inline __m512i broadcastWord512(uint64_t value)
+{
+    return _mm512_set1_epi64(static_cast<long long>(value));
+}
+
+inline __m512i broadcastWord512(uint32_t value)
+{
+    return _mm512_set1_epi32(static_cast<int>(value));
+}
+
+#endif
+
+/**
+ * @internal
+ * @brief   Reports the words equal to one of up to `kWordMatchValues` values.
+ * @copydetails forEachWordMatch
+ */
+template<typename WordT, typename FuncT>
+inline void forEachWordMatchPass(const WordT* words, std::size_t count, const WordT* values,
+    FuncT& func)
+{
+    auto report = [&](std::size_t base, uint32_t mask)
+    {
+        for (; mask; mask &= mask - 1) func(base + countTrailingZeros(mask));
+    };
+
+    std::size_t i = 0;
+#   if defined(__AVX512F__)
+        const std::size_t kPerBlock512 = 64 / sizeof(WordT);
+        const __m512i wide[] = {
+            broadcastWord512(values[0]), broadcastWord512(values[1]),
+            broadcastWord512(values[2]), broadcastWord512(values[3]),
+        };
+        for (; i + kPerBlock512 <= count; i += kPerBlock512)
+        {
+            if (auto mask = wordMatchMask512(words + i, wide)) report(i, mask);
+        }
+#   endif
+#   if defined(__AVX2__)
+        const std::size_t kPerBlock256 = 32 / sizeof(WordT);
+        const __m256i broad[] = {
+            broadcastWord(values[0]), broadcastWord(values[1]),
+            broadcastWord(values[2]), broadcastWord(values[3]),
+        };
+        for (; i + kPerBlock256 <= count; i += kPerBlock256)
+        {
+            if (auto mask = wordMatchMask256(words + i, broad)) report(i, mask);
+        }
+#   endif
+    for (; i < count; i += 32)
+    {
+        // MSVC12 requires parentheses here (min macro).
+        const auto num = (std::min)(count - i, std::size_t{32});
+        if (auto mask = wordMatchMaskScalar(words + i, num, values)) report(i, mask);
+    }
+}
+
+} // namespace internal
+
+/**
+ * @brief   Finds the words of a buffer equal to any of a set of values.
+ * @tparam  WordT       The word type, `uint32_t` or `uint64_t`.
+ * @param   words       The words.
+ * @param   count       The number of words.
+ * @param   values      The values to look for.
+ * @param   numValues   The number of values.
+ * @param   func        Called as `func(std::size_t index)` for every matching word, in ascending
+ *                      order per group of 4 values.
+ *
+ * Compares 8 (AVX-512) or 4 (AVX2) 64-bit words at once against 4 values each, where available
+ * at compile time, word by word otherwise. Values beyond the first 4 take additional passes.
+ */
+template<typename WordT, typename FuncT>
+inline void forEachWordMatch(const WordT* words, std::size_t count, const WordT* values,
+    std::size_t numValues, FuncT&& func)
+{
+    static_assert(std::is_same<WordT, uint32_t>::value || std::is_same<WordT, uint64_t>::value,
+        "only 32 and 64 bit words are supported");
+
+    for (std::size_t first = 0; first < numValues; first += internal::kWordMatchValues)
+    {
+        // Shorter groups are padded with their first value.
+        WordT group[internal::kWordMatchValues];
+        for (std::size_t i = 0; i < internal::kWordMatchValues; ++i)
+        {
+            group[i] = values[first + i < numValues ? first + i : first];
+        }
+        internal::forEachWordMatchPass(words, count, group, func);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [compareMask]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Comparisons supported by `compareMask`.
+ */
+enum class CompareOp
+{
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Branch-free scalar kernel of `compareMask`, which compilers may vectorize themselves.
+ */
+template<typename T, typename PredT>
+inline uint64_t compareMaskScalar(const T* values, std::size_t count, const PredT& pred)
+{
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        mask |= uint64_t{pred(values[i])} << i;
+    }
+    return mask;
+}
+
+/**
+ * @internal
+ * @brief   Scalar `compareMask`, also handling the tails of the vectorized kernels.
+ */
+template<typename T>
+inline uint64_t compareMaskScalar(const T* values, std::size_t count, CompareOp op, T value)
+{
+    switch (op)
+    {
+        case CompareOp::Less:
+            return compareMaskScalar(values, count, [value](T cur) { return cur < value; });
+        case CompareOp::LessEqual:
+            return compareMaskScalar(values, count, [value](T cur) { return cur <= value; });
+        case CompareOp::Greater:
+            return compareMaskScalar(values, count, [value](T cur) { return cur > value; });
+        case CompareOp::GreaterEqual:
+            return compareMaskScalar(values, count, [value](T cur) { return cur >= value; });
+        case CompareOp::Equal:
+            return compareMaskScalar(values, count, [value](T cur) { return cur == value; });
+        case CompareOp::NotEqual:
+            return compareMaskScalar(values, count, [value](T cur) { return cur != value; });
+    }
+    return 0;
+}
+
+/**
+ * @internal
+ * @brief   Kernel selected by element type, falling back to the scalar kernel.
+ */
+template<typename T>
+struct CompareKernel
+{
+    static uint64_t run(const T* values, std::size_t count, CompareOp op, T value)
+    {
+        return compareMaskScalar(values, count, op, value);
+    }
+};
+
+#if defined(REMODEL_SIMD_SSE2)
+
+/**
+ * @internal
+ * @brief   Kernel for `int32_t` elements, comparing four at a time.
+ */
+template<>
+struct CompareKernel<int32_t>
+{
+    static uint64_t run(const int32_t* values, std::size_t count, CompareOp op, int32_t value)
+    {
+        const __m128i rhs = _mm_set1_epi32(value);
+        // Less-equal, greater-equal and not-equal are the inverted opposites.
+        const bool invert = op == CompareOp::LessEqual || op == CompareOp::GreaterEqual 
+            || op == CompareOp::NotEqual;
+
+        uint64_t mask = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i cmp;
+            switch (op)
+            {
+                case CompareOp::Less:
+                case CompareOp::GreaterEqual:
+                    cmp = _mm_cmplt_epi32(lhs, rhs);
+                    break;
+                case CompareOp::Greater:
+                case CompareOp::LessEqual:
+                    cmp = _mm_cmpgt_epi32(lhs, rhs);
+                    break;
+                default:
+                    cmp = _mm_cmpeq_epi32(lhs, rhs);
+                    break;
+            }
+            const auto bits = static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(cmp)));
+            mask |= (invert ? bits ^ 0xF : bits) << i;
+        }
+        if (i < count) mask |= compareMaskScalar(values + i, count - i, op, value) << i;
+        return mask;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Kernel for `float` elements, comparing four at a time.
+ */
+template<>
+struct CompareKernel<float>
+{
+    static uint64_t run(const float* values, std::size_t count, CompareOp op, float value)
+    {
+        const __m128 rhs = _mm_set1_ps(value);
+        uint64_t mask = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 lhs = _mm_loadu_ps(values + i);
+            __m128 cmp;
+            switch (op)
+            {
+                case CompareOp::Less:         cmp = _mm_cmplt_ps (lhs, rhs); break;
+                case CompareOp::LessEqual:    cmp = _mm_cmple_ps (lhs, rhs); break;
+                case CompareOp::Greater:      cmp = _mm_cmpgt_ps (lhs, rhs); break;
+                case CompareOp::GreaterEqual: cmp = _mm_cmpge_ps (lhs, rhs); break;
+                case CompareOp::Equal:        cmp = _mm_cmpeq_ps (lhs, rhs); break;
+                default:                      cmp = _mm_cmpneq_ps(lhs, rhs); break;
+            }
+            mask |= static_cast<uint64_t>(_mm_movemask_ps(cmp)) << i;
+        }
+        if (i < count) mask |= compareMaskScalar(values + i, count - i, op, value) << i;
+        return mask;
+    }
+};
+
+#endif // REMODEL_SIMD_SSE2
+
+} // namespace internal
+
+/**
+ * @brief   Compares contiguous values with a constant and collects the results in a bitmask.
+ * @tparam  T       The element type, arithmetic or an enum.
+ * @param   values  The values.
+ * @param   count   The number of values, at most 64.
+ * @param   op      The comparison, `values[i] op value`.
+ * @param   value   The constant to compare with.
+ * @return  The bitmask, bit @c i set if `values[i]` satisfies the comparison.
+ *
+ * Uses SSE2 for `int32_t` and `float` elements where available, a branch-free scalar loop for 
+ * other types.
+ */
+template<typename T>
+inline uint64_t compareMask(const T* values, std::size_t count, CompareOp op, T value)
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, 
+        "only arithmetic values can be compared");
+    assert(count <= 64);
+    return internal::CompareKernel<T>::run(values, count, op, value);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [prefetchRange]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The assumed size of a cache line, in bytes.
+ */
+const std::size_t kCacheLineSize = 64;
+
+/**
+ * @brief   Issues software prefetches for all cache lines of a range.
+ * @param   ptr     The start of the range.
+ * @param   size    The size of the range, in bytes.
+ */
+inline void prefetchRange(const void* ptr, std::size_t size)
+{
+    const auto end = reinterpret_cast<uintptr_t>(ptr) + size;
+    auto line = reinterpret_cast<uintptr_t>(ptr) & ~(kCacheLineSize - 1);
+    for (; line < end; line += kCacheLineSize)
+    {
+        REMODEL_PREFETCH(reinterpret_cast<const void*>(line));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [Vec4f]                                                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Portable vector of four floats, laid out like `float[4]` and `__m128`.
+ *
+ * Aligned to 16 bytes, so plain fields of this type are read and written by single aligned
+ * vector moves. Vectors that aren't aligned in the target are accessed using
+ * `access::Unaligned`, which makes them single unaligned moves instead. The operators work
+ * element-wise, using SSE where available.
+ *
+ * @code
+ *     class Transform : public AdvancedClassWrapper<48, 16>
+ *     {
+ *         REMODEL_ADV_WRAPPER(Transform)
+ *     public:
+ *         Field<simd::Vec4f> position{this, 0};
+ *         Field<simd::Vec4f> scale   {this, 16};
+ *     };
+ *
+ *     transform.position += velocity * dt;
+ * @endcode
+ */
+struct alignas(16) Vec4f
+{
+    float v[4];
+
+    float& operator [] (std::size_t idx) { return v[idx]; }
+    const float& operator [] (std::size_t idx) const { return v[idx]; }
+
+#   if defined(REMODEL_SIMD_SSE2)
+    /**
+     * @brief   Converts an SSE vector.
+     * @param   value   The SSE vector.
+     * @return  The vector.
+     */
+    static Vec4f fromNative(__m128 value)
+    {
+        Vec4f result;
+        _mm_store_ps(result.v, value);
+        return result;
+    }
+
+    /**
+     * @brief   Converts the vector to an SSE vector.
+     * @return  The SSE vector.
+     */
+    __m128 toNative() const { return _mm_load_ps(v); }
+#   endif
+
+    /**
+     * @brief   Creates a vector with all elements set to a value.
+     * @param   value   The value.
+     * @return  The vector.
+     */
+    static Vec4f broadcast(float value) { return {{value, value, value, value}}; }
+
+#   if defined(REMODEL_SIMD_SSE2)
+#       define REMODEL_VEC4F_OPERATOR(op, intrinsic)                                               \
+        friend Vec4f operator op (const Vec4f& lhs, const Vec4f& rhs)                              \
+        {                                                                                          \
+            return fromNative(intrinsic(lhs.toNative(), rhs.toNative()));                          \
+        }
+#   else
+#       define REMODEL_VEC4F_OPERATOR(op, intrinsic)                                               \
+        friend Vec4f operator op (const Vec4f& lhs, const Vec4f& rhs)                              \
+        {                                                                                          \
+            return {{lhs.v[0] op rhs.v[0], lhs.v[1] op rhs.v[1],                                   \
+                lhs.v[2] op rhs.v[2], lhs.v[3] op rhs.v[3]}};                                      \
+        }
+#   endif
+
+    REMODEL_VEC4F_OPERATOR(+, _mm_add_ps)
+    REMODEL_VEC4F_OPERATOR(-, _mm_sub_ps)
+    REMODEL_VEC4F_OPERATOR(*, _mm_mul_ps)
+    REMODEL_VEC4F_OPERATOR(/, _mm_div_ps)
+
+#   undef REMODEL_VEC4F_OPERATOR
+
+    friend Vec4f operator * (const Vec4f& lhs, float rhs) { return lhs * broadcast(rhs); }
+    friend Vec4f operator / (const Vec4f& lhs, float rhs) { return lhs / broadcast(rhs); }
+
+    Vec4f& operator += (const Vec4f& rhs) { return *this = *this + rhs; }
+    Vec4f& operator -= (const Vec4f& rhs) { return *this = *this - rhs; }
+    Vec4f& operator *= (const Vec4f& rhs) { return *this = *this * rhs; }
+    Vec4f& operator /= (const Vec4f& rhs) { return *this = *this / rhs; }
+    Vec4f& operator *= (float rhs) { return *this = *this * rhs; }
+    Vec4f& operator /= (float rhs) { return *this = *this / rhs; }
+};
+
+static_assert(sizeof(Vec4f) == 16 && std::is_trivial<Vec4f>::value, "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace simd
+} // namespace remodel
+
+#endif // REMODEL_SIMD_HPP
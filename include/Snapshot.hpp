@@ -0,0 +1,1696 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_SNAPSHOT_HPP
+#define REMODEL_SNAPSHOT_HPP
+
+/**
+ * @file
+ * @brief Contains a binary snapshot format for graphs of wrapped objects.
+ *
+ * A snapshot holds the bytes of every object reachable from a set of roots plus the links
+ * between them. Links are stored as offsets into the file, so snapshots can be loaded by mapping
+ * the file and pointing wrappers right into the mapping, e.g. to replay production states in
+ * tests without a live target:
+ * @code
+ *     SnapshotBuilder<Entity> builder{game};
+ *     builder.capture(world.firstEntity, &Entity::next, &Entity::target);
+ *     builder.save("world.snap");
+ *
+ *     SnapshotFile<Entity> snap{"world.snap"};
+ *     for (std::size_t i = 0; i < snap.size(); ++i) std::cout << snap.object(i).health << '\n';
+ * @endcode
+ *
+ * Consecutive snapshots can be compared field by field with `diff`, which also keeps indexes of
+ * the objects by key (`SnapshotHashIndex`, `SnapshotSortedIndex`) up to date.
+ *
+ * Large snapshots can be saved compressed in blocks of 64 KiB and opened with
+ * `CompressedSnapshotFile`, which decompresses only the blocks of the objects accessed.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Memory.hpp"
+#include "Parallel.hpp"
+#include "Platform.hpp"
+#include "Simd.hpp"
+
+namespace remodel
+{
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Constants of the snapshot file format.
+ */
+struct SnapshotFormat
+{
+    static const uint32_t kVersion = 1;
+    static const std::size_t kHeaderSize = 64;
+    static const std::size_t kBlockSize = 0x10000;
+
+    /**
+     * @brief   Determines the distance of the objects in a snapshot.
+     * @tparam  WrapperT    Wrapper type of the objects.
+     */
+    template<typename WrapperT>
+    struct Stride
+    {
+        static const std::size_t kAlign = WrapperT::kObjAlign > 8 ? WrapperT::kObjAlign : 8;
+        static_assert(kAlign <= kHeaderSize, "objects aligned above the header size unsupported");
+        static const std::size_t kValue = (WrapperT::kObjSize + kAlign - 1) / kAlign * kAlign;
+        static const std::size_t kBlockObjects = kValue < kBlockSize ? kBlockSize / kValue : 1;
+    };
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [lz4]                                                                                          //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Compresses data into the LZ4 block format.
+ * @param   src     The data.
+ * @param   size    The size of the data, in bytes.
+ * @param   out     Receives the compressed data, appended.
+ *
+ * A greedy single-pass compressor, the output can be decompressed by any LZ4 implementation
+ * (e.g. `LZ4_decompress_safe`).
+ */
+inline void lz4Compress(const uint8_t* src, std::size_t size, std::vector<uint8_t>& out)
+{
+    const std::size_t kMinMatch = 4, kLastLiterals = 5, kMatchFindLimit = 12;
+    auto read32 = [src](std::size_t pos)
+    {
+        uint32_t value;
+        std::memcpy(&value, src + pos, sizeof(value));
+        return value;
+    };
+    auto putLength = [&out](std::size_t length)
+    {
+        for (; length >= 255; length -= 255) out.push_back(255);
+        out.push_back(static_cast<uint8_t>(length));
+    };
+    auto putLiterals = [&](std::size_t first, std::size_t end, uint8_t matchNibble)
+    {
+        const std::size_t length = end - first;
+        out.push_back(static_cast<uint8_t>((length < 15 ? length : 15) << 4 | matchNibble));
+        if (length >= 15) putLength(length - 15);
+        out.insert(out.end(), src + first, src + end);
+    };
+
+    std::vector<uint32_t> table(0x1000);
+    std::size_t anchor = 0, pos = 0;
+    while (size >= kMatchFindLimit && pos <= size - kMatchFindLimit)
+    {
+        const uint32_t sequence = read32(pos);
+        auto& entry = table[(sequence * 2654435761u) >> 20];
+        const std::size_t candidate = entry;
+        entry = static_cast<uint32_t>(pos);
+        if (candidate >= pos || pos - candidate > 0xFFFF || read32(candidate) != sequence)
+        {
+            ++pos;
+            continue;
+        }
+
+        std::size_t length = kMinMatch;
+        while (pos + length < size - kLastLiterals && src[candidate + length] == src[pos + length])
+        {
+            ++length;
+        }
+
+        const std::size_t matchLength = length - kMinMatch;
+        putLiterals(anchor, pos, static_cast<uint8_t>(matchLength < 15 ? matchLength : 15));
+        const auto offset = static_cast<uint16_t>(pos - candidate);
+        out.push_back(static_cast<uint8_t>(offset));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchLength >= 15) putLength(matchLength - 15);
+
+        pos += length;
+        anchor = pos;
+    }
+    putLiterals(anchor, size, 0);
+}
+
+/**
+ * @internal
+ * @brief   Decompresses data in the LZ4 block format.
+ * @param   src     The compressed data.
+ * @param   srcSize The size of the compressed data, in bytes.
+ * @param   dst     Receives the data.
+ * @param   dstSize The size of the data, in bytes.
+ * @return  @c true on success, @c false if the compressed data is malformed or doesn't
+ *          decompress to exactly @c dstSize bytes.
+ */
+inline bool lz4Decompress(const uint8_t* src, std::size_t srcSize, uint8_t* dst,
+    std::size_t dstSize)
+{
+    const uint8_t* const srcEnd = src + srcSize;
+    std::size_t pos = 0;
+    auto getLength = [&](std::size_t length, std::size_t& result)
+    {
+        if (length == 15)
+        {
+            uint8_t byte;
+            do
+            {
+                if (src == srcEnd) return false;
+                byte = *src++;
+                length += byte;
+            } while (byte == 255);
+        }
+        result = length;
+        return true;
+    };
+
+    while (src != srcEnd)
+    {
+        const uint8_t token = *src++;
+        std::size_t length;
+        if (!getLength(token >> 4, length)) return false;
+        if (length > static_cast<std::size_t>(srcEnd - src) || length > dstSize - pos)
+        {
+            return false;
+        }
+        std::memcpy(dst + pos, src, length);
+        src += length;
+        pos += length;
+
+        // The last sequence consists of literals only.
+        if (src == srcEnd) break;
+
+        if (srcEnd - src < 2) return false;
+        const std::size_t offset = src[0] | static_cast<std::size_t>(src[1]) << 8;
+        src += 2;
+        if (!offset || offset > pos) return false;
+        if (!getLength(token & 0xF, length)) return false;
+        length += 4;
+        if (length > dstSize - pos) return false;
+
+        // Matches may overlap the bytes they produce, so they are copied byte by byte.
+        for (std::size_t i = 0; i < length; ++i, ++pos)
+        {
+            dst[pos] = dst[pos - offset];
+        }
+    }
+    return pos == dstSize;
+}
+
+/**
+ * @internal
+ * @brief   Determines the position of a link field inside of an object.
+ * @param   reader  A wrapper that is rebound to the object.
+ * @param   link    The pointer field.
+ * @param   node    The object.
+ * @return  The offset of the field, in bytes.
+ */
+template<typename WrapperT, typename FieldT>
+inline std::ptrdiff_t linkSlot(WrapperT& reader, FieldT WrapperT::* link, uint8_t* node)
+{
+    reader.rebind(node);
+    static_assert(std::is_pointer<std::remove_pointer_t<decltype(
+        (reader.*link).addressOfObj())>>::value, "links are required to be pointer fields");
+    return static_cast<const uint8_t*>(static_cast<const void*>(
+        (reader.*link).addressOfObj())) - node;
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [SnapshotBuilder]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The ways objects can be stored in a snapshot file.
+ */
+enum class SnapshotCompression
+{
+    /**
+     * @brief   Objects are stored as they are, the file is opened with `SnapshotFile`.
+     */
+    None,
+    /**
+     * @brief   Objects are stored in LZ4 compressed blocks, the file is opened with
+     *          `CompressedSnapshotFile`.
+     */
+    Lz4,
+};
+
+/**
+ * @brief   Captures graphs of objects from a memory backend into a snapshot.
+ * @tparam  WrapperT    Wrapper type of the objects, required to be derived from
+ *                      `AdvancedClassWrapper`.
+ *
+ * Objects are discovered by following the link fields passed to `capture`, level by level, and
+ * every level is read with a single `ReadBatch`. Objects reachable through several links or
+ * roots are stored once, so shared and cyclic links are preserved. Pointer fields that are not
+ * passed as links are stored as they are and still refer to the captured address space.
+ *
+ * File layout (host byte order):
+ * @code
+ *  char     magic[4];              // "RMGS"
+ *  uint32_t version;
+ *  uint64_t objSize;
+ *  uint64_t stride;                // objSize rounded up to the object alignment, at least 8
+ *  uint64_t numObjects;
+ *  uint64_t numEdges;
+ *  uint64_t numRoots;
+ *  uint8_t  padding[16];
+ *  uint8_t  objects[numObjects][stride];   // at offset 64
+ *  uint64_t sources[numObjects];           // addresses in the captured address space
+ *  uint64_t edges[numEdges];               // file offsets of link fields
+ *  uint64_t roots[numRoots];               // indices of the root objects
+ * @endcode
+ * Link fields listed in `edges` hold the file offset of the object they point to.
+ *
+ * Compressed snapshots (`SnapshotCompression::Lz4`) start with the magic "RMGZ" and store the
+ * number of objects per block at header offset 48. The object area is split into blocks of
+ * whole objects, about 64 KiB each, which are compressed independently. The tables follow as
+ * one more block, with every entry stored as the difference to the previous one:
+ * @code
+ *  uint8_t  header[64];
+ *  uint64_t blocks[numBlocks + 2];         // file offsets of the blocks and tables, plus the end
+ *  uint8_t  data[];                        // blocks are stored raw if they don't compress
+ * @endcode
+ * Link fields and `edges` hold offsets in the uncompressed layout, as above.
+ */
+template<typename WrapperT>
+class SnapshotBuilder
+{
+    static const std::size_t kStride = internal::SnapshotFormat::Stride<WrapperT>::kValue;
+
+    struct Edge
+    {
+        // The offset of the link field in `m_objects`.
+        std::size_t slot;
+        std::size_t target;
+    };
+
+    MemoryBackend* m_memory;
+    std::vector<uint8_t> m_objects;
+    std::vector<uintptr_t> m_sources;
+    std::unordered_map<uintptr_t, std::size_t> m_indices;
+    std::vector<Edge> m_edges;
+    std::vector<std::size_t> m_roots;
+
+    std::size_t intern(uintptr_t address, std::vector<std::size_t>& pending)
+    {
+        auto it = m_indices.find(address);
+        if (it != m_indices.end()) return it->second;
+
+        const std::size_t index = m_sources.size();
+        m_indices.emplace(address, index);
+        m_sources.push_back(address);
+        pending.push_back(index);
+        return index;
+    }
+
+    template<typename FieldT>
+    bool follow(WrapperT& reader, std::size_t index, FieldT WrapperT::* link,
+        std::vector<std::size_t>& pending)
+    {
+        auto node = m_objects.data() + index * kStride;
+        const auto slot = internal::linkSlot(reader, link, node);
+        if (slot < 0 || static_cast<std::size_t>(slot) + sizeof(void*) > WrapperT::kObjSize)
+        {
+            return false;
+        }
+
+        uintptr_t target;
+        std::memcpy(&target, node + slot, sizeof(target));
+        if (target)
+        {
+            m_edges.push_back({index * kStride + slot, intern(target, pending)});
+        }
+        return true;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   memory  The memory backend to read the objects from.
+     */
+    explicit SnapshotBuilder(MemoryBackend& memory)
+        : m_memory{&memory}
+    {}
+
+    /**
+     * @brief   Captures an object and all objects reachable from it.
+     * @param   root    The address of the object.
+     * @param   first   The first field pointing to another object, e.g. `&Entity::next`.
+     * @param   rest    The other fields pointing to other objects.
+     * @return  @c true on success, @c false if @c root is null or an object could not be read.
+     *          After a failure, the builder should be discarded.
+     *
+     * Can be called repeatedly to add more roots, objects already captured are not read again.
+     */
+    template<typename FirstT, typename... RestT>
+    bool capture(uintptr_t root, FirstT WrapperT::* first, RestT WrapperT::*... rest)
+    {
+        if (!root) return false;
+
+        std::vector<std::size_t> level, pending;
+        m_roots.push_back(intern(root, level));
+
+        ReadBatch batch{*m_memory};
+        auto reader = wrapper_cast<WrapperT>(m_objects.data());
+        while (!level.empty())
+        {
+            // Growing the storage moves it, so it is resized before queueing the reads.
+            m_objects.resize(m_sources.size() * kStride);
+            batch.clear();
+            for (auto index : level)
+            {
+                batch.add(m_sources[index], m_objects.data() + index * kStride,
+                    WrapperT::kObjSize);
+            }
+            if (!batch.submit()) return false;
+
+            pending.clear();
+            for (auto index : level)
+            {
+                bool results[] = {
+                    follow(reader, index, first, pending), follow(reader, index, rest, pending)...
+                };
+                for (auto result : results)
+                {
+                    if (!result) return false;
+                }
+            }
+            level.swap(pending);
+        }
+        return true;
+    }
+
+    /**
+     * @copydoc capture
+     */
+    template<typename FirstT, typename... RestT>
+    bool capture(const void* root, FirstT WrapperT::* first, RestT WrapperT::*... rest)
+    {
+        return capture(reinterpret_cast<uintptr_t>(root), first, rest...);
+    }
+
+    /**
+     * @brief   Gets the number of objects captured.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_sources.size(); }
+
+    /**
+     * @brief   Gets the number of links between the objects captured.
+     * @return  The number of links.
+     */
+    std::size_t numEdges() const { return m_edges.size(); }
+
+    /**
+     * @brief   Serializes the snapshot.
+     * @param   compression How to store the objects.
+     * @return  The contents of a snapshot file.
+     */
+    std::vector<uint8_t> serialize(SnapshotCompression compression = SnapshotCompression::None)
+        const
+    {
+        if (compression == SnapshotCompression::Lz4) return serializeCompressed();
+
+        const std::size_t objectsEnd = internal::SnapshotFormat::kHeaderSize + m_objects.size();
+        std::vector<uint8_t> data(objectsEnd
+            + (m_sources.size() + m_edges.size() + m_roots.size()) * sizeof(uint64_t));
+
+        std::memcpy(data.data(), "RMGS", 4);
+        const uint32_t version = internal::SnapshotFormat::kVersion;
+        const uint64_t header[] = {
+            WrapperT::kObjSize, kStride, m_sources.size(), m_edges.size(), m_roots.size()
+        };
+        std::memcpy(data.data() + 4, &version, sizeof(version));
+        std::memcpy(data.data() + 8, header, sizeof(header));
+        if (!m_objects.empty())
+        {
+            std::memcpy(data.data() + internal::SnapshotFormat::kHeaderSize, m_objects.data(),
+                m_objects.size());
+        }
+
+        auto table = data.data() + objectsEnd;
+        auto put = [&table](uint64_t value)
+        {
+            std::memcpy(table, &value, sizeof(value));
+            table += sizeof(value);
+        };
+        for (auto source : m_sources) put(source);
+        for (const auto& edge : m_edges)
+        {
+            const uint64_t slot = internal::SnapshotFormat::kHeaderSize + edge.slot;
+            const uintptr_t target = internal::SnapshotFormat::kHeaderSize
+                + edge.target * kStride;
+            std::memcpy(data.data() + slot, &target, sizeof(target));
+            put(slot);
+        }
+        for (auto root : m_roots) put(root);
+        return data;
+    }
+
+    /**
+     * @brief   Writes the snapshot to a file.
+     * @param   path        The path of the file, replaced if existing.
+     * @param   compression How to store the objects.
+     * @return  @c true on success, else @c false.
+     */
+    bool save(const char* path, SnapshotCompression compression = SnapshotCompression::None) const
+    {
+        const auto data = serialize(compression);
+        const std::string tmpPath = std::string{path} + ".tmp";
+        auto file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) return false;
+        const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (std::fclose(file) != 0 || !written)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            const bool replaced =
+                MoveFileExA(tmpPath.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#       else
+            const bool replaced = std::rename(tmpPath.c_str(), path) == 0;
+#       endif
+        if (!replaced) std::remove(tmpPath.c_str());
+        return replaced;
+    }
+private:
+    std::vector<uint8_t> serializeCompressed() const
+    {
+        using Format = internal::SnapshotFormat;
+        const std::size_t blockBytes = Format::Stride<WrapperT>::kBlockObjects * kStride;
+        const std::size_t numBlocks = (m_objects.size() + blockBytes - 1) / blockBytes;
+
+        // Links are stored as offsets in the uncompressed layout, just like in plain snapshots.
+        auto objects = m_objects;
+        for (const auto& edge : m_edges)
+        {
+            const uintptr_t target = Format::kHeaderSize + edge.target * kStride;
+            std::memcpy(objects.data() + edge.slot, &target, sizeof(target));
+        }
+
+        // Addresses and offsets mostly grow by a constant, which makes their deltas compress well.
+        std::vector<uint64_t> tables;
+        tables.reserve(m_sources.size() + m_edges.size() + m_roots.size());
+        tables.insert(tables.end(), m_sources.begin(), m_sources.end());
+        for (const auto& edge : m_edges) tables.push_back(Format::kHeaderSize + edge.slot);
+        tables.insert(tables.end(), m_roots.begin(), m_roots.end());
+        for (std::size_t i = tables.size(); i-- > 1;) tables[i] -= tables[i - 1];
+
+        std::vector<std::vector<uint8_t>> blocks(numBlocks + 1);
+        internal::parallelForChunks(numBlocks + 1, 0, [&](std::size_t block)
+        {
+            const auto first = block < numBlocks ? objects.data() + block * blockBytes
+                : reinterpret_cast<const uint8_t*>(tables.data());
+            const auto size = block < numBlocks
+                ? (std::min)(blockBytes, objects.size() - block * blockBytes)
+                : tables.size() * sizeof(uint64_t);
+            internal::lz4Compress(first, size, blocks[block]);
+            if (blocks[block].size() >= size) blocks[block].assign(first, first + size);
+        });
+
+        std::vector<uint8_t> data(Format::kHeaderSize);
+        std::memcpy(data.data(), "RMGZ", 4);
+        const uint32_t version = Format::kVersion;
+        const uint64_t header[] = {
+            WrapperT::kObjSize, kStride, m_sources.size(), m_edges.size(), m_roots.size(),
+            Format::Stride<WrapperT>::kBlockObjects
+        };
+        std::memcpy(data.data() + 4, &version, sizeof(version));
+        std::memcpy(data.data() + 8, header, sizeof(header));
+
+        auto put = [&data](uint64_t value)
+        {
+            const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            data.insert(data.end(), bytes, bytes + sizeof(value));
+        };
+        uint64_t offset = Format::kHeaderSize + (numBlocks + 2) * sizeof(uint64_t);
+        for (const auto& block : blocks)
+        {
+            put(offset);
+            offset += block.size();
+        }
+        put(offset);
+        data.reserve(static_cast<std::size_t>(offset));
+        for (const auto& block : blocks) data.insert(data.end(), block.begin(), block.end());
+        return data;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [SnapshotFile]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A snapshot file written by `SnapshotBuilder`, mapped into memory.
+ * @tparam  WrapperT    Wrapper type of the objects.
+ *
+ * The file is mapped copy-on-write and the links are rewritten from file offsets to pointers
+ * into the mapping, so wrappers returned by `object` and `root` can follow links like those of
+ * live objects. Only pages containing links are touched while loading, which keeps loading large
+ * snapshots cheap. Changes to the objects are private to the mapping.
+ */
+template<typename WrapperT>
+class SnapshotFile : public zycore::NonCopyable
+{
+    static const std::size_t kStride = internal::SnapshotFormat::Stride<WrapperT>::kValue;
+
+    platform::MappedFile m_file;
+    std::size_t m_numObjects = 0;
+    std::size_t m_numRoots = 0;
+    const uint8_t* m_sources = nullptr;
+    const uint8_t* m_roots = nullptr;
+
+    uint8_t* objectData(std::size_t idx) const
+    {
+        return static_cast<uint8_t*>(m_file.data) + internal::SnapshotFormat::kHeaderSize
+            + idx * kStride;
+    }
+
+    static uint64_t load(const uint8_t* table, std::size_t idx)
+    {
+        uint64_t value;
+        std::memcpy(&value, table + idx * sizeof(value), sizeof(value));
+        return value;
+    }
+
+    bool parse()
+    {
+        auto data = static_cast<uint8_t*>(m_file.data);
+        const std::size_t size = m_file.size;
+        if (size < internal::SnapshotFormat::kHeaderSize || std::memcmp(data, "RMGS", 4) != 0)
+        {
+            return false;
+        }
+
+        uint32_t version;
+        uint64_t header[5];
+        std::memcpy(&version, data + 4, sizeof(version));
+        std::memcpy(header, data + 8, sizeof(header));
+        if (version != internal::SnapshotFormat::kVersion || header[0] != WrapperT::kObjSize
+            || header[1] != kStride)
+        {
+            return false;
+        }
+
+        // Checked one by one, so that none of the sizes can overflow.
+        auto remaining = size - internal::SnapshotFormat::kHeaderSize;
+        if (header[2] > remaining / (kStride + sizeof(uint64_t))) return false;
+        const auto numObjects = static_cast<std::size_t>(header[2]);
+        remaining -= numObjects * (kStride + sizeof(uint64_t));
+        if (header[3] > remaining / sizeof(uint64_t)) return false;
+        const auto numEdges = static_cast<std::size_t>(header[3]);
+        remaining -= numEdges * sizeof(uint64_t);
+        if (header[4] != remaining / sizeof(uint64_t)) return false;
+        const auto numRoots = static_cast<std::size_t>(header[4]);
+
+        const std::size_t objectsEnd = internal::SnapshotFormat::kHeaderSize
+            + numObjects * kStride;
+        auto isObject = [&](uint64_t offset)
+        {
+            return offset >= internal::SnapshotFormat::kHeaderSize && offset < objectsEnd
+                && (offset - internal::SnapshotFormat::kHeaderSize) % kStride == 0;
+        };
+
+        auto edges = data + objectsEnd + numObjects * sizeof(uint64_t);
+        for (std::size_t i = 0; i < numEdges; ++i)
+        {
+            const auto slot = load(edges, i);
+            if (slot < internal::SnapshotFormat::kHeaderSize
+                || slot > objectsEnd - sizeof(uintptr_t))
+            {
+                return false;
+            }
+
+            uintptr_t target;
+            std::memcpy(&target, data + slot, sizeof(target));
+            if (!isObject(target)) return false;
+            const auto pointer = reinterpret_cast<uintptr_t>(data + target);
+            std::memcpy(data + slot, &pointer, sizeof(pointer));
+        }
+
+        m_roots = edges + numEdges * sizeof(uint64_t);
+        for (std::size_t i = 0; i < numRoots; ++i)
+        {
+            if (load(m_roots, i) >= numObjects) return false;
+        }
+
+        m_numObjects = numObjects;
+        m_numRoots = numRoots;
+        m_sources = data + objectsEnd;
+        return true;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   path    The path of the snapshot file.
+     */
+    explicit SnapshotFile(const char* path)
+        : m_file{platform::mapFile(path)}
+    {
+        if (m_file.data && !parse())
+        {
+            platform::unmapFile(m_file);
+            m_numObjects = m_numRoots = 0;
+        }
+    }
+
+    /**
+     * @brief   Destructor.
+     */
+    ~SnapshotFile()
+    {
+        platform::unmapFile(m_file);
+    }
+
+    /**
+     * @brief   Determines whether the snapshot was loaded successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_file.data != nullptr; }
+
+    /**
+     * @brief   Gets the number of objects in the snapshot.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_numObjects; }
+
+    /**
+     * @brief   Gets an object of the snapshot.
+     * @param   idx The index of the object, in the order of discovery.
+     * @return  A wrapper for the object.
+     */
+    WrapperT object(std::size_t idx) const { return wrapper_cast<WrapperT>(objectData(idx)); }
+
+    /**
+     * @brief   Gets the address an object had in the captured address space.
+     * @param   idx The index of the object.
+     * @return  The address.
+     */
+    uintptr_t source(std::size_t idx) const
+    {
+        return static_cast<uintptr_t>(load(m_sources, idx));
+    }
+
+    /**
+     * @brief   Gets the number of roots the snapshot was captured from.
+     * @return  The number of roots.
+     */
+    std::size_t numRoots() const { return m_numRoots; }
+
+    /**
+     * @brief   Gets a root object of the snapshot.
+     * @param   idx The index of the root, in the order of capture.
+     * @return  A wrapper for the object.
+     */
+    WrapperT root(std::size_t idx) const
+    {
+        return object(static_cast<std::size_t>(load(m_roots, idx)));
+    }
+
+    /**
+     * @brief   Determines the index of an object of the snapshot, e.g. one a link points to.
+     * @param   raw The raw pointer of the object.
+     * @return  If pointing to an object of the snapshot, its index, else an empty optional.
+     */
+    zycore::Optional<std::size_t> indexOf(const void* raw) const
+    {
+        if (!isValid() || raw < objectData(0) || raw >= objectData(m_numObjects))
+        {
+            return zycore::kEmpty;
+        }
+        const auto offs = static_cast<std::size_t>(static_cast<const uint8_t*>(raw)
+            - objectData(0));
+        if (offs % kStride) return zycore::kEmpty;
+        return {zycore::kInPlace, offs / kStride};
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [CompressedSnapshotFile]                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A compressed snapshot file written by `SnapshotBuilder`.
+ * @tparam  WrapperT    Wrapper type of the objects.
+ *
+ * Only the block index and the tables (8 bytes per object and link) are decompressed when
+ * opening the file. Accessing an object decompresses the block containing it, the most recently
+ * used blocks are kept decompressed.
+ *
+ * Unlike with `SnapshotFile`, link fields aren't rewritten to pointers, as blocks move in and
+ * out of the cache. They hold the offset of their target instead, which `indexOf` resolves:
+ * @code
+ *     CompressedSnapshotFile<Entity> snap{"world.snap"};
+ *     auto entity = snap.root(0);
+ *     auto target = snap.indexOf(entity.target);
+ *     if (target.hasValue()) std::cout << snap.object(target.value()).health << '\n';
+ * @endcode
+ *
+ * @note    Wrappers returned by `object` and `root` stay valid until @c cacheBlocks other
+ *          blocks have been accessed. Instances must not be shared between threads.
+ */
+template<typename WrapperT>
+class CompressedSnapshotFile : public zycore::NonCopyable
+{
+    using Format = internal::SnapshotFormat;
+    static const std::size_t kStride = Format::Stride<WrapperT>::kValue;
+    static const std::size_t kBlockObjects = Format::Stride<WrapperT>::kBlockObjects;
+    static const std::size_t kAlign = Format::Stride<WrapperT>::kAlign;
+
+    struct CachedBlock
+    {
+        std::size_t index;
+        std::vector<uint8_t> storage;
+        uint8_t* data;
+    };
+
+    platform::MappedFile m_file;
+    std::size_t m_numObjects = 0;
+    std::size_t m_numRoots = 0;
+    std::size_t m_numBlocks = 0;
+    const uint8_t* m_blocks = nullptr;
+    std::vector<uint64_t> m_tables;
+    const uint64_t* m_roots = nullptr;
+
+    std::size_t m_cacheBlocks;
+    mutable std::list<CachedBlock> m_cache;
+    mutable std::unordered_map<std::size_t, typename std::list<CachedBlock>::iterator> m_cached;
+    mutable std::size_t m_numMisses = 0;
+
+    static uint64_t load(const uint8_t* table, std::size_t idx)
+    {
+        uint64_t value;
+        std::memcpy(&value, table + idx * sizeof(value), sizeof(value));
+        return value;
+    }
+
+    std::size_t blockSize(std::size_t block) const
+    {
+        return ((std::min)(m_numObjects, (block + 1) * kBlockObjects) - block * kBlockObjects)
+            * kStride;
+    }
+
+    bool parse()
+    {
+        auto data = static_cast<const uint8_t*>(m_file.data);
+        const std::size_t size = m_file.size;
+        if (size < Format::kHeaderSize || std::memcmp(data, "RMGZ", 4) != 0) return false;
+
+        uint32_t version;
+        uint64_t header[6];
+        std::memcpy(&version, data + 4, sizeof(version));
+        std::memcpy(header, data + 8, sizeof(header));
+        if (version != Format::kVersion || header[0] != WrapperT::kObjSize
+            || header[1] != kStride || header[5] != kBlockObjects)
+        {
+            return false;
+        }
+
+        // Each table entry takes at least a bit of the file, which bounds the sizes to allocate.
+        const uint64_t maxEntries = uint64_t{size} * 8;
+        if (header[2] > maxEntries || header[3] > maxEntries || header[4] > maxEntries
+            || header[2] + header[3] + header[4] > maxEntries)
+        {
+            return false;
+        }
+        const auto numObjects = static_cast<std::size_t>(header[2]);
+        const auto numEdges = static_cast<std::size_t>(header[3]);
+        const auto numRoots = static_cast<std::size_t>(header[4]);
+        const std::size_t numBlocks = (numObjects + kBlockObjects - 1) / kBlockObjects;
+        if (numBlocks + 2 > (size - Format::kHeaderSize) / sizeof(uint64_t)) return false;
+
+        m_numObjects = numObjects;
+        m_blocks = data + Format::kHeaderSize;
+        uint64_t prev = Format::kHeaderSize + (numBlocks + 2) * sizeof(uint64_t);
+        for (std::size_t i = 0; i <= numBlocks; ++i)
+        {
+            const auto rawSize = i < numBlocks ? blockSize(i)
+                : (numObjects + numEdges + numRoots) * sizeof(uint64_t);
+            const auto next = load(m_blocks, i + 1);
+            if (load(m_blocks, i) != prev || next < prev || next - prev > rawSize) return false;
+            prev = next;
+        }
+        if (prev != size) return false;
+
+        m_tables.resize(numObjects + numEdges + numRoots);
+        const auto tablesSize = m_tables.size() * sizeof(uint64_t);
+        const auto first = load(m_blocks, numBlocks);
+        const auto compressedSize = static_cast<std::size_t>(size - first);
+        const auto tables = reinterpret_cast<uint8_t*>(m_tables.data());
+        if (compressedSize == tablesSize)
+        {
+            if (tablesSize) std::memcpy(tables, data + first, tablesSize);
+        }
+        else if (!internal::lz4Decompress(data + first, compressedSize, tables, tablesSize))
+        {
+            return false;
+        }
+        for (std::size_t i = 1; i < m_tables.size(); ++i) m_tables[i] += m_tables[i - 1];
+
+        const std::size_t objectsEnd = Format::kHeaderSize + numObjects * kStride;
+        for (std::size_t i = 0; i < numEdges; ++i)
+        {
+            const auto slot = m_tables[numObjects + i];
+            if (slot < Format::kHeaderSize || slot > objectsEnd - sizeof(uintptr_t)) return false;
+        }
+        for (std::size_t i = 0; i < numRoots; ++i)
+        {
+            if (m_tables[numObjects + numEdges + i] >= numObjects) return false;
+        }
+
+        m_numRoots = numRoots;
+        m_numBlocks = numBlocks;
+        m_roots = m_tables.data() + numObjects + numEdges;
+        return true;
+    }
+
+    uint8_t* block(std::size_t idx) const
+    {
+        auto it = m_cached.find(idx);
+        if (it != m_cached.end())
+        {
+            m_cache.splice(m_cache.begin(), m_cache, it->second);
+            return it->second->data;
+        }
+
+        ++m_numMisses;
+        if (m_cache.size() < m_cacheBlocks)
+        {
+            m_cache.emplace_front();
+        }
+        else
+        {
+            m_cached.erase(m_cache.back().index);
+            m_cache.splice(m_cache.begin(), m_cache, std::prev(m_cache.end()));
+        }
+
+        // Blocks are decompressed into storage aligned by hand, which allows objects aligned
+        // above the alignment guaranteed by the allocator.
+        auto& cached = m_cache.front();
+        const std::size_t size = blockSize(idx);
+        cached.index = idx;
+        cached.storage.resize(size + kAlign);
+        cached.data = cached.storage.data() + (kAlign - reinterpret_cast<uintptr_t>(
+            cached.storage.data()) % kAlign) % kAlign;
+
+        const auto first = load(m_blocks, idx);
+        const auto compressedSize = static_cast<std::size_t>(load(m_blocks, idx + 1) - first);
+        const auto src = static_cast<const uint8_t*>(m_file.data) + first;
+        if (compressedSize == size)
+        {
+            std::memcpy(cached.data, src, size);
+        }
+        else if (!internal::lz4Decompress(src, compressedSize, cached.data, size))
+        {
+            // Reading a corrupt block yields zeroed objects rather than garbage.
+            std::memset(cached.data, 0, size);
+        }
+        m_cached[idx] = m_cache.begin();
+        return cached.data;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   path        The path of the snapshot file.
+     * @param   cacheBlocks The number of decompressed blocks to keep, at least 1.
+     */
+    explicit CompressedSnapshotFile(const char* path, std::size_t cacheBlocks = 16)
+        : m_file{platform::mapFile(path)}
+        , m_cacheBlocks{cacheBlocks ? cacheBlocks : 1}
+    {
+        if (m_file.data && !parse())
+        {
+            platform::unmapFile(m_file);
+            m_numObjects = m_numRoots = m_numBlocks = 0;
+            m_tables.clear();
+        }
+    }
+
+    /**
+     * @brief   Destructor.
+     */
+    ~CompressedSnapshotFile()
+    {
+        platform::unmapFile(m_file);
+    }
+
+    /**
+     * @brief   Determines whether the snapshot was loaded successfully.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_file.data != nullptr; }
+
+    /**
+     * @brief   Gets the number of objects in the snapshot.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_numObjects; }
+
+    /**
+     * @brief   Gets the number of compressed blocks.
+     * @return  The number of blocks.
+     */
+    std::size_t numBlocks() const { return m_numBlocks; }
+
+    /**
+     * @brief   Gets the number of blocks decompressed so far.
+     * @return  The number of cache misses.
+     */
+    std::size_t numMisses() const { return m_numMisses; }
+
+    /**
+     * @brief   Gets an object of the snapshot, decompressing its block if not cached.
+     * @param   idx The index of the object, in the order of discovery.
+     * @return  A wrapper for the object.
+     */
+    WrapperT object(std::size_t idx) const
+    {
+        assert(idx < m_numObjects);
+        return wrapper_cast<WrapperT>(block(idx / kBlockObjects) + idx % kBlockObjects * kStride);
+    }
+
+    /**
+     * @brief   Gets the address an object had in the captured address space.
+     * @param   idx The index of the object.
+     * @return  The address.
+     */
+    uintptr_t source(std::size_t idx) const { return static_cast<uintptr_t>(m_tables[idx]); }
+
+    /**
+     * @brief   Gets the number of roots the snapshot was captured from.
+     * @return  The number of roots.
+     */
+    std::size_t numRoots() const { return m_numRoots; }
+
+    /**
+     * @brief   Gets a root object of the snapshot.
+     * @param   idx The index of the root, in the order of capture.
+     * @return  A wrapper for the object.
+     */
+    WrapperT root(std::size_t idx) const { return object(static_cast<std::size_t>(m_roots[idx])); }
+
+    /**
+     * @brief   Determines the object a link field points to.
+     * @param   link    The value of the link field.
+     * @return  If pointing to an object of the snapshot, its index, else an empty optional.
+     */
+    zycore::Optional<std::size_t> indexOf(const void* link) const
+    {
+        const auto offset = reinterpret_cast<uintptr_t>(link);
+        if (offset < Format::kHeaderSize || (offset - Format::kHeaderSize) % kStride
+            || (offset - Format::kHeaderSize) / kStride >= m_numObjects)
+        {
+            return zycore::kEmpty;
+        }
+        return {zycore::kInPlace, (offset - Format::kHeaderSize) / kStride};
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [diff]                                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A field that differs between two snapshots.
+ */
+struct FieldChange
+{
+    /// The index of the object in the first snapshot.
+    std::size_t lhsObject;
+    /// The index of the object in the second snapshot.
+    std::size_t rhsObject;
+    /// The index of the field in the field table.
+    std::size_t field;
+};
+
+/**
+ * @brief   An object contained in both snapshots, but at different indices.
+ */
+struct ObjectMove
+{
+    /// The index of the object in the first snapshot.
+    std::size_t lhsObject;
+    /// The index of the object in the second snapshot.
+    std::size_t rhsObject;
+};
+
+/**
+ * @brief   The differences between two snapshots, see `diff`.
+ */
+struct SnapshotDiff
+{
+    /// The fields that differ, ordered by object and offset.
+    std::vector<FieldChange> changed;
+    /// The objects whose index changed, ordered by index in the first snapshot.
+    std::vector<ObjectMove> moved;
+    /// The indices of the objects only contained in the first snapshot.
+    std::vector<std::size_t> removed;
+    /// The indices of the objects only contained in the second snapshot.
+    std::vector<std::size_t> added;
+};
+
+/**
+ * @brief   Determines the fields that differ between two snapshots of the same object graph.
+ * @param   lhs         The older snapshot.
+ * @param   rhs         The newer snapshot.
+ * @param   fields      The field table, e.g. from `fieldInfos` of a `REMODEL_FIELDS` wrapper.
+ *                      Bytes covered by more than one field are attributed to the first one.
+ * @param   numFields   The number of fields in the table.
+ * @return  The differences.
+ *
+ * Objects are matched by the address they had in the captured address space. The bytes of
+ * matched objects are compared with `simd::forEachMismatch`, and only differing bytes are mapped
+ * back to fields through a table built once per call, so equal objects cost a few vector
+ * compares each. Bytes not covered by any field are ignored. Pointer sized fields pointing into
+ * the snapshots (i.e. links) are compared by the source addresses of the objects they point to.
+ */
+template<typename WrapperT>
+inline SnapshotDiff diff(const SnapshotFile<WrapperT>& lhs, const SnapshotFile<WrapperT>& rhs,
+    const FieldInfo* fields, std::size_t numFields)
+{
+    const std::size_t objSize = WrapperT::kObjSize;
+
+    // The index of the field covering each byte of the objects, plus one.
+    std::vector<std::size_t> owners(objSize, 0);
+    for (std::size_t i = numFields; i--;)
+    {
+        if (fields[i].offset < 0) continue;
+        const auto begin = static_cast<std::size_t>(fields[i].offset);
+        for (auto b = begin; b < begin + fields[i].size && b < objSize; ++b) owners[b] = i + 1;
+    }
+
+    auto sameLink = [&](const uint8_t* a, const uint8_t* b)
+    {
+        const void* lhsLink;
+        const void* rhsLink;
+        std::memcpy(&lhsLink, a, sizeof(lhsLink));
+        std::memcpy(&rhsLink, b, sizeof(rhsLink));
+        auto lhsIdx = lhs.indexOf(lhsLink);
+        auto rhsIdx = rhs.indexOf(rhsLink);
+        return lhsIdx.hasValue() && rhsIdx.hasValue()
+            && lhs.source(lhsIdx.value()) == rhs.source(rhsIdx.value());
+    };
+
+    SnapshotDiff result;
+    auto compare = [&](std::size_t lhsObj, std::size_t rhsObj)
+    {
+        auto a = static_cast<const uint8_t*>(lhs.object(lhsObj).addressOfObj());
+        auto b = static_cast<const uint8_t*>(rhs.object(rhsObj).addressOfObj());
+        // Bytes before this offset belong to fields that were already handled.
+        std::size_t resume = 0;
+        simd::forEachMismatch(a, b, objSize, [&](std::size_t offset, uint32_t mask)
+        {
+            for (; mask; mask &= mask - 1)
+            {
+                const std::size_t byte = offset + simd::countTrailingZeros(mask);
+                if (byte < resume || !owners[byte]) continue;
+
+                const auto& info = fields[owners[byte] - 1];
+                resume = static_cast<std::size_t>(info.offset) + info.size;
+                if (info.size == sizeof(void*) && sameLink(a + info.offset, b + info.offset))
+                {
+                    continue;
+                }
+                result.changed.push_back({lhsObj, rhsObj, owners[byte] - 1});
+            }
+        });
+    };
+
+    // Objects usually keep their position, the index is only built when they don't.
+    std::unordered_map<uintptr_t, std::size_t> rhsIndices;
+    std::vector<bool> matched(rhs.size(), false);
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        const auto source = lhs.source(i);
+        std::size_t j = i;
+        if (j >= rhs.size() || rhs.source(j) != source)
+        {
+            if (rhsIndices.empty())
+            {
+                for (std::size_t k = 0; k < rhs.size(); ++k) rhsIndices.emplace(rhs.source(k), k);
+            }
+            auto it = rhsIndices.find(source);
+            if (it == rhsIndices.end())
+            {
+                result.removed.push_back(i);
+                continue;
+            }
+            j = it->second;
+        }
+
+        if (j != i) result.moved.push_back({i, j});
+        matched[j] = true;
+        compare(i, j);
+    }
+
+    for (std::size_t j = 0; j < rhs.size(); ++j)
+    {
+        if (!matched[j]) result.added.push_back(j);
+    }
+    return result;
+}
+
+/**
+ * @brief   Determines the fields that differ between two snapshots of the same object graph.
+ * @param   lhs The older snapshot.
+ * @param   rhs The newer snapshot.
+ * @return  The differences, referring to the fields of `WrapperT::fieldInfos()`.
+ *
+ * Overload for wrappers declaring their fields with `REMODEL_FIELDS`.
+ */
+template<typename WrapperT>
+inline SnapshotDiff diff(const SnapshotFile<WrapperT>& lhs, const SnapshotFile<WrapperT>& rhs)
+{
+    return diff(lhs, rhs, WrapperT::fieldInfos(), WrapperT::Layout::kNumFields);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [SnapshotHashIndex] + [SnapshotSortedIndex]                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Extracts the keys of all objects of a snapshot, distributed over multiple threads.
+ */
+template<typename WrapperT, typename KeyT, typename KeyFuncT>
+inline std::vector<KeyT> extractKeys(const SnapshotFile<WrapperT>& snap, const KeyFuncT& keyFunc,
+    unsigned numThreads)
+{
+    const std::size_t kChunk = 1024;
+    std::vector<KeyT> keys(snap.size());
+    parallelForChunks((snap.size() + kChunk - 1) / kChunk, numThreads, [&](std::size_t chunk)
+    {
+        const auto end = (std::min)(snap.size(), (chunk + 1) * kChunk);
+        for (auto i = chunk * kChunk; i < end; ++i)
+        {
+            auto obj = snap.object(i);
+            keys[i] = keyFunc(obj);
+        }
+    });
+    return keys;
+}
+
+/**
+ * @internal
+ * @brief   Determines the objects whose index entries are outdated after a diff.
+ * @param   stale   Receives the indices in the older snapshot of the entries to remove.
+ * @param   fresh   Receives the indices in the newer snapshot of the entries to insert.
+ *
+ * These are removed and added objects, moved objects and objects with changes to their key.
+ */
+template<typename WrapperT, typename KeyFuncT>
+inline void outdatedEntries(const SnapshotFile<WrapperT>& lhs, const SnapshotFile<WrapperT>& rhs,
+    const SnapshotDiff& diff, const KeyFuncT& keyFunc, std::vector<std::size_t>& stale,
+    std::vector<std::size_t>& fresh)
+{
+    stale = diff.removed;
+    fresh = diff.added;
+    for (const auto& cur : diff.moved)
+    {
+        stale.push_back(cur.lhsObject);
+        fresh.push_back(cur.rhsObject);
+    }
+
+    // Changes are ordered by object, so each object is checked once.
+    for (std::size_t i = 0; i < diff.changed.size(); ++i)
+    {
+        const auto& cur = diff.changed[i];
+        if (i && diff.changed[i - 1].lhsObject == cur.lhsObject) continue;
+        auto a = lhs.object(cur.lhsObject);
+        auto b = rhs.object(cur.rhsObject);
+        if (!(keyFunc(a) == keyFunc(b)))
+        {
+            stale.push_back(cur.lhsObject);
+            fresh.push_back(cur.rhsObject);
+        }
+    }
+
+    // Moved objects with changed keys are listed twice.
+    for (auto* cur : {&stale, &fresh})
+    {
+        std::sort(cur->begin(), cur->end());
+        cur->erase(std::unique(cur->begin(), cur->end()), cur->end());
+    }
+}
+
+} // namespace internal
+
+/**
+ * @brief   Hash index mapping a key of the objects of a snapshot (e.g. an ID) to their indices.
+ * @tparam  WrapperT    Wrapper type of the objects.
+ * @tparam  KeyT        The type of the keys, hashable with `std::hash`.
+ *
+ * Built once per snapshot and then carried over to the following snapshots with `update`, which
+ * only touches the entries of objects that changed according to `diff`:
+ * @code
+ *     SnapshotHashIndex<Entity, uint32_t> byId{[](Entity& e) { return uint32_t{e.id}; }};
+ *     byId.build(snap);
+ *     // ...
+ *     auto changes = diff(snap, nextSnap);
+ *     byId.update(snap, nextSnap, changes);
+ *     if (auto idx = byId.find(1234)) std::cout << nextSnap.object(idx.value()).health << '\n';
+ * @endcode
+ * Keys don't need to be unique, `find` returns any of the objects then, `forEach` all of them.
+ */
+template<typename WrapperT, typename KeyT>
+class SnapshotHashIndex
+{
+public:
+    /**
+     * @brief   Extracts the key of an object.
+     */
+    using KeyFunc = std::function<KeyT (WrapperT&)>;
+private:
+    KeyFunc m_keyFunc;
+    std::unordered_multimap<KeyT, std::size_t> m_entries;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   keyFunc Extracts the key of an object, invoked concurrently by `build`.
+     */
+    explicit SnapshotHashIndex(KeyFunc keyFunc)
+        : m_keyFunc{std::move(keyFunc)}
+    {}
+
+    /**
+     * @brief   Builds the index for a snapshot, discarding previous entries.
+     * @param   snap        The snapshot.
+     * @param   numThreads  The number of threads extracting keys, 0 to use the hardware 
+     *                      concurrency.
+     */
+    void build(const SnapshotFile<WrapperT>& snap, unsigned numThreads = 0)
+    {
+        auto keys = internal::extractKeys<WrapperT, KeyT>(snap, m_keyFunc, numThreads);
+        m_entries.clear();
+        m_entries.reserve(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) m_entries.emplace(std::move(keys[i]), i);
+    }
+
+    /**
+     * @brief   Carries the index over from a snapshot to the next one.
+     * @param   lhs     The snapshot the index currently refers to.
+     * @param   rhs     The newer snapshot.
+     * @param   diff    The result of `diff(lhs, rhs)`.
+     */
+    void update(const SnapshotFile<WrapperT>& lhs, const SnapshotFile<WrapperT>& rhs,
+        const SnapshotDiff& diff)
+    {
+        std::vector<std::size_t> stale, fresh;
+        internal::outdatedEntries(lhs, rhs, diff, m_keyFunc, stale, fresh);
+
+        for (auto idx : stale)
+        {
+            auto obj = lhs.object(idx);
+            auto range = m_entries.equal_range(m_keyFunc(obj));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == idx)
+                {
+                    m_entries.erase(it);
+                    break;
+                }
+            }
+        }
+        for (auto idx : fresh)
+        {
+            auto obj = rhs.object(idx);
+            m_entries.emplace(m_keyFunc(obj), idx);
+        }
+    }
+
+    /**
+     * @brief   Looks up an object by key.
+     * @param   key The key.
+     * @return  If found, the index of the object, else an empty optional.
+     */
+    zycore::Optional<std::size_t> find(const KeyT& key) const
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) return zycore::kEmpty;
+        return {zycore::kInPlace, it->second};
+    }
+
+    /**
+     * @brief   Invokes a function for the indices of all objects with a key.
+     * @param   key     The key.
+     * @param   func    The function, callable as `void(std::size_t)`.
+     */
+    template<typename FuncT>
+    void forEach(const KeyT& key, FuncT&& func) const
+    {
+        auto range = m_entries.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) func(it->second);
+    }
+
+    /**
+     * @brief   Gets the number of entries.
+     * @return  The number of entries, one per object.
+     */
+    std::size_t size() const { return m_entries.size(); }
+};
+
+/**
+ * @brief   Sorted index of the objects of a snapshot by a key, e.g. a name, allowing range
+ *          queries.
+ * @tparam  WrapperT    Wrapper type of the objects.
+ * @tparam  KeyT        The type of the keys, ordered by `operator <`.
+ *
+ * Used like `SnapshotHashIndex`. Updates remove outdated entries in one pass and merge the new 
+ * ones in, rather than sorting everything again.
+ */
+template<typename WrapperT, typename KeyT>
+class SnapshotSortedIndex
+{
+public:
+    /**
+     * @brief   Extracts the key of an object.
+     */
+    using KeyFunc = std::function<KeyT (WrapperT&)>;
+
+    /**
+     * @brief   An entry of the index.
+     */
+    struct Entry
+    {
+        KeyT key;
+        std::size_t object;
+
+        bool operator < (const Entry& rhs) const
+        {
+            return key < rhs.key || (!(rhs.key < key) && object < rhs.object);
+        }
+    };
+private:
+    KeyFunc m_keyFunc;
+    std::vector<Entry> m_entries;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   keyFunc Extracts the key of an object, invoked concurrently by `build`.
+     */
+    explicit SnapshotSortedIndex(KeyFunc keyFunc)
+        : m_keyFunc{std::move(keyFunc)}
+    {}
+
+    /**
+     * @copydoc SnapshotHashIndex::build
+     */
+    void build(const SnapshotFile<WrapperT>& snap, unsigned numThreads = 0)
+    {
+        auto keys = internal::extractKeys<WrapperT, KeyT>(snap, m_keyFunc, numThreads);
+        m_entries.clear();
+        m_entries.reserve(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) m_entries.push_back({std::move(keys[i]), i});
+        std::sort(m_entries.begin(), m_entries.end());
+    }
+
+    /**
+     * @copydoc SnapshotHashIndex::update
+     */
+    void update(const SnapshotFile<WrapperT>& lhs, const SnapshotFile<WrapperT>& rhs,
+        const SnapshotDiff& diff)
+    {
+        std::vector<std::size_t> stale, fresh;
+        internal::outdatedEntries(lhs, rhs, diff, m_keyFunc, stale, fresh);
+
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [&](const Entry& cur)
+        {
+            return std::binary_search(stale.begin(), stale.end(), cur.object);
+        }), m_entries.end());
+
+        const auto middle = m_entries.size();
+        for (auto idx : fresh)
+        {
+            auto obj = rhs.object(idx);
+            m_entries.push_back({m_keyFunc(obj), idx});
+        }
+        std::sort(m_entries.begin() + static_cast<std::ptrdiff_t>(middle), m_entries.end());
+        std::inplace_merge(m_entries.begin(), m_entries.begin() 
+            + static_cast<std::ptrdiff_t>(middle), m_entries.end());
+    }
+
+    /**
+     * @copydoc SnapshotHashIndex::find
+     */
+    zycore::Optional<std::size_t> find(const KeyT& key) const
+    {
+        auto it = lowerBound(key);
+        if (it == m_entries.end() || key < it->key) return zycore::kEmpty;
+        return {zycore::kInPlace, it->object};
+    }
+
+    /**
+     * @brief   Invokes a function for the indices of all objects with keys in `[first, last)`,
+     *          in ascending order of keys.
+     * @param   first   The lowest key.
+     * @param   last    The key after the highest one.
+     * @param   func    The function, callable as `void(std::size_t)`.
+     */
+    template<typename FuncT>
+    void forEachInRange(const KeyT& first, const KeyT& last, FuncT&& func) const
+    {
+        for (auto it = lowerBound(first); it != m_entries.end() && it->key < last; ++it)
+        {
+            func(it->object);
+        }
+    }
+
+    /**
+     * @brief   Gets the entries, sorted by key and object index.
+     * @return  The entries.
+     */
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+    /**
+     * @copydoc SnapshotHashIndex::size
+     */
+    std::size_t size() const { return m_entries.size(); }
+private:
+    typename std::vector<Entry>::const_iterator lowerBound(const KeyT& key) const
+    {
+        return std::lower_bound(m_entries.begin(), m_entries.end(), key, 
+            [](const Entry& cur, const KeyT& value) { return cur.key < value; });
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [RegionSnapshot]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Copy of a range of memory of a backend, refreshed incrementally.
+ *
+ * Where the backend tracks writes (see `MemoryBackend::queryDirtyPages`, soft-dirty bits on 
+ * Linux, write watches on Windows), `refresh` only reads the pages written to since the last 
+ * refresh, and `forEachChange` only compares those, so keeping a copy of a large heap up to date
+ * costs time proportional to the amount of memory written rather than to the size of the heap. 
+ * Without tracking, every refresh reads the whole range.
+ * @code
+ *     RegionSnapshot heap{process, heapStart, heapSize};
+ *     heap.capture();
+ *     for (;;)
+ *     {
+ *         waitForTick();
+ *         heap.refresh();
+ *         heap.forEachChange([](uintptr_t address, std::size_t size) { ... });
+ *     }
+ * @endcode
+ *
+ * Writes racing with `refresh` on Linux (between reading and clearing the soft-dirty bits) may go
+ * unnoticed, so the target should be paused or between ticks while refreshing.
+ */
+class RegionSnapshot : public zycore::NonCopyable
+{
+public:
+    static const std::size_t kPageSize = platform::kDirtyPageSize;
+private:
+    MemoryBackend* m_memory;
+    uintptr_t m_address;
+    std::size_t m_size;
+    std::vector<uint8_t> m_data;
+    // The pages read by the last refresh and their previous contents.
+    std::vector<uintptr_t> m_refreshed;
+    std::vector<uint8_t> m_previous;
+    bool m_tracking = false;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   memory  The memory backend.
+     * @param   address The start of the range, rounded down to a page boundary.
+     * @param   size    The size of the range, in bytes, rounded up to whole pages.
+     */
+    RegionSnapshot(MemoryBackend& memory, uintptr_t address, std::size_t size)
+        : m_memory{&memory}
+        , m_address{address & ~uintptr_t{kPageSize - 1}}
+        , m_size{(address + size - m_address + kPageSize - 1) & ~(kPageSize - 1)}
+        , m_data(m_size)
+    {}
+
+    /**
+     * @brief   Reads the whole range.
+     * @return  @c true if read completely, else @c false.
+     */
+    bool capture()
+    {
+        // Tracking starts before reading, so writes during the read are picked up later.
+        m_tracking = m_memory->resetDirtyPages(m_address, m_size);
+        m_refreshed.clear();
+        m_previous.clear();
+        return m_memory->read(m_address, m_data.data(), m_size);
+    }
+
+    /**
+     * @brief   Reads the pages written to since the last `capture` or `refresh`.
+     * @return  @c true if all of them were read, else @c false.
+     */
+    bool refresh()
+    {
+        std::vector<uintptr_t> pages;
+        if (!m_tracking || !m_memory->queryDirtyPages(m_address, m_size, pages))
+        {
+            pages.clear();
+            for (std::size_t offs = 0; offs < m_size; offs += kPageSize)
+            {
+                pages.push_back(m_address + offs);
+            }
+        }
+        m_tracking = m_memory->resetDirtyPages(m_address, m_size);
+
+        m_previous.resize(pages.size() * kPageSize);
+        std::vector<platform::IoRange> ranges;
+        for (std::size_t i = 0; i < pages.size(); ++i)
+        {
+            auto cur = m_data.data() + (pages[i] - m_address);
+            std::memcpy(m_previous.data() + i * kPageSize, cur, kPageSize);
+            // Adjacent pages are read at once.
+            if (!ranges.empty() && ranges.back().address + ranges.back().size == pages[i])
+            {
+                ranges.back().size += kPageSize;
+            }
+            else
+            {
+                ranges.push_back({pages[i], cur, kPageSize});
+            }
+        }
+        m_refreshed = std::move(pages);
+        return m_memory->readBatch(ranges.data(), ranges.size());
+    }
+
+    /**
+     * @brief   Invokes a function for every run of bytes changed by the last `refresh`.
+     * @param   func    The function, callable as `void(uintptr_t address, std::size_t size)`, 
+     *                  invoked in ascending order of addresses.
+     */
+    template<typename FuncT>
+    void forEachChange(FuncT&& func) const
+    {
+        for (std::size_t i = 0; i < m_refreshed.size(); ++i)
+        {
+            const auto page = m_refreshed[i];
+            std::size_t runStart = 0, runEnd = 0;
+            simd::forEachMismatch(m_previous.data() + i * kPageSize, 
+                m_data.data() + (page - m_address), kPageSize, 
+                [&](std::size_t offset, uint32_t mask)
+            {
+                for (; mask; mask &= mask - 1)
+                {
+                    const std::size_t byte = offset + simd::countTrailingZeros(mask);
+                    if (runEnd != byte)
+                    {
+                        if (runEnd) func(page + runStart, runEnd - runStart);
+                        runStart = byte;
+                    }
+                    runEnd = byte + 1;
+                }
+            });
+            if (runEnd) func(page + runStart, runEnd - runStart);
+        }
+    }
+
+    /**
+     * @brief   Translates an address of the range to a pointer into the copy.
+     * @param   address The address.
+     * @param   size    The number of bytes that are required to be inside the range.
+     * @return  If inside the range, the pointer, else @c nullptr.
+     */
+    void* translate(uintptr_t address, std::size_t size = 1)
+    {
+        if (address < m_address || address - m_address > m_size 
+            || m_size - (address - m_address) < size)
+        {
+            return nullptr;
+        }
+        return m_data.data() + (address - m_address);
+    }
+
+    /**
+     * @brief   Gets the number of pages read by the last `refresh`.
+     * @return  The number of pages.
+     */
+    std::size_t numRefreshedPages() const { return m_refreshed.size(); }
+
+    /**
+     * @brief   Determines whether the backend tracks writes to the range.
+     * @return  @c true if refreshes only read written pages, else @c false.
+     */
+    bool isTracking() const { return m_tracking; }
+
+    /**
+     * @brief   Gets the start of the range.
+     * @return  The address of the first page.
+     */
+    uintptr_t address() const { return m_address; }
+
+    /**
+     * @brief   Gets the size of the range.
+     * @return  The size, in bytes.
+     */
+    std::size_t size() const { return m_size; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_SNAPSHOT_HPP
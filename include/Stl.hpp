@@ -0,0 +1,613 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_STL_HPP
+#define REMODEL_STL_HPP
+
+/**     
+ * @file
+ * @brief Contains layouts of foreign standard library containers, usable as field types.
+ *        
+ * The layouts read strings and vectors of targets built with the MSVC STL or libstdc++ straight 
+ * from their memory, without allocating copies:
+ * @code
+ *     class Player : public AdvancedClassWrapper<64>
+ *     {
+ *         REMODEL_ADV_WRAPPER(Player)
+ *     public:
+ *         Field<MsvcString>               name     {this, 0x08};
+ *         Field<MsvcVector<Item::Compact>> inventory{this, 0x28};
+ *     };
+ *     
+ *     if (player.name->ref() == "sn0wball") 
+ *     {
+ *         for (auto& item : player.inventory->ref()) item.view().durability = 100;
+ *     }
+ * @endcode
+ * 
+ * The target is assumed to use the same pointer size as we do. Pointers stored in the containers 
+ * are addresses in the target's address space, so `data` and everything based on it only work 
+ * in-process; `dataAddress` tells where to read the elements from with a `MemoryBackend`.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#   include <string_view>
+#   define REMODEL_STL_STRING_VIEW
+#endif
+
+#include "Remodel.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [BasicStringRef] + [ArrayRef]                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Non-owning view on a string, a `std::basic_string_view` for C++14.
+ * @tparam  CharT   The character type.
+ */
+template<typename CharT>
+class BasicStringRef
+{
+    const CharT* m_data;
+    std::size_t m_size;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   data    The first character.
+     * @param   size    The number of characters.
+     */
+    BasicStringRef(const CharT* data, std::size_t size)
+        : m_data{data}
+        , m_size{size}
+    {}
+
+    const CharT* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const CharT* begin() const { return m_data; }
+    const CharT* end() const { return m_data + m_size; }
+    const CharT& operator [] (std::size_t idx) const { return m_data[idx]; }
+
+    /**
+     * @brief   Creates an owning copy of the string.
+     * @return  The copy.
+     */
+    std::basic_string<CharT> str() const { return std::basic_string<CharT>(m_data, m_size); }
+
+#   if defined(REMODEL_STL_STRING_VIEW)
+        operator std::basic_string_view<CharT> () const { return {m_data, m_size}; }
+#   endif
+
+    bool operator == (const BasicStringRef& rhs) const
+    {
+        return m_size == rhs.m_size && std::equal(begin(), end(), rhs.begin());
+    }
+
+    bool operator != (const BasicStringRef& rhs) const { return !(*this == rhs); }
+
+    bool operator == (const CharT* rhs) const
+    {
+        return *this == BasicStringRef{rhs, std::char_traits<CharT>::length(rhs)};
+    }
+
+    bool operator != (const CharT* rhs) const { return !(*this == rhs); }
+};
+
+using StringRef = BasicStringRef<char>;
+
+/**
+ * @brief   Non-owning view on a contiguous array.
+ * @tparam  T   The element type.
+ */
+template<typename T>
+class ArrayRef
+{
+    T* m_first;
+    T* m_last;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   first   The first element.
+     * @param   last    One past the last element.
+     */
+    ArrayRef(T* first, T* last)
+        : m_first{first}
+        , m_last{last}
+    {}
+
+    T* data() const { return m_first; }
+    std::size_t size() const { return static_cast<std::size_t>(m_last - m_first); }
+    bool empty() const { return m_first == m_last; }
+    T* begin() const { return m_first; }
+    T* end() const { return m_last; }
+    T& operator [] (std::size_t idx) const { return m_first[idx]; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [MsvcBasicString]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Layout of `std::basic_string` in the MSVC STL (VS2015 and newer, release builds).
+ * @tparam  CharT   The character type.
+ *                  
+ * Strings shorter than `kBufSize` characters are stored inline, longer ones on the heap. Debug 
+ * builds (`_ITERATOR_DEBUG_LEVEL` above 0) put a pointer to the container proxy in front; wrap 
+ * such strings at their offset plus one pointer.
+ */
+template<typename CharT>
+class MsvcBasicString
+{
+public:
+    /**
+     * @brief   The capacity of the inline buffer, including the terminator.
+     */
+    static const std::size_t kBufSize = 16 / sizeof(CharT) < 1 ? 1 : 16 / sizeof(CharT);
+private:
+    union
+    {
+        CharT m_buf[kBufSize];
+        CharT* m_ptr;
+    };
+    std::size_t m_size;
+    std::size_t m_capacity;
+public:
+    /**
+     * @brief   Determines whether the string is stored inline.
+     * @return  @c true if it is, else @c false.
+     */
+    bool isSmall() const { return m_capacity < kBufSize; }
+
+    const CharT* data() const { return isSmall() ? m_buf : m_ptr; }
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief   Gets the address of the characters in the target's address space.
+     * @param   objectAddress   The address of the string object in the target.
+     * @return  The address.
+     */
+    uintptr_t dataAddress(uintptr_t objectAddress) const
+    {
+        return isSmall() ? objectAddress : reinterpret_cast<uintptr_t>(m_ptr);
+    }
+
+    BasicStringRef<CharT> ref() const { return {data(), m_size}; }
+    std::basic_string<CharT> str() const { return ref().str(); }
+};
+
+using MsvcString = MsvcBasicString<char>;
+using MsvcWString = MsvcBasicString<char16_t>; // `wchar_t` is 16 bit wide on Windows
+
+// ---------------------------------------------------------------------------------------------- //
+// [LibstdcxxBasicString] + [LibstdcxxCowBasicString]                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Layout of `std::basic_string` in libstdc++ with the C++11 ABI (GCC 5 and newer).
+ * @tparam  CharT   The character type.
+ *                  
+ * The data pointer always points to the characters, which are in the inline buffer for short 
+ * strings.
+ */
+template<typename CharT>
+class LibstdcxxBasicString
+{
+public:
+    /**
+     * @brief   The capacity of the inline buffer, including the terminator.
+     */
+    static const std::size_t kBufSize = 16 / sizeof(CharT) < 1 ? 1 : 16 / sizeof(CharT);
+private:
+    CharT* m_ptr;
+    std::size_t m_size;
+    union
+    {
+        CharT m_buf[kBufSize];
+        std::size_t m_capacity;
+    };
+public:
+    /**
+     * @brief   Determines whether the string is stored inline.
+     * @return  @c true if it is, else @c false.
+     * @note    Only correct for the string object in the target, not for copies of it.
+     */
+    bool isSmall() const { return m_ptr == m_buf; }
+
+    const CharT* data() const { return m_ptr; }
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return isSmall() ? kBufSize - 1 : m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * @copydoc MsvcBasicString::dataAddress
+     */
+    uintptr_t dataAddress(uintptr_t /*objectAddress*/) const 
+    { 
+        return reinterpret_cast<uintptr_t>(m_ptr); 
+    }
+
+    BasicStringRef<CharT> ref() const { return {m_ptr, m_size}; }
+    std::basic_string<CharT> str() const { return ref().str(); }
+};
+
+using LibstdcxxString = LibstdcxxBasicString<char>;
+using LibstdcxxWString = LibstdcxxBasicString<wchar_t>;
+
+/**
+ * @brief   Layout of the reference counted `std::basic_string` of the old libstdc++ ABI.
+ * @tparam  CharT   The character type.
+ *                  
+ * Used by GCC before version 5 and with `_GLIBCXX_USE_CXX11_ABI=0`. The object is just a pointer 
+ * to the characters, preceded by the length, the capacity and the reference count.
+ */
+template<typename CharT>
+class LibstdcxxCowBasicString
+{
+    CharT* m_ptr;
+
+    const std::size_t* header() const { return reinterpret_cast<const std::size_t*>(m_ptr) - 3; }
+public:
+    const CharT* data() const { return m_ptr; }
+    std::size_t size() const { return header()[0]; }
+    std::size_t capacity() const { return header()[1]; }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @copydoc MsvcBasicString::dataAddress
+     */
+    uintptr_t dataAddress(uintptr_t /*objectAddress*/) const 
+    { 
+        return reinterpret_cast<uintptr_t>(m_ptr); 
+    }
+
+    BasicStringRef<CharT> ref() const { return {m_ptr, size()}; }
+    std::basic_string<CharT> str() const { return ref().str(); }
+};
+
+using LibstdcxxCowString = LibstdcxxCowBasicString<char>;
+
+// ---------------------------------------------------------------------------------------------- //
+// [MsvcVector] + [LibstdcxxVector]                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Layout of `std::vector` storing pointers to the first, past the last and past the
+ *          allocated element, as used by both the MSVC STL and libstdc++.
+ * @tparam  T   The element type, e.g. `Wrapper::Compact` for vectors of wrapped objects.
+ */
+template<typename T>
+class PointerTripleVector
+{
+    T* m_first;
+    T* m_last;
+    T* m_end;
+public:
+    T* data() const { return m_first; }
+    std::size_t size() const { return static_cast<std::size_t>(m_last - m_first); }
+    std::size_t capacity() const { return static_cast<std::size_t>(m_end - m_first); }
+    bool empty() const { return m_first == m_last; }
+    T* begin() const { return m_first; }
+    T* end() const { return m_last; }
+    T& operator [] (std::size_t idx) const { return m_first[idx]; }
+
+    /**
+     * @brief   Gets the address of the elements in the target's address space.
+     * @return  The address.
+     */
+    uintptr_t dataAddress() const { return reinterpret_cast<uintptr_t>(m_first); }
+
+    ArrayRef<T> ref() const { return {m_first, m_last}; }
+
+    /**
+     * @brief   Creates a range of wrappers for the elements.
+     * @tparam  WrapperT    The wrapper type.
+     * @return  The range.
+     */
+    template<typename WrapperT>
+    WrapperRange<WrapperT> wrappers() const
+    {
+        return {static_cast<void*>(m_first), size(), sizeof(T)};
+    }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Layout of `std::vector` in the MSVC STL (release builds).
+ * @tparam  T   The element type.
+ */
+template<typename T>
+using MsvcVector = internal::PointerTripleVector<T>;
+
+/**
+ * @brief   Layout of `std::vector` in libstdc++.
+ * @tparam  T   The element type.
+ */
+template<typename T>
+using LibstdcxxVector = internal::PointerTripleVector<T>;
+
+// ---------------------------------------------------------------------------------------------- //
+// [BasicStringViewField] + [BasicStringSpan]                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Field reading a string stored as a pointer to the characters and a length, as in
+ *          custom string classes of many targets.
+ * @tparam  CharT   The character type.
+ * @tparam  SizeT   The type of the length.
+ *
+ * Both members are read directly, so no functions of the target need to be called:
+ * @code
+ *     class Dog : public AdvancedClassWrapper<128>
+ *     {
+ *         REMODEL_ADV_WRAPPER(Dog)
+ *     public:
+ *         StringViewField name{this, 4, 8}; // `char* data` at 4, `std::size_t length` at 8
+ *     };
+ *
+ *     if (dog.name == "Rex") std::cout << dog.name.str() << std::endl;
+ * @endcode
+ * Like the layouts above, the characters are only accessible in-process.
+ */
+template<typename CharT, typename SizeT = std::size_t>
+class BasicStringViewField : public internal::BasicFieldBase<OffsGetter>
+{
+    std::ptrdiff_t m_sizeDelta;
+
+    const uint8_t* dataPtr() const { return static_cast<const uint8_t*>(this->crawPtr()); }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   parent      The class wrapper that is the parent of this object.
+     * @param   dataOffset  The offset of the pointer to the characters, in bytes.
+     * @param   sizeOffset  The offset of the length, in bytes.
+     */
+    BasicStringViewField(internal::WrapperBase* parent, std::ptrdiff_t dataOffset,
+            std::ptrdiff_t sizeOffset)
+        : internal::BasicFieldBase<OffsGetter>{parent, OffsGetter{dataOffset}}
+        , m_sizeDelta{sizeOffset - dataOffset}
+    {}
+
+    /**
+     * @brief   Copy constructor.
+     * @see     Field::Field(const Field&)
+     */
+    explicit BasicStringViewField(const BasicStringViewField&) = default;
+
+    /**
+     * @brief   Gets the offset of the pointer to the characters.
+     * @return  The offset, in bytes.
+     */
+    std::ptrdiff_t dataOffset() const { return this->ptrGetter().offset(); }
+
+    /**
+     * @brief   Gets the offset of the length.
+     * @return  The offset, in bytes.
+     */
+    std::ptrdiff_t sizeOffset() const { return dataOffset() + m_sizeDelta; }
+
+    const CharT* data() const { return *reinterpret_cast<const CharT* const*>(dataPtr()); }
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(
+            *reinterpret_cast<const SizeT*>(dataPtr() + m_sizeDelta));
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief   Gets the address of the characters in the target's address space.
+     * @return  The address.
+     */
+    uintptr_t dataAddress() const { return reinterpret_cast<uintptr_t>(data()); }
+
+    /**
+     * @brief   Reads the string.
+     * @return  A view on the characters, converting to `std::basic_string_view` in C++17.
+     */
+    BasicStringRef<CharT> get() const
+    {
+        const auto ptr = dataPtr();
+        return {*reinterpret_cast<const CharT* const*>(ptr),
+            static_cast<std::size_t>(*reinterpret_cast<const SizeT*>(ptr + m_sizeDelta))};
+    }
+
+    operator BasicStringRef<CharT> () const { return get(); }
+    BasicStringRef<CharT> ref() const { return get(); }
+    std::basic_string<CharT> str() const { return get().str(); }
+
+    bool operator == (const CharT* rhs) const { return get() == rhs; }
+    bool operator != (const CharT* rhs) const { return get() != rhs; }
+    bool operator == (const BasicStringRef<CharT>& rhs) const { return get() == rhs; }
+    bool operator != (const BasicStringRef<CharT>& rhs) const { return get() != rhs; }
+};
+
+using StringViewField = BasicStringViewField<char>;
+
+/**
+ * @brief   View on the strings of a `BasicStringViewField` of many equally spaced objects.
+ * @tparam  CharT   The character type.
+ * @tparam  SizeT   The type of the length.
+ *
+ * Reads the pointers and lengths through `FieldSpan`s, without creating wrappers. Lookups compare
+ * the lengths, gathered in blocks, before touching any characters.
+ * @code
+ *     WrapperRange<Dog> dogs{dogArray, dogCount};
+ *     auto names = makeStringSpan(dogs, &Dog::name);
+ *     auto rex = names.find("Rex");
+ * @endcode
+ */
+template<typename CharT, typename SizeT = std::size_t>
+class BasicStringSpan
+{
+    FieldSpan<const CharT* const> m_data;
+    FieldSpan<const SizeT> m_sizes;
+
+    static const std::size_t kBlockSize = 256;
+public:
+    /**
+     * @brief   The index returned by `find` if no string matches.
+     */
+    static const std::size_t npos = ~std::size_t{0};
+
+    /**
+     * @brief   Constructor.
+     * @param   firstObj    The raw pointer of the first object.
+     * @param   dataOffset  The offset of the pointer to the characters, in bytes.
+     * @param   sizeOffset  The offset of the length, in bytes.
+     * @param   count       The number of objects.
+     * @param   stride      The distance between two objects, in bytes.
+     */
+    BasicStringSpan(const void* firstObj, std::ptrdiff_t dataOffset, std::ptrdiff_t sizeOffset,
+            std::size_t count, std::size_t stride)
+        : m_data{firstObj, dataOffset, count, stride}
+        , m_sizes{firstObj, sizeOffset, count, stride}
+    {}
+
+    /**
+     * @brief   Gets the number of strings in the span.
+     * @return  The number of strings.
+     */
+    std::size_t size() const { return m_data.size(); }
+
+    /**
+     * @brief   Reads a string.
+     * @param   idx The index of the object.
+     * @return  A view on the characters.
+     */
+    BasicStringRef<CharT> operator [] (std::size_t idx) const
+    {
+        return {m_data[idx], static_cast<std::size_t>(m_sizes[idx])};
+    }
+
+    /**
+     * @brief   Copies the lengths of all strings to a contiguous buffer.
+     * @param   out The buffer, at least `size()` elements.
+     */
+    void gatherSizes(SizeT* out) const { m_sizes.gather(out); }
+
+    /**
+     * @brief   Reads all strings.
+     * @param   out The vector to write the views to. Previous contents are discarded.
+     */
+    void copyTo(std::vector<BasicStringRef<CharT>>& out) const
+    {
+        out.clear();
+        out.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) out.push_back((*this)[i]);
+    }
+
+    /**
+     * @brief   Calculates the FNV-1a hash of every string, e.g. for building a lookup table.
+     * @param   out The buffer to write the hashes to, at least `size()` elements.
+     */
+    void hashes(uint64_t* out) const
+    {
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            const auto str = (*this)[i];
+            const auto bytes = reinterpret_cast<const uint8_t*>(str.data());
+            uint64_t hash = 0xCBF29CE484222325;
+            for (std::size_t j = 0; j < str.size() * sizeof(CharT); ++j)
+            {
+                hash = (hash ^ bytes[j]) * 0x100000001B3;
+            }
+            out[i] = hash;
+        }
+    }
+
+    /**
+     * @brief   Searches for the first string equal to another one.
+     * @param   needle  The string to search for.
+     * @return  The index of the object, or `npos` if not found.
+     */
+    std::size_t find(const BasicStringRef<CharT>& needle) const
+    {
+        SizeT sizes[kBlockSize];
+        for (std::size_t first = 0; first < size(); first += kBlockSize)
+        {
+            const auto count = size() - first < kBlockSize ? size() - first : kBlockSize;
+            simd::gatherStrided(sizes, &m_sizes[first], m_sizes.stride(), count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (static_cast<std::size_t>(sizes[i]) != needle.size()) continue;
+                if (std::equal(needle.begin(), needle.end(), m_data[first + i])) return first + i;
+            }
+        }
+        return npos;
+    }
+
+    /**
+     * @copydoc find(const BasicStringRef<CharT>&) const
+     */
+    std::size_t find(const CharT* needle) const
+    {
+        return find(BasicStringRef<CharT>{needle, std::char_traits<CharT>::length(needle)});
+    }
+};
+
+template<typename CharT, typename SizeT>
+const std::size_t BasicStringSpan<CharT, SizeT>::npos;
+
+using StringSpan = BasicStringSpan<char>;
+
+/**
+ * @brief   Creates a span covering a `BasicStringViewField` of all objects in a range.
+ * @tparam  WrapperT    The wrapper type of the range.
+ * @tparam  CharT       The character type.
+ * @tparam  SizeT       The type of the length.
+ * @param   range       The range of objects, not empty.
+ * @param   field       The field to create the span for.
+ * @return  The resulting span.
+ */
+template<typename WrapperT, typename CharT, typename SizeT>
+inline BasicStringSpan<CharT, SizeT> makeStringSpan(
+    const WrapperRange<WrapperT>& range, BasicStringViewField<CharT, SizeT> WrapperT::* field)
+{
+    // Offsets are per instance, take them from the first object.
+    auto first = wrapper_cast<WrapperT>(range.first());
+    const auto& prototype = first.*field;
+    return {range.first(), prototype.dataOffset(), prototype.sizeOffset(), range.size(),
+        range.stride()};
+}
+
+} // namespace remodel
+
+#endif // REMODEL_STL_HPP
@@ -0,0 +1,267 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_STREAMINGTABLE_HPP
+#define REMODEL_STREAMINGTABLE_HPP
+
+/**
+ * @file
+ * @brief Contains double-buffered scans of arrays of objects in other processes.
+ *
+ * Arrays too large to copy at once are read in chunks of rows. While the application processes
+ * a chunk through the usual `Table` interface, a reader thread already reads the next one into a
+ * second buffer, so a scan takes about as long as reading the array rather than reading and
+ * processing it one after another:
+ * @code
+ *     ProcessMemory process{pid};
+ *     StreamingTable<Particle> particles{process, particleArray, 50000000};
+ *     float energy = 0.f;
+ *     particles.forEach([&](Particle& cur) { energy += cur.mass * cur.speed * cur.speed; });
+ * @endcode
+ */
+
+#include <stdint.h>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "Memory.hpp"
+#include "Table.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [StreamingTable]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Array of equally spaced objects in another address space, scanned chunk by chunk
+ *          with double buffering.
+ * @tparam  WrapperT    The wrapper (or view) type describing a row.
+ *
+ * Each scan reads the chunks into two alternating local buffers, the next chunk on a reader
+ * thread while the calling thread processes the current one. Rows are wrappers of the local
+ * copies, so pointers stored in the objects still point into the target. The array is read as
+ * `count * stride` bytes, changes to the copies are discarded.
+ */
+template<typename WrapperT>
+class StreamingTable : public zycore::NonCopyable
+{
+    MemoryBackend* m_memory;
+    uintptr_t m_base;
+    std::size_t m_count;
+    std::size_t m_stride;
+    std::size_t m_chunkRows;
+
+    /**
+     * @brief   The hand-over of the buffers between the reader thread and the processing one.
+     */
+    struct Exchange
+    {
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::size_t numRead = 0;
+        std::size_t numProcessed = 0;
+        bool failed = false;
+        bool stop = false;
+    };
+
+    bool readChunk(std::size_t idx, uint8_t* buffer) const
+    {
+        const auto first = idx * m_chunkRows;
+        return m_memory->read(m_base + first * m_stride, buffer, rowsOf(idx) * m_stride);
+    }
+
+    std::size_t rowsOf(std::size_t idx) const
+    {
+        const auto first = idx * m_chunkRows;
+        return m_count - first < m_chunkRows ? m_count - first : m_chunkRows;
+    }
+public:
+    /**
+     * @brief   The size of the chunks used by default, in bytes.
+     */
+    static const std::size_t kDefaultChunkSize = 1024 * 1024;
+
+    /**
+     * @brief   Constructor.
+     * @param   memory      The backend of the address space holding the array, accessed by the
+     *                      reader thread during scans.
+     * @param   base        The address of the first object.
+     * @param   count       The number of objects.
+     * @param   stride      The distance between two objects, in bytes.
+     * @param   chunkRows   The number of rows per chunk, 0 for about `kDefaultChunkSize` bytes.
+     */
+    StreamingTable(MemoryBackend& memory, uintptr_t base, std::size_t count, std::size_t stride,
+            std::size_t chunkRows = 0)
+        : m_memory{&memory}
+        , m_base{base}
+        , m_count{count}
+        , m_stride{stride}
+        , m_chunkRows{chunkRows ? chunkRows
+            : (stride && stride < kDefaultChunkSize ? kDefaultChunkSize / stride : 1)}
+    {}
+
+    /**
+     * @brief   Constructor for arrays of densely packed objects wrapped by advanced wrappers.
+     * @param   memory      The backend of the address space holding the array.
+     * @param   base        The address of the first object.
+     * @param   count       The number of objects.
+     */
+    template<
+        typename U = WrapperT,
+        typename = typename U::IsAdvWrapper /* manual SFINAE */>
+    StreamingTable(MemoryBackend& memory, uintptr_t base, std::size_t count)
+        : StreamingTable{memory, base, count, U::kObjSize}
+    {}
+
+    /**
+     * @brief   Gets the number of objects.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_count; }
+
+    /**
+     * @brief   Gets the distance between two objects.
+     * @return  The distance, in bytes.
+     */
+    std::size_t stride() const { return m_stride; }
+
+    /**
+     * @brief   Gets the number of rows per chunk.
+     * @return  The number of rows, the last chunk may have fewer.
+     */
+    std::size_t chunkRows() const { return m_chunkRows; }
+
+    /**
+     * @brief   Gets the number of chunks.
+     * @return  The number of chunks.
+     */
+    std::size_t numChunks() const { return (m_count + m_chunkRows - 1) / m_chunkRows; }
+
+    /**
+     * @brief   Invokes a function for every chunk, in order.
+     * @param   func    The function, callable as `void(const Table<WrapperT>& chunk,
+     *                  std::size_t first)`, `first` being the index of the first row of the chunk.
+     *                  The chunk is only valid during the call.
+     * @return  @c true if all chunks were read, else @c false. The chunks before a failed one
+     *          are processed anyway.
+     */
+    template<typename FuncT>
+    bool forEachChunk(FuncT&& func) const
+    {
+        const auto numChunks = this->numChunks();
+        if (!numChunks) return true;
+
+        // Cache line aligned, for the alignment of the objects and to keep the reader's writes
+        // off the lines of the chunk being processed.
+        const std::size_t alignment = 64;
+        const auto bufferSize = (m_chunkRows * m_stride + alignment - 1) & ~(alignment - 1);
+        std::unique_ptr<uint8_t[]> storage{
+            new uint8_t[(numChunks > 1 ? 2 : 1) * bufferSize + alignment]};
+        const auto raw = reinterpret_cast<uintptr_t>(storage.get());
+        uint8_t* const buffers[2]{
+            reinterpret_cast<uint8_t*>((raw + alignment - 1) & ~(alignment - 1)),
+            reinterpret_cast<uint8_t*>((raw + alignment - 1) & ~(alignment - 1)) + bufferSize,
+        };
+
+        if (numChunks == 1)
+        {
+            if (!readChunk(0, buffers[0])) return false;
+            func(Table<WrapperT>{buffers[0], m_count, m_stride}, std::size_t{0});
+            return true;
+        }
+
+        Exchange exchange;
+        std::thread reader{[&]
+        {
+            for (std::size_t i = 0; i < numChunks; ++i)
+            {
+                {
+                    // Wait for the buffer to be released.
+                    std::unique_lock<std::mutex> lock{exchange.mutex};
+                    exchange.wakeup.wait(lock,
+                        [&] { return exchange.stop || i - exchange.numProcessed < 2; });
+                    if (exchange.stop) return;
+                }
+                const bool read = readChunk(i, buffers[i % 2]);
+                std::lock_guard<std::mutex> lock{exchange.mutex};
+                if (read) ++exchange.numRead;
+                else exchange.failed = true;
+                exchange.wakeup.notify_all();
+                if (!read) return;
+            }
+        }};
+
+        bool complete = true;
+        for (std::size_t i = 0; i < numChunks; ++i)
+        {
+            {
+                std::unique_lock<std::mutex> lock{exchange.mutex};
+                exchange.wakeup.wait(lock,
+                    [&] { return exchange.failed || exchange.numRead > i; });
+                if (exchange.numRead <= i)
+                {
+                    complete = false;
+                    break;
+                }
+            }
+            func(Table<WrapperT>{buffers[i % 2], rowsOf(i), m_stride}, i * m_chunkRows);
+            std::lock_guard<std::mutex> lock{exchange.mutex};
+            ++exchange.numProcessed;
+            exchange.wakeup.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{exchange.mutex};
+            exchange.stop = true;
+            exchange.wakeup.notify_all();
+        }
+        reader.join();
+        return complete;
+    }
+
+    /**
+     * @brief   Invokes a function for every row, in order, using a single wrapper per chunk.
+     * @param   func    The function, callable as `void(WrapperT&)`.
+     * @return  @c true if all chunks were read, else @c false.
+     */
+    template<typename FuncT>
+    bool forEach(FuncT&& func) const
+    {
+        return forEachChunk([&](const Table<WrapperT>& chunk, std::size_t /*first*/)
+        {
+            for (auto& row : chunk) func(row);
+        });
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_STREAMINGTABLE_HPP
@@ -0,0 +1,215 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_TABLE_HPP
+#define REMODEL_TABLE_HPP
+
+/**
+ * @file
+ * @brief Contains tables of equally spaced foreign objects, accessed by rows and by columns.
+ *
+ * A `Table` is the entry point for bulk processing of arrays of foreign structures, e.g. entity
+ * arrays of known stride: rows are wrappers, columns are `FieldSpan`s feeding `Query`s and SIMD
+ * conversions, and whole tables go to `parallelForEach`:
+ * @code
+ *     Table<Entity> entities{entityArray, entityCount};
+ *     auto weak = where(entities.column(&Entity::hp) < 10);
+ *     entities.forEach(weak, [](Entity& cur) { cur.hp = 100; });
+ *     parallelForEach(entities, [](Entity& cur) { cur.ticks += 1; });
+ * @endcode
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Remodel.hpp"
+#include "Parallel.hpp"
+#include "Query.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [Table]                                                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Array of equally spaced objects of one layout, accessed by rows or columns.
+ * @tparam  WrapperT    The wrapper (or view) type describing a row.
+ *
+ * Just holds the base, count and stride of the array, so it is as cheap to copy as a pointer
+ * and creates wrappers only on demand. Columns are available for `StaticField`s, for the fields
+ * of layouts declared with `REMODEL_FIELDS` (by index) and for raw offsets.
+ */
+template<typename WrapperT>
+class Table
+{
+    void* m_base;
+    std::size_t m_count;
+    std::size_t m_stride;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   base    The raw pointer of the first object.
+     * @param   count   The number of objects.
+     * @param   stride  The distance between two objects, in bytes.
+     */
+    Table(void* base, std::size_t count, std::size_t stride)
+        : m_base{base}
+        , m_count{count}
+        , m_stride{stride}
+    {}
+
+    /**
+     * @brief   Constructor for tables of densely packed objects wrapped by advanced wrappers.
+     * @param   base    The raw pointer of the first object.
+     * @param   count   The number of objects.
+     */
+    template<
+        typename U = WrapperT,
+        typename = typename U::IsAdvWrapper /* manual SFINAE */>
+    Table(void* base, std::size_t count)
+        : Table{base, count, U::kObjSize}
+    {}
+
+    /**
+     * @brief   Gets the raw pointer of the first object.
+     * @return  The raw pointer.
+     */
+    void* base() const { return m_base; }
+
+    /**
+     * @brief   Gets the number of objects.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_count; }
+
+    /**
+     * @brief   Gets the distance between two objects.
+     * @return  The distance, in bytes.
+     */
+    std::size_t stride() const { return m_stride; }
+
+    /**
+     * @brief   Creates a wrapper for a row.
+     * @param   idx The index of the object.
+     * @return  The resulting wrapper.
+     */
+    WrapperT operator [] (std::size_t idx) const { return rows()[idx]; }
+
+    /**
+     * @brief   Gets all rows, iterated with a single rebound wrapper.
+     * @return  The rows.
+     */
+    WrapperRange<WrapperT> rows() const { return {m_base, m_count, m_stride}; }
+
+    typename WrapperRange<WrapperT>::Iterator begin() const { return rows().begin(); }
+    typename WrapperRange<WrapperT>::Iterator end() const { return rows().end(); }
+
+    /**
+     * @brief   Gets a part of the table.
+     * @param   first   The index of the first row.
+     * @param   count   The number of rows.
+     * @return  The rows `[first, first + count)`.
+     */
+    Table slice(std::size_t first, std::size_t count) const
+    {
+        assert(first + count <= m_count);
+        return {static_cast<uint8_t*>(m_base) + first * m_stride, count, m_stride};
+    }
+
+    /**
+     * @brief   Gets the column of a `StaticField`.
+     * @param   field   The field, e.g. `&Entity::hp`.
+     * @return  The span covering the field of all rows.
+     */
+    template<typename T, std::ptrdiff_t offsT>
+    FieldSpan<typename Field<T, StaticOffsGetter<offsT>>::RewrittenT> column(
+        Field<T, StaticOffsGetter<offsT>> WrapperT::* field) const
+    {
+        return makeFieldSpan(rows(), field);
+    }
+
+    /**
+     * @brief   Gets the column of a field of the layout declared with `REMODEL_FIELDS`.
+     * @tparam  idxT    The index of the field in the layout.
+     * @return  The span covering the field of all rows.
+     */
+    template<std::size_t idxT, typename U = WrapperT>
+    FieldSpan<typename U::Layout::template At<idxT>::Access::RewrittenT> column() const
+    {
+        using Entry = typename U::Layout::template At<idxT>;
+        static_assert(!std::is_reference<typename Entry::Type>::value,
+            "columns of references are not supported");
+        return {m_base, Entry::kOffset, m_count, m_stride};
+    }
+
+    /**
+     * @brief   Gets the column of a field not declared in the wrapper.
+     * @tparam  T       The type of the field.
+     * @param   offset  The offset of the field inside of the objects, in bytes.
+     * @return  The span covering the field of all rows.
+     */
+    template<typename T>
+    FieldSpan<T> column(std::ptrdiff_t offset) const
+    {
+        return {m_base, offset, m_count, m_stride};
+    }
+
+    /**
+     * @brief   Invokes a function for every row matching a query, using a single wrapper.
+     * @param   query   The query, formed from columns of this table.
+     * @param   func    The function, callable as `void(WrapperT&)`.
+     */
+    template<typename FuncT>
+    void forEach(const Query& query, FuncT&& func) const
+    {
+        query.forEach(rows(), std::forward<FuncT>(func));
+    }
+};
+
+// Tables are meant to be passed around by value.
+static_assert(sizeof(Table<ClassWrapper>) == 3 * sizeof(void*), "internal library error");
+
+/**
+ * @brief   Invokes a function for every row of a table, distributed over multiple threads.
+ * @tparam  WrapperT    The wrapper type of the table.
+ * @tparam  FuncT       Type of the function, callable as `void(WrapperT&)`.
+ * @param   table       The table.
+ * @param   func        The function, invoked concurrently.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ */
+template<typename WrapperT, typename FuncT>
+inline void parallelForEach(const Table<WrapperT>& table, const FuncT& func,
+    unsigned numThreads = 0)
+{
+    parallelForEach(table.rows(), func, numThreads);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_TABLE_HPP
@@ -0,0 +1,600 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_TRACE_HPP
+#define REMODEL_TRACE_HPP
+
+/**     
+ * @file
+ * @brief Contains low-overhead call tracing for wrapped and hooked functions.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Platform.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64))
+#   include <intrin.h>
+#   define REMODEL_TRACE_RDTSC
+#elif defined(ZYCORE_GNUC) && (defined(__i386__) || defined(__x86_64__))
+#   include <x86intrin.h>
+#   define REMODEL_TRACE_RDTSC
+#endif
+
+#if !defined(REMODEL_TRACE_ARGS)
+    /**
+     * @brief   The number of arguments recorded per call.
+     */
+#   define REMODEL_TRACE_ARGS 4
+#endif
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [CallRecord]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   A traced call.
+ */
+struct CallRecord
+{
+    /**
+     * @brief   The time of the call, in ticks of `CallTracer::now`.
+     */
+    uint64_t timestamp;
+    /**
+     * @brief   The duration of the call, in ticks of `CallTracer::now`.
+     */
+    uint64_t duration;
+    /**
+     * @brief   The ID of the function, see `CallTracer::registerFunction`.
+     */
+    uint32_t functionId;
+    /**
+     * @brief   The ID of the calling thread, see `platform::currentThreadId`.
+     */
+    uint32_t threadId;
+    /**
+     * @brief   The number of recorded arguments, at most `REMODEL_TRACE_ARGS`.
+     */
+    uint32_t numArgs;
+    /**
+     * @brief   The first arguments: integers and enums by value, pointers by address, floating 
+     *          point values as the bits of a @c double and anything else as 0.
+     */
+    uint64_t args[REMODEL_TRACE_ARGS];
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Converts a traced argument, see `CallRecord::args`.
+ */
+template<typename T>
+inline std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value, uint64_t>
+    traceValue(const T& value)
+{
+    return static_cast<uint64_t>(value);
+}
+
+/**
+ * @internal
+ * @copydoc traceValue
+ */
+template<typename T>
+inline std::enable_if_t<std::is_floating_point<T>::value, uint64_t> traceValue(const T& value)
+{
+    const double asDouble = value;
+    uint64_t bits;
+    std::memcpy(&bits, &asDouble, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @internal
+ * @copydoc traceValue
+ */
+template<typename T>
+inline uint64_t traceValue(T* value)
+{
+    return reinterpret_cast<uintptr_t>(value);
+}
+
+/**
+ * @internal
+ * @copydoc traceValue
+ */
+template<typename T>
+inline std::enable_if_t<
+    !std::is_arithmetic<T>::value && !std::is_enum<T>::value && !std::is_pointer<T>::value, 
+    uint64_t> traceValue(const T&)
+{
+    return 0;
+}
+
+/**
+ * @internal
+ * @brief   Stores the first arguments of a call in a record.
+ * @param   record  The record.
+ * @param   args    The arguments.
+ */
+template<typename... ArgsT>
+inline void captureArgs(CallRecord& record, const ArgsT&... args)
+{
+    const uint64_t values[] = {traceValue(args)..., 0};
+    record.numArgs = sizeof...(ArgsT) < REMODEL_TRACE_ARGS 
+        ? static_cast<uint32_t>(sizeof...(ArgsT)) : REMODEL_TRACE_ARGS;
+    std::memcpy(record.args, values, record.numArgs * sizeof(uint64_t));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [TraceRing]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Single-producer single-consumer ring buffer of the calls of one thread.
+ *          
+ * The producer is the traced thread, the consumer whoever drains the tracer. Calls are dropped 
+ * while the ring is full.
+ */
+class TraceRing : public zycore::NonCopyable
+{
+    // Head and tail on their own cache lines, so producer and consumer don't contend.
+    std::atomic<std::size_t> m_head{0};
+    char m_pad0[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_tail{0};
+    char m_pad1[64 - sizeof(std::atomic<std::size_t>)];
+    std::size_t m_mask;
+    uint32_t m_threadId;
+    std::atomic<uint64_t> m_dropped{0};
+    std::unique_ptr<CallRecord[]> m_records;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   capacity    The number of records, rounded up to a power of two.
+     * @param   threadId    The ID of the producing thread.
+     */
+    TraceRing(std::size_t capacity, uint32_t threadId)
+        : m_threadId{threadId}
+    {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_mask = size - 1;
+        m_records.reset(new CallRecord[size]);
+    }
+
+    uint32_t threadId() const { return m_threadId; }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief   Appends a record, producer only.
+     * @param   record  The record, its `threadId` is set.
+     * @return  @c true if appended, @c false if dropped.
+     */
+    bool push(CallRecord& record)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        record.threadId = m_threadId;
+        m_records[head & m_mask] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Removes all records, consumer only.
+     * @param   func    Called with every record.
+     * @return  The number of records.
+     */
+    template<typename FuncT>
+    std::size_t drain(FuncT& func)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        const auto head = m_head.load(std::memory_order_acquire);
+        for (auto i = tail; i != head; ++i)
+        {
+            func(static_cast<const CallRecord&>(m_records[i & m_mask]));
+        }
+        m_tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [CallTracer]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Collects traced calls of all threads.
+ *          
+ * Every thread records into a ring buffer of its own, so recording a call doesn't take locks or
+ * allocate (except for a thread's first call). The records are consumed by `drain`, usually from 
+ * the background thread started by `startDrainer`. Tracing is disabled by default and costs a
+ * single load per call while disabled.
+ * @code
+ *     auto id = CallTracer::global().registerFunction("Player::takeDamage");
+ *     auto tracedTakeDamage = traced(player.takeDamage, id);
+ *     CallTracer::global().startDrainer([](const CallRecord& r) { ... });
+ *     CallTracer::global().enable();
+ *     tracedTakeDamage(10);
+ * @endcode
+ */
+class CallTracer : public zycore::NonCopyable
+{
+    uint64_t m_id;
+    std::atomic<bool> m_enabled{false};
+    std::size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<internal::TraceRing>> m_rings;
+    std::vector<std::string> m_names;
+
+    std::mutex m_drainMutex;
+    std::thread m_drainer;
+    std::mutex m_drainerMutex;
+    std::condition_variable m_drainerWakeup;
+    bool m_stopDrainer = false;
+
+    static uint64_t nextId()
+    {
+        static std::atomic<uint64_t> lastId{0};
+        return ++lastId;
+    }
+
+    internal::TraceRing& registerThread()
+    {
+        // Rings of exited threads are reused by new threads with the same ID.
+        const auto threadId = platform::currentThreadId();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (const auto& ring : m_rings)
+        {
+            if (ring->threadId() == threadId) return *ring;
+        }
+        m_rings.emplace_back(new internal::TraceRing{m_capacity, threadId});
+        return *m_rings.back();
+    }
+
+    internal::TraceRing& ring()
+    {
+        // Cached per thread, for the tracer used last. Tracers are told apart by ID rather than
+        // address, as a new tracer may reuse the address of a destroyed one.
+        static REMODEL_THREAD_LOCAL uint64_t cachedTracer = 0;
+        static REMODEL_THREAD_LOCAL internal::TraceRing* cachedRing = nullptr;
+        if (cachedTracer != m_id)
+        {
+            cachedRing   = &registerThread();
+            cachedTracer = m_id;
+        }
+        return *cachedRing;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   capacity    The number of calls buffered per thread.
+     */
+    explicit CallTracer(std::size_t capacity = 4096)
+        : m_id{nextId()}
+        , m_capacity{capacity}
+    {}
+
+    /**
+     * @brief   Destructor, stopping the drainer.
+     */
+    ~CallTracer() { stopDrainer(); }
+
+    /**
+     * @brief   Gets the tracer used by default.
+     * @return  The tracer.
+     */
+    static CallTracer& global()
+    {
+        static CallTracer tracer;
+        return tracer;
+    }
+
+    /**
+     * @brief   Gets the current time, in ticks of the time stamp counter where available.
+     * @return  The time.
+     */
+    static uint64_t now()
+    {
+#       if defined(REMODEL_TRACE_RDTSC)
+            return __rdtsc();
+#       else
+            return static_cast<uint64_t>(
+                std::chrono::steady_clock::now().time_since_epoch().count());
+#       endif
+    }
+
+    /**
+     * @brief   Measures the frequency of `now`.
+     * @return  The number of ticks per second.
+     *          
+     * Measures for 10 ms on the first call.
+     */
+    static double ticksPerSecond()
+    {
+        static const double ticks = []
+        {
+            const auto startTime  = std::chrono::steady_clock::now();
+            const auto startTicks = now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            const auto elapsed = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - startTime);
+            return static_cast<double>(now() - startTicks) / elapsed.count();
+        }();
+        return ticks;
+    }
+
+    /**
+     * @brief   Enables or disables recording calls.
+     * @param   enabled If @c true, calls are recorded, else ignored.
+     */
+    void enable(bool enabled = true) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief   Determines whether calls are recorded.
+     * @return  @c true if enabled, else @c false.
+     */
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief   Registers a function name.
+     * @param   name    The name.
+     * @return  The ID to record calls of the function with.
+     */
+    uint32_t registerFunction(std::string name)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_names.push_back(std::move(name));
+        return static_cast<uint32_t>(m_names.size() - 1);
+    }
+
+    /**
+     * @brief   Gets the name of a registered function.
+     * @param   functionId  The ID of the function.
+     * @return  The name or an empty string if not registered.
+     */
+    std::string functionName(uint32_t functionId) const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return functionId < m_names.size() ? m_names[functionId] : std::string{};
+    }
+
+    /**
+     * @brief   Records a call of the calling thread.
+     * @param   record  The call. Its `threadId` is set.
+     * @return  @c true if recorded, @c false if the thread's buffer is full.
+     */
+    bool record(CallRecord& record) { return ring().push(record); }
+
+    /**
+     * @brief   Gets the number of calls dropped as the buffers were full.
+     * @return  The number of dropped calls.
+     */
+    uint64_t dropped() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        uint64_t dropped = 0;
+        for (const auto& ring : m_rings) dropped += ring->dropped();
+        return dropped;
+    }
+
+    /**
+     * @brief   Removes all recorded calls.
+     * @tparam  FuncT   The function type, `void(const CallRecord&)`.
+     * @param   func    Called with every call, in order per thread.
+     * @return  The number of calls.
+     */
+    template<typename FuncT>
+    std::size_t drain(FuncT func)
+    {
+        std::lock_guard<std::mutex> drainLock{m_drainMutex};
+        std::vector<internal::TraceRing*> rings;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            for (const auto& ring : m_rings) rings.push_back(ring.get());
+        }
+
+        std::size_t numRecords = 0;
+        for (auto ring : rings) numRecords += ring->drain(func);
+        return numRecords;
+    }
+
+    /**
+     * @brief   Starts a background thread draining the recorded calls periodically.
+     * @param   sink        Called with every call, on the background thread.
+     * @param   interval    The time between draining.
+     *          
+     * A running drainer is stopped first.
+     */
+    void startDrainer(std::function<void(const CallRecord&)> sink, 
+        std::chrono::milliseconds interval = std::chrono::milliseconds(10))
+    {
+        stopDrainer();
+        m_stopDrainer = false;
+        m_drainer = std::thread{[this, sink, interval]
+        {
+            std::unique_lock<std::mutex> lock{m_drainerMutex};
+            while (!m_stopDrainer)
+            {
+                m_drainerWakeup.wait_for(lock, interval);
+                drain(std::cref(sink));
+            }
+        }};
+    }
+
+    /**
+     * @brief   Stops the background thread after draining the remaining calls.
+     */
+    void stopDrainer()
+    {
+        if (!m_drainer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock{m_drainerMutex};
+            m_stopDrainer = true;
+        }
+        m_drainerWakeup.notify_all();
+        m_drainer.join();
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [TraceScope]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Records a call from its construction until its destruction.
+ *          
+ * Meant for detours and other code calling functions not wrapped with `traced`:
+ * @code
+ *     int detour(int x)
+ *     {
+ *         TraceScope scope{detourId, x};
+ *         return hook->original()(x);
+ *     }
+ * @endcode
+ */
+class TraceScope : public zycore::NonCopyable
+{
+    CallTracer* m_tracer;
+    CallRecord m_record;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   tracer      The tracer recording the call.
+     * @param   functionId  The ID of the function.
+     * @param   args        The arguments to record.
+     */
+    template<typename... ArgsT>
+    explicit TraceScope(CallTracer& tracer, uint32_t functionId, const ArgsT&... args)
+        : m_tracer{tracer.isEnabled() ? &tracer : nullptr}
+    {
+        if (!m_tracer) return;
+        m_record.functionId = functionId;
+        internal::captureArgs(m_record, args...);
+        m_record.timestamp = CallTracer::now();
+    }
+
+    /**
+     * @brief   Constructor, recording with the global tracer.
+     * @param   functionId  The ID of the function.
+     * @param   args        The arguments to record.
+     */
+    template<typename... ArgsT>
+    explicit TraceScope(uint32_t functionId, const ArgsT&... args)
+        : TraceScope{CallTracer::global(), functionId, args...}
+    {}
+
+    /**
+     * @brief   Destructor, recording the call.
+     */
+    ~TraceScope()
+    {
+        if (!m_tracer) return;
+        m_record.duration = CallTracer::now() - m_record.timestamp;
+        m_tracer->record(m_record);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [Traced]                                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Callable recording the calls of another callable.
+ * @tparam  FuncT   The type of the traced callable, e.g. a `Function` or `MemberFunction`.
+ *          
+ * Create instances with `traced`.
+ */
+template<typename FuncT>
+class Traced
+{
+    const FuncT* m_func;
+    uint32_t m_functionId;
+    CallTracer* m_tracer;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   func        The traced callable, must outlive the instance.
+     * @param   functionId  The ID to record calls with.
+     * @param   tracer      The tracer recording the calls.
+     */
+    Traced(const FuncT& func, uint32_t functionId, CallTracer& tracer)
+        : m_func{&func}
+        , m_functionId{functionId}
+        , m_tracer{&tracer}
+    {}
+
+    template<typename... ArgsT>
+    auto operator () (ArgsT&&... args) const
+        -> decltype(std::declval<const FuncT&>()(std::forward<ArgsT>(args)...))
+    {
+        TraceScope scope{*m_tracer, m_functionId, args...};
+        return (*m_func)(std::forward<ArgsT>(args)...);
+    }
+};
+
+/**
+ * @brief   Wraps a callable to record its calls.
+ * @param   func        The callable, e.g. a `Function`, `MemberFunction` or `Hook::original()`. 
+ *                      Must outlive the result.
+ * @param   functionId  The ID to record calls with, see `CallTracer::registerFunction`.
+ * @param   tracer      The tracer recording the calls.
+ * @return  The wrapped callable.
+ */
+template<typename FuncT>
+inline Traced<FuncT> traced(
+    const FuncT& func, uint32_t functionId, CallTracer& tracer = CallTracer::global())
+{
+    return Traced<FuncT>{func, functionId, tracer};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_TRACE_HPP
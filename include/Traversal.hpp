@@ -0,0 +1,319 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_TRAVERSAL_HPP
+#define REMODEL_TRAVERSAL_HPP
+
+/**
+ * @file
+ * @brief Contains iterators and walkers for foreign linked lists and trees.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Memory.hpp"
+
+namespace remodel
+{
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Reads a pointer field of an object.
+ * @param   reader  A wrapper that is rebound to the object.
+ * @param   link    The pointer field.
+ * @param   node    The raw pointer of the object.
+ * @return  The value of the field.
+ */
+template<typename WrapperT, typename FieldT>
+inline void* readLink(WrapperT& reader, FieldT WrapperT::* link, void* node)
+{
+    reader.rebind(node);
+    return const_cast<void*>(static_cast<const void*>(*(reader.*link).addressOfObj()));
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [ListRange]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Range of the nodes of a foreign singly linked list.
+ * @tparam  WrapperT    The wrapper type of the nodes.
+ * @tparam  FieldT      The type of the field pointing to the next node.
+ *
+ * The iterators stay two nodes ahead of the current one: while a node is processed, the node
+ * after the next one is prefetched, so following the links overlaps with the work done per node
+ * instead of stalling on a cache miss each. Like with `WrapperRange`, the iterators rebind a
+ * wrapper rather than creating a new one per node. Create ranges with `makeListRange`.
+ *
+ * Lists linking to a member of the next node (e.g. an embedded list entry) are supported by a
+ * link offset, circular lists by a sentinel link value ending the iteration.
+ *
+ * @note    Dereferencing an iterator yields a reference to the wrapper stored inside of the
+ *          iterator, which stays valid only until the iterator is advanced or destroyed.
+ */
+template<typename WrapperT, typename FieldT>
+class ListRange
+{
+    void* m_head;
+    FieldT WrapperT::* m_link;
+    std::ptrdiff_t m_linkOffset;
+    const void* m_sentinel;
+public:
+    /**
+     * @brief   Iterator type of the range.
+     */
+    class Iterator
+    {
+        WrapperT m_wrapper;
+        WrapperT m_reader;
+        const ListRange* m_range;
+        void* m_cur;
+        void* m_next = nullptr;
+        void* m_nextNext = nullptr;
+
+        void* follow(void* node)
+        {
+            if (!node) return nullptr;
+            auto link = internal::readLink(m_reader, m_range->m_link, node);
+            if (!link || link == m_range->m_sentinel) return nullptr;
+            return static_cast<uint8_t*>(link) - m_range->m_linkOffset;
+        }
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = WrapperT;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = WrapperT*;
+        using reference         = WrapperT&;
+
+        /**
+         * @brief   Constructor.
+         * @param   range   The range iterated.
+         * @param   node    The raw pointer of the current node or @c nullptr for the end.
+         */
+        Iterator(const ListRange& range, void* node)
+            : m_wrapper{wrapper_cast<WrapperT>(node)}
+            , m_reader{wrapper_cast<WrapperT>(node)}
+            , m_range{&range}
+            , m_cur{node}
+        {
+            m_next = follow(m_cur);
+            m_nextNext = follow(m_next);
+            if (m_nextNext) REMODEL_PREFETCH(m_nextNext);
+        }
+
+        WrapperT& operator * () { return m_wrapper; }
+        WrapperT* operator -> () { return m_wrapper.addressOfWrapper(); }
+
+        Iterator& operator ++ ()
+        {
+            m_cur = m_next;
+            m_next = m_nextNext;
+            // Reads the node prefetched by the previous step.
+            m_nextNext = follow(m_next);
+            if (m_nextNext) REMODEL_PREFETCH(m_nextNext);
+            m_wrapper.rebind(m_cur);
+            return *this;
+        }
+
+        bool operator == (const Iterator& rhs) const { return m_cur == rhs.m_cur; }
+        bool operator != (const Iterator& rhs) const { return !(*this == rhs); }
+    };
+
+    /**
+     * @brief   Constructor.
+     * @param   head        The raw pointer of the first node or @c nullptr for an empty list.
+     * @param   link        The field pointing to the next node.
+     * @param   linkOffset  The offset of the linked member inside of the nodes, in bytes.
+     * @param   sentinel    The link value ending the list in addition to @c nullptr.
+     */
+    ListRange(void* head, FieldT WrapperT::* link, std::ptrdiff_t linkOffset = 0,
+            const void* sentinel = nullptr)
+        : m_head{head}
+        , m_link{link}
+        , m_linkOffset{linkOffset}
+        , m_sentinel{sentinel}
+    {}
+
+    Iterator begin() const { return {*this, m_head}; }
+    Iterator end() const { return {*this, nullptr}; }
+};
+
+/**
+ * @brief   Creates a range of the nodes of a foreign singly linked list.
+ * @param   head        The raw pointer of the first node or @c nullptr for an empty list.
+ * @param   link        The field pointing to the next node, e.g. `&Node::next`.
+ * @param   linkOffset  The offset of the linked member inside of the nodes, in bytes.
+ * @param   sentinel    The link value ending the list in addition to @c nullptr.
+ * @return  The range.
+ *
+ * @code
+ *     for (auto& entity : makeListRange(world.firstEntity, &Entity::next))
+ *     {
+ *         entity.health = 100;
+ *     }
+ * @endcode
+ */
+template<typename WrapperT, typename FieldT>
+inline ListRange<WrapperT, FieldT> makeListRange(void* head, FieldT WrapperT::* link,
+    std::ptrdiff_t linkOffset = 0, const void* sentinel = nullptr)
+{
+    return {head, link, linkOffset, sentinel};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [walkTree]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Visits all nodes of a foreign tree in pre-order.
+ * @param   root    The raw pointer of the root node or @c nullptr for an empty tree.
+ * @param   visit   Function called with a wrapper for every node.
+ * @param   first   The first field pointing to a child node.
+ * @param   rest    The other fields pointing to child nodes.
+ * @return  The number of nodes visited.
+ *
+ * Children are prefetched as soon as their parent was visited. The nodes are expected to form a
+ * tree, shared or cyclic links make nodes visited repeatedly.
+ * @code
+ *     walkTree(map.root, [](Entry& entry) { ... }, &Entry::left, &Entry::right);
+ * @endcode
+ */
+template<typename WrapperT, typename FuncT, typename FirstT, typename... RestT>
+inline std::size_t walkTree(void* root, FuncT visit, FirstT WrapperT::* first,
+    RestT WrapperT::*... rest)
+{
+    std::vector<void*> stack;
+    if (root) stack.push_back(root);
+
+    auto wrapper = wrapper_cast<WrapperT>(root);
+    std::size_t count = 0;
+    while (!stack.empty())
+    {
+        auto node = stack.back();
+        stack.pop_back();
+        wrapper.rebind(node);
+        visit(wrapper);
+        ++count;
+
+        // Pushed in reverse, so the first child is visited next.
+        void* children[] = {
+            internal::readLink(wrapper, first, node), internal::readLink(wrapper, rest, node)...
+        };
+        for (std::size_t i = sizeof(children) / sizeof(children[0]); i--;)
+        {
+            if (!children[i]) continue;
+            REMODEL_PREFETCH(children[i]);
+            stack.push_back(children[i]);
+        }
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [walkRemoteList] + [walkRemoteTree]                                                            //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Visits all nodes of a linked list in another address space.
+ * @param   memory  The memory backend to read from.
+ * @param   head    The address of the first node or 0 for an empty list.
+ * @param   visit   Function called with a `RemoteSnapshot` of every node.
+ * @param   link    The field pointing to the next node.
+ * @return  @c true if all nodes could be read, else @c false.
+ *
+ * Every node depends on the previous one, so each costs one read of the backend.
+ */
+template<typename WrapperT, typename FuncT, typename FieldT>
+inline bool walkRemoteList(MemoryBackend& memory, uintptr_t head, FuncT visit,
+    FieldT WrapperT::* link)
+{
+    for (auto cur = head; cur;)
+    {
+        RemoteSnapshot<WrapperT> node{memory, cur};
+        if (!node.refresh()) return false;
+        visit(node);
+        cur = reinterpret_cast<uintptr_t>(*(node.*link).addressOfObj());
+    }
+    return true;
+}
+
+/**
+ * @brief   Visits all nodes of a tree in another address space, level by level.
+ * @param   memory  The memory backend to read from.
+ * @param   root    The address of the root node or 0 for an empty tree.
+ * @param   visit   Function called with a `RemoteSnapshot` of every node.
+ * @param   first   The first field pointing to a child node.
+ * @param   rest    The other fields pointing to child nodes.
+ * @return  @c true if all nodes could be read, else @c false.
+ *
+ * All nodes of a level are read with one `ReadBatch`, so the number of round trips to the
+ * backend is the depth of the tree rather than the number of nodes. Nodes are visited in
+ * breadth-first order.
+ */
+template<typename WrapperT, typename FuncT, typename FirstT, typename... RestT>
+inline bool walkRemoteTree(MemoryBackend& memory, uintptr_t root, FuncT visit,
+    FirstT WrapperT::* first, RestT WrapperT::*... rest)
+{
+    std::vector<uintptr_t> level;
+    if (root) level.push_back(root);
+
+    ReadBatch batch{memory};
+    std::vector<RemoteSnapshot<WrapperT>> nodes;
+    while (!level.empty())
+    {
+        nodes.clear();
+        nodes.reserve(level.size());
+        for (auto address : level) nodes.emplace_back(memory, address);
+        batch.clear();
+        for (auto& node : nodes) batch.add(node);
+        if (!batch.submit()) return false;
+
+        level.clear();
+        for (auto& node : nodes)
+        {
+            visit(node);
+            uintptr_t children[] = {
+                reinterpret_cast<uintptr_t>(*(node.*first).addressOfObj()),
+                reinterpret_cast<uintptr_t>(*(node.*rest).addressOfObj())...
+            };
+            for (auto child : children)
+            {
+                if (child) level.push_back(child);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace remodel
+
+#endif // REMODEL_TRAVERSAL_HPP
@@ -0,0 +1,801 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_WATCH_HPP
+#define REMODEL_WATCH_HPP
+
+/**
+ * @file
+ * @brief Contains engines notifying about changes of fields, by polling or by hardware
+ *        watchpoints.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Remodel.hpp"
+#include "Memory.hpp"
+#include "Platform.hpp"
+
+#if (defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)) \
+    && (defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64))
+#   define REMODEL_HARDWARE_WATCH_SUPPORTED
+#elif defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+#   include <linux/hw_breakpoint.h>
+#   include <linux/perf_event.h>
+    // Synchronous SIGTRAPs for perf events (`sigtrap`, `sig_data`) came with Linux 5.13.
+#   if defined(PERF_ATTR_SIZE_VER7)
+#       define REMODEL_HARDWARE_WATCH_SUPPORTED
+#   endif
+#endif
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [WatchSet]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Set of watched fields, polled for changes all at once.
+ *
+ * The watched ranges are grouped by lines of a fixed granularity (e.g. cache lines or pages) and
+ * every line is read only once per poll, no matter how many watches it contains. All lines are
+ * read with a single `ReadBatch`, so for `ProcessMemory` a poll of thousands of watches costs a
+ * single system call. Callbacks are invoked with the old and the new value of changed fields.
+ *
+ * Fields of local objects are watched through a `LocalMemory` backend, fields of remote objects
+ * through the `RemoteSnapshot` they belong to:
+ * @code
+ *     LocalMemory local;
+ *     WatchSet watches{local};
+ *     watches.watch(dog.age, [](int oldAge, int newAge) { ... });
+ *     for (;;)
+ *     {
+ *         watches.poll();
+ *         std::this_thread::sleep_for(std::chrono::milliseconds{16});
+ *     }
+ * @endcode
+ */
+class WatchSet
+{
+public:
+    /**
+     * @brief   Identifies a watch of a set.
+     */
+    using Id = std::size_t;
+
+    /**
+     * @brief   Callback type of raw watches, called with the old and the new bytes.
+     */
+    using RawCallback = std::function<void(const void* oldValue, const void* newValue)>;
+private:
+    struct Watch
+    {
+        Id id;
+        uintptr_t address;
+        std::size_t size;
+        RawCallback callback;
+        // The offset of the field's current value in `m_lines`.
+        std::size_t lineOffset;
+        // The offset of the field's previous value in `m_previous`.
+        std::size_t previousOffset;
+        // Whether the previous value was read yet.
+        bool primed;
+    };
+
+    struct Run
+    {
+        uintptr_t address;
+        std::size_t size;
+        std::size_t offset;
+    };
+
+    MemoryBackend* m_memory;
+    std::size_t m_granularity;
+    std::vector<Watch> m_watches;
+    Id m_nextId = 0;
+    // Contiguous ranges of lines, their contents and the values seen by the last poll.
+    std::vector<Run> m_runs;
+    std::vector<uint8_t> m_lines;
+    std::vector<uint8_t> m_previous;
+    bool m_dirty = false;
+    ReadBatch m_batch;
+
+    void rebuild()
+    {
+        std::vector<uintptr_t> lines;
+        for (const auto& cur : m_watches)
+        {
+            const auto last = (cur.address + cur.size - 1) & ~(m_granularity - 1);
+            for (auto line = cur.address & ~(m_granularity - 1); line <= last;
+                line += m_granularity)
+            {
+                lines.push_back(line);
+            }
+        }
+        std::sort(lines.begin(), lines.end());
+        lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+
+        m_runs.clear();
+        std::size_t total = 0;
+        for (auto line : lines)
+        {
+            if (!m_runs.empty() && m_runs.back().address + m_runs.back().size == line)
+            {
+                m_runs.back().size += m_granularity;
+            }
+            else
+            {
+                m_runs.push_back({line, m_granularity, total});
+            }
+            total += m_granularity;
+        }
+        m_lines.assign(total, 0);
+
+        // Previous values are kept, so that no change is lost by adding or removing watches.
+        std::vector<uint8_t> previous;
+        for (auto& cur : m_watches)
+        {
+            auto run = std::upper_bound(m_runs.begin(), m_runs.end(), cur.address,
+                [](uintptr_t address, const Run& run) { return address < run.address; }) - 1;
+            cur.lineOffset = run->offset + (cur.address - run->address);
+
+            const auto offset = previous.size();
+            previous.resize(offset + cur.size);
+            if (cur.primed)
+            {
+                std::memcpy(&previous[offset], &m_previous[cur.previousOffset], cur.size);
+            }
+            cur.previousOffset = offset;
+        }
+        m_previous.swap(previous);
+
+        m_batch.clear();
+        for (const auto& run : m_runs) m_batch.add(run.address, &m_lines[run.offset], run.size);
+        m_dirty = false;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   memory      The memory backend to read from.
+     * @param   granularity The size of the lines read, in bytes. Required to be a power of two
+     *                      not exceeding the page size, so that lines never reach into pages
+     *                      containing no watched field.
+     */
+    explicit WatchSet(MemoryBackend& memory, std::size_t granularity = 64)
+        : m_memory{&memory}
+        , m_granularity{granularity}
+        , m_batch{memory}
+    {}
+
+    /**
+     * @brief   Watches a range of bytes.
+     * @param   address     The address of the range in the address space of the backend.
+     * @param   size        The size of the range, in bytes.
+     * @param   callback    Called with pointers to the old and the new bytes on change.
+     * @return  The id of the watch.
+     */
+    Id watch(uintptr_t address, std::size_t size, RawCallback callback)
+    {
+        const Id id = m_nextId++;
+        if (size) m_watches.push_back({id, address, size, std::move(callback), 0, 0, false});
+        m_dirty = true;
+        return id;
+    }
+
+    /**
+     * @brief   Watches a field of a local object.
+     * @param   field       The field, of a trivially copyable type `T`.
+     * @param   onChange    Called as `onChange(const T& oldValue, const T& newValue)` on change.
+     * @return  The id of the watch.
+     *
+     * Requires the backend to be a `LocalMemory`.
+     */
+    template<typename FieldT, typename FuncT>
+    Id watch(FieldT& field, FuncT onChange)
+    {
+        return watchTyped(field, reinterpret_cast<uintptr_t>(field.addressOfObj()),
+            std::move(onChange));
+    }
+
+    /**
+     * @brief   Watches a field of a remote object.
+     * @param   snap        The snapshot the field belongs to, determining the remote address.
+     * @param   field       The field, required to be a field of @c snap.
+     * @param   onChange    Called as `onChange(const T& oldValue, const T& newValue)` on change.
+     * @return  The id of the watch.
+     *
+     * The snapshot itself isn't updated by polls, it only needs to live while registering.
+     */
+    template<typename WrapperT, typename FieldT, typename FuncT>
+    Id watch(RemoteSnapshot<WrapperT>& snap, FieldT& field, FuncT onChange)
+    {
+        auto local = reinterpret_cast<const uint8_t*>(field.addressOfObj());
+        return watchTyped(field,
+            snap.source() + (local - static_cast<const uint8_t*>(snap.addressOfObj())),
+            std::move(onChange));
+    }
+
+    /**
+     * @brief   Removes a watch.
+     * @param   id  The id of the watch.
+     * @return  @c true if removed, @c false if no such watch exists.
+     */
+    bool unwatch(Id id)
+    {
+        auto it = std::find_if(m_watches.begin(), m_watches.end(),
+            [id](const Watch& cur) { return cur.id == id; });
+        if (it == m_watches.end()) return false;
+        m_watches.erase(it);
+        m_dirty = true;
+        return true;
+    }
+
+    /**
+     * @brief   Gets the number of watches.
+     * @return  The number of watches.
+     */
+    std::size_t size() const { return m_watches.size(); }
+
+    /**
+     * @brief   Gets the number of bytes read by a poll.
+     * @return  The number of bytes.
+     */
+    std::size_t bytesPerPoll()
+    {
+        if (m_dirty) rebuild();
+        return m_lines.size();
+    }
+
+    /**
+     * @brief   Reads all watched fields and invokes the callbacks of those that changed.
+     * @return  @c true on success, @c false if reading failed. Nothing is reported then.
+     *
+     * The first poll of a new watch only records the current value. Callbacks may add or
+     * remove watches; the remaining changes are then reported by the next poll.
+     */
+    bool poll()
+    {
+        if (m_dirty) rebuild();
+        if (m_watches.empty()) return true;
+        if (!m_batch.submit()) return false;
+
+        std::vector<uint8_t> old;
+        for (std::size_t i = 0; i < m_watches.size() && !m_dirty; ++i)
+        {
+            auto& cur = m_watches[i];
+            auto current = &m_lines[cur.lineOffset];
+            auto previous = &m_previous[cur.previousOffset];
+            if (cur.primed && std::memcmp(current, previous, cur.size) != 0)
+            {
+                old.assign(previous, previous + cur.size);
+                std::memcpy(previous, current, cur.size);
+                // Copied, as the callback may remove its own watch.
+                auto callback = cur.callback;
+                callback(old.data(), current);
+            }
+            else
+            {
+                std::memcpy(previous, current, cur.size);
+                cur.primed = true;
+            }
+        }
+        return true;
+    }
+private:
+    template<typename FieldT, typename FuncT>
+    Id watchTyped(FieldT& field, uintptr_t address, FuncT onChange)
+    {
+        using T = std::remove_cv_t<std::remove_pointer_t<decltype(field.addressOfObj())>>;
+        static_assert(std::is_trivially_copyable<T>::value,
+            "watched fields are required to be trivially copyable");
+        return watch(address, sizeof(T), [onChange](const void* oldValue, const void* newValue)
+        {
+            T oldCopy, newCopy;
+            std::memcpy(&oldCopy, oldValue, sizeof(T));
+            std::memcpy(&newCopy, newValue, sizeof(T));
+            onChange(oldCopy, newCopy);
+        });
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [HardwareWatch]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+#if defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   One of the four x86 debug registers, as used by `HardwareWatch`.
+ */
+struct HardwareWatchSlot
+{
+    std::atomic<bool> armed{false};
+    // Number of threads currently running the handler, so disarming can wait for them.
+    std::atomic<uint32_t> busy{0};
+    uintptr_t address = 0;
+    std::size_t size = 0;
+    std::function<void(uintptr_t address)> handler;
+#   if defined(__linux__)
+        std::vector<int> events;
+#   endif
+
+    /**
+     * @internal
+     * @brief   Calls the handler, if the slot is armed.
+     */
+    void dispatch()
+    {
+        busy.fetch_add(1, std::memory_order_acq_rel);
+        if (armed.load(std::memory_order_acquire)) handler(address);
+        busy.fetch_sub(1, std::memory_order_release);
+    }
+};
+
+/**
+ * @internal
+ * @brief   State shared by all `HardwareWatch`es and the trap handler.
+ */
+struct HardwareWatchState
+{
+    static const std::size_t kNumSlots = 4;
+
+    HardwareWatchSlot slots[kNumSlots];
+    // Serializes arming and disarming.
+    std::mutex mutex;
+#   if defined(__linux__)
+        struct sigaction previous;
+#   endif
+
+    static HardwareWatchState& global()
+    {
+        static HardwareWatchState state;
+        return state;
+    }
+};
+
+#if defined(__linux__)
+
+/**
+ * @internal
+ * @brief   Tag identifying our perf events in `si_perf_data`, the slot index is or'ed in.
+ */
+const unsigned long kHardwareWatchTag = 0x524D0000;
+
+/**
+ * @internal
+ * @brief   `si_code` of SIGTRAPs raised by perf events (missing in older C library headers).
+ */
+const int kTrapPerf = 6;
+
+/**
+ * @internal
+ * @brief   SIGTRAP handler dispatching hits to the slots, chaining to the previous handler for
+ *          all other traps.
+ */
+inline void hardwareWatchHandler(int signal, siginfo_t* info, void* context)
+{
+    auto& state = HardwareWatchState::global();
+    if (info->si_code == kTrapPerf)
+    {
+        // The C library doesn't expose `si_perf_data`, it follows the fault address.
+        unsigned long data;
+        std::memcpy(&data, reinterpret_cast<const uint8_t*>(&info->si_addr) + sizeof(void*),
+            sizeof(data));
+        if ((data & ~0xFFul) == kHardwareWatchTag && (data & 0xFF) < state.kNumSlots)
+        {
+            state.slots[data & 0xFF].dispatch();
+            return;
+        }
+    }
+
+    const auto& previous = state.previous;
+    if (previous.sa_flags & SA_SIGINFO)
+    {
+        previous.sa_sigaction(signal, info, context);
+    }
+    else if (previous.sa_handler == SIG_DFL)
+    {
+        // Terminates the process, like the trap would have without us.
+        ::signal(signal, SIG_DFL);
+        raise(signal);
+    }
+    else if (previous.sa_handler != SIG_IGN)
+    {
+        previous.sa_handler(signal);
+    }
+}
+
+/**
+ * @internal
+ * @brief   Arms a slot by opening a breakpoint perf event for every thread of the process.
+ * @param   idx     The index of the slot.
+ * @return  @c true if succeeded, else @c false.
+ *
+ * The events are inherited by threads created later on, but only by those created by threads
+ * that existed at this point.
+ */
+inline bool armHardwareWatch(std::size_t idx)
+{
+    static std::once_flag installed;
+    std::call_once(installed, []
+    {
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_sigaction = &hardwareWatchHandler;
+        action.sa_flags     = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGTRAP, &action, &HardwareWatchState::global().previous);
+    });
+
+    auto& slot = HardwareWatchState::global().slots[idx];
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_BREAKPOINT;
+    attr.size           = sizeof(attr);
+    attr.bp_type        = HW_BREAKPOINT_W;
+    attr.bp_addr        = slot.address;
+    attr.bp_len         = slot.size;
+    attr.sample_period  = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.inherit        = 1;
+    attr.inherit_thread = 1;
+    attr.remove_on_exec = 1;
+    attr.sigtrap        = 1;
+    attr.sig_data       = kHardwareWatchTag | idx;
+
+    auto dir = opendir("/proc/self/task");
+    if (!dir) return false;
+    bool ok = true;
+    while (auto entry = readdir(dir))
+    {
+        auto tid = static_cast<pid_t>(atoi(entry->d_name));
+        if (tid <= 0) continue;
+        const auto fd = static_cast<int>(
+            syscall(SYS_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        if (fd >= 0)
+        {
+            slot.events.push_back(fd);
+        }
+        else if (errno != ESRCH) // Threads that exited meanwhile fail with ESRCH.
+        {
+            ok = false;
+            break;
+        }
+    }
+    closedir(dir);
+    return ok && !slot.events.empty();
+}
+
+/**
+ * @internal
+ * @brief   Disarms a slot, also removing the events inherited from its events.
+ * @param   idx     The index of the slot.
+ */
+inline void disarmHardwareWatch(std::size_t idx)
+{
+    auto& slot = HardwareWatchState::global().slots[idx];
+    for (auto fd : slot.events) close(fd);
+    slot.events.clear();
+}
+
+#else // Windows
+
+/**
+ * @internal
+ * @brief   Vectored exception handler dispatching hits to the slots.
+ */
+inline LONG CALLBACK hardwareWatchHandler(EXCEPTION_POINTERS* info)
+{
+    if (info->ExceptionRecord->ExceptionCode != EXCEPTION_SINGLE_STEP)
+    {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    auto& state = HardwareWatchState::global();
+    auto& context = *info->ContextRecord;
+    bool handled = false;
+    for (std::size_t i = 0; i < state.kNumSlots; ++i)
+    {
+        if (!(context.Dr6 & (1u << i)) || !state.slots[i].armed.load()) continue;
+        state.slots[i].dispatch();
+        handled = true;
+    }
+    if (!handled) return EXCEPTION_CONTINUE_SEARCH;
+    context.Dr6 = 0;
+    return EXCEPTION_CONTINUE_EXECUTION;
+}
+
+/**
+ * @internal
+ * @brief   Loads the armed slots into the debug registers of all threads of the process.
+ * @return  @c true if succeeded, else @c false.
+ *
+ * The context of the calling thread can't be changed while it is running, so the registers are
+ * set from a helper thread. Threads created later on don't inherit the registers.
+ */
+inline bool applyHardwareWatches()
+{
+    static std::once_flag installed;
+    std::call_once(installed, [] { AddVectoredExceptionHandler(1, &hardwareWatchHandler); });
+
+    auto& state = HardwareWatchState::global();
+    DWORD_PTR addresses[HardwareWatchState::kNumSlots] = {};
+    DWORD_PTR dr7 = 0;
+    for (std::size_t i = 0; i < state.kNumSlots; ++i)
+    {
+        const auto& slot = state.slots[i];
+        if (!slot.size) continue;
+        // Length encoding: 1 -> 00, 2 -> 01, 8 -> 10, 4 -> 11; RW 01 breaks on writes.
+        const DWORD_PTR len = slot.size == 1 ? 0 : slot.size == 2 ? 1 : slot.size == 8 ? 2 : 3;
+        addresses[i] = slot.address;
+        dr7 |= DWORD_PTR{1} << (i * 2) | (DWORD_PTR{1} | len << 2) << (16 + i * 4);
+    }
+
+    bool ok = false;
+    std::thread helper{[&]
+    {
+        auto snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) return;
+        const auto pid  = GetCurrentProcessId();
+        const auto self = GetCurrentThreadId();
+        ok = true;
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof(entry);
+        for (auto more = Thread32First(snapshot, &entry); more;
+            more = Thread32Next(snapshot, &entry))
+        {
+            if (entry.th32OwnerProcessID != pid || entry.th32ThreadID == self) continue;
+            auto thread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT
+                | THREAD_SET_CONTEXT, FALSE, entry.th32ThreadID);
+            if (!thread) continue; // Exited meanwhile.
+            if (SuspendThread(thread) != static_cast<DWORD>(-1))
+            {
+                CONTEXT context;
+                context.ContextFlags = CONTEXT_DEBUG_REGISTERS;
+                if (GetThreadContext(thread, &context))
+                {
+                    context.Dr0 = addresses[0];
+                    context.Dr1 = addresses[1];
+                    context.Dr2 = addresses[2];
+                    context.Dr3 = addresses[3];
+                    context.Dr7 = dr7;
+                    ok = SetThreadContext(thread, &context) && ok;
+                }
+                ResumeThread(thread);
+            }
+            CloseHandle(thread);
+        }
+        CloseHandle(snapshot);
+    }};
+    helper.join();
+    return ok;
+}
+
+inline bool armHardwareWatch(std::size_t) { return applyHardwareWatches(); }
+inline void disarmHardwareWatch(std::size_t) { applyHardwareWatches(); }
+
+#endif
+
+} // namespace internal
+
+#endif // defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+
+/**
+ * @brief   Watches a few fields with the debug registers of the CPU, calling a handler right
+ *          after every write.
+ *
+ * Other than polling with a `WatchSet`, watched fields cost nothing until they're written to,
+ * and no write is missed. The handler runs on the writing thread, right behind the writing
+ * instruction. x86 CPUs have just four debug registers, shared by all `HardwareWatch`es of the
+ * process, and the fields need to be 1, 2, 4 or (on x86-64) 8 bytes large and aligned to their
+ * size. Watching fails in all other cases, so fields can fall back to polling:
+ * @code
+ *     HardwareWatch hardware;
+ *     WatchSet polled{local};
+ *     if (!hardware.watch(player.health, [](int32_t health) { ... }).hasValue())
+ *     {
+ *         polled.watch(player.health, [](int32_t, int32_t health) { ... });
+ *     }
+ * @endcode
+ *
+ * On Linux, the debug registers are armed through breakpoint perf events (`perf_event_open`,
+ * requiring Linux 5.13) delivering a synchronous SIGTRAP, whose handler stays installed and
+ * chains to the one installed before. Threads started later on are covered if they are started
+ * by a thread that existed when the field was watched. On Windows, the registers are set in the
+ * contexts of all threads and hits are dispatched by a vectored exception handler; threads
+ * started later on aren't covered. Only supported for x86 and x86-64 on Windows and Linux,
+ * `isSupported` returns @c false elsewhere.
+ *
+ * @note    Handlers run in signal (or exception) context: they must not allocate, take locks or
+ *          write watched fields themselves.
+ */
+class HardwareWatch : public zycore::NonCopyable
+{
+public:
+    /**
+     * @brief   Identifies a watch, the index of the debug register used.
+     */
+    using Id = std::size_t;
+
+    /**
+     * @brief   Handler type of raw watches, called with the address of the written range.
+     */
+    using Handler = std::function<void(uintptr_t address)>;
+
+    /**
+     * @brief   The number of fields that can be watched at once, by all instances together.
+     */
+    static const std::size_t kNumSlots = 4;
+private:
+    uint32_t m_owned = 0;
+public:
+    /**
+     * @brief   Default constructor.
+     */
+    HardwareWatch() = default;
+
+    /**
+     * @brief   Destructor, removing all watches of this instance.
+     */
+    ~HardwareWatch()
+    {
+        for (Id id = 0; id < kNumSlots; ++id) unwatch(id);
+    }
+
+    /**
+     * @brief   Determines whether hardware watches are supported on this platform.
+     * @return  @c true if supported, else @c false.
+     */
+    static bool isSupported()
+    {
+#       if defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+            return true;
+#       else
+            return false;
+#       endif
+    }
+
+    /**
+     * @brief   Watches a range of bytes for writes.
+     * @param   address The address of the range.
+     * @param   size    The size of the range, 1, 2, 4 or (on x86-64) 8 bytes.
+     * @param   handler Called with @c address after every write to the range.
+     * @return  The id of the watch, or an empty optional if the range can't be watched (all
+     *          debug registers in use, bad size or alignment, or not supported).
+     */
+    zycore::Optional<Id> watch(uintptr_t address, std::size_t size, Handler handler)
+    {
+#       if defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+            const bool validSize = size == 1 || size == 2 || size == 4
+                || (size == 8 && sizeof(void*) == 8);
+            if (!validSize || address % size) return zycore::kEmpty;
+
+            auto& state = internal::HardwareWatchState::global();
+            std::lock_guard<std::mutex> lock{state.mutex};
+            for (Id id = 0; id < kNumSlots; ++id)
+            {
+                auto& slot = state.slots[id];
+                if (slot.size) continue;
+                slot.address = address;
+                slot.size    = size;
+                slot.handler = std::move(handler);
+                slot.armed.store(true, std::memory_order_release);
+                if (!internal::armHardwareWatch(id))
+                {
+                    release(slot, id);
+                    return zycore::kEmpty;
+                }
+                m_owned |= 1u << id;
+                return {zycore::kInPlace, id};
+            }
+#       else
+            (void)address;
+            (void)size;
+            (void)handler;
+#       endif
+        return zycore::kEmpty;
+    }
+
+    /**
+     * @brief   Watches a field for writes.
+     * @param   field   The field, of a trivially copyable type `T`.
+     * @param   onWrite Called as `onWrite(const T& newValue)` after every write, even if the
+     *                  value didn't change.
+     * @return  The id of the watch, or an empty optional if the field can't be watched.
+     */
+    template<typename FieldT, typename FuncT>
+    zycore::Optional<Id> watch(FieldT& field, FuncT onWrite)
+    {
+        using T = std::remove_cv_t<std::remove_pointer_t<decltype(field.addressOfObj())>>;
+        static_assert(std::is_trivially_copyable<T>::value,
+            "watched fields are required to be trivially copyable");
+        return watch(reinterpret_cast<uintptr_t>(field.addressOfObj()), sizeof(T),
+            [onWrite](uintptr_t address)
+        {
+            T value;
+            std::memcpy(&value, reinterpret_cast<const void*>(address), sizeof(T));
+            onWrite(value);
+        });
+    }
+
+    /**
+     * @brief   Removes a watch, waiting for running handlers of it to return.
+     * @param   id  The id of the watch.
+     * @return  @c true if removed, @c false if this instance has no such watch.
+     */
+    bool unwatch(Id id)
+    {
+        if (id >= kNumSlots || !(m_owned & (1u << id))) return false;
+        m_owned &= ~(1u << id);
+#       if defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+            auto& state = internal::HardwareWatchState::global();
+            std::lock_guard<std::mutex> lock{state.mutex};
+            release(state.slots[id], id);
+#       endif
+        return true;
+    }
+
+    /**
+     * @brief   Gets the number of watches of this instance.
+     * @return  The number of watches.
+     */
+    std::size_t size() const
+    {
+        std::size_t count = 0;
+        for (auto owned = m_owned; owned; owned &= owned - 1) ++count;
+        return count;
+    }
+private:
+#   if defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+        static void release(internal::HardwareWatchSlot& slot, Id id)
+        {
+            slot.armed.store(false, std::memory_order_release);
+            slot.size = 0;
+            internal::disarmHardwareWatch(id);
+            while (slot.busy.load(std::memory_order_acquire)) std::this_thread::yield();
+            slot.handler = nullptr;
+        }
+#   endif
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_WATCH_HPP
@@ -0,0 +1,244 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_WRAPPERSTATS_HPP
+#define REMODEL_WRAPPERSTATS_HPP
+
+/**
+ * @file
+ * @brief Contains a report of the memory footprint and construction cost of wrapper types.
+ *
+ * `stats` measures a wrapper type, `toText` ranks the results of many, most expensive first:
+ * @code
+ *     std::vector<WrapperStats> all{stats<Dog>("Dog"), stats<Cat>("Cat")};
+ *     std::cout << toText(all);
+ * @endcode
+ * Counting the fields of a wrapper requires `REMODEL_PROFILE`, counting heap allocations a
+ * function returning the number of allocations so far, e.g. from a replaced `operator new`.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Remodel.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [WrapperStats]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Memory footprint and construction cost of a wrapper type.
+ */
+struct WrapperStats
+{
+    /**
+     * @brief   The name of the wrapper, as passed to `stats`.
+     */
+    std::string name;
+    /**
+     * @brief   The size of the wrapper, `sizeof(WrapperT)`.
+     */
+    std::size_t wrapperSize = 0;
+    /**
+     * @brief   The bytes of the wrapper beyond its base holding the raw pointer, i.e. its fields.
+     */
+    std::size_t fieldBytes = 0;
+    /**
+     * @brief   Whether `numFields` and `getterBytes` were counted, requires `REMODEL_PROFILE`.
+     */
+    bool hasFieldCounts = false;
+    /**
+     * @brief   The number of fields and function wrappers constructed per wrapper.
+     */
+    std::size_t numFields = 0;
+    /**
+     * @brief   The bytes of `PtrGetter`s stored by the fields, 0 for `StaticField`s.
+     */
+    std::size_t getterBytes = 0;
+    /**
+     * @brief   The size of the wrapped object, `kObjSize`, 0 for wrappers without.
+     */
+    std::size_t objSize = 0;
+    /**
+     * @brief   The size of `WrapperT::Instantiable`, 0 for wrappers without.
+     */
+    std::size_t instantiableSize = 0;
+    /**
+     * @brief   The average duration of a `wrapper_cast`, in nanoseconds.
+     */
+    double castNanoseconds = 0.;
+    /**
+     * @brief   The average number of heap allocations per `wrapper_cast`, negative if not counted.
+     */
+    double allocationsPerCast = -1.;
+
+    /**
+     * @brief   Gets the bytes an `Instantiable` takes in addition to the object.
+     * @return  The overhead, in bytes.
+     */
+    std::size_t instantiableOverhead() const
+    {
+        return instantiableSize ? instantiableSize - objSize : 0;
+    }
+};
+
+/**
+ * @brief   Function returning the number of heap allocations of the process so far.
+ */
+using AllocationCounter = uint64_t (*)();
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Sizes of the instantiable forms of a wrapper, none for wrappers without.
+ * @tparam  WrapperT    The wrapper type.
+ */
+template<typename WrapperT, typename = void>
+struct InstantiableSizes
+{
+    static const std::size_t kObjSize = 0;
+    static const std::size_t kInstantiableSize = 0;
+};
+
+/**
+ * @internal
+ * @brief   Advanced wrappers have an `Instantiable` member-type.
+ * @copydetails InstantiableSizes
+ */
+template<typename WrapperT>
+struct InstantiableSizes<WrapperT, std::conditional_t<
+    true, void, typename WrapperT::Instantiable>>
+{
+    static const std::size_t kObjSize = WrapperT::kObjSize;
+    static const std::size_t kInstantiableSize = sizeof(typename WrapperT::Instantiable);
+};
+
+} // namespace internal
+
+/**
+ * @brief   Measures a wrapper type.
+ * @tparam  WrapperT    The wrapper type.
+ * @param   name        The name of the wrapper in the report.
+ * @param   allocations If non-null, used to count the heap allocations of the casts.
+ * @param   numCasts    The number of `wrapper_cast`s to measure.
+ * @return  The results.
+ *
+ * The wrappers are created for a zeroed buffer of `kObjSize` bytes (or a page for wrappers
+ * without), through a call the compiler can't inline, so the wrapper isn't optimized away.
+ */
+template<typename WrapperT>
+inline WrapperStats stats(
+    std::string name, AllocationCounter allocations = nullptr, std::size_t numCasts = 1000)
+{
+    using Sizes = internal::InstantiableSizes<WrapperT>;
+
+    WrapperStats result;
+    result.name = std::move(name);
+    result.wrapperSize = sizeof(WrapperT);
+    result.fieldBytes = sizeof(WrapperT) - sizeof(internal::WrapperBase);
+    result.objSize = Sizes::kObjSize;
+    result.instantiableSize = Sizes::kInstantiableSize;
+
+    const std::size_t bufferSize = Sizes::kObjSize ? Sizes::kObjSize : 4096;
+    std::unique_ptr<uint64_t[]> buffer{new uint64_t[(bufferSize + 7) / 8]()};
+    const auto raw = static_cast<void*>(buffer.get());
+
+#   if defined(REMODEL_PROFILE)
+        profile::internal::FieldCensus census;
+        profile::internal::FieldCensus::active() = &census;
+        wrapper_cast<WrapperT>(raw);
+        profile::internal::FieldCensus::active() = nullptr;
+        result.hasFieldCounts = true;
+        result.numFields = census.numFields;
+        result.getterBytes = census.getterBytes;
+#   endif
+
+    static WrapperT (* volatile cast)(void*) = &wrapper_cast<WrapperT>;
+    const auto allocationsBefore = allocations ? allocations() : 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < numCasts; ++i) cast(raw);
+    const auto duration = std::chrono::steady_clock::now() - start;
+    if (allocations)
+    {
+        result.allocationsPerCast = numCasts
+            ? static_cast<double>(allocations() - allocationsBefore) / numCasts : 0.;
+    }
+    result.castNanoseconds = numCasts ? static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) / numCasts : 0.;
+    return result;
+}
+
+/**
+ * @brief   Formats results as a table, the most expensive wrappers to create first.
+ * @param   all The results, see `stats`.
+ * @return  The text, one line per wrapper. Counts that weren't measured are shown as `-`.
+ */
+inline std::string toText(std::vector<WrapperStats> all)
+{
+    std::stable_sort(all.begin(), all.end(), [](const WrapperStats& a, const WrapperStats& b)
+    {
+        return a.castNanoseconds > b.castNanoseconds;
+    });
+
+    std::string text = "wrapper                          size  fields  getters  field bytes"
+        "  inst. overhead  ns/cast  allocs/cast\n";
+    char line[256];
+    for (const auto& cur : all)
+    {
+        char fields[16] = "-";
+        char getters[16] = "-";
+        char allocs[16] = "-";
+        if (cur.hasFieldCounts)
+        {
+            std::snprintf(fields, sizeof(fields), "%zu", cur.numFields);
+            std::snprintf(getters, sizeof(getters), "%zu", cur.getterBytes);
+        }
+        if (cur.allocationsPerCast >= 0.)
+        {
+            std::snprintf(allocs, sizeof(allocs), "%.2f", cur.allocationsPerCast);
+        }
+        std::snprintf(line, sizeof(line), "%-30s %6zu  %6s  %7s  %11zu  %14zu  %7.1f  %11s\n",
+            cur.name.c_str(), cur.wrapperSize, fields, getters, cur.fieldBytes,
+            cur.instantiableOverhead(), cur.castNanoseconds, allocs);
+        text += line;
+    }
+    return text;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace remodel
+
+#endif // REMODEL_WRAPPERSTATS_HPP
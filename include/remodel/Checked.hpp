@@ -0,0 +1,179 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_CHECKED_HPP
+#define REMODEL_CHECKED_HPP
+
+/**
+ * @file
+ * @brief Contains the layout checks of the `REMODEL_CHECKED` mode.
+ *
+ * Defining `REMODEL_CHECKED` (globally, for every translation unit) makes fields verify the
+ * layout their wrappers describe, to find wrong offsets and sizes during development:
+ * - fields of `AdvancedClassWrapper`s must lie within `kObjSize` bytes, checked on construction
+ *   for offset getters and on every access for fields starting inside the object,
+ * - objects must be aligned as their type demands, unless accessed via `access::Unaligned`,
+ * - subscripts of array fields, `TrailingArray`s, `FieldSpan`s, `ContiguousRange`s and
+ *   `WrapperRange`s must be in bounds.
+ *
+ * Violations are reported to the handler set with `checked::setFailureHandler`; by default, they
+ * are printed to `stderr` before aborting. Without `REMODEL_CHECKED`, the hooks expand to nothing
+ * and none of this is defined, so release builds keep the unchecked accesses.
+ */
+
+#if defined(REMODEL_CHECKED)
+#   include <stdint.h>
+#   include <atomic>
+#   include <cstddef>
+#   include <cstdio>
+#   include <cstdlib>
+
+    /**
+     * @internal
+     * @brief   Checks the bounds and alignment of the object of a field of @c wrapper at @c ptr.
+     */
+#   define REMODEL_CHECK_FIELD(wrapper, ptr, size, align)                                         \
+        ::remodel::internal::FieldBase::checkAccess(wrapper, ptr, size, align)
+    /**
+     * @internal
+     * @brief   Checks the offset of a field of @c wrapper, if known from its @c getter.
+     */
+#   define REMODEL_CHECK_GETTER(wrapper, getter, size)                                            \
+        ::remodel::internal::FieldBase::checkGetter(wrapper, getter, size)
+    /**
+     * @internal
+     * @brief   Checks the offset of a field of @c wrapper.
+     */
+#   define REMODEL_CHECK_OFFSET(wrapper, offset, size)                                            \
+        ::remodel::internal::FieldBase::checkOffset(wrapper, offset, size)
+    /**
+     * @internal
+     * @brief   Checks a subscript against the number of elements.
+     */
+#   define REMODEL_CHECK_INDEX(idx, size)                                                         \
+        ::remodel::checked::internal::checkIndex(idx, size)
+#else
+#   define REMODEL_CHECK_FIELD(wrapper, ptr, size, align)
+#   define REMODEL_CHECK_GETTER(wrapper, getter, size)
+#   define REMODEL_CHECK_OFFSET(wrapper, offset, size)
+#   define REMODEL_CHECK_INDEX(idx, size)
+#endif
+
+#if defined(REMODEL_CHECKED)
+
+namespace remodel
+{
+namespace checked
+{
+
+/**
+ * @brief   The kinds of violations found by the checks.
+ */
+enum class Violation : uint8_t
+{
+    /**
+     * @brief   A field exceeding the object of its wrapper.
+     */
+    Bounds,
+    /**
+     * @brief   An object not aligned as its type demands.
+     */
+    Alignment,
+    /**
+     * @brief   A subscript past the end of an array.
+     */
+    Index,
+};
+
+/**
+ * @brief   Function called for violations.
+ * @param   violation   The kind of the violation.
+ * @param   address     The address of the offending object, @c nullptr for subscripts.
+ *
+ * Accesses continue as usual if the handler returns.
+ */
+using FailureHandler = void (*)(Violation violation, const void* address);
+
+namespace internal
+{
+
+inline std::atomic<FailureHandler>& failureHandler()
+{
+    static std::atomic<FailureHandler> handler{nullptr};
+    return handler;
+}
+
+} // namespace internal
+
+/**
+ * @brief   Replaces the function called for violations.
+ * @param   handler The handler, @c nullptr to restore printing and aborting.
+ * @return  The previous handler.
+ */
+inline FailureHandler setFailureHandler(FailureHandler handler)
+{
+    return internal::failureHandler().exchange(handler);
+}
+
+/**
+ * @brief   Reports a violation.
+ * @param   violation   The kind of the violation.
+ * @param   address     The address of the offending object, @c nullptr for subscripts.
+ */
+inline void fail(Violation violation, const void* address)
+{
+    if (auto handler = internal::failureHandler().load())
+    {
+        handler(violation, address);
+        return;
+    }
+
+    static const char* const kNames[] = {"bounds", "alignment", "index"};
+    std::fprintf(stderr, "remodel: %s check failed at %p\n",
+        kNames[static_cast<uint8_t>(violation)], address);
+    std::abort();
+}
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Checks a subscript, see `REMODEL_CHECK_INDEX`.
+ * @param   idx     The subscript, negative ones fail as well.
+ * @param   size    The number of elements.
+ */
+template<typename IdxT>
+inline void checkIndex(IdxT idx, std::size_t size)
+{
+    if (static_cast<std::size_t>(idx) >= size) fail(Violation::Index, nullptr);
+}
+
+} // namespace internal
+
+} // namespace checked
+} // namespace remodel
+
+#endif // REMODEL_CHECKED
+
+#endif // REMODEL_CHECKED_HPP
@@ -0,0 +1,3612 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_FIELD_HPP
+#define REMODEL_FIELD_HPP
+
+/**     
+ * @file
+ * @brief Contains the field classes (`Field`, `BitField`, `AtomicField`, ...) and their
+ *        implementation details.
+ */
+
+#include <array>
+#include <cstring>
+#include <tuple>
+
+#include "../Simd.hpp"
+#include "Wrapper.hpp"
+
+namespace remodel
+{
+
+// ============================================================================================== //
+// Abstract field object implementation                                                           //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldBase]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{ 
+
+/**
+ * @internal
+ * @brief   Base class for all kinds of wrapper-fields.
+ */
+class FieldBase
+{
+public:
+    /**
+     * @brief   Definition of the prototype for type-erased pointer-getters.
+     */
+    using PtrGetter = std::function<void*(void* rawBasePtr)>;
+protected:
+    /**
+     * @brief   Default constructor.
+     */
+    FieldBase() = default;
+
+    /**
+     * @brief   Copy constructor.
+     *          
+     * Whether a field may be copied is decided by its parent link, see `RelativeParentLink`.
+     */
+    FieldBase(const FieldBase&) = default;
+
+    /**
+     * @brief   Deleted assignment operator.
+     * @note    This is just here as an assertation so internal code cannot copy fields by 
+     *          accident. The concrete implementation hides this operator in favor of an operator
+     *          that copies the data wrapped by one proxy object to another (emulating normal
+     *          assignment semantics).
+     */
+    FieldBase& operator = (const FieldBase&) = delete;
+
+    /**   
+     * @brief   Destructor.
+     *          
+     * Fields are never destroyed through pointers to their base, so we don't need a virtual 
+     * destructor (and the vftable pointer that comes with it) here.
+     */
+    ~FieldBase() = default;
+
+    /**
+     * @brief   Obtains the raw pointer of a wrapper.
+     * @param   wrapper The wrapper or @c nullptr.
+     * @return  The raw pointer of the wrapper or @c nullptr if @c wrapper is @c nullptr.
+     */
+    static void* rawOf(const WrapperBase* wrapper)
+    {
+        return wrapper ? wrapper->m_raw : nullptr;
+    }
+#   if defined(REMODEL_PROFILE)
+public:
+    /**
+     * @brief   Counts an access of a field, see `REMODEL_PROFILE_FIELD`.
+     * @param   wrapper The parent of the field or @c nullptr.
+     * @param   ptr     The address of the accessed object.
+     */
+    static void profileField(const WrapperBase* wrapper, const void* ptr)
+    {
+        profile::internal::recordAccess(profile::AccessKind::Field,
+            wrapper ? wrapper->m_profileName : nullptr,
+            reinterpret_cast<intptr_t>(ptr) - reinterpret_cast<intptr_t>(rawOf(wrapper)));
+    }
+
+    /**
+     * @brief   Counts a call of a function, see `REMODEL_PROFILE_CALL`.
+     * @param   wrapper The parent of the function or @c nullptr.
+     * @param   code    The address of the called code.
+     */
+    static void profileCall(const WrapperBase* wrapper, const void* code)
+    {
+        profile::internal::recordAccess(profile::AccessKind::Call,
+            wrapper ? wrapper->m_profileName : nullptr, reinterpret_cast<intptr_t>(code));
+    }
+
+    /**
+     * @brief   Counts the construction of a field, see `REMODEL_PROFILE_FIELD_INIT`.
+     * @param   getterSize  The number of bytes the field stores for its `PtrGetter`.
+     */
+    static void profileFieldInit(std::size_t getterSize)
+    {
+        if (auto census = profile::internal::FieldCensus::active())
+        {
+            ++census->numFields;
+            census->getterBytes += getterSize;
+        }
+    }
+#   endif
+#   if defined(REMODEL_CHECKED)
+public:
+    /**
+     * @brief   Checks the offset of a field, see `REMODEL_CHECK_OFFSET`.
+     * @param   wrapper The parent of the field or @c nullptr.
+     * @param   offset  The offset of the field.
+     * @param   size    The size of the object of the field.
+     */
+    static void checkOffset(const WrapperBase* wrapper, std::ptrdiff_t offset, std::size_t size)
+    {
+        if (!wrapper || !wrapper->m_checkedSize) return;
+        if (offset < 0 || static_cast<std::size_t>(offset) + size > wrapper->m_checkedSize)
+        {
+            checked::fail(checked::Violation::Bounds,
+                static_cast<const uint8_t*>(rawOf(wrapper)) + offset);
+        }
+    }
+
+    /**
+     * @brief   Checks the offset of a field, see `REMODEL_CHECK_GETTER`.
+     * @param   wrapper The parent of the field or @c nullptr.
+     * @param   getter  The getter of the field, only offset getters are checked.
+     * @param   size    The size of the object of the field.
+     */
+    template<typename GetterT>
+    static void checkGetter(const WrapperBase* wrapper, const GetterT& getter, std::size_t size)
+    {
+        (void)wrapper, (void)getter, (void)size;
+    }
+
+    /**
+     * @copydoc checkGetter
+     */
+    static void checkGetter(const WrapperBase* wrapper, const OffsGetter& getter, std::size_t size)
+    {
+        checkOffset(wrapper, getter.offset(), size);
+    }
+
+    /**
+     * @copydoc checkGetter
+     */
+    template<std::ptrdiff_t offsT>
+    static void checkGetter(
+        const WrapperBase* wrapper, const StaticOffsGetter<offsT>&, std::size_t size)
+    {
+        checkOffset(wrapper, offsT, size);
+    }
+
+    /**
+     * @brief   Checks an access of a field, see `REMODEL_CHECK_FIELD`.
+     * @param   wrapper The parent of the field or @c nullptr.
+     * @param   ptr     The address of the accessed object.
+     * @param   size    The size of the object.
+     * @param   align   The alignment required for the object.
+     *
+     * Fields of other getters (e.g. `AbsGetter`) may be located anywhere, so only objects
+     * starting inside of the parent are checked for exceeding it.
+     */
+    static void checkAccess(
+        const WrapperBase* wrapper, const void* ptr, std::size_t size, std::size_t align)
+    {
+        if (reinterpret_cast<uintptr_t>(ptr) % align)
+        {
+            checked::fail(checked::Violation::Alignment, ptr);
+        }
+        if (!wrapper || !wrapper->m_checkedSize) return;
+
+        const auto offset =
+            reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(rawOf(wrapper));
+        if (offset < wrapper->m_checkedSize && offset + size > wrapper->m_checkedSize)
+        {
+            checked::fail(checked::Violation::Bounds, ptr);
+        }
+    }
+#   endif
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [PtrParentLink] + [RelativeParentLink]                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Link from a field to its parent, storing a pointer to the parent.
+ */
+class PtrParentLink
+{
+    WrapperBase* m_parent;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   field   The field owning the link (unused).
+     * @param   parent  If non-null, the parent.
+     */
+    PtrParentLink(const void* /*field*/, WrapperBase* parent)
+        : m_parent{parent}
+    {}
+
+    /**
+     * @brief   Deleted copy constructor.
+     *          
+     * A copied link would still point to the parent of the original field, so fields using this
+     * link are not copyable.
+     */
+    PtrParentLink(const PtrParentLink&) = delete;
+
+    /**
+     * @brief   Gets a pointer to the parent.
+     * @param   field   The field owning the link (unused).
+     * @return  The parent.
+     */
+    WrapperBase* get(const void* /*field*/) const { return m_parent; }
+};
+
+/**
+ * @internal
+ * @brief   Link from a field to its parent, storing the distance from the field to the parent.
+ *          
+ * Only suitable for fields that are members of their parent. Other than `PtrParentLink`, the link
+ * just takes 4 bytes and stays valid when the parent is copied as a whole, since the distance 
+ * between the parent and its members is the same for all instances of a wrapper type. This is
+ * what makes bytewise copies of `LightClassWrapper`s possible.
+ */
+class RelativeParentLink
+{
+    int32_t m_offs;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   field   The field owning the link.
+     * @param   parent  If non-null, the parent. Required to be the object containing @c field.
+     */
+    RelativeParentLink(const void* field, WrapperBase* parent)
+        : m_offs{static_cast<int32_t>(parent 
+            ? reinterpret_cast<intptr_t>(parent) - reinterpret_cast<intptr_t>(field) : 0
+            )}
+    {
+        assert(!parent || reinterpret_cast<intptr_t>(parent) 
+            - reinterpret_cast<intptr_t>(field) == m_offs);
+    }
+
+    /**
+     * @brief   Gets a pointer to the parent.
+     * @param   field   The field owning the link.
+     * @return  The parent.
+     */
+    WrapperBase* get(const void* field) const
+    { 
+        // A field can never be located at the very address of its parent (that is where
+        // the parent's own data lives), so an offset of 0 safely encodes "no parent".
+        return m_offs ? reinterpret_cast<WrapperBase*>(
+            reinterpret_cast<intptr_t>(field) + m_offs) : nullptr;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Selects the parent link used by fields using a `PtrGetter` of the given type.
+ * @tparam  PtrGetterT  The `PtrGetter` type.
+ */
+template<typename PtrGetterT>
+struct ParentLinkOf
+{
+    using Type = PtrParentLink;
+};
+
+/**
+ * @internal
+ * @brief   `StaticField`s are always members of their parent, so use a relative link for them.
+ * @copydetails ParentLinkOf
+ */
+template<std::ptrdiff_t offsT>
+struct ParentLinkOf<StaticOffsGetter<offsT>>
+{
+    using Type = RelativeParentLink;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [BasicFieldBase]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Storage for a `PtrGetter`, taking advantage of the empty base optimization for 
+ *          stateless getters.
+ * @tparam  PtrGetterT  The `PtrGetter` type.
+ */
+template<typename PtrGetterT, typename = void>
+class PtrGetterStorage
+{
+    PtrGetterT m_ptrGetter;
+protected:
+    explicit PtrGetterStorage(PtrGetterT ptrGetter)
+        : m_ptrGetter{ptrGetter}
+    {}
+
+    const PtrGetterT& getter() const { return m_ptrGetter; }
+};
+
+/**
+ * @internal
+ * @brief   Storage for stateless `PtrGetter`s.
+ * @copydetails PtrGetterStorage
+ */
+template<typename PtrGetterT>
+class PtrGetterStorage<PtrGetterT, std::enable_if_t<
+        std::is_empty<PtrGetterT>::value && !std::is_final<PtrGetterT>::value
+    >>
+    : private PtrGetterT
+{
+protected:
+    explicit PtrGetterStorage(PtrGetterT ptrGetter)
+        : PtrGetterT(ptrGetter) // MSVC12 requires parentheses here
+    {}
+
+    const PtrGetterT& getter() const { return *this; }
+};
+
+/**
+ * @internal
+ * @brief   Base class for wrapper-fields using a `PtrGetter` of a given type.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation.
+ */
+template<typename PtrGetterT>
+class BasicFieldBase 
+    : public FieldBase
+    , private PtrGetterStorage<PtrGetterT>
+{
+    using ParentLink = typename ParentLinkOf<PtrGetterT>::Type;
+    ParentLink m_parentLink;
+protected:
+    /**
+     * @brief   Constructor.
+     * @param   parent      If non-null, the parent.
+     * @param   ptrGetter   A `PtrGetter` calculating the actual offset of the proxied object.
+     */
+    BasicFieldBase(WrapperBase* parent, PtrGetterT ptrGetter)
+        : PtrGetterStorage<PtrGetterT>{ptrGetter}
+        , m_parentLink{this, parent}
+    {
+        REMODEL_PROFILE_FIELD_INIT(std::is_empty<PtrGetterT>::value ? 0 : sizeof(PtrGetterT));
+    }
+
+    /**
+     * @brief   Gets a pointer to the parent of this field.
+     * @return  The parent.
+     */
+    WrapperBase* parent() { return m_parentLink.get(this); }
+
+    /**
+     * @brief   Gets a constant pointer to the parent of this field.
+     * @return  The parent.
+     */
+    const WrapperBase* parent() const { return m_parentLink.get(this); }
+
+    /**
+     * @brief   Gets the `PtrGetter` used for address calculation.
+     * @return  The used `PtrGetter`.
+     */
+    const PtrGetterT& ptrGetter() const { return this->getter(); }
+
+    /**
+     * @brief   Obtains a pointer to the raw object using the `PtrGetter`.
+     * @return  The requested pointer.
+     */
+    void* rawPtr()
+    {
+        auto ptr = this->getter()(rawOf(this->parent()));
+        REMODEL_PROFILE_FIELD(this->parent(), ptr);
+        return ptr;
+    }
+
+    /**
+     * @brief   Obtains a constant pointer to the raw object using the `PtrGetter`.
+     * @return  The requested pointer.
+     */
+    const void* crawPtr() const
+    {
+        const void* ptr = this->getter()(rawOf(this->parent()));
+        REMODEL_PROFILE_FIELD(this->parent(), ptr);
+        return ptr;
+    }
+
+    /**
+     * @brief   Obtains a pointer to the raw object without counting it as field access, for
+     *          function wrappers resolving their code pointer.
+     * @return  The requested pointer.
+     */
+    const void* codePtr() const
+    {
+        return this->getter()(rawOf(this->parent()));
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ForwardByFlags]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace operators
+{
+
+/**
+ * @internal
+ * @brief   Flags selecting the operators forwarded by `ForwardByFlags`.
+ */
+enum : uint32_t
+{
+    ADD                 = 1 << 0,
+    SUBTRACT            = 1 << 1,
+    MULTIPLY            = 1 << 2,
+    DIVIDE              = 1 << 3,
+    MODULO              = 1 << 4,
+    UNARY_PLUS          = 1 << 5,
+    UNARY_MINUS         = 1 << 6,
+    INCREMENT           = 1 << 7,
+    DECREMENT           = 1 << 8,
+    BITWISE_OR          = 1 << 9,
+    BITWISE_AND         = 1 << 10,
+    BITWISE_XOR         = 1 << 11,
+    SHIFT_LEFT          = 1 << 12,
+    SHIFT_RIGHT         = 1 << 13,
+    BITWISE_NOT         = 1 << 14,
+    COMPARE             = 1 << 15,
+    ARRAY_SUBSCRIPT     = 1 << 16,
+    INDIRECTION         = 1 << 17,
+    STRUCT_DEREFERENCE  = 1 << 18,
+
+    ARITHMETIC          = ADD | SUBTRACT | MULTIPLY | DIVIDE | MODULO 
+                        | UNARY_PLUS | UNARY_MINUS | INCREMENT | DECREMENT,
+    BITWISE             = BITWISE_OR | BITWISE_AND | BITWISE_XOR 
+                        | SHIFT_LEFT | SHIFT_RIGHT | BITWISE_NOT,
+};
+
+} // namespace operators
+
+/**
+ * @internal
+ * @brief   CRTP helper forwarding operators to the object referenced by a field.
+ * @tparam  DerivedT    The concrete field type, providing `valueRef` and `valueCRef`.
+ * @tparam  T           The type of the referenced object.
+ * @tparam  flagsT      The operators to forward (see `operators`).
+ *                      
+ * Other than a virtual interface, the static dispatch to `DerivedT` allows the compiler to inline
+ * the complete access, reducing operations on fields to plain operations on the wrapped object.
+ * Every operator obtains the reference exactly once, so compound assignments and increments
+ * resolve the address a single time (e.g. a single `add [mem], imm` for `field += 1` on x86)
+ * and access the object by a single load and store with access policies other than
+ * `access::Plain`.
+ */
+template<typename DerivedT, typename T, uint32_t flagsT>
+class ForwardByFlags
+{
+    // References for `access::Plain` fields, values or `AccessRef`s for other access policies.
+    decltype(auto) fwdRef() { return static_cast<DerivedT*>(this)->valueRef(); }
+    decltype(auto) fwdCRef() const { return static_cast<const DerivedT*>(this)->valueCRef(); }
+
+    // Results referring into a temporary `AccessRef` are returned by value instead.
+    template<typename D, typename ResultT>
+    using FwdResult = std::conditional_t<
+        std::is_reference<decltype(std::declval<D&>().valueRef())>::value,
+        ResultT, std::decay_t<ResultT>>;
+public:
+    // `U` and `D` delay the evaluation of the return types until the operator is actually used.
+#define REMODEL_FORWARD_IF(flag)                                                                   \
+    typename U = T, typename D = DerivedT, uint32_t flagsU = flagsT,                               \
+    typename = std::enable_if_t<(flagsU & (flag)) != 0>
+
+#define REMODEL_FORWARD_BINARY_OPERATOR(op, flag)                                                  \
+    template<typename RhsT, REMODEL_FORWARD_IF(flag)>                                              \
+    auto operator op (const RhsT& rhs) const -> decltype(std::declval<const U&>() op rhs)          \
+    {                                                                                              \
+        return this->fwdCRef() op rhs;                                                             \
+    }                                                                                              \
+                                                                                                   \
+    template<typename RhsT, REMODEL_FORWARD_IF(flag)>                                              \
+    auto operator op##= (const RhsT& rhs)                                                          \
+        -> FwdResult<D, decltype(std::declval<D&>().valueRef() op##= rhs)>                         \
+    {                                                                                              \
+        return this->fwdRef() op##= rhs;                                                           \
+    }
+
+#define REMODEL_FORWARD_COMPARE_OPERATOR(op)                                                       \
+    template<typename RhsT, REMODEL_FORWARD_IF(operators::COMPARE)>                                \
+    auto operator op (const RhsT& rhs) const -> decltype(std::declval<const U&>() op rhs)          \
+    {                                                                                              \
+        return this->fwdCRef() op rhs;                                                             \
+    }
+
+#define REMODEL_FORWARD_UNARY_OPERATOR(op, flag)                                                   \
+    template<REMODEL_FORWARD_IF(flag)>                                                             \
+    auto operator op () const -> decltype(op std::declval<const U&>())                             \
+    {                                                                                              \
+        return op this->fwdCRef();                                                                 \
+    }
+
+    REMODEL_FORWARD_BINARY_OPERATOR(+,  operators::ADD)
+    REMODEL_FORWARD_BINARY_OPERATOR(-,  operators::SUBTRACT)
+    REMODEL_FORWARD_BINARY_OPERATOR(*,  operators::MULTIPLY)
+    REMODEL_FORWARD_BINARY_OPERATOR(/,  operators::DIVIDE)
+    REMODEL_FORWARD_BINARY_OPERATOR(%,  operators::MODULO)
+    REMODEL_FORWARD_BINARY_OPERATOR(|,  operators::BITWISE_OR)
+    REMODEL_FORWARD_BINARY_OPERATOR(&,  operators::BITWISE_AND)
+    REMODEL_FORWARD_BINARY_OPERATOR(^,  operators::BITWISE_XOR)
+    REMODEL_FORWARD_BINARY_OPERATOR(<<, operators::SHIFT_LEFT)
+    REMODEL_FORWARD_BINARY_OPERATOR(>>, operators::SHIFT_RIGHT)
+
+    REMODEL_FORWARD_COMPARE_OPERATOR(==)
+    REMODEL_FORWARD_COMPARE_OPERATOR(!=)
+    REMODEL_FORWARD_COMPARE_OPERATOR(<)
+    REMODEL_FORWARD_COMPARE_OPERATOR(>)
+    REMODEL_FORWARD_COMPARE_OPERATOR(<=)
+    REMODEL_FORWARD_COMPARE_OPERATOR(>=)
+
+    REMODEL_FORWARD_UNARY_OPERATOR(+, operators::UNARY_PLUS)
+    REMODEL_FORWARD_UNARY_OPERATOR(-, operators::UNARY_MINUS)
+    REMODEL_FORWARD_UNARY_OPERATOR(~, operators::BITWISE_NOT)
+
+    template<REMODEL_FORWARD_IF(operators::INCREMENT)>
+    auto operator ++ () -> FwdResult<D, decltype(++std::declval<D&>().valueRef())>
+    {
+        return ++this->fwdRef();
+    }
+
+    template<REMODEL_FORWARD_IF(operators::INCREMENT)>
+    auto operator ++ (int) -> decltype(std::declval<D&>().valueRef()++)
+    {
+        return this->fwdRef()++;
+    }
+
+    template<REMODEL_FORWARD_IF(operators::DECREMENT)>
+    auto operator -- () -> FwdResult<D, decltype(--std::declval<D&>().valueRef())>
+    {
+        return --this->fwdRef();
+    }
+
+    template<REMODEL_FORWARD_IF(operators::DECREMENT)>
+    auto operator -- (int) -> decltype(std::declval<D&>().valueRef()--)
+    {
+        return this->fwdRef()--;
+    }
+
+    template<typename IdxT, REMODEL_FORWARD_IF(operators::ARRAY_SUBSCRIPT)>
+    auto operator [] (const IdxT& idx) -> decltype(std::declval<U&>()[idx])
+    {
+        REMODEL_CHECK_INDEX(idx, std::extent<U>::value ? std::extent<U>::value : ~std::size_t{0});
+        return this->fwdRef()[idx];
+    }
+
+    template<typename IdxT, REMODEL_FORWARD_IF(operators::ARRAY_SUBSCRIPT)>
+    auto operator [] (const IdxT& idx) const -> decltype(std::declval<const U&>()[idx])
+    {
+        REMODEL_CHECK_INDEX(idx, std::extent<U>::value ? std::extent<U>::value : ~std::size_t{0});
+        return this->fwdCRef()[idx];
+    }
+
+    template<REMODEL_FORWARD_IF(operators::INDIRECTION)>
+    auto operator * () -> decltype(*std::declval<U&>())
+    {
+        return *this->fwdRef();
+    }
+
+    template<REMODEL_FORWARD_IF(operators::STRUCT_DEREFERENCE)>
+    T& operator -> ()
+    {
+        return this->fwdRef();
+    }
+
+    template<REMODEL_FORWARD_IF(operators::STRUCT_DEREFERENCE)>
+    const T& operator -> () const
+    {
+        return this->fwdCRef();
+    }
+
+#undef REMODEL_FORWARD_UNARY_OPERATOR
+#undef REMODEL_FORWARD_COMPARE_OPERATOR
+#undef REMODEL_FORWARD_BINARY_OPERATOR
+#undef REMODEL_FORWARD_IF
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [EndianValue]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Arithmetic value stored in a fixed byte order.
+ * @tparam  T       The arithmetic or enum type of the value.
+ * @tparam  bigT    @c true for big endian ("network") byte order, @c false for little endian.
+ *
+ * Converts on load and store, so structures with a defined byte order (network protocols, file
+ * formats, targets running on other architectures) can be wrapped as-is. Values are trivial and
+ * exactly as large as `T`, usable both as field types and as members of plain structures. When
+ * the byte order matches the host's, conversions are no-ops. Values may be unaligned, as usual
+ * in packed headers.
+ *
+ * @code
+ *     Field<BigEndian<uint32_t>> sequence{this, 4};
+ *     uint32_t next = sequence + 1;
+ *     sequence = next;
+ * @endcode
+ *
+ * Use `FieldSpan::gatherValues` to convert a field of many objects at once.
+ */
+template<typename T, bool bigT>
+class EndianValue
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, 
+        "byte order conversion is only supported for arithmetic types and enums");
+public:
+    using ValueType = T;
+    using StorageType = typename simd::internal::UIntOfSize<sizeof(T)>::Type;
+
+    /// Whether the byte order differs from the host's, requiring conversions.
+#   if defined(REMODEL_BIG_ENDIAN_HOST)
+    static const bool kIsSwapped = !bigT;
+#   else
+    static const bool kIsSwapped = bigT;
+#   endif
+private:
+    // Bytes rather than `StorageType`, so values keep an alignment of 1 in packed structures.
+    uint8_t m_bytes[sizeof(T)];
+
+    static StorageType convert(StorageType value)
+    {
+        return kIsSwapped ? simd::byteSwap(value) : value;
+    }
+public:
+    /**
+     * @brief   Default constructor, leaving the value uninitialized.
+     */
+    EndianValue() = default;
+
+    /**
+     * @brief   Converting constructor.
+     * @param   value   The value to store.
+     */
+    EndianValue(T value) { set(value); }
+
+    /**
+     * @brief   Reads the value.
+     * @return  The value, in host byte order.
+     */
+    T get() const
+    {
+        T value;
+        const auto native = convert(stored());
+        std::memcpy(&value, &native, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief   Writes the value.
+     * @param   value   The value, in host byte order.
+     */
+    void set(T value)
+    {
+        StorageType native;
+        std::memcpy(&native, &value, sizeof(value));
+        const auto stored = convert(native);
+        std::memcpy(m_bytes, &stored, sizeof(stored));
+    }
+
+    /**
+     * @brief   Gets the value as stored, without conversion.
+     * @return  The stored bytes.
+     */
+    StorageType stored() const
+    {
+        StorageType stored;
+        std::memcpy(&stored, m_bytes, sizeof(stored));
+        return stored;
+    }
+
+    /**
+     * @brief   Implicit cast to the value.
+     * @return  The value, in host byte order.
+     */
+    operator T () const { return get(); }
+
+    /**
+     * @brief   Assignment operator writing the value.
+     * @param   rhs The right hand side.
+     * @return  `*this`.
+     */
+    EndianValue& operator = (T rhs)
+    {
+        set(rhs);
+        return *this;
+    }
+
+#define REMODEL_ENDIAN_COMPOUND_OPERATOR(op)                                                       \
+    template<typename RhsT>                                                                        \
+    EndianValue& operator op##= (const RhsT& rhs)                                                  \
+    {                                                                                              \
+        set(static_cast<T>(get() op rhs));                                                         \
+        return *this;                                                                              \
+    }
+
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(+)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(-)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(*)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(/)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(%)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(|)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(&)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(^)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(<<)
+    REMODEL_ENDIAN_COMPOUND_OPERATOR(>>)
+
+#undef REMODEL_ENDIAN_COMPOUND_OPERATOR
+
+    EndianValue& operator ++ () { return *this += 1; }
+    EndianValue& operator -- () { return *this -= 1; }
+
+    T operator ++ (int) 
+    { 
+        const auto old = get();
+        ++*this;
+        return old;
+    }
+
+    T operator -- (int) 
+    { 
+        const auto old = get();
+        --*this;
+        return old;
+    }
+};
+
+/**
+ * @brief   Value stored in big endian ("network") byte order.
+ * @tparam  T   The arithmetic or enum type of the value.
+ * @see     EndianValue
+ */
+template<typename T>
+using BigEndian = EndianValue<T, true>;
+
+static_assert(alignof(EndianValue<uint64_t, true>) == 1 && alignof(EndianValue<double, false>) == 1,
+    "byte order values must be usable unaligned");
+
+/**
+ * @brief   Value stored in little endian byte order.
+ * @tparam  T   The arithmetic or enum type of the value.
+ * @see     EndianValue
+ */
+template<typename T>
+using LittleEndian = EndianValue<T, false>;
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines whether a type is an `EndianValue`.
+ * @tparam  T   The type to check.
+ */
+template<typename T>
+struct IsEndianValue : std::false_type {};
+
+/**
+ * @internal
+ * @brief   `EndianValue`s are endian values.
+ * @copydetails IsEndianValue
+ */
+template<typename T, bool bigT>
+struct IsEndianValue<EndianValue<T, bigT>> : std::true_type {};
+
+/**
+ * @internal
+ * @brief   Determines whether a type is a SIMD vector, loaded and stored as a whole.
+ * @tparam  T   The type to check.
+ */
+template<typename T>
+struct IsVectorValue : std::false_type {};
+
+template<> struct IsVectorValue<simd::Vec4f> : std::true_type {};
+#   if defined(ZYCORE_GNUC)
+#       pragma GCC diagnostic push
+#       pragma GCC diagnostic ignored "-Wignored-attributes"
+#   endif
+#   if defined(REMODEL_SIMD_SSE2)
+template<> struct IsVectorValue<__m128>  : std::true_type {};
+template<> struct IsVectorValue<__m128d> : std::true_type {};
+template<> struct IsVectorValue<__m128i> : std::true_type {};
+#   endif
+#   if defined(__AVX__)
+template<> struct IsVectorValue<__m256>  : std::true_type {};
+template<> struct IsVectorValue<__m256d> : std::true_type {};
+template<> struct IsVectorValue<__m256i> : std::true_type {};
+#   endif
+#   if defined(ZYCORE_GNUC)
+#       pragma GCC diagnostic pop
+#   endif
+
+/**
+ * @internal
+ * @brief   The operators forwarded by fields of an arithmetic type or enum.
+ * @tparam  T   The type of the field.
+ */
+template<typename T>
+struct ArithmeticFlags
+{
+    static const uint32_t kValue = 
+        static_cast<uint32_t>(operators::ARITHMETIC | operators::BITWISE | operators::COMPARE)
+            & ~(std::is_floating_point<T>::value
+                ? static_cast<uint32_t>(operators::BITWISE_NOT) : 0u)
+            & ~(std::is_unsigned<T>::value
+                ? static_cast<uint32_t>(operators::UNARY_MINUS) : 0u)
+            & ~(std::is_enum<T>::value
+                ? static_cast<uint32_t>(operators::INCREMENT | operators::DECREMENT) : 0u)
+            & ~(std::is_same<T, bool>::value
+                ? static_cast<uint32_t>(
+                    operators::INCREMENT | operators::DECREMENT | operators::BITWISE_NOT)
+                : 0u);
+};
+
+// ============================================================================================== //
+// Concrete field object implementation                                                           //
+// ============================================================================================== //
+
+/*
+ * +-----------------------------+-------------------------------------------------+-----------+
+ * | type                        | example(s)                                      | supported |
+ * +-----------------------------+-------------------------------------------------+-----------+
+ * | arithmetic types            | int, float, bool, size_t                        | yes       |
+ * | trivial structs/classes     | struct A { int b; };                            | yes       |
+ * | non-trivial structs/classes | struct A { virtual void b() {} };               | no        |
+ * | enums                       | enum A { B = 0 };                               | yes       |
+ * | enum classes                | enum class A { B = 0 };                         | yes       |
+ * | endian values               | BigEndian<uint32_t>, LittleEndian<float>        | yes       |
+ * | wrapped classes             | struct A : ClassWrapper { REMODEL_WRAPPER(A) }; | yes       |
+ * | functions                   | void a();                                       | yes       |
+ * | virtual functions           | virtual void a();                               | yes       |
+ * +-----------------------------+-------------------------------------------------+-----------+
+ *
+ * +-----------+-----------+--------------------------------------+
+ * | qualifier | supported | notes                                |
+ * + ----------+-----------+--------------------------------------+
+ * | *         | yes       |                                      |
+ * | &         | yes       | expects implementation of ref as ptr |
+ * | &&        | no        | doesn't make any sense to wrap       |
+ * | []        | yes       |                                      |
+ * | [N]       | yes       |                                      |
+ * +-----------+-----------+--------------------------------------+
+ */
+
+#define REMODEL_FIELDIMPL_FORWARD_CTORS                                                            \
+    public:                                                                                        \
+        FieldImpl(WrapperBase *parent, PtrGetterT ptrGetter)                                       \
+            : BasicFieldBase<PtrGetterT>{parent, ptrGetter}                                        \
+        {}                                                                                         \
+                                                                                                   \
+        explicit FieldImpl(const FieldImpl& other) = default;                                      \
+    private:
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] fall-through implementation                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   The kinds of types wrapped by fields, selecting the `FieldImpl` specialization.
+ */
+enum class FieldKind
+{
+    Unsupported,
+    Arithmetic,
+    Array,
+    Class,
+    Endian,
+    EnumClass,
+    Pointer,
+    RvalueRef,
+    Vector,
+};
+
+/**
+ * @internal
+ * @brief   Classifies the type wrapped by a field.
+ * @tparam  T   The wrapped type.
+ *
+ * Classifying once and specializing `FieldImpl` on the resulting constant is cheaper to
+ * instantiate than letting the compiler match every field type against a set of `enable_if`
+ * constrained partial specializations.
+ */
+template<typename T>
+struct FieldKindOf
+{
+    static const FieldKind kValue =
+        IsVectorValue<T>::value ? FieldKind::Vector
+        : std::is_arithmetic<T>::value ? FieldKind::Arithmetic
+        : std::is_pointer<T>::value ? FieldKind::Pointer
+        : std::is_array<T>::value ? FieldKind::Array
+        // Enum classes do not implicitly convert to int, enums do. We use that for filtering.
+        : std::is_enum<T>::value ? (
+            std::is_convertible<T, int>::value ? FieldKind::Arithmetic : FieldKind::EnumClass)
+        : IsEndianValue<T>::value ? FieldKind::Endian
+        : std::is_class<T>::value ? FieldKind::Class
+        : std::is_rvalue_reference<T>::value ? FieldKind::RvalueRef
+        : FieldKind::Unsupported;
+};
+
+/**
+ * @internal
+ * @brief   Fall-through field implementation capturing unsupported types.
+ * @tparam  T           The wrapped type.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation.
+ * @tparam  DerivedT    The concrete field type, providing `valueRef` and `valueCRef`.
+ * @tparam  kindT       The kind of @c T.
+ */
+template<typename T, typename PtrGetterT, typename DerivedT,
+    FieldKind kindT = FieldKindOf<T>::kValue>
+class FieldImpl
+{
+    static_assert(BlackBoxConsts<T>::kFalse, "this types is not supported for wrapping");
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for arithmetic types + enums                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing arithmetic types and enums.
+ * @copydetails FieldImpl
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::Arithmetic>
+    : public BasicFieldBase<PtrGetterT>
+    , public ForwardByFlags<DerivedT, T, ArithmeticFlags<T>::kValue>
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ContiguousRange]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Pair of raw pointers describing the elements of an array or pointer field.
+ * @tparam  T   The element type.
+ *
+ * The iterators are plain pointers, thus contiguous and usable with everything in `<algorithm>`,
+ * including the parallel overloads taking an execution policy.
+ */
+template<typename T>
+class ContiguousRange
+{
+    T* m_first;
+    T* m_last;
+public:
+    ContiguousRange(T* first, std::size_t count)
+        : m_first{first}
+        , m_last{first + count}
+    {}
+
+    T* begin() const { return m_first; }
+    T* end() const { return m_last; }
+    T* data() const { return m_first; }
+    std::size_t size() const { return static_cast<std::size_t>(m_last - m_first); }
+    bool empty() const { return m_first == m_last; }
+    T& operator [] (std::size_t idx) const
+    {
+        REMODEL_CHECK_INDEX(idx, size());
+        return m_first[idx];
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for arrays                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing arrays.
+ * @copydetails FieldImpl
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::Array>
+    : public BasicFieldBase<PtrGetterT>
+    , public ForwardByFlags<
+        DerivedT,
+        T,
+        operators::ARRAY_SUBSCRIPT 
+            | operators::INDIRECTION 
+            | operators::SUBTRACT
+            | operators::ADD
+            | (std::is_class<T>::value ? operators::STRUCT_DEREFERENCE : 0)
+    >
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+    static_assert(!std::is_base_of<WrapperBase, T>::value, "internal library error");
+public:
+    using ElementType = std::remove_extent_t<T>;
+
+    // Arrays of wrappers are rewritten to arrays of weak wrappers, so iterating yields
+    // `Wrapper::Weak&`s that can be used via `with` without constructing strong wrappers.
+    ElementType* data()             { return static_cast<DerivedT*>(this)->valueRef(); }
+    const ElementType* data() const { return static_cast<const DerivedT*>(this)->valueCRef(); }
+    ElementType* begin()             { return data(); }
+    ElementType* end()               { return data() + size(); }
+    const ElementType* begin() const { return data(); }
+    const ElementType* end() const   { return data() + size(); }
+    static constexpr std::size_t size() { return std::extent<T>::value; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for structs/classes                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing `class` and `struct` types.
+ * @copydetails FieldImpl
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::Class>
+    : public BasicFieldBase<PtrGetterT>
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+    // Triviality is checked by `Field`, objects referenced by reference fields needn't be.
+    static_assert(!std::is_base_of<WrapperBase, T>::value, "internal library error");
+public:
+    // C++ does not allow overloading the dot operator (yet), so we provide an -> operator behaving
+    // like the dot operator instead plus a more verbose syntax using the get() function.
+    T& get()                      { return static_cast<DerivedT*>(this)->valueRef(); }
+    const T& get() const          { return static_cast<const DerivedT*>(this)->valueCRef(); }
+    T* operator -> ()             { return &get(); }
+    const T* operator -> () const { return &get(); }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for endian values                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing `EndianValue`s, behaving like arithmetic fields.
+ * @copydetails FieldImpl
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::Endian>
+    : public BasicFieldBase<PtrGetterT>
+    , public ForwardByFlags<DerivedT, T, ArithmeticFlags<typename T::ValueType>::kValue>
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+public:
+    using ValueType = typename T::ValueType;
+
+    /**
+     * @brief   Reads the value.
+     * @return  The value, in host byte order.
+     */
+    ValueType get() const { return static_cast<const DerivedT*>(this)->valueCRef().get(); }
+
+    /**
+     * @brief   Writes the value.
+     * @param   value   The value, in host byte order.
+     */
+    void set(ValueType value) { static_cast<DerivedT*>(this)->valueRef().set(value); }
+
+    /**
+     * @brief   Implicit cast to the value.
+     * @return  The value, in host byte order.
+     */
+    operator ValueType () const { return get(); }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for SIMD vectors                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing SIMD vectors (`__m128`, `__m256`, `simd::Vec4f`, ..).
+ * @copydetails FieldImpl
+ *
+ * Vectors are only ever accessed as a whole, so reading or writing the field is a single vector
+ * move. Plain fields require the vector to be aligned as its type demands, fields using
+ * `access::Unaligned` don't. Either way, the field exposes values rather than references.
+ * Operators are forwarded where the vector type supports them.
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::Vector>
+    : public BasicFieldBase<PtrGetterT>
+    , public ForwardByFlags<
+        DerivedT,
+        T,
+        operators::ADD | operators::SUBTRACT | operators::MULTIPLY | operators::DIVIDE
+    >
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+public:
+    /**
+     * @brief   Loads the vector.
+     * @return  The vector.
+     */
+    T get() const { return static_cast<const DerivedT*>(this)->valueCRef(); }
+
+    /**
+     * @brief   Stores the vector.
+     * @param   value   The vector.
+     */
+    void set(const T& value) { static_cast<DerivedT*>(this)->valueRef() = value; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for enums/enum classes                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing `enum class` types.
+ * @copydetails FieldImpl
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::EnumClass>
+    : public BasicFieldBase<PtrGetterT>
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+public:
+    // Nothing to do here!
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for pointers                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename PtrT, typename = void> struct TryFollow;
+
+/**
+ * @internal
+ * @brief   Field implementation capturing pointers.
+ * @copydetails FieldImpl
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+// We capture pointers by kind to maintain the CV-qualifiers on the pointer itself.
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::Pointer>
+    : public BasicFieldBase<PtrGetterT>
+    , public ForwardByFlags<
+        DerivedT,
+        T,
+        operators::ARRAY_SUBSCRIPT 
+            // Indirection operator is forwarded through implicit conversion operator.
+            // Explicit implementation disabled due to decltype bug in MSVC.
+            //| (std::is_void<std::remove_pointer_t<T>>::value ? 0 : operators::INDIRECTION)
+            | operators::SUBTRACT
+            | operators::ADD
+            | (std::is_class<std::remove_pointer_t<T>>::value ? operators::STRUCT_DEREFERENCE : 0)
+    >
+{
+    REMODEL_FIELDIMPL_FORWARD_CTORS
+public:
+    /**
+     * @brief   Views the memory pointed to as an array of a given length.
+     * @param   count   The number of elements, e.g. read from a sibling count field.
+     * @return  A range over the elements, iterable with range-for and `<algorithm>`.
+     */
+    template<typename U = std::remove_pointer_t<T>,
+        typename = std::enable_if_t<!std::is_void<U>::value>>
+    ContiguousRange<U> range(std::size_t count) const
+    {
+        return {static_cast<const DerivedT*>(this)->valueCRef(), count};
+    }
+
+    /**
+     * @brief   Follows the pointer without trusting it.
+     * @return  The pointee, as a strong wrapper for pointers to wrappers, or nothing if the
+     *          pointer is null or implausible. See `OptionalView`.
+     */
+    auto tryGet() const
+    {
+        const auto ptr = static_cast<const DerivedT*>(this)->valueCRef();
+        return TryFollow<std::decay_t<decltype(ptr)>>::follow(ptr);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldImpl] for rvalue-references                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @internal
+ * @brief   Field implementation capturing rvalue-references.
+ * @tparam  T   The wrapped type.
+ * @warning Wrapping rvalue-references is not supported. If you shoud ever find any real-world
+ *          use case for wrapping rvalue-references, feel free to contact me.
+ */
+template<typename T, typename PtrGetterT, typename DerivedT>
+class FieldImpl<T, PtrGetterT, DerivedT, FieldKind::RvalueRef>
+{
+    static_assert(BlackBoxConsts<T>::kFalse, "rvalue-reference-fields are not supported");
+};
+
+#undef REMODEL_FIELDIMPL_FORWARD_CTORS
+
+// ---------------------------------------------------------------------------------------------- //
+// [RewriteWrappers] + helper types                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+// Step 3: Implementation capturing simple wrapper types.
+template<typename BaseTypeT, typename QualifierStackT, typename = void>
+struct RewriteWrappersStep3
+{
+    static_assert(BlackBoxConsts<QualifierStackT>::kFalse,
+        "using wrapped types in fields requires usage of AdvancedClassWrapper as base");
+};
+
+// Step 3: Implementation capturing advanced wrapper types (manual SFINAE).
+template<typename BaseTypeT, typename QualifierStackT>
+struct RewriteWrappersStep3<BaseTypeT, QualifierStackT, typename BaseTypeT::IsAdvWrapper>
+{
+    // Rewrite wrapper type with WrapperPtr.
+    using Type = ApplyQualifierStack<
+        WeakWrapper<BaseTypeT>,
+        BaseTypeT, 
+        QualifierStackT
+        >;
+};
+
+// Step 2: Implementation capturing non-wrapper types.
+template<typename BaseTypeT, typename QualifierStackT, typename = void>
+struct RewriteWrappersStep2
+{
+    // Nothing to do, just reassemble type.
+    using Type = ApplyQualifierStack<BaseTypeT, BaseTypeT, QualifierStackT>;
+};
+
+// Step 2: Implementation capturing wrapper types.
+template<typename BaseTypeT, typename QualifierStackT>
+struct RewriteWrappersStep2<
+    BaseTypeT, 
+    QualifierStackT, 
+    std::enable_if_t<std::is_base_of<WrapperBase, BaseTypeT>::value>
+> : RewriteWrappersStep3<BaseTypeT, QualifierStackT> {};
+
+// Step 1: Dissect type into base-type and qualifier-stack.
+template<typename T, typename = void>
+struct RewriteWrappersStep1
+    : RewriteWrappersStep2<
+        typename AnalyzeQualifiers<T>::BaseType,
+        typename AnalyzeQualifiers<T>::QualifierStack
+    >
+{};
+
+// Step 1: Shortcut for the bulk of field types, which can't contain wrappers: scalars (without
+// indirection) and non-wrapper classes are kept as they are, skipping the qualifier analysis.
+template<typename T>
+struct RewriteWrappersStep1<T, std::enable_if_t<
+        std::is_arithmetic<T>::value
+        || std::is_enum<T>::value
+        || (std::is_class<T>::value && !std::is_base_of<WrapperBase, T>::value)
+    >>
+{
+    using Type = T;
+};
+
+/**
+ * @internal
+ * @brief   Rewrites wrapper types to the corresponding `WeakWrapper` type.
+ */
+template<typename T>
+using RewriteWrappers = typename RewriteWrappersStep1<T>::Type;
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [AtomicOps] + [access] policies                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Atomic operations on plain objects, the pre-C++20 equivalent of `std::atomic_ref`.
+ * @tparam  T   The type of the objects.
+ *
+ * GCC and clang provide builtins working on any suitably aligned object. Elsewhere, the object is
+ * accessed through a `std::atomic<T>`, which has the same representation as `T` for lock-free
+ * types with all supported compilers.
+ */
+template<typename T>
+struct AtomicOps
+{
+#if defined(ZYCORE_GNUC)
+    static int order(std::memory_order order) { return static_cast<int>(order); }
+
+    static T load(const T* obj, std::memory_order mo)
+    {
+        T result;
+        __atomic_load(const_cast<T*>(obj), &result, order(mo));
+        return result;
+    }
+
+    static void store(T* obj, T value, std::memory_order mo)
+    {
+        __atomic_store(obj, &value, order(mo));
+    }
+
+    static T exchange(T* obj, T value, std::memory_order mo)
+    {
+        T result;
+        __atomic_exchange(obj, &value, &result, order(mo));
+        return result;
+    }
+
+    static bool compareExchange(T* obj, T& expected, T desired, bool weak,
+        std::memory_order success, std::memory_order failure)
+    {
+        return __atomic_compare_exchange(
+            obj, &expected, &desired, weak, order(success), order(failure));
+    }
+
+    static T fetchAdd(T* obj, T value, std::memory_order mo)
+    {
+        return __atomic_fetch_add(obj, value, order(mo));
+    }
+
+    static T fetchSub(T* obj, T value, std::memory_order mo)
+    {
+        return __atomic_fetch_sub(obj, value, order(mo));
+    }
+
+    static T fetchAnd(T* obj, T value, std::memory_order mo)
+    {
+        return __atomic_fetch_and(obj, value, order(mo));
+    }
+
+    static T fetchOr(T* obj, T value, std::memory_order mo)
+    {
+        return __atomic_fetch_or(obj, value, order(mo));
+    }
+
+    static T fetchXor(T* obj, T value, std::memory_order mo)
+    {
+        return __atomic_fetch_xor(obj, value, order(mo));
+    }
+#else
+    static_assert(sizeof(std::atomic<T>) == sizeof(T) && alignof(std::atomic<T>) == alignof(T),
+        "std::atomic<T> isn't layout-compatible to T on this compiler");
+
+    static std::atomic<T>* ref(const T* obj)
+    {
+        return reinterpret_cast<std::atomic<T>*>(const_cast<T*>(obj));
+    }
+
+    static T load(const T* obj, std::memory_order mo) { return ref(obj)->load(mo); }
+    static void store(T* obj, T value, std::memory_order mo) { ref(obj)->store(value, mo); }
+
+    static T exchange(T* obj, T value, std::memory_order mo)
+    {
+        return ref(obj)->exchange(value, mo);
+    }
+
+    static bool compareExchange(T* obj, T& expected, T desired, bool weak,
+        std::memory_order success, std::memory_order failure)
+    {
+        return weak
+            ? ref(obj)->compare_exchange_weak(expected, desired, success, failure)
+            : ref(obj)->compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    static T fetchAdd(T* obj, T value, std::memory_order mo)
+    {
+        return ref(obj)->fetch_add(value, mo);
+    }
+
+    static T fetchSub(T* obj, T value, std::memory_order mo)
+    {
+        return ref(obj)->fetch_sub(value, mo);
+    }
+
+    static T fetchAnd(T* obj, T value, std::memory_order mo)
+    {
+        return ref(obj)->fetch_and(value, mo);
+    }
+
+    static T fetchOr(T* obj, T value, std::memory_order mo)
+    {
+        return ref(obj)->fetch_or(value, mo);
+    }
+
+    static T fetchXor(T* obj, T value, std::memory_order mo)
+    {
+        return ref(obj)->fetch_xor(value, mo);
+    }
+#endif
+
+    /**
+     * @internal
+     * @brief   Derives the failure order of a compare-exchange from its success order, just like
+     *          the single-order overloads of `std::atomic` do.
+     */
+    static std::memory_order failureOrderOf(std::memory_order success)
+    {
+        return success == std::memory_order_acq_rel ? std::memory_order_acquire
+            : success == std::memory_order_release ? std::memory_order_relaxed : success;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Loads an object with a load the compiler may merge with other loads of the same
+ *          address and hoist out of loops, even across stores and calls.
+ * @param   obj The object.
+ * @return  The value of the object.
+ *
+ * On x86 with GCC and clang, the load is hidden in an asm statement that only takes the address
+ * as input and thus is treated as a pure function of it. Elsewhere this is an ordinary load.
+ */
+template<typename T>
+inline T loadInvariant(const T* obj)
+{
+#if defined(ZYCORE_GNUC) && (defined(__x86_64__) || defined(__i386__))
+    using Raw = typename simd::internal::UIntOfSize<
+        sizeof(T) <= sizeof(void*) && (sizeof(T) & (sizeof(T) - 1)) == 0 ? sizeof(T) : 1>::Type;
+    if (sizeof(T) == sizeof(Raw))
+    {
+        Raw raw;
+        // `q` restricts byte loads to registers having a byte form on x86-32.
+        asm("mov (%1), %0" : "=q"(raw) : "r"(obj));
+        T value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return value;
+    }
+#endif
+    return *obj;
+}
+
+} // namespace internal
+
+/**
+ * @brief   Access policies of fields, selecting the semantics of loads and stores.
+ *
+ * Passed as third template argument to `Field`. Policies other than `Plain` are available for
+ * arithmetic fields, enums and SIMD vectors only; the field then exposes values instead of
+ * references: implicit conversions load, assignments store and compound operators load, compute
+ * and store.
+ *
+ * @code
+ *     Field<float, OffsGetter, access::Cached>    tickRate{this, 0x10}; // fixed per frame
+ *     Field<bool, OffsGetter, access::Volatile>   done    {this, 0x14}; // polled in a loop
+ *     Field<int32_t, OffsGetter, access::Relaxed> health  {this, 0x18}; // written concurrently
+ * @endcode
+ */
+namespace access
+{
+
+/**
+ * @brief   Ordinary loads and stores through references, the default.
+ */
+struct Plain {};
+
+/**
+ * @brief   Every access hits memory, like accesses through a `volatile` object.
+ *
+ * Prevents the compiler from merging or hoisting reads of values changing behind its back, e.g.
+ * flags polled in a loop. Doesn't order the accesses relative to other threads.
+ */
+struct Volatile
+{
+    template<typename T>
+    static T load(const T* obj) { return *static_cast<const volatile T*>(obj); }
+
+    template<typename T>
+    static void store(T* obj, T value) { *static_cast<volatile T*>(obj) = value; }
+};
+
+/**
+ * @brief   Relaxed atomic loads and stores.
+ *
+ * Accesses neither tear nor race with threads of the target writing the same object, without
+ * any fencing. Compound operators are a relaxed load followed by a relaxed store, use
+ * `AtomicField` for atomic read-modify-write operations.
+ */
+struct Relaxed
+{
+    template<typename T>
+    static T load(const T* obj)
+    {
+        return internal::AtomicOps<T>::load(obj, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    static void store(T* obj, T value)
+    {
+        internal::AtomicOps<T>::store(obj, value, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief   Loads may be merged and hoisted, even across stores and calls.
+ *
+ * Declares that the value doesn't change while it is used (e.g. during a frame), so the
+ * compiler may keep it in a register instead of reloading it after every call in a hot loop.
+ * Stores through the field are ordinary stores, but may not be observed by merged loads.
+ */
+struct Cached
+{
+    template<typename T>
+    static T load(const T* obj) { return internal::loadInvariant(obj); }
+
+    template<typename T>
+    static void store(T* obj, T value) { *obj = value; }
+};
+
+/**
+ * @brief   Loads and stores not assuming the object to be aligned as its type demands.
+ *
+ * For objects located at addresses the compiler can't rely on, e.g. vectors inside of packed
+ * structures. SIMD vectors are then moved by single unaligned vector loads and stores.
+ */
+struct Unaligned
+{
+    template<typename T>
+    static T load(const T* obj)
+    {
+        T value;
+        std::memcpy(&value, obj, sizeof(value));
+        return value;
+    }
+
+    template<typename T>
+    static void store(T* obj, T value) { std::memcpy(obj, &value, sizeof(value)); }
+};
+
+} // namespace access
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Reference to an object, accessing it by an access policy other than `access::Plain`.
+ * @tparam  T           The type of the object.
+ * @tparam  AccessT     The access policy.
+ *
+ * Returned by value from the field, so the operators return copies rather than references to
+ * potentially temporary objects.
+ */
+template<typename T, typename AccessT>
+class AccessRef
+{
+    T* m_obj;
+public:
+    explicit AccessRef(T* obj)
+        : m_obj{obj}
+    {}
+
+    AccessRef(const AccessRef&) = default;
+
+    operator T () const { return AccessT::load(m_obj); }
+
+    AccessRef& operator = (T value)
+    {
+        AccessT::store(m_obj, value);
+        return *this;
+    }
+
+    AccessRef& operator = (const AccessRef& rhs)
+    {
+        return *this = static_cast<T>(rhs);
+    }
+
+#define REMODEL_ACCESSREF_COMPOUND_OPERATOR(op)                                                    \
+    template<typename RhsT, typename U = T,                                                        \
+        typename = decltype(std::declval<U&>() op##= std::declval<const RhsT&>())>                 \
+    AccessRef& operator op##= (const RhsT& rhs)                                                    \
+    {                                                                                              \
+        T value = *this;                                                                           \
+        value op##= rhs;                                                                           \
+        return *this = value;                                                                      \
+    }
+
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(+)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(-)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(*)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(/)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(%)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(|)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(&)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(^)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(<<)
+    REMODEL_ACCESSREF_COMPOUND_OPERATOR(>>)
+
+#undef REMODEL_ACCESSREF_COMPOUND_OPERATOR
+
+    template<typename U = T, typename = decltype(++std::declval<U&>())>
+    AccessRef& operator ++ () { return *this += 1; }
+
+    template<typename U = T, typename = decltype(--std::declval<U&>())>
+    AccessRef& operator -- () { return *this -= 1; }
+
+    template<typename U = T, typename = decltype(std::declval<U&>()++)>
+    T operator ++ (int)
+    {
+        // Not implemented via the prefix operator, which would load the value a second time.
+        T value = *this;
+        T result = value;
+        *this = ++result;
+        return value;
+    }
+
+    template<typename U = T, typename = decltype(std::declval<U&>()--)>
+    T operator -- (int)
+    {
+        // Not implemented via the prefix operator, which would load the value a second time.
+        T value = *this;
+        T result = value;
+        *this = --result;
+        return value;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Loads and stores of SIMD vectors aligned as their type demands.
+ *
+ * Vectors are moved with `memcpy` rather than through references: vector types lose their
+ * `may_alias` attribute when used as template arguments, so accessing e.g. arrays of floats
+ * through references to them would break strict aliasing.
+ */
+struct AlignedVectorAccess
+{
+    template<typename T>
+    static const T* assumeAligned(const T* obj)
+    {
+#   if defined(ZYCORE_GNUC)
+        return static_cast<const T*>(__builtin_assume_aligned(obj, alignof(T)));
+#   else
+        return obj;
+#   endif
+    }
+
+    template<typename T>
+    static T load(const T* obj)
+    {
+        T value;
+        std::memcpy(&value, assumeAligned(obj), sizeof(value));
+        return value;
+    }
+
+    template<typename T>
+    static void store(T* obj, T value)
+    {
+        std::memcpy(const_cast<T*>(assumeAligned(obj)), &value, sizeof(value));
+    }
+};
+
+/**
+ * @internal
+ * @brief   The types fields expose their objects as, by access policy.
+ * @tparam  T           The type of the object.
+ * @tparam  AccessT     The access policy.
+ */
+template<typename T, typename AccessT, typename = void>
+struct AccessTraits
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value
+        || IsVectorValue<T>::value,
+        "access policies other than `access::Plain` are only supported for arithmetic types, "
+        "enums and SIMD vectors");
+
+    using Ref  = AccessRef<T, AccessT>;
+    using CRef = T;
+
+    static Ref ref(T* obj) { return Ref{obj}; }
+    static CRef cref(const T* obj) { return AccessT::load(obj); }
+};
+
+/**
+ * @internal
+ * @brief   Plain accesses go through ordinary references.
+ * @copydetails AccessTraits
+ */
+template<typename T>
+struct AccessTraits<T, access::Plain, std::enable_if_t<!IsVectorValue<T>::value>>
+{
+    using Ref  = T&;
+    using CRef = const T&;
+
+    static Ref ref(T* obj) { return *obj; }
+    static CRef cref(const T* obj) { return *obj; }
+};
+
+/**
+ * @internal
+ * @brief   Plain accesses of SIMD vectors are aligned vector loads and stores.
+ * @copydetails AccessTraits
+ */
+template<typename T>
+struct AccessTraits<T, access::Plain, std::enable_if_t<IsVectorValue<T>::value>>
+    : AccessTraits<T, AlignedVectorAccess>
+{};
+
+} // namespace internal
+
+// ============================================================================================== //
+// Remodeling classes                                                                             //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [Field]                                                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Class representing a field (attribute, member variable) of a wrapper class.
+ * @tparam  T           The type of the field represent.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation. Defaults to a 
+ *                      type-erased functor accepting any `PtrGetter`. Specifying a concrete 
+ *                      `PtrGetter` type here (e.g. `OffsGetter`) allows the compiler to inline
+ *                      the address calculation and shrinks the field to the size of the getter.
+ * @tparam  AccessT     The access policy, see `access`. Defaults to ordinary loads and stores.
+ */
+template<
+    typename T,
+    typename PtrGetterT = internal::FieldBase::PtrGetter,
+    typename AccessT = access::Plain>
+class Field 
+    : public internal::FieldImpl<
+        internal::RewriteWrappers<std::remove_reference_t<T>>, 
+        PtrGetterT, 
+        Field<T, PtrGetterT, AccessT>
+    >
+{
+    template<typename, typename, typename, internal::FieldKind> friend class internal::FieldImpl;
+    template<typename, typename, uint32_t> friend class internal::ForwardByFlags;
+public:
+    using RewrittenT = internal::RewriteWrappers<std::remove_reference_t<T>>;
+protected:
+    using CompleteProxy = internal::FieldImpl<RewrittenT, PtrGetterT, Field>;
+    using Access = internal::AccessTraits<RewrittenT, AccessT>;
+    static const bool kDoExtraDref =
+        std::is_reference<T>::value && !internal::IsDerefGetter<PtrGetterT>::value;
+    static_assert(std::is_reference<T>::value || !internal::IsDerefGetter<PtrGetterT>::value,
+        "getters following references require reference fields");
+    static_assert(std::is_reference<T>::value || !std::is_class<RewrittenT>::value
+        || internal::IsEndianValue<RewrittenT>::value || std::is_trivial<RewrittenT>::value,
+        "wrapping is only supported for trivial types, objects referenced by reference fields "
+        "excepted");
+
+    // What is stored at the address of the field, for the checks of the `REMODEL_CHECKED` mode.
+    // Arrays of unknown bound take no space of their own.
+    static const std::size_t kStoredSize = kDoExtraDref ? sizeof(void*)
+        : std::is_array<RewrittenT>::value && !std::extent<RewrittenT>::value ? 0
+        : sizeof(std::conditional_t<std::is_array<RewrittenT>::value
+            && !std::extent<RewrittenT>::value, char, RewrittenT>);
+    static const std::size_t kStoredAlign = kDoExtraDref ? alignof(void*)
+        : std::is_same<AccessT, access::Unaligned>::value
+            || internal::IsEndianValue<RewrittenT>::value ? 1 : alignof(RewrittenT);
+
+    RewrittenT* objPtr()
+    {
+        auto ptr = this->rawPtr();
+        REMODEL_CHECK_FIELD(this->parent(), ptr, kStoredSize, kStoredAlign);
+        return static_cast<RewrittenT*>(kDoExtraDref ? *reinterpret_cast<RewrittenT**>(ptr) : ptr);
+    }
+
+    const RewrittenT* objCPtr() const
+    {
+        auto ptr = this->crawPtr();
+        REMODEL_CHECK_FIELD(this->parent(), ptr, kStoredSize, kStoredAlign);
+        return static_cast<const RewrittenT*>(kDoExtraDref
+            ? *reinterpret_cast<const RewrittenT* const*>(ptr) : ptr);
+    }
+protected: // Accessors used by the operator forwarders
+    /**
+     * @brief   Obtains a reference to the wrapped object.
+     * @return  The reference to the wrapped object, an `AccessRef` for access policies other
+     *          than `access::Plain`.
+     */
+    typename Access::Ref valueRef() { return Access::ref(this->objPtr()); }
+
+    /**
+     * @brief   Obtains a constant reference to the wrapped object.
+     * @return  The reference to the wrapped object, the loaded value for access policies other
+     *          than `access::Plain`.
+     */
+    typename Access::CRef valueCRef() const { return Access::cref(this->objCPtr()); }
+public:
+    /**
+     * @brief   Constructs a field from a parent and a `PtrGetter`.
+     * @param   parent      The class wrapper that is the parent of this object.
+     * @param   ptrGetter   The function used to calculate the final address of the wrapped field.
+     * @see     Global
+     * @see     Module
+     */
+    Field(internal::WrapperBase* parent, PtrGetterT ptrGetter)
+        : CompleteProxy{parent, ptrGetter}
+    {
+        REMODEL_CHECK_GETTER(parent, this->ptrGetter(), kStoredSize);
+    }
+
+    /**
+     * @brief   Copy constructor.
+     * 
+     * Explicit, so fields aren't accidentally copied where a copy of the wrapped value is meant.
+     * Only available for fields using a `RelativeParentLink`, allowing for bytewise copies of
+     * wrappers (see `LightClassWrapper`).
+     */
+    explicit Field(const Field&) = default;
+
+    /**
+     * @brief   Convenience constructs defaulting to an `OffsGetter` as `ptrGetter`.
+     * @param   parent      The class wrapper that is the parent of this object.
+     * @param   ptrGetter   The function used to calculate the final address of the wrapped field.
+     * @see     Global
+     * @see     Module
+     */
+    template<
+        typename GetterT = PtrGetterT, 
+        typename = std::enable_if_t<std::is_constructible<GetterT, OffsGetter>::value>>
+    Field(internal::WrapperBase* parent, std::ptrdiff_t offset)
+        : CompleteProxy{parent, PtrGetterT(OffsGetter{offset})}
+    {
+        REMODEL_CHECK_OFFSET(parent, offset, kStoredSize);
+    }
+
+    /**
+     * @brief   Convenience constructor for stateless `PtrGetter` types (e.g. `StaticOffsGetter`).
+     * @param   parent      The class wrapper that is the parent of this object.
+     */
+    template<
+        typename GetterT = PtrGetterT, 
+        typename = std::enable_if_t<std::is_empty<GetterT>::value 
+            && std::is_default_constructible<GetterT>::value>>
+    explicit Field(internal::WrapperBase* parent)
+        : CompleteProxy{parent, PtrGetterT{}}
+    {
+        REMODEL_CHECK_GETTER(parent, this->ptrGetter(), kStoredSize);
+    }
+
+    /**
+     * @brief   Implicit cast to a reference to the wrapped field.
+     * @return  The desired reference.
+     */
+    operator typename Access::Ref () { return this->valueRef(); }
+    
+    /**
+     * @brief   Implicit cast to a constant reference to the wrapped field.
+     * @return  The desired reference (the value for access policies other than `access::Plain`).
+     */
+    operator typename Access::CRef () const { return this->valueCRef(); }
+
+    /**
+     * @brief   Assignment operator simulating normal copy semantics for fields.
+     * @param   rhs The right hand side.
+     * @return  `*this`.
+     */
+    typename Access::Ref operator = (const Field& rhs)
+    {
+        return this->valueRef() = rhs.valueCRef();
+    }
+
+    /**
+     * @brief   Assignment operator simulating normal copy semantics for fields.
+     * @param   rhs The right hand side.
+     * @return  `*this`.
+     */
+    typename Access::Ref operator = (const RewrittenT& rhs)
+    {
+        return this->valueRef() = rhs;
+    }
+
+    /**
+     * @brief   Obtains a raw pointer to the wrapped object.
+     * @return  The desired pointer.
+     */
+    RewrittenT* addressOfObj()               { return this->objPtr(); }
+
+    /**
+     * @brief   Obtains a constant raw pointer to the wrapped object.
+     * @return  The desired pointer.
+     */
+    const RewrittenT* addressOfObj() const   { return this->objCPtr(); }
+
+    /**
+     * @brief   Obtains a pointer to the wrapper object.
+     * @return  `this`.
+     */
+    Field* addressOfWrapper()                { return this; }
+
+    /**
+     * @brief   Obtains a constant pointer to the wrapper object.
+     * @return  `this`.
+     */
+    const Field* addressOfWrapper() const    { return this; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [StaticField]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Field located at a compile-time offset inside of its parent.
+ * @tparam  T       The type of the field represent.
+ * @tparam  offsT   The offset of the field inside of the wrapped class, in bytes.
+ *                  
+ * Behaves exactly like `Field`, but folds the offset into the type instead of storing a 
+ * type-erased `PtrGetter`, so accesses compile down to a plain load relative to the raw pointer
+ * of the parent.
+ * 
+ * @code
+ *     Field<uint8_t>            age{this, 124}; // offset stored in a `PtrGetter`
+ *     StaticField<uint8_t, 124> age{this};      // offset folded into the type
+ * @endcode
+ */
+template<typename T, std::ptrdiff_t offsT>
+using StaticField = Field<T, StaticOffsGetter<offsT>>;
+
+// ---------------------------------------------------------------------------------------------- //
+// [BitField]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Field representing a range of bits inside of an unsigned integer of its parent.
+ * @tparam  T           The unsigned integer type the bits are stored in.
+ * @tparam  bitOffsetT  The index of the lowest bit of the range.
+ * @tparam  bitWidthT   The number of bits in the range.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation of the integer.
+ *
+ * Shift and mask are compile-time constants, so reads boil down to a load, a shift and an and,
+ * writes and compound assignments to a single read-modify-write of the integer. Values are
+ * exposed as `T`; read-only operators work through the implicit conversion, assignments store
+ * the value truncated to the width of the range.
+ *
+ * @code
+ *     Field<uint32_t>          flags  {this, 0x20}; // masking at every call site
+ *     BitField<uint32_t, 4, 3> level  {this, 0x20}; // bits 4 to 6 of the same integer
+ *     BitField<uint32_t, 7, 1> isAdmin{this, 0x20};
+ *
+ *     if (isAdmin) ++level;
+ * @endcode
+ */
+template<typename T, unsigned bitOffsetT, unsigned bitWidthT, 
+    typename PtrGetterT = internal::FieldBase::PtrGetter>
+class BitField : public internal::BasicFieldBase<PtrGetterT>
+{
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value 
+        && !std::is_same<T, bool>::value, "bit fields must be stored in unsigned integers");
+    static_assert(bitWidthT > 0 && bitOffsetT + bitWidthT <= sizeof(T) * 8,
+        "the bit range exceeds the integer");
+public:
+    static const unsigned kBitOffset = bitOffsetT;
+    static const unsigned kBitWidth = bitWidthT;
+    /// The mask of the value, before shifting it into place.
+    static const T kMask = static_cast<T>(static_cast<T>(~T(0)) >> (sizeof(T) * 8 - bitWidthT));
+private:
+    static const T kShiftedMask = static_cast<T>(kMask << bitOffsetT);
+
+    T& word() { return *static_cast<T*>(this->rawPtr()); }
+    const T& word() const { return *static_cast<const T*>(this->crawPtr()); }
+
+    static T extract(T word) { return static_cast<T>((word >> bitOffsetT) & kMask); }
+
+    static T insert(T word, T value)
+    {
+        return static_cast<T>((word & ~kShiftedMask) | ((value & kMask) << bitOffsetT));
+    }
+
+    /**
+     * @brief   Replaces the value by the result of a function, reading the integer just once.
+     * @param   func    Function mapping the old value to the new one.
+     * @return  The old value.
+     */
+    template<typename FuncT>
+    T modify(FuncT func)
+    {
+        auto& raw = word();
+        const auto old = raw;
+        raw = insert(old, static_cast<T>(func(extract(old))));
+        return extract(old);
+    }
+public:
+    /**
+     * @brief   Constructs a bit field from a parent and a `PtrGetter`.
+     * @param   parent      The class wrapper that is the parent of this object.
+     * @param   ptrGetter   The function used to calculate the address of the integer.
+     */
+    BitField(internal::WrapperBase* parent, PtrGetterT ptrGetter)
+        : internal::BasicFieldBase<PtrGetterT>{parent, ptrGetter}
+    {}
+
+    /**
+     * @brief   Copy constructor.
+     * @see     Field::Field(const Field&)
+     */
+    explicit BitField(const BitField&) = default;
+
+    /**
+     * @brief   Convenience constructs defaulting to an `OffsGetter` as `ptrGetter`.
+     * @param   parent  The class wrapper that is the parent of this object.
+     * @param   offset  The offset of the integer inside of the parent, in bytes.
+     */
+    template<
+        typename GetterT = PtrGetterT, 
+        typename = std::enable_if_t<std::is_constructible<GetterT, OffsGetter>::value>>
+    BitField(internal::WrapperBase* parent, std::ptrdiff_t offset)
+        : BitField{parent, PtrGetterT(OffsGetter{offset})}
+    {}
+
+    /**
+     * @brief   Convenience constructor for stateless `PtrGetter` types (e.g. `StaticOffsGetter`).
+     * @param   parent  The class wrapper that is the parent of this object.
+     */
+    template<
+        typename GetterT = PtrGetterT, 
+        typename = std::enable_if_t<std::is_empty<GetterT>::value 
+            && std::is_default_constructible<GetterT>::value>>
+    explicit BitField(internal::WrapperBase* parent)
+        : BitField{parent, PtrGetterT{}}
+    {}
+
+    /**
+     * @brief   Reads the value.
+     * @return  The value.
+     */
+    T get() const { return extract(word()); }
+
+    /**
+     * @brief   Writes the value, leaving the other bits of the integer untouched.
+     * @param   value   The new value, truncated to the width of the field.
+     */
+    void set(T value) 
+    { 
+        auto& raw = word();
+        raw = insert(raw, value);
+    }
+
+    /**
+     * @brief   Implicit cast to the value.
+     * @return  The value.
+     */
+    operator T () const { return get(); }
+
+    /**
+     * @brief   Assignment operator writing the value.
+     * @param   rhs The right hand side.
+     * @return  `*this`.
+     */
+    BitField& operator = (T rhs)
+    {
+        set(rhs);
+        return *this;
+    }
+
+    /**
+     * @brief   Assignment operator simulating normal copy semantics for fields.
+     * @param   rhs The right hand side.
+     * @return  `*this`.
+     */
+    BitField& operator = (const BitField& rhs)
+    {
+        set(rhs.get());
+        return *this;
+    }
+
+#define REMODEL_BITFIELD_COMPOUND_OPERATOR(op)                                                     \
+    template<typename RhsT>                                                                        \
+    BitField& operator op##= (const RhsT& rhs)                                                     \
+    {                                                                                              \
+        modify([&](T value) { return value op rhs; });                                             \
+        return *this;                                                                              \
+    }
+
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(+)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(-)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(*)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(/)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(%)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(|)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(&)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(^)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(<<)
+    REMODEL_BITFIELD_COMPOUND_OPERATOR(>>)
+
+#undef REMODEL_BITFIELD_COMPOUND_OPERATOR
+
+    BitField& operator ++ ()
+    {
+        modify([](T value) { return value + 1; });
+        return *this;
+    }
+
+    BitField& operator -- ()
+    {
+        modify([](T value) { return value - 1; });
+        return *this;
+    }
+
+    T operator ++ (int) { return modify([](T value) { return value + 1; }); }
+    T operator -- (int) { return modify([](T value) { return value - 1; }); }
+
+    /**
+     * @brief   Obtains a raw pointer to the integer holding the bits.
+     * @return  The desired pointer.
+     */
+    T* addressOfObj() { return &word(); }
+
+    /**
+     * @brief   Obtains a constant raw pointer to the integer holding the bits.
+     * @return  The desired pointer.
+     */
+    const T* addressOfObj() const { return &word(); }
+
+    /**
+     * @brief   Obtains a pointer to the wrapper object.
+     * @return  `this`.
+     */
+    BitField* addressOfWrapper() { return this; }
+
+    /**
+     * @brief   Obtains a constant pointer to the wrapper object.
+     * @return  `this`.
+     */
+    const BitField* addressOfWrapper() const { return this; }
+};
+
+/**
+ * @brief   Bit field located at a compile-time offset inside of its parent.
+ * @see     StaticField
+ */
+template<typename T, std::ptrdiff_t offsT, unsigned bitOffsetT, unsigned bitWidthT>
+using StaticBitField = BitField<T, bitOffsetT, bitWidthT, StaticOffsGetter<offsT>>;
+
+// ---------------------------------------------------------------------------------------------- //
+// [AtomicField]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Field accessed with atomic operations, with explicitly given memory orders.
+ * @tparam  T           The type of the field, trivially copyable and 1, 2, 4 or 8 bytes large.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation.
+ *
+ * Plain `Field`s compile to ordinary loads and stores, which race with threads of the target
+ * writing the same objects. Atomic fields read and write the object in place, without casting
+ * `addressOfObj()` to `std::atomic<T>*` by hand, and make the required ordering explicit instead
+ * of defaulting to sequential consistency everywhere. The implicit conversion and assignment are
+ * sequentially consistent, like those of `std::atomic`. The arithmetic and bitwise operations
+ * are only available for integral types. The object has to be aligned to its size.
+ *
+ * @code
+ *     AtomicField<uint32_t> refCount{this, 0x08};
+ *     AtomicField<bool>     ready   {this, 0x0C};
+ *
+ *     refCount.fetchAdd(1, std::memory_order_relaxed);
+ *     if (ready.load(std::memory_order_acquire)) ...
+ * @endcode
+ */
+template<typename T, typename PtrGetterT = internal::FieldBase::PtrGetter>
+class AtomicField : public internal::BasicFieldBase<PtrGetterT>
+{
+    static_assert(std::is_trivially_copyable<T>::value && !std::is_const<T>::value,
+        "atomic fields must be of non-const, trivially copyable types");
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+        "atomic fields must be 1, 2, 4 or 8 bytes large");
+
+    using Ops = internal::AtomicOps<T>;
+
+    template<typename U>
+    using EnableIfIntegral = std::enable_if_t<
+        std::is_integral<U>::value && !std::is_same<U, bool>::value>;
+
+    T* obj()
+    {
+        auto ptr = static_cast<T*>(this->rawPtr());
+        assert(reinterpret_cast<uintptr_t>(ptr) % sizeof(T) == 0);
+        return ptr;
+    }
+
+    const T* obj() const
+    {
+        auto ptr = static_cast<const T*>(this->crawPtr());
+        assert(reinterpret_cast<uintptr_t>(ptr) % sizeof(T) == 0);
+        return ptr;
+    }
+public:
+    /**
+     * @brief   Constructs an atomic field from a parent and a `PtrGetter`.
+     * @param   parent      The class wrapper that is the parent of this object.
+     * @param   ptrGetter   The function used to calculate the address of the object.
+     */
+    AtomicField(internal::WrapperBase* parent, PtrGetterT ptrGetter)
+        : internal::BasicFieldBase<PtrGetterT>{parent, ptrGetter}
+    {}
+
+    /**
+     * @brief   Copy constructor.
+     * @see     Field::Field(const Field&)
+     */
+    explicit AtomicField(const AtomicField&) = default;
+
+    /**
+     * @brief   Convenience constructs defaulting to an `OffsGetter` as `ptrGetter`.
+     * @param   parent  The class wrapper that is the parent of this object.
+     * @param   offset  The offset of the object inside of the parent, in bytes.
+     */
+    template<
+        typename GetterT = PtrGetterT,
+        typename = std::enable_if_t<std::is_constructible<GetterT, OffsGetter>::value>>
+    AtomicField(internal::WrapperBase* parent, std::ptrdiff_t offset)
+        : AtomicField{parent, PtrGetterT(OffsGetter{offset})}
+    {}
+
+    /**
+     * @brief   Convenience constructor for stateless `PtrGetter` types (e.g. `StaticOffsGetter`).
+     * @param   parent  The class wrapper that is the parent of this object.
+     */
+    template<
+        typename GetterT = PtrGetterT,
+        typename = std::enable_if_t<std::is_empty<GetterT>::value
+            && std::is_default_constructible<GetterT>::value>>
+    explicit AtomicField(internal::WrapperBase* parent)
+        : AtomicField{parent, PtrGetterT{}}
+    {}
+
+    /**
+     * @brief   Atomically reads the value.
+     * @param   order   The memory order of the load.
+     * @return  The value.
+     */
+    T load(std::memory_order order = std::memory_order_seq_cst) const
+    {
+        return Ops::load(obj(), order);
+    }
+
+    /**
+     * @brief   Atomically writes the value.
+     * @param   value   The new value.
+     * @param   order   The memory order of the store.
+     */
+    void store(T value, std::memory_order order = std::memory_order_seq_cst)
+    {
+        Ops::store(obj(), value, order);
+    }
+
+    /**
+     * @brief   Atomically replaces the value.
+     * @param   value   The new value.
+     * @param   order   The memory order of the operation.
+     * @return  The old value.
+     */
+    T exchange(T value, std::memory_order order = std::memory_order_seq_cst)
+    {
+        return Ops::exchange(obj(), value, order);
+    }
+
+    /**
+     * @brief   Atomically replaces the value if it equals an expected one (bytewise).
+     * @param   expected    The expected value, set to the actual value on failure.
+     * @param   desired     The new value.
+     * @param   success     The memory order if the value was replaced.
+     * @param   failure     The memory order of the load if it wasn't.
+     * @return  @c true if the value was replaced, else @c false.
+     */
+    bool compareExchangeStrong(T& expected, T desired,
+        std::memory_order success, std::memory_order failure)
+    {
+        return Ops::compareExchange(obj(), expected, desired, false, success, failure);
+    }
+
+    /**
+     * @copybrief compareExchangeStrong
+     * @param   expected    The expected value, set to the actual value on failure.
+     * @param   desired     The new value.
+     * @param   order       The memory order of the operation.
+     * @return  @c true if the value was replaced, else @c false.
+     */
+    bool compareExchangeStrong(T& expected, T desired,
+        std::memory_order order = std::memory_order_seq_cst)
+    {
+        return compareExchangeStrong(expected, desired, order, Ops::failureOrderOf(order));
+    }
+
+    /**
+     * @brief   Like `compareExchangeStrong`, but may fail spuriously, for use in loops.
+     * @copydetails compareExchangeStrong(T&, T, std::memory_order, std::memory_order)
+     */
+    bool compareExchangeWeak(T& expected, T desired,
+        std::memory_order success, std::memory_order failure)
+    {
+        return Ops::compareExchange(obj(), expected, desired, true, success, failure);
+    }
+
+    /**
+     * @brief   Like `compareExchangeStrong`, but may fail spuriously, for use in loops.
+     * @copydetails compareExchangeStrong(T&, T, std::memory_order)
+     */
+    bool compareExchangeWeak(T& expected, T desired,
+        std::memory_order order = std::memory_order_seq_cst)
+    {
+        return compareExchangeWeak(expected, desired, order, Ops::failureOrderOf(order));
+    }
+
+#define REMODEL_ATOMICFIELD_FETCH_OPERATION(name, op)                                              \
+    template<typename U = T, typename = EnableIfIntegral<U>>                                       \
+    T fetch##name(T value, std::memory_order order = std::memory_order_seq_cst)                    \
+    {                                                                                              \
+        return Ops::fetch##name(obj(), value, order);                                              \
+    }                                                                                              \
+                                                                                                   \
+    template<typename U = T, typename = EnableIfIntegral<U>>                                       \
+    T operator op##= (T value)                                                                     \
+    {                                                                                              \
+        return static_cast<T>(Ops::fetch##name(obj(), value, std::memory_order_seq_cst) op value); \
+    }
+
+    REMODEL_ATOMICFIELD_FETCH_OPERATION(Add, +)
+    REMODEL_ATOMICFIELD_FETCH_OPERATION(Sub, -)
+    REMODEL_ATOMICFIELD_FETCH_OPERATION(And, &)
+    REMODEL_ATOMICFIELD_FETCH_OPERATION(Or,  |)
+    REMODEL_ATOMICFIELD_FETCH_OPERATION(Xor, ^)
+
+#undef REMODEL_ATOMICFIELD_FETCH_OPERATION
+
+    template<typename U = T, typename = EnableIfIntegral<U>>
+    T operator ++ () { return static_cast<T>(fetchAdd(1) + 1); }
+
+    template<typename U = T, typename = EnableIfIntegral<U>>
+    T operator -- () { return static_cast<T>(fetchSub(1) - 1); }
+
+    template<typename U = T, typename = EnableIfIntegral<U>>
+    T operator ++ (int) { return fetchAdd(1); }
+
+    template<typename U = T, typename = EnableIfIntegral<U>>
+    T operator -- (int) { return fetchSub(1); }
+
+    /**
+     * @brief   Implicit cast to the value, loaded sequentially consistent.
+     * @return  The value.
+     */
+    operator T () const { return load(); }
+
+    /**
+     * @brief   Assignment operator storing the value sequentially consistent.
+     * @param   rhs The right hand side.
+     * @return  @c rhs.
+     */
+    T operator = (T rhs)
+    {
+        store(rhs);
+        return rhs;
+    }
+
+    /**
+     * @brief   Assignment operator simulating normal copy semantics for fields.
+     * @param   rhs The right hand side.
+     * @return  The copied value.
+     */
+    T operator = (const AtomicField& rhs)
+    {
+        return *this = rhs.load();
+    }
+
+    /**
+     * @brief   Obtains a raw pointer to the wrapped object.
+     * @return  The desired pointer.
+     */
+    T* addressOfObj() { return obj(); }
+
+    /**
+     * @brief   Obtains a constant raw pointer to the wrapped object.
+     * @return  The desired pointer.
+     */
+    const T* addressOfObj() const { return obj(); }
+
+    /**
+     * @brief   Obtains a pointer to the wrapper object.
+     * @return  `this`.
+     */
+    AtomicField* addressOfWrapper() { return this; }
+
+    /**
+     * @brief   Obtains a constant pointer to the wrapper object.
+     * @return  `this`.
+     */
+    const AtomicField* addressOfWrapper() const { return this; }
+};
+
+/**
+ * @brief   Atomic field located at a compile-time offset inside of its parent.
+ * @see     StaticField
+ */
+template<typename T, std::ptrdiff_t offsT>
+using StaticAtomicField = AtomicField<T, StaticOffsGetter<offsT>>;
+
+// ---------------------------------------------------------------------------------------------- //
+// [TrailingArray]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Field representing an array whose length is only known at runtime, e.g. given by an
+ *          earlier field.
+ * @tparam  T           The element type, required to be trivial.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation of the first element.
+ *                      
+ * The length is queried on every access, so it follows changes of the object. Fields located 
+ * behind the array can use `endOffset` with a `DynamicOffsGetter` (see there for an example).
+ */
+template<typename T, typename PtrGetterT = internal::FieldBase::PtrGetter>
+class TrailingArray : public internal::BasicFieldBase<PtrGetterT>
+{
+    static_assert(std::is_trivial<T>::value, 
+        "trailing arrays are only supported for trivial types");
+public:
+    using CountFunc = std::function<std::size_t()>;
+private:
+    CountFunc m_count;
+public:
+    /**
+     * @brief   Constructs an array from a parent, a `PtrGetter` and a length function.
+     * @param   parent      The class wrapper that is the parent of this object.
+     * @param   ptrGetter   The function used to calculate the address of the first element.
+     * @param   count       Functor returning the number of elements.
+     */
+    TrailingArray(internal::WrapperBase* parent, PtrGetterT ptrGetter, CountFunc count)
+        : internal::BasicFieldBase<PtrGetterT>{parent, ptrGetter}
+        , m_count{std::move(count)}
+    {}
+
+    /**
+     * @brief   Convenience constructs defaulting to an `OffsGetter` as `ptrGetter`.
+     * @param   parent  The class wrapper that is the parent of this object.
+     * @param   offset  The offset of the first element inside of the parent, in bytes.
+     * @param   count   Functor returning the number of elements.
+     */
+    template<
+        typename GetterT = PtrGetterT, 
+        typename = std::enable_if_t<std::is_constructible<GetterT, OffsGetter>::value>>
+    TrailingArray(internal::WrapperBase* parent, std::ptrdiff_t offset, CountFunc count)
+        : TrailingArray{parent, PtrGetterT(OffsGetter{offset}), std::move(count)}
+    {}
+
+    TrailingArray(const TrailingArray&) = delete;
+    TrailingArray& operator = (const TrailingArray&) = delete;
+
+    /**
+     * @brief   Gets the number of elements.
+     * @return  The number of elements.
+     */
+    std::size_t size() const { return m_count(); }
+
+    /**
+     * @brief   Determines whether the array is empty.
+     * @return  @c true if empty, else @c false.
+     */
+    bool empty() const { return size() == 0; }
+
+    T* data() { return static_cast<T*>(this->rawPtr()); }
+    const T* data() const { return static_cast<const T*>(this->crawPtr()); }
+    T* begin() { return data(); }
+    T* end() { return data() + size(); }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+    T& operator [] (std::size_t idx)
+    {
+        REMODEL_CHECK_INDEX(idx, size());
+        return data()[idx];
+    }
+
+    const T& operator [] (std::size_t idx) const
+    {
+        REMODEL_CHECK_INDEX(idx, size());
+        return data()[idx];
+    }
+
+    /**
+     * @brief   Gets the offset of the first byte behind the array inside of the parent.
+     * @return  The offset, in bytes.
+     */
+    std::ptrdiff_t endOffset() const
+    {
+        return reinterpret_cast<const uint8_t*>(end()) 
+            - static_cast<const uint8_t*>(this->rawOf(this->parent()));
+    }
+
+    /**
+     * @brief   Obtains a pointer to the wrapper object.
+     * @return  `this`.
+     */
+    TrailingArray* addressOfWrapper() { return this; }
+
+    /**
+     * @brief   Obtains a constant pointer to the wrapper object.
+     * @return  `this`.
+     */
+    const TrailingArray* addressOfWrapper() const { return this; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ClassView]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Base class for lightweight class views.
+ *          
+ * Other than `ClassWrapper`s, views don't hold any field objects. Fields are declared using the
+ * `REMODEL_VIEW_FIELD` macro and resolved on demand, relative to the raw pointer, whenever they
+ * are accessed. A view thus consists of nothing but the raw pointer, making `wrapper_cast` and
+ * copies of views exactly as cheap as copying a pointer, independent of the number of fields.
+ * 
+ * @code
+ *     class DogView : public ClassView
+ *     {
+ *         REMODEL_VIEW(DogView)
+ *     public:
+ *         REMODEL_VIEW_FIELD(uint8_t,       age,  124)
+ *         REMODEL_VIEW_FIELD(CustomString*, race, 12)
+ *     };
+ *     
+ *     auto dog = wrapper_cast<DogView>(dogInstanceLocation);
+ *     ++dog.age();
+ *     const char* race = dog.race()->toStrong().str();
+ * @endcode
+ */
+class ClassView
+{
+protected:
+    void* m_raw = nullptr;
+
+    /**
+     * @internal
+     * @brief   Constructor.
+     * @param   raw The raw pointer of the wrapped object.
+     */
+    explicit ClassView(void* raw)
+        : m_raw{raw}
+    {}
+public:
+    /**
+     * @brief   Obtains a raw pointer to the wrapped object.
+     * @return  The desired pointer.
+     */
+    void* addressOfObj() { return m_raw; }
+
+    /**
+     * @brief   Obtains a const raw pointer to the wrapped object.
+     * @copydetails addressOfObj
+     */
+    const void* addressOfObj() const { return m_raw; }
+
+    /**
+     * @brief   Re-points the view to another object.
+     * @param   raw The raw pointer of the new wrapped object.
+     */
+    void rebind(void* raw) { m_raw = raw; }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Resolves fields of class views.
+ * @tparam  T       The type of the field.
+ * @tparam  offsT   The offset of the field inside of the wrapped class, in bytes.
+ */
+template<typename T, std::ptrdiff_t offsT>
+struct ViewFieldAccess
+{
+    using RewrittenT = RewriteWrappers<std::remove_reference_t<T>>;
+    static const bool kDoExtraDref = std::is_reference<T>::value;
+
+    /**
+     * @brief   Obtains a reference to the field of the object at @c raw.
+     * @param   raw The raw pointer of the wrapped object.
+     * @return  The reference to the field.
+     */
+    static RewrittenT& get(void* raw)
+    {
+        void* ptr = reinterpret_cast<uint8_t*>(raw) + offsT;
+        return *static_cast<RewrittenT*>(
+            kDoExtraDref ? *reinterpret_cast<RewrittenT**>(ptr) : ptr
+            );
+    }
+
+    /**
+     * @copydoc get
+     */
+    static const RewrittenT& cget(const void* raw)
+    {
+        return get(const_cast<void*>(raw));
+    }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Macro forwarding constructors and implementing other view logic required.
+ * @param   classname   The class name of the view.
+ * @see     ClassView
+ */
+#define REMODEL_VIEW(classname)                                                                    \
+    protected:                                                                                     \
+        template<typename WrapperT>                                                                \
+        friend WrapperT remodel::wrapper_cast(void *raw);                                          \
+        explicit classname(void* raw)                                                              \
+            : ClassView(raw) /* MSVC12 requires parentheses here */ {}                             \
+    public:                                                                                        \
+        /* allow field access via -> (required to allow -> on wrapped struct fields) */            \
+        classname* operator -> () { return this; }                                                 \
+        classname* addressOfWrapper() { return this; }                                             \
+        const classname* addressOfWrapper() const { return this; }                                 \
+    private:
+
+/**
+ * @brief   Declares accessor functions resolving a field of a view on demand.
+ * @param   type    The type of the field.
+ * @param   name    The name of the accessor functions.
+ * @param   offs    The offset of the field inside of the wrapped class, in bytes.
+ * @see     ClassView
+ */
+#define REMODEL_VIEW_FIELD(type, name, offs)                                                       \
+    remodel::internal::ViewFieldAccess<type, offs>::RewrittenT& name()                             \
+        { return remodel::internal::ViewFieldAccess<type, offs>::get(this->m_raw); }               \
+    const remodel::internal::ViewFieldAccess<type, offs>::RewrittenT& name() const                 \
+        { return remodel::internal::ViewFieldAccess<type, offs>::cget(this->m_raw); }
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Creates views on objects embedded into other objects.
+ * @tparam  ViewT   The view type of the embedded object.
+ * @tparam  offsT   The offset of the embedded object inside of the outer one, in bytes.
+ */
+template<typename ViewT, std::ptrdiff_t offsT>
+struct NestedViewAccess
+{
+    static_assert(std::is_base_of<ClassView, ViewT>::value,
+        "nested views must be derived from ClassView");
+
+    /**
+     * @brief   Creates a view on the embedded object of the object at @c raw.
+     * @param   raw The raw pointer of the outer object.
+     * @return  The view.
+     */
+    static ViewT get(const void* raw)
+    {
+        return wrapper_cast<ViewT>(
+            const_cast<uint8_t*>(static_cast<const uint8_t*>(raw)) + offsT);
+    }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Declares an accessor function returning a view on an object embedded by value.
+ * @param   type    The `ClassView` type of the embedded object.
+ * @param   name    The name of the accessor function.
+ * @param   offs    The offset of the embedded object inside of the wrapped class, in bytes.
+ *
+ * Usable in views and wrappers alike. As views consist of nothing but the raw pointer and their
+ * fields are resolved relative to it using constant offsets, the offsets of nested accesses fold
+ * at compile time: `dog.collar().tag()` compiles to a single load from
+ * `raw + (collarOffs + tagOffs)` without creating any intermediate wrapper.
+ *
+ * @code
+ *     class CollarView : public ClassView
+ *     {
+ *         REMODEL_VIEW(CollarView)
+ *     public:
+ *         REMODEL_VIEW_FIELD(uint32_t, tag, 8)
+ *     };
+ *
+ *     class DogView : public ClassView
+ *     {
+ *         REMODEL_VIEW(DogView)
+ *     public:
+ *         REMODEL_VIEW_NESTED(CollarView, collar, 0x40)
+ *     };
+ * @endcode
+ */
+#define REMODEL_VIEW_NESTED(type, name, offs)                                                      \
+    type name() const                                                                              \
+        { return remodel::internal::NestedViewAccess<type, offs>::get(this->addressOfObj()); }
+
+// Verify assumptions about this class.
+static_assert(std::is_trivially_copyable<ClassView>::value, "internal library error");
+static_assert(sizeof(void*) == sizeof(ClassView), "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [Layout] + [REMODEL_FIELDS]                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Describes a field of a layout declared with `REMODEL_FIELDS` at runtime.
+ */
+struct FieldInfo
+{
+    /// The name of the field.
+    const char* name;
+    /// The offset of the field inside of the wrapped class, in bytes.
+    std::ptrdiff_t offset;
+    /// The size of the field, in bytes.
+    std::size_t size;
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Compile-time description of a field of a layout.
+ * @tparam  T       The type of the field.
+ * @tparam  offsT   The offset of the field inside of the wrapped class, in bytes.
+ */
+template<typename T, std::ptrdiff_t offsT>
+struct LayoutEntry
+{
+    static_assert(offsT >= 0, "fields must not have negative offsets");
+
+    using Type = T;
+    using Access = ViewFieldAccess<T, offsT>;
+    static const std::ptrdiff_t kOffset = offsT;
+    // References are implemented as pointers.
+    static const std::size_t kSize = std::is_reference<T>::value 
+        ? sizeof(void*) : sizeof(typename Access::RewrittenT);
+    static const std::size_t kEnd = static_cast<std::size_t>(offsT) + kSize;
+
+    /**
+     * @brief   Gets the index of the first line (of the wrapped object) covered by the field.
+     * @tparam  lineSizeT   The size of the lines, in bytes.
+     */
+    template<std::size_t lineSizeT = simd::kCacheLineSize>
+    static constexpr std::size_t firstLine() { return static_cast<std::size_t>(offsT) / lineSizeT; }
+
+    /**
+     * @brief   Gets the index of the last line (of the wrapped object) covered by the field.
+     * @tparam  lineSizeT   The size of the lines, in bytes.
+     */
+    template<std::size_t lineSizeT = simd::kCacheLineSize>
+    static constexpr std::size_t lastLine() { return (kSize ? kEnd - 1 : kEnd) / lineSizeT; }
+
+    /**
+     * @brief   Determines whether the field crosses a line boundary.
+     * @tparam  lineSizeT   The size of the lines, in bytes.
+     */
+    template<std::size_t lineSizeT = simd::kCacheLineSize>
+    static constexpr bool crossesLine() { return firstLine<lineSizeT>() != lastLine<lineSizeT>(); }
+};
+
+/**
+ * @internal
+ * @brief   Determines whether two layout entries share any bytes.
+ * @tparam  LhsT    The first entry.
+ * @tparam  RhsT    The second entry.
+ */
+template<typename LhsT, typename RhsT>
+struct EntriesOverlap : std::integral_constant<bool, 
+    static_cast<std::size_t>(LhsT::kOffset) < RhsT::kEnd 
+    && static_cast<std::size_t>(RhsT::kOffset) < LhsT::kEnd> 
+{};
+
+/**
+ * @internal
+ * @brief   Determines whether a layout entry overlaps with any of the other entries.
+ * @tparam  EntryT  The entry.
+ * @tparam  OthersT The other entries.
+ */
+template<typename EntryT, typename... OthersT>
+struct OverlapsAny : std::false_type {};
+
+/**
+ * @internal
+ * @copydoc OverlapsAny
+ */
+template<typename EntryT, typename FirstT, typename... OthersT>
+struct OverlapsAny<EntryT, FirstT, OthersT...> : std::integral_constant<bool, 
+    EntriesOverlap<EntryT, FirstT>::value || OverlapsAny<EntryT, OthersT...>::value> 
+{};
+
+} // namespace internal
+
+/**
+ * @brief   Compile-time table of the fields of a class, as declared with `REMODEL_FIELDS`.
+ * @tparam  EntriesT    The entries, one per field, in declaration order.
+ *
+ * Exposes the extent of the fields and whether any of them overlap as constants, so layouts can
+ * be validated by `static_assert`s. `At<idx>` gives the entry of a field, providing its `Type`, 
+ * `kOffset` and `kSize` as well as the cache lines it covers:
+ * @code
+ *     static_assert(Dog::Layout::At<0>::lastLine() == 0, "race is on the first line");
+ *     static_assert(Dog::Layout::numCrossingFields() == 0, "no field crosses a cache line");
+ * @endcode
+ */
+template<typename... EntriesT>
+struct Layout
+{
+    static const std::size_t kNumFields = 0;
+    static const std::size_t kEnd = 0;
+    static const bool kHasOverlap = false;
+
+    template<std::size_t lineSizeT = simd::kCacheLineSize>
+    static constexpr std::size_t numCrossingFields() { return 0; }
+};
+
+/**
+ * @copydoc Layout
+ */
+template<typename FirstT, typename... RestT>
+struct Layout<FirstT, RestT...>
+{
+    /// The number of fields.
+    static const std::size_t kNumFields = 1 + sizeof...(RestT);
+    /// The offset of the first byte behind all fields.
+    static const std::size_t kEnd = FirstT::kEnd > Layout<RestT...>::kEnd 
+        ? FirstT::kEnd : Layout<RestT...>::kEnd;
+    /// Whether any fields share bytes.
+    static const bool kHasOverlap = internal::OverlapsAny<FirstT, RestT...>::value 
+        || Layout<RestT...>::kHasOverlap;
+
+    /// The entry of the field at an index.
+    template<std::size_t idxT>
+    using At = typename std::tuple_element<idxT, std::tuple<FirstT, RestT...>>::type;
+
+    /**
+     * @brief   Counts the fields crossing line boundaries, see `CacheLineReport` for details.
+     * @tparam  lineSizeT   The size of the lines, in bytes.
+     */
+    template<std::size_t lineSizeT = simd::kCacheLineSize>
+    static constexpr std::size_t numCrossingFields()
+    {
+        return (FirstT::template crossesLine<lineSizeT>() ? 1 : 0)
+            + Layout<RestT...>::template numCrossingFields<lineSizeT>();
+    }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Strips the placeholder preceding the entries generated by `REMODEL_FIELDS`.
+ * @tparam  PlaceholderT    The placeholder, `void`.
+ * @tparam  EntriesT        The entries.
+ */
+template<typename PlaceholderT, typename... EntriesT>
+struct MakeLayout
+{
+    using Type = Layout<EntriesT...>;
+};
+
+/**
+ * @internal
+ * @brief   Determines whether a layout fits into a class. Classes of unknown size always fit.
+ * @tparam  LayoutT The layout.
+ * @tparam  ClassT  The class.
+ */
+template<typename LayoutT, typename ClassT, typename = void>
+struct LayoutFits : std::true_type {};
+
+/**
+ * @internal
+ * @brief   Advanced wrappers know the size of the wrapped class.
+ * @copydetails LayoutFits
+ */
+template<typename LayoutT, typename ClassT>
+struct LayoutFits<LayoutT, ClassT, typename ClassT::IsAdvWrapper /* manual SFINAE */> 
+    : std::integral_constant<bool, LayoutT::kEnd <= ClassT::kObjSize>
+{};
+
+// Preprocessor helpers used by `REMODEL_FIELDS`. `REMODEL_PP_EXPAND` forces another rescan, as
+// MSVC's traditional preprocessor otherwise passes `__VA_ARGS__` on as a single argument.
+#define REMODEL_PP_EXPAND(x) x
+#define REMODEL_PP_CAT_IMPL(a, b) a##b
+#define REMODEL_PP_CAT(a, b) REMODEL_PP_CAT_IMPL(a, b)
+#define REMODEL_PP_NARGS(...)                                                                      \
+    REMODEL_PP_EXPAND(REMODEL_PP_NARGS_IMPL(__VA_ARGS__,                                           \
+        32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,                            \
+        16, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1))
+#define REMODEL_PP_NARGS_IMPL(                                                                     \
+        _1,  _2,  _3,  _4,  _5,  _6,  _7,  _8,  _9, _10, _11, _12, _13, _14, _15, _16,             \
+        _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, n, ...) n
+#define REMODEL_PP_EACH_1(m, x) m(x)
+#define REMODEL_PP_EACH_2(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_1(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_3(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_2(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_4(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_3(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_5(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_4(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_6(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_5(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_7(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_6(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_8(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_7(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_9(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_8(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_10(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_9(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_11(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_10(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_12(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_11(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_13(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_12(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_14(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_13(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_15(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_14(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_16(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_15(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_17(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_16(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_18(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_17(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_19(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_18(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_20(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_19(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_21(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_20(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_22(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_21(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_23(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_22(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_24(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_23(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_25(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_24(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_26(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_25(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_27(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_26(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_28(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_27(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_29(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_28(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_30(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_29(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_31(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_30(m, __VA_ARGS__))
+#define REMODEL_PP_EACH_32(m, x, ...) m(x) REMODEL_PP_EXPAND(REMODEL_PP_EACH_31(m, __VA_ARGS__))
+#define REMODEL_PP_FOR_EACH(m, ...)                                                                \
+    REMODEL_PP_EXPAND(REMODEL_PP_CAT(REMODEL_PP_EACH_, REMODEL_PP_NARGS(__VA_ARGS__))(             \
+        m, __VA_ARGS__))
+
+} // namespace internal
+
+#define REMODEL_FIELDS_ENTRY_IMPL(name, type, offs)                                                \
+    , remodel::internal::LayoutEntry<type, offs>
+#define REMODEL_FIELDS_ENTRY(field) REMODEL_PP_EXPAND(REMODEL_FIELDS_ENTRY_IMPL field)
+
+#define REMODEL_FIELDS_INFO_IMPL(name, type, offs)                                                 \
+    {#name, offs, remodel::internal::LayoutEntry<type, offs>::kSize},
+#define REMODEL_FIELDS_INFO(field) REMODEL_PP_EXPAND(REMODEL_FIELDS_INFO_IMPL field)
+
+#define REMODEL_FIELDS_ACCESSOR_IMPL(name, type, offs)                                             \
+    remodel::internal::ViewFieldAccess<type, offs>::RewrittenT& name()                             \
+        { return remodel::internal::ViewFieldAccess<type, offs>::get(this->addressOfObj()); }      \
+    const remodel::internal::ViewFieldAccess<type, offs>::RewrittenT& name() const                 \
+        { return remodel::internal::ViewFieldAccess<type, offs>::cget(this->addressOfObj()); }
+#define REMODEL_FIELDS_ACCESSOR(field) REMODEL_PP_EXPAND(REMODEL_FIELDS_ACCESSOR_IMPL field)
+
+/**
+ * @brief   Declares the fields of a class view or wrapper in a single layout table.
+ * @param   ...     Up to 32 fields, each given as `(name, type, offset)`. Types containing 
+ *                  commas have to be aliased first.
+ *
+ * Generates accessor functions like `REMODEL_VIEW_FIELD`, which resolve the fields relative to 
+ * the raw pointer and take no storage at all. The layout is also collected into a compile-time
+ * table, published as `Layout` (see `remodel::Layout`), and into a runtime table of `FieldInfo`s 
+ * returned by `fieldInfos()`. The declaration is validated while compiling: overlapping fields 
+ * and, for `AdvancedClassWrapper`s, fields exceeding `kObjSize` are rejected.
+ *
+ * @code
+ *     class Dog : public AdvancedClassWrapper<128>
+ *     {
+ *         REMODEL_ADV_WRAPPER(Dog)
+ *     public:
+ *         REMODEL_FIELDS(
+ *             (race, CustomString*, 12),
+ *             (age,  uint8_t,       124)
+ *         )
+ *     };
+ *
+ *     static_assert(Dog::Layout::At<1>::kOffset == 124, "");
+ *     ++dog.age();
+ * @endcode
+ */
+#define REMODEL_FIELDS(...)                                                                        \
+    public:                                                                                        \
+        using Layout = remodel::internal::MakeLayout<                                              \
+            void REMODEL_PP_FOR_EACH(REMODEL_FIELDS_ENTRY, __VA_ARGS__)>::Type;                    \
+        static const remodel::FieldInfo* fieldInfos()                                              \
+        {                                                                                          \
+            static const remodel::FieldInfo infos[] = {                                            \
+                REMODEL_PP_FOR_EACH(REMODEL_FIELDS_INFO, __VA_ARGS__)                              \
+            };                                                                                     \
+            return infos;                                                                          \
+        }                                                                                          \
+        REMODEL_PP_FOR_EACH(REMODEL_FIELDS_ACCESSOR, __VA_ARGS__)                                  \
+    private:                                                                                       \
+        /* member function bodies see the complete class, so the class can validate itself */     \
+        void remodelValidateLayout() const                                                         \
+        {                                                                                          \
+            using Self = std::remove_cv_t<std::remove_reference_t<decltype(*this)>>;               \
+            static_assert(!Layout::kHasOverlap, "fields of the layout overlap");                   \
+            static_assert(remodel::internal::LayoutFits<Layout, Self>::value,                      \
+                "fields of the layout exceed the size of the object");                             \
+        }                                                                                          \
+    private:
+
+// ---------------------------------------------------------------------------------------------- //
+// [forEachField]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Calls a visitor for the fields of a layout, starting at an index.
+ * @tparam  LayoutT The layout.
+ * @tparam  idxT    The index of the field to visit.
+ * @tparam  countT  The number of fields of the layout.
+ *
+ * Instantiated recursively, so the calls are unrolled at compile time.
+ */
+template<typename LayoutT, std::size_t idxT, std::size_t countT>
+struct VisitFields
+{
+    template<typename VisitorT>
+    static void run(void* raw, const FieldInfo* infos, VisitorT& visitor)
+    {
+        visitor(infos[idxT], LayoutT::template At<idxT>::Access::get(raw));
+        VisitFields<LayoutT, idxT + 1, countT>::run(raw, infos, visitor);
+    }
+
+    template<typename VisitorT>
+    static void run(const void* raw, const FieldInfo* infos, VisitorT& visitor)
+    {
+        visitor(infos[idxT], LayoutT::template At<idxT>::Access::cget(raw));
+        VisitFields<LayoutT, idxT + 1, countT>::run(raw, infos, visitor);
+    }
+};
+
+/**
+ * @internal
+ * @brief   End of the recursion.
+ * @copydetails VisitFields
+ */
+template<typename LayoutT, std::size_t countT>
+struct VisitFields<LayoutT, countT, countT>
+{
+    template<typename RawT, typename VisitorT>
+    static void run(RawT*, const FieldInfo*, VisitorT&) {}
+};
+
+} // namespace internal
+
+/**
+ * @brief   Calls a visitor for every field of a wrapper declared with `REMODEL_FIELDS`.
+ * @param   wrapper The wrapper or view.
+ * @param   visitor Functor called as `visitor(const FieldInfo& info, T& value)` for every field,
+ *                  in declaration order. `T` is the type of the field, so visitors are usually
+ *                  generic lambdas or classes with overloaded call operators.
+ *
+ * The field list is known at compile time, so the calls are unrolled and typically inlined,
+ * which makes this suitable for generic serializers, hashers or differs.
+ *
+ * @code
+ *     forEachField(dog, [&](const FieldInfo& info, const auto& value) {
+ *         out << info.name << " @ " << info.offset << " = " << value << '\n';
+ *     });
+ * @endcode
+ */
+template<typename WrapperT, typename VisitorT>
+inline void forEachField(WrapperT& wrapper, VisitorT&& visitor)
+{
+    using LayoutT = typename std::remove_const_t<WrapperT>::Layout;
+    internal::VisitFields<LayoutT, 0, LayoutT::kNumFields>::run(
+        wrapper.addressOfObj(), std::remove_const_t<WrapperT>::fieldInfos(), visitor);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [prefetch]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Prefetches the cache lines of a field.
+ * @param   field   The field.
+ */
+template<typename FieldT>
+inline void prefetchField(const FieldT& field)
+{
+    const auto obj = field.addressOfObj();
+    simd::prefetchRange(obj, sizeof(*obj));
+}
+
+} // namespace internal
+
+/**
+ * @brief   Issues software prefetches for the cache lines of fields of a wrapper.
+ * @param   wrapper The wrapper.
+ * @param   fields  Pointers to the fields to prefetch, e.g. `&Dog::age`.
+ *
+ * The field addresses are resolved right away, only the loads of the data are left to the
+ * hardware, so this pays off when there's work to overlap them with, e.g. the current element
+ * while iterating:
+ * @code
+ *     for (std::size_t i = 0; i < dogs.size(); ++i)
+ *     {
+ *         if (i + 1 < dogs.size()) prefetch(dogs[i + 1], &Dog::age, &Dog::name);
+ *         feed(dogs[i]);
+ *     }
+ * @endcode
+ *
+ * For objects in another address space, see the `ReadBatch` overload in `Memory.hpp`.
+ */
+template<typename WrapperT, typename... FieldPtrsT>
+inline void prefetch(const WrapperT& wrapper, FieldPtrsT... fields)
+{
+    using Expand = int[];
+    (void)Expand{0, (internal::prefetchField(wrapper.*fields), 0)...};
+}
+
+/**
+ * @brief   Issues software prefetches for all cache lines of the object of a wrapper.
+ * @param   wrapper The wrapper, of a type with known object size (`AdvancedClassWrapper`).
+ */
+template<typename WrapperT>
+inline void prefetch(const WrapperT& wrapper)
+{
+    simd::prefetchRange(wrapper.addressOfObj(), WrapperT::kObjSize);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [load]                                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines how `load` copies the value of a field.
+ * @tparam  FieldT  The field type.
+ *
+ * Values are read through the conversion operator of the field, so access policies, bit fields
+ * and atomics apply as usual.
+ */
+template<typename FieldT>
+struct LoadTraits
+{
+    using ObjT = std::remove_cv_t<
+        std::remove_pointer_t<decltype(std::declval<const FieldT&>().addressOfObj())>>;
+    static_assert(!std::is_base_of<WrapperBase, ObjT>::value,
+        "load copies plain values, fields of wrapper types can't be loaded");
+
+    using Type = ObjT;
+
+    static Type load(const FieldT& field) { return static_cast<Type>(field); }
+};
+
+/**
+ * @internal
+ * @brief   Arrays are copied into `std::array`s.
+ * @copydetails LoadTraits
+ */
+template<typename FieldT>
+struct LoadArrayTraits
+{
+    using ObjT = std::remove_pointer_t<decltype(std::declval<const FieldT&>().addressOfObj())>;
+    using Type = std::array<std::remove_cv_t<std::remove_extent_t<ObjT>>, std::extent<ObjT>::value>;
+
+    static Type load(const FieldT& field)
+    {
+        Type value;
+        std::memcpy(value.data(), field.addressOfObj(), sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Values in foreign byte order are converted to native values.
+ * @copydetails LoadTraits
+ */
+template<typename FieldT>
+struct LoadEndianTraits
+{
+    using ObjT = std::remove_pointer_t<decltype(std::declval<const FieldT&>().addressOfObj())>;
+    using Type = typename ObjT::ValueType;
+
+    static Type load(const FieldT& field) { return field.get(); }
+};
+
+/**
+ * @internal
+ * @brief   Selects the `LoadTraits` of a field.
+ * @tparam  FieldT  The field type.
+ */
+template<typename FieldT, typename ObjT = std::remove_cv_t<
+    std::remove_pointer_t<decltype(std::declval<const FieldT&>().addressOfObj())>>>
+using LoadTraitsOf = std::conditional_t<
+    std::is_array<ObjT>::value,
+    LoadArrayTraits<FieldT>,
+    std::conditional_t<IsEndianValue<ObjT>::value, LoadEndianTraits<FieldT>, LoadTraits<FieldT>>>;
+
+/**
+ * @internal
+ * @brief   The type of a field of a wrapper, given a pointer to the field.
+ */
+template<typename WrapperT, typename FieldPtrT>
+using FieldOf = std::remove_reference_t<
+    decltype(std::declval<const WrapperT&>().*std::declval<FieldPtrT>())>;
+
+} // namespace internal
+
+/**
+ * @brief   The result of `load`, a tuple of the values of the loaded fields.
+ * @tparam  WrapperT    The wrapper type.
+ * @tparam  FieldPtrsT  The types of the pointers to the fields.
+ */
+template<typename WrapperT, typename... FieldPtrsT>
+using LoadResult = std::tuple<
+    typename internal::LoadTraitsOf<internal::FieldOf<WrapperT, FieldPtrsT>>::Type...>;
+
+/**
+ * @brief   Copies the values of multiple fields of a wrapper into a tuple.
+ * @param   wrapper The wrapper.
+ * @param   fields  Pointers to the fields to load, e.g. `&Cat::age`.
+ * @return  The values, in the order of @c fields. Arrays are returned as `std::array`s and
+ *          values in foreign byte order (`BigEndian`, `LittleEndian`) are converted.
+ *
+ * Fields are read in the listed order, so listing them by offset reads the object front to back.
+ * Code working with several fields at once can thus work on plain local values:
+ * @code
+ *     auto [age, gender, fleas] = load(cat, &Cat::age, &Cat::gender, &Cat::fleas); // C++17
+ *     std::tie(age, gender, fleas) = load(cat, &Cat::age, &Cat::gender, &Cat::fleas);
+ * @endcode
+ *
+ * For objects in another address space, see the `MemoryBackend` overload in `Memory.hpp`,
+ * which reads all fields with a single coalesced read.
+ */
+template<typename WrapperT, typename... FieldPtrsT>
+inline LoadResult<WrapperT, FieldPtrsT...> load(const WrapperT& wrapper, FieldPtrsT... fields)
+{
+    // Braced initialization guarantees left to right evaluation.
+    return LoadResult<WrapperT, FieldPtrsT...>{
+        internal::LoadTraitsOf<internal::FieldOf<WrapperT, FieldPtrsT>>::load(wrapper.*fields)...};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [OptionalView] + [tryGet]                                                                      //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `zycore::Optional` returned by `tryGet`, chaining further reads with `then`.
+ * @tparam  T   The type of the value, a wrapper for followed pointers to wrappers.
+ *
+ * Navigates chains of untrusted pointers without nesting checks:
+ * @code
+ *     auto age = dog.tryGet(&Dog::owner).then(&Person::pet).then(&Dog::age);
+ *     if (age.hasValue()) feed(age.value());
+ * @endcode
+ *
+ * Pointers are checked for being null or pointing into the first 64 KiB of the address space,
+ * which never is mapped and is where pointers read through a null pointer plus an offset end
+ * up, in a single comparison marked likely to pass. The pointees aren't probed, use `SafeField`
+ * for pointers that may be dangling. Every step is inlined, so a chain compiles to a series of
+ * loads, each followed by one rarely taken branch.
+ */
+template<typename T>
+class OptionalView : public zycore::Optional<T>
+{
+public:
+    using zycore::Optional<T>::Optional;
+
+    /**
+     * @brief   Reads a field of the wrapper held, if any.
+     * @param   field   Pointer to the field, e.g. `&Dog::owner`.
+     * @return  The result of `tryGet` on the wrapper, or nothing if this is empty.
+     */
+    template<typename FieldPtrT>
+    auto then(FieldPtrT field) const
+    {
+        using Result = decltype(this->value().tryGet(field));
+        if (REMODEL_LIKELY(this->hasValue())) return this->value().tryGet(field);
+        return Result{zycore::kEmpty};
+    }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines whether a pointer may be followed, see `OptionalView`.
+ * @param   ptr The pointer.
+ * @return  @c true if neither null nor pointing into the first 64 KiB, else @c false.
+ */
+template<typename PtrT>
+inline bool isPlausiblePointer(PtrT ptr)
+{
+    return reinterpret_cast<uintptr_t>(ptr) >= 0x10000;
+}
+
+/**
+ * @internal
+ * @brief   Follows pointers for `tryGet`, plain pointers are returned as they are.
+ * @tparam  PtrT    The pointer type.
+ */
+template<typename PtrT, typename>
+struct TryFollow
+{
+    static OptionalView<PtrT> follow(PtrT ptr)
+    {
+        if (REMODEL_LIKELY(isPlausiblePointer(ptr))) return {zycore::kInPlace, ptr};
+        return zycore::kEmpty;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Pointers to wrappers are returned as strong wrappers.
+ * @copydetails TryFollow
+ */
+template<typename WrapperT>
+struct TryFollow<WeakWrapper<WrapperT>*>
+{
+    static OptionalView<WrapperT> follow(WeakWrapper<WrapperT>* ptr)
+    {
+        if (REMODEL_LIKELY(isPlausiblePointer(ptr)))
+        {
+            return {zycore::kInPlace, wrapper_cast<WrapperT>(ptr)};
+        }
+        return zycore::kEmpty;
+    }
+};
+
+/**
+ * @internal
+ * @copydoc TryFollow<WeakWrapper<WrapperT>*>
+ */
+template<typename WrapperT>
+struct TryFollow<const WeakWrapper<WrapperT>*>
+{
+    static OptionalView<WrapperT> follow(const WeakWrapper<WrapperT>* ptr)
+    {
+        return TryFollow<WeakWrapper<WrapperT>*>::follow(const_cast<WeakWrapper<WrapperT>*>(ptr));
+    }
+};
+
+/**
+ * @internal
+ * @brief   Reads a field for `WrapperBase::tryGet`, fields other than pointers are loaded.
+ * @tparam  FieldT  The field type.
+ */
+template<typename FieldT, typename>
+struct TryGetTraits
+{
+    static OptionalView<typename LoadTraitsOf<FieldT>::Type> get(const FieldT& field)
+    {
+        return {zycore::kInPlace, LoadTraitsOf<FieldT>::load(field)};
+    }
+};
+
+/**
+ * @internal
+ * @brief   Pointer fields are followed.
+ * @copydetails TryGetTraits
+ */
+template<typename FieldT>
+struct TryGetTraits<FieldT, std::conditional_t<
+    true, void, decltype(std::declval<const FieldT&>().tryGet())>>
+{
+    static auto get(const FieldT& field) { return field.tryGet(); }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [FieldSpan]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Strided view on one field of an array of objects.
+ * @tparam  T   The type of the field.
+ *              
+ * Allows random access to the same field of many equally spaced objects without creating any
+ * wrappers, e.g. for processing a single attribute of a huge foreign array in columnar form.
+ * 
+ * @code
+ *     WrapperRange<Dog> dogs{dogArray, dogCount};
+ *     auto ages = makeFieldSpan(dogs, &Dog::age); // `age` being a `StaticField`
+ *     std::vector<uint8_t> ageColumn;
+ *     ages.copyTo(ageColumn);
+ * @endcode
+ */
+template<typename T>
+class FieldSpan
+{
+    static_assert(!std::is_reference<T>::value, "field spans of references are not supported");
+public:
+    /**
+     * @brief   Random access iterator type of the span.
+     */
+    class Iterator
+    {
+        zycore::CloneConst<T, uint8_t>* m_cur;
+        std::size_t m_stride;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::remove_cv_t<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        /**
+         * @brief   Constructor.
+         * @param   cur     Pointer to the current field.
+         * @param   stride  The distance between two fields, in bytes.
+         */
+        Iterator(zycore::CloneConst<T, uint8_t>* cur, std::size_t stride)
+            : m_cur{cur}
+            , m_stride{stride}
+        {}
+
+        T& operator * () const { return *reinterpret_cast<T*>(m_cur); }
+        T* operator -> () const { return reinterpret_cast<T*>(m_cur); }
+        T& operator [] (difference_type n) const { return *(*this + n); }
+
+        Iterator& operator ++ () { m_cur += m_stride; return *this; }
+        Iterator& operator -- () { m_cur -= m_stride; return *this; }
+        Iterator operator ++ (int) { Iterator tmp{*this}; ++*this; return tmp; }
+        Iterator operator -- (int) { Iterator tmp{*this}; --*this; return tmp; }
+
+        Iterator& operator += (difference_type n) 
+        { 
+            m_cur += n * static_cast<difference_type>(m_stride); 
+            return *this; 
+        }
+
+        Iterator& operator -= (difference_type n) { return *this += -n; }
+        Iterator operator + (difference_type n) const { Iterator tmp{*this}; return tmp += n; }
+        Iterator operator - (difference_type n) const { Iterator tmp{*this}; return tmp -= n; }
+        friend Iterator operator + (difference_type n, const Iterator& it) { return it + n; }
+
+        difference_type operator - (const Iterator& rhs) const
+        {
+            return (m_cur - rhs.m_cur) / static_cast<difference_type>(m_stride);
+        }
+
+        bool operator == (const Iterator& rhs) const { return m_cur == rhs.m_cur; }
+        bool operator != (const Iterator& rhs) const { return m_cur != rhs.m_cur; }
+        bool operator <  (const Iterator& rhs) const { return m_cur <  rhs.m_cur; }
+        bool operator >  (const Iterator& rhs) const { return m_cur >  rhs.m_cur; }
+        bool operator <= (const Iterator& rhs) const { return m_cur <= rhs.m_cur; }
+        bool operator >= (const Iterator& rhs) const { return m_cur >= rhs.m_cur; }
+    };
+private:
+    zycore::CloneConst<T, uint8_t>* m_first;
+    std::size_t m_count;
+    std::size_t m_stride;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   firstObj    The raw pointer of the first object.
+     * @param   offset      The offset of the field inside of the objects, in bytes.
+     * @param   count       The number of objects.
+     * @param   stride      The distance between two objects, in bytes.
+     */
+    FieldSpan(zycore::CloneConst<T, void>* firstObj, std::ptrdiff_t offset, 
+            std::size_t count, std::size_t stride)
+        : m_first{static_cast<zycore::CloneConst<T, uint8_t>*>(firstObj) + offset}
+        , m_count{count}
+        , m_stride{stride}
+    {}
+
+    Iterator begin() const { return {m_first, m_stride}; }
+    Iterator end() const { return {m_first + m_count * m_stride, m_stride}; }
+
+    /**
+     * @brief   Gets the number of fields in the span.
+     * @return  The number of fields.
+     */
+    std::size_t size() const { return m_count; }
+
+    /**
+     * @brief   Gets the distance between two fields in the span.
+     * @return  The distance, in bytes.
+     */
+    std::size_t stride() const { return m_stride; }
+
+    /**
+     * @brief   Accesses a field in the span.
+     * @param   idx The index of the object.
+     * @return  A reference to the field.
+     */
+    T& operator [] (std::size_t idx) const 
+    { 
+        REMODEL_CHECK_INDEX(idx, m_count);
+        return *reinterpret_cast<T*>(m_first + idx * m_stride); 
+    }
+
+    /**
+     * @brief   Copies all fields in the span to a contiguous buffer.
+     * @param   out The buffer to write the values to, at least `size()` elements.
+     * @see     simd::gatherStrided
+     */
+    void gather(std::remove_cv_t<T>* out) const
+    {
+        simd::gatherStrided(out, m_first, m_stride, m_count);
+    }
+
+    /**
+     * @brief   Writes values from a contiguous buffer to all fields in the span.
+     * @param   in  The values to write, at least `size()` elements.
+     * @see     simd::scatterStrided
+     */
+    void scatter(const std::remove_cv_t<T>* in) const
+    {
+        static_assert(!std::is_const<T>::value, "cannot write to a span of constant fields");
+        simd::scatterStrided(m_first, m_stride, in, m_count);
+    }
+
+    /**
+     * @brief   Copies all fields in the span to a vector.
+     * @param   out The vector to write the values to. Previous contents are discarded.
+     */
+    void copyTo(std::vector<std::remove_cv_t<T>>& out) const
+    {
+        out.resize(m_count);
+        gather(out.data());
+    }
+
+    /**
+     * @brief   Writes values from a buffer to all fields in the span.
+     * @param   in  The values to write, at least `size()` elements.
+     */
+    void copyFrom(const std::remove_cv_t<T>* in) const
+    {
+        scatter(in);
+    }
+
+    /**
+     * @brief   Copies all values of a span of `EndianValue`s to a contiguous buffer, converted to
+     *          host byte order.
+     * @param   out The buffer to write the values to, at least `size()` elements.
+     *              
+     * The fields are gathered first and then converted in bulk (see `simd::byteSwapArray`), 
+     * which is considerably faster than converting the fields one by one.
+     */
+    template<typename U = std::remove_cv_t<T>, 
+        typename = std::enable_if_t<internal::IsEndianValue<U>::value>>
+    void gatherValues(typename U::ValueType* out) const
+    {
+        simd::gatherStrided(out, m_first, m_stride, m_count);
+        if (U::kIsSwapped) simd::byteSwapArray(out, m_count);
+    }
+
+    /**
+     * @brief   Writes values in host byte order to all fields of a span of `EndianValue`s.
+     * @param   in      The values to write, at least `size()` elements.
+     * @param   scratch Buffer of at least `size()` elements, receiving the converted values.
+     */
+    template<typename U = std::remove_cv_t<T>, 
+        typename = std::enable_if_t<internal::IsEndianValue<U>::value>>
+    void scatterValues(const typename U::ValueType* in, typename U::ValueType* scratch) const
+    {
+        static_assert(!std::is_const<T>::value, "cannot write to a span of constant fields");
+        std::copy(in, in + m_count, scratch);
+        if (U::kIsSwapped) simd::byteSwapArray(scratch, m_count);
+        simd::scatterStrided(m_first, m_stride, scratch, m_count);
+    }
+};
+
+/**
+ * @brief   Creates a span covering a `StaticField` of all objects in a range.
+ * @tparam  WrapperT    The wrapper type of the range.
+ * @tparam  T           The type of the field.
+ * @tparam  offsT       The offset of the field.
+ * @param   range       The range of objects.
+ * @param   field       The field to create the span for.
+ * @return  The resulting span.
+ */
+template<typename WrapperT, typename T, std::ptrdiff_t offsT>
+inline FieldSpan<typename Field<T, StaticOffsGetter<offsT>>::RewrittenT> makeFieldSpan(
+    const WrapperRange<WrapperT>& range, Field<T, StaticOffsGetter<offsT>> WrapperT::* /*field*/)
+{
+    return {range.first(), offsT, range.size(), range.stride()};
+}
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_FIELD_HPP
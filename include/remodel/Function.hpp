@@ -0,0 +1,665 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_FUNCTION_HPP
+#define REMODEL_FUNCTION_HPP
+
+/**     
+ * @file
+ * @brief Contains the function wrappers (`Function`, `MemberFunction`, `VirtualFunction`).
+ */
+
+#include "Field.hpp"
+
+namespace remodel
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [Function]                                                                                     //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines whether a `PtrGetter` ignores the raw pointer and always returns the same 
+ *          address, which allows function wrappers to resolve it just once.
+ * @tparam  PtrGetterT  The `PtrGetter` type.
+ */
+template<typename PtrGetterT>
+struct IsFixedGetter : std::false_type {};
+
+/**
+ * @internal
+ * @brief   `AbsGetter`s always return the same address.
+ * @copydetails IsFixedGetter
+ */
+template<>
+struct IsFixedGetter<AbsGetter> : std::true_type {};
+
+/**
+ * @internal
+ * @brief   Code pointer of a function wrapper, resolved once (pinned), lazily per epoch (tracked)
+ *          or on every call (neither).
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation.
+ */
+template<typename PtrGetterT, typename = void>
+class CodePtrCache
+{
+    mutable const void* m_ptr = nullptr;
+    const Epoch* m_epoch = nullptr;
+    mutable uint64_t m_stamp = 0;
+public:
+    void pin(const void* ptr)
+    {
+        m_ptr = ptr;
+        m_epoch = nullptr;
+    }
+
+    void track(const Epoch& epoch)
+    {
+        m_ptr = nullptr;
+        m_epoch = &epoch;
+    }
+
+    template<typename ResolverT>
+    const void* get(const ResolverT& resolver) const
+    {
+        if (m_ptr && (!m_epoch || m_stamp == m_epoch->stamp())) return m_ptr;
+        if (!m_epoch) return resolver();
+        m_stamp = m_epoch->stamp();
+        return m_ptr = resolver();
+    }
+};
+
+/**
+ * @internal
+ * @brief   Fixed getters are always pinned on construction, so calls skip all checks.
+ * @copydetails CodePtrCache
+ */
+template<typename PtrGetterT>
+class CodePtrCache<PtrGetterT, std::enable_if_t<IsFixedGetter<PtrGetterT>::value>>
+{
+    const void* m_ptr = nullptr;
+public:
+    void pin(const void* ptr) { m_ptr = ptr; }
+
+    template<typename ResolverT>
+    const void* get(const ResolverT&) const { return m_ptr; }
+};
+
+/**
+ * @internal
+ * @brief   Fall-through implementation for non-fptr types.
+ * @tparam  T           Invalid template argument.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation.
+ */
+template<typename T, typename PtrGetterT> 
+class FunctionImpl
+{
+    static_assert(BlackBoxConsts<T>::kFalse,
+        "function wrappers expect a function pointer definition as template parameter");
+};
+
+/**
+ * @internal
+ * @brief   A macro that defines a function implementation for a given calling convention.
+ * @param   callingConv The calling convention.
+ *                      
+ * The call operators forward their arguments to the function pointer, so arguments are converted
+ * to the parameter types only once and by-value arguments aren't copied twice.
+ */
+#define REMODEL_DEF_FUNCTION(callingConv)                                                          \
+    template<typename PtrGetterT, typename RetT, typename... ArgsT>                                \
+    class FunctionImpl<RetT (callingConv*)(ArgsT...), PtrGetterT>                                  \
+        : public internal::BasicFieldBase<PtrGetterT>                                              \
+    {                                                                                              \
+    protected:                                                                                     \
+        using FunctionPtr = RetT(callingConv*)(ArgsT...);                                          \
+                                                                                                   \
+        void pinCode() { m_code.pin(this->codePtr()); }                                             \
+    private:                                                                                       \
+        CodePtrCache<PtrGetterT> m_code;                                                           \
+    public:                                                                                        \
+        explicit FunctionImpl(PtrGetterT ptrGetter)                                                \
+            : BasicFieldBase<PtrGetterT>{nullptr, ptrGetter}                                       \
+        {                                                                                          \
+            if (IsFixedGetter<PtrGetterT>::value) pinCode();                                       \
+        }                                                                                          \
+                                                                                                   \
+        FunctionImpl(PtrGetterT ptrGetter, const Epoch& epoch)                                     \
+            : BasicFieldBase<PtrGetterT>{nullptr, ptrGetter}                                       \
+        {                                                                                          \
+            m_code.track(epoch);                                                                   \
+        }                                                                                          \
+                                                                                                   \
+        FunctionPtr get() const                                                                    \
+        {                                                                                          \
+            auto code = m_code.get([this] { return this->codePtr(); });                            \
+            REMODEL_PROFILE_CALL(this->parent(), code);                                            \
+            return (FunctionPtr)code;                                                              \
+        }                                                                                          \
+                                                                                                   \
+        template<typename... CallArgsT>                                                            \
+        RetT operator () (CallArgsT&&... args) const                                               \
+        {                                                                                          \
+            return get()(std::forward<CallArgsT>(args)...);                                        \
+        }                                                                                          \
+    }
+
+/**
+ * @internal
+ * @brief   A macro that defines a C-vararg function implementation for a given calling convention.
+ * @param   callingConv The calling convention.
+ */
+#define REMODEL_DEF_VARARG_FUNCTION(callingConv)                                                   \
+    template<typename PtrGetterT, typename RetT, typename... ArgsT>                                \
+    class FunctionImpl<RetT (callingConv*)(ArgsT..., ...), PtrGetterT>                             \
+        : public internal::BasicFieldBase<PtrGetterT>                                              \
+    {                                                                                              \
+    protected:                                                                                     \
+        using FunctionPtr = RetT(callingConv*)(ArgsT..., ...);                                     \
+                                                                                                   \
+        void pinCode() { m_code.pin(this->codePtr()); }                                             \
+    private:                                                                                       \
+        CodePtrCache<PtrGetterT> m_code;                                                           \
+    public:                                                                                        \
+        explicit FunctionImpl(PtrGetterT ptrGetter)                                                \
+            : BasicFieldBase<PtrGetterT>{nullptr, ptrGetter}                                       \
+        {                                                                                          \
+            if (IsFixedGetter<PtrGetterT>::value) pinCode();                                       \
+        }                                                                                          \
+                                                                                                   \
+        FunctionImpl(PtrGetterT ptrGetter, const Epoch& epoch)                                     \
+            : BasicFieldBase<PtrGetterT>{nullptr, ptrGetter}                                       \
+        {                                                                                          \
+            m_code.track(epoch);                                                                   \
+        }                                                                                          \
+                                                                                                   \
+        FunctionPtr get() const                                                                    \
+        {                                                                                          \
+            auto code = m_code.get([this] { return this->codePtr(); });                            \
+            REMODEL_PROFILE_CALL(this->parent(), code);                                            \
+            return (FunctionPtr)code;                                                              \
+        }                                                                                          \
+                                                                                                   \
+        template<typename... CallArgsT>                                                            \
+        RetT operator () (CallArgsT&&... args) const                                               \
+        {                                                                                          \
+            return get()(std::forward<CallArgsT>(args)...);                                        \
+        }                                                                                          \
+    }
+
+#ifdef ZYCORE_MSVC
+    REMODEL_DEF_FUNCTION(__cdecl);
+    REMODEL_DEF_FUNCTION(__stdcall);
+    REMODEL_DEF_FUNCTION(__thiscall);
+    REMODEL_DEF_FUNCTION(__fastcall);
+    REMODEL_DEF_FUNCTION(__vectorcall);
+    REMODEL_DEF_VARARG_FUNCTION(__cdecl);
+#elif defined(ZYCORE_GNUC)
+#   if defined(__i386__)
+    REMODEL_DEF_FUNCTION(__attribute__((cdecl)));
+    REMODEL_DEF_FUNCTION(__attribute__((stdcall)));
+    REMODEL_DEF_FUNCTION(__attribute__((fastcall)));
+    REMODEL_DEF_FUNCTION(__attribute__((thiscall)));
+    REMODEL_DEF_VARARG_FUNCTION(__attribute__((cdecl)));
+#   else
+    // The x86 conventions only yield distinct function types on 32-bit targets; elsewhere GCC and
+    // clang ignore them (with a warning) and a second specialization would be a redefinition.
+    REMODEL_DEF_FUNCTION();
+    REMODEL_DEF_VARARG_FUNCTION();
+#   endif
+#   if defined(__clang__) && (defined(__i386__) || (defined(_WIN32) && defined(__x86_64__)))
+    REMODEL_DEF_FUNCTION(__attribute__((vectorcall)));
+#   endif
+#endif
+
+#undef REMODEL_DEF_FUNCTION
+#undef REMODEL_DEF_VARARG_FUNCTION
+
+} // namespace internal
+
+/**
+ * @brief   Function wrapper template.
+ * @tparam  T           A function pointer definition equal to the prototype of the wrapped 
+ *                      function.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation. Defaults to a 
+ *                      type-erased functor accepting any `PtrGetter`.
+ *                      
+ * Wrappers constructed from an absolute address or with a fixed getter (`AbsGetter`, 
+ * `RvaGetter`) resolve the function pointer once, so calls are plain indirect calls. Other 
+ * getters are invoked on every call, unless an `Epoch` is passed, in which case the pointer is 
+ * resolved on the first call and again after the epoch was bumped.
+ */
+template<typename T, typename PtrGetterT = internal::FieldBase::PtrGetter>
+struct Function : internal::FunctionImpl<T, PtrGetterT>
+{
+    /**
+     * @brief   Constructs an instance with a custom `PtrGetter`.
+     * @param   ptrGetter   The `PtrGetter` to use for address calculation.
+     */
+    explicit Function(PtrGetterT ptrGetter)
+        : internal::FunctionImpl<T, PtrGetterT>(ptrGetter) // MSVC12 requires parentheses here
+    {}
+
+    /**
+     * @brief   Constructs an instance with a custom `PtrGetter`, caching its result.
+     * @param   ptrGetter   The `PtrGetter` to use for address calculation.
+     * @param   epoch       The epoch invalidating the cached function pointer.
+     */
+    Function(PtrGetterT ptrGetter, const Epoch& epoch)
+        // MSVC12 requires parentheses here
+        : internal::FunctionImpl<T, PtrGetterT>(ptrGetter, epoch)
+    {}
+
+    /**
+     * @brief   Constructs an instance from a pointer to the function in `uint` representation.
+     * @param   ptrGetter   The absolute address of the function in `uint` representation.
+     */
+    template<
+        typename GetterT = PtrGetterT,
+        typename = std::enable_if_t<std::is_constructible<GetterT, AbsGetter>::value>>
+    explicit Function(uintptr_t absAddress)
+        : Function{PtrGetterT(AbsGetter{absAddress})}
+    {
+        this->pinCode();
+    }
+
+    /**
+     * @brief   Constructs an instance from a raw pointer to the function.
+     * @param   ptr     The function pointer of the function to wrap.
+     */
+    template<
+        typename GetterT = PtrGetterT,
+        typename = std::enable_if_t<std::is_constructible<GetterT, AbsGetter>::value>>
+    explicit Function(T ptr)
+    // This cast magic is required because the C++ standard does not permit casting code pointers
+    // into data pointers as it doesn't require those to be the same size. remodel, however, makes
+    // that assumption (which is validated by a static_cast to reject unsupported platforms), so
+    // we can safely bypass the restriction using an extra level of pointers.
+        : Function{PtrGetterT(AbsGetter{*reinterpret_cast<void**>(&ptr)})}
+    {
+        this->pinCode();
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [MemberFunction]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Fall-through implementation for non-fptr types.
+ * @tparam  T           Invalid template argument.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation.
+ */
+template<typename T, typename PtrGetterT> 
+class MemberFunctionImpl
+{
+    static_assert(BlackBoxConsts<T>::kFalse,
+        "function wrappers expect a function pointer definition as template parameter");
+};
+
+/**
+ * @internal
+ * @brief   A macro that defines a member-function implementation for a given calling convention.
+ * @param   callingConv The calling convention.
+ */
+#define REMODEL_DEF_MEMBER_FUNCTION(callingConv)                                                   \
+    template<typename PtrGetterT, typename RetT, typename... ArgsT>                                \
+    class MemberFunctionImpl<RetT (callingConv*)(ArgsT...), PtrGetterT>                            \
+        : public internal::BasicFieldBase<PtrGetterT>                                              \
+    {                                                                                              \
+    public:                                                                                        \
+        using FunctionPtr = RetT(callingConv*)(void* thiz, ArgsT... args);                         \
+        using ReturnType = RetT;                                                                   \
+    protected:                                                                                     \
+                                                                                                   \
+        void pinCode() { m_code.pin(this->codePtr()); }                                             \
+                                                                                                   \
+        /* the wrapped object isn't part of the wrapper, so constness doesn't carry over */        \
+        void* thisPtr() const { return const_cast<void*>(addressOfObj(*this->parent())); }         \
+    private:                                                                                       \
+        CodePtrCache<PtrGetterT> m_code;                                                           \
+    public:                                                                                        \
+        MemberFunctionImpl(WrapperBase* parent, PtrGetterT ptrGetter)                              \
+            : BasicFieldBase<PtrGetterT>{parent, ptrGetter}                                        \
+        {                                                                                          \
+            if (IsFixedGetter<PtrGetterT>::value) pinCode();                                       \
+        }                                                                                          \
+                                                                                                   \
+        FunctionPtr get() const                                                                    \
+        {                                                                                          \
+            auto code = m_code.get([this] { return this->codePtr(); });                            \
+            REMODEL_PROFILE_CALL(this->parent(), code);                                            \
+            return (FunctionPtr)code;                                                              \
+        }                                                                                          \
+                                                                                                   \
+        template<typename... CallArgsT>                                                            \
+        RetT operator () (CallArgsT&&... args) const                                               \
+        {                                                                                          \
+            return get()(thisPtr(), std::forward<CallArgsT>(args)...);                             \
+        }                                                                                          \
+    }
+
+/**
+ * @internal
+ * @brief   A macro that defines a C-vararg member-function implementation for a given calling 
+ *          convention.
+ * @param   callingConv The calling convention.
+ */
+#define REMODEL_DEF_VARARG_MEMBER_FUNCTION(callingConv)                                            \
+    template<typename PtrGetterT, typename RetT, typename... ArgsT>                                \
+    class MemberFunctionImpl<RetT (callingConv*)(ArgsT..., ...), PtrGetterT>                       \
+        : public internal::BasicFieldBase<PtrGetterT>                                              \
+    {                                                                                              \
+    public:                                                                                        \
+        using FunctionPtr = RetT(callingConv*)(void* thiz, ArgsT... args, ...);                    \
+        using ReturnType = RetT;                                                                   \
+    protected:                                                                                     \
+                                                                                                   \
+        void pinCode() { m_code.pin(this->codePtr()); }                                             \
+                                                                                                   \
+        /* the wrapped object isn't part of the wrapper, so constness doesn't carry over */        \
+        void* thisPtr() const { return const_cast<void*>(addressOfObj(*this->parent())); }         \
+    private:                                                                                       \
+        CodePtrCache<PtrGetterT> m_code;                                                           \
+    public:                                                                                        \
+        MemberFunctionImpl(WrapperBase* parent, PtrGetterT ptrGetter)                              \
+            : BasicFieldBase<PtrGetterT>{parent, ptrGetter}                                        \
+        {                                                                                          \
+            if (IsFixedGetter<PtrGetterT>::value) pinCode();                                       \
+        }                                                                                          \
+                                                                                                   \
+        FunctionPtr get() const                                                                    \
+        {                                                                                          \
+            auto code = m_code.get([this] { return this->codePtr(); });                            \
+            REMODEL_PROFILE_CALL(this->parent(), code);                                            \
+            return (FunctionPtr)code;                                                              \
+        }                                                                                          \
+                                                                                                   \
+        template<typename... CallArgsT>                                                            \
+        RetT operator () (CallArgsT&&... args) const                                               \
+        {                                                                                          \
+            return get()(thisPtr(), std::forward<CallArgsT>(args)...);                             \
+        }                                                                                          \
+    }
+
+#ifdef ZYCORE_MSVC
+    REMODEL_DEF_MEMBER_FUNCTION(__cdecl);
+    REMODEL_DEF_MEMBER_FUNCTION(__stdcall);
+    REMODEL_DEF_MEMBER_FUNCTION(__thiscall);
+    REMODEL_DEF_MEMBER_FUNCTION(__fastcall);
+    REMODEL_DEF_MEMBER_FUNCTION(__vectorcall);
+    REMODEL_DEF_VARARG_MEMBER_FUNCTION(__cdecl);
+#elif defined(ZYCORE_GNUC)
+#   if defined(__i386__)
+    REMODEL_DEF_MEMBER_FUNCTION(__attribute__((cdecl)));
+    REMODEL_DEF_MEMBER_FUNCTION(__attribute__((stdcall)));
+    REMODEL_DEF_MEMBER_FUNCTION(__attribute__((fastcall)));
+    REMODEL_DEF_MEMBER_FUNCTION(__attribute__((thiscall)));
+    REMODEL_DEF_VARARG_MEMBER_FUNCTION(__attribute__((cdecl)));
+#   else
+    REMODEL_DEF_MEMBER_FUNCTION();
+    REMODEL_DEF_VARARG_MEMBER_FUNCTION();
+#   endif
+#   if defined(__clang__) && (defined(__i386__) || (defined(_WIN32) && defined(__x86_64__)))
+    REMODEL_DEF_MEMBER_FUNCTION(__attribute__((vectorcall)));
+#   endif
+#endif
+
+#undef REMODEL_DEF_MEMBER_FUNCTION
+#undef REMODEL_DEF_VARARG_MEMBER_FUNCTION
+
+} // namespace internal
+
+/**
+ * @brief   Member function wrapper template.
+ * @tparam  T           A function pointer definition equal to the prototype of the wrapped 
+ *                      function.
+ * @tparam  PtrGetterT  The `PtrGetter` type used for address calculation. Defaults to a 
+ *                      type-erased functor accepting any `PtrGetter`.
+ *                      
+ * Like with `Function`, absolute addresses and fixed getters are resolved just once.
+ */
+template<typename T, typename PtrGetterT = internal::FieldBase::PtrGetter>
+struct MemberFunction : internal::MemberFunctionImpl<T, PtrGetterT>
+{
+    /**
+     * @brief   Constructs an instance with a custom `PtrGetter`.
+     * @param   parent      The class wrapper instance this member-function belongs to.
+     * @param   ptrGetter   The `PtrGetter` to use for address calculation.
+     */
+    explicit MemberFunction(internal::WrapperBase* parent, PtrGetterT ptrGetter)
+        // MSVC12 requires parentheses here
+        : internal::MemberFunctionImpl<T, PtrGetterT>(parent, ptrGetter)
+    {}
+
+    /**
+     * @brief   Constructs an instance from a pointer to the member-function in `uint`
+     *          representation.
+     * @param   parent      The class wrapper instance this member-function belongs to.
+     * @param   ptrGetter   A pointer to the member-function to wrap in `uint` representation.
+     */
+    template<
+        typename GetterT = PtrGetterT,
+        typename = std::enable_if_t<std::is_constructible<GetterT, AbsGetter>::value>>
+    explicit MemberFunction(internal::WrapperBase* parent, uintptr_t absAddress)
+        : MemberFunction{parent, PtrGetterT(AbsGetter{absAddress})}
+    {
+        this->pinCode();
+    }
+
+    /**
+     * @brief   Constructs an instance from a raw pointer to the member-function.
+     * @param   parent      The class wrapper instance this member-function belongs to.
+     * @param   ptrGetter   A raw pointer to the member-function.
+     */
+    template<
+        typename GetterT = PtrGetterT,
+        typename = std::enable_if_t<std::is_constructible<GetterT, AbsGetter>::value>>
+    explicit MemberFunction(internal::WrapperBase* parent, void* absAddress)
+        : MemberFunction{parent, PtrGetterT(AbsGetter{absAddress})}
+    {
+        this->pinCode();
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [VirtualFunction]                                                                              //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Source of vftable indices looked up by the name of the virtual function, e.g. an
+ *          `OffsetDatabase` holding the indices of the running target version.
+ */
+class VfIndexResolver
+{
+public:
+    /**
+     * @brief   Looks up the vftable index of a virtual function.
+     * @param   name    The name of the function, e.g. `Dog::giveGoodie`.
+     * @return  The index, or nothing if unknown.
+     */
+    virtual zycore::Optional<std::size_t> vftableIndex(const char* name) const = 0;
+protected:
+    ~VfIndexResolver() = default;
+};
+
+/**
+ * @brief   Convenience wrapper around `MemberFunction` constructing from a vftable index.
+ * @tparam  T   A function pointer definition equal to the prototype of the wrapped function.
+ *              
+ * If the concrete class of the wrapped objects is known in advance, calls can be devirtualized 
+ * speculatively: the object's vftable is compared with the expected one and, on a match, the
+ * known implementation is called directly, falling back to the virtual call otherwise.
+ * @code
+ *     dog.giveGoodie.expect(kDogVfTable, &dogGiveGoodie); // checked by every call
+ *     dog.giveGoodie.speculate<&dogGiveGoodie>(kDogVfTable, 7); // direct, inlinable call
+ * @endcode
+ *
+ * Rather than hard-coding indices that shift between target versions, functions can be declared
+ * by name. The index is looked up once when the wrapper is created and stored in the getter, so
+ * calls index the vftable directly, as with a fixed index:
+ * @code
+ *     VirtualFunction<void (*)(int)> giveGoodie{this, "Dog::giveGoodie", OffsetDatabase::global()};
+ * @endcode
+ */
+template<typename T>
+struct VirtualFunction : MemberFunction<T, VfTableGetter>
+{
+    using Base = MemberFunction<T, VfTableGetter>;
+    using typename Base::FunctionPtr;
+    using typename Base::ReturnType;
+private:
+    const void* m_expectedVftable = nullptr;
+    FunctionPtr m_expectedTarget = nullptr;
+
+    static std::size_t indexOf(const char* name, const VfIndexResolver& resolver)
+    {
+        auto idx = resolver.vftableIndex(name);
+        return idx.hasValue() ? idx.value() : ~std::size_t{0};
+    }
+public:
+    /**
+     * @brief   Constructs an instance from a vftable index.
+     * @param   parent          The class wrapper instance this member-function belongs to.
+     * @param   vftableIdx      Index of the function inside the table.
+     * @param   vftableOffset   Offset of the vftable-pointer in the class.
+     */
+    explicit VirtualFunction(
+            internal::WrapperBase* parent, std::size_t vftableIdx, std::size_t vftableOffset = 0)
+        : MemberFunction<T, VfTableGetter>(parent, VfTableGetter{vftableIdx, vftableOffset})
+        // MSVC12 requires parentheses here
+    {}
+
+    /**
+     * @brief   Constructs an instance from a vftable index, sharing a vftable cache.
+     * @param   parent      The class wrapper instance this member-function belongs to.
+     * @param   cache       The vftable cache, a member of @p parent.
+     * @param   vftableIdx  Index of the function inside the table.
+     * @see     VfTableCache
+     */
+    VirtualFunction(internal::WrapperBase* parent, const VfTableCache& cache, 
+            std::size_t vftableIdx)
+        : MemberFunction<T, VfTableGetter>(parent, VfTableGetter{cache, vftableIdx})
+        // MSVC12 requires parentheses here
+    {}
+
+    /**
+     * @brief   Constructs an instance from the name of the function.
+     * @param   parent          The class wrapper instance this member-function belongs to.
+     * @param   name            The name of the function, e.g. `Dog::giveGoodie`.
+     * @param   resolver        The source of the vftable index.
+     * @param   vftableOffset   Offset of the vftable-pointer in the class.
+     *
+     * Calling the function is invalid if the name is unknown, see @c isResolved.
+     */
+    VirtualFunction(internal::WrapperBase* parent, const char* name,
+            const VfIndexResolver& resolver, std::size_t vftableOffset = 0)
+        : MemberFunction<T, VfTableGetter>(
+            parent, VfTableGetter{indexOf(name, resolver), vftableOffset})
+    {}
+
+    /**
+     * @brief   Constructs an instance from the name of the function, sharing a vftable cache.
+     * @param   parent      The class wrapper instance this member-function belongs to.
+     * @param   cache       The vftable cache, a member of @p parent.
+     * @param   name        The name of the function, e.g. `Dog::giveGoodie`.
+     * @param   resolver    The source of the vftable index.
+     * @copydetails VirtualFunction(internal::WrapperBase*, const char*, const VfIndexResolver&,
+     *              std::size_t)
+     */
+    VirtualFunction(internal::WrapperBase* parent, const VfTableCache& cache, const char* name,
+            const VfIndexResolver& resolver)
+        : MemberFunction<T, VfTableGetter>(
+            parent, VfTableGetter{cache, indexOf(name, resolver)})
+    {}
+
+    /**
+     * @brief   Determines whether the vftable index is known, i.e. whether the name passed on
+     *          construction was found.
+     * @return  @c true if known, else @c false.
+     */
+    bool isResolved() const { return this->ptrGetter().vftableIdx() != ~std::size_t{0}; }
+
+    /**
+     * @brief   Sets the implementation expected to be called, checked on every call.
+     * @param   vftable The vftable of the class providing @p target, @c nullptr to disable.
+     * @param   target  The implementation of the function in that class.
+     */
+    void expect(const void* vftable, FunctionPtr target)
+    {
+        m_expectedVftable = vftable;
+        m_expectedTarget = target;
+    }
+
+    /**
+     * @brief   Determines whether the wrapped object has a given vftable.
+     * @param   vftable The vftable.
+     * @return  @c true if it has, else @c false.
+     */
+    bool hasVfTable(const void* vftable) const
+    {
+        return this->ptrGetter().vftable(this->thisPtr()) == vftable;
+    }
+
+    /**
+     * @brief   Calls the function, directly if the object has the vftable passed to @c expect.
+     */
+    template<typename... CallArgsT>
+    ReturnType operator () (CallArgsT&&... args) const
+    {
+        if (m_expectedVftable && hasVfTable(m_expectedVftable))
+        {
+            return m_expectedTarget(this->thisPtr(), std::forward<CallArgsT>(args)...);
+        }
+        return Base::operator () (std::forward<CallArgsT>(args)...);
+    }
+
+    /**
+     * @brief   Calls a known implementation directly if the object has the expected vftable, else
+     *          performs the virtual call.
+     * @tparam  targetT The implementation of the function in the expected class.
+     * @param   vftable The vftable of the expected class.
+     * @param   args    The arguments.
+     * @return  The return value.
+     */
+    template<FunctionPtr targetT, typename... CallArgsT>
+    ReturnType speculate(const void* vftable, CallArgsT&&... args) const
+    {
+        if (hasVfTable(vftable)) return targetT(this->thisPtr(), std::forward<CallArgsT>(args)...);
+        return Base::operator () (std::forward<CallArgsT>(args)...);
+    }
+};
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_FUNCTION_HPP
@@ -0,0 +1,1141 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_MODULE_HPP
+#define REMODEL_MODULE_HPP
+
+/**     
+ * @file
+ * @brief Contains `Global`, module lookup and the module-relative pointer getters.
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#include "../Platform.hpp"
+#include "../Pattern.hpp"
+#include "Function.hpp"
+
+namespace remodel
+{
+
+// ============================================================================================== //
+// Classes that may be used to place objects in a global or module level space                    //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [Global]                                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+class Global;
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Storage of the `Global` singleton.
+ *
+ * A static data member of a class template, so the header can define it without C++17 inline
+ * variables. Since `Global` is constructed by a `constexpr` constructor, the instance is
+ * constant-initialized: it exists before any dynamic initialization runs and accesses don't pay
+ * for the guard checks of function-local statics.
+ */
+template<typename = void>
+struct GlobalStorage
+{
+    static Global instance;
+};
+
+} // namespace internal
+
+/**
+ * @brief   Allows declaration of global variables as fields using absolute addresses.
+ *
+ * Fields of the global wrapper resolve their offset relative to a null raw pointer, i.e. the
+ * offset is the absolute address. Fields that don't need a parent at all can use an `AbsGetter`
+ * instead, see `GlobalField`.
+ */
+class Global
+    : public ClassWrapper
+    , public zycore::NonCopyable
+{
+    REMODEL_WRAPPER(Global)
+    template<typename> friend struct internal::GlobalStorage;
+
+    /**
+     * @brief   Default constructor.
+     */
+    constexpr Global() : ClassWrapper{nullptr} {}
+public:
+    /**
+     * @brief   Gets the instance of the singleton.
+     * @return  The instance, constant-initialized and thus usable during static initialization.
+     */
+    static Global* instance()
+    {
+        return internal::GlobalStorage<>::instance.addressOfWrapper();
+    }
+};
+
+template<typename T>
+Global internal::GlobalStorage<T>::instance;
+
+/**
+ * @brief   Field of a global variable at an absolute address, not requiring a parent.
+ * @tparam  T       The type of the variable.
+ * @tparam  AccessT The access policy, see `access`.
+ *
+ * Accesses skip the parent (and thus `Global::instance()`) entirely and boil down to a load of
+ * the address stored in the field, followed by the access itself.
+ *
+ * @code
+ *     GlobalField<int32_t> frameCount{nullptr, AbsGetter{module.base() + 0x1234}};
+ * @endcode
+ */
+template<typename T, typename AccessT = access::Plain>
+using GlobalField = Field<T, AbsGetter, AccessT>;
+
+// ---------------------------------------------------------------------------------------------- //
+// [SymbolIndex]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Immutable open-addressing hash table mapping symbol names to addresses.
+ */
+class SymbolIndex : public zycore::NonCopyable
+{
+    struct Slot
+    {
+        uint32_t hash;
+        const platform::SymbolInfo* symbol; // @c nullptr for empty slots
+    };
+
+    std::vector<platform::SymbolInfo> m_symbols;
+    std::vector<Slot> m_slots;
+    std::size_t m_mask = 0;
+
+    static uint32_t hashOf(const char* name)
+    {
+        uint32_t hash = 0x811C9DC5;
+        for (; *name; ++name) hash = (hash ^ static_cast<uint8_t>(*name)) * 0x01000193;
+        return hash;
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   symbols The symbols. On duplicate names, the first one wins.
+     */
+    explicit SymbolIndex(std::vector<platform::SymbolInfo> symbols)
+        : m_symbols(std::move(symbols))
+    {
+        // Keep the load factor at or below 50%, so probe sequences stay short.
+        std::size_t capacity = 16;
+        while (capacity < m_symbols.size() * 2) capacity *= 2;
+        m_slots.assign(capacity, Slot{0, nullptr});
+        m_mask = capacity - 1;
+
+        for (const auto& cur : m_symbols)
+        {
+            const uint32_t hash = hashOf(cur.name);
+            std::size_t idx = hash & m_mask;
+            for (; m_slots[idx].symbol; idx = (idx + 1) & m_mask)
+            {
+                if (m_slots[idx].hash == hash && !std::strcmp(m_slots[idx].symbol->name, cur.name))
+                {
+                    break;
+                }
+            }
+            if (!m_slots[idx].symbol) m_slots[idx] = Slot{hash, &cur};
+        }
+    }
+
+    /**
+     * @brief   Looks up a symbol.
+     * @param   name    The name of the symbol.
+     * @return  The symbol or @c nullptr if not found.
+     */
+    const platform::SymbolInfo* find(const char* name) const
+    {
+        const uint32_t hash = hashOf(name);
+        for (std::size_t idx = hash & m_mask; m_slots[idx].symbol; idx = (idx + 1) & m_mask)
+        {
+            const auto& slot = m_slots[idx];
+            if (slot.hash == hash && !std::strcmp(slot.symbol->name, name)) return slot.symbol;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief   Gets the number of symbols.
+     * @return  The number of symbols.
+     */
+    std::size_t size() const { return m_symbols.size(); }
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [ModuleRegistry]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Table of the modules loaded into our address space.
+ *          
+ * The modules are enumerated once (see @c platform::enumerateModules) and kept sorted by base
+ * address and by name, so lookups take logarithmic time and never involve the loader. The table
+ * has to be refreshed manually after modules were loaded or unloaded; refreshing must not happen
+ * concurrently with lookups.
+ */
+class ModuleRegistry : public zycore::NonCopyable
+{
+    using SymbolIndexPtr = std::atomic<const internal::SymbolIndex*>;
+    using ImportTablePtr = std::atomic<const std::vector<platform::ImportInfo>*>;
+
+    std::vector<platform::ModuleInfo> m_modules; // sorted by base
+    std::vector<std::size_t> m_byName;
+    std::size_t m_main = 0;
+    std::unique_ptr<SymbolIndexPtr[]> m_symbols; // built lazily, indexed like `m_modules`
+    std::unique_ptr<ImportTablePtr[]> m_imports; // likewise
+
+    void releaseSymbols()
+    {
+        if (!m_symbols) return;
+        for (std::size_t i = 0; i < m_modules.size(); ++i)
+        {
+            delete m_symbols[i].load();
+            delete m_imports[i].load();
+        }
+        m_symbols.reset();
+        m_imports.reset();
+    }
+
+    static int compareNames(const char* a, const char* b)
+    {
+#       if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32)
+            return _stricmp(a, b);
+#       else
+            return std::strcmp(a, b);
+#       endif
+    }
+
+    static int compareNames(const std::string& a, const char* b)
+    {
+        return compareNames(a.c_str(), b);
+    }
+public:
+    /**
+     * @brief   Default constructor, enumerates the modules.
+     */
+    ModuleRegistry() { refresh(); }
+
+    /**
+     * @brief   Destructor.
+     */
+    ~ModuleRegistry() { releaseSymbols(); }
+
+    /**
+     * @brief   Gets the registry shared by @c Module::getModule.
+     * @return  The registry.
+     */
+    static ModuleRegistry& global()
+    {
+        static ModuleRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief   Enumerates the modules again.
+     * @return  @c true if succeeded, else @c false.
+     */
+    bool refresh()
+    {
+        std::vector<platform::ModuleInfo> modules;
+        const bool ok = platform::enumerateModules(modules);
+        const uintptr_t mainBase = modules.empty() ? 0 : modules.front().base;
+
+        std::sort(modules.begin(), modules.end(), 
+            [](const platform::ModuleInfo& a, const platform::ModuleInfo& b)
+        {
+            return a.base < b.base;
+        });
+
+        releaseSymbols();
+        m_modules.swap(modules);
+        m_symbols.reset(new SymbolIndexPtr[m_modules.size()]);
+        m_imports.reset(new ImportTablePtr[m_modules.size()]);
+        for (std::size_t i = 0; i < m_modules.size(); ++i)
+        {
+            m_symbols[i].store(nullptr);
+            m_imports[i].store(nullptr);
+        }
+        m_main = 0;
+        m_byName.resize(m_modules.size());
+        for (std::size_t i = 0; i < m_modules.size(); ++i)
+        {
+            m_byName[i] = i;
+            if (m_modules[i].base == mainBase) m_main = i;
+        }
+        std::sort(m_byName.begin(), m_byName.end(), [this](std::size_t a, std::size_t b)
+        {
+            return compareNames(m_modules[a].name, m_modules[b].name.c_str()) < 0;
+        });
+
+        return ok;
+    }
+
+    /**
+     * @brief   Gets all modules, sorted by base address.
+     * @return  The modules.
+     */
+    const std::vector<platform::ModuleInfo>& modules() const { return m_modules; }
+
+    /**
+     * @brief   Looks up a module by name.
+     * @param   moduleName  The file name (e.g. `ntdll.dll`), a path, or @c nullptr for the main 
+     *                      module.
+     * @return  The module or @c nullptr if not found.
+     */
+    const platform::ModuleInfo* find(const char* moduleName) const
+    {
+        if (m_modules.empty()) return nullptr;
+        if (!moduleName) return &m_modules[m_main];
+
+        // Paths are rare and can't use the name index.
+        if (std::strpbrk(moduleName, "/\\"))
+        {
+            for (const auto& cur : m_modules)
+            {
+                if (platform::matchesModuleName(cur, moduleName)) return &cur;
+            }
+            return nullptr;
+        }
+
+        auto it = std::lower_bound(m_byName.begin(), m_byName.end(), moduleName, 
+            [this](std::size_t idx, const char* name)
+        {
+            return compareNames(m_modules[idx].name, name) < 0;
+        });
+        if (it == m_byName.end() || compareNames(m_modules[*it].name, moduleName)) return nullptr;
+        return &m_modules[*it];
+    }
+
+    /**
+     * @brief   Looks up the module containing an address.
+     * @param   address The address.
+     * @return  The module or @c nullptr if the address doesn't belong to any module.
+     */
+    const platform::ModuleInfo* findByAddress(const void* address) const
+    {
+        const auto addr = reinterpret_cast<uintptr_t>(address);
+        auto it = std::upper_bound(m_modules.begin(), m_modules.end(), addr, 
+            [](uintptr_t val, const platform::ModuleInfo& module)
+        {
+            return val < module.base;
+        });
+        if (it == m_modules.begin()) return nullptr;
+        --it;
+        return addr - it->base < it->size ? &*it : nullptr;
+    }
+
+    /**
+     * @brief   Looks up a symbol exported by a module.
+     * @param   module  The module, as returned by this registry.
+     * @param   name    The name of the symbol.
+     * @return  The symbol or @c nullptr if not found.
+     *          
+     * The exports of every module are indexed on first use (see @c platform::obtainExports), 
+     * later lookups are single hash table probes. Lookups are lock-free and may happen 
+     * concurrently.
+     */
+    const platform::SymbolInfo* findSymbol(const platform::ModuleInfo& module, 
+        const char* name) const
+    {
+        auto& slot = m_symbols[static_cast<std::size_t>(&module - m_modules.data())];
+        auto index = slot.load(std::memory_order_acquire);
+        if (!index)
+        {
+            std::vector<platform::SymbolInfo> symbols;
+            platform::obtainExports(reinterpret_cast<const void*>(module.base), symbols);
+            std::unique_ptr<const internal::SymbolIndex> built{
+                new internal::SymbolIndex{std::move(symbols)}};
+
+            // Another thread might have won the race; use its index then.
+            if (slot.compare_exchange_strong(index, built.get(), std::memory_order_acq_rel))
+            {
+                index = built.release();
+            }
+        }
+        return index->find(name);
+    }
+
+    /**
+     * @brief   Gets the symbols imported by a module.
+     * @param   module  The module, as returned by this registry.
+     * @return  The imports.
+     *
+     * The import table is parsed on first use (see @c platform::obtainImports). Like symbol
+     * lookups, this is lock-free and may happen concurrently.
+     */
+    const std::vector<platform::ImportInfo>& imports(const platform::ModuleInfo& module) const
+    {
+        auto& slot = m_imports[static_cast<std::size_t>(&module - m_modules.data())];
+        auto table = slot.load(std::memory_order_acquire);
+        if (!table)
+        {
+            std::unique_ptr<std::vector<platform::ImportInfo>> built{
+                new std::vector<platform::ImportInfo>};
+            platform::obtainImports(reinterpret_cast<const void*>(module.base), *built);
+            if (slot.compare_exchange_strong(table, built.get(), std::memory_order_acq_rel))
+            {
+                table = built.release();
+            }
+        }
+        return *table;
+    }
+
+    /**
+     * @brief   Looks up a symbol imported by a module.
+     * @param   module          The module, as returned by this registry.
+     * @param   importModule    The name of the module imported from, e.g. `kernel32.dll`.
+     *                          Ignored for ELF modules, whose imports aren't bound to a module.
+     * @param   name            The name of the symbol.
+     * @return  The import or @c nullptr if not found.
+     */
+    const platform::ImportInfo* findImport(const platform::ModuleInfo& module,
+        const char* importModule, const char* name) const
+    {
+        for (const auto& cur : imports(module))
+        {
+            if (std::strcmp(cur.name, name)) continue;
+            if (!cur.module || !importModule || !compareNames(cur.module, importModule))
+            {
+                return &cur;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [Module]                                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Allows declaration of global variables as fields using module relative addresses.
+ *
+ * A light wrapper holding nothing but the base address, so modules (and `Optional<Module>`s)
+ * are copied as cheaply as a pointer.
+ */
+class Module : public LightClassWrapper
+{
+    REMODEL_LIGHT_WRAPPER(Module)
+public:
+    /**
+     * @brief   Gets a module by it's name (e.g. `ntdll.dll`).
+     * @param   moduleName  The name of the desired module or @c nullptr for the main-module.
+     * @return  If found, the module, else an empty optional.
+     *          
+     * The module is looked up in @c ModuleRegistry::global, which is refreshed once if the module
+     * is not found, in case it was loaded after the registry was built.
+     */
+    static zycore::Optional<Module> getModule(const char* moduleName)
+    {
+        auto& registry = ModuleRegistry::global();
+        auto module = registry.find(moduleName);
+        if (!module && registry.refresh()) module = registry.find(moduleName);
+        if (!module) return zycore::kEmpty;
+        return {zycore::kInPlace, wrapper_cast<Module>(reinterpret_cast<void*>(module->base))};
+    }
+
+    /**
+     * @brief   Gets the module containing an address.
+     * @param   address The address, e.g. of a function or a global variable.
+     * @return  If found, the module, else an empty optional.
+     */
+    static zycore::Optional<Module> getModuleByAddress(const void* address)
+    {
+        auto& registry = ModuleRegistry::global();
+        auto module = registry.findByAddress(address);
+        if (!module && registry.refresh()) module = registry.findByAddress(address);
+        if (!module) return zycore::kEmpty;
+        return {zycore::kInPlace, wrapper_cast<Module>(reinterpret_cast<void*>(module->base))};
+    }
+
+    /**
+     * @brief   Looks up a symbol exported by the module, without involving the loader.
+     * @param   name    The name of the symbol.
+     * @return  If found, the address of the symbol, else an empty optional.
+     * @see     ModuleRegistry::findSymbol
+     */
+    zycore::Optional<uintptr_t> symbol(const char* name) const
+    {
+        auto module = info();
+        if (!module) return zycore::kEmpty;
+        auto sym = ModuleRegistry::global().findSymbol(*module, name);
+        if (!sym) return zycore::kEmpty;
+        return {zycore::kInPlace, sym->address};
+    }
+
+    /**
+     * @brief   Looks up the IAT or GOT entry the module calls an imported symbol through.
+     * @param   importModule    The name of the module imported from, e.g. `kernel32.dll`.
+     *                          Ignored on ELF platforms.
+     * @param   name            The name of the symbol.
+     * @return  If found, the address of the entry, else an empty optional.
+     * @see     ModuleRegistry::findImport, ImportHook
+     */
+    zycore::Optional<uintptr_t> importSlot(const char* importModule, const char* name) const
+    {
+        auto module = info();
+        if (!module) return zycore::kEmpty;
+        auto import = ModuleRegistry::global().findImport(*module, importModule, name);
+        if (!import) return zycore::kEmpty;
+        return {zycore::kInPlace, import->slot};
+    }
+
+    /**
+     * @brief   Gets the registry entry of the module.
+     * @return  The entry or @c nullptr if the module isn't loaded (anymore).
+     */
+    const platform::ModuleInfo* info() const
+    {
+        auto& registry = ModuleRegistry::global();
+        auto module = registry.findByAddress(addressOfObj());
+        if (!module && registry.refresh()) module = registry.findByAddress(addressOfObj());
+        if (!module || module->base != reinterpret_cast<uintptr_t>(addressOfObj())) return nullptr;
+        return module;
+    }
+
+    /**
+     * @brief   Searches the executable sections of the module for a byte pattern.
+     * @param   pattern The pattern to search for.
+     * @return  If found, the address of the first match, else an empty optional.
+     * @see     remodel::findPattern
+     */
+    zycore::Optional<uintptr_t> findPattern(const Pattern& pattern) const
+    {
+        std::vector<platform::MemoryRegion> regions;
+        if (!platform::obtainCodeRegions(addressOfObj(), regions)) return zycore::kEmpty;
+
+        for (const auto& cur : regions)
+        {
+            auto match = remodel::findPattern(
+                reinterpret_cast<const void*>(cur.address), cur.size, pattern);
+            if (match) return {zycore::kInPlace, reinterpret_cast<uintptr_t>(match)};
+        }
+
+        return zycore::kEmpty;
+    }
+
+    /**
+     * @brief   Searches the executable sections of the module for a byte pattern.
+     * @param   pattern The pattern to search for, e.g. `48 8B ?? ?? E8`.
+     * @copydetails findPattern(const Pattern&) const
+     */
+    zycore::Optional<uintptr_t> findPattern(const char* pattern) const
+    {
+        return findPattern(Pattern{pattern});
+    }
+
+    /**
+     * @brief   Searches the executable sections of the module for many patterns at once.
+     * @param   patterns    The patterns to search for.
+     * @param   results     Receives the address of the first match of every pattern, or @c 0 if 
+     *                      not found, indexed like the patterns.
+     * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+     * @return  @c true if the module's sections could be determined, else @c false.
+     * @see     PatternSet::find
+     */
+    bool findPatterns(const PatternSet& patterns, std::vector<uintptr_t>& results, 
+        unsigned numThreads = 0) const
+    {
+        std::vector<platform::MemoryRegion> regions;
+        if (!platform::obtainCodeRegions(addressOfObj(), regions)) return false;
+
+        std::vector<const uint8_t*> matches;
+        patterns.find(regions.data(), regions.size(), matches, numThreads);
+        results.resize(matches.size());
+        std::transform(matches.begin(), matches.end(), results.begin(), 
+            [](const uint8_t* match) { return reinterpret_cast<uintptr_t>(match); });
+        return true;
+    }
+};
+
+// Verify assumptions about this class.
+static_assert(std::is_trivially_copy_constructible<Module>::value
+    && std::is_trivially_destructible<Module>::value, "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [RvaGetter]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor returning a fixed address relative to a module's base.
+ *          
+ * The module base is resolved once, on construction, so calls cost the same as with an 
+ * @c AbsGetter while remaining correct for relocated (ASLR) images.
+ */
+class RvaGetter
+{
+    void* m_ptr = nullptr;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   module  The module.
+     * @param   rva     The address relative to the module base.
+     */
+    RvaGetter(const Module& module, uintptr_t rva)
+        : m_ptr{reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(module.addressOfObj()) + rva)}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   moduleName  The name of the module, @c nullptr for the main-module.
+     * @param   rva         The address relative to the module base.
+     * @see     Module::getModule
+     */
+    RvaGetter(const char* moduleName, uintptr_t rva)
+    {
+        auto module = Module::getModule(moduleName);
+        if (module.hasValue()) *this = RvaGetter{module.value(), rva};
+    }
+
+    /**
+     * @brief   Determines whether the module was found. If not, calls return @c nullptr.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid() const { return m_ptr != nullptr; }
+
+    void* operator () (void*) const
+    {
+        return m_ptr;
+    }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   `RvaGetter`s resolve the module base on construction.
+ * @copydetails IsFixedGetter
+ */
+template<>
+struct IsFixedGetter<RvaGetter> : std::true_type {};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [LazyGetter]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Converts the results of `LazyGetter` resolvers to pointers.
+ */
+inline void* lazyAddressOf(void* address) { return address; }
+
+/**
+ * @internal
+ * @copydoc lazyAddressOf(void*)
+ */
+inline void* lazyAddressOf(uintptr_t address) { return reinterpret_cast<void*>(address); }
+
+/**
+ * @internal
+ * @copydoc lazyAddressOf(void*)
+ */
+inline void* lazyAddressOf(const zycore::Optional<uintptr_t>& address)
+{
+    return address.hasValue() ? reinterpret_cast<void*>(address.value()) : nullptr;
+}
+
+} // namespace internal
+
+class LazyGetter;
+inline bool resolveAll(unsigned numThreads = 0);
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   The unresolved `LazyGetter`s, as picked up by `resolveAll`.
+ */
+class LazyGetterRegistry
+{
+    std::mutex m_mutex;
+    std::unordered_set<LazyGetter*> m_pending;
+public:
+    static LazyGetterRegistry& global()
+    {
+        static LazyGetterRegistry registry;
+        return registry;
+    }
+
+    void add(LazyGetter* getter)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_pending.insert(getter);
+    }
+
+    void remove(LazyGetter* getter)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_pending.erase(getter);
+    }
+
+    std::vector<LazyGetter*> take()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::vector<LazyGetter*> pending{m_pending.begin(), m_pending.end()};
+        m_pending.clear();
+        return pending;
+    }
+};
+
+} // namespace internal
+
+/**
+ * @brief   `PtrGetter` functor resolving a fixed address on first use, e.g. by a signature scan.
+ *
+ * Defers resolution until the wrapped global is actually accessed, so startup isn't blocked by
+ * resolving globals that may never be touched. The resolver runs exactly once, even if the first
+ * accesses happen concurrently (later callers wait for it), and may return a pointer, an
+ * `uintptr_t` or the `zycore::Optional<uintptr_t>` returned by `Module::symbol` and
+ * `Module::findPattern`. Afterwards, calls are a single load of the resolved address.
+ *
+ * @code
+ *     Field<int32_t, LazyGetter> playerCount{nullptr, LazyGetter{[]
+ *     {
+ *         return Module::getModule(nullptr).value().findPattern("8B 0D ?? ?? ?? ?? 85 C9");
+ *     }}};
+ *     Function<void(*)(int), LazyGetter> kick{LazyGetter{[] { return mainModule.symbol("kick"); }}};
+ * @endcode
+ *
+ * Copies share nothing: a copy of a resolved getter is resolved, a copy of an unresolved one
+ * resolves separately.
+ *
+ * Unresolved getters are registered globally, so startup code that prefers paying for resolution
+ * up front can resolve all of them at once with `resolveAll`. Getters created by `pattern` and
+ * `symbol` describe their query, which lets `resolveAll` batch them.
+ */
+class LazyGetter
+{
+public:
+    /**
+     * @brief   Type-erased resolver computing the address.
+     */
+    using Resolver = std::function<void*()>;
+private:
+    friend bool resolveAll(unsigned numThreads);
+
+    enum : uint8_t
+    {
+        kUnresolved,
+        kResolving,
+        kResolved,
+    };
+
+    enum class Query : uint8_t
+    {
+        Custom,
+        Pattern,
+        Symbol,
+    };
+
+    Resolver m_resolver;
+    mutable std::atomic<void*> m_ptr{nullptr};
+    mutable std::atomic<uint8_t> m_state{kUnresolved};
+    std::atomic<bool> m_registered{false};
+    Query m_query = Query::Custom;
+    std::string m_module; // empty for the main module
+    std::string m_name;   // the pattern or symbol
+
+    LazyGetter(Query query, const char* module, const char* name)
+        : m_query{query}
+        , m_module{module ? module : ""}
+        , m_name{name}
+    {
+        auto moduleName = m_module;
+        auto queryName = m_name;
+        m_resolver = [query, moduleName, queryName]() -> void*
+        {
+            auto module = Module::getModule(moduleName.empty() ? nullptr : moduleName.c_str());
+            if (!module) return nullptr;
+            return internal::lazyAddressOf(query == Query::Pattern
+                ? module.value().findPattern(queryName.c_str())
+                : module.value().symbol(queryName.c_str()));
+        };
+        registerPending();
+    }
+
+    void registerPending()
+    {
+        m_registered.store(true, std::memory_order_relaxed);
+        internal::LazyGetterRegistry::global().add(this);
+    }
+
+    bool claim() const
+    {
+        auto state = static_cast<uint8_t>(kUnresolved);
+        return m_state.compare_exchange_strong(state, kResolving, std::memory_order_acquire);
+    }
+
+    void complete(void* ptr) const
+    {
+        m_ptr.store(ptr, std::memory_order_release);
+        m_state.store(kResolved, std::memory_order_release);
+    }
+
+    void* resolve() const
+    {
+        if (claim())
+        {
+            complete(m_resolver ? m_resolver() : nullptr);
+        }
+        else
+        {
+            while (m_state.load(std::memory_order_acquire) != kResolved)
+            {
+                std::this_thread::yield();
+            }
+        }
+        return m_ptr.load(std::memory_order_acquire);
+    }
+public:
+    /**
+     * @brief   Constructor.
+     * @param   resolver    Functor computing the address on first use.
+     */
+    template<typename ResolverT, typename = std::enable_if_t<
+        !std::is_same<std::decay_t<ResolverT>, LazyGetter>::value>>
+    explicit LazyGetter(ResolverT resolver)
+        : m_resolver{[resolver]() mutable { return internal::lazyAddressOf(resolver()); }}
+    {
+        registerPending();
+    }
+
+    /**
+     * @brief   Copy constructor.
+     * @param   other   The getter to copy from.
+     */
+    LazyGetter(const LazyGetter& other)
+        : m_resolver{other.m_resolver}
+        , m_query{other.m_query}
+        , m_module{other.m_module}
+        , m_name{other.m_name}
+    {
+        if (other.isResolved())
+        {
+            m_ptr.store(other.m_ptr.load(std::memory_order_acquire), std::memory_order_relaxed);
+            m_state.store(kResolved, std::memory_order_relaxed);
+        }
+        else
+        {
+            registerPending();
+        }
+    }
+
+    /**
+     * @brief   Destructor.
+     */
+    ~LazyGetter()
+    {
+        if (m_registered.load(std::memory_order_relaxed))
+        {
+            internal::LazyGetterRegistry::global().remove(this);
+        }
+    }
+
+    /**
+     * @brief   Creates a getter resolving to the first match of a pattern in a module.
+     * @param   module  The name of the module, @c nullptr for the main module.
+     * @param   pattern The pattern, e.g. `48 8B ?? ?? E8`.
+     * @return  The getter.
+     * @see     Module::findPattern
+     */
+    static LazyGetter pattern(const char* module, const char* pattern)
+    {
+        return LazyGetter{Query::Pattern, module, pattern};
+    }
+
+    /**
+     * @brief   Creates a getter resolving to a symbol exported by a module.
+     * @param   module  The name of the module, @c nullptr for the main module.
+     * @param   name    The name of the symbol.
+     * @return  The getter.
+     * @see     Module::symbol
+     */
+    static LazyGetter symbol(const char* module, const char* name)
+    {
+        return LazyGetter{Query::Symbol, module, name};
+    }
+
+    /**
+     * @brief   Determines whether the address was resolved already.
+     * @return  @c true if resolved, else @c false.
+     */
+    bool isResolved() const { return m_state.load(std::memory_order_acquire) == kResolved; }
+
+    void* operator () (void*) const
+    {
+        // A null address also ends up here, but `resolve` returns it right away when resolved.
+        auto ptr = m_ptr.load(std::memory_order_acquire);
+        return ptr ? ptr : resolve();
+    }
+};
+
+/**
+ * @brief   Resolves all pending `LazyGetter`s at once, e.g. right after attaching.
+ * @param   numThreads  The maximum number of threads, 0 to use the hardware concurrency.
+ * @return  @c true if every address was found, else @c false.
+ *
+ * Pattern queries are grouped by module, so every module is scanned once for all of its patterns
+ * (see `PatternSet`). Symbol lookups and custom resolvers run on a set of worker threads. Getters
+ * that are being resolved by an access concurrently are left to it.
+ *
+ * Must not run concurrently with the destruction of unresolved getters.
+ */
+inline bool resolveAll(unsigned numThreads)
+{
+    using Query = LazyGetter::Query;
+
+    std::vector<const LazyGetter*> pending;
+    for (auto getter : internal::LazyGetterRegistry::global().take())
+    {
+        getter->m_registered.store(false, std::memory_order_relaxed);
+        if (getter->claim()) pending.push_back(getter);
+    }
+
+    // Look up the modules up front, keeping registry refreshes out of the worker threads.
+    std::map<std::string, const platform::ModuleInfo*> modules;
+    std::map<std::string, std::vector<const LazyGetter*>> patterns;
+    std::vector<const LazyGetter*> others;
+    for (auto getter : pending)
+    {
+        if (getter->m_query != Query::Custom && !modules.count(getter->m_module))
+        {
+            auto module = Module::getModule(
+                getter->m_module.empty() ? nullptr : getter->m_module.c_str());
+            modules[getter->m_module] = module ? module.value().info() : nullptr;
+        }
+
+        if (getter->m_query == Query::Pattern)
+        {
+            patterns[getter->m_module].push_back(getter);
+        }
+        else
+        {
+            others.push_back(getter);
+        }
+    }
+
+    std::atomic<bool> allFound{true};
+    auto complete = [&](const LazyGetter* getter, void* ptr)
+    {
+        if (!ptr) allFound.store(false, std::memory_order_relaxed);
+        getter->complete(ptr);
+    };
+
+    for (const auto& group : patterns)
+    {
+        auto module = modules.at(group.first);
+        PatternSet set;
+        for (auto getter : group.second) set.add(getter->m_name.c_str());
+
+        std::vector<uintptr_t> matches;
+        if (!module || !wrapper_cast<Module>(reinterpret_cast<void*>(module->base))
+            .findPatterns(set, matches, numThreads))
+        {
+            matches.assign(set.size(), 0);
+        }
+        for (std::size_t i = 0; i < set.size(); ++i)
+        {
+            complete(group.second[i], reinterpret_cast<void*>(matches[i]));
+        }
+    }
+
+    internal::parallelFor(others.size(), numThreads, [&](std::size_t i)
+    {
+        auto getter = others[i];
+        if (getter->m_query == Query::Custom)
+        {
+            complete(getter, getter->m_resolver ? getter->m_resolver() : nullptr);
+            return;
+        }
+
+        auto module = modules.at(getter->m_module);
+        auto sym = module
+            ? ModuleRegistry::global().findSymbol(*module, getter->m_name.c_str()) : nullptr;
+        complete(getter, sym ? reinterpret_cast<void*>(sym->address) : nullptr);
+    });
+
+    return allFound.load(std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+// [LazyFunction]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Free function bound on its first call through a self-patching stub.
+ * @tparam  T           The function pointer type, including the calling convention.
+ * @tparam  ResolverT   A type with a static `resolve()` returning anything `LazyGetter` accepts.
+ *
+ * Unlike `Function<T, LazyGetter>`, which checks for a resolved address on every call, the
+ * cached pointer initially refers to a stub with the function's signature. The first call runs
+ * the resolver exactly once (concurrent first callers wait for it), swaps the real address into
+ * the cache and tail-calls it; every later call is a plain load plus indirect call.
+ *
+ * @code
+ *     struct KickResolver
+ *     {
+ *         static zycore::Optional<uintptr_t> resolve() { return mainModule.symbol("kick"); }
+ *     };
+ *     LazyFunction<void(*)(int), KickResolver> kick;
+ *     kick(7);
+ * @endcode
+ *
+ * The binding is global per `T` and `ResolverT`, all instances are views onto the same cache.
+ * Calling a function whose resolver failed is invalid; use `resolve()` to check up front.
+ */
+template<typename T, typename ResolverT>
+class LazyFunction
+{
+    static_assert(zycore::BlackBoxConsts<T>::kFalse,
+        "LazyFunction expects a function pointer definition as template parameter");
+};
+
+/**
+ * @internal
+ * @brief   A macro that defines a `LazyFunction` implementation for a given calling convention.
+ * @param   callingConv The calling convention.
+ */
+#define REMODEL_DEF_LAZY_FUNCTION(callingConv)                                                     \
+    template<typename ResolverT, typename RetT, typename... ArgsT>                                 \
+    class LazyFunction<RetT (callingConv*)(ArgsT...), ResolverT>                                   \
+    {                                                                                              \
+    public:                                                                                        \
+        using FunctionPtr = RetT(callingConv*)(ArgsT...);                                          \
+    private:                                                                                       \
+        enum : uint8_t                                                                             \
+        {                                                                                          \
+            kUnresolved,                                                                           \
+            kResolving,                                                                            \
+            kResolved,                                                                             \
+        };                                                                                         \
+                                                                                                   \
+        static std::atomic<FunctionPtr> s_ptr;                                                     \
+        static std::atomic<void*> s_target;                                                        \
+        static std::atomic<uint8_t> s_state;                                                       \
+                                                                                                   \
+        static void* target()                                                                      \
+        {                                                                                          \
+            auto state = static_cast<uint8_t>(kUnresolved);                                        \
+            if (s_state.compare_exchange_strong(state, kResolving, std::memory_order_acquire))     \
+            {                                                                                      \
+                auto address = internal::lazyAddressOf(ResolverT::resolve());                      \
+                s_target.store(address, std::memory_order_release);                                \
+                if (address) s_ptr.store((FunctionPtr)address, std::memory_order_release);         \
+                s_state.store(kResolved, std::memory_order_release);                               \
+            }                                                                                      \
+            else                                                                                   \
+            {                                                                                      \
+                while (s_state.load(std::memory_order_acquire) != kResolved)                       \
+                {                                                                                  \
+                    std::this_thread::yield();                                                     \
+                }                                                                                  \
+            }                                                                                      \
+            return s_target.load(std::memory_order_acquire);                                       \
+        }                                                                                          \
+                                                                                                   \
+        static RetT callingConv stub(ArgsT... args)                                                \
+        {                                                                                          \
+            return ((FunctionPtr)target())(std::forward<ArgsT>(args)...);                          \
+        }                                                                                          \
+    public:                                                                                        \
+        static FunctionPtr stubPtr() { return &stub; }                                             \
+                                                                                                   \
+        static bool resolve() { return target() != nullptr; }                                      \
+                                                                                                   \
+        static bool isResolved() { return s_state.load(std::memory_order_acquire) == kResolved; }  \
+                                                                                                   \
+        FunctionPtr get() const { return s_ptr.load(std::memory_order_acquire); }                  \
+                                                                                                   \
+        template<typename... CallArgsT>                                                            \
+        RetT operator () (CallArgsT&&... args) const                                               \
+        {                                                                                          \
+            return get()(std::forward<CallArgsT>(args)...);                                        \
+        }                                                                                          \
+    };                                                                                             \
+                                                                                                   \
+    template<typename ResolverT, typename RetT, typename... ArgsT>                                 \
+    std::atomic<RetT(callingConv*)(ArgsT...)>                                                      \
+        LazyFunction<RetT (callingConv*)(ArgsT...), ResolverT>::s_ptr{                             \
+            &LazyFunction<RetT (callingConv*)(ArgsT...), ResolverT>::stub};                        \
+    template<typename ResolverT, typename RetT, typename... ArgsT>                                 \
+    std::atomic<void*> LazyFunction<RetT (callingConv*)(ArgsT...), ResolverT>::s_target{nullptr};  \
+    template<typename ResolverT, typename RetT, typename... ArgsT>                                 \
+    std::atomic<uint8_t> LazyFunction<RetT (callingConv*)(ArgsT...), ResolverT>::s_state{          \
+        kUnresolved}
+
+#ifdef ZYCORE_MSVC
+    REMODEL_DEF_LAZY_FUNCTION(__cdecl);
+    REMODEL_DEF_LAZY_FUNCTION(__stdcall);
+    REMODEL_DEF_LAZY_FUNCTION(__thiscall);
+    REMODEL_DEF_LAZY_FUNCTION(__fastcall);
+    REMODEL_DEF_LAZY_FUNCTION(__vectorcall);
+#elif defined(ZYCORE_GNUC)
+#   if defined(__i386__)
+    REMODEL_DEF_LAZY_FUNCTION(__attribute__((cdecl)));
+    REMODEL_DEF_LAZY_FUNCTION(__attribute__((stdcall)));
+    REMODEL_DEF_LAZY_FUNCTION(__attribute__((fastcall)));
+    REMODEL_DEF_LAZY_FUNCTION(__attribute__((thiscall)));
+#   else
+    REMODEL_DEF_LAZY_FUNCTION();
+#   endif
+#   if defined(__clang__) && (defined(__i386__) || (defined(_WIN32) && defined(__x86_64__)))
+    REMODEL_DEF_LAZY_FUNCTION(__attribute__((vectorcall)));
+#   endif
+#endif
+
+#undef REMODEL_DEF_LAZY_FUNCTION
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_MODULE_HPP
@@ -0,0 +1,454 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_PROFILE_HPP
+#define REMODEL_PROFILE_HPP
+
+/**
+ * @file
+ * @brief Contains the per-field access counters of the `REMODEL_PROFILE` mode.
+ *
+ * Defining `REMODEL_PROFILE` (globally, for every translation unit) makes each access of a
+ * field and each call of a function wrapper bump a per-thread counter keyed by the wrapper type
+ * and the accessed offset. `profile::collect` aggregates the counters of all threads, which can
+ * then be exported via `profile::toCsv` or `profile::toChromeTrace`:
+ * @code
+ *     runScenario();
+ *     auto entries = profile::collect(); // hottest first
+ *     std::ofstream{"fields.csv"} << profile::toCsv(entries);
+ * @endcode
+ *
+ * Without `REMODEL_PROFILE`, the hooks expand to nothing and none of this is defined.
+ */
+
+#include "zycore/Utils.hpp"
+
+#if defined(REMODEL_PROFILE)
+#   include <stdint.h>
+#   include <algorithm>
+#   include <atomic>
+#   include <cstddef>
+#   include <cstdio>
+#   include <functional>
+#   include <map>
+#   include <mutex>
+#   include <string>
+#   include <tuple>
+#   include <unordered_map>
+#   include <utility>
+#   include <vector>
+
+    /**
+     * @internal
+     * @brief   Records the type name of a wrapper, used in the wrapper constructors.
+     */
+#   define REMODEL_PROFILE_NAME(classname)                                                        \
+        this->m_profileName = #classname;
+    /**
+     * @internal
+     * @brief   Counts an access of a field of @c wrapper at @c ptr.
+     */
+#   define REMODEL_PROFILE_FIELD(wrapper, ptr)                                                    \
+        ::remodel::internal::FieldBase::profileField(wrapper, ptr)
+    /**
+     * @internal
+     * @brief   Counts a call of the function at @c code, a member of @c wrapper if non-null.
+     */
+#   define REMODEL_PROFILE_CALL(wrapper, code)                                                    \
+        ::remodel::internal::FieldBase::profileCall(wrapper, code)
+    /**
+     * @internal
+     * @brief   Counts the construction of a field storing @c getterSize bytes of `PtrGetter`.
+     */
+#   define REMODEL_PROFILE_FIELD_INIT(getterSize)                                                 \
+        ::remodel::internal::FieldBase::profileFieldInit(getterSize)
+#else
+#   define REMODEL_PROFILE_NAME(classname)
+#   define REMODEL_PROFILE_FIELD(wrapper, ptr)
+#   define REMODEL_PROFILE_CALL(wrapper, code)
+#   define REMODEL_PROFILE_FIELD_INIT(getterSize)
+#endif
+
+#if defined(REMODEL_PROFILE)
+
+namespace remodel
+{
+namespace profile
+{
+
+// ---------------------------------------------------------------------------------------------- //
+// [Entry]                                                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   The kinds of counted accesses.
+ */
+enum class AccessKind : uint8_t
+{
+    /**
+     * @brief   An access of a field.
+     */
+    Field,
+    /**
+     * @brief   A call of a `Function`, `MemberFunction` or `VirtualFunction`.
+     */
+    Call,
+};
+
+/**
+ * @brief   The aggregated counter of an accessed location.
+ */
+struct Entry
+{
+    /**
+     * @brief   The kind of the accesses.
+     */
+    AccessKind kind;
+    /**
+     * @brief   The type name of the wrapper, empty for fields and functions without a parent.
+     */
+    std::string wrapper;
+    /**
+     * @brief   For fields, the offset relative to the wrapped object, or the absolute address for
+     *          fields without a parent. For calls, the address of the called code.
+     */
+    std::ptrdiff_t offset;
+    /**
+     * @brief   The number of accesses.
+     */
+    uint64_t count;
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   The key of a counter. Wrapper names are compared by address here, as the same name
+ *          may have distinct addresses in different translation units, `collect` merges them.
+ */
+struct CounterKey
+{
+    const char* wrapper;
+    std::ptrdiff_t offset;
+    AccessKind kind;
+
+    bool operator == (const CounterKey& other) const
+    {
+        return wrapper == other.wrapper && offset == other.offset && kind == other.kind;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Hash functor for `CounterKey`s.
+ */
+struct CounterKeyHash
+{
+    std::size_t operator () (const CounterKey& key) const
+    {
+        auto hash = std::hash<const void*>{}(key.wrapper);
+        hash ^= std::hash<std::ptrdiff_t>{}(key.offset) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+        return hash ^ static_cast<std::size_t>(key.kind);
+    }
+};
+
+using CounterMap = std::unordered_map<CounterKey, std::atomic<uint64_t>, CounterKeyHash>;
+
+class ThreadCounters;
+
+/**
+ * @internal
+ * @brief   Registry of the counters of all threads.
+ */
+class CounterRegistry : public zycore::NonCopyable
+{
+    friend class ThreadCounters;
+
+    std::mutex m_mutex;
+    std::vector<ThreadCounters*> m_threads;
+    std::unordered_map<CounterKey, uint64_t, CounterKeyHash> m_retired;
+
+    CounterRegistry() = default;
+public:
+    /**
+     * @brief   Gets the global instance.
+     * @return  The instance.
+     */
+    static CounterRegistry& global()
+    {
+        static CounterRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief   Invokes a visitor for all counters, under the registry lock.
+     * @param   visitor The visitor, invoked with the key and the current count.
+     */
+    template<typename VisitorT>
+    void visit(VisitorT&& visitor);
+
+    /**
+     * @brief   Zeroes all counters.
+     */
+    void reset();
+};
+
+/**
+ * @internal
+ * @brief   The counters of a thread.
+ *
+ * Only the owning thread inserts counters, so it looks them up without locking, insertions and
+ * readers from other threads are serialized by the mutex. Counters are never erased, and the
+ * nodes of an `unordered_map` stay put on rehashes, so the last used counter is cached.
+ */
+class ThreadCounters : public zycore::NonCopyable
+{
+    friend class CounterRegistry;
+
+    std::mutex m_mutex;
+    CounterMap m_counters;
+    CounterKey m_lastKey{nullptr, 0, AccessKind::Field};
+    std::atomic<uint64_t>* m_lastCounter = nullptr;
+public:
+    ThreadCounters()
+    {
+        auto& registry = CounterRegistry::global();
+        std::lock_guard<std::mutex> lock{registry.m_mutex};
+        registry.m_threads.push_back(this);
+    }
+
+    ~ThreadCounters()
+    {
+        auto& registry = CounterRegistry::global();
+        std::lock_guard<std::mutex> lock{registry.m_mutex};
+        for (const auto& counter : m_counters)
+        {
+            registry.m_retired[counter.first] += counter.second.load(std::memory_order_relaxed);
+        }
+        registry.m_threads.erase(
+            std::find(registry.m_threads.begin(), registry.m_threads.end(), this));
+    }
+
+    /**
+     * @brief   Gets the counters of the calling thread.
+     * @return  The counters.
+     */
+    static ThreadCounters& current()
+    {
+        static thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    /**
+     * @brief   Increments the counter of a key.
+     * @param   key The key.
+     */
+    void bump(const CounterKey& key)
+    {
+        if (!m_lastCounter || !(key == m_lastKey))
+        {
+            auto it = m_counters.find(key);
+            if (it == m_counters.end())
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                it = m_counters.emplace(std::piecewise_construct,
+                    std::forward_as_tuple(key), std::forward_as_tuple(0)).first;
+            }
+            m_lastKey     = key;
+            m_lastCounter = &it->second;
+        }
+        // Only this thread writes, so a relaxed load and store suffice (and are way cheaper
+        // than a locked increment).
+        m_lastCounter->store(
+            m_lastCounter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
+
+template<typename VisitorT>
+inline void CounterRegistry::visit(VisitorT&& visitor)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (const auto& counter : m_retired) visitor(counter.first, counter.second);
+    for (auto thread : m_threads)
+    {
+        std::lock_guard<std::mutex> threadLock{thread->m_mutex};
+        for (const auto& counter : thread->m_counters)
+        {
+            visitor(counter.first, counter.second.load(std::memory_order_relaxed));
+        }
+    }
+}
+
+inline void CounterRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_retired.clear();
+    for (auto thread : m_threads)
+    {
+        std::lock_guard<std::mutex> threadLock{thread->m_mutex};
+        for (auto& counter : thread->m_counters) counter.second.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @internal
+ * @brief   Counts an access.
+ * @param   kind    The kind of the access.
+ * @param   wrapper The type name of the wrapper or @c nullptr.
+ * @param   offset  The offset, see `Entry::offset`.
+ */
+inline void recordAccess(AccessKind kind, const char* wrapper, std::ptrdiff_t offset)
+{
+    ThreadCounters::current().bump({wrapper, offset, kind});
+}
+
+/**
+ * @internal
+ * @brief   Tally of the fields constructed while it is active on a thread, see `stats`.
+ */
+struct FieldCensus
+{
+    std::size_t numFields = 0;
+    std::size_t getterBytes = 0;
+
+    /**
+     * @brief   Gets the census active on the calling thread.
+     * @return  The census, or @c nullptr if fields aren't counted.
+     */
+    static FieldCensus*& active()
+    {
+        static thread_local FieldCensus* census = nullptr;
+        return census;
+    }
+};
+
+/**
+ * @internal
+ * @brief   Formats an offset as (signed) hex number.
+ */
+inline std::string formatOffset(std::ptrdiff_t offset)
+{
+    char buffer[2 + 2 + 2 * sizeof(offset) + 1];
+    const auto magnitude = offset < 0
+        ? 0 - static_cast<unsigned long long>(offset) : static_cast<unsigned long long>(offset);
+    std::snprintf(buffer, sizeof(buffer), "%s0x%llx", offset < 0 ? "-" : "", magnitude);
+    return buffer;
+}
+
+/**
+ * @internal
+ * @brief   Gets the name of an access kind, as used in the exports.
+ */
+inline const char* kindName(AccessKind kind)
+{
+    return kind == AccessKind::Call ? "call" : "field";
+}
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [collect] + [reset] + exports                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Aggregates the counters of all threads, including exited ones.
+ * @return  The non-zero counters, sorted by count in descending order.
+ */
+inline std::vector<Entry> collect()
+{
+    std::map<std::tuple<AccessKind, std::string, std::ptrdiff_t>, uint64_t> merged;
+    internal::CounterRegistry::global().visit(
+        [&](const internal::CounterKey& key, uint64_t count)
+        {
+            if (count) merged[std::make_tuple(key.kind, key.wrapper ? key.wrapper : "", key.offset)]
+                += count;
+        });
+
+    std::vector<Entry> entries;
+    entries.reserve(merged.size());
+    for (const auto& counter : merged)
+    {
+        entries.push_back({std::get<0>(counter.first), std::get<1>(counter.first),
+            std::get<2>(counter.first), counter.second});
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    return entries;
+}
+
+/**
+ * @brief   Zeroes the counters of all threads.
+ */
+inline void reset()
+{
+    internal::CounterRegistry::global().reset();
+}
+
+/**
+ * @brief   Formats entries as CSV, with a `kind,wrapper,offset,count` header line.
+ * @param   entries The entries, see `collect`.
+ * @return  The CSV text.
+ */
+inline std::string toCsv(const std::vector<Entry>& entries)
+{
+    std::string csv = "kind,wrapper,offset,count\n";
+    for (const auto& entry : entries)
+    {
+        csv += internal::kindName(entry.kind);
+        csv += ',' + entry.wrapper + ',' + internal::formatOffset(entry.offset) + ',';
+        csv += std::to_string(entry.count) + '\n';
+    }
+    return csv;
+}
+
+/**
+ * @brief   Formats entries as Chrome trace (`chrome://tracing`, Perfetto), one counter event
+ *          named `wrapper+offset` per entry.
+ * @param   entries The entries, see `collect`.
+ * @return  The JSON text.
+ */
+inline std::string toChromeTrace(const std::vector<Entry>& entries)
+{
+    // Wrapper names are C++ identifiers, so there's nothing to escape.
+    std::string json = "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+        if (i) json += ',';
+        json += "{\"name\":\"" + entry.wrapper + '+' + internal::formatOffset(entry.offset);
+        json += "\",\"cat\":\"" + std::string{internal::kindName(entry.kind)};
+        json += "\",\"ph\":\"C\",\"ts\":0,\"pid\":0,\"args\":{\"count\":";
+        json += std::to_string(entry.count) + "}}";
+    }
+    return json + "]}";
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+} // namespace profile
+} // namespace remodel
+
+#endif // REMODEL_PROFILE
+
+#endif // REMODEL_PROFILE_HPP
@@ -0,0 +1,123 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief C++20 module interface unit exporting the library as `remodel`.
+ *
+ * The headers are parsed once when building this unit, importers only load the compiled
+ * interface. Macros can't cross a module boundary though, so translation units declaring
+ * wrappers via `REMODEL_WRAPPER` & co. still include `Remodel.hpp` (or the `remodel/` header
+ * they need). Enable the `REMODEL_MODULE` CMake option to build it.
+ */
+
+module;
+
+#include "../Remodel.hpp"
+
+export module remodel;
+
+export namespace remodel
+{
+
+// Wrappers
+using remodel::ClassWrapper;
+using remodel::LightClassWrapper;
+using remodel::AdvancedClassWrapper;
+using remodel::IsTriviallyRelocatable;
+using remodel::WeakWrapper;
+using remodel::Handle;
+using remodel::PtrRegion;
+using remodel::CompressedPtr;
+using remodel::TargetPtr;
+using remodel::Ptr32;
+using remodel::Ptr64;
+using remodel::WrapperRange;
+using remodel::wrapper_cast;
+using remodel::snapshot;
+using remodel::addressOfObj;
+using remodel::addressOfWrapper;
+
+// Pointer getters
+using remodel::OffsGetter;
+using remodel::StaticOffsGetter;
+using remodel::AbsGetter;
+using remodel::VfTableCache;
+using remodel::VfTableGetter;
+using remodel::Epoch;
+using remodel::EpochCache;
+using remodel::invalidateAll;
+using remodel::ChainGetter;
+using remodel::DynamicOffsGetter;
+using remodel::RefGetter;
+using remodel::RvaGetter;
+using remodel::LazyGetter;
+using remodel::resolveAll;
+
+// Fields
+using remodel::EndianValue;
+using remodel::BigEndian;
+using remodel::LittleEndian;
+using remodel::Field;
+using remodel::StaticField;
+using remodel::BitField;
+using remodel::StaticBitField;
+using remodel::AtomicField;
+using remodel::StaticAtomicField;
+using remodel::TrailingArray;
+using remodel::ClassView;
+using remodel::FieldInfo;
+using remodel::Layout;
+using remodel::forEachField;
+using remodel::prefetch;
+using remodel::load;
+using remodel::OptionalView;
+using remodel::LoadResult;
+using remodel::FieldSpan;
+using remodel::makeFieldSpan;
+
+// Functions
+using remodel::Function;
+using remodel::MemberFunction;
+using remodel::VirtualFunction;
+using remodel::VfIndexResolver;
+using remodel::LazyFunction;
+
+// Globals + modules
+using remodel::Global;
+using remodel::GlobalField;
+using remodel::ModuleRegistry;
+using remodel::Module;
+
+} // namespace remodel
+
+export namespace remodel::access
+{
+
+using remodel::access::Plain;
+using remodel::access::Volatile;
+using remodel::access::Relaxed;
+using remodel::access::Cached;
+using remodel::access::Unaligned;
+
+} // namespace remodel::access
@@ -0,0 +1,2258 @@
+/**
+ * This file is part of the remodel library (zyantific.com).
+ * 
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Hner (athre0z)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software 
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, 
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or 
+ * substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING 
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND 
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, 
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REMODEL_WRAPPER_HPP
+#define REMODEL_WRAPPER_HPP
+
+/**     
+ * @file
+ * @brief Contains the wrapper base classes, casts and the default pointer getters.
+ */
+
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+
+#include "zycore/Utils.hpp"
+#include "zycore/Optional.hpp"
+
+#include "Profile.hpp"
+#include "Checked.hpp"
+
+namespace remodel
+{
+
+namespace internal
+{
+    class FieldBase;
+    template<typename FieldT, typename = void> struct TryGetTraits;
+    using namespace zycore;
+} // namespace internal
+
+// We require that data-pointers are equal in size to code-pointers.
+static_assert(sizeof(void(*)()) == sizeof(void*), "unsupported platform");
+
+/**
+ * @brief   Hints that a condition usually holds, laying out its branch as the fall-through path.
+ * @param   cond    The condition.
+ */
+#if defined(ZYCORE_GNUC)
+#   define REMODEL_LIKELY(cond) __builtin_expect(!!(cond), 1)
+#else
+#   define REMODEL_LIKELY(cond) (cond)
+#endif
+
+/**
+ * @brief   Hints that a condition rarely holds, see `REMODEL_LIKELY`.
+ * @param   cond    The condition.
+ */
+#if defined(ZYCORE_GNUC)
+#   define REMODEL_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#else
+#   define REMODEL_UNLIKELY(cond) (cond)
+#endif
+
+// ============================================================================================== //
+// Base classes for wrapper classes                                                               //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [WrapperBase]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Common, non-polymorphic base of `ClassWrapper` and `LightClassWrapper`.
+ *          
+ * Fields refer to their parent through this type.
+ */
+class WrapperBase
+{
+    friend class FieldBase;
+protected:
+    void* m_raw = nullptr;
+#   if defined(REMODEL_PROFILE)
+    /**
+     * @brief   The type name of the wrapper, keying the access counters of its fields.
+     */
+    const char* m_profileName = nullptr;
+#   endif
+#   if defined(REMODEL_CHECKED)
+    /**
+     * @brief   The size of the wrapped object for the bounds checks, 0 if unknown.
+     */
+    std::size_t m_checkedSize = 0;
+#   endif
+
+    /**
+     * @internal
+     * @brief   Constructor.
+     * @param   raw The raw pointer of the wrapped object.
+     */
+    constexpr explicit WrapperBase(void* raw)
+        : m_raw{raw}
+    {}
+
+    /**
+     * @brief   Destructor.
+     */
+    ~WrapperBase() = default;
+public:
+    /**
+     * @brief   Copy constructor.
+     * @param   other   The instance to copy from.
+     */
+    WrapperBase(const WrapperBase& other) = default;
+
+    /**
+     * @brief   Assignment operator.
+     * @param   other   The instance to assign from.
+     * @return  `*this`.
+     */
+    WrapperBase& operator = (const WrapperBase& other) = default;
+
+    /**
+     * @brief   Address-of operator disabled to avoid confusion 
+     * @return  The result of the operation.
+     * Use `addressOfObj` and `addressOfWrapper` instead.
+     */
+    WrapperBase& operator & () = delete;
+
+    /**
+     * @brief   Obtains a raw pointer to the wrapped object.
+     * @return  The desired pointer.
+     */
+    // TODO: return a more concrete type here?
+    void* addressOfObj() { return m_raw; }
+
+    /**
+     * @brief   Obtains a const raw pointer to the wrapped object.
+     * @copydetails addressOfObj
+     */
+    const void* addressOfObj() const { return m_raw; }
+
+    /**
+     * @brief   Re-points the wrapper to another object.
+     * @param   raw The raw pointer of the new wrapped object.
+     *              
+     * Fields resolve their address relative to the raw pointer of their parent on each access, 
+     * so this is all that's required to reuse a wrapper for another object of the same type, 
+     * which is a lot cheaper than creating a new wrapper via `wrapper_cast`.
+     */
+    void rebind(void* raw) { m_raw = raw; }
+
+    /**
+     * @brief   Reads a field, following pointer fields without trusting them.
+     * @param   field   Pointer to the field, e.g. `&Dog::owner`.
+     * @return  For pointer fields, the result of their `tryGet`, else the value of the field.
+     * @see     OptionalView
+     */
+    template<typename WrapperT, typename FieldT>
+    auto tryGet(FieldT WrapperT::* field) const
+    {
+        return TryGetTraits<FieldT>::get(static_cast<const WrapperT*>(this)->*field);
+    }
+
+    // addressOfWrapper is implemented in the REMODEL_WRAPPER/REMODEL_ADV_WRAPPER macro.
+};
+
+} // namespace internal
+
+// ---------------------------------------------------------------------------------------------- //
+// [ClassWrapper]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Base class for class wrappers.
+ *
+ * Copying a wrapper copies the raw pointer, but also runs the initializers of all of its fields
+ * again. Wrappers copied in hot code (e.g. returned by value) are better derived from
+ * `LightClassWrapper`, whose copies are bytewise, or replaced with a `ClassView`.
+ */
+class ClassWrapper : public internal::WrapperBase
+{
+protected:
+    /**
+     * @internal
+     * @brief   Constructor.
+     * @param   raw The raw pointer of the wrapped object.
+     */
+    constexpr explicit ClassWrapper(void* raw)
+        : WrapperBase{raw}
+    {}
+public:
+    /**
+     * @brief   Destructor.
+     */
+    virtual ~ClassWrapper() = default;
+
+    /**
+     * @brief   Copy constructor.
+     * @param   other   The instance to copy from.
+     */
+    ClassWrapper(const ClassWrapper& other)
+        : WrapperBase{other}
+    {}
+
+    /**
+     * @brief   Assignment operator.
+     * @param   other   The instance to assign from.
+     * @return  `*this`.
+     */
+    ClassWrapper& operator = (const ClassWrapper& other)
+    {
+        m_raw = other.m_raw;
+        return *this;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [LightClassWrapper]                                                                            //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Non-polymorphic base class for class wrappers with trivial copy semantics.
+ *          
+ * Other than `ClassWrapper`, this class has no virtual destructor, so wrappers derived from it
+ * don't carry a vftable pointer and are trivially copy constructible and destructible (and thus
+ * passed and returned in registers where the ABI allows). Copying a light wrapper is a plain
+ * bytewise copy, which is only correct for fields that don't store a pointer to their parent,
+ * so light wrappers are restricted to `StaticField`s. Using any other field type in a light 
+ * wrapper deletes the copy constructor of the wrapper.
+ * 
+ * @code
+ *     class Dog : public LightClassWrapper
+ *     {
+ *         REMODEL_LIGHT_WRAPPER(Dog)
+ *     public:
+ *         StaticField<uint8_t, 124> age{this};
+ *         StaticField<bool, 125> hatesKittehz{this};
+ *     };
+ *     
+ *     std::vector<Dog> dogs; // as cheap as a vector of pointers
+ * @endcode
+ */
+class LightClassWrapper : public internal::WrapperBase
+{
+protected:
+    /**
+     * @internal
+     * @brief   Constructor.
+     * @param   raw The raw pointer of the wrapped object.
+     */
+    explicit LightClassWrapper(void* raw)
+        : WrapperBase{raw}
+    {}
+public:
+    /**
+     * @brief   Copy constructor.
+     * @param   other   The instance to copy from.
+     */
+    LightClassWrapper(const LightClassWrapper& other) = default;
+
+    /**
+     * @brief   Assignment operator.
+     * @param   other   The instance to assign from.
+     * @return  `*this`.
+     */
+    LightClassWrapper& operator = (const LightClassWrapper& other) = default;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [AdvancedClassWrapper] + helper classes                                                        //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Trait marking objects of a wrapper as trivially relocatable.
+ * @tparam  WrapperT    Type of the wrapper.
+ *                      
+ * Relocatable objects stay valid when their bytes are moved to another address with `memcpy`, 
+ * which holds unless they point into themselves or are referenced by address from elsewhere.
+ * `Instantiable`s of such wrappers can be moved, e.g. into a growing `std::vector`. Mark a 
+ * wrapper by declaring `using IsRelocatable = void;` in it or by specializing this template.
+ */
+template<typename WrapperT, typename = void>
+struct IsTriviallyRelocatable : std::false_type {};
+
+/**
+ * @brief   Trait implementation detecting the `IsRelocatable` marker.
+ * @copydetails IsTriviallyRelocatable
+ */
+template<typename WrapperT>
+struct IsTriviallyRelocatable<WrapperT, typename WrapperT::IsRelocatable> : std::true_type {};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   TMP helper type implementation that does nothing when called.
+ * @tparam  WrapperT        Type of the wrapper.
+ * @tparam  useCustomCtorT  `true` to call the custom constructor, `false` to do nothing.
+ * @tparam  ArgsT           Constructor argument types.
+ */
+template<typename WrapperT, bool useCustomCtorT, typename... ArgsT>
+struct InstantiableWrapperCtorCaller
+{
+    static void Call(WrapperT* /*thiz*/, ArgsT&&... /*args*/)
+    {
+        // default construction, just do nothing.
+    }
+};
+
+/**
+ * @internal
+ * @brief   TMP helper type implementation that calls the custom constructor.
+ * @copydetails InstantiableWrapperCtorCaller
+ */
+template<typename WrapperT, typename... ArgsT>
+struct InstantiableWrapperCtorCaller<WrapperT, true, ArgsT...>
+{
+    static void Call(WrapperT* thiz, ArgsT&&... args)
+    {
+        thiz->construct(std::forward<ArgsT>(args)...);
+    }
+};
+
+/**
+ * @brief   TMP helper type implementation that does nothing when called.
+ * @tparam  WrapperT        Type of the wrapper.
+ * @tparam  useCustomDtorT  `true` to call the custom constructor, `false` to do nothing.
+ */
+template<typename WrapperT, bool useCustomDtorT>
+struct InstantiableWrapperDtorCaller
+{
+    static void Call(WrapperT* /*thiz*/)
+    {
+        // default destruction, just do nothing.
+    }
+};
+
+/**
+ * @brief   TMP helper type implementation that calls the custom destructor.
+ * @copydetails InstantiableWrapperDtorCaller
+ */
+template<typename WrapperT>
+struct InstantiableWrapperDtorCaller<WrapperT, true>
+{
+    static void Call(WrapperT* thiz)
+    {
+        thiz->destruct();
+    }
+};
+
+/**
+ * @internal
+ * @brief   TMP tools determining whether a wrapper has custom `construct` and `destruct` routines.
+ * @tparam  WrapperT    Type of the wrapper.
+ */
+template<typename WrapperT>
+class InstantiableTraits
+{
+    /**
+     * @internal
+     * @brief   Marker type.
+     */
+    struct Yep {};
+
+    /**
+     * @internal
+     * @brief   Marker type.
+     */
+    struct Nope {};
+public:
+    /**
+     * @internal
+     * @brief   TMP tool determining if we should use default-construction for the wrapper.
+     */
+    class HasCustomCtor
+    {
+        template<typename C> static Yep  test(decltype(&C::construct));
+        template<typename C> static Nope test(...                    );
+    public:
+        static const bool Value = std::is_same<decltype(test<WrapperT>(nullptr)), Yep>::value;
+    };
+
+    /**
+     * @internal
+     * @brief   TMP tool determining if we should use default-destruction for the wrapper.
+     */
+    class HasCustomDtor
+    {
+        template<typename C> static Yep  test(decltype(&C::destruct));
+        template<typename C> static Nope test(...                   );
+    public:
+        static const bool Value = std::is_same<decltype(test<WrapperT>(nullptr)), Yep>::value;
+    };
+};
+
+/**
+ * @internal
+ * @brief   Default alignment of wrapped objects, derived from their size.
+ * @tparam  objSizeT    The size of the wrapped class, in bytes.
+ *          
+ * The size of an object is a multiple of its alignment, so the lowest set bit of the size is an 
+ * upper bound of it. Capped to the alignment of fundamental types, the most `new` guarantees.
+ */
+template<std::size_t objSizeT>
+struct DefaultObjAlign
+{
+    union Fundamental
+    {
+        long double a;
+        long long b;
+        void* c;
+        void (*d)();
+    };
+
+    static const std::size_t kLowestBit = objSizeT & (~objSizeT + 1);
+    static const std::size_t kMax = std::alignment_of<Fundamental>::value;
+    static const std::size_t value = !objSizeT ? 1 : (kLowestBit < kMax ? kLowestBit : kMax);
+};
+
+/**
+ * @brief   Template making wrapper types instantiable.
+ * @tparam  WrapperT    Wrapepr type.
+ *                      
+ * The object data is aligned to `WrapperT::kObjAlign`. Alignments above the one of fundamental 
+ * types are only guaranteed for instances outside the heap or in an `InstantiablePool`. Instances
+ * are movable if the wrapper is marked with `IsTriviallyRelocatable`.
+ */
+template<typename WrapperT>
+class InstantiableWrapper 
+    : public WrapperT
+    , public NonCopyable
+{
+    union
+    {
+        uint8_t m_data[WrapperT::kObjSize];
+        typename std::aligned_storage<1, WrapperT::kObjAlign>::type m_alignment;
+    };
+
+    bool m_live = true;
+
+    using HasCustomCtor = typename InstantiableTraits<WrapperT>::HasCustomCtor;
+    using HasCustomDtor = typename InstantiableTraits<WrapperT>::HasCustomDtor;
+public:
+    /**
+     * @brief   Constructor.
+     * @tparam  ArgsT   Constructor argument types.
+     * @param   args    Arguments passed to the `construct` routine.
+     *                          
+     * If no custom `construct` routine is defined in the wrapper, an empty argument list is 
+     * expected. The default `construct` routine does nothing.
+     */
+    template<typename... ArgsT>
+    explicit InstantiableWrapper(ArgsT&&... args)
+        : WrapperT{&m_data}
+    {
+        InstantiableWrapperCtorCaller<
+            WrapperT, HasCustomCtor::Value, ArgsT...
+            >::Call(this, std::forward<ArgsT>(args)...);
+    }
+
+    /**
+     * @brief   Move constructor, relocating the object with `memcpy`.
+     * @param   other   The instance to move from, left without an object.
+     *                  
+     * Neither routine runs, the object just changes its address. Only available for wrappers 
+     * marked with `IsTriviallyRelocatable`.
+     */
+    InstantiableWrapper(InstantiableWrapper&& other)
+        : WrapperT{&m_data}
+        , m_live{other.m_live}
+    {
+        static_assert(IsTriviallyRelocatable<WrapperT>::value, 
+            "Instantiables can only be moved for wrappers marked as trivially relocatable");
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+        other.m_live = false;
+    }
+
+    /**
+     * @brief   Move assignment operator, destructs the current object and relocates the other.
+     * @param   other   The instance to move from, left without an object.
+     * @return  `*this`.
+     */
+    InstantiableWrapper& operator = (InstantiableWrapper&& other)
+    {
+        static_assert(IsTriviallyRelocatable<WrapperT>::value, 
+            "Instantiables can only be moved for wrappers marked as trivially relocatable");
+        if (std::addressof(other) != this)
+        {
+            if (m_live) InstantiableWrapperDtorCaller<WrapperT, HasCustomDtor::Value>::Call(this);
+            std::memcpy(m_data, other.m_data, sizeof(m_data));
+            m_live = other.m_live;
+            other.m_live = false;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief   Destructor.
+     *          
+     * If no custom `destruct` routine is defined in the wrapper, a default `destruct` routine is
+     * generated that does nothing. Instances moved from don't run it.
+     */
+    ~InstantiableWrapper()
+    {
+        if (m_live) InstantiableWrapperDtorCaller<WrapperT, HasCustomDtor::Value>::Call(this);
+    }
+};
+
+/**
+ * @brief   Template creating wrappers for local copies of wrapped objects.
+ * @tparam  WrapperT    Wrapper type.
+ *                      
+ * Just like `InstantiableWrapper`, this class extends the wrapper with memory holding the data of
+ * the object, but fills it with a bytewise copy of an existing object instead of constructing 
+ * a new one. Neither `construct` nor `destruct` routines are called.
+ */
+template<typename WrapperT>
+class SnapshotWrapper : public WrapperT
+{
+    union
+    {
+        uint8_t m_data[WrapperT::kObjSize];
+        typename std::aligned_storage<1, WrapperT::kObjAlign>::type m_alignment;
+    };
+    const void* m_source;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   source  Pointer to the object to copy.
+     */
+    explicit SnapshotWrapper(const void* source)
+        : WrapperT{&m_data}
+        , m_source{source}
+    {
+        refresh();
+    }
+
+    /**
+     * @brief   Copy constructor.
+     * @param   other   The instance to copy from.
+     */
+    SnapshotWrapper(const SnapshotWrapper& other)
+        : WrapperT{&m_data}
+        , m_source{other.m_source}
+    {
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Assignment operator.
+     * @param   other   The instance to assign from.
+     * @return  `*this`.
+     */
+    SnapshotWrapper& operator = (const SnapshotWrapper& other)
+    {
+        m_source = other.m_source;
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+        return *this;
+    }
+
+    /**
+     * @brief   Updates the snapshot with the current state of the source object.
+     */
+    void refresh()
+    {
+        std::memcpy(m_data, m_source, sizeof(m_data));
+    }
+
+    /**
+     * @brief   Gets the address of the object this snapshot was created from.
+     * @return  The address of the source object.
+     */
+    const void* source() const { return m_source; }
+};
+
+} // namespace internal
+
+/**
+ * @brief   Advanced version of the base class for wrappers.
+ * @tparam  objSizeT    The size of the wrapped class, in bytes.
+ * @tparam  objAlignT   The alignment of the wrapped class, in bytes. Defaults to the largest 
+ *                      power of two dividing the size, up to the alignment of fundamental types.
+ *                      
+ * Local copies of the object (`Instantiable`, `Snapshot`) store its data with that alignment, 
+ * so aligned loads of its fields don't split cache lines.
+ * @code
+ *     class Particle : public AdvancedClassWrapper<32, 16>
+ *     {
+ *         REMODEL_ADV_WRAPPER(Particle)
+ *     public:
+ *         Field<float[4]> position{this, 0};
+ *         Field<float[4]> velocity{this, 16};
+ *     };
+ *     
+ *     Particle::Instantiable particle;
+ *     _mm_store_ps(particle.position, _mm_load_ps(particle.velocity));
+ * @endcode
+ */
+template<std::size_t objSizeT, std::size_t objAlignT = internal::DefaultObjAlign<objSizeT>::value>
+class AdvancedClassWrapper : public ClassWrapper
+{
+    static_assert(objAlignT && !(objAlignT & (objAlignT - 1)), "alignment must be a power of two");
+protected:
+    explicit AdvancedClassWrapper(void* raw)
+        : ClassWrapper{raw}
+    {
+#       if defined(REMODEL_CHECKED)
+            this->m_checkedSize = objSizeT;
+#       endif
+    }
+public:
+    using IsAdvWrapper = void;
+
+    static const std::size_t kObjSize = objSizeT;
+    static const std::size_t kObjAlign = objAlignT;
+
+    AdvancedClassWrapper(const AdvancedClassWrapper& other)
+        : ClassWrapper{other}
+    {}
+
+    AdvancedClassWrapper& operator = (const AdvancedClassWrapper& other)
+    { 
+        this->ClassWrapper::operator = (other); 
+        return *this; 
+    }
+};
+
+/**
+ * @internal
+ * @brief   Macro forwarding constructors and implementing other wrapper logic required.
+ * @param   classname   The class name of the wrapper.
+ * @param   base        The wrapper base class that is derived from.
+ */
+#define REMODEL_WRAPPER_IMPL(classname, base)                                                      \
+    protected:                                                                                     \
+        template<typename WrapperT>                                                                \
+        friend WrapperT remodel::wrapper_cast(void *raw);                                          \
+        explicit classname(void* raw)                                                              \
+            : base(raw) /* MSVC12 requires parentheses here */ { REMODEL_PROFILE_NAME(classname) } \
+    public:                                                                                        \
+        classname(const classname& other)                                                          \
+            : base(other) /* MSVC12 requires parentheses here */ {}                                \
+        classname& operator = (const classname& other)                                             \
+            { this->base::operator = (other); return *this; }                                      \
+        /* allow field access via -> (required to allow -> on wrapped struct fields) */            \
+        classname* operator -> () { return this; }                                                 \
+        classname* addressOfWrapper() { return this; }                                             \
+        const classname* addressOfWrapper() const { return this; }                                 \
+    private:
+
+/**
+ * @brief   Macro forwarding constructors and implementing other wrapper logic required.
+ * @param   classname   The class name of the wrapper.
+ * @see     ClassWrapper
+ */
+#define REMODEL_WRAPPER(classname)                                                                 \
+    REMODEL_WRAPPER_IMPL(classname, ClassWrapper)
+
+/**
+ * @brief   Macro forwarding constructors and implementing other wrapper logic required.
+ * @param   classname   The class name of the wrapper.
+ * @see     LightClassWrapper
+ */
+#define REMODEL_LIGHT_WRAPPER(classname)                                                           \
+    protected:                                                                                     \
+        template<typename WrapperT>                                                                \
+        friend WrapperT remodel::wrapper_cast(void *raw);                                          \
+        explicit classname(void* raw)                                                              \
+            : LightClassWrapper(raw) /* MSVC12 requires parentheses here */                        \
+            { REMODEL_PROFILE_NAME(classname) }                                                    \
+    public:                                                                                        \
+        classname(const classname& other) = default;                                               \
+        /* fields stay valid, so assignment just needs to rebind the raw pointer */                \
+        classname& operator = (const classname& other)                                             \
+            { this->LightClassWrapper::operator = (other); return *this; }                         \
+        classname* operator -> () { return this; }                                                 \
+        classname* addressOfWrapper() { return this; }                                             \
+        const classname* addressOfWrapper() const { return this; }                                 \
+    private:
+
+/**
+ * @brief   Macro forwarding constructors and implementing other wrapper logic required.
+ * @param   classname   The class name of the wrapper.
+ * @see     AdvancedClassWrapper
+ */
+#define REMODEL_ADV_WRAPPER(classname)                                                             \
+    REMODEL_WRAPPER_IMPL(classname, AdvancedClassWrapper)                                          \
+    public:                                                                                        \
+        using Instantiable = internal::InstantiableWrapper<classname>;                             \
+        using Snapshot = internal::SnapshotWrapper<classname>;                                     \
+        using Compact = internal::CompactWrapper<classname>;                                       \
+        using Weak = WeakWrapper<classname>;                                                       \
+    public:                                                                                        \
+        Weak* weakPtr() { return reinterpret_cast<Weak*>(this->addressOfObj()); }                  \
+        /* runs the construct/destruct routines over memory we didn't allocate */                  \
+        template<typename... ArgsT>                                                                \
+        static classname constructAt(void* mem, ArgsT&&... args)                                   \
+        {                                                                                          \
+            return remodel::internal::constructAt<classname>(mem, std::forward<ArgsT>(args)...);   \
+        }                                                                                          \
+        static void destructAt(void* mem) { remodel::internal::destructAt<classname>(mem); }       \
+    private:
+
+// ============================================================================================== //
+// Casting function(s) and out-of-class "operators"                                               //
+// ============================================================================================== //
+
+/**
+ * @brief   Creates a wrapper from a "raw" void pointer.
+ * @tparam  WrapperT    The wrapper type to create.
+ * @param   raw         The raw pointer to create the wrapper from.
+ * @note    The naming convention violated here because, well, casts should look this way.
+ * @return  The resulting wrapper.
+ */
+template<typename WrapperT>
+inline WrapperT wrapper_cast(void* raw)
+{
+    WrapperT nrvo{raw};
+    return nrvo;
+}
+
+/**
+ * @brief   Creates a wrapper from a "raw" pointer in `uintptr_t` representation.
+ * @copydetails wrapper_cast(void*)
+ */
+template<typename WrapperT>
+inline WrapperT wrapper_cast(uintptr_t raw)
+{
+    WrapperT nrvo{wrapper_cast<WrapperT>(reinterpret_cast<void*>(raw))};
+    return nrvo;
+}
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Runs the `construct` routine of a wrapper over existing memory.
+ * @tparam  WrapperT    The wrapper type.
+ * @tparam  ArgsT       Constructor argument types.
+ * @param   mem         The memory to construct the object in, `WrapperT::kObjSize` bytes.
+ * @param   args        Arguments passed to the `construct` routine.
+ * @return  A wrapper for the object.
+ */
+template<typename WrapperT, typename... ArgsT>
+inline WrapperT constructAt(void* mem, ArgsT&&... args)
+{
+    WrapperT nrvo{wrapper_cast<WrapperT>(mem)};
+    InstantiableWrapperCtorCaller<
+        WrapperT, InstantiableTraits<WrapperT>::HasCustomCtor::Value, ArgsT...
+        >::Call(nrvo.addressOfWrapper(), std::forward<ArgsT>(args)...);
+    return nrvo;
+}
+
+/**
+ * @internal
+ * @brief   Runs the `destruct` routine of a wrapper over existing memory.
+ * @tparam  WrapperT    The wrapper type.
+ * @param   mem         The object to destruct.
+ */
+template<typename WrapperT>
+inline void destructAt(void* mem)
+{
+    auto wrapper = wrapper_cast<WrapperT>(mem);
+    InstantiableWrapperDtorCaller<
+        WrapperT, InstantiableTraits<WrapperT>::HasCustomDtor::Value
+        >::Call(wrapper.addressOfWrapper());
+}
+
+} // namespace internal
+
+/**
+ * @brief   Creates a local copy of an object wrapped by an advanced wrapper.
+ * @tparam  WrapperT    The wrapper type, required to be derived from `AdvancedClassWrapper`.
+ * @param   wrapper     The wrapper of the object to copy.
+ * @return  A wrapper for the copy.
+ *          
+ * The whole object is copied with one `memcpy`, so reading many fields of the snapshot is a lot
+ * cheaper than reading each of them from the (possibly heavily contended) original. Writes to
+ * the snapshot don't affect the original object. Use `WrapperT::Snapshot::refresh` to update it.
+ */
+template<typename WrapperT>
+inline typename WrapperT::Snapshot snapshot(const WrapperT& wrapper)
+{
+    typename WrapperT::Snapshot nrvo{wrapper.addressOfObj()};
+    return nrvo;
+}
+
+/**
+ * @brief   Obtains the address of an object wrapped by this field/wrapper.
+ * @tparam  WrapperT    Type of the wrapper.
+ * @param   wrapper     The wrapper.
+ * @return  The address of the wrapped object.
+ */
+template<typename WrapperT>
+inline zycore::CloneConst<WrapperT, void>* addressOfObj(WrapperT& wrapper)
+{
+    static_assert(std::is_base_of<internal::WrapperBase, WrapperT>::value
+        || std::is_base_of<internal::FieldBase, WrapperT>::value,
+        "addressOfObj is only supported for class-wrappers");
+
+    return wrapper.addressOfObj();
+}
+
+/**
+ * @brief   Obtains the address of a field/wrapper (NOT of the wrapped object).
+ * @tparam  WrapperT    Type of the wrapper.
+ * @param   wrapper     The wrapper.
+ * @return  The address of the wrapper.
+ */
+template<typename WrapperT>
+inline WrapperT* addressOfWrapper(WrapperT& wrapper)
+{
+    static_assert(std::is_base_of<internal::WrapperBase, WrapperT>::value
+        || std::is_base_of<internal::FieldBase, WrapperT>::value,
+        "addressOfWrapper is only supported for class-wrappers and fields");
+
+    return wrapper.addressOfWrapper();
+}
+
+// ============================================================================================== //
+// Default PtrGetter implementations                                                              //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [OffsGetter]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor adding an offset to the passed raw address.
+ */
+class OffsGetter
+{
+    std::ptrdiff_t m_offs;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   offs    The offset to apply to the raw pointer.
+     * @todo    `std::ptrdiff_t` is not perfect here (consider envs using `Global` and /3GB on 
+     *          windows), find a better type.
+     */
+    explicit OffsGetter(std::ptrdiff_t offs)
+        : m_offs{offs}
+    {}
+
+    /**
+     * @brief   Gets the offset applied to the raw pointer.
+     * @return  The offset.
+     */
+    std::ptrdiff_t offset() const { return m_offs; }
+
+    void* operator () (void* raw) const
+    {
+        return reinterpret_cast<void*>(
+            reinterpret_cast<uintptr_t>(raw) + m_offs
+            );
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [StaticOffsGetter]                                                                             //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor adding a compile-time offset to the passed raw address.
+ * @tparam  offsT   The offset to apply to the raw pointer.
+ *
+ * Other than `OffsGetter`, this functor is stateless, allowing the compiler to fold the address
+ * calculation right into the access.
+ */
+template<std::ptrdiff_t offsT>
+class StaticOffsGetter
+{
+public:
+    static const std::ptrdiff_t kOffs = offsT;
+
+    void* operator () (void* raw) const
+    {
+        return reinterpret_cast<void*>(
+            reinterpret_cast<uintptr_t>(raw) + offsT
+            );
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [AbsGetter]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor ignoring the passed raw address, always returning a fixed address.
+ */
+class AbsGetter
+{
+    void* m_ptr;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   ptr The pointer to return on calls (ignoring the raw pointer).
+     */
+    constexpr explicit AbsGetter(void* ptr)
+        : m_ptr{ptr}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   ptr The pointer to return on calls (ignoring the raw pointer) in `uint` 
+     *              representation.
+     */
+    explicit AbsGetter(uintptr_t ptr)
+        : AbsGetter{reinterpret_cast<void*>(ptr)}
+    {}
+
+    void* operator () (void*) const
+    {
+        return m_ptr;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [VfTableGetter]                                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Vftable-pointer of a wrapped object, shared by all `VirtualFunction`s of a wrapper 
+ *          using that vftable.
+ *          
+ * Declare it as a member of the wrapper, before the virtual functions using it:
+ * @code
+ *     VfTableCache vftable{0, VfTableCache::Mode::AssumeStable}; // at offset 0
+ *     VirtualFunction<int (*)()> calculateFluffiness{this, vftable, 0}; // first entry
+ *     VirtualFunction<void (*)(int)> giveGoodie{this, vftable, 1};
+ * @endcode
+ * 
+ * In `Checked` mode, the object's vftable-pointer is still read on every call, but the virtual 
+ * functions only read their table entry again when it changed. In `AssumeStable` mode, the 
+ * vftable-pointer is only read again when the wrapper is rebound to another object, so calls
+ * don't touch the object at all; this is only correct if nothing replaces the object's 
+ * vftable-pointer while it is wrapped (such as constructors, destructors or hooks).
+ *     
+ * @note    The cache is not synchronized, don't share a wrapper between threads.
+ */
+class VfTableCache
+{
+public:
+    /**
+     * @brief   Values that represent how the vftable-pointer is validated.
+     */
+    enum class Mode
+    {
+        Checked,
+        AssumeStable,
+    };
+private:
+    std::size_t m_vftableOffset;
+    Mode m_mode;
+    mutable const void* m_raw = nullptr;
+    mutable const void* const* m_vftable = nullptr;
+    mutable uint32_t m_generation = 0;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   vftableOffset   Offset of the vftable-pointer in the class.
+     * @param   mode            How the vftable-pointer is validated.
+     */
+    explicit VfTableCache(std::size_t vftableOffset = 0, Mode mode = Mode::Checked)
+        : m_vftableOffset{vftableOffset}
+        , m_mode{mode}
+    {}
+
+    /**
+     * @brief   Gets the vftable of an object.
+     * @param   raw The object.
+     * @return  The vftable.
+     */
+    const void* const* vftable(const void* raw) const
+    {
+        if (m_mode == Mode::AssumeStable && raw == m_raw && m_vftable) return m_vftable;
+        m_raw = raw;
+        return m_vftable = *reinterpret_cast<const void* const* const*>(
+            reinterpret_cast<uintptr_t>(raw) + m_vftableOffset);
+    }
+
+    /**
+     * @brief   Forgets the cached vftable-pointer and the entries remembered by the virtual
+     *          functions using the cache, required after the vftable-pointer was replaced in
+     *          `AssumeStable` mode or after entries of the vftable were changed.
+     */
+    void invalidate() const
+    {
+        m_vftable = nullptr;
+        ++m_generation;
+    }
+
+    /**
+     * @brief   Gets the number of `invalidate` calls, so getters can tell remembered entries 
+     *          are outdated.
+     * @return  The generation.
+     */
+    uint32_t generation() const { return m_generation; }
+
+    std::size_t vftableOffset() const { return m_vftableOffset; }
+    Mode mode() const { return m_mode; }
+};
+
+/**
+ * @brief   `PtrGetter` functor obtaining a function address using the virtual function table.
+ */
+class VfTableGetter
+{
+    std::size_t m_vftableIdx;
+    std::size_t m_vftableOffset;
+    const VfTableCache* m_cache = nullptr;
+    mutable const void* const* m_seenVftable = nullptr;
+    mutable uint32_t m_seenGeneration = 0;
+    mutable void* m_func = nullptr;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   vftableIdx      Index of the function inside the table.
+     * @param   vftableOffset   Offset of the vftable-pointer in the class.
+     */
+    explicit VfTableGetter(std::size_t vftableIdx, std::size_t vftableOffset = 0)
+        : m_vftableIdx   {vftableIdx}
+        , m_vftableOffset{vftableOffset}
+    {}
+
+    /**
+     * @brief   Constructor, obtaining the vftable through a cache and remembering the table entry 
+     *          for as long as the vftable doesn't change.
+     * @param   cache       The cache, must outlive the getter.
+     * @param   vftableIdx  Index of the function inside the table.
+     */
+    VfTableGetter(const VfTableCache& cache, std::size_t vftableIdx)
+        : m_vftableIdx   {vftableIdx}
+        , m_vftableOffset{cache.vftableOffset()}
+        , m_cache        {&cache}
+    {}
+
+    /**
+     * @brief   Gets the index of the function inside the table.
+     * @return  The index.
+     */
+    std::size_t vftableIdx() const { return m_vftableIdx; }
+
+    /**
+     * @brief   Gets the vftable of an object.
+     * @param   raw The object.
+     * @return  The vftable.
+     */
+    const void* const* vftable(const void* raw) const
+    {
+        if (m_cache) return m_cache->vftable(raw);
+        return *reinterpret_cast<const void* const* const*>(
+            reinterpret_cast<uintptr_t>(raw) + m_vftableOffset);
+    }
+
+    void* operator () (void* raw) const
+    {
+        if (m_cache)
+        {
+            const auto vftable = m_cache->vftable(raw);
+            if (vftable != m_seenVftable || m_cache->generation() != m_seenGeneration)
+            {
+                m_func = const_cast<void*>(vftable[m_vftableIdx]);
+                m_seenVftable = vftable;
+                m_seenGeneration = m_cache->generation();
+            }
+            return m_func;
+        }
+
+        return reinterpret_cast<void*>(
+            *reinterpret_cast<uintptr_t*>(
+                *reinterpret_cast<uintptr_t*>(
+                    reinterpret_cast<uintptr_t>(raw) + m_vftableOffset
+                ) 
+                + m_vftableIdx * sizeof(uintptr_t)
+            )
+        );
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [Epoch] + [EpochCache]                                                                         //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Generation counter used to invalidate cached resolutions (addresses, pointers, ...).
+ *          
+ * Caches stamp their values with the stamp of an epoch and re-resolve lazily once it changed, 
+ * see `EpochCache`. Besides the global epoch, which every cache depends on, epochs can be 
+ * created for separate domains (e.g. one per module or per hot-reloadable layout), so a domain
+ * can be invalidated without affecting unrelated caches.
+ * 
+ * @code
+ *     remodel::Epoch entityEpoch;
+ *     // ...
+ *     entityEpoch.bump();       // invalidates all caches using `entityEpoch`
+ *     remodel::invalidateAll(); // invalidates all caches
+ * @endcode
+ */
+class Epoch : public zycore::NonCopyable
+{
+    std::atomic<uint32_t> m_counter{1};
+public:
+    /**
+     * @brief   Gets the global epoch.
+     * @return  The global epoch.
+     */
+    static Epoch& global()
+    {
+        static Epoch global;
+        return global;
+    }
+
+    /**
+     * @brief   Gets the current generation of this epoch. Never 0.
+     * @return  The current generation.
+     */
+    uint32_t current() const { return m_counter.load(std::memory_order_acquire); }
+
+    /**
+     * @brief   Gets a stamp combining the current generation of this epoch with that of the
+     *          global epoch. Never 0.
+     * @return  The stamp.
+     */
+    uint64_t stamp() const
+    {
+        return static_cast<uint64_t>(global().current()) << 32 | current();
+    }
+
+    /**
+     * @brief   Starts a new generation, invalidating all caches stamped with this epoch.
+     */
+    void bump()
+    {
+        // Skip 0 on overflow, it's used to mark empty caches.
+        if (m_counter.fetch_add(1, std::memory_order_acq_rel) + 1 == 0)
+        {
+            m_counter.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+};
+
+/**
+ * @brief   Invalidates all caches by bumping the global epoch.
+ */
+inline void invalidateAll()
+{
+    Epoch::global().bump();
+}
+
+/**
+ * @brief   Lazily resolved value, invalidated by an `Epoch`.
+ * @tparam  T   The type of the cached value.
+ *              
+ * @note    Not synchronized, a cache must not be resolved concurrently by multiple threads.
+ */
+template<typename T>
+class EpochCache
+{
+    T m_value{};
+    uint64_t m_stamp = 0;
+public:
+    /**
+     * @brief   Gets the cached value, resolving it if stale.
+     * @param   epoch       The epoch the value depends on.
+     * @param   resolver    Functor computing the value if stale.
+     * @return  The value.
+     */
+    template<typename ResolverT>
+    const T& get(const Epoch& epoch, ResolverT&& resolver)
+    {
+        const auto stamp = epoch.stamp();
+        if (m_stamp != stamp)
+        {
+            m_value = resolver();
+            m_stamp = stamp;
+        }
+        return m_value;
+    }
+
+    /**
+     * @brief   Determines whether the cached value is still valid.
+     * @param   epoch   The epoch the value depends on.
+     * @return  @c true if valid, else @c false.
+     */
+    bool isValid(const Epoch& epoch) const { return m_stamp == epoch.stamp(); }
+
+    /**
+     * @brief   Invalidates just this cache.
+     */
+    void invalidate() { m_stamp = 0; }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [ChainGetter]                                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor following a chain of pointers, caching the result.
+ *          
+ * For the offsets `{0x10, 0x48, 0x8}`, the resulting address is `[[raw + 0x10] + 0x48] + 0x8`,
+ * where `[x]` denotes reading a pointer at `x`. The resolved address is cached until the raw 
+ * pointer changes or its `Epoch` is bumped, so repeated accesses cost a single comparison
+ * instead of a series of dependent loads.
+ *
+ * @code
+ *     Field<int, ChainGetter> health{Global::instance(), ChainGetter{0x1234, {0x10, 0x48, 0x8}}};
+ * @endcode
+ *     
+ * @note    The cache is not synchronized, don't share one getter between threads.
+ */
+class ChainGetter
+{
+public:
+    static const std::size_t kMaxDepth = 8;
+private:
+    std::ptrdiff_t m_offsets[kMaxDepth];
+    std::size_t m_depth;
+    uintptr_t m_base;
+    const Epoch* m_epoch;
+    mutable void* m_cachedRaw = nullptr;
+    mutable EpochCache<void*> m_cache;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   base    Value added to the raw pointer before following the chain (e.g. the 
+     *                  address of a global when used with `Global`).
+     * @param   offsets The offsets, at most `kMaxDepth`.
+     * @param   epoch   The epoch invalidating the cached result.
+     */
+    ChainGetter(uintptr_t base, std::initializer_list<std::ptrdiff_t> offsets, 
+            const Epoch& epoch = Epoch::global())
+        : m_depth{offsets.size()}
+        , m_base{base}
+        , m_epoch{&epoch}
+    {
+        assert(offsets.size() && offsets.size() <= kMaxDepth);
+        if (m_depth > kMaxDepth) m_depth = kMaxDepth;
+        std::copy(offsets.begin(), offsets.begin() + m_depth, m_offsets);
+    }
+
+    /**
+     * @brief   Constructor.
+     * @param   offsets The offsets, at most `kMaxDepth`.
+     */
+    explicit ChainGetter(
+            std::initializer_list<std::ptrdiff_t> offsets, const Epoch& epoch = Epoch::global())
+        : ChainGetter{0, offsets, epoch}
+    {}
+
+    void* operator () (void* raw) const
+    {
+        if (m_cachedRaw != raw)
+        {
+            m_cache.invalidate();
+            m_cachedRaw = raw;
+        }
+        return m_cache.get(*m_epoch, [&] { return resolve(raw); });
+    }
+
+    /**
+     * @brief   Follows the chain, bypassing the cache.
+     * @param   raw The raw pointer.
+     * @return  The resulting pointer.
+     */
+    void* resolve(void* raw) const
+    {
+        auto cur = reinterpret_cast<uintptr_t>(raw) + m_base;
+        for (std::size_t i = 0; i + 1 < m_depth; ++i)
+        {
+            cur = *reinterpret_cast<uintptr_t*>(cur + m_offsets[i]);
+        }
+        return reinterpret_cast<void*>(cur + m_offsets[m_depth - 1]);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [DynamicOffsGetter]                                                                            //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor adding an offset computed from the object itself, caching the 
+ *          result.
+ *          
+ * Made for fields behind variable-length parts of an object, whose offsets depend on earlier 
+ * fields (e.g. the length of a `TrailingArray`). The offset is computed on the first access and 
+ * cached until the raw pointer changes or its `Epoch` is bumped, so every further access costs a
+ * comparison instead of recomputing the layout.
+ *
+ * @code
+ *     Field<uint32_t>     numItems{this, 0x8};
+ *     TrailingArray<Item> items   {this, 0xC, [this] { return std::size_t{numItems}; }};
+ *     Field<uint32_t, DynamicOffsGetter> checksum{
+ *         this, DynamicOffsGetter{[this](void*) { return items.endOffset(); }}};
+ * @endcode
+ *
+ * @note    The cache is not synchronized, don't share one getter between threads. Bump the epoch
+ *          when the fields the offset depends on change.
+ */
+class DynamicOffsGetter
+{
+public:
+    using OffsetFunc = std::function<std::ptrdiff_t(void* raw)>;
+private:
+    OffsetFunc m_offsetOf;
+    const Epoch* m_epoch;
+    mutable void* m_cachedRaw = nullptr;
+    mutable EpochCache<void*> m_cache;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   offsetOf    Functor computing the offset from the raw pointer.
+     * @param   epoch       The epoch invalidating the cached result.
+     */
+    explicit DynamicOffsGetter(OffsetFunc offsetOf, const Epoch& epoch = Epoch::global())
+        : m_offsetOf{std::move(offsetOf)}
+        , m_epoch{&epoch}
+    {}
+
+    void* operator () (void* raw) const
+    {
+        if (m_cachedRaw != raw)
+        {
+            m_cache.invalidate();
+            m_cachedRaw = raw;
+        }
+        return m_cache.get(*m_epoch, [&] { return resolve(raw); });
+    }
+
+    /**
+     * @brief   Computes the address, bypassing the cache.
+     * @param   raw The raw pointer.
+     * @return  The resulting pointer.
+     */
+    void* resolve(void* raw) const
+    {
+        return static_cast<uint8_t*>(raw) + m_offsetOf(raw);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [RefGetter]                                                                                    //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   `PtrGetter` functor following a reference stored at an offset, caching the address of
+ *          the referenced object.
+ *
+ * Plain reference fields (`Field<T&>`) load the stored pointer on every access. References can't
+ * be reseated though, so the referenced address only changes with the raw pointer. Reference
+ * fields using this getter remember it until the wrapper is rebound, so hot accesses cost a
+ * comparison and a load instead of the address calculation plus two dependent loads.
+ *
+ * @code
+ *     Field<Kennel&, RefGetter> kennel{this, 0x20};
+ * @endcode
+ *
+ * @note    The cache is not synchronized, don't share one getter between threads. Objects created
+ *          anew at the address of a destroyed one require rebinding the wrapper (or a new one).
+ */
+class RefGetter
+{
+    OffsGetter m_getter;
+    mutable void* m_cachedRaw = nullptr;
+    mutable void* m_obj = nullptr;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   getter  The getter locating the stored reference.
+     */
+    explicit RefGetter(OffsGetter getter)
+        : m_getter{getter}
+    {}
+
+    /**
+     * @brief   Constructor.
+     * @param   offs    The offset of the stored reference.
+     */
+    explicit RefGetter(std::ptrdiff_t offs)
+        : m_getter{offs}
+    {}
+
+    void* operator () (void* raw) const
+    {
+        if (m_cachedRaw != raw)
+        {
+            m_obj = *static_cast<void**>(m_getter(raw));
+            m_cachedRaw = raw;
+        }
+        return m_obj;
+    }
+};
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines whether a `PtrGetter` follows references itself, so reference fields using
+ *          it must not dereference the result again.
+ * @tparam  PtrGetterT  The `PtrGetter` type.
+ */
+template<typename PtrGetterT>
+struct IsDerefGetter : std::false_type {};
+
+/**
+ * @internal
+ * @brief   `RefGetter`s return the address of the referenced object.
+ * @copydetails IsDerefGetter
+ */
+template<>
+struct IsDerefGetter<RefGetter> : std::true_type {};
+
+} // namespace internal
+
+// ============================================================================================== //
+// Helper class(es) to create wrappers from raw pointers                                          //
+// ============================================================================================== //
+
+// ---------------------------------------------------------------------------------------------- //
+// [WrapperPtr]                                                                                   //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Weak wrapper fall-through capturing invalid instantiations.
+ * @tparam  WrapperT    Wrapper type.
+ */
+template<typename WrapperT, typename = void>
+class WeakWrapperImpl
+{
+    static_assert(BlackBoxConsts<WrapperT>::kFalse,
+        "WeakWrapper can only be created for AdvancedClassWrappers");
+};
+
+/**
+ * @internal
+ * @brief   Strong wrapper borrowed from a per-thread stack of wrappers, see
+ *          `WeakWrapperImpl::with`.
+ * @tparam  WrapperT    The wrapper type.
+ *
+ * Wrappers are created once per thread and nesting depth and then just rebound, so borrowing
+ * one costs a few stores instead of constructing every field.
+ */
+template<typename WrapperT>
+class BorrowedWrapper
+{
+    struct Stack
+    {
+        std::vector<std::unique_ptr<WrapperT>> wrappers;
+        std::size_t depth = 0;
+    };
+
+    static Stack& stack()
+    {
+        static thread_local Stack stack;
+        return stack;
+    }
+
+    WrapperT* m_wrapper;
+public:
+    explicit BorrowedWrapper(void* raw)
+    {
+        auto& cur = stack();
+        if (cur.depth == cur.wrappers.size())
+        {
+            cur.wrappers.emplace_back(new WrapperT{wrapper_cast<WrapperT>(raw)});
+        }
+        m_wrapper = cur.wrappers[cur.depth++].get();
+        m_wrapper->rebind(raw);
+    }
+
+    ~BorrowedWrapper()
+    {
+        --stack().depth;
+    }
+
+    BorrowedWrapper(const BorrowedWrapper&) = delete;
+    BorrowedWrapper& operator = (const BorrowedWrapper&) = delete;
+
+    WrapperT& get() { return *m_wrapper; }
+};
+
+#pragma pack(push, 1)
+/**
+ * @internal
+ * @brief   Weak wrapper implementation capturing correct instantiations.
+ * @tparam  WrapperT    Wrapper type derived from `AdvancedClassWrapper`.
+ */
+template<typename WrapperT>
+class WeakWrapperImpl<WrapperT, typename WrapperT::IsAdvWrapper /* manual SFINAE */>
+{
+    uint8_t m_dummy[WrapperT::kObjSize];
+protected:
+    /**
+     * @brief   Default constructor.
+     */
+    WeakWrapperImpl() = default;
+public:
+    /**
+     * @brief   Gets the raw pointer 
+     * @return  The raw pointer.
+     */
+    void* raw() { return this; }
+
+    /**
+     * @brief   Converts this weak wrapper to a strong ("normal") one.
+     * @return  A strong wrapper.
+     */
+    WrapperT toStrong() { return wrapper_cast<WrapperT>(this); }
+
+    /**
+     * @brief   Invokes a functor with a strong wrapper for this object, without constructing one.
+     * @param   func    The functor, taking a `WrapperT&`.
+     * @return  The result of @c func.
+     *
+     * `toStrong` constructs every field of the wrapper, which adds up in callbacks invoked per
+     * element. Here, the wrapper is borrowed from a per-thread stack and rebound to this object
+     * instead, costing a few stores independent of the number of fields. The wrapper is only
+     * valid during the call, nested calls (even for the same type) borrow separate wrappers.
+     * @code
+     *     void horseTraverser(Horse::Weak* curHorse)
+     *     {
+     *         curHorse->with([](Horse& horse) { std::cout << horse.age << std::endl; });
+     *     }
+     * @endcode
+     */
+    template<typename FuncT>
+    auto with(FuncT&& func) -> decltype(func(std::declval<WrapperT&>()))
+    {
+        BorrowedWrapper<WrapperT> borrowed{this};
+        return func(borrowed.get());
+    }
+};
+#pragma pack(pop)
+ 
+} // namespace internal
+
+/**
+ * @brief   Weak wrapper helper type.
+ * @tparam  WrapperT    Type of the strong wrapper to create a weak wrapper for.
+ *                      
+ * Other than with normal wrappers, the `this` pointer of this class points to the actual object
+ * which allows creation of raw pointers to weak wrappers which is useful when defining functions
+ * that take pointers to wrapped types. Weak wrappers can then be evolved to strong wrappers
+ * with a simple `toStrong` invocation.
+ */
+template<typename WrapperT>
+struct WeakWrapper final : internal::WeakWrapperImpl<WrapperT> {};
+
+// Verify assumptions about this class.
+static_assert(std::is_trivial<WeakWrapper<AdvancedClassWrapper<sizeof(int)>>>::value, 
+    "internal library error");
+static_assert(sizeof(int) == sizeof(WeakWrapper<AdvancedClassWrapper<sizeof(int)>>), 
+    "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [Handle]                                                                                       //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Reference to a wrapped object consisting of nothing but the raw pointer.
+ * @tparam  WrapperT    The wrapper (or view) type used to access the object, @c void for handles
+ *                      to objects of any type.
+ *
+ * Handles are trivially copyable and pointer-sized, so containers of them cost as much as
+ * containers of raw pointers while staying typed. The wrapper is only materialized on access,
+ * either by value via `get` or, without constructing any fields, borrowed via `with`. Handles of
+ * different types convert to `Handle<void>`, which allows storing them in a single container
+ * and casting them back later.
+ *
+ * @code
+ *     std::vector<Handle<Dog>> dogs; // 8 bytes per dog on 64 bit hosts
+ *     dogs.emplace_back(dogInstanceLocation);
+ *     for (auto dog : dogs) dog.with([](Dog& cur) { ++cur.age; });
+ * @endcode
+ */
+template<typename WrapperT = void>
+class Handle
+{
+    void* m_raw;
+
+    // Trivially copyable wrappers (views, light wrappers) are as cheap to create as to borrow.
+    template<typename U, typename FuncT>
+    auto withImpl(FuncT&& func, std::true_type) const -> decltype(func(std::declval<U&>()))
+    {
+        auto wrapper = wrapper_cast<U>(m_raw);
+        return func(wrapper);
+    }
+
+    template<typename U, typename FuncT>
+    auto withImpl(FuncT&& func, std::false_type) const -> decltype(func(std::declval<U&>()))
+    {
+        internal::BorrowedWrapper<U> borrowed{m_raw};
+        return func(borrowed.get());
+    }
+public:
+    /**
+     * @brief   Default constructor, leaves the handle uninitialized like a raw pointer.
+     */
+    Handle() = default;
+
+    /**
+     * @brief   Constructs a null handle.
+     */
+    Handle(std::nullptr_t)
+        : m_raw{nullptr}
+    {}
+
+    /**
+     * @brief   Constructs a handle from a raw pointer.
+     * @param   raw The raw pointer of the object.
+     */
+    explicit Handle(void* raw)
+        : m_raw{raw}
+    {}
+
+    /**
+     * @brief   Constructs a handle to the object of a wrapper.
+     * @param   wrapper The wrapper.
+     */
+    template<typename U, typename = std::enable_if_t<std::is_base_of<WrapperT, U>::value>>
+    explicit Handle(const U& wrapper)
+        : m_raw{const_cast<void*>(wrapper.addressOfObj())}
+    {}
+
+    /**
+     * @brief   Converts a typed handle to an untyped one.
+     * @param   other   The typed handle.
+     */
+    template<typename OtherT, typename U = WrapperT,
+        typename = std::enable_if_t<std::is_void<U>::value && !std::is_void<OtherT>::value>>
+    Handle(Handle<OtherT> other)
+        : m_raw{other.raw()}
+    {}
+
+    /**
+     * @brief   Gets the raw pointer.
+     * @return  The raw pointer of the object.
+     */
+    void* raw() const { return m_raw; }
+
+    /**
+     * @brief   Determines whether the handle refers to an object.
+     * @return  @c true if the handle is not null, else @c false.
+     */
+    explicit operator bool () const { return m_raw != nullptr; }
+
+    /**
+     * @brief   Reinterprets the handle as a handle of another wrapper type.
+     * @tparam  OtherT  The other wrapper type.
+     * @return  The handle.
+     */
+    template<typename OtherT>
+    Handle<OtherT> cast() const { return Handle<OtherT>{m_raw}; }
+
+    /**
+     * @brief   Creates a wrapper for the object.
+     * @return  The wrapper.
+     */
+    template<typename U = WrapperT, typename = std::enable_if_t<!std::is_void<U>::value>>
+    U get() const { return wrapper_cast<U>(m_raw); }
+
+    /**
+     * @brief   Invokes a functor with a wrapper for the object, without constructing one.
+     * @param   func    The functor, taking a `WrapperT&`.
+     * @return  The result of @c func.
+     * @see     WeakWrapper::with
+     */
+    template<typename FuncT, typename U = WrapperT,
+        typename = std::enable_if_t<!std::is_void<U>::value>>
+    auto with(FuncT&& func) const -> decltype(func(std::declval<U&>()))
+    {
+        return withImpl<U>(std::forward<FuncT>(func), std::is_trivially_copy_constructible<U>{});
+    }
+
+    friend bool operator == (Handle lhs, Handle rhs) { return lhs.m_raw == rhs.m_raw; }
+    friend bool operator != (Handle lhs, Handle rhs) { return lhs.m_raw != rhs.m_raw; }
+    friend bool operator <  (Handle lhs, Handle rhs) { return lhs.m_raw <  rhs.m_raw; }
+};
+
+// Verify assumptions about this class.
+static_assert(std::is_trivial<Handle<>>::value, "internal library error");
+static_assert(sizeof(void*) == sizeof(Handle<>), "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [PtrRegion] + [CompressedPtr]                                                                  //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Region of memory that `CompressedPtr`s are relative to.
+ * @tparam  TagT    Tag type, distinguishing independent regions.
+ * @tparam  shiftT  The binary logarithm of the alignment of all objects in the region. Scaling
+ *                  the offsets by the alignment extends the region from 4 GB to 4 GB << shift.
+ *
+ * The base is reserved for null, so it has to be located below the first object that should be
+ * referenced. Pointers of 32 bit targets are decoded with a base of 0, the default.
+ *
+ * @code
+ *     struct EntityHeap;
+ *     using EntityRegion = PtrRegion<EntityHeap, 3>; // 8 byte aligned objects, 32 GB
+ *     EntityRegion::setBase(heapStart);
+ * @endcode
+ */
+template<typename TagT = void, unsigned shiftT = 0>
+class PtrRegion
+{
+    static_assert(shiftT < 32, "shift exceeds the pointer width");
+
+    static uintptr_t& baseRef()
+    {
+        static uintptr_t base = 0;
+        return base;
+    }
+public:
+    static const unsigned kShift = shiftT;
+
+    /**
+     * @brief   Gets the base of the region.
+     * @return  The base address.
+     */
+    static uintptr_t base() { return baseRef(); }
+
+    /**
+     * @brief   Sets the base of the region. Previously compressed pointers aren't adjusted.
+     * @param   base    The base address.
+     */
+    static void setBase(uintptr_t base) { baseRef() = base; }
+
+    /**
+     * @copydoc setBase(uintptr_t)
+     */
+    static void setBase(const void* base) { setBase(reinterpret_cast<uintptr_t>(base)); }
+
+    /**
+     * @brief   Determines whether an address can be compressed.
+     * @param   ptr The address.
+     * @return  @c true if @c ptr is null or an aligned address above the base inside of the
+     *          region, else @c false.
+     */
+    static bool contains(const void* ptr)
+    {
+        if (!ptr) return true;
+        const auto addr = reinterpret_cast<uintptr_t>(ptr);
+        const auto offs = static_cast<uint64_t>(addr - base());
+        return addr > base() && !(offs & ((uint64_t{1} << shiftT) - 1))
+            && (offs >> shiftT) <= UINT32_MAX;
+    }
+};
+
+/**
+ * @brief   Pointer to a wrapped object stored as a 32 bit offset into a `PtrRegion`.
+ * @tparam  WrapperT    The wrapper (or view) type used to access the object.
+ * @tparam  RegionT     The region the pointer is relative to.
+ *
+ * Half the size of a raw pointer on 64 bit hosts, so twice as many fit into a cache line, e.g. in
+ * indexes or handle tables referencing objects of a single heap. Being trivial, compressed
+ * pointers can also be used as fields, e.g. to decode pointers of 32 bit targets:
+ * @code
+ *     Field<CompressedPtr<Dog>> owner{this, 0x10}; // default region, based at 0
+ *     owner->with([](Dog& dog) { ++dog.age; });
+ * @endcode
+ */
+template<typename WrapperT, typename RegionT = PtrRegion<>>
+class CompressedPtr
+{
+    uint32_t m_value;
+public:
+    /**
+     * @brief   Default constructor, leaves the pointer uninitialized like a raw pointer.
+     */
+    CompressedPtr() = default;
+
+    /**
+     * @brief   Constructs a null pointer.
+     */
+    CompressedPtr(std::nullptr_t)
+        : m_value{0}
+    {}
+
+    /**
+     * @brief   Compresses an address.
+     * @param   ptr The address, required to be contained in the region (see
+     *              `PtrRegion::contains`).
+     */
+    explicit CompressedPtr(const void* ptr)
+        : m_value{static_cast<uint32_t>(ptr
+            ? (reinterpret_cast<uintptr_t>(ptr) - RegionT::base()) >> RegionT::kShift : 0)}
+    {
+        assert(RegionT::contains(ptr));
+    }
+
+    /**
+     * @brief   Compresses the pointer of a handle.
+     * @param   handle  The handle.
+     */
+    explicit CompressedPtr(Handle<WrapperT> handle)
+        : CompressedPtr{handle.raw()}
+    {}
+
+    /**
+     * @brief   Creates a pointer from its compressed representation.
+     * @param   value   The compressed value, e.g. a pointer of a 32 bit target.
+     * @return  The pointer.
+     */
+    static CompressedPtr fromValue(uint32_t value)
+    {
+        CompressedPtr ptr;
+        ptr.m_value = value;
+        return ptr;
+    }
+
+    /**
+     * @brief   Gets the compressed representation.
+     * @return  The compressed value.
+     */
+    uint32_t value() const { return m_value; }
+
+    /**
+     * @brief   Decompresses the pointer.
+     * @return  The raw pointer of the object.
+     */
+    void* raw() const
+    {
+        return m_value ? reinterpret_cast<void*>(
+            RegionT::base() + (static_cast<uintptr_t>(m_value) << RegionT::kShift)) : nullptr;
+    }
+
+    /**
+     * @brief   Decompresses the pointer to a handle.
+     * @return  The handle.
+     */
+    Handle<WrapperT> handle() const { return Handle<WrapperT>{raw()}; }
+
+    /**
+     * @brief   Creates a wrapper for the object.
+     * @return  The wrapper.
+     */
+    WrapperT get() const { return handle().get(); }
+
+    /**
+     * @brief   Invokes a functor with a wrapper for the object, without constructing one.
+     * @param   func    The functor, taking a `WrapperT&`.
+     * @return  The result of @c func.
+     * @see     Handle::with
+     */
+    template<typename FuncT, typename U = WrapperT>
+    auto with(FuncT&& func) const -> decltype(func(std::declval<U&>()))
+    {
+        return handle().with(std::forward<FuncT>(func));
+    }
+
+    /**
+     * @brief   Determines whether the pointer refers to an object.
+     * @return  @c true if the pointer is not null, else @c false.
+     */
+    explicit operator bool () const { return m_value != 0; }
+
+    friend bool operator == (CompressedPtr lhs, CompressedPtr rhs)
+    {
+        return lhs.m_value == rhs.m_value;
+    }
+
+    friend bool operator != (CompressedPtr lhs, CompressedPtr rhs)
+    {
+        return lhs.m_value != rhs.m_value;
+    }
+
+    friend bool operator < (CompressedPtr lhs, CompressedPtr rhs)
+    {
+        return lhs.m_value < rhs.m_value;
+    }
+};
+
+// Verify assumptions about this class.
+static_assert(std::is_trivial<CompressedPtr<void>>::value, "internal library error");
+static_assert(sizeof(uint32_t) == sizeof(CompressedPtr<void>), "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [TargetPtr] + [Ptr32] + [Ptr64]                                                                //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @internal
+ * @brief   Determines the size of objects in the address space of the target.
+ * @tparam  T   The type of the objects, wrappers are sized by `kObjSize`.
+ */
+template<typename T, typename = void>
+struct TargetSizeOf : std::integral_constant<std::size_t, sizeof(T)> {};
+
+/**
+ * @internal
+ * @brief   Advanced wrappers know the size of the wrapped objects.
+ * @copydetails TargetSizeOf
+ */
+template<typename T>
+struct TargetSizeOf<T, typename T::IsAdvWrapper /* manual SFINAE */>
+    : std::integral_constant<std::size_t, T::kObjSize>
+{};
+
+} // namespace internal
+
+/**
+ * @brief   Pointer stored with the pointer width of the target rather than the host.
+ * @tparam  T       The type pointed to, a wrapper or any other type.
+ * @tparam  AddrT   The unsigned integer type of the target's pointers.
+ *
+ * Raw pointers always have the width of the host, so fields representing pointers of a target
+ * with another width (e.g. a 32 bit process inspected by a 64 bit tool) are declared as
+ * `Field<Ptr32<Dog>>` rather than `Field<Dog*>`. The address isn't meaningful in our own address
+ * space, it is read using a `MemoryBackend` (see `readRemote` and `readTarget` in `Memory.hpp`).
+ * Pointer arithmetic advances by the size of the objects in the target (`kObjSize` for
+ * wrappers), so `TargetPtr`s of `TargetPtr`s step by the target's pointer width.
+ */
+template<typename T, typename AddrT>
+class TargetPtr
+{
+    static_assert(std::is_same<AddrT, uint32_t>::value || std::is_same<AddrT, uint64_t>::value,
+        "targets are required to use 32 or 64 bit pointers");
+
+    AddrT m_address;
+public:
+    using ElementType = T;
+    using Address = AddrT;
+
+    /**
+     * @brief   Default constructor, leaves the pointer uninitialized like a raw pointer.
+     */
+    TargetPtr() = default;
+
+    /**
+     * @brief   Constructs a null pointer.
+     */
+    TargetPtr(std::nullptr_t)
+        : m_address{0}
+    {}
+
+    /**
+     * @brief   Constructs a pointer from an address.
+     * @param   address The address in the target, required to fit into @c AddrT.
+     */
+    explicit TargetPtr(uint64_t address)
+        : m_address{static_cast<AddrT>(address)}
+    {
+        assert(m_address == address);
+    }
+
+    /**
+     * @brief   Gets the address.
+     * @return  The address in the target.
+     */
+    uint64_t address() const { return m_address; }
+
+    /**
+     * @brief   Determines whether the pointer is not null.
+     * @return  @c true if the pointer is not null, else @c false.
+     */
+    explicit operator bool () const { return m_address != 0; }
+
+    TargetPtr operator + (std::ptrdiff_t n) const
+    {
+        return TargetPtr{static_cast<uint64_t>(static_cast<AddrT>(m_address
+            + static_cast<AddrT>(n) * static_cast<AddrT>(internal::TargetSizeOf<T>::value)))};
+    }
+
+    TargetPtr operator - (std::ptrdiff_t n) const { return *this + -n; }
+
+    friend bool operator == (TargetPtr lhs, TargetPtr rhs)
+    {
+        return lhs.m_address == rhs.m_address;
+    }
+
+    friend bool operator != (TargetPtr lhs, TargetPtr rhs)
+    {
+        return lhs.m_address != rhs.m_address;
+    }
+
+    friend bool operator < (TargetPtr lhs, TargetPtr rhs)
+    {
+        return lhs.m_address < rhs.m_address;
+    }
+};
+
+/**
+ * @brief   Pointer of a 32 bit target.
+ * @tparam  T   The type pointed to.
+ */
+template<typename T>
+using Ptr32 = TargetPtr<T, uint32_t>;
+
+/**
+ * @brief   Pointer of a 64 bit target.
+ * @tparam  T   The type pointed to.
+ */
+template<typename T>
+using Ptr64 = TargetPtr<T, uint64_t>;
+
+// Verify assumptions about this class.
+static_assert(std::is_trivial<Ptr32<void>>::value && sizeof(Ptr32<void>) == 4,
+    "internal library error");
+static_assert(std::is_trivial<Ptr64<void>>::value && sizeof(Ptr64<void>) == 8,
+    "internal library error");
+
+// ---------------------------------------------------------------------------------------------- //
+// [WrapperRange]                                                                                 //
+// ---------------------------------------------------------------------------------------------- //
+
+/**
+ * @brief   Range of equally spaced objects in memory, iterated with a single rebound wrapper.
+ * @tparam  WrapperT    The wrapper (or view) type used to access the objects.
+ *                      
+ * Instead of creating a new wrapper for every element, the iterators of this range keep one 
+ * wrapper each and `rebind` it when advanced, so walking large arrays of foreign objects just 
+ * costs a pointer increment per element.
+ * 
+ * @code
+ *     for (auto& dog : WrapperRange<Dog>{dogArray, dogCount, sizeof(DogStruct)}) 
+ *     {
+ *         ++dog.age;
+ *     }
+ * @endcode
+ *     
+ * @note    Dereferencing an iterator yields a reference to the wrapper stored inside of the
+ *          iterator, which stays valid only until the iterator is advanced or destroyed.
+ */
+template<typename WrapperT>
+class WrapperRange
+{
+public:
+    /**
+     * @brief   Iterator type of the range.
+     */
+    class Iterator
+    {
+        WrapperT m_wrapper;
+        std::size_t m_stride;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = WrapperT;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = WrapperT*;
+        using reference         = WrapperT&;
+
+        /**
+         * @brief   Constructor.
+         * @param   raw     The raw pointer of the current object.
+         * @param   stride  The distance between two objects, in bytes.
+         */
+        Iterator(void* raw, std::size_t stride)
+            : m_wrapper{wrapper_cast<WrapperT>(raw)}
+            , m_stride{stride}
+        {}
+
+        WrapperT& operator * () { return m_wrapper; }
+        WrapperT* operator -> () { return m_wrapper.addressOfWrapper(); }
+
+        Iterator& operator ++ ()
+        {
+            m_wrapper.rebind(static_cast<uint8_t*>(m_wrapper.addressOfObj()) + m_stride);
+            return *this;
+        }
+
+        bool operator == (const Iterator& rhs) const
+        {
+            return m_wrapper.addressOfObj() == rhs.m_wrapper.addressOfObj();
+        }
+
+        bool operator != (const Iterator& rhs) const { return !(*this == rhs); }
+    };
+private:
+    void* m_first;
+    std::size_t m_count;
+    std::size_t m_stride;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   first   The raw pointer of the first object.
+     * @param   count   The number of objects.
+     * @param   stride  The distance between two objects, in bytes.
+     */
+    WrapperRange(void* first, std::size_t count, std::size_t stride)
+        : m_first{first}
+        , m_count{count}
+        , m_stride{stride}
+    {}
+
+    /**
+     * @brief   Constructor for ranges of densely packed objects wrapped by advanced wrappers.
+     * @param   first   The raw pointer of the first object.
+     * @param   count   The number of objects.
+     */
+    template<
+        typename U = WrapperT,
+        typename = typename U::IsAdvWrapper /* manual SFINAE */>
+    WrapperRange(void* first, std::size_t count)
+        : WrapperRange{first, count, U::kObjSize}
+    {}
+
+    Iterator begin() const { return {m_first, m_stride}; }
+    Iterator end() const { return {rawAt(m_count), m_stride}; }
+
+    /**
+     * @brief   Gets the number of objects in the range.
+     * @return  The number of objects.
+     */
+    std::size_t size() const { return m_count; }
+
+    /**
+     * @brief   Gets the raw pointer of the first object in the range.
+     * @return  The raw pointer.
+     */
+    void* first() const { return m_first; }
+
+    /**
+     * @brief   Gets the distance between two objects in the range.
+     * @return  The distance, in bytes.
+     */
+    std::size_t stride() const { return m_stride; }
+
+    /**
+     * @brief   Creates a wrapper for an object in the range.
+     * @param   idx The index of the object.
+     * @return  The resulting wrapper.
+     */
+    WrapperT operator [] (std::size_t idx) const
+    {
+        REMODEL_CHECK_INDEX(idx, m_count);
+        return wrapper_cast<WrapperT>(rawAt(idx));
+    }
+private:
+    void* rawAt(std::size_t idx) const
+    {
+        return static_cast<uint8_t*>(m_first) + idx * m_stride;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+// [CompactWrapper]                                                                               //
+// ---------------------------------------------------------------------------------------------- //
+
+namespace internal
+{
+
+/**
+ * @brief   Template storing just the data of a wrapped object, without the wrapper.
+ * @tparam  WrapperT    Wrapper type derived from `AdvancedClassWrapper`.
+ *                      
+ * Other than `InstantiableWrapper`, this class is exactly `WrapperT::kObjSize` bytes large and 
+ * trivially copyable, so it can be used in `std::vector`s and arrays of objects just like the 
+ * wrapped type itself. Wrappers are created on demand with `view`, or for a whole array with a 
+ * `WrapperRange`.
+ * @code
+ *     std::vector<Cat::Compact> cats;
+ *     cats.reserve(1000000);
+ *     for (auto i = 0; i < 1000000; ++i) cats.emplace_back(3, Cat::Male, nullptr);
+ *     for (auto& cat : WrapperRange<Cat>{cats.data(), cats.size()}) ++cat.age;
+ * @endcode
+ * 
+ * The `construct` routine runs on construction and the bytes start out zeroed. Copies are
+ * bytewise and nothing runs on destruction, so wrappers with a `destruct` routine aren't 
+ * supported, use `Instantiable` or `InstantiablePool` for those.
+ */
+template<typename WrapperT>
+class CompactWrapper
+{
+    static_assert(!InstantiableTraits<WrapperT>::HasCustomDtor::Value,
+        "Compact doesn't support destruct routines, use Instantiable instead");
+    static_assert(WrapperT::kObjSize % WrapperT::kObjAlign == 0,
+        "object size must be a multiple of its alignment");
+
+    union
+    {
+        uint8_t m_data[WrapperT::kObjSize];
+        typename std::aligned_storage<1, WrapperT::kObjAlign>::type m_alignment;
+    };
+public:
+    /**
+     * @brief   Constructor.
+     * @tparam  ArgsT   Constructor argument types.
+     * @param   args    Arguments passed to the `construct` routine.
+     *                  
+     * If no custom `construct` routine is defined in the wrapper, an empty argument list is 
+     * expected.
+     */
+    template<typename... ArgsT>
+    explicit CompactWrapper(ArgsT&&... args)
+    {
+        std::memset(m_data, 0, sizeof(m_data));
+        constructAt<WrapperT>(&m_data, std::forward<ArgsT>(args)...);
+    }
+
+    CompactWrapper(const CompactWrapper& other) = default;
+    CompactWrapper& operator = (const CompactWrapper& other) = default;
+
+    /**
+     * @brief   Creates a wrapper for the object.
+     * @return  The wrapper, valid as long as this instance isn't moved or destroyed.
+     */
+    WrapperT view() { return wrapper_cast<WrapperT>(&m_data); }
+
+    /**
+     * @brief   Gets a weak pointer to the object.
+     * @return  The weak pointer.
+     */
+    WeakWrapper<WrapperT>* weakPtr() { return reinterpret_cast<WeakWrapper<WrapperT>*>(&m_data); }
+
+    /**
+     * @brief   Gets the address of the object.
+     * @return  The address.
+     */
+    void* addressOfObj() { return &m_data; }
+
+    /**
+     * @copydoc addressOfObj
+     */
+    const void* addressOfObj() const { return &m_data; }
+};
+
+} // namespace internal
+
+// ============================================================================================== //
+
+} // namespace remodel
+
+#endif // REMODEL_WRAPPER_HPP
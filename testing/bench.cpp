@@ -0,0 +1,326 @@
+#include "Remodel.hpp"
+#include "WrapperStats.hpp"
+#include "benchmark/benchmark.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace remodel;
+
+// Counts the heap allocations of the process for the allocations-per-cast counters.
+static std::atomic<uint64_t> g_numAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    ++g_numAllocations;
+    if (auto ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+
+// ============================================================================================== //
+// Field access benchmarks                                                                        //
+// ============================================================================================== //
+
+struct Dog
+{
+    int32_t age;
+    float   weight;
+    int32_t fields[16];
+};
+
+class WrapDog : public AdvancedClassWrapper<sizeof(Dog)>
+{
+    REMODEL_ADV_WRAPPER(WrapDog)
+public:
+    Field<int32_t>                                  age      {this, offsetof(Dog, age)};
+    Field<int32_t, OffsGetter>                      typedAge {this, offsetof(Dog, age)};
+    StaticField<int32_t, offsetof(Dog, age)>        staticAge{this};
+    Field<float>                                    weight   {this, offsetof(Dog, weight)};
+};
+
+void BM_RawRead(benchmark::State& state)
+{
+    Dog dog{};
+    auto ptr = &dog;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ptr);
+        benchmark::DoNotOptimize(ptr->age);
+    }
+}
+BENCHMARK(BM_RawRead);
+
+void BM_FieldRead(benchmark::State& state)
+{
+    Dog dog{};
+    auto dogWrap = wrapper_cast<WrapDog>(&dog);
+    for (auto _ : state)
+    {
+        int32_t age = dogWrap.age;
+        benchmark::DoNotOptimize(age);
+    }
+}
+BENCHMARK(BM_FieldRead);
+
+void BM_TypedFieldRead(benchmark::State& state)
+{
+    Dog dog{};
+    auto dogWrap = wrapper_cast<WrapDog>(&dog);
+    for (auto _ : state)
+    {
+        int32_t age = dogWrap.typedAge;
+        benchmark::DoNotOptimize(age);
+    }
+}
+BENCHMARK(BM_TypedFieldRead);
+
+void BM_StaticFieldRead(benchmark::State& state)
+{
+    Dog dog{};
+    auto dogWrap = wrapper_cast<WrapDog>(&dog);
+    for (auto _ : state)
+    {
+        int32_t age = dogWrap.staticAge;
+        benchmark::DoNotOptimize(age);
+    }
+}
+BENCHMARK(BM_StaticFieldRead);
+
+void BM_RawWrite(benchmark::State& state)
+{
+    Dog dog{};
+    auto ptr = &dog;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ptr);
+        ++ptr->age;
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_RawWrite);
+
+void BM_FieldWrite(benchmark::State& state)
+{
+    Dog dog{};
+    auto dogWrap = wrapper_cast<WrapDog>(&dog);
+    for (auto _ : state)
+    {
+        ++dogWrap.age;
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FieldWrite);
+
+void BM_StaticFieldWrite(benchmark::State& state)
+{
+    Dog dog{};
+    auto dogWrap = wrapper_cast<WrapDog>(&dog);
+    for (auto _ : state)
+    {
+        ++dogWrap.staticAge;
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_StaticFieldWrite);
+
+// ============================================================================================== //
+// wrapper_cast benchmarks                                                                        //
+// ============================================================================================== //
+
+#define BENCH_FIELD(idx) Field<int32_t> f##idx{this, offsetof(Dog, fields) + idx * 4};
+
+class WrapDog1 : public AdvancedClassWrapper<sizeof(Dog)>
+{
+    REMODEL_ADV_WRAPPER(WrapDog1)
+public:
+    BENCH_FIELD(0)
+};
+
+class WrapDog4 : public AdvancedClassWrapper<sizeof(Dog)>
+{
+    REMODEL_ADV_WRAPPER(WrapDog4)
+public:
+    BENCH_FIELD(0) BENCH_FIELD(1) BENCH_FIELD(2) BENCH_FIELD(3)
+};
+
+class WrapDog16 : public AdvancedClassWrapper<sizeof(Dog)>
+{
+    REMODEL_ADV_WRAPPER(WrapDog16)
+public:
+    BENCH_FIELD(0)  BENCH_FIELD(1)  BENCH_FIELD(2)  BENCH_FIELD(3)
+    BENCH_FIELD(4)  BENCH_FIELD(5)  BENCH_FIELD(6)  BENCH_FIELD(7)
+    BENCH_FIELD(8)  BENCH_FIELD(9)  BENCH_FIELD(10) BENCH_FIELD(11)
+    BENCH_FIELD(12) BENCH_FIELD(13) BENCH_FIELD(14) BENCH_FIELD(15)
+};
+
+#undef BENCH_FIELD
+
+template<typename WrapperT>
+void BM_WrapperCast(benchmark::State& state)
+{
+    Dog dog{};
+    for (auto _ : state)
+    {
+        auto dogWrap = wrapper_cast<WrapperT>(&dog);
+        benchmark::DoNotOptimize(dogWrap.f0.addressOfObj());
+    }
+
+    const auto info = stats<WrapperT>("", [] { return g_numAllocations.load(); });
+    state.counters["wrapper_bytes"] = static_cast<double>(info.wrapperSize);
+    state.counters["allocs_per_cast"] = info.allocationsPerCast;
+}
+BENCHMARK_TEMPLATE(BM_WrapperCast, WrapDog1);
+BENCHMARK_TEMPLATE(BM_WrapperCast, WrapDog4);
+BENCHMARK_TEMPLATE(BM_WrapperCast, WrapDog16);
+
+// ============================================================================================== //
+// Function call benchmarks                                                                       //
+// ============================================================================================== //
+
+struct Cat
+{
+    const void* const* vftable;
+    int32_t lives;
+};
+
+#if defined(ZYCORE_MSVC)
+#   define BENCH_NOINLINE __declspec(noinline)
+#else
+#   define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+// Plain functions taking `this` first, so the benchmarks don't depend on the compiler's ABI for
+// member functions and vftables.
+BENCH_NOINLINE int32_t addLives(void* thiz, int32_t x)
+{
+    return static_cast<Cat*>(thiz)->lives + x;
+}
+
+BENCH_NOINLINE int32_t add(int32_t a, int32_t b)
+{
+    return a + b;
+}
+
+int32_t (*addLivesPtr)(void*, int32_t) = &addLives;
+const void* catVfTable[] = {*reinterpret_cast<void**>(&addLivesPtr)};
+
+class WrapCat : public ClassWrapper
+{
+    REMODEL_WRAPPER(WrapCat)
+public:
+    MemberFunction<int32_t (*)(int32_t)> addLives{
+        this, reinterpret_cast<uintptr_t>(*reinterpret_cast<void**>(&addLivesPtr))};
+    VfTableCache vftable{offsetof(Cat, vftable)};
+    VirtualFunction<int32_t (*)(int32_t)> virtualAddLives{this, vftable, 0};
+};
+
+void BM_DirectCall(benchmark::State& state)
+{
+    int32_t x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(add(x, 2));
+    }
+}
+BENCHMARK(BM_DirectCall);
+
+void BM_FunctionCall(benchmark::State& state)
+{
+    Function<int32_t (*)(int32_t, int32_t)> wrapped{&add};
+    int32_t x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(wrapped(x, 2));
+    }
+}
+BENCHMARK(BM_FunctionCall);
+
+void BM_DirectMemberCall(benchmark::State& state)
+{
+    Cat cat{catVfTable, 9};
+    int32_t x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(addLives(&cat, x));
+    }
+}
+BENCHMARK(BM_DirectMemberCall);
+
+void BM_MemberFunctionCall(benchmark::State& state)
+{
+    Cat cat{catVfTable, 9};
+    auto catWrap = wrapper_cast<WrapCat>(&cat);
+    int32_t x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(catWrap.addLives(x));
+    }
+}
+BENCHMARK(BM_MemberFunctionCall);
+
+void BM_VirtualFunctionCall(benchmark::State& state)
+{
+    Cat cat{catVfTable, 9};
+    auto catWrap = wrapper_cast<WrapCat>(&cat);
+    int32_t x = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(catWrap.virtualAddLives(x));
+    }
+}
+BENCHMARK(BM_VirtualFunctionCall);
+
+// ============================================================================================== //
+// Instantiable benchmarks                                                                        //
+// ============================================================================================== //
+
+void BM_RawConstruction(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Dog dog{};
+        benchmark::DoNotOptimize(&dog);
+    }
+}
+BENCHMARK(BM_RawConstruction);
+
+void BM_InstantiableConstruction(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        WrapDog::Instantiable dog;
+        benchmark::DoNotOptimize(dog.addressOfObj());
+    }
+}
+BENCHMARK(BM_InstantiableConstruction);
+
+void BM_InstantiableChurn(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto dog = new WrapDog::Instantiable;
+        benchmark::DoNotOptimize(dog->addressOfObj());
+        delete dog;
+    }
+}
+BENCHMARK(BM_InstantiableChurn);
+
+} // anon namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+# Checks the assembly of the codegen probes against the `// CODEGEN` lines of their source.
+#
+# Usage: cmake -DSOURCE=<probes.cpp> -DASSEMBLY=<probes.s> -P CheckCodegen.cmake
+
+file(STRINGS "${SOURCE}" rules REGEX "^// CODEGEN ")
+file(STRINGS "${ASSEMBLY}" lines)
+list(LENGTH rules num_rules)
+if (num_rules EQUAL 0)
+	message(FATAL_ERROR "no probes found in ${SOURCE}")
+endif ()
+
+set(failed FALSE)
+foreach (rule ${rules})
+	string(REGEX REPLACE "^// CODEGEN +" "" rule "${rule}")
+	string(REPLACE " " ";" checks "${rule}")
+	list(GET checks 0 function)
+	list(REMOVE_AT checks 0)
+	set(function_failed FALSE)
+
+	# Collect the instructions of the function, from its label up to the end of its CFI block.
+	set(in_function FALSE)
+	set(instructions)
+	foreach (line ${lines})
+		if (line MATCHES "^_?${function}:")
+			set(in_function TRUE)
+		elseif (in_function)
+			if (line MATCHES "\\.cfi_endproc|^[\t ]*\\.size")
+				break()
+			endif ()
+			# Instructions are indented, directives start with a dot. CET landing pads don't count.
+			if (line MATCHES "^[\t ]+[a-z]" AND NOT line MATCHES "^[\t ]+endbr")
+				string(STRIP "${line}" line)
+				list(APPEND instructions "${line}")
+			endif ()
+		endif ()
+	endforeach ()
+
+	list(LENGTH instructions num_instructions)
+	if (num_instructions EQUAL 0)
+		message(SEND_ERROR "${function}: not found in ${ASSEMBLY}")
+		set(function_failed TRUE)
+	endif ()
+
+	foreach (check ${checks})
+		if (check STREQUAL "no-call")
+			foreach (instruction ${instructions})
+				if (instruction MATCHES "^call|^jmp[\t ]+[A-Za-z_]")
+					message(SEND_ERROR "${function}: unexpected call: ${instruction}")
+					set(function_failed TRUE)
+				endif ()
+			endforeach ()
+		elseif (check MATCHES "^max-insns=([0-9]+)$")
+			if (num_instructions GREATER CMAKE_MATCH_1)
+				string(REPLACE ";" "\n    " listing "${instructions}")
+				message(SEND_ERROR "${function}: ${num_instructions} instructions, expected at "
+					"most ${CMAKE_MATCH_1}:\n    ${listing}")
+				set(function_failed TRUE)
+			endif ()
+		elseif (check MATCHES "^max-branches=([0-9]+)$")
+			# Saved, the matches below overwrite CMAKE_MATCH_1.
+			set(max_branches ${CMAKE_MATCH_1})
+			set(branches)
+			foreach (instruction ${instructions})
+				if (instruction MATCHES "^j" AND NOT instruction MATCHES "^jmp")
+					list(APPEND branches "${instruction}")
+				endif ()
+			endforeach ()
+			list(LENGTH branches num_branches)
+			if (num_branches GREATER max_branches)
+				string(REPLACE ";" "\n    " listing "${instructions}")
+				message(SEND_ERROR "${function}: ${num_branches} conditional branches, expected "
+					"at most ${max_branches}:\n    ${listing}")
+				set(function_failed TRUE)
+			endif ()
+		else ()
+			message(FATAL_ERROR "${function}: unknown check ${check}")
+		endif ()
+	endforeach ()
+
+	if (function_failed)
+		set(failed TRUE)
+	else ()
+		message(STATUS "${function}: ${num_instructions} instructions, ok")
+	endif ()
+endforeach ()
+
+if (failed)
+	message(FATAL_ERROR "codegen checks failed")
+endif ()
@@ -0,0 +1,63 @@
+// Probes compiled to assembly by the `remodel-codegen` test, see `CheckCodegen.cmake`.
+//
+// Each `// CODEGEN <function> <checks...>` line makes the test check the code generated for the
+// given (unmangled) function:
+//   no-call        The function contains no calls and no tail calls to symbols.
+//   max-insns=N    The function consists of at most N instructions, including the return.
+//   max-branches=N The function contains at most N conditional branches.
+//
+// The budgets are the measured counts. Fields resolve their parent through its link, which is
+// null for fields of no parent, so the accesses keep the null checks of the link: a relative
+// link tests the stored offset and the resulting pointer (two `test`/`je` pairs), a pointer
+// link tests the pointer (one pair).
+
+#include "Remodel.hpp"
+
+using namespace remodel;
+
+namespace
+{
+
+struct Dog
+{
+    int32_t age;
+    float   weight;
+};
+
+class WrapDog : public AdvancedClassWrapper<sizeof(Dog)>
+{
+    REMODEL_ADV_WRAPPER(WrapDog)
+public:
+    StaticField<int32_t, offsetof(Dog, age)> staticAge{this};
+    Field<int32_t, OffsGetter>               typedAge {this, offsetof(Dog, age)};
+    Field<float>                             weight   {this, offsetof(Dog, weight)};
+};
+
+} // anon namespace
+
+// Static offsets: the offset is folded into the load relative to the raw pointer.
+// CODEGEN probeStaticRead no-call max-insns=9 max-branches=2
+extern "C" int32_t probeStaticRead(WrapDog& dog) { return dog.staticAge; }
+
+// Forwarded compound operators operate on memory directly.
+// CODEGEN probeStaticAdd no-call max-insns=9 max-branches=2
+extern "C" void probeStaticAdd(WrapDog& dog, int32_t x) { dog.staticAge += x; }
+
+// Typed getters are inlined, no `std::function` in the access path.
+// CODEGEN probeTypedRead no-call max-insns=11 max-branches=1
+extern "C" int32_t probeTypedRead(WrapDog& dog) { return dog.typedAge; }
+
+// Comparisons are forwarded statically (CRTP), without virtual calls.
+// CODEGEN probeTypedCompare no-call max-insns=13 max-branches=1
+extern "C" bool probeTypedCompare(WrapDog& dog) { return dog.typedAge == 5; }
+
+// Global fields skip the parent: load the address, load the value.
+// CODEGEN probeGlobalRead no-call max-insns=3 max-branches=0
+extern "C" int32_t probeGlobalRead(GlobalField<int32_t>& field) { return field; }
+
+// Functions with fixed getters call the pinned code pointer right away.
+// CODEGEN probeFixedFunctionCall no-call max-insns=3 max-branches=0
+extern "C" int32_t probeFixedFunctionCall(Function<int32_t (*)(int32_t), AbsGetter>& function)
+{
+    return function(1);
+}
@@ -0,0 +1,47 @@
+# Generates a translation unit of synthetic wrappers for measuring compile times.
+#
+# Usage: cmake -DOUTPUT=<file.cpp> -DNUM_WRAPPERS=<N> -DNUM_FIELDS=<M> -P Generate.cmake
+#
+# Every wrapper gets M fields cycling through the common field kinds (arithmetic types, enums,
+# arrays, pointers, structs and wrapper pointers), and every field is read once, so the operator
+# forwarders are instantiated like in real code.
+
+# `Prev*` stands for a pointer to the previously generated wrapper, so every wrapper instantiates
+# fields of distinct types too.
+set(types "int32_t" "float" "uint8_t" "Kind" "int32_t[4]" "Pod" "Pod*" "uint64_t*" "Prev*")
+list(LENGTH types num_types)
+
+set(code "// Generated by Generate.cmake, do not edit.\n\n#include \"remodel/Field.hpp\"\n\n")
+string(APPEND code "using namespace remodel;\n\nnamespace\n{\n\n")
+string(APPEND code "enum Kind : uint8_t { kA, kB };\n\nstruct Pod { int32_t x, y; };\n\n")
+string(APPEND code "struct Base : AdvancedClassWrapper<8>\n{\n    REMODEL_ADV_WRAPPER(Base)\n")
+string(APPEND code "public:\n    Field<int32_t> x{this, 0};\n};\n\n")
+
+math(EXPR last_wrapper "${NUM_WRAPPERS} - 1")
+math(EXPR last_field "${NUM_FIELDS} - 1")
+foreach (w RANGE ${last_wrapper})
+	string(APPEND code "struct Wrap${w} : AdvancedClassWrapper<${NUM_FIELDS} * 16>\n{\n")
+	string(APPEND code "    REMODEL_ADV_WRAPPER(Wrap${w})\npublic:\n")
+	set(uses "")
+	foreach (f RANGE ${last_field})
+		math(EXPR t "(${w} + ${f}) % ${num_types}")
+		list(GET types ${t} type)
+		if (type STREQUAL "Prev*")
+			if (w EQUAL 0)
+				set(type "Base*")
+			else ()
+				math(EXPR prev "${w} - 1")
+				set(type "Wrap${prev}*")
+			endif ()
+		endif ()
+		math(EXPR offset "${f} * 16")
+		string(APPEND code "    Field<${type}> f${f}{this, ${offset}};\n")
+		string(APPEND uses "    (void)wrap.f${f}.addressOfObj();\n")
+	endforeach ()
+	string(APPEND code "};\n\n")
+	string(APPEND code "void use${w}(void* raw)\n{\n    auto wrap = wrapper_cast<Wrap${w}>(raw);\n")
+	string(APPEND code "${uses}}\n\n")
+endforeach ()
+
+string(APPEND code "} // anon namespace\n")
+file(WRITE "${OUTPUT}" "${code}")
@@ -0,0 +1,127 @@
+# Runs microbenchmarks and compares their medians against a baseline, failing on regressions.
+#
+# Usage: cmake -DBENCH=<remodel_bench> -DFILTER=<regex> -DBASELINE=<baseline.json>
+#              -DTHRESHOLD=<percent> -DOUTPUT=<results.json> -P CheckPerf.cmake
+#
+# Both the baseline and the results are JSON files written by Google Benchmark with
+# `--benchmark_repetitions` and `--benchmark_report_aggregates_only`, see the
+# remodel_bench_baseline target.
+
+if (NOT EXISTS "${BASELINE}")
+	message("no baseline at ${BASELINE}, build the remodel_bench_baseline target to record one")
+	return()
+endif ()
+
+# Converts a JSON number (e.g. 4.0013901220956647e+01) to an integer of thousandths, as CMake
+# can only do integer math.
+function (to_thousandths value out)
+	if (NOT value MATCHES "^([0-9]+)\\.?([0-9]*)[eE]?([-+]?[0-9]*)$")
+		message(FATAL_ERROR "unexpected number ${value}")
+	endif ()
+	set(digits "${CMAKE_MATCH_1}${CMAKE_MATCH_2}")
+	string(LENGTH "${CMAKE_MATCH_2}" num_fraction)
+	set(exponent "${CMAKE_MATCH_3}")
+	if (exponent STREQUAL "")
+		set(exponent 0)
+	endif ()
+	math(EXPR shift "${exponent} + 3 - ${num_fraction}")
+	if (shift GREATER_EQUAL 0)
+		string(REPEAT "0" ${shift} zeros)
+		string(APPEND digits "${zeros}")
+	else ()
+		string(LENGTH "${digits}" num_digits)
+		math(EXPR num_digits "${num_digits} + ${shift}")
+		if (num_digits LESS_EQUAL 0)
+			set(digits 0)
+		else ()
+			string(SUBSTRING "${digits}" 0 ${num_digits} digits)
+		endif ()
+	endif ()
+	string(REGEX REPLACE "^0+([0-9])" "\\1" digits "${digits}")
+	set(${out} ${digits} PARENT_SCOPE)
+endfunction ()
+
+# Formats thousandths as decimal number.
+function (format_thousandths value out)
+	math(EXPR integer "${value} / 1000")
+	math(EXPR fraction "${value} % 1000 + 1000")
+	string(SUBSTRING "${fraction}" 1 3 fraction)
+	set(${out} "${integer}.${fraction}" PARENT_SCOPE)
+endfunction ()
+
+# Collects the median CPU times of a result file as `<prefix>_<key>` variables, where the key is
+# the benchmark name made an identifier, and the names as `<prefix>_names`.
+function (read_medians file prefix)
+	file(READ "${file}" json)
+	string(JSON num_benchmarks LENGTH "${json}" benchmarks)
+	set(names)
+	if (num_benchmarks GREATER 0)
+		math(EXPR last "${num_benchmarks} - 1")
+		foreach (i RANGE ${last})
+			string(JSON aggregate ERROR_VARIABLE error GET "${json}" benchmarks ${i} aggregate_name)
+			if (NOT aggregate STREQUAL "median")
+				continue()
+			endif ()
+			string(JSON name GET "${json}" benchmarks ${i} run_name)
+			string(JSON time GET "${json}" benchmarks ${i} cpu_time)
+			string(JSON unit GET "${json}" benchmarks ${i} time_unit)
+			to_thousandths(${time} time)
+			string(MAKE_C_IDENTIFIER "${name}" key)
+			list(APPEND names "${name}")
+			set(${prefix}_${key} ${time} PARENT_SCOPE)
+			set(${prefix}_${key}_unit ${unit} PARENT_SCOPE)
+		endforeach ()
+	endif ()
+	set(${prefix}_names ${names} PARENT_SCOPE)
+endfunction ()
+
+execute_process(
+	COMMAND "${BENCH}"
+		--benchmark_filter=${FILTER}
+		--benchmark_repetitions=5
+		--benchmark_report_aggregates_only=true
+		--benchmark_out=${OUTPUT}
+		--benchmark_out_format=json
+	RESULT_VARIABLE result
+	OUTPUT_QUIET)
+if (NOT result EQUAL 0)
+	message(FATAL_ERROR "running ${BENCH} failed: ${result}")
+endif ()
+
+read_medians("${BASELINE}" baseline)
+read_medians("${OUTPUT}" current)
+if (NOT current_names)
+	message(FATAL_ERROR "no benchmarks match ${FILTER}")
+endif ()
+
+set(failed FALSE)
+foreach (name ${current_names})
+	string(MAKE_C_IDENTIFIER "${name}" key)
+	if (NOT DEFINED baseline_${key})
+		message(STATUS "${name}: not in the baseline, skipped")
+		continue()
+	endif ()
+	if (NOT baseline_${key}_unit STREQUAL current_${key}_unit)
+		message(SEND_ERROR "${name}: time unit differs from the baseline")
+		set(failed TRUE)
+		continue()
+	endif ()
+
+	set(now ${current_${key}})
+	set(then ${baseline_${key}})
+	set(unit ${current_${key}_unit})
+	format_thousandths(${now} now_text)
+	format_thousandths(${then} then_text)
+	math(EXPR limit "${then} * (100 + ${THRESHOLD}) / 100")
+	if (now GREATER limit)
+		message(SEND_ERROR "${name}: ${now_text} ${unit}, baseline ${then_text} ${unit}, more "
+			"than ${THRESHOLD}% slower")
+		set(failed TRUE)
+	else ()
+		message(STATUS "${name}: ${now_text} ${unit}, baseline ${then_text} ${unit}, ok")
+	endif ()
+endforeach ()
+
+if (failed)
+	message(FATAL_ERROR "performance regressions found")
+endif ()
@@ -1,9 +1,46 @@
 #include "Remodel.hpp"
+#include "Memory.hpp"
+#include "Async.hpp"
+#include "SignatureCache.hpp"
+#include "OffsetDatabase.hpp"
+#include "MultiLayout.hpp"
+#include "Hook.hpp"
+#include "Trace.hpp"
+#include "Instrument.hpp"
+#include "Callback.hpp"
+#include "Pool.hpp"
+#include "Stl.hpp"
+#include "Traversal.hpp"
+#include "Crawler.hpp"
+#include "Scan.hpp"
+#include "Rtti.hpp"
+#include "Safe.hpp"
+#include "HashMap.hpp"
+#include "Packet.hpp"
+#include "Snapshot.hpp"
+#include "Watch.hpp"
+#include "RemoteCall.hpp"
+#include "Parallel.hpp"
+#include "Query.hpp"
+#include "Recorder.hpp"
+#include "CacheLines.hpp"
+#include "Table.hpp"
+#include "CodeCache.hpp"
+#include "WrapperStats.hpp"
+#include "StreamingTable.hpp"
 #include "gtest/gtest.h"
 
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 #include <stdarg.h>
 #include <numeric>
+#include <vector>
+#include <cstdio>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 using namespace remodel;
 
@@ -429,6 +466,14 @@ public:
         Field<WrapA[12]> wrapX {this, offsetof(B, x)};
         Field<A[]>       x2    {this, offsetof(B, x)};
     }; 
+
+    class WrapPtr : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapPtr)
+    public:
+        Field<A*>     p     {this, 0};
+        Field<WrapA*> wrapP {this, 0};
+    };
 protected:
     ArrayFieldTest()
         : wrapB{wrapper_cast<WrapB>(&b)}
@@ -488,6 +533,38 @@ TEST_F(ArrayFieldTest, WrappedArrayFields)
     EXPECT_EQ(0, wrapB.wrapX - wrapB.wrapX);
 }
 
+TEST_F(ArrayFieldTest, IteratorTest)
+{
+    static_assert(decltype(wrapB.x)::size() == 12, "bad array field size");
+
+    // Plain arrays iterate their elements in place.
+    int sum = 0;
+    for (auto& cur : wrapB.x) sum += cur.y;
+    EXPECT_EQ(132, sum);
+    EXPECT_EQ(b.x + 12, wrapB.x.end());
+    std::sort(wrapB.x.begin(), wrapB.x.end(), [](const A& l, const A& r) { return l.y > r.y; });
+    EXPECT_EQ(22, b.x[0].y);
+    EXPECT_EQ(0,  b.x[11].y);
+
+    // Arrays of wrappers yield weak wrappers.
+    unsigned z = 0;
+    for (auto& cur : wrapB.wrapX)
+    {
+        z += cur.with([](WrapA& a) { return static_cast<unsigned>(a.z); });
+    }
+    EXPECT_EQ(66u, z);
+
+    // Pointers can be viewed as arrays of a given length.
+    A* ptr = b.x;
+    auto wrapPtr = wrapper_cast<WrapPtr>(&ptr);
+    auto range = wrapPtr.p.range(4);
+    EXPECT_EQ(4u, range.size());
+    EXPECT_EQ(38, std::accumulate(range.begin(), range.end(), 0,
+        [](int acc, const A& cur) { return acc + cur.z; }));
+    EXPECT_EQ(4, std::count_if(wrapPtr.wrapP.range(12).begin(), wrapPtr.wrapP.range(12).end(),
+        [](WrapA::Weak& cur) { return cur.toStrong().y >= 16; }));
+}
+
 // ============================================================================================== //
 // Struct field testing                                                                           //
 // ============================================================================================== //
@@ -545,6 +622,22 @@ TEST_F(StructFieldTest, WrappedStructField)
     EXPECT_EQ(126, b.x.x                                      );
 }
 
+TEST_F(StructFieldTest, WeakWithTest)
+{
+    EXPECT_EQ(123u, wrapB.wrapX->with([](WrapA& a) { return a.x++; }));
+    EXPECT_EQ(124u, b.x.x);
+
+    // Nested calls get separate wrappers, even for the same type.
+    A other{7};
+    auto otherWeak = wrapper_cast<WrapA>(&other).weakPtr();
+    const uint32_t sum = wrapB.wrapX->with([&](WrapA& outer)
+    {
+        return otherWeak->with([&](WrapA& inner) { return outer.x + inner.x; });
+    });
+    EXPECT_EQ(131u, sum);
+    wrapB.wrapX->with([&](WrapA& a) { EXPECT_EQ(&b.x, a.addressOfObj()); });
+}
+
 // ============================================================================================== //
 // Pointer field testing                                                                          //
 // ============================================================================================== //
@@ -618,6 +711,28 @@ TEST_F(PointerFieldTest, PointerToArrayTest)
     EXPECT_EQ(3,       (*wrapB->z)[2] );
 }
 
+TEST_F(PointerFieldTest, TryGetTest)
+{
+    auto wrapA = wrapB.wrapA.tryGet();
+    ASSERT_TRUE(wrapA.hasValue());
+    EXPECT_EQ(&a, wrapA.value().addressOfObj());
+    EXPECT_EQ(&a, wrapB.a.tryGet().value());
+
+    auto x = wrapB.tryGet(&WrapB::wrapA).then(&WrapA::x);
+    ASSERT_TRUE(x.hasValue());
+    EXPECT_EQ(&c, x.value());
+
+    // Null pointers, and pointers read through them, end the chain.
+    b.a = nullptr;
+    EXPECT_FALSE(wrapB.wrapA.tryGet().hasValue());
+    EXPECT_FALSE(wrapB.tryGet(&WrapB::wrapA).then(&WrapA::x).hasValue());
+    b.a = reinterpret_cast<A*>(offsetof(A, x) + 8);
+    EXPECT_FALSE(wrapB.tryGet(&WrapB::a).hasValue());
+
+    // Plain pointers are returned as they are.
+    EXPECT_EQ(&z, wrapB.tryGet(&WrapB::z).value());
+}
+
 // ============================================================================================== //
 // lvalue-reference-field testing                                                                 //
 // ============================================================================================== //
@@ -654,8 +769,11 @@ public:
     {
         REMODEL_WRAPPER(WrapB)
     public:
-        //Field<A&>     a    {this, 0};
+        Field<A&>     a    {this, 0};
         Field<WrapA&> wrapA{this, 0};
+
+        Field<A&, RefGetter>        cachedA{this, 0};
+        Field<uint32_t&, RefGetter> cachedX{this, RefGetter{OffsGetter{0}}};
     };
 protected:
     LvalueReferenceFieldTest()
@@ -671,13 +789,13 @@ protected:
     WrapB    wrapB;
 };
 
-//TEST_F(LvalueReferenceFieldTest, PlainRefFieldTest)
-//{
-//    EXPECT_EQ(&c,      &wrapB.a->x );
-//    EXPECT_EQ(6358095, wrapB.a->x++);
-//    EXPECT_EQ(6358096, wrapB.a->x  );
-//    EXPECT_EQ(6358096, c           );
-//}
+TEST_F(LvalueReferenceFieldTest, PlainRefFieldTest)
+{
+    EXPECT_EQ(&c,      &wrapB.a->x );
+    EXPECT_EQ(6358095, wrapB.a->x++);
+    EXPECT_EQ(6358096, wrapB.a->x  );
+    EXPECT_EQ(6358096, c           );
+}
 
 TEST_F(LvalueReferenceFieldTest, WrapperRefFieldTest)
 {
@@ -687,6 +805,28 @@ TEST_F(LvalueReferenceFieldTest, WrapperRefFieldTest)
     EXPECT_EQ(6358096, c                                       );
 }
 
+TEST_F(LvalueReferenceFieldTest, CachedRefFieldTest)
+{
+    EXPECT_EQ(&a,      wrapB.cachedA.addressOfObj());
+    EXPECT_EQ(&c,      &wrapB.cachedA->x          );
+    EXPECT_EQ(6358095, wrapB.cachedA->x++         );
+    EXPECT_EQ(6358096, c                          );
+
+    // `cachedX` refers to the reference stored in `A`, not `B`.
+    auto overA = wrapper_cast<WrapB>(&a);
+    EXPECT_EQ(&c,      overA.cachedX.addressOfObj());
+    overA.cachedX = 5;
+    EXPECT_EQ(5u,      c);
+
+    // Rebinding the wrapper follows the reference of the new object.
+    uint32_t otherC = 7;
+    A otherA{otherC};
+    B otherB{otherA};
+    wrapB.rebind(&otherB);
+    EXPECT_EQ(&otherA, wrapB.cachedA.addressOfObj());
+    EXPECT_EQ(7u,      wrapB.cachedA->x);
+}
+
 // ============================================================================================== //
 // enum/enum class testing                                                                        //
 // ============================================================================================== //
@@ -741,333 +881,7029 @@ TEST_F(EnumTest, EnumTest)
 }
 
 // ============================================================================================== //
-// [Global] testing                                                                               //
+// [StaticField] testing                                                                          //
 // ============================================================================================== //
 
-class GlobalTest : public testing::Test {};
-
-TEST_F(GlobalTest, GlobalTest)
+class StaticFieldTest : public testing::Test
 {
-    auto global    = Global::instance();
-    int myStackVar = 854693;
-    Field<int> myStackVarField{global, reinterpret_cast<ptrdiff_t>(&myStackVar)};
+protected:
+    struct A
+    {
+        uint32_t x;
+        float    y;
+        int32_t  z[4];
+    };
 
-    EXPECT_EQ(myStackVar, myStackVarField);
+    struct B
+    {
+        A  a;
+        A* pa;
+    };
 
-    ++myStackVarField;
-    EXPECT_EQ(myStackVarField, 854693 + 1);
-    EXPECT_EQ(myStackVar,      854693 + 1);
+    class WrapA : public AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapA)
+    public:
+        StaticField<uint32_t,   offsetof(A, x)> x{this};
+        StaticField<float,      offsetof(A, y)> y{this};
+        StaticField<int32_t[4], offsetof(A, z)> z{this};
+    };
+
+    class WrapB : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapB)
+    public:
+        StaticField<WrapA,  offsetof(B, a)>  a {this};
+        StaticField<WrapA*, offsetof(B, pa)> pa{this};
+    };
+protected:
+    StaticFieldTest()
+        : wrapB{wrapper_cast<WrapB>(&b)}
+    {
+        b.a  = {1234, 5.f, {1, 2, 3, 4}};
+        b.pa = &b.a;
+    }
+protected:
+    B     b;
+    WrapB wrapB;
+};
+
+TEST_F(StaticFieldTest, StaticFieldTest)
+{
+    auto wrapA = wrapB.a->toStrong();
+
+    EXPECT_EQ(1234, wrapA.x);
+    EXPECT_EQ(1235, ++wrapA.x);
+    wrapA.x += 5;
+    EXPECT_EQ(1240, b.a.x);
+    wrapA.y = 2.5f;
+    EXPECT_FLOAT_EQ(2.5f, b.a.y);
+    EXPECT_EQ(3, wrapA.z[2]);
+    EXPECT_EQ(&b.a.x, wrapA.x.addressOfObj());
+
+    EXPECT_EQ(1240, wrapB.pa->toStrong().x);
+    EXPECT_EQ(static_cast<void*>(&b.a), wrapB.pa->raw());
+}
+
+TEST_F(StaticFieldTest, CompactLayoutTest)
+{
+    // StaticFields neither store their offset nor a pointer to their parent.
+    EXPECT_EQ(sizeof(int32_t), (sizeof(StaticField<uint32_t, offsetof(A, x)>)));
+    EXPECT_EQ(sizeof(ClassWrapper) + 2 * sizeof(int32_t), sizeof(WrapB));
+    EXPECT_EQ(&b.a.z[3], &wrapB.a->toStrong().z[3]);
 }
 
 // ============================================================================================== //
-// [Module] testing                                                                               //
+// [BitField] testing                                                                             //
 // ============================================================================================== //
 
-class ModuleTest : public testing::Test {};
-
-TEST_F(ModuleTest, ModuleTest)
+class BitFieldTest : public testing::Test
 {
-    static int myStaticVar = 854693;
-    auto mainModulePtr = platform::obtainModuleHandle(nullptr);
-    auto mainModule = Module::getModule(nullptr);
-
-    EXPECT_TRUE(mainModule);
-    EXPECT_TRUE(mainModulePtr != nullptr);
+protected:
+    struct Flags
+    {
+        uint32_t bits;
+        uint8_t  small;
+    };
 
-    Field<int> myStaticVarField{
-        addressOfWrapper(mainModule.value()), 
-        static_cast<ptrdiff_t>(reinterpret_cast<uintptr_t>(&myStaticVar)
-            - reinterpret_cast<uintptr_t>(mainModulePtr))
+    class WrapFlags : public AdvancedClassWrapper<sizeof(Flags)>
+    {
+        REMODEL_ADV_WRAPPER(WrapFlags)
+    public:
+        BitField<uint32_t, 0, 1>   isAdmin{this, offsetof(Flags, bits)};
+        BitField<uint32_t, 4, 3>   level  {this, offsetof(Flags, bits)};
+        BitField<uint32_t, 16, 16> id     {this, offsetof(Flags, bits)};
+        StaticBitField<uint8_t, offsetof(Flags, small), 6, 2> top{this};
     };
+};
 
-    ++myStaticVarField;
-    EXPECT_EQ(myStaticVarField, 854693 + 1);
-    EXPECT_EQ(myStaticVar,      854693 + 1);
+TEST_F(BitFieldTest, AccessTest)
+{
+    Flags flags{0x12340051, 0x41};
+    auto wrapper = wrapper_cast<WrapFlags>(&flags);
+
+    EXPECT_TRUE(wrapper.isAdmin == 1u);
+    EXPECT_EQ(5u, wrapper.level.get());
+    EXPECT_EQ(0x1234u, wrapper.id.get());
+    EXPECT_EQ(1u, wrapper.top.get());
+    EXPECT_EQ(7u, wrapper.level + 2);
+    EXPECT_EQ(&flags.bits, wrapper.level.addressOfObj());
+
+    wrapper.level = 2;
+    EXPECT_EQ(0x12340021u, flags.bits);
+    ++wrapper.level;
+    wrapper.level += 1;
+    EXPECT_EQ(4u, wrapper.level.get());
+    EXPECT_EQ(4u, wrapper.level--);
+    EXPECT_EQ(3u, wrapper.level.get());
+
+    // Values are truncated to the width of the field.
+    wrapper.level = 9;
+    EXPECT_EQ(1u, wrapper.level.get());
+    wrapper.level -= 2;
+    EXPECT_EQ(7u, wrapper.level.get());
+    EXPECT_EQ(0x12340071u, flags.bits);
+
+    wrapper.isAdmin = 0;
+    wrapper.id ^= 0xFFFF;
+    EXPECT_EQ(0xEDCB0070u, flags.bits);
+
+    wrapper.top = 2;
+    EXPECT_EQ(0x81, flags.small);
+    static_assert(decltype(wrapper.top)::kMask == 3, "unexpected mask");
 }
 
 // ============================================================================================== //
-// [Function] testing                                                                             //
+// [AtomicField] testing                                                                          //
 // ============================================================================================== //
 
-class FunctionTest : public testing::Test
+class AtomicFieldTest : public testing::Test
 {
 protected:
-    static int add(int a, int b) { return a + b; }
-    Function<int(*)(int, int)> wrapAdd{&add};
-    static void magic(int& out) { out = 42; }
-    Function<void(*)(int&)> wrapMagic{&magic};
-
-    static int cVarArgSum(std::size_t numArgs, ...)
+    struct Counter
     {
-        va_list va;
-        va_start(va, numArgs);
-
-        int sum = 0;
-        for (std::size_t i = 0; i < numArgs; ++i)
-        {
-            sum += va_arg(va, int);
-        }
-
-        va_end(va);
-        return sum;
-    }
+        uint32_t refs;
+        bool     ready;
+        int64_t  total;
+        float    scale;
+    };
 
-    Function<int(*)(std::size_t, ...)> wrapCVarArgSum{&cVarArgSum};
-public:
-    FunctionTest() = default;
+    class WrapCounter : public AdvancedClassWrapper<sizeof(Counter)>
+    {
+        REMODEL_ADV_WRAPPER(WrapCounter)
+    public:
+        AtomicField<uint32_t> refs {this, offsetof(Counter, refs)};
+        AtomicField<bool>     ready{this, offsetof(Counter, ready)};
+        StaticAtomicField<int64_t, offsetof(Counter, total)> total{this};
+        AtomicField<float>    scale{this, offsetof(Counter, scale)};
+    };
 };
 
-TEST_F(FunctionTest, FunctionTest)
+TEST_F(AtomicFieldTest, AccessTest)
 {
-    EXPECT_EQ(add(1423,  6879), wrapAdd(1423, 6879 ));
-    EXPECT_EQ(add(-1423, 6879), wrapAdd(-1423, 6879));
+    Counter counter{1, false, 10, 1.f};
+    auto wrapper = wrapper_cast<WrapCounter>(&counter);
+
+    EXPECT_EQ(1u, wrapper.refs.load(std::memory_order_relaxed));
+    EXPECT_EQ(1u, wrapper.refs.fetchAdd(2, std::memory_order_relaxed));
+    EXPECT_EQ(4u, ++wrapper.refs);
+    EXPECT_EQ(6u, wrapper.refs += 2);
+    EXPECT_EQ(6u, wrapper.refs.fetchOr(1));
+    EXPECT_EQ(7u, counter.refs);
+    EXPECT_EQ(&counter.refs, wrapper.refs.addressOfObj());
+
+    wrapper.ready.store(true, std::memory_order_release);
+    EXPECT_TRUE(counter.ready);
+    EXPECT_TRUE(wrapper.ready.exchange(false));
+    EXPECT_FALSE(wrapper.ready);
+
+    int64_t expected = 11;
+    EXPECT_FALSE(wrapper.total.compareExchangeStrong(expected, 20));
+    EXPECT_EQ(10, expected);
+    EXPECT_TRUE(wrapper.total.compareExchangeStrong(expected, 20, std::memory_order_acq_rel));
+    EXPECT_EQ(20, counter.total);
+
+    float scale = wrapper.scale;
+    while (!wrapper.scale.compareExchangeWeak(scale, scale * 2.f)) {}
+    EXPECT_EQ(2.f, counter.scale);
+    wrapper.scale = 0.5f;
+    EXPECT_EQ(0.5f, counter.scale);
+}
 
-    int a = 0;
-    wrapMagic(a);
-    EXPECT_EQ(42, a);
+TEST_F(AtomicFieldTest, ConcurrencyTest)
+{
+    Counter counter{0, false, 0, 0.f};
+    auto wrapper = wrapper_cast<WrapCounter>(&counter);
 
-    EXPECT_EQ(15, cVarArgSum    (3, 1, 5, 9));
-    EXPECT_EQ(15, wrapCVarArgSum(3, 1, 5, 9));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            for (int j = 0; j < 10000; ++j)
+            {
+                wrapper.refs.fetchAdd(1, std::memory_order_relaxed);
+                wrapper.total.fetchSub(2, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(40000u, wrapper.refs.load());
+    EXPECT_EQ(-80000, wrapper.total.load());
 }
 
 // ============================================================================================== //
-// [MemberFunction] testing                                                                       //
+// [access] policies testing                                                                      //
 // ============================================================================================== //
 
-// We rely on the fact that the compiler handles member-function-pointers as regular function
-// pointers on the hood here (which is not guaranteed by the standard), so let's just perform
-// this test with MSVC for now (where we know that the stuff is implemented this way).
-#ifdef ZYCORE_MSVC
-
-class MemberFunctionTest : public testing::Test
+class AccessPolicyTest : public testing::Test
 {
 protected:
-    struct A
+    enum Mode : uint8_t { Idle, Busy };
+
+    struct State
     {
-        int c = 42;
-        int __thiscall add(int x, int y) { return x + y + c; }
-        void __thiscall magic(int& out) { out = 42; }
+        int32_t health;
+        float   scale;
+        bool    done;
+        Mode    mode;
+    };
 
-        int __cdecl cVarArgSum(std::size_t numArgs, ...)
-        {
-            va_list va;
-            va_start(va, numArgs);
+    class WrapState : public AdvancedClassWrapper<sizeof(State)>
+    {
+        REMODEL_ADV_WRAPPER(WrapState)
+    public:
+        Field<int32_t, OffsGetter, access::Relaxed> health{this, offsetof(State, health)};
+        Field<float, OffsGetter, access::Cached>    scale {this, offsetof(State, scale)};
+        Field<bool, OffsGetter, access::Volatile>   done  {this, offsetof(State, done)};
+        Field<Mode, OffsGetter, access::Volatile>   mode  {this, offsetof(State, mode)};
+        Field<int32_t, OffsGetter>                  plain {this, offsetof(State, health)};
+    };
 
-            int sum = 0;
-            for (std::size_t i = 0; i < numArgs; ++i)
-            {
-                sum += va_arg(va, int);
-            }
+    static int numResolves;
+    static int numLoads;
 
-            va_end(va);
-            return sum;
-        }
+    struct CountingGetter
+    {
+        void* operator () (void* raw) const { ++numResolves; return raw; }
     };
 
-    struct WrapA : ClassWrapper
+    struct CountingAccess
     {
-        REMODEL_WRAPPER(WrapA)
-    public:
-        int(A::*pAdd)(int, int){&A::add};
-        MemberFunction<int (__thiscall*)(int, int)> add{this, reinterpret_cast<uintptr_t&>(pAdd)};
+        template<typename T>
+        static T load(const T* obj) { ++numLoads; return *obj; }
 
-        void(A::*pMagic)(int&){&A::magic};
-        MemberFunction<void (__thiscall*)(int&)> magic{this, reinterpret_cast<uintptr_t&>(pMagic)};
+        template<typename T>
+        static void store(T* obj, T value) { *obj = value; }
+    };
 
-        int(A::*pCVarArgSum)(std::size_t, ...){&A::cVarArgSum};
-        MemberFunction<int (__cdecl*)(std::size_t, ...)> cVarArgSum{
-            this, reinterpret_cast<uintptr_t&>(pCVarArgSum)};
+    class WrapCounting : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapCounting)
+    public:
+        Field<int32_t, CountingGetter>                 plain  {this, CountingGetter{}};
+        Field<int32_t, CountingGetter, CountingAccess> policy {this, CountingGetter{}};
     };
-public:
-    MemberFunctionTest() = default;
-protected:
-    A a;
-    WrapA wrapA{wrapper_cast<WrapA>(&a)};
 };
 
-TEST_F(MemberFunctionTest, FunctionTest)
+int AccessPolicyTest::numResolves = 0;
+int AccessPolicyTest::numLoads = 0;
+
+TEST_F(AccessPolicyTest, AccessTest)
 {
-    EXPECT_EQ(a.add(1423,  6879), wrapA.add(1423, 6879 ));
-    EXPECT_EQ(a.add(-1423, 6879), wrapA.add(-1423, 6879));
+    State state{100, 2.f, false, Idle};
+    auto wrapper = wrapper_cast<WrapState>(&state);
+
+    int32_t health = wrapper.health;
+    EXPECT_EQ(100, health);
+    EXPECT_EQ(110, wrapper.health + 10);
+    EXPECT_TRUE(wrapper.health > 50);
+    wrapper.health -= 30;
+    EXPECT_EQ(70, state.health);
+    EXPECT_EQ(71, ++wrapper.health);
+    EXPECT_EQ(71, wrapper.health--);
+    EXPECT_EQ(70, state.health);
+    wrapper.health = 5;
+    EXPECT_EQ(5, state.health);
+    EXPECT_EQ(&state.health, wrapper.health.addressOfObj());
+
+    EXPECT_EQ(4.f, wrapper.scale * 2.f);
+    wrapper.scale *= 2.f;
+    EXPECT_EQ(4.f, state.scale);
+
+    EXPECT_FALSE(wrapper.done);
+    wrapper.done = true;
+    EXPECT_TRUE(state.done);
+    EXPECT_TRUE(!wrapper.done == false);
+
+    wrapper.mode = Busy;
+    EXPECT_EQ(Busy, state.mode);
+    EXPECT_TRUE(wrapper.mode == Busy);
+
+    // Plain fields still expose references.
+    int32_t& ref = wrapper.plain;
+    EXPECT_EQ(&state.health, &ref);
+}
 
-    int x = 0;
-    wrapA.magic(x);
-    EXPECT_EQ(42, x);
+TEST_F(AccessPolicyTest, VolatileTest)
+{
+    State state{0, 0.f, false, Idle};
+    auto wrapper = wrapper_cast<WrapState>(&state);
 
-    EXPECT_EQ(21, a.cVarArgSum    (5, 1, 6, 7, 8, -1));
-    EXPECT_EQ(21, wrapA.cVarArgSum(5, 1, 6, 7, 8, -1));
+    std::thread setter{[&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        wrapper.health = 1;
+        wrapper.done = true;
+    }};
+    // Reloaded on every iteration.
+    while (!wrapper.done) {}
+    setter.join();
+    EXPECT_EQ(1, wrapper.health);
 }
 
-#endif // ifdef ZYCORE_MSVC
+TEST_F(AccessPolicyTest, SingleResolutionTest)
+{
+    int32_t value = 0;
+    auto wrapper = wrapper_cast<WrapCounting>(&value);
+
+    numResolves = 0;
+    wrapper.plain += 5;
+    ++wrapper.plain;
+    wrapper.plain--;
+    wrapper.plain <<= 1;
+    EXPECT_EQ(4, numResolves);
+    EXPECT_EQ(10, value);
+
+    numResolves = 0;
+    numLoads = 0;
+    wrapper.policy += 5;
+    ++wrapper.policy;
+    EXPECT_EQ(16, wrapper.policy++);
+    --wrapper.policy;
+    EXPECT_EQ(4, numResolves);
+    EXPECT_EQ(4, numLoads);
+    EXPECT_EQ(16, value);
+}
 
 // ============================================================================================== //
-// [VirtualFunction] testing                                                                      //
+// Vector field testing                                                                           //
 // ============================================================================================== //
 
-// VF-Table layout is highly compiler-dependant, just perform this test with MSVC for now.
-#ifdef ZYCORE_MSVC
+#if defined(ZYCORE_GNUC)
+// Vector types lose their attributes as template arguments, fields don't depend on them.
+#   pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
 
-class VirtualFunctionTest : public testing::Test
+class VectorFieldTest : public testing::Test
 {
 protected:
-    struct A
+    struct alignas(16) Body
     {
-        int c = 42;
-        virtual int add(int x, int y) { return x + y + c; }
+        float   position[4];
+        float   velocity[4];
+        uint8_t pad;
+        uint8_t packed[16]; // misaligned floats
     };
 
-    struct WrapA : ClassWrapper
+    static float packedAt(const Body& body, int idx)
     {
-        REMODEL_WRAPPER(WrapA)
+        float value;
+        std::memcpy(&value, body.packed + idx * sizeof(float), sizeof(value));
+        return value;
+    }
+
+    class WrapBody : public AdvancedClassWrapper<sizeof(Body), 16>
+    {
+        REMODEL_ADV_WRAPPER(WrapBody)
     public:
-        VirtualFunction<int (__thiscall*)(int, int)> add{this, 0};
+        StaticField<simd::Vec4f, offsetof(Body, position)>       position{this};
+        Field<simd::Vec4f>                                        velocity{this, 16};
+        Field<simd::Vec4f, OffsGetter, access::Unaligned>         packed  {this, 33};
+#   if defined(REMODEL_SIMD_SSE2)
+        Field<__m128>                                             native  {this, 16};
+        Field<__m128, OffsGetter, access::Unaligned>              nativeU {this, 33};
+#   endif
     };
-public:
-    VirtualFunctionTest() = default;
-protected:
-    A a;
-    WrapA wrapA{wrapper_cast<WrapA>(&a)};
 };
 
-TEST_F(VirtualFunctionTest, FunctionTest)
+TEST_F(VectorFieldTest, AccessTest)
 {
-    EXPECT_EQ(a.add(1423,  6879), wrapA.add(1423, 6879 ));
-    EXPECT_EQ(a.add(-1423, 6879), wrapA.add(-1423, 6879));
+    static_assert(offsetof(Body, velocity) == 16 && offsetof(Body, packed) == 33,
+        "unexpected layout");
+
+    const float packedInit[] = {10.f, 20.f, 30.f, 40.f};
+    Body body{{1.f, 2.f, 3.f, 4.f}, {.5f, .5f, .5f, .5f}, 0, {}};
+    std::memcpy(body.packed, packedInit, sizeof(packedInit));
+    auto wrapper = wrapper_cast<WrapBody>(&body);
+
+    wrapper.position += wrapper.velocity.get() * 2.f;
+    EXPECT_EQ(2.f, body.position[0]);
+    EXPECT_EQ(5.f, body.position[3]);
+
+    simd::Vec4f packed = wrapper.packed;
+    EXPECT_EQ(30.f, packed[2]);
+    wrapper.packed = packed - wrapper.position.get();
+    EXPECT_EQ(17.f, packedAt(body, 1));
+    wrapper.packed *= simd::Vec4f::broadcast(2.f);
+    EXPECT_EQ(70.f, packedAt(body, 3));
+
+#   if defined(REMODEL_SIMD_SSE2)
+    wrapper.native = _mm_add_ps(wrapper.nativeU, wrapper.native.get());
+    EXPECT_EQ(16.5f, body.velocity[0]);
+    wrapper.nativeU = _mm_setzero_ps();
+    EXPECT_EQ(0.f, packedAt(body, 3));
+#   endif
 }
 
-#endif // ifdef ZYCORE_MSVC
+TEST_F(VectorFieldTest, FieldSpanTest)
+{
+    Body bodies[5] = {};
+    for (int i = 0; i < 5; ++i)
+    {
+        bodies[i].position[0] = static_cast<float>(i);
+    }
+
+    auto positions = makeFieldSpan(
+        WrapperRange<WrapBody>{bodies, 5}, &WrapBody::position);
+    std::vector<simd::Vec4f> column;
+    positions.copyTo(column);
+    for (auto& cur : column)
+    {
+        cur += simd::Vec4f{{1.f, 1.f, 1.f, 1.f}};
+    }
+    positions.copyFrom(column.data());
+
+    EXPECT_EQ(5.f, bodies[4].position[0]);
+    EXPECT_EQ(1.f, bodies[4].position[3]);
+}
 
 // ============================================================================================== //
-// [MyWrapperType::Instantiable] testing                                                          //
+// Typed PtrGetter testing                                                                        //
 // ============================================================================================== //
 
-int* hackyGlobalPtr = nullptr;
-
-class InstantiableTest : public testing::Test
+class TypedPtrGetterTest : public testing::Test
 {
 protected:
     struct A
     {
-        int    a;
-        float  b;
-        double c;
+        int32_t x;
+        int32_t y;
     };
 
-    struct WrapA
-        : AdvancedClassWrapper<sizeof(A)>
+    class WrapA : public ClassWrapper
     {
-        REMODEL_ADV_WRAPPER(WrapA)
+        REMODEL_WRAPPER(WrapA)
     public:
-        Field<int>    a{this, offsetof(A, a)};
-        Field<float>  b{this, offsetof(A, b)};
-        Field<double> c{this, offsetof(A, c)};
+        Field<int32_t, OffsGetter> x{this, offsetof(A, x)};
+        Field<int32_t, OffsGetter> y{this, OffsGetter{offsetof(A, y)}};
     };
 
-    struct WrapACustomCtor
-        : AdvancedClassWrapper<sizeof(A)>
+    static int add(int a, int b) { return a + b; }
+protected:
+    TypedPtrGetterTest()
+        : wrapA{wrapper_cast<WrapA>(&a)}
     {
-        REMODEL_ADV_WRAPPER(WrapACustomCtor)
-    public:
-        Field<int>    a{this, offsetof(A, a)};
-        Field<float>  b{this, offsetof(A, b)};
-        Field<double> c{this, offsetof(A, c)};
-    
-        void construct(int a_, float b_, double c_)
-        {
-            a = a_;
-            b = b_;
-            c = c_;
+        a.x = 10;
+        a.y = 20;
+    }
+protected:
+    A     a;
+    WrapA wrapA;
+};
+
+TEST_F(TypedPtrGetterTest, TypedPtrGetterTest)
+{
+    EXPECT_EQ(30, wrapA.x + wrapA.y);
+    wrapA.y *= 2;
+    EXPECT_EQ(40, a.y);
+
+    Function<int(*)(int, int), AbsGetter> wrapAdd{&add};
+    EXPECT_EQ(add(1423, 6879), wrapAdd(1423, 6879));
+
+    EXPECT_LT(sizeof(Field<int32_t, OffsGetter>), sizeof(Field<int32_t>));
+}
+
+// ============================================================================================== //
+// Snapshot testing                                                                               //
+// ============================================================================================== //
+
+class SnapshotTest : public StaticFieldTest {};
+
+TEST_F(SnapshotTest, SnapshotTest)
+{
+    auto wrapA = wrapB.a->toStrong();
+    auto snap  = snapshot(wrapA);
+
+    EXPECT_EQ(&b.a, snap.source());
+    EXPECT_NE(&b.a, snap.addressOfObj());
+    EXPECT_EQ(1234, snap.x);
+    EXPECT_EQ(4, snap.z[3]);
+
+    // Neither direction affects the other until refreshed.
+    b.a.x  = 2;
+    snap.y = 1.f;
+    EXPECT_EQ(1234, snap.x);
+    EXPECT_FLOAT_EQ(5.f, b.a.y);
+
+    auto copy = snap;
+    EXPECT_NE(snap.addressOfObj(), copy.addressOfObj());
+    EXPECT_FLOAT_EQ(1.f, copy.y);
+
+    snap.refresh();
+    EXPECT_EQ(2, snap.x);
+    EXPECT_FLOAT_EQ(5.f, snap.y);
+    EXPECT_EQ(1234, copy.x);
+}
+
+// ============================================================================================== //
+// Memory backend testing                                                                         //
+// ============================================================================================== //
+
+class MemoryBackendTest : public StaticFieldTest 
+{
+protected:
+    static uint32_t currentPid()
+    {
+#       if defined(ZYCORE_WINDOWS)
+            return GetCurrentProcessId();
+#       else
+            return static_cast<uint32_t>(getpid());
+#       endif
+    }
+
+    void testBackend(MemoryBackend& memory, std::function<void()> invalidate = []{},
+        B* target = nullptr)
+    {
+        auto& remote = target ? *target : b;
+        auto snap = readRemote<WrapA>(memory, &remote.a);
+        ASSERT_TRUE(snap.hasValue());
+        EXPECT_EQ(1234, snap.value().x);
+        EXPECT_EQ(2, snap.value().z[1]);
+
+        snap.value().x = 42;
+        EXPECT_EQ(1234, remote.a.x);
+        EXPECT_TRUE(snap.value().flush());
+        EXPECT_EQ(42, remote.a.x);
+
+        remote.a.y = 8.f;
+        invalidate();
+        EXPECT_TRUE(snap.value().refresh());
+        EXPECT_FLOAT_EQ(8.f, snap.value().y);
+
+        // Pointers inside of snapshots refer to the backend's address space.
+        RemoteSnapshot<WrapA> viaPtr{memory, reinterpret_cast<uintptr_t>(remote.pa)};
+        EXPECT_TRUE(viaPtr.refresh());
+        EXPECT_EQ(42, viaPtr.x);
+    }
+};
+
+TEST_F(MemoryBackendTest, LocalMemoryTest)
+{
+    LocalMemory memory;
+    testBackend(memory);
+}
+
+TEST_F(MemoryBackendTest, ProcessMemoryTest)
+{
+    ProcessMemory memory{currentPid()};
+    ASSERT_TRUE(memory.isValid());
+    testBackend(memory);
+
+    EXPECT_FALSE(readRemote<WrapA>(memory, static_cast<uintptr_t>(0)).hasValue());
+}
+
+TEST_F(MemoryBackendTest, CachedMemoryTest)
+{
+    // Whole pages of our own, so the page-sized reads of the cache stay in bounds.
+    const auto pageSize = CachedMemory::kPageSize;
+    std::unique_ptr<uint8_t[]> storage{new uint8_t[5 * pageSize]};
+    const auto pages = reinterpret_cast<uint8_t*>(
+        (reinterpret_cast<uintptr_t>(storage.get()) + pageSize - 1) & ~(pageSize - 1));
+    auto& target = *new (pages) B(b);
+    target.pa = &target.a;
+
+    struct CountingMemory : LocalMemory
+    {
+        uintptr_t begin, end;
+        int reads = 0;
+        bool read(uintptr_t address, void* out, std::size_t size) override
+        {
+            ++reads;
+            if (address < begin || end - address < size)
+            {
+                ADD_FAILURE() << "read out of bounds";
+                return false;
+            }
+            return LocalMemory::read(address, out, size);
         }
     };
 
-    struct WrapACustomDtor
-        : AdvancedClassWrapper<sizeof(A)>
+    CountingMemory counting;
+    counting.begin = reinterpret_cast<uintptr_t>(pages);
+    counting.end   = counting.begin + 4 * pageSize;
+    CachedMemory   memory{counting, 2};
+    testBackend(memory, [&]{ memory.invalidate(); }, &target);
+
+    // Fully cached from here on.
+    auto reads = counting.reads;
+    auto snap  = readRemote<WrapA>(memory, &target.a);
+    ASSERT_TRUE(snap.hasValue());
+    EXPECT_EQ(reads, counting.reads);
+    EXPECT_EQ(42, snap.value().x);
+    EXPECT_GT(memory.stats().hits, 0);
+
+    // Writes from the other side are only seen after invalidation.
+    target.a.x = 7;
+    EXPECT_TRUE(snap.value().refresh());
+    EXPECT_EQ(42, snap.value().x);
+    memory.invalidate();
+    EXPECT_TRUE(snap.value().refresh());
+    EXPECT_EQ(7, snap.value().x);
+    EXPECT_GT(counting.reads, reads);
+
+    // Reads crossing pages and page eviction.
+    const auto big = pages + pageSize;
+    for (std::size_t i = 0; i < 3 * pageSize; ++i) big[i] = static_cast<uint8_t>(i * 7);
+    uint8_t buf[CachedMemory::kPageSize + 64];
+    const auto addr = reinterpret_cast<uintptr_t>(big) + pageSize - 32;
+    ASSERT_TRUE(memory.read(addr, buf, sizeof(buf)));
+    EXPECT_EQ(0, std::memcmp(buf, big + pageSize - 32, sizeof(buf)));
+    ASSERT_TRUE(memory.read(reinterpret_cast<uintptr_t>(big), buf, 16));
+    EXPECT_EQ(0, std::memcmp(buf, big, 16));
+
+    uint8_t val = 0xAB;
+    ASSERT_TRUE(memory.write(reinterpret_cast<uintptr_t>(big) + 5, &val, 1));
+    ASSERT_TRUE(memory.read(reinterpret_cast<uintptr_t>(big), buf, 16));
+    EXPECT_EQ(0xAB, buf[5]);
+}
+
+TEST_F(MemoryBackendTest, ReadBatchTest)
+{
+    struct CountingMemory : ProcessMemory
     {
-        REMODEL_ADV_WRAPPER(WrapACustomDtor)
-    public:
-        Field<int>    a{this, offsetof(A, a)};
-        Field<float>  b{this, offsetof(A, b)};
-        Field<double> c{this, offsetof(A, c)};
+        int batches = 0;
+        std::size_t ranges = 0;
+        CountingMemory() : ProcessMemory{currentPid()} {}
+        bool readBatch(const platform::IoRange* r, std::size_t count) override
+        {
+            ++batches;
+            ranges += count;
+            return ProcessMemory::readBatch(r, count);
+        }
+    };
 
-        int* hackyPublicPtr = nullptr;
+    A others[3] = {{1, 1.f, {}}, {2, 2.f, {}}, {3, 3.f, {}}};
 
-        void destruct()
+    CountingMemory memory;
+    RemoteSnapshot<WrapA> snapA{memory, reinterpret_cast<uintptr_t>(&b.a)};
+    std::vector<RemoteSnapshot<WrapA>> snaps;
+    for (auto& cur : others)
+    {
+        snaps.emplace_back(memory, reinterpret_cast<uintptr_t>(&cur));
+    }
+
+    ReadBatch batch{memory};
+    batch.add(snapA, snapA.x);
+    batch.add(snapA, snapA.y); // adjacent, read in place
+    batch.add(snapA, snapA.x); // duplicate, staged
+    for (auto& cur : snaps)
+    {
+        batch.add(cur, cur.z);
+        batch.add(cur, cur.x);
+    }
+    int32_t raw = 0;
+    batch.add(reinterpret_cast<uintptr_t>(&b.a.z[2]), &raw, sizeof(raw));
+    ASSERT_TRUE(batch.submit());
+
+    EXPECT_EQ(1, memory.batches);
+    EXPECT_EQ(1234, snapA.x);
+    EXPECT_FLOAT_EQ(5.f, snapA.y);
+    EXPECT_EQ(0, snapA.z[0]); // not read
+    EXPECT_EQ(3, raw);
+    for (std::size_t i = 0; i < snaps.size(); ++i)
+    {
+        EXPECT_EQ(others[i].x, snaps[i].x);
+        EXPECT_FLOAT_EQ(0.f, snaps[i].y);
+    }
+
+    // Resubmission picks up changes.
+    others[2].x = 99;
+    ASSERT_TRUE(batch.submit());
+    EXPECT_EQ(99, snaps[2].x);
+    EXPECT_EQ(2, memory.batches);
+
+    batch.clear();
+    batch.add(0, &raw, sizeof(raw));
+    EXPECT_FALSE(batch.submit());
+}
+
+TEST_F(MemoryBackendTest, PrefetchTest)
+{
+    // Local prefetches are just hints, the data must be left alone.
+    auto local = wrapper_cast<WrapA>(&b.a);
+    prefetch(local, &WrapA::x, &WrapA::z);
+    prefetch(local);
+    EXPECT_EQ(1234, b.a.x);
+    EXPECT_EQ(4, b.a.z[3]);
+
+    // Remote prefetches queue reads in a batch instead.
+    LocalMemory memory;
+    RemoteSnapshot<WrapA> snap{memory, reinterpret_cast<uintptr_t>(&b.a)};
+    RemoteSnapshot<WrapA> whole{memory, reinterpret_cast<uintptr_t>(&b.a)};
+    ReadBatch batch{memory};
+    prefetch(batch, snap, &WrapA::x, &WrapA::z);
+    prefetch(batch, whole);
+    EXPECT_EQ(3, batch.size());
+    ASSERT_TRUE(batch.submit());
+    EXPECT_EQ(1234, snap.x);
+    EXPECT_EQ(4, snap.z[3]);
+    EXPECT_FLOAT_EQ(0.f, snap.y); // not read
+    EXPECT_FLOAT_EQ(5.f, whole.y);
+}
+
+TEST_F(MemoryBackendTest, LoadTest)
+{
+    auto local = wrapper_cast<WrapA>(&b.a);
+    auto values = load(local, &WrapA::x, &WrapA::y, &WrapA::z);
+    static_assert(std::is_same<std::tuple<uint32_t, float, std::array<int32_t, 4>>,
+        decltype(values)>::value, "unexpected value types");
+    EXPECT_EQ(1234, std::get<0>(values));
+    EXPECT_FLOAT_EQ(5.f, std::get<1>(values));
+    EXPECT_EQ(3, std::get<2>(values)[2]);
+
+    // Values are copies.
+    uint32_t x;
+    float y;
+    std::tie(x, y) = load(local, &WrapA::x, &WrapA::y);
+    b.a.x = 7;
+    EXPECT_EQ(1234, x);
+
+    // Remote loads are a single batch read.
+    struct CountingMemory : ProcessMemory
+    {
+        int batches = 0;
+        CountingMemory() : ProcessMemory{currentPid()} {}
+        bool readBatch(const platform::IoRange* r, std::size_t count) override
         {
-            *hackyPublicPtr = 42;
+            ++batches;
+            return ProcessMemory::readBatch(r, count);
+        }
+    } memory;
+    auto remote = load<WrapA>(memory, reinterpret_cast<uintptr_t>(&b.a), &WrapA::z, &WrapA::x);
+    ASSERT_TRUE(remote.hasValue());
+    EXPECT_EQ(1, memory.batches);
+    EXPECT_EQ(4, std::get<0>(remote.value())[3]);
+    EXPECT_EQ(7, std::get<1>(remote.value()));
+    EXPECT_FALSE(load<WrapA>(memory, 0, &WrapA::x).hasValue());
+}
+
+TEST_F(MemoryBackendTest, ShadowTest)
+{
+    struct CountingMemory : ProcessMemory
+    {
+        int reads = 0;
+        std::vector<std::size_t> writes;
+        CountingMemory() : ProcessMemory{currentPid()} {}
+        bool readBatch(const platform::IoRange* r, std::size_t count) override
+        {
+            ++reads;
+            return ProcessMemory::readBatch(r, count);
         }
+        bool writeBatch(const platform::IoRange* r, std::size_t count) override
+        {
+            for (std::size_t i = 0; i < count; ++i) writes.push_back(r[i].size);
+            return ProcessMemory::writeBatch(r, count);
+        }
+    } memory;
+
+    // Lines of 8 bytes: x and y share line 0, z spans lines 1 and 2.
+    Shadow<WrapA, 8> shadow{memory, reinterpret_cast<uintptr_t>(&b.a)};
+    EXPECT_EQ(0, memory.reads);
+    EXPECT_EQ(1234, shadow[&WrapA::x]);
+    EXPECT_EQ(1, memory.reads);
+    EXPECT_TRUE(shadow.isLineLoaded(0));
+    EXPECT_FALSE(shadow.isLineLoaded(1));
+    EXPECT_FLOAT_EQ(5.f, shadow[&WrapA::y]);
+    EXPECT_EQ(1, memory.reads);
+
+    // Writes stay local until flushed.
+    for (int i = 0; i < 10; ++i) shadow[&WrapA::x] += 1;
+    shadow[&WrapA::z][1] = 20;
+    EXPECT_EQ(2, memory.reads);
+    EXPECT_EQ(1234, b.a.x);
+    EXPECT_TRUE(shadow.isDirty());
+
+    // Only the changed bytes are written, in one batch: the low byte of x and of z[1].
+    b.a.y = 6.f;
+    ASSERT_TRUE(shadow.flush());
+    EXPECT_EQ(std::vector<std::size_t>({1, 1}), memory.writes);
+    EXPECT_EQ(1244, b.a.x);
+    EXPECT_EQ(20, b.a.z[1]);
+    EXPECT_FLOAT_EQ(6.f, b.a.y);
+    EXPECT_FALSE(shadow.isDirty());
+    EXPECT_TRUE(shadow.flush());
+    EXPECT_EQ(2u, memory.writes.size());
+
+    // Discarding reverts to the last flushed state, invalidating forgets all reads.
+    shadow[&WrapA::x] = 0;
+    shadow.discard();
+    EXPECT_EQ(1244, shadow.x);
+    shadow.invalidate();
+    EXPECT_FLOAT_EQ(6.f, shadow[&WrapA::y]);
+    EXPECT_TRUE(shadow.loadAll());
+    EXPECT_EQ(4, shadow.z[3]);
+    EXPECT_FALSE(shadow.hasFailed());
+
+    Shadow<WrapA> bad{memory, 0};
+    EXPECT_FALSE(bad.ensureFields(&WrapA::x, &WrapA::y));
+    EXPECT_TRUE(bad.hasFailed());
+}
+
+TEST_F(MemoryBackendTest, AsyncReaderTest)
+{
+    struct CountingMemory : ProcessMemory
+    {
+        int batches = 0;
+        CountingMemory() : ProcessMemory{currentPid()} {}
+        bool readBatch(const platform::IoRange* r, std::size_t count) override
+        {
+            ++batches;
+            return ProcessMemory::readBatch(r, count);
+        }
+    } memory;
+    AsyncReader reader{memory};
+
+    struct Result
+    {
+        int calls = 0;
+        bool success = false;
+    };
+    auto complete = [](void* context, bool success)
+    {
+        auto result = static_cast<Result*>(context);
+        ++result->calls;
+        result->success = success;
     };
 
-    static void pseudoCtor(int& ref)
+    // Reads queued by different tasks complete in one batch on the next tick.
+    uint32_t x = 0;
+    int32_t z[4] = {};
+    Result rx, rz;
+    reader.enqueue(reinterpret_cast<uintptr_t>(&b.a.x), &x, sizeof(x), complete, &rx);
+    reader.enqueue(reinterpret_cast<uintptr_t>(&b.a.z), z, sizeof(z), complete, &rz);
+    EXPECT_EQ(2u, reader.pending());
+    EXPECT_EQ(0, rx.calls);
+    EXPECT_EQ(2u, reader.tick());
+    EXPECT_EQ(1, memory.batches);
+    EXPECT_TRUE(rx.success && rz.success);
+    EXPECT_EQ(1234, x);
+    EXPECT_EQ(4, z[3]);
+    EXPECT_EQ(0u, reader.tick());
+
+    // A bad address only fails its own read.
+    Result rbad, rgood;
+    x = 0;
+    reader.enqueue(0, z, sizeof(z), complete, &rbad);
+    reader.enqueue(reinterpret_cast<uintptr_t>(&b.a.x), &x, sizeof(x), complete, &rgood);
+    EXPECT_EQ(2u, reader.tick());
+    EXPECT_EQ(1, rbad.calls);
+    EXPECT_FALSE(rbad.success);
+    EXPECT_TRUE(rgood.success);
+    EXPECT_EQ(1234, x);
+}
+
+TEST_F(MemoryBackendTest, WriteCombiningMemoryTest)
+{
+    struct CountingMemory : ProcessMemory
     {
-        ref = 42;
+        int writes = 0;
+        CountingMemory() : ProcessMemory{currentPid()} {}
+        bool write(uintptr_t address, const void* in, std::size_t size) override
+        {
+            ++writes;
+            return ProcessMemory::write(address, in, size);
+        }
+        bool writeBatch(const platform::IoRange* r, std::size_t count) override
+        {
+            ++writes;
+            return ProcessMemory::writeBatch(r, count);
+        }
+    };
+
+    CountingMemory counting;
+    WriteCombiningMemory memory{counting};
+
+    auto snap = readRemote<WrapA>(memory, &b.a);
+    ASSERT_TRUE(snap.hasValue());
+    auto& wrapA = snap.value();
+
+    wrapA.x    = 1;
+    wrapA.z[3] = 30;
+    wrapA.z[1] = 20;
+    EXPECT_TRUE(wrapA.flush(wrapA.x));
+    EXPECT_TRUE(wrapA.flush(wrapA.z));
+    wrapA.z[3] = 40;
+    EXPECT_TRUE(wrapA.flush(wrapA.z)); // overlapping
+    EXPECT_EQ(2, memory.pendingRanges());
+
+    // Adjacent to both, merging everything into one range.
+    wrapA.y = 9.f;
+    EXPECT_TRUE(wrapA.flush(wrapA.y));
+    EXPECT_EQ(1, memory.pendingRanges());
+
+    // Nothing written yet, but visible through the backend.
+    EXPECT_EQ(0, counting.writes);
+    EXPECT_EQ(1234, b.a.x);
+    int32_t z3 = 0;
+    EXPECT_TRUE(memory.read(reinterpret_cast<uintptr_t>(&b.a.z[3]), &z3, sizeof(z3)));
+    EXPECT_EQ(40, z3);
+
+    EXPECT_TRUE(memory.commit());
+    EXPECT_EQ(1, counting.writes);
+    EXPECT_EQ(0, memory.pendingRanges());
+    EXPECT_EQ(1, b.a.x);
+    EXPECT_FLOAT_EQ(9.f, b.a.y);
+    EXPECT_EQ(20, b.a.z[1]);
+    EXPECT_EQ(40, b.a.z[3]);
+
+    wrapA.x = 5;
+    EXPECT_TRUE(wrapA.flush());
+    memory.discard();
+    EXPECT_TRUE(memory.commit());
+    EXPECT_EQ(1, b.a.x);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+class DumpMemoryTest : public testing::Test
+{
+protected:
+    static const char* const kPath;
+
+    std::vector<uint8_t> file;
+
+    template<typename T>
+    void put(std::size_t offs, T val)
+    {
+        if (file.size() < offs + sizeof(T)) file.resize(offs + sizeof(T));
+        std::memcpy(file.data() + offs, &val, sizeof(T));
     }
 
-    static void pseudoDtor()
+    void writeFile()
     {
-        *hackyGlobalPtr = 42;
+        auto f = std::fopen(kPath, "wb");
+        ASSERT_NE(nullptr, f);
+        std::fwrite(file.data(), 1, file.size(), f);
+        std::fclose(f);
     }
-    
-    struct WrapACustomWrappedCtor
-        : AdvancedClassWrapper<sizeof(A)>
+
+    struct A { uint32_t x, y; };
+
+    class WrapA : public ClassWrapper
     {
-        REMODEL_ADV_WRAPPER(WrapACustomWrappedCtor)
+        REMODEL_WRAPPER(WrapA)
     public:
-        Function<void(*)(int&)> construct{&pseudoCtor};
+        StaticField<uint32_t, offsetof(A, y)> y{this};
     };
 
-    struct WrapACustomWrappedDtor
-        : AdvancedClassWrapper<sizeof(A)>
+    void fillData(std::size_t offs)
     {
-        REMODEL_ADV_WRAPPER(WrapACustomWrappedDtor)
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            put<uint32_t>(offs + i * 4, 1000 + i);
+        }
+    }
+
+    ~DumpMemoryTest()
+    {
+        std::remove(kPath);
+    }
+};
+
+const char* const DumpMemoryTest::kPath = "remodel_test_dump.bin";
+
+TEST_F(DumpMemoryTest, ElfCoreTest)
+{
+    if (sizeof(void*) != 8) return;
+
+    put<uint32_t>(0, 0x464C457F);           // magic
+    put<uint8_t >(4, 2);                    // ELFCLASS64
+    put<uint8_t >(5, 1);                    // little endian
+    put<uint16_t>(16, 4);                   // ET_CORE
+    put<uint64_t>(32, 64);                  // e_phoff
+    put<uint16_t>(54, 56);                  // e_phentsize
+    put<uint16_t>(56, 4);                   // e_phnum
+
+    const uint64_t segs[][3] = {            // type, vaddr, size
+        {1, 0x10040, 0x40}, {4, 0, 0}, {1, 0x10000, 0x40}, {1, 0x20000, 0x10}};
+    uint64_t dataOffs = 512;
+    for (int i = 0; i < 4; ++i)
+    {
+        const std::size_t ph = 64 + i * 56;
+        put<uint32_t>(ph, static_cast<uint32_t>(segs[i][0]));
+        put<uint64_t>(ph + 8,  dataOffs);
+        put<uint64_t>(ph + 16, segs[i][1]);
+        put<uint64_t>(ph + 32, segs[i][2]);
+        put<uint64_t>(ph + 40, segs[i][2] * 2); // memsz bigger than filesz
+        dataOffs += segs[i][2];
+    }
+    // File order differs from address order: 0x10040 comes first.
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        put<uint32_t>(512 + 0x40 + i * 4, 1000 + i);
+        put<uint32_t>(512 + i * 4, 1016 + i);
+    }
+    put<uint32_t>(512 + 0x80, 0xDEADBEEF);
+    put<uint32_t>(512 + 0x8C, 0);
+    writeFile();
+
+    DumpMemory dump{kPath};
+    ASSERT_TRUE(dump.isValid());
+    EXPECT_EQ(DumpMemory::Format::ElfCore, dump.format());
+    ASSERT_EQ(3, dump.segments().size());
+    EXPECT_EQ(0x10000, dump.segments()[0].address);
+
+    uint32_t val;
+    EXPECT_TRUE(dump.read(0x10000, &val, 4));
+    EXPECT_EQ(1000, val);
+    EXPECT_TRUE(dump.read(0x20000, &val, 4));
+    EXPECT_EQ(0xDEADBEEF, val);
+    EXPECT_FALSE(dump.read(0x20010, &val, 4));
+    EXPECT_EQ(nullptr, dump.translate(0x10000 + 0x3E, 4));
+
+    // Reads spanning contiguous segments.
+    uint32_t buf[4];
+    EXPECT_TRUE(dump.read(0x10038, buf, sizeof(buf)));
+    EXPECT_EQ(1014, buf[0]);
+    EXPECT_EQ(1017, buf[3]);
+
+    // Zero-copy wrappers on top of the mapping.
+    auto wrapA = wrapper_cast<WrapA>(dump.translate(0x10008, sizeof(A)));
+    EXPECT_EQ(1003, wrapA.y);
+    wrapA.y = 5;
+    EXPECT_TRUE(dump.read(0x1000C, &val, 4));
+    EXPECT_EQ(5, val);
+}
+
+TEST_F(DumpMemoryTest, MinidumpTest)
+{
+    put<uint32_t>(0, 0x504D444D);           // signature
+    put<uint32_t>(8, 2);                    // number of streams
+    put<uint32_t>(12, 32);                  // stream directory RVA
+    put<uint32_t>(32, 9);                   // Memory64ListStream
+    put<uint32_t>(40, 64);
+    put<uint32_t>(44, 5);                   // MemoryListStream
+    put<uint32_t>(52, 128);
+
+    put<uint64_t>(64, 2);                   // number of ranges
+    put<uint64_t>(72, 256);                 // base RVA
+    put<uint64_t>(80, 0x10000);
+    put<uint64_t>(88, 0x40);
+    put<uint64_t>(96, 0x10040);
+    put<uint64_t>(104, 0x40);
+
+    put<uint32_t>(128, 1);                  // number of ranges
+    put<uint64_t>(132, 0x20000);
+    put<uint32_t>(140, 0x10);
+    put<uint32_t>(144, 512);
+
+    fillData(256);
+    put<uint32_t>(512, 0xDEADBEEF);
+    put<uint32_t>(524, 0);
+    writeFile();
+
+    DumpMemory dump{kPath};
+    ASSERT_TRUE(dump.isValid());
+    EXPECT_EQ(DumpMemory::Format::Minidump, dump.format());
+    ASSERT_EQ(3, dump.segments().size());
+
+    uint32_t buf[4];
+    EXPECT_TRUE(dump.read(0x10038, buf, sizeof(buf)));
+    EXPECT_EQ(1014, buf[0]);
+    EXPECT_EQ(1017, buf[3]);
+    EXPECT_TRUE(dump.read(0x20000, buf, 4));
+    EXPECT_EQ(0xDEADBEEF, buf[0]);
+}
+
+TEST_F(DumpMemoryTest, InvalidTest)
+{
+    put<uint32_t>(0, 0x12345678);
+    writeFile();
+    EXPECT_FALSE(DumpMemory{kPath}.isValid());
+    EXPECT_FALSE(DumpMemory{"remodel_does_not_exist.bin"}.isValid());
+}
+
+// ============================================================================================== //
+// [SharedMemory] testing                                                                         //
+// ============================================================================================== //
+
+class SharedMemoryTest : public MemoryBackendTest
+{
+protected:
+    const std::string name = "/remodel_test_" + std::to_string(currentPid());
+
+    void TearDown() override
+    {
+        platform::removeSharedMemory(name.c_str());
+    }
+};
+
+TEST_F(SharedMemoryTest, ZeroCopyTest)
+{
+    using Channel = SpscChannel<uint64_t, 4>;
+    const std::size_t kObjects = 256;
+
+    // The agent's side.
+    SharedMemory agent{name.c_str(), 0x1000};
+    ASSERT_TRUE(agent.isValid());
+    EXPECT_EQ(0x1000, agent.size());
+    auto producer = Channel::create(agent.translate(0, sizeof(Channel)));
+    std::memcpy(agent.translate(kObjects, sizeof(A)), &b.a, sizeof(A));
+    EXPECT_TRUE(producer->push(kObjects));
+
+    // The tool's side, mapping the region a second time.
+    SharedMemory tool{name.c_str()};
+    ASSERT_TRUE(tool.isValid());
+    EXPECT_EQ(0x1000, tool.size());
+    auto consumer = Channel::attach(tool.translate(0, sizeof(Channel)));
+    uint64_t offset = 0;
+    ASSERT_TRUE(consumer->pop(offset));
+    EXPECT_FALSE(consumer->pop(offset));
+
+    auto a = wrapper_cast<WrapA>(tool.translate(offset, WrapA::kObjSize));
+    EXPECT_EQ(1234, a.x);
+    a.x = 42;
+    EXPECT_EQ(42, wrapper_cast<WrapA>(agent.translate(offset)).x);
+
+    auto snap = readRemote<WrapA>(tool, offset);
+    ASSERT_TRUE(snap.hasValue());
+    EXPECT_EQ(2, snap.value().z[1]);
+    EXPECT_FALSE(readRemote<WrapA>(tool, 0x1000 - 4).hasValue());
+
+    // Full channel.
+    for (uint64_t i = 0; i < Channel::kCapacity; ++i) EXPECT_TRUE(producer->push(i));
+    EXPECT_FALSE(producer->push(0));
+    EXPECT_EQ(Channel::kCapacity, consumer->size());
+}
+
+TEST_F(SharedMemoryTest, ThreadTest)
+{
+    using Channel = SpscChannel<uint32_t, 64>;
+    SharedMemory shm{name.c_str(), sizeof(Channel)};
+    ASSERT_TRUE(shm.isValid());
+    auto producer = Channel::create(shm.translate(0, sizeof(Channel)));
+    SharedMemory other{name.c_str()};
+    auto consumer = Channel::attach(other.translate(0, sizeof(Channel)));
+
+    const uint32_t kCount = 10000;
+    std::thread thread{[&]
+    {
+        for (uint32_t i = 1; i <= kCount; )
+        {
+            if (producer->push(i)) ++i; else std::this_thread::yield();
+        }
+    }};
+
+    uint64_t sum = 0;
+    for (uint32_t received = 0, value; received < kCount; )
+    {
+        if (consumer->pop(value))
+        {
+            EXPECT_EQ(++received, value);
+            sum += value;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    thread.join();
+    EXPECT_EQ(uint64_t{kCount} * (kCount + 1) / 2, sum);
+}
+
+// ============================================================================================== //
+// [LightClassWrapper] testing                                                                    //
+// ============================================================================================== //
+
+class LightClassWrapperTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int32_t x;
+        float   y;
+    };
+
+    class WrapA : public LightClassWrapper
+    {
+        REMODEL_LIGHT_WRAPPER(WrapA)
     public:
-        Function<void(*)()> destruct{&pseudoDtor};
+        StaticField<int32_t, offsetof(A, x)> x{this};
+        StaticField<float,   offsetof(A, y)> y{this};
     };
+
+    static WrapA makeWrapper(A* a) { return wrapper_cast<WrapA>(a); }
 protected:
-    InstantiableTest() = default;
+    A a[3] = {{1, 1.f}, {2, 2.f}, {3, 3.f}};
 };
 
-TEST_F(InstantiableTest, InstantiableTest)
+TEST_F(LightClassWrapperTest, LightClassWrapperTest)
 {
-    WrapA::Instantiable simple;
-    // Nothing more to check with the simple version, just create an instance here to force 
-    // compilation and to detect any possible compiler-time errors.
-    (void)simple;
+    static_assert(std::is_trivially_copy_constructible<WrapA>::value, 
+        "light wrappers should be trivially copy constructible");
+    static_assert(std::is_trivially_destructible<WrapA>::value, 
+        "light wrappers should be trivially destructible");
+    static_assert(!std::is_polymorphic<WrapA>::value, "light wrappers should not be polymorphic");
+
+    std::vector<WrapA> wrappers;
+    for (auto& cur : a)
+    {
+        wrappers.push_back(makeWrapper(&cur));
+    }
 
-    WrapACustomCtor::Instantiable customCtor{42, 43.f, 44.};
-    EXPECT_EQ       (42,   customCtor->a);
-    EXPECT_FLOAT_EQ (43.f, customCtor->b);
-    EXPECT_DOUBLE_EQ(44.,  customCtor->c);
+    // Copies have to refer to the copy's raw pointer.
+    auto copy = wrappers[1];
+    EXPECT_EQ(&a[1], copy.addressOfObj());
+    EXPECT_EQ(2, copy.x);
 
-    // The destructor alters the target of the pointer to 42 in case everything is working.
-    int x = 0;
+    copy = wrappers[2];
+    copy.y = 7.5f;
+    EXPECT_FLOAT_EQ(7.5f, a[2].y);
+    EXPECT_EQ(2, a[1].x);
+
+    int32_t sum = 0;
+    for (auto& cur : wrappers)
     {
-        WrapACustomDtor::Instantiable customDtor;
-        customDtor.hackyPublicPtr = &x;
+        sum += cur.x;
     }
-    EXPECT_EQ(42, x);
+    EXPECT_EQ(6, sum);
 }
 
-TEST_F(InstantiableTest, WrappedFunctionUsage)
+// ============================================================================================== //
+// [ChainGetter] testing                                                                          //
+// ============================================================================================== //
+
+class ChainGetterTest : public testing::Test
 {
-    int a = 0;
-    WrapACustomWrappedCtor::Instantiable customCtor{a};
-    (void)customCtor;
-    EXPECT_EQ(42, a);
+protected:
+    struct C { int32_t pad[2]; int32_t value; };
+    struct B { uint8_t pad[0x48]; C* c; };
+    struct A { uint8_t pad[0x10]; B* b; };
 
-    a = 0;
+    class WrapA : public ClassWrapper
     {
-        WrapACustomWrappedDtor::Instantiable customDtor;
-        hackyGlobalPtr = &a;
+        REMODEL_WRAPPER(WrapA)
+    public:
+        Field<int32_t, ChainGetter> value{this, ChainGetter{{0x10, 0x48, 0x8}}};
+        Field<int32_t>              valueErased{this, ChainGetter{{0x10, 0x48, 0x8}}};
+    };
+protected:
+    ChainGetterTest()
+    {
+        c1.value = 1;
+        c2.value = 2;
+        b.c = &c1;
+        a.b = &b;
     }
-    EXPECT_EQ(42, a);
+protected:
+    C c1, c2;
+    B b;
+    A a;
+};
+
+TEST_F(ChainGetterTest, ChainGetterTest)
+{
+    static_assert(offsetof(A, b) == 0x10 && offsetof(B, c) == 0x48 && offsetof(C, value) == 0x8,
+        "unexpected test struct layout");
+
+    auto wrapA = wrapper_cast<WrapA>(&a);
+    EXPECT_EQ(1, wrapA.value);
+    EXPECT_EQ(1, wrapA.valueErased);
+    wrapA.value = 5;
+    EXPECT_EQ(5, c1.value);
+
+    // Cached until invalidated.
+    b.c = &c2;
+    EXPECT_EQ(5, wrapA.value);
+    invalidateAll();
+    EXPECT_EQ(2, wrapA.value);
+    EXPECT_EQ(2, wrapA.valueErased);
+
+    // Absolute base with `Global`.
+    Field<int32_t, ChainGetter> global{
+        Global::instance(), ChainGetter{reinterpret_cast<uintptr_t>(&a), {0x10, 0x48, 0x8}}};
+    EXPECT_EQ(2, global);
+}
+
+TEST_F(ChainGetterTest, EpochTest)
+{
+    Epoch domain;
+    auto wrapA = wrapper_cast<WrapA>(&a);
+    Field<int32_t, ChainGetter> inDomain{wrapA.addressOfWrapper(), ChainGetter{{0x10, 0x48, 0x8}, domain}};
+
+    EXPECT_EQ(1, inDomain);
+    EXPECT_EQ(1, wrapA.value);
+    b.c = &c2;
+
+    // Bumping a domain only affects caches depending on it.
+    domain.bump();
+    EXPECT_EQ(2, inDomain);
+    EXPECT_EQ(1, wrapA.value);
+
+    b.c = &c1;
+    invalidateAll();
+    EXPECT_EQ(1, inDomain);
+    EXPECT_EQ(1, wrapA.value);
+
+    int resolves = 0;
+    EpochCache<int> cache;
+    EXPECT_FALSE(cache.isValid(domain));
+    EXPECT_EQ(7, cache.get(domain, [&] { return ++resolves, 7; }));
+    EXPECT_EQ(7, cache.get(domain, [&] { return ++resolves, 8; }));
+    EXPECT_EQ(1, resolves);
+    EXPECT_TRUE(cache.isValid(domain));
+    invalidateAll();
+    EXPECT_FALSE(cache.isValid(domain));
+    EXPECT_EQ(8, cache.get(domain, [&] { return ++resolves, 8; }));
+    cache.invalidate();
+    EXPECT_EQ(9, cache.get(domain, [&] { return ++resolves, 9; }));
+    EXPECT_EQ(3, resolves);
 }
 
+// ============================================================================================== //
+// [DynamicOffsGetter] + [TrailingArray] testing                                                  //
 // ============================================================================================== //
 
-} // anon namespace
+class DynamicLayoutTest : public testing::Test
+{
+protected:
+    // uint32_t count; uint16_t values[count]; uint32_t checksum;
+    struct Message
+    {
+        uint8_t bytes[64];
+    };
 
-int main(int argc, char* argv[])
+    class WrapMessage : public AdvancedClassWrapper<4>
+    {
+        REMODEL_ADV_WRAPPER(WrapMessage)
+    public:
+        int numResolves = 0;
+
+        Field<uint32_t>         count {this, 0};
+        TrailingArray<uint16_t> values{this, 4, [this] { return std::size_t{count}; }};
+        // Follows the 2-byte values, so it is not always 4-byte aligned.
+        Field<uint32_t, DynamicOffsGetter, access::Unaligned> checksum{this,
+            DynamicOffsGetter{[this](void*) {
+                ++numResolves;
+                return values.endOffset();
+            }}};
+    };
+
+    static void build(Message& message, uint32_t count)
+    {
+        std::memcpy(message.bytes, &count, sizeof(count));
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            const uint16_t value = static_cast<uint16_t>(i * 10);
+            std::memcpy(message.bytes + 4 + i * 2, &value, sizeof(value));
+        }
+        const uint32_t checksum = 0xC0FFEE00 + count;
+        std::memcpy(message.bytes + 4 + count * 2, &checksum, sizeof(checksum));
+    }
+};
+
+TEST_F(DynamicLayoutTest, TrailingArrayTest)
 {
-    testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
+    Message message;
+    build(message, 5);
+    auto wrapper = wrapper_cast<WrapMessage>(&message);
+
+    EXPECT_EQ(5, wrapper.values.size());
+    EXPECT_EQ(30, wrapper.values[3]);
+    EXPECT_EQ(100, std::accumulate(wrapper.values.begin(), wrapper.values.end(), 0));
+    EXPECT_EQ(14, wrapper.values.endOffset());
+    wrapper.values[0] = 7;
+    EXPECT_EQ(7, message.bytes[4]);
+}
+
+TEST_F(DynamicLayoutTest, MemoizationTest)
+{
+    Message first, second;
+    build(first, 5);
+    build(second, 2);
+
+    auto wrapper = wrapper_cast<WrapMessage>(&first);
+    EXPECT_EQ(0xC0FFEE05, wrapper.checksum);
+    EXPECT_EQ(0xC0FFEE05, wrapper.checksum);
+    EXPECT_EQ(1, wrapper.numResolves);
+
+    // Rebinding recomputes the offset.
+    wrapper.rebind(&second);
+    EXPECT_EQ(0xC0FFEE02, wrapper.checksum);
+    EXPECT_EQ(2, wrapper.numResolves);
+
+    // Layout changes in place require bumping the epoch.
+    build(second, 3);
+    invalidateAll();
+    EXPECT_EQ(0xC0FFEE03, wrapper.checksum);
+    EXPECT_EQ(3, wrapper.numResolves);
+}
+
+// ============================================================================================== //
+// [ClassView] testing                                                                            //
+// ============================================================================================== //
+
+class ClassViewTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        uint32_t x;
+        float    y;
+    };
+
+    struct B
+    {
+        int32_t  i;
+        A        a;
+        A*       pa;
+        int32_t  arr[3];
+        int32_t* pi;
+    };
+
+    class WrapA : public AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapA)
+    public:
+        StaticField<uint32_t, offsetof(A, x)> x{this};
+        StaticField<float,    offsetof(A, y)> y{this};
+    };
+
+    class ViewB : public ClassView
+    {
+        REMODEL_VIEW(ViewB)
+    public:
+        REMODEL_VIEW_FIELD(int32_t,    i,   offsetof(B, i))
+        REMODEL_VIEW_FIELD(WrapA,      a,   offsetof(B, a))
+        REMODEL_VIEW_FIELD(WrapA*,     pa,  offsetof(B, pa))
+        REMODEL_VIEW_FIELD(int32_t[3], arr, offsetof(B, arr))
+        REMODEL_VIEW_FIELD(int32_t&,   ri,  offsetof(B, pi))
+    };
+
+    struct C
+    {
+        int64_t k;
+        B       b;
+    };
+
+    class ViewC : public ClassView
+    {
+        REMODEL_VIEW(ViewC)
+    public:
+        REMODEL_VIEW_NESTED(ViewB, b, offsetof(C, b))
+    };
+
+    class WrapC : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapC)
+    public:
+        REMODEL_VIEW_NESTED(ViewB, b, offsetof(C, b))
+    };
+protected:
+    ClassViewTest()
+    {
+        b.i   = 42;
+        b.a   = {1234, 5.f};
+        b.pa  = &b.a;
+        b.arr[0] = 1; b.arr[1] = 2; b.arr[2] = 3;
+        b.pi  = &b.i;
+    }
+protected:
+    B b;
+};
+
+TEST_F(ClassViewTest, ClassViewTest)
+{
+    static_assert(std::is_trivially_copyable<ViewB>::value, "views should be trivially copyable");
+    static_assert(sizeof(void*) == sizeof(ViewB), "views should be pointer-sized");
+
+    auto viewB = wrapper_cast<ViewB>(&b);
+    EXPECT_EQ(&b, viewB.addressOfObj());
+
+    EXPECT_EQ(42, viewB.i());
+    viewB.i() += 3;
+    EXPECT_EQ(45, b.i);
+    EXPECT_EQ(45, viewB.ri());
+    ++viewB.ri();
+    EXPECT_EQ(46, b.i);
+
+    EXPECT_EQ(1234, viewB.a().toStrong().x);
+    viewB.pa()->toStrong().y = 2.5f;
+    EXPECT_FLOAT_EQ(2.5f, b.a.y);
+
+    EXPECT_EQ(3, viewB.arr()[2]);
+    viewB.arr()[0] = 7;
+    EXPECT_EQ(7, b.arr[0]);
+
+    const ViewB cviewB = viewB;
+    EXPECT_EQ(46, cviewB.i());
+}
+
+TEST_F(ClassViewTest, NestedViewTest)
+{
+    C c{};
+    c.b.i = 7;
+    c.b.arr[1] = 11;
+
+    const auto viewC = wrapper_cast<ViewC>(&c);
+    EXPECT_EQ(&c.b, viewC.b().addressOfObj());
+    EXPECT_EQ(7, viewC.b().i());
+    viewC.b().i() = 8;
+    EXPECT_EQ(8, c.b.i);
+
+    auto wrapC = wrapper_cast<WrapC>(&c);
+    EXPECT_EQ(11, wrapC.b().arr()[1]);
+}
+
+// ============================================================================================== //
+// [WrapperRange] testing                                                                         //
+// ============================================================================================== //
+
+class WrapperRangeTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int32_t x;
+        int16_t y;
+    };
+
+    class WrapA : public AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapA)
+    public:
+        StaticField<int32_t, offsetof(A, x)> x{this};
+        Field<int16_t>                       y{this, offsetof(A, y)};
+    };
+
+    class ViewA : public ClassView
+    {
+        REMODEL_VIEW(ViewA)
+    public:
+        REMODEL_VIEW_FIELD(int32_t, x, offsetof(A, x))
+    };
+protected:
+    WrapperRangeTest()
+    {
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            a[i] = {i, static_cast<int16_t>(i * 2)};
+        }
+    }
+protected:
+    A a[100];
+};
+
+TEST_F(WrapperRangeTest, WrapperRangeTest)
+{
+    auto wrapA = wrapper_cast<WrapA>(&a[0]);
+    wrapA.rebind(&a[10]);
+    EXPECT_EQ(10, wrapA.x);
+    EXPECT_EQ(20, wrapA.y);
+
+    int32_t sum = 0;
+    for (auto& cur : WrapperRange<WrapA>{a, 100})
+    {
+        sum += cur.x;
+        ++cur.y;
+    }
+    EXPECT_EQ(4950, sum);
+    EXPECT_EQ(199, a[99].y);
+
+    // Every other element, iterated via a view.
+    WrapperRange<ViewA> evenRange{a, 50, 2 * sizeof(A)};
+    EXPECT_EQ(50, evenRange.size());
+    EXPECT_EQ(98, evenRange[49].x());
+
+    sum = 0;
+    for (auto& cur : evenRange)
+    {
+        sum += cur.x();
+    }
+    EXPECT_EQ(2450, sum);
+}
+
+// ============================================================================================== //
+// [Handle] testing                                                                               //
+// ============================================================================================== //
+
+class HandleTest : public WrapperRangeTest {};
+
+TEST_F(HandleTest, HandleTest)
+{
+    std::vector<Handle<WrapA>> handles;
+    for (auto& cur : a) handles.emplace_back(&cur);
+
+    int32_t sum = 0;
+    for (auto cur : handles) sum += cur.with([](WrapA& wrapA) { return int32_t{wrapA.x}; });
+    EXPECT_EQ(4950, sum);
+    EXPECT_EQ(20, handles[10].get().y);
+
+    // Views are materialized directly.
+    Handle<ViewA> view{&a[42]};
+    EXPECT_EQ(42, view.with([](ViewA& cur) { return cur.x(); }));
+    EXPECT_EQ(view, Handle<ViewA>{wrapper_cast<ViewA>(&a[42])});
+
+    // Handles of different types share untyped containers.
+    std::vector<Handle<>> mixed{handles[5], view};
+    EXPECT_EQ(5, mixed[0].cast<WrapA>().get().x);
+    EXPECT_EQ(42, mixed[1].cast<ViewA>().get().x());
+    EXPECT_TRUE(static_cast<bool>(mixed[0]));
+    EXPECT_FALSE(static_cast<bool>(Handle<>{nullptr}));
+}
+
+TEST_F(HandleTest, CompressedPtrTest)
+{
+    struct Region;
+    using ARegion = PtrRegion<Region, 3>;
+    ARegion::setBase(reinterpret_cast<uint8_t*>(a) - 8);
+    EXPECT_TRUE(ARegion::contains(&a[99]));
+    EXPECT_FALSE(ARegion::contains(&a[0].y));
+
+    using APtr = CompressedPtr<WrapA, ARegion>;
+    std::vector<APtr> ptrs;
+    for (auto& cur : a) ptrs.emplace_back(&cur);
+    EXPECT_EQ(1u, ptrs[0].value());
+    EXPECT_EQ(&a[42], ptrs[42].raw());
+    EXPECT_EQ(84, ptrs[42].get().y);
+    EXPECT_EQ(99, ptrs[99].with([](WrapA& cur) { return int32_t{cur.x}; }));
+    EXPECT_FALSE(static_cast<bool>(APtr{nullptr}));
+    EXPECT_EQ(nullptr, APtr{nullptr}.raw());
+
+    // Decoding pointers of 32 bit targets with the default region.
+    EXPECT_EQ(reinterpret_cast<void*>(0x401000),
+        (CompressedPtr<WrapA>::fromValue(0x401000).raw()));
+}
+
+// ============================================================================================== //
+// [TargetPtr] testing                                                                            //
+// ============================================================================================== //
+
+class TargetPtrTest : public testing::Test
+{
+protected:
+    // A 32 bit list node, `{ uint32_t value; Node32* next; }`.
+    class WrapNode32 : public AdvancedClassWrapper<8>
+    {
+        REMODEL_ADV_WRAPPER(WrapNode32)
+    public:
+        Field<uint32_t> value{this, 0};
+        Field<Ptr32<WrapNode32>> next{this, 4};
+    };
+
+    // Maps a buffer to addresses of a fake 32 bit target.
+    struct Memory32 : MemoryBackend
+    {
+        static constexpr uintptr_t kBase = 0x10000;
+        uint8_t data[64] = {};
+
+        bool read(uintptr_t address, void* out, std::size_t size) override
+        {
+            if (address < kBase || address + size > kBase + sizeof(data)) return false;
+            std::memcpy(out, data + (address - kBase), size);
+            return true;
+        }
+
+        bool write(uintptr_t address, const void* in, std::size_t size) override
+        {
+            if (address < kBase || address + size > kBase + sizeof(data)) return false;
+            std::memcpy(data + (address - kBase), in, size);
+            return true;
+        }
+
+        void put(uintptr_t address, uint32_t value) { write(address, &value, sizeof(value)); }
+    };
+
+    Memory32 memory;
+};
+
+TEST_F(TargetPtrTest, RemoteTest)
+{
+    // Node at 0x10000 -> node at 0x10010 -> null.
+    memory.put(0x10000, 7);
+    memory.put(0x10004, 0x10010);
+    memory.put(0x10010, 9);
+    memory.put(0x10014, 0);
+
+    std::vector<uint32_t> values;
+    for (Ptr32<WrapNode32> cur{0x10000}; cur; )
+    {
+        auto node = readRemote(memory, cur);
+        ASSERT_TRUE(node.hasValue());
+        values.push_back(node.value()->value);
+        cur = node.value()->next;
+    }
+    EXPECT_EQ((std::vector<uint32_t>{7, 9}), values);
+    EXPECT_FALSE(readRemote(memory, Ptr32<WrapNode32>{0x20000}).hasValue());
+
+    // Arithmetic uses the size of objects in the target.
+    EXPECT_EQ(0x10008u, (Ptr32<WrapNode32>{0x10000} + 1).address());
+    EXPECT_EQ(0x10004u, (Ptr32<Ptr32<void>>{0x10000} + 1).address());
+    EXPECT_EQ(0x10008u, (Ptr64<Ptr64<void>>{0x10000} + 1).address());
+    EXPECT_EQ(9u, readTarget(memory, Ptr32<uint32_t>{0x10010}).value());
+}
+
+TEST_F(TargetPtrTest, VirtualFunctionTest)
+{
+    // Object at 0x10020 with its vftable pointer at offset 4, table at 0x10030.
+    memory.put(0x10024, 0x10030);
+    memory.put(0x10030, 0x401000);
+    memory.put(0x10034, 0x401100);
+
+    auto func = readVirtualFunction<uint32_t>(memory, 0x10020, 1, 4);
+    ASSERT_TRUE(func.hasValue());
+    EXPECT_EQ(0x401100u, func.value());
+    EXPECT_FALSE(readVirtualFunction<uint32_t>(memory, 0x10020, 1).hasValue());
+}
+
+// ============================================================================================== //
+// [REMODEL_FIELDS] testing                                                                       //
+// ============================================================================================== //
+
+class LayoutTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int32_t x;
+        float   y;
+        int16_t z[3];
+        A*      next;
+    };
+
+    class WrapA : public AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapA)
+    public:
+        REMODEL_FIELDS(
+            (x,    int32_t,    offsetof(A, x)),
+            (y,    float,      offsetof(A, y)),
+            (z,    int16_t[3], offsetof(A, z)),
+            (next, A*,         offsetof(A, next))
+        )
+    };
+
+    class ViewA : public ClassView
+    {
+        REMODEL_VIEW(ViewA)
+    public:
+        REMODEL_FIELDS((y, float, offsetof(A, y)))
+    };
+
+    class WrapLines : public AdvancedClassWrapper<256>
+    {
+        REMODEL_ADV_WRAPPER(WrapLines)
+    public:
+        REMODEL_FIELDS(
+            (hp,    int32_t,  0),
+            (name,  char[24], 4),
+            (pos,   uint64_t, 60),
+            (flags, uint32_t, 68),
+            (cold,  uint32_t, 200)
+        )
+    };
+
+    // Visitor collecting names of differing fields.
+    struct Differ
+    {
+        const WrapA* other;
+        std::vector<std::string> changed;
+
+        template<typename T>
+        void operator () (const FieldInfo& info, const T& value)
+        {
+            auto otherRaw = static_cast<const uint8_t*>(other->addressOfObj()) + info.offset;
+            if (std::memcmp(&value, otherRaw, sizeof(T)) != 0) changed.push_back(info.name);
+        }
+    };
+
+    // Visitor incrementing arithmetic fields.
+    struct Incrementer
+    {
+        void operator () (const FieldInfo&, int32_t& value) { ++value; }
+        void operator () (const FieldInfo&, float& value) { value += 1.f; }
+        template<typename T> void operator () (const FieldInfo&, T&) {}
+    };
+};
+
+TEST_F(LayoutTest, AccessTest)
+{
+    A a{1, 2.f, {3, 4, 5}, nullptr};
+    A b{6, 7.f, {8, 9, 10}, &a};
+    auto wrapper = wrapper_cast<WrapA>(&b);
+
+    EXPECT_EQ(6, wrapper.x());
+    ++wrapper.x();
+    EXPECT_EQ(7, b.x);
+    EXPECT_EQ(9, wrapper.z()[1]);
+    EXPECT_EQ(1, wrapper_cast<WrapA>(wrapper.next()).x());
+    EXPECT_FLOAT_EQ(2.f, wrapper_cast<ViewA>(&a).y());
+
+    // Accessors don't take any storage.
+    EXPECT_EQ(sizeof(AdvancedClassWrapper<sizeof(A)>), sizeof(WrapA));
+    EXPECT_EQ(sizeof(void*), sizeof(ViewA));
+}
+
+TEST_F(LayoutTest, TableTest)
+{
+    using L = WrapA::Layout;
+    static_assert(L::kNumFields == 4, "unexpected field count");
+    static_assert(L::kEnd == sizeof(A), "unexpected layout end");
+    static_assert(!L::kHasOverlap, "unexpected overlap");
+    static_assert(L::At<2>::kOffset == offsetof(A, z) && L::At<2>::kSize == 6, "bad entry");
+    static_assert(std::is_same<L::At<1>::Type, float>::value, "bad entry type");
+    static_assert(L::At<3>::kSize == sizeof(void*), "bad pointer entry");
+
+    using Overlapping = Layout<
+        internal::LayoutEntry<int32_t, 0>, internal::LayoutEntry<int16_t, 4>, 
+        internal::LayoutEntry<int32_t, 5>>;
+    static_assert(Overlapping::kHasOverlap, "overlap not detected");
+    static_assert(Overlapping::kEnd == 9, "unexpected layout end");
+
+    auto infos = WrapA::fieldInfos();
+    EXPECT_STREQ("x", infos[0].name);
+    EXPECT_STREQ("next", infos[3].name);
+    EXPECT_EQ(offsetof(A, y), infos[1].offset);
+    EXPECT_EQ(6, infos[2].size);
+}
+
+TEST_F(LayoutTest, ForEachFieldTest)
+{
+    A a{1, 2.5f, {3, 4, 5}, nullptr};
+    auto wrapper = wrapper_cast<WrapA>(&a);
+
+    std::vector<std::string> names;
+    std::size_t totalSize = 0;
+    forEachField(wrapper, [&](const FieldInfo& info, const auto& value) {
+        names.push_back(info.name);
+        totalSize += sizeof(value);
+        EXPECT_EQ(info.size, sizeof(value));
+        EXPECT_EQ(reinterpret_cast<const uint8_t*>(&a) + info.offset,
+            reinterpret_cast<const uint8_t*>(&value));
+    });
+    EXPECT_EQ((std::vector<std::string>{"x", "y", "z", "next"}), names);
+    EXPECT_EQ(4 + 4 + 6 + sizeof(void*), totalSize);
+
+    // Typed visitor, e.g. for differs.
+    A b = a;
+    b.z[2] = 42;
+    b.y = 1.f;
+    const auto other = wrapper_cast<WrapA>(&b);
+    Differ differ{&other, {}};
+    forEachField(wrapper, differ);
+    EXPECT_EQ((std::vector<std::string>{"y", "z"}), differ.changed);
+
+    // Non-const wrappers hand out mutable references.
+    forEachField(wrapper, Incrementer{});
+    EXPECT_EQ(2, a.x);
+    EXPECT_EQ(3.5f, a.y);
+}
+
+TEST_F(LayoutTest, CacheLineTest)
+{
+    using L = WrapLines::Layout;
+    static_assert(L::At<1>::firstLine() == 0 && L::At<1>::lastLine() == 0, "bad lines");
+    static_assert(L::At<2>::crossesLine() && L::At<2>::lastLine() == 1, "bad lines");
+    static_assert(L::numCrossingFields() == 1, "unexpected crossing fields");
+    static_assert(L::numCrossingFields<16>() == 2, "unexpected crossing fields");
+    static_assert(WrapA::Layout::numCrossingFields() == 0, "unexpected crossing fields");
+
+    auto report = analyzeCacheLines<WrapLines>();
+    ASSERT_EQ(3, report.lines().size());
+    EXPECT_EQ(3, report.lines()[2].index);
+    ASSERT_EQ(1, report.crossing().size());
+    EXPECT_STREQ("pos", report.crossing()[0].name);
+
+    auto shared = report.shared();
+    ASSERT_EQ(2, shared.size());
+    EXPECT_EQ(3, shared[0]->fields.size());
+    EXPECT_STREQ("flags", shared[1]->fields[1].name);
+
+    // Accesses of fields crossing lines count for both, others for the line of the offset.
+    EXPECT_TRUE(report.addAccesses(0, 5));
+    EXPECT_TRUE(report.addAccesses(64, 10));
+    EXPECT_TRUE(report.addAccesses(130, 3));
+    EXPECT_FALSE(report.addAccesses(-8, 1));
+#   if defined(REMODEL_PROFILE)
+    EXPECT_EQ(2, report.addProfile({
+        {profile::AccessKind::Field, "WrapLines", 68, 2},
+        {profile::AccessKind::Call, "WrapLines", 68, 100},
+        {profile::AccessKind::Field, "WrapA", 68, 7},
+    }, "WrapLines"));
+#   else
+    report.addAccesses(68, 2);
+#   endif
+
+    auto hottest = report.hottest();
+    ASSERT_EQ(3, hottest.size());
+    EXPECT_EQ(0, hottest[0]->index);
+    EXPECT_EQ(15, hottest[0]->accesses);
+    EXPECT_EQ(12, hottest[1]->accesses);
+    EXPECT_EQ(2, hottest[2]->index);
+    EXPECT_TRUE(hottest[2]->fields.empty());
+
+    EXPECT_EQ(
+        "line 0 +0x0: hp name pos* (15 accesses)\n"
+        "line 1 +0x40: pos* flags (12 accesses)\n"
+        "line 2 +0x80: (3 accesses)\n"
+        "line 3 +0xc0: cold\n",
+        report.toText());
+}
+
+// ============================================================================================== //
+// [EndianValue] testing                                                                          //
+// ============================================================================================== //
+
+class EndianTest : public testing::Test
+{
+protected:
+#pragma pack(push, 1)
+    struct Header
+    {
+        uint8_t  bytes[2];
+        uint32_t seq;
+        uint32_t ack;
+    };
+#pragma pack(pop)
+
+    class WrapHeader : public AdvancedClassWrapper<sizeof(Header)>
+    {
+        REMODEL_ADV_WRAPPER(WrapHeader)
+    public:
+        Field<BigEndian<uint16_t>>                              port{this, offsetof(Header, bytes)};
+        StaticField<BigEndian<uint32_t>, offsetof(Header, seq)> seq {this};
+        Field<LittleEndian<uint32_t>>                           ack {this, offsetof(Header, ack)};
+    };
+
+    static uint32_t bytesToBig(const uint8_t* bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) << 24 | bytes[1] << 16 | bytes[2] << 8 | bytes[3];
+    }
+};
+
+TEST_F(EndianTest, FieldTest)
+{
+    Header header{{0x1F, 0x90}, 0, 0};
+    auto wrapper = wrapper_cast<WrapHeader>(&header);
+    EXPECT_EQ(8080, wrapper.port);
+
+    wrapper.seq = 0x11223344;
+    EXPECT_EQ(0x11223344u, bytesToBig(reinterpret_cast<uint8_t*>(&header.seq)));
+    wrapper.seq += 0x100;
+    ++wrapper.seq;
+    EXPECT_EQ(0x11223445u, wrapper.seq.get());
+    EXPECT_TRUE(wrapper.seq == 0x11223445u);
+    EXPECT_EQ(0x11223446u, wrapper.seq + 1);
+    uint32_t seq = wrapper.seq;
+    EXPECT_EQ(0x11223445u, seq);
+
+    wrapper.ack = 7;
+    EXPECT_EQ(7u, wrapper.ack);
+    EXPECT_EQ(7, reinterpret_cast<uint8_t*>(&header.ack)[0]);
+
+    // Plain structures can use endian values as well.
+    BigEndian<float> f = 2.5f;
+    EXPECT_FLOAT_EQ(2.5f, f);
+    EXPECT_EQ(sizeof(float), sizeof(f));
+    EXPECT_TRUE(std::is_trivial<BigEndian<uint64_t>>::value);
+}
+
+TEST_F(EndianTest, ByteSwapArrayTest)
+{
+    std::vector<uint16_t> u16(37);
+    std::vector<uint32_t> u32(37);
+    std::vector<uint64_t> u64(37);
+    for (uint32_t i = 0; i < 37; ++i)
+    {
+        u16[i] = static_cast<uint16_t>(i * 0x0101 + 1);
+        u32[i] = i * 0x01020304;
+        u64[i] = i * 0x0102030405060708ull;
+    }
+    simd::byteSwapArray(u16.data(), u16.size());
+    simd::byteSwapArray(u32.data(), u32.size());
+    simd::byteSwapArray(u64.data(), u64.size());
+    for (uint32_t i = 0; i < 37; ++i)
+    {
+        EXPECT_EQ(simd::byteSwap(static_cast<uint16_t>(i * 0x0101 + 1)), u16[i]);
+        EXPECT_EQ(simd::byteSwap(static_cast<uint32_t>(i * 0x01020304)), u32[i]);
+        EXPECT_EQ(simd::byteSwap(static_cast<uint64_t>(i * 0x0102030405060708ull)), u64[i]);
+    }
+    EXPECT_EQ(0x78563412u, simd::byteSwap(static_cast<uint32_t>(0x12345678)));
+}
+
+TEST_F(EndianTest, SpanTest)
+{
+    Header headers[50];
+    auto range = WrapperRange<WrapHeader>{headers, 50};
+    for (uint32_t i = 0; i < 50; ++i) range[i].seq = i * 1000;
+
+    auto seqs = makeFieldSpan(range, &WrapHeader::seq);
+    std::vector<uint32_t> values(50);
+    seqs.gatherValues(values.data());
+    EXPECT_EQ(49000u, values[49]);
+    EXPECT_EQ(1000u, values[1]);
+
+    for (auto& value : values) value += 1;
+    std::vector<uint32_t> scratch(50);
+    seqs.scatterValues(values.data(), scratch.data());
+    EXPECT_EQ(25001u, range[25].seq.get());
+    EXPECT_EQ(49001u, bytesToBig(reinterpret_cast<uint8_t*>(&headers[49].seq)));
+}
+
+// ============================================================================================== //
+// [FieldSpan] testing                                                                            //
+// ============================================================================================== //
+
+class FieldSpanTest : public WrapperRangeTest {};
+
+TEST_F(FieldSpanTest, FieldSpanTest)
+{
+    auto xs = makeFieldSpan(WrapperRange<WrapA>{a, 100}, &WrapA::x);
+    EXPECT_EQ(100, xs.size());
+    EXPECT_EQ(42, xs[42]);
+    EXPECT_EQ(4950, std::accumulate(xs.begin(), xs.end(), 0));
+    EXPECT_EQ(100, xs.end() - xs.begin());
+    EXPECT_EQ(57, *(xs.begin() + 57));
+    EXPECT_EQ(&a[99].x, &xs.end()[-1]);
+
+    std::vector<int32_t> column;
+    xs.copyTo(column);
+    ASSERT_EQ(100, column.size());
+    EXPECT_EQ(99, column[99]);
+
+    for (auto& cur : column)
+    {
+        cur *= 3;
+    }
+    xs.copyFrom(column.data());
+    EXPECT_EQ(297, a[99].x);
+
+    FieldSpan<const int16_t> ys{&a[0], offsetof(A, y), 100, sizeof(A)};
+    EXPECT_EQ(198, ys[99]);
+}
+
+TEST_F(FieldSpanTest, GatherScatterTest)
+{
+    struct B
+    {
+        uint8_t pad;
+        float   f;
+        double  d;
+        int8_t  c;
+    };
+
+    // Odd counts to cover the tails of the vectorized kernels.
+    B b[37] = {};
+    for (int i = 0; i < 37; ++i)
+    {
+        b[i].f = i * 1.5f;
+        b[i].d = i * 0.25;
+        b[i].c = static_cast<int8_t>(-i);
+    }
+
+    FieldSpan<float>  fs{b, offsetof(B, f), 37, sizeof(B)};
+    FieldSpan<double> ds{b, offsetof(B, d), 37, sizeof(B)};
+    FieldSpan<int8_t> cs{b, offsetof(B, c), 37, sizeof(B)};
+
+    float  fbuf[37];
+    double dbuf[37];
+    int8_t cbuf[37];
+    fs.gather(fbuf);
+    ds.gather(dbuf);
+    cs.gather(cbuf);
+    for (int i = 0; i < 37; ++i)
+    {
+        EXPECT_FLOAT_EQ(b[i].f, fbuf[i]);
+        EXPECT_DOUBLE_EQ(b[i].d, dbuf[i]);
+        EXPECT_EQ(b[i].c, cbuf[i]);
+        fbuf[i] *= 2.f;
+        dbuf[i] += 1.;
+        cbuf[i] = static_cast<int8_t>(i);
+    }
+
+    fs.scatter(fbuf);
+    ds.scatter(dbuf);
+    cs.scatter(cbuf);
+    for (int i = 0; i < 37; ++i)
+    {
+        EXPECT_FLOAT_EQ(i * 3.f, b[i].f);
+        EXPECT_DOUBLE_EQ(i * 0.25 + 1., b[i].d);
+        EXPECT_EQ(i, b[i].c);
+        EXPECT_EQ(0, b[i].pad);
+    }
+}
+
+// ============================================================================================== //
+// [Pattern] testing                                                                              //
+// ============================================================================================== //
+
+class PatternTest : public testing::Test {};
+
+TEST_F(PatternTest, ParseTest)
+{
+    Pattern pattern{"48 8B ?? ? E8"};
+    ASSERT_TRUE(pattern.isValid());
+    EXPECT_EQ(5, pattern.size());
+    EXPECT_EQ(0, pattern.firstFixed());
+    EXPECT_EQ(4, pattern.lastFixed());
+
+    EXPECT_TRUE(Pattern{"?? 0f"}.isValid());
+    EXPECT_FALSE(Pattern{"?? ??"}.isValid());
+    EXPECT_FALSE(Pattern{""}.isValid());
+    EXPECT_FALSE(Pattern{"4"}.isValid());
+    EXPECT_FALSE(Pattern{"48 XX"}.isValid());
+    EXPECT_FALSE(Pattern{"488B"}.isValid());
+}
+
+TEST_F(PatternTest, FindPatternTest)
+{
+    std::vector<uint8_t> data(100000);
+    uint32_t seed = 1234;
+    for (auto& cur : data)
+    {
+        seed = seed * 1103515245 + 12345;
+        cur = static_cast<uint8_t>(seed >> 16);
+    }
+
+    // Lots of near-matches in front of the real one.
+    for (std::size_t i = 0; i < 50000; i += 7)
+    {
+        data[i] = 0x48; data[i + 1] = 0x8B; data[i + 4] = 0x00;
+    }
+    const uint8_t needle[] = {0x48, 0x8B, 0x11, 0x22, 0xE8};
+    std::copy(std::begin(needle), std::end(needle), data.begin() + 77777);
+
+    const uint8_t* match = findPattern(data.data(), data.size(), "48 8B ?? ?? E8");
+    ASSERT_NE(nullptr, match);
+    EXPECT_EQ(data.data() + 77777, match);
+
+    // Exact end of the buffer, leading wildcard.
+    std::copy(std::begin(needle), std::end(needle), data.end() - 5);
+    EXPECT_EQ(&*(data.end() - 5), findPattern(&data[77782], data.size() - 77782, "?? 8B 11"));
+    EXPECT_EQ(&*(data.end() - 4), findPattern(&data[77782], data.size() - 77782, "8B 11 22 E8"));
+    EXPECT_EQ(&*(data.end() - 5), findPattern(
+        &data[77782], data.size() - 77782, "48 8B 11 22 E8"));
+
+    EXPECT_EQ(nullptr, findPattern(data.data(), data.size(), "DE AD BE EF 13 37 ?? 42"));
+    EXPECT_EQ(nullptr, findPattern(data.data(), 3, "48 8B ?? ?? E8"));
+}
+
+TEST_F(PatternTest, PatternSetTest)
+{
+    // Several chunks worth of data.
+    std::vector<uint8_t> data(0x40000 * 5 + 123);
+    uint32_t seed = 4321;
+    for (auto& cur : data)
+    {
+        seed = seed * 1103515245 + 12345;
+        cur = static_cast<uint8_t>(seed >> 16);
+    }
+
+    PatternSet set;
+    std::vector<std::string> strings;
+    for (std::size_t i = 0; i < 200; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        const std::size_t offs = (seed >> 8) % (data.size() - 16);
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%02X %02X ?? %02X %02X %02X ? %02X", data[offs], 
+            data[offs + 1], data[offs + 3], data[offs + 4], data[offs + 5], data[offs + 7]);
+        strings.push_back(buf);
+    }
+    strings.push_back("DE AD BE EF 13 37 ?? 42");
+    strings.push_back("?? ??");
+    strings.push_back("48 ?? 8B ?? E8");
+
+    // Straddles the first chunk boundary; the last one only has single-byte anchors.
+    const uint8_t needle[] = {0x48, 0xCC, 0x8B, 0xCC, 0xE8, 0x11, 0x22, 0xE8};
+    std::copy(std::begin(needle), std::end(needle), data.begin() + 0x40000 - 3);
+    strings.push_back("E8 11 22 E8");
+
+    for (const auto& cur : strings) set.add(cur.c_str());
+    ASSERT_EQ(strings.size(), set.size());
+
+    for (unsigned numThreads : {1u, 4u, 0u})
+    {
+        std::vector<const uint8_t*> results;
+        set.find(data.data(), data.size(), results, numThreads);
+        ASSERT_EQ(set.size(), results.size());
+        for (std::size_t i = 0; i < set.size(); ++i)
+        {
+            EXPECT_EQ(findPattern(data.data(), data.size(), set[i]), results[i]) << strings[i];
+        }
+    }
+
+    std::vector<const uint8_t*> results;
+    set.find(data.data(), data.size(), results);
+    EXPECT_EQ(nullptr, results[200]);
+    EXPECT_EQ(nullptr, results[201]);
+    EXPECT_EQ(&data[0x40000 - 3], results[202]);
+    EXPECT_EQ(&data[0x40000 + 1], results[203]);
+}
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+static int patternTestMarker(int x)
+{
+    return x * 0x1337;
+}
+
+TEST_F(PatternTest, ModuleFindPatternTest)
+{
+    Dl_info info;
+    ASSERT_NE(0, dladdr(reinterpret_cast<void*>(&patternTestMarker), &info));
+    auto module = wrapper_cast<Module>(info.dli_fbase);
+
+    std::vector<platform::MemoryRegion> regions;
+    ASSERT_TRUE(platform::obtainCodeRegions(info.dli_fbase, regions));
+    ASSERT_FALSE(regions.empty());
+
+    // Search for the first bytes of the function itself.
+    const auto func = reinterpret_cast<const uint8_t*>(&patternTestMarker);
+    char pattern[64];
+    std::snprintf(pattern, sizeof(pattern), "%02X %02X %02X %02X %02X %02X %02X %02X",
+        func[0], func[1], func[2], func[3], func[4], func[5], func[6], func[7]);
+
+    auto found = module.findPattern(pattern);
+    ASSERT_TRUE(found.hasValue());
+    EXPECT_LE(found.value(), reinterpret_cast<uintptr_t>(func));
+    EXPECT_EQ(0, std::memcmp(reinterpret_cast<const void*>(found.value()), func, 8));
+
+    PatternSet set;
+    set.add(pattern);
+    set.add("DE AD BE EF 13 37 ?? 42 DE AD BE EF 13 37 ?? 42");
+    std::vector<uintptr_t> results;
+    ASSERT_TRUE(module.findPatterns(set, results));
+    ASSERT_EQ(2, results.size());
+    EXPECT_EQ(found.value(), results[0]);
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+// ============================================================================================== //
+// [findInstances] testing                                                                        //
+// ============================================================================================== //
+
+class ScanTest : public testing::Test
+{
+protected:
+    struct Animal
+    {
+        virtual ~Animal() = default;
+        int legs = 4;
+    };
+
+    struct Bird : Animal
+    {
+        Bird() { legs = 2; }
+    };
+
+    struct WrapAnimal : AdvancedClassWrapper<sizeof(Animal)>
+    {
+        REMODEL_ADV_WRAPPER(WrapAnimal)
+    public:
+        Field<int> legs{this, sizeof(void*)};
+    };
+
+    static uintptr_t vtableOf(const Animal* animal)
+    {
+        uintptr_t vtable;
+        std::memcpy(&vtable, animal, sizeof(vtable));
+        return vtable;
+    }
+};
+
+TEST_F(ScanTest, WordMatchTest)
+{
+    std::vector<uint64_t> words(1000);
+    std::iota(words.begin(), words.end(), uint64_t{1000});
+    const uint64_t values[] = {1003, 1500, 1999, 7, 1004, 1003};
+
+    std::vector<std::size_t> found;
+    simd::forEachWordMatch(words.data(), words.size(), values, 2, [&](std::size_t i)
+    {
+        found.push_back(i);
+    });
+    EXPECT_EQ((std::vector<std::size_t>{3, 500}), found);
+
+    // More than 4 values take another pass, duplicates are reported once per pass.
+    found.clear();
+    simd::forEachWordMatch(words.data(), words.size(), values, 6, [&](std::size_t i)
+    {
+        found.push_back(i);
+    });
+    EXPECT_EQ((std::vector<std::size_t>{3, 500, 999, 3, 4}), found);
+
+    std::vector<uint32_t> small{5, 6, 7, 5};
+    const uint32_t five = 5;
+    found.clear();
+    simd::forEachWordMatch(small.data(), small.size(), &five, 1, [&](std::size_t i)
+    {
+        found.push_back(i);
+    });
+    EXPECT_EQ((std::vector<std::size_t>{0, 3}), found);
+}
+
+TEST_F(ScanTest, FindInstancesTest)
+{
+    std::vector<std::unique_ptr<Animal>> animals;
+    for (int i = 0; i < 100; ++i)
+    {
+        animals.emplace_back(i % 4 ? new Animal : new Bird);
+    }
+
+    std::vector<platform::MemoryRegion> regions;
+    ASSERT_TRUE(platform::obtainWritableRegions(regions));
+    ASSERT_FALSE(regions.empty());
+
+    // Scans may find stray copies of the vtable addresses, but never miss an object.
+    auto isContained = [&](const std::vector<void*>& found, const void* animal)
+    {
+        return std::binary_search(found.begin(), found.end(), const_cast<void*>(animal));
+    };
+    const auto animalVtable = vtableOf(animals[1].get());
+    const auto birdVtable = vtableOf(animals[0].get());
+
+    auto all = findInstances<WrapAnimal>({animalVtable, birdVtable}, regions, 4);
+    auto allObjects = all.objects();
+    EXPECT_TRUE(std::is_sorted(allObjects.begin(), allObjects.end()));
+    int legs = 0;
+    for (const auto& animal : animals)
+    {
+        EXPECT_TRUE(isContained(allObjects, animal.get()));
+        legs += animal->legs;
+    }
+
+    auto birds = findInstances<WrapAnimal>({birdVtable});
+    auto birdObjects = birds.objects();
+    int birdLegs = 0;
+    for (std::size_t i = 0; i < animals.size(); ++i)
+    {
+        EXPECT_EQ(i % 4 == 0, isContained(birdObjects, animals[i].get()));
+        if (i % 4 == 0) birdLegs += animals[i]->legs;
+    }
+    EXPECT_EQ(50, birdLegs);
+
+    int wrappedLegs = 0;
+    for (auto& bird : birds)
+    {
+        if (isContained(allObjects, bird.addressOfObj()) && bird.legs == 2) wrappedLegs += 2;
+    }
+    EXPECT_GE(wrappedLegs, 50);
+    EXPECT_EQ(350, legs);
+}
+
+// ============================================================================================== //
+// [AddressSpaceMap] testing                                                                      //
+// ============================================================================================== //
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+class AddressSpaceMapTest : public testing::Test {};
+
+TEST_F(AddressSpaceMapTest, CheckTest)
+{
+    int local = 0;
+    static const int kConstant = 42;
+    EXPECT_TRUE(isReadable(&local, sizeof(local)));
+    EXPECT_TRUE(isWritable(&local, sizeof(local)));
+    EXPECT_TRUE(isReadable(&kConstant));
+    EXPECT_FALSE(isWritable(&kConstant));
+    EXPECT_FALSE(isReadable(nullptr));
+    EXPECT_FALSE(isReadable(reinterpret_cast<void*>(~uintptr_t{0} - 16), 64));
+
+    // New mappings show up once the map is refreshed, ranges may span merged mappings.
+    platform::AddressSpaceMap map;
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto pages = static_cast<uint8_t*>(mmap(nullptr, 3 * pageSize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_NE(MAP_FAILED, static_cast<void*>(pages));
+    mprotect(pages + 2 * pageSize, pageSize, PROT_NONE);
+
+    const auto address = reinterpret_cast<uintptr_t>(pages);
+    EXPECT_TRUE(map.check(address, 2 * pageSize, platform::kMappingWritable));
+    EXPECT_FALSE(map.check(address, 3 * pageSize, platform::kMappingReadable));
+    EXPECT_FALSE(map.check(address + 2 * pageSize, 1, platform::kMappingReadable));
+    platform::Mapping mapping;
+    ASSERT_TRUE(map.find(address + pageSize, mapping));
+    EXPECT_LE(mapping.address, address);
+
+    // Unmapping isn't noticed before the next refresh.
+    munmap(pages, 3 * pageSize);
+    EXPECT_TRUE(map.check(address, pageSize, platform::kMappingReadable));
+    ASSERT_TRUE(map.refresh());
+    EXPECT_FALSE(map.check(address, pageSize, platform::kMappingReadable));
+
+    // Misses refresh the map only once it's older than the interval.
+    map.setRefreshInterval(std::chrono::hours{1});
+    auto again = mmap(pages, pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, again);
+    const auto againAddress = reinterpret_cast<uintptr_t>(again);
+    EXPECT_FALSE(map.check(againAddress, pageSize, platform::kMappingReadable));
+    map.setRefreshInterval(std::chrono::microseconds{0});
+    EXPECT_TRUE(map.check(againAddress, pageSize, platform::kMappingReadable));
+    munmap(again, pageSize);
+}
+
+TEST_F(AddressSpaceMapTest, ConcurrentRefreshTest)
+{
+    // Snapshots are replaced and freed while other threads look them up.
+    platform::AddressSpaceMap map;
+    map.setRefreshInterval(std::chrono::microseconds{0});
+    int local = 0;
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            for (int j = 0; j < 200; ++j)
+            {
+                if (!map.check(reinterpret_cast<uintptr_t>(&local), sizeof(local),
+                    platform::kMappingWritable)) failed = true;
+                map.check(0, 1, platform::kMappingReadable);
+                if (!map.size()) failed = true;
+            }
+        });
+    }
+    for (auto& cur : threads) cur.join();
+    EXPECT_FALSE(failed);
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+// ============================================================================================== //
+// [safeLoad] testing                                                                             //
+// ============================================================================================== //
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+class SafeLoadTest : public testing::Test
+{
+protected:
+    class WrapPet : public AdvancedClassWrapper<24>
+    {
+        REMODEL_ADV_WRAPPER(WrapPet)
+    public:
+        Field<uint32_t>                   age  {this, 0};
+        SafeField<BigEndian<uint16_t>>    legs {this, 4};
+        Field<uint8_t[4]>                 tag  {this, 8};
+        SafeField<uint32_t&>              owner{this, 16};
+    };
+};
+
+TEST_F(SafeLoadTest, LoadTest)
+{
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto page = static_cast<uint8_t*>(mmap(nullptr, pageSize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_NE(MAP_FAILED, static_cast<void*>(page));
+
+    uint32_t ownerId = 77;
+    auto pet = wrapper_cast<WrapPet>(page);
+    pet.age = 3;
+    pet.legs = 4;
+    pet.tag[2] = 9;
+    auto ownerPtr = &ownerId;
+    std::memcpy(page + 16, &ownerPtr, sizeof(ownerPtr));
+
+    auto age = safeLoad(pet, &WrapPet::age);
+    ASSERT_TRUE(age.hasValue());
+    EXPECT_EQ(3u, age.value());
+    auto legs = pet.legs.load();
+    ASSERT_TRUE(legs.hasValue());
+    EXPECT_EQ(4, legs.value());
+    auto tag = safeLoad(pet.tag);
+    ASSERT_TRUE(tag.hasValue());
+    EXPECT_EQ(9, tag.value()[2]);
+    auto owner = pet.owner.load();
+    ASSERT_TRUE(owner.hasValue());
+    EXPECT_EQ(77u, owner.value());
+
+    // Dangling references and unmapped objects fail gracefully.
+    ownerPtr = reinterpret_cast<uint32_t*>(16);
+    std::memcpy(page + 16, &ownerPtr, sizeof(ownerPtr));
+    EXPECT_FALSE(pet.owner.load().hasValue());
+    uint32_t value;
+    EXPECT_FALSE(platform::safeRead(&value, nullptr, sizeof(value)));
+
+    // Not yet noticed by the address space map, so the read faults and is recovered from.
+    // Faults refresh the map only once it's older than the interval.
+    auto& map = platform::AddressSpaceMap::global();
+    const auto interval = map.refreshInterval();
+    ASSERT_TRUE(map.refresh());
+    map.setRefreshInterval(std::chrono::hours{1});
+    munmap(page, pageSize);
+    EXPECT_FALSE(safeLoad(pet, &WrapPet::age).hasValue());
+    EXPECT_TRUE(isReadable(page));
+    map.setRefreshInterval(std::chrono::microseconds{0});
+    EXPECT_FALSE(pet.legs.load().hasValue());
+    map.setRefreshInterval(interval);
+    EXPECT_FALSE(isReadable(page));
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+// ============================================================================================== //
+// [ClassIndex] testing                                                                           //
+// ============================================================================================== //
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+class ClassIndexTest : public testing::Test
+{
+protected:
+    struct Vehicle
+    {
+        virtual ~Vehicle() = default;
+        virtual int wheels() const { return 0; }
+    };
+
+    struct Engine
+    {
+        virtual ~Engine() = default;
+        int power = 100;
+    };
+
+    struct Car : Vehicle
+    {
+        int wheels() const override { return 4; }
+    };
+
+    struct Truck : Car, Engine
+    {
+        int wheels() const override { return 6; }
+    };
+
+    static std::string nameOf(const std::type_info& type)
+    {
+        int status;
+        auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        std::string result{demangled};
+        std::free(demangled);
+        return result;
+    }
+
+    static uintptr_t vtableOf(const void* object)
+    {
+        uintptr_t vtable;
+        std::memcpy(&vtable, object, sizeof(vtable));
+        return vtable;
+    }
+};
+
+TEST_F(ClassIndexTest, ItaniumTest)
+{
+    Truck truck;
+    Car car;
+    Dl_info info;
+    ASSERT_NE(0, dladdr(reinterpret_cast<void*>(&patternTestMarker), &info));
+
+    ClassIndex index;
+    ASSERT_TRUE(index.analyze(info.dli_fbase, 4));
+
+    auto carInfo = index.find(nameOf(typeid(Car)));
+    ASSERT_NE(nullptr, carInfo);
+    EXPECT_EQ(vtableOf(&car), carInfo->vtable());
+    ASSERT_EQ(1, carInfo->bases.size());
+    EXPECT_EQ(nameOf(typeid(Vehicle)), carInfo->bases[0].name);
+    EXPECT_EQ(carInfo, index.findByTypeInfo(reinterpret_cast<uintptr_t>(&typeid(Car))));
+
+    // Multiple inheritance: a secondary vtable for the `Engine` part.
+    auto truckInfo = index.find(nameOf(typeid(Truck)));
+    ASSERT_NE(nullptr, truckInfo);
+    const auto engineOffset = reinterpret_cast<const uint8_t*>(static_cast<Engine*>(&truck))
+        - reinterpret_cast<const uint8_t*>(&truck);
+    EXPECT_EQ(vtableOf(&truck), truckInfo->vtable());
+    ASSERT_EQ(2, truckInfo->vtables.size());
+    EXPECT_EQ(engineOffset, truckInfo->vtables[1].offset);
+    EXPECT_EQ(vtableOf(static_cast<Engine*>(&truck)), truckInfo->vtables[1].address);
+    ASSERT_EQ(2, truckInfo->bases.size());
+    EXPECT_EQ(nameOf(typeid(Engine)), truckInfo->bases[1].name);
+    EXPECT_EQ(engineOffset, truckInfo->bases[1].offset);
+    EXPECT_FALSE(truckInfo->bases[1].isVirtual);
+
+    // Virtual functions by slot, after the two destructor slots.
+    using WheelsFunc = int (*)(const Truck*);
+    auto wheels = reinterpret_cast<WheelsFunc>(truckInfo->virtualFunction(2));
+    EXPECT_EQ(6, wheels(&truck));
+    EXPECT_EQ(2, index.vftableIndex(truckInfo->name, truckInfo->virtualFunction(2)).value());
+    EXPECT_FALSE(index.vftableIndex(truckInfo->name, 1).hasValue());
+
+    EXPECT_EQ(nullptr, index.find("NoSuchClass"));
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+// ============================================================================================== //
+// [SignatureCache] testing                                                                       //
+// ============================================================================================== //
+
+class SignatureCacheTest : public testing::Test 
+{
+protected:
+    static const char* const kPath;
+
+    void TearDown() override
+    {
+        std::remove(kPath);
+    }
+};
+
+const char* const SignatureCacheTest::kPath = "remodel_test_sigcache.bin";
+
+TEST_F(SignatureCacheTest, PersistenceTest)
+{
+    EXPECT_EQ("48 8B ?? ?? E8", Pattern{"48 8b ? ?? e8"}.toString());
+
+    SignatureCache cache{std::vector<uint8_t>{1, 2, 3, 4}};
+    ASSERT_TRUE(cache.isValid());
+    EXPECT_FALSE(cache.load(kPath));
+
+    cache.store("48 8B ?? ?? E8", {zycore::kInPlace, uint64_t{0x1234}});
+    cache.store("DE AD", zycore::kEmpty);
+    EXPECT_TRUE(cache.isDirty());
+    ASSERT_TRUE(cache.save(kPath));
+    EXPECT_FALSE(cache.isDirty());
+
+    SignatureCache loaded{std::vector<uint8_t>{1, 2, 3, 4}};
+    ASSERT_TRUE(loaded.load(kPath));
+    EXPECT_EQ(2, loaded.size());
+    ASSERT_TRUE(loaded.lookup("48 8B ?? ?? E8").hasValue());
+    EXPECT_EQ(0x1234, loaded.lookup("48 8B ?? ?? E8").value());
+    EXPECT_TRUE(loaded.contains("DE AD"));
+    EXPECT_FALSE(loaded.lookup("DE AD").hasValue());
+    EXPECT_FALSE(loaded.contains("CC"));
+
+    // Different build of the module.
+    SignatureCache other{std::vector<uint8_t>{1, 2, 3, 5}};
+    EXPECT_FALSE(other.load(kPath));
+    EXPECT_EQ(0, other.size());
+
+    // Corrupted file.
+    auto f = std::fopen(kPath, "r+b");
+    ASSERT_NE(nullptr, f);
+    std::fseek(f, 20, SEEK_SET);
+    std::fputc('X', f);
+    std::fclose(f);
+    EXPECT_FALSE(loaded.load(kPath));
+    EXPECT_EQ(2, loaded.size());
+
+    SignatureCache noIdentity{std::vector<uint8_t>{}};
+    EXPECT_FALSE(noIdentity.isValid());
+    EXPECT_FALSE(noIdentity.save(kPath));
+}
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+static int signatureCacheTestMarker(int x)
+{
+    return x * 0x4242 + 7;
+}
+
+TEST_F(SignatureCacheTest, ModuleTest)
+{
+    Dl_info info;
+    ASSERT_NE(0, dladdr(reinterpret_cast<void*>(&signatureCacheTestMarker), &info));
+    auto module = wrapper_cast<Module>(info.dli_fbase);
+    const auto base = reinterpret_cast<uintptr_t>(info.dli_fbase);
+
+    SignatureCache cache{module};
+    // Toolchains linking without a build-id give us nothing to key the cache by.
+    if (!cache.isValid()) return;
+
+    const auto func = reinterpret_cast<const uint8_t*>(&signatureCacheTestMarker);
+    char pattern[64];
+    std::snprintf(pattern, sizeof(pattern), "%02X %02X %02X %02X ?? %02X %02X %02X",
+        func[0], func[1], func[2], func[3], func[5], func[6], func[7]);
+
+    PatternSet set;
+    set.add(pattern);
+    set.add("DE AD BE EF 13 37 ?? 42 DE AD BE EF 13 37 ?? 42");
+
+    std::vector<uintptr_t> results;
+    ASSERT_TRUE(cache.resolve(module, set, results));
+    ASSERT_EQ(2, results.size());
+    EXPECT_EQ(module.findPattern(set[0]).value(), results[0]);
+    EXPECT_EQ(2, cache.size());
+    ASSERT_TRUE(cache.save(kPath));
+
+    // Results are served from the file without scanning; prove it by planting a fake offset.
+    SignatureCache loaded{module};
+    ASSERT_TRUE(loaded.load(kPath));
+    EXPECT_FALSE(loaded.isDirty());
+    EXPECT_EQ(results[0], loaded.resolve(module, pattern).value());
+    loaded.store(set[0].toString(), {zycore::kInPlace, uint64_t{0x10}});
+    EXPECT_EQ(base + 0x10, loaded.resolve(module, set[0]).value());
+    ASSERT_TRUE(loaded.resolve(module, set, results));
+    EXPECT_EQ(base + 0x10, results[0]);
+    EXPECT_EQ(0, results[1]);
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+// ============================================================================================== //
+// [CodeCache] testing                                                                            //
+// ============================================================================================== //
+
+#if defined(ZYCORE_POSIX)
+
+class CodeCacheTest : public testing::Test
+{
+protected:
+    std::string m_directory;
+
+    void SetUp() override
+    {
+        char path[] = "remodel_test_codecache_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(path));
+        m_directory = path;
+    }
+
+    void TearDown() override
+    {
+        if (auto dir = opendir(m_directory.c_str()))
+        {
+            while (auto entry = readdir(dir))
+            {
+                if (entry->d_name[0] == '.') continue;
+                std::remove((m_directory + '/' + entry->d_name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(m_directory.c_str());
+    }
+};
+
+TEST_F(CodeCacheTest, SectionTest)
+{
+    // A "module" in our own memory, its second half being the code section.
+    std::vector<uint8_t> image(0x400);
+    std::iota(image.begin(), image.end(), uint8_t{0});
+    const auto base = reinterpret_cast<uintptr_t>(image.data());
+    const platform::MemoryRegion text{0x200, 0x200};
+    const std::vector<uint8_t> identity{0xAB, 0xCD};
+
+    LocalMemory memory;
+    CodeCache cache{m_directory};
+    EXPECT_EQ(nullptr, cache.obtain(memory, {}, base, text));
+
+    auto section = cache.obtain(memory, identity, base, text);
+    ASSERT_NE(nullptr, section);
+    ASSERT_EQ(text.size, section->size());
+    EXPECT_EQ(0, std::memcmp(image.data() + text.address, section->data(), text.size));
+    EXPECT_NE(image.data() + text.address, section->data());
+    EXPECT_EQ(section, cache.obtain(memory, identity, base, text));
+    EXPECT_EQ(1, cache.stats().reads);
+    EXPECT_EQ(1, cache.stats().hits);
+
+    // Another process attaching to the same build, loaded elsewhere, reads nothing.
+    std::vector<uint8_t> relocated(image);
+    std::fill(relocated.begin(), relocated.end(), 0);
+    CodeCache other{m_directory};
+    auto shared = other.obtain(memory, identity, reinterpret_cast<uintptr_t>(relocated.data()),
+        text);
+    ASSERT_NE(nullptr, shared);
+    EXPECT_EQ(section->hash(), shared->hash());
+    EXPECT_EQ(0, std::memcmp(section->data(), shared->data(), text.size));
+    EXPECT_EQ(1, other.stats().loads);
+    EXPECT_EQ(0, other.stats().reads);
+
+    // A different build with equal contents shares the stored bytes.
+    auto copy = other.obtain(memory, {0xAB, 0xCE}, base, text);
+    ASSERT_NE(nullptr, copy);
+    EXPECT_EQ(shared, copy);
+    EXPECT_EQ(1, other.stats().reads);
+}
+
+TEST_F(CodeCacheTest, ResolveTest)
+{
+    std::vector<uint8_t> image(0x400);
+    const auto base = reinterpret_cast<uintptr_t>(image.data());
+    const uint8_t needle[]{0xDE, 0xAD, 0xBE, 0xEF, 0x13, 0x37};
+    std::memcpy(image.data() + 0x123, needle, sizeof(needle));
+    std::memcpy(image.data() + 0x345, needle, 4);
+    const std::vector<platform::MemoryRegion> sections{{0x100, 0x100}, {0x300, 0x100}};
+    const std::vector<uint8_t> identity{1, 2, 3, 4};
+
+    PatternSet patterns;
+    patterns.add("DE AD BE EF 13 ??");
+    patterns.add("DE AD BE EF 00");
+    patterns.add("CC CC CC CC");
+
+    LocalMemory memory;
+    CodeCache cache{m_directory};
+    std::vector<uintptr_t> results;
+    ASSERT_TRUE(cache.findPatterns(memory, identity, base, sections, patterns, results));
+    ASSERT_EQ(3, results.size());
+    EXPECT_EQ(base + 0x123, results[0]);
+    EXPECT_EQ(base + 0x345, results[1]);
+    EXPECT_EQ(0, results[2]);
+    EXPECT_EQ(2, cache.stats().reads);
+
+    SignatureCache signatures{identity};
+    ASSERT_TRUE(cache.resolve(signatures, memory, base, sections, patterns, results));
+    EXPECT_EQ(base + 0x345, results[1]);
+    EXPECT_EQ(3, signatures.size());
+    EXPECT_EQ(2, cache.stats().hits);
+
+    // Scanning sections that aren't cached and can't be read fails.
+    struct FailingMemory : LocalMemory
+    {
+        bool read(uintptr_t, void*, std::size_t) override { return false; }
+    } failing;
+    EXPECT_TRUE(cache.findPatterns(failing, identity, base, sections, patterns, results));
+    EXPECT_FALSE(cache.findPatterns(failing, {5}, base, sections, patterns, results));
+}
+
+#endif // defined(ZYCORE_POSIX)
+
+// ============================================================================================== //
+// [OffsetDatabase] testing                                                                       //
+// ============================================================================================== //
+
+class OffsetDatabaseTest : public testing::Test
+{
+protected:
+    static const char* const kPath;
+
+    struct Dog
+    {
+        uint32_t id;
+        uint8_t age;
+        uint16_t legs;
+    };
+
+    class WrapDog : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapDog)
+    public:
+        Field<uint8_t, NamedOffsGetter>  age {this, NamedOffsGetter{"Dog::age"}};
+        Field<uint16_t, NamedOffsGetter> legs{this, NamedOffsGetter{"Dog::legs"}};
+        Field<uint32_t, NamedOffsGetter> tail{this, NamedOffsGetter{"Dog::tail"}};
+    };
+
+    // A hand-made vftable of plain functions taking `this` as their first argument.
+    struct Barker
+    {
+        const void* const* vftable;
+        int volume;
+    };
+
+    static int bark(void* thiz, int times) { return static_cast<Barker*>(thiz)->volume * times; }
+
+    class WrapBarker : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapBarker)
+    public:
+        VirtualFunction<int (*)(int)> bark{this, "Barker::bark", OffsetDatabase::global()};
+        VirtualFunction<int (*)(int)> howl{this, "Barker::howl", OffsetDatabase::global()};
+    };
+
+    void TearDown() override
+    {
+        OffsetDatabase::global().close();
+        std::remove(kPath);
+    }
+};
+
+const char* const OffsetDatabaseTest::kPath = "remodel_test_offsets.bin";
+
+TEST_F(OffsetDatabaseTest, LookupTest)
+{
+    static_assert(OffsetDatabase::hash("Dog::age") != OffsetDatabase::hash("Dog::legs"),
+        "keys are hashed at compile time");
+
+    OffsetDatabaseWriter writer;
+    EXPECT_TRUE(writer.add("Dog::age", offsetof(Dog, age)));
+    EXPECT_TRUE(writer.add("Dog::legs", 0));
+    EXPECT_TRUE(writer.add("Dog::legs", offsetof(Dog, legs)));
+    for (int i = 0; i < 5000; ++i)
+    {
+        EXPECT_TRUE(writer.add("Filler::field" + std::to_string(i), -i));
+    }
+    EXPECT_EQ(5002u, writer.size());
+    ASSERT_TRUE(writer.save(kPath));
+
+    OffsetDatabase database{kPath};
+    ASSERT_TRUE(database.isOpen());
+    EXPECT_EQ(5002u, database.size());
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto value = database.find(("Filler::field" + std::to_string(i)).c_str());
+        ASSERT_TRUE(value.hasValue());
+        EXPECT_EQ(-i, value.value());
+    }
+    EXPECT_FALSE(database.find("Filler::field5000").hasValue());
+    EXPECT_EQ(offsetof(Dog, legs), database.get<std::size_t>("Dog::legs"));
+    EXPECT_EQ(7, database.get("Dog::tail", 7));
+
+    // Named fields resolve through the global database on first access.
+    Dog dog{1, 5, 4};
+    auto wrapDog = wrapper_cast<WrapDog>(&dog);
+    ASSERT_TRUE(OffsetDatabase::global().open(kPath));
+    EXPECT_EQ(5, wrapDog.age);
+    EXPECT_EQ(4, wrapDog.legs);
+    wrapDog.age = 6;
+    EXPECT_EQ(6, dog.age);
+    EXPECT_EQ(nullptr, wrapDog.tail.addressOfObj());
+
+    // Databases failing validation are rejected.
+    database.close();
+    EXPECT_FALSE(database.isOpen());
+    EXPECT_FALSE(database.find("Dog::age").hasValue());
+    EXPECT_FALSE(database.open("remodel_does_not_exist.bin"));
+    auto file = std::fopen(kPath, "wb");
+    ASSERT_NE(nullptr, file);
+    std::fputs("RMOD garbage", file);
+    std::fclose(file);
+    EXPECT_FALSE(database.open(kPath));
+    EXPECT_FALSE(database.isOpen());
+
+    // Empty databases are valid.
+    ASSERT_TRUE(OffsetDatabaseWriter{}.save(kPath));
+    ASSERT_TRUE(database.open(kPath));
+    EXPECT_EQ(0u, database.size());
+    EXPECT_FALSE(database.find("Dog::age").hasValue());
+}
+
+static int offsetDatabaseAnswer()
+{
+    return 42;
+}
+
+TEST_F(OffsetDatabaseTest, ReloadTest)
+{
+    const char* const kOtherPath = "remodel_test_offsets2.bin";
+    auto module = Module::getModule(nullptr);
+    ASSERT_TRUE(module.hasValue());
+    const auto rva = reinterpret_cast<uintptr_t>(&offsetDatabaseAnswer)
+        - reinterpret_cast<uintptr_t>(platform::obtainModuleHandle(nullptr));
+
+    // The second version of the "target" moved `age` and `legs`.
+    OffsetDatabaseWriter writer;
+    writer.add("Dog::age", offsetof(Dog, age));
+    writer.add("Dog::legs", offsetof(Dog, legs));
+    writer.add("answer", static_cast<int64_t>(rva));
+    ASSERT_TRUE(writer.save(kPath));
+    writer.add("Dog::age", offsetof(Dog, id));
+    writer.add("Dog::legs", offsetof(Dog, id) + 2);
+    ASSERT_TRUE(writer.save(kOtherPath));
+
+    auto& database = OffsetDatabase::global();
+    ASSERT_TRUE(database.open(kPath));
+    Dog dog{0x00070001, 5, 4};
+    auto wrapDog = wrapper_cast<WrapDog>(&dog);
+    Function<int (*)(), NamedRvaGetter> answer{NamedRvaGetter{module.value(), "answer"}};
+    EXPECT_EQ(5, wrapDog.age);
+    EXPECT_EQ(4, wrapDog.legs);
+    EXPECT_EQ(42, answer());
+
+    // Lookups on other threads keep working while the file is swapped.
+    std::atomic<bool> stop{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]
+        {
+            auto readerDog = wrapper_cast<WrapDog>(&dog);
+            while (!stop.load())
+            {
+                const int age = readerDog.age;
+                if (age != 5 && age != 1) failures.fetch_add(1);
+                if (!database.find("answer").hasValue()) failures.fetch_add(1);
+            }
+        });
+    }
+    for (int i = 0; i < 100; ++i) ASSERT_TRUE(database.open(i % 2 ? kOtherPath : kPath));
+    stop.store(true);
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(0, failures.load());
+
+    // Existing getters pick the new offsets up, failed reloads keep the current ones.
+    EXPECT_EQ(1, wrapDog.age);
+    EXPECT_EQ(7, wrapDog.legs);
+    EXPECT_FALSE(database.open("remodel_does_not_exist.bin"));
+    EXPECT_EQ(1, wrapDog.age);
+    ASSERT_TRUE(database.open(kPath));
+    EXPECT_EQ(5, wrapDog.age);
+    EXPECT_EQ(42, answer());
+
+    std::remove(kOtherPath);
+}
+
+TEST_F(OffsetDatabaseTest, VirtualFunctionTest)
+{
+    OffsetDatabaseWriter writer;
+    writer.add("Barker::bark", 2);
+    writer.add("Barker::negative", -1);
+    ASSERT_TRUE(writer.save(kPath));
+    ASSERT_TRUE(OffsetDatabase::global().open(kPath));
+    EXPECT_EQ(2, OffsetDatabase::global().vftableIndex("Barker::bark").value());
+    EXPECT_FALSE(OffsetDatabase::global().vftableIndex("Barker::negative").hasValue());
+
+    auto barkFunc = &bark;
+    const void* vftable[] = {nullptr, nullptr, *reinterpret_cast<void**>(&barkFunc)};
+    Barker barker{vftable, 3};
+    auto wrap = wrapper_cast<WrapBarker>(&barker);
+    EXPECT_TRUE(wrap.bark.isResolved());
+    EXPECT_EQ(12, wrap.bark(4));
+    EXPECT_FALSE(wrap.howl.isResolved());
+}
+
+// ============================================================================================== //
+// [MultiLayout] testing                                                                          //
+// ============================================================================================== //
+
+class MultiLayoutTest : public testing::Test
+{
+protected:
+    struct DogV1
+    {
+        uint32_t id;
+        uint8_t age;
+        uint16_t legs;
+    };
+
+    struct DogV2
+    {
+        uint16_t legs;
+        uint32_t id;
+        uint64_t collar;
+        uint8_t age;
+    };
+
+    class WrapDog : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapDog)
+
+        enum { kAge, kLegs, kNumFields };
+    public:
+        static MultiLayout<kNumFields>& layouts()
+        {
+            static MultiLayout<kNumFields> layouts{
+                {"1.0", "", {{offsetof(DogV1, age), offsetof(DogV1, legs)}}},
+                {"2.0", "", {{offsetof(DogV2, age), offsetof(DogV2, legs)}}},
+            };
+            return layouts;
+        }
+
+        Field<uint8_t, LayoutGetter>  age {this, layouts().getter(kAge)};
+        Field<uint16_t, LayoutGetter> legs{this, layouts().getter(kLegs)};
+    };
+};
+
+TEST_F(MultiLayoutTest, SelectTest)
+{
+    DogV1 v1{1, 5, 4};
+    DogV2 v2{3, 2, 0, 7};
+    auto& layouts = WrapDog::layouts();
+
+    // The first layout is the default.
+    auto dog1 = wrapper_cast<WrapDog>(&v1);
+    EXPECT_STREQ("1.0", layouts.selected().name);
+    EXPECT_EQ(5, dog1.age);
+    EXPECT_EQ(4, dog1.legs);
+
+    // Existing wrappers follow the selection.
+    ASSERT_TRUE(layouts.select("2.0"));
+    auto dog2 = wrapper_cast<WrapDog>(&v2);
+    EXPECT_EQ(7, dog2.age);
+    EXPECT_EQ(3, dog2.legs);
+    dog2.age = 8;
+    EXPECT_EQ(8, v2.age);
+    EXPECT_EQ(static_cast<std::ptrdiff_t>(offsetof(DogV2, legs)), layouts.value(1));
+    EXPECT_EQ(static_cast<std::ptrdiff_t>(offsetof(DogV2, age)),
+        reinterpret_cast<uint8_t*>(dog1.age.addressOfObj()) - reinterpret_cast<uint8_t*>(&v1));
+
+    EXPECT_FALSE(layouts.select("3.0"));
+    EXPECT_FALSE(layouts.select(std::size_t{2}));
+    EXPECT_STREQ("2.0", layouts.selected().name);
+    ASSERT_TRUE(layouts.select(std::size_t{0}));
+    EXPECT_EQ(5, dog1.age);
+}
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+TEST_F(MultiLayoutTest, IdentityTest)
+{
+    auto module = Module::getModule(nullptr);
+    ASSERT_TRUE(module.hasValue());
+    std::vector<uint8_t> identity;
+    if (!platform::obtainModuleIdentity(module.value().addressOfObj(), identity))
+    {
+        return; // linked without build-id
+    }
+
+    std::string hex;
+    char digits[3];
+    for (auto byte : identity)
+    {
+        std::snprintf(digits, sizeof(digits), "%02X", byte);
+        hex += digits;
+    }
+
+    MultiLayout<1> layouts{
+        {"old", "00112233", {{0x10}}},
+        {"current", hex.c_str(), {{0x20}}},
+    };
+    ASSERT_TRUE(layouts.select(module.value()));
+    EXPECT_STREQ("current", layouts.selected().name);
+    EXPECT_EQ(0x20, layouts.value(0));
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+// ============================================================================================== //
+// [Global] testing                                                                               //
+// ============================================================================================== //
+
+class GlobalTest : public testing::Test {};
+
+TEST_F(GlobalTest, GlobalTest)
+{
+    auto global    = Global::instance();
+    int myStackVar = 854693;
+    Field<int> myStackVarField{global, reinterpret_cast<ptrdiff_t>(&myStackVar)};
+
+    EXPECT_EQ(myStackVar, myStackVarField);
+
+    ++myStackVarField;
+    EXPECT_EQ(myStackVarField, 854693 + 1);
+    EXPECT_EQ(myStackVar,      854693 + 1);
+}
+
+TEST_F(GlobalTest, GlobalFieldTest)
+{
+    EXPECT_EQ(Global::instance(), Global::instance());
+    EXPECT_EQ(nullptr, Global::instance()->addressOfObj());
+
+    int myStackVar = 42;
+    GlobalField<int> field{nullptr, AbsGetter{&myStackVar}};
+    EXPECT_EQ(42, field);
+    field += 8;
+    EXPECT_EQ(50, myStackVar);
+    EXPECT_EQ(&myStackVar, field.addressOfObj());
+}
+
+TEST_F(GlobalTest, LazyGetterTest)
+{
+    static int value = 5;
+    static std::atomic<int> resolves;
+    resolves = 0;
+
+    Field<int, LazyGetter> field{nullptr, LazyGetter{[]
+    {
+        ++resolves;
+        return reinterpret_cast<uintptr_t>(&value);
+    }}};
+    EXPECT_EQ(0, resolves);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> sum{0};
+    for (int i = 0; i < 4; ++i) threads.emplace_back([&] { sum += field; });
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(20, sum);
+    EXPECT_EQ(1, resolves);
+
+    field = 7;
+    EXPECT_EQ(7, value);
+    EXPECT_EQ(1, resolves);
+
+    // Failed resolutions aren't retried.
+    LazyGetter missing{[] { ++resolves; return zycore::Optional<uintptr_t>{}; }};
+    EXPECT_EQ(nullptr, missing(nullptr));
+    EXPECT_EQ(nullptr, missing(nullptr));
+    EXPECT_TRUE(missing.isResolved());
+    EXPECT_EQ(2, resolves);
+
+    Function<int(*)(int, int), LazyGetter> add{LazyGetter{[]
+    {
+        return reinterpret_cast<void*>(+[](int a, int b) { return a + b; });
+    }}};
+    EXPECT_EQ(5, add(2, 3));
+}
+
+static std::atomic<int> lazyFunctionResolves{0};
+
+struct LazyAddResolver
+{
+    static void* resolve()
+    {
+        ++lazyFunctionResolves;
+        return reinterpret_cast<void*>(+[](int a, int b) { return a + b; });
+    }
+};
+
+struct LazyMissingResolver
+{
+    static zycore::Optional<uintptr_t> resolve()
+    {
+        ++lazyFunctionResolves;
+        return zycore::kEmpty;
+    }
+};
+
+TEST_F(GlobalTest, LazyFunctionTest)
+{
+    using Add = LazyFunction<int(*)(int, int), LazyAddResolver>;
+    Add add;
+    EXPECT_FALSE(Add::isResolved());
+    EXPECT_EQ(Add::stubPtr(), add.get());
+    EXPECT_EQ(0, lazyFunctionResolves);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> sum{0};
+    for (int i = 0; i < 4; ++i) threads.emplace_back([&, i] { sum += add(i, 1); });
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(10, sum);
+    EXPECT_EQ(1, lazyFunctionResolves);
+
+    // The stub has been patched out, other instances share the binding.
+    EXPECT_TRUE(Add::isResolved());
+    EXPECT_NE(Add::stubPtr(), Add{}.get());
+    EXPECT_EQ(9, Add{}(4, 5));
+    EXPECT_TRUE(Add::resolve());
+    EXPECT_EQ(1, lazyFunctionResolves);
+
+    using Missing = LazyFunction<void(*)(), LazyMissingResolver>;
+    EXPECT_FALSE(Missing::resolve());
+    EXPECT_FALSE(Missing::resolve());
+    EXPECT_EQ(Missing::stubPtr(), Missing{}.get());
+    EXPECT_EQ(2, lazyFunctionResolves);
+}
+
+// ============================================================================================== //
+// [Module] testing                                                                               //
+// ============================================================================================== //
+
+class ModuleTest : public testing::Test {};
+
+TEST_F(ModuleTest, ModuleTest)
+{
+    static int myStaticVar = 854693;
+    auto mainModulePtr = platform::obtainModuleHandle(nullptr);
+    auto mainModule = Module::getModule(nullptr);
+
+    EXPECT_TRUE(mainModule);
+    EXPECT_TRUE(mainModulePtr != nullptr);
+
+    Field<int> myStaticVarField{
+        addressOfWrapper(mainModule.value()), 
+        static_cast<ptrdiff_t>(reinterpret_cast<uintptr_t>(&myStaticVar)
+            - reinterpret_cast<uintptr_t>(mainModulePtr))
+    };
+
+    ++myStaticVarField;
+    EXPECT_EQ(myStaticVarField, 854693 + 1);
+    EXPECT_EQ(myStaticVar,      854693 + 1);
+}
+
+TEST_F(ModuleTest, RegistryTest)
+{
+    static int myStaticVar = 1337;
+    ModuleRegistry registry;
+    ASSERT_FALSE(registry.modules().empty());
+    EXPECT_TRUE(std::is_sorted(registry.modules().begin(), registry.modules().end(), 
+        [](const platform::ModuleInfo& a, const platform::ModuleInfo& b)
+    {
+        return a.base < b.base;
+    }));
+
+    auto main = registry.find(nullptr);
+    ASSERT_TRUE(main != nullptr);
+    EXPECT_EQ(main, registry.findByAddress(&myStaticVar));
+    EXPECT_EQ(main->base, reinterpret_cast<uintptr_t>(platform::obtainModuleHandle(nullptr)));
+    EXPECT_FALSE(main->codeRegions.empty());
+    EXPECT_EQ(nullptr, registry.findByAddress(nullptr));
+    EXPECT_EQ(nullptr, registry.find("remodel_no_such_module"));
+
+    // Every named module can be found by name and by address.
+    for (const auto& cur : registry.modules())
+    {
+        EXPECT_EQ(&cur, registry.findByAddress(reinterpret_cast<void*>(cur.base)));
+        if (cur.size)
+        {
+            EXPECT_EQ(&cur, registry.findByAddress(
+                reinterpret_cast<void*>(cur.base + cur.size - 1)));
+        }
+        if (cur.name.empty()) continue;
+        auto byName = registry.find(cur.name.c_str());
+        ASSERT_TRUE(byName != nullptr);
+        EXPECT_EQ(cur.name, byName->name);
+        if (!cur.path.empty())
+        {
+            EXPECT_EQ(byName, registry.find(cur.path.c_str()));
+        }
+    }
+
+    auto module = Module::getModuleByAddress(&myStaticVar);
+    ASSERT_TRUE(module.hasValue());
+    EXPECT_EQ(main->base, reinterpret_cast<uintptr_t>(module.value().addressOfObj()));
+}
+
+TEST_F(ModuleTest, SymbolIndexTest)
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i) names.push_back("symbol" + std::to_string(i));
+
+    std::vector<platform::SymbolInfo> symbols;
+    for (std::size_t i = 0; i < names.size(); ++i) symbols.push_back({names[i].c_str(), i * 16});
+    symbols.push_back({names[5].c_str(), 0xDEAD});
+
+    internal::SymbolIndex index{symbols};
+    EXPECT_EQ(1001, index.size());
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        auto sym = index.find(names[i].c_str());
+        ASSERT_TRUE(sym != nullptr);
+        EXPECT_EQ(i * 16, sym->address);
+    }
+    EXPECT_EQ(nullptr, index.find("symbol1000"));
+    EXPECT_EQ(nullptr, index.find(""));
+}
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+TEST_F(ModuleTest, SymbolTest)
+{
+    // Compare against the loader for a few libc exports, some of them versioned.
+    for (auto name : {"getpid", "malloc", "fopen", "realpath", "pthread_cond_wait", "environ"})
+    {
+        void* expected = dlsym(RTLD_DEFAULT, name);
+        ASSERT_TRUE(expected != nullptr) << name;
+        auto module = Module::getModuleByAddress(expected);
+        ASSERT_TRUE(module.hasValue()) << name;
+
+        auto sym = module.value().symbol(name);
+        ASSERT_TRUE(sym.hasValue()) << name;
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(expected), sym.value()) << name;
+    }
+
+    auto main = Module::getModule(nullptr);
+    ASSERT_TRUE(main.hasValue());
+    EXPECT_FALSE(main.value().symbol("remodel_no_such_symbol").hasValue());
+}
+
+TEST_F(ModuleTest, ResolveAllTest)
+{
+    void* getpidAddr = dlsym(RTLD_DEFAULT, "getpid");
+    auto libc = ModuleRegistry::global().findByAddress(getpidAddr);
+    ASSERT_TRUE(libc != nullptr);
+
+    const auto func = reinterpret_cast<const uint8_t*>(&patternTestMarker);
+    char pattern[64];
+    std::snprintf(pattern, sizeof(pattern), "%02X %02X %02X %02X %02X %02X %02X %02X",
+        func[0], func[1], func[2], func[3], func[4], func[5], func[6], func[7]);
+
+    static int value = 3;
+    static std::atomic<int> resolves;
+    resolves = 0;
+
+    auto pid = LazyGetter::symbol(libc->name.c_str(), "getpid");
+    auto missing = LazyGetter::symbol(libc->name.c_str(), "remodel_no_such_symbol");
+    auto marker = LazyGetter::pattern(nullptr, pattern);
+    LazyGetter custom{[] { ++resolves; return &value; }};
+    LazyGetter accessed{[] { ++resolves; return &value; }};
+    EXPECT_EQ(&value, accessed(nullptr));
+    EXPECT_FALSE(pid.isResolved());
+    EXPECT_FALSE(marker.isResolved());
+
+    EXPECT_FALSE(resolveAll(2));
+    EXPECT_TRUE(pid.isResolved());
+    EXPECT_TRUE(missing.isResolved());
+    EXPECT_TRUE(marker.isResolved());
+    EXPECT_TRUE(custom.isResolved());
+    EXPECT_EQ(2, resolves);
+
+    EXPECT_EQ(getpidAddr, pid(nullptr));
+    EXPECT_EQ(nullptr, missing(nullptr));
+    EXPECT_EQ(&value, custom(nullptr));
+    auto match = static_cast<const uint8_t*>(marker(nullptr));
+    ASSERT_TRUE(match != nullptr);
+    EXPECT_LE(match, func);
+    EXPECT_EQ(0, std::memcmp(match, func, 8));
+
+    // Nothing is pending anymore, and the factories resolve on access as well.
+    EXPECT_TRUE(resolveAll());
+    EXPECT_EQ(getpidAddr, LazyGetter::symbol(libc->name.c_str(), "getpid")(nullptr));
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+static int rvaGetterTestFunc(int a, int b)
+{
+    return a * b + 1;
+}
+
+TEST_F(ModuleTest, RvaGetterTest)
+{
+    static int myStaticVar = 4711;
+    auto module = Module::getModule(nullptr);
+    ASSERT_TRUE(module.hasValue());
+    const auto base = reinterpret_cast<uintptr_t>(module.value().addressOfObj());
+    const auto varRva = reinterpret_cast<uintptr_t>(&myStaticVar) - base;
+    auto funcPtr = &rvaGetterTestFunc;
+    const auto funcRva = *reinterpret_cast<uintptr_t*>(&funcPtr) - base;
+
+    RvaGetter varGetter{nullptr, varRva};
+    ASSERT_TRUE(varGetter.isValid());
+    EXPECT_EQ(&myStaticVar, varGetter(nullptr));
+
+    Field<int, RvaGetter> field{Global::instance(), varGetter};
+    EXPECT_EQ(4711, field);
+    ++field;
+    EXPECT_EQ(4712, myStaticVar);
+
+    Function<int(*)(int, int), RvaGetter> func{RvaGetter{module.value(), funcRva}};
+    EXPECT_EQ(13, func(3, 4));
+    Function<int(*)(int, int)> erasedFunc{RvaGetter{nullptr, funcRva}};
+    EXPECT_EQ(21, erasedFunc(4, 5));
+
+    EXPECT_FALSE((RvaGetter{"remodel_no_such_module", 0x1000}.isValid()));
+}
+
+// ============================================================================================== //
+// [Function] testing                                                                             //
+// ============================================================================================== //
+
+class FunctionTest : public testing::Test
+{
+protected:
+    static int add(int a, int b) { return a + b; }
+    Function<int(*)(int, int)> wrapAdd{&add};
+    static void magic(int& out) { out = 42; }
+    Function<void(*)(int&)> wrapMagic{&magic};
+
+    static int cVarArgSum(std::size_t numArgs, ...)
+    {
+        va_list va;
+        va_start(va, numArgs);
+
+        int sum = 0;
+        for (std::size_t i = 0; i < numArgs; ++i)
+        {
+            sum += va_arg(va, int);
+        }
+
+        va_end(va);
+        return sum;
+    }
+
+    Function<int(*)(std::size_t, ...)> wrapCVarArgSum{&cVarArgSum};
+
+    class WrapInt : public AdvancedClassWrapper<sizeof(int)>
+    {
+        REMODEL_ADV_WRAPPER(WrapInt)
+    public:
+        Field<int> value{this, 0};
+    };
+
+    static int readWeak(WrapInt::Weak* weak) { return weak->toStrong().value; }
+    Function<int(*)(WrapInt::Weak*)> wrapReadWeak{&readWeak};
+public:
+    FunctionTest() = default;
+};
+
+TEST_F(FunctionTest, FunctionTest)
+{
+    EXPECT_EQ(add(1423,  6879), wrapAdd(1423, 6879 ));
+    EXPECT_EQ(add(-1423, 6879), wrapAdd(-1423, 6879));
+
+    int a = 0;
+    wrapMagic(a);
+    EXPECT_EQ(42, a);
+
+    EXPECT_EQ(15, cVarArgSum    (3, 1, 5, 9));
+    EXPECT_EQ(15, wrapCVarArgSum(3, 1, 5, 9));
+}
+
+namespace
+{
+
+/**
+ * @brief   Getter returning a switchable target, counting its invocations.
+ */
+struct CountingGetter
+{
+    void** target;
+    int* calls;
+
+    void* operator () (void*) const
+    {
+        ++*calls;
+        return *target;
+    }
+};
+
+int functionTestMul(int a, int b) { return a * b; }
+
+} // anonymous namespace
+
+TEST_F(FunctionTest, CachingTest)
+{
+    auto addPtr = &add;
+    auto mulPtr = &functionTestMul;
+    void* target = *reinterpret_cast<void**>(&addPtr);
+    int calls = 0;
+
+    // Fixed getters never invoke the type-erased getter again.
+    Function<int(*)(int, int), AbsGetter> fixed{AbsGetter{target}};
+    EXPECT_EQ(3, fixed(1, 2));
+    EXPECT_EQ(target, reinterpret_cast<void*>(fixed.get()));
+
+    // Without an epoch, custom getters are invoked on every call.
+    Function<int(*)(int, int), CountingGetter> uncached{CountingGetter{&target, &calls}};
+    EXPECT_EQ(3, uncached(1, 2));
+    EXPECT_EQ(3, uncached(1, 2));
+    EXPECT_EQ(2, calls);
+
+    // With one, only on the first call and after the epoch was bumped.
+    Epoch epoch;
+    calls = 0;
+    Function<int(*)(int, int), CountingGetter> cached{CountingGetter{&target, &calls}, epoch};
+    EXPECT_EQ(0, calls);
+    EXPECT_EQ(3, cached(1, 2));
+    EXPECT_EQ(3, cached(1, 2));
+    EXPECT_EQ(1, calls);
+
+    target = *reinterpret_cast<void**>(&mulPtr);
+    EXPECT_EQ(3, cached(1, 2));
+    epoch.bump();
+    EXPECT_EQ(2, cached(1, 2));
+    EXPECT_EQ(2, calls);
+    invalidateAll();
+    EXPECT_EQ(6, cached(2, 3));
+    EXPECT_EQ(3, calls);
+
+    Function<int(*)(int, int)> erased{CountingGetter{&target, &calls}, epoch};
+    EXPECT_EQ(12, erased(3, 4));
+    EXPECT_EQ(12, erased(3, 4));
+    EXPECT_EQ(4, calls);
+}
+
+namespace
+{
+
+/**
+ * @brief   Type counting its copies and moves.
+ */
+struct CopyCounter
+{
+    static int copies;
+    static int moves;
+    int value;
+
+    explicit CopyCounter(int value) : value{value} {}
+    CopyCounter(const CopyCounter& other) : value{other.value} { ++copies; }
+    CopyCounter(CopyCounter&& other) : value{other.value} { ++moves; }
+
+    static void reset() { copies = moves = 0; }
+};
+
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+int takeCopyCounter(CopyCounter counter, const CopyCounter& ref, int x)
+{
+    return counter.value + ref.value + x;
+}
+
+} // anonymous namespace
+
+TEST_F(FunctionTest, ForwardingTest)
+{
+    Function<int(*)(CopyCounter, const CopyCounter&, int)> wrapTake{&takeCopyCounter};
+    CopyCounter counter{1};
+
+    // Same number of copies and moves as a direct call.
+    CopyCounter::reset();
+    EXPECT_EQ(12, takeCopyCounter(counter, counter, 10));
+    const int rawCopies = CopyCounter::copies, rawMoves = CopyCounter::moves;
+    CopyCounter::reset();
+    EXPECT_EQ(12, wrapTake(counter, counter, 10));
+    EXPECT_EQ(rawCopies, CopyCounter::copies);
+    EXPECT_EQ(rawMoves,  CopyCounter::moves);
+
+    CopyCounter::reset();
+    EXPECT_EQ(12, wrapTake(std::move(counter), counter, 10));
+    EXPECT_EQ(0, CopyCounter::copies);
+    EXPECT_EQ(1, CopyCounter::moves);
+
+    // Arguments are converted to the parameter types by the wrapped call.
+    short small = 5;
+    EXPECT_EQ(7, wrapAdd(small, 2L));
+
+    int raw = 1337;
+    auto wrapInt = wrapper_cast<WrapInt>(&raw);
+    auto weak = wrapInt.weakPtr();
+    EXPECT_EQ(1337, wrapReadWeak(weak));
+    EXPECT_EQ(1337, wrapReadWeak(wrapInt.weakPtr()));
+}
+
+// ============================================================================================== //
+// [MemberFunction] testing                                                                       //
+// ============================================================================================== //
+
+// We rely on the fact that the compiler handles member-function-pointers as regular function
+// pointers on the hood here (which is not guaranteed by the standard), so let's just perform
+// this test with MSVC for now (where we know that the stuff is implemented this way).
+#ifdef ZYCORE_MSVC
+
+class MemberFunctionTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int c = 42;
+        int __thiscall add(int x, int y) { return x + y + c; }
+        void __thiscall magic(int& out) { out = 42; }
+
+        int __cdecl cVarArgSum(std::size_t numArgs, ...)
+        {
+            va_list va;
+            va_start(va, numArgs);
+
+            int sum = 0;
+            for (std::size_t i = 0; i < numArgs; ++i)
+            {
+                sum += va_arg(va, int);
+            }
+
+            va_end(va);
+            return sum;
+        }
+    };
+
+    struct WrapA : ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapA)
+    public:
+        int(A::*pAdd)(int, int){&A::add};
+        MemberFunction<int (__thiscall*)(int, int)> add{this, reinterpret_cast<uintptr_t&>(pAdd)};
+
+        void(A::*pMagic)(int&){&A::magic};
+        MemberFunction<void (__thiscall*)(int&)> magic{this, reinterpret_cast<uintptr_t&>(pMagic)};
+
+        int(A::*pCVarArgSum)(std::size_t, ...){&A::cVarArgSum};
+        MemberFunction<int (__cdecl*)(std::size_t, ...)> cVarArgSum{
+            this, reinterpret_cast<uintptr_t&>(pCVarArgSum)};
+    };
+public:
+    MemberFunctionTest() = default;
+protected:
+    A a;
+    WrapA wrapA{wrapper_cast<WrapA>(&a)};
+};
+
+TEST_F(MemberFunctionTest, FunctionTest)
+{
+    EXPECT_EQ(a.add(1423,  6879), wrapA.add(1423, 6879 ));
+    EXPECT_EQ(a.add(-1423, 6879), wrapA.add(-1423, 6879));
+
+    int x = 0;
+    wrapA.magic(x);
+    EXPECT_EQ(42, x);
+
+    EXPECT_EQ(21, a.cVarArgSum    (5, 1, 6, 7, 8, -1));
+    EXPECT_EQ(21, wrapA.cVarArgSum(5, 1, 6, 7, 8, -1));
+}
+
+#endif // ifdef ZYCORE_MSVC
+
+// ============================================================================================== //
+// [VirtualFunction] testing                                                                      //
+// ============================================================================================== //
+
+// VF-Table layout is highly compiler-dependant, just perform this test with MSVC for now.
+#ifdef ZYCORE_MSVC
+
+class VirtualFunctionTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int c = 42;
+        virtual int add(int x, int y) { return x + y + c; }
+    };
+
+    struct WrapA : ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapA)
+    public:
+        VirtualFunction<int (__thiscall*)(int, int)> add{this, 0};
+    };
+public:
+    VirtualFunctionTest() = default;
+protected:
+    A a;
+    WrapA wrapA{wrapper_cast<WrapA>(&a)};
+};
+
+TEST_F(VirtualFunctionTest, FunctionTest)
+{
+    EXPECT_EQ(a.add(1423,  6879), wrapA.add(1423, 6879 ));
+    EXPECT_EQ(a.add(-1423, 6879), wrapA.add(-1423, 6879));
+}
+
+#endif // ifdef ZYCORE_MSVC
+
+// Uses hand-made vftables of plain functions taking `this` as their first argument, so the test
+// doesn't depend on the compiler's class layout.
+class VfTableCacheTest : public testing::Test
+{
+protected:
+    struct Object
+    {
+        int pad;
+        const void* const* vftable;
+        int value;
+    };
+
+    static int getA(void* thiz, int x) { return static_cast<Object*>(thiz)->value + x; }
+    static int getB(void* thiz, int x) { return static_cast<Object*>(thiz)->value * x; }
+
+    static const void* const* makeVfTable(int (*first)(void*, int), int (*second)(void*, int))
+    {
+        static std::vector<std::vector<const void*>> tables;
+        tables.push_back({*reinterpret_cast<void**>(&first), *reinterpret_cast<void**>(&second)});
+        return tables.back().data();
+    }
+
+    class WrapChecked : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapChecked)
+    public:
+        VfTableCache vftable{offsetof(Object, vftable)};
+        VirtualFunction<int (*)(int)> first{this, vftable, 0};
+        VirtualFunction<int (*)(int)> second{this, vftable, 1};
+    };
+
+    class WrapStable : public ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapStable)
+    public:
+        VfTableCache vftable{offsetof(Object, vftable), VfTableCache::Mode::AssumeStable};
+        VirtualFunction<int (*)(int)> first{this, vftable, 0};
+        VirtualFunction<int (*)(int)> uncached{this, 0, offsetof(Object, vftable)};
+    };
+
+    const void* const* tableAB = makeVfTable(&getA, &getB);
+    const void* const* tableBA = makeVfTable(&getB, &getA);
+    Object obj1{0, tableAB, 10};
+    Object obj2{0, tableBA, 20};
+};
+
+TEST_F(VfTableCacheTest, CheckedTest)
+{
+    auto wrap = wrapper_cast<WrapChecked>(&obj1);
+    EXPECT_EQ(11, wrap.first(1));
+    EXPECT_EQ(20, wrap.second(2));
+
+    // Swapped vftables are noticed.
+    obj1.vftable = tableBA;
+    EXPECT_EQ(20, wrap.first(2));
+    EXPECT_EQ(11, wrap.second(1));
+
+    // Copies use their own cache.
+    auto copy = wrap;
+    EXPECT_EQ(30, copy.first(3));
+
+    wrap = wrapper_cast<WrapChecked>(&obj2);
+    EXPECT_EQ(40, wrap.first(2));
+    EXPECT_EQ(22, wrap.second(2));
+}
+
+TEST_F(VfTableCacheTest, AssumeStableTest)
+{
+    auto wrap = wrapper_cast<WrapStable>(&obj1);
+    EXPECT_EQ(11, wrap.first(1));
+    EXPECT_EQ(11, wrap.uncached(1));
+
+    // Swapping the vftable is invisible until the cache is invalidated ...
+    obj1.vftable = tableBA;
+    EXPECT_EQ(11, wrap.first(1));
+    EXPECT_EQ(10, wrap.uncached(1));
+    wrap.vftable.invalidate();
+    EXPECT_EQ(10, wrap.first(1));
+
+    // ... but rebinding the wrapper is not.
+    wrap = wrapper_cast<WrapStable>(&obj2);
+    EXPECT_EQ(40, wrap.first(2));
+}
+
+namespace
+{
+
+int vfTableKnownCalls = 0;
+
+int vfTableKnownGetA(void* thiz, int x)
+{
+    ++vfTableKnownCalls;
+    return *reinterpret_cast<int*>(static_cast<char*>(thiz) + 2 * sizeof(void*)) + x;
+}
+
+} // anonymous namespace
+
+TEST_F(VfTableCacheTest, DevirtualizationTest)
+{
+    static_assert(offsetof(Object, value) == 2 * sizeof(void*), "unexpected layout");
+
+    auto wrap = wrapper_cast<WrapChecked>(&obj1);
+    EXPECT_TRUE(wrap.first.hasVfTable(tableAB));
+    EXPECT_FALSE(wrap.first.hasVfTable(tableBA));
+
+    vfTableKnownCalls = 0;
+    wrap.first.expect(tableAB, &vfTableKnownGetA);
+    EXPECT_EQ(11, wrap.first(1));
+    EXPECT_EQ(1, vfTableKnownCalls);
+    EXPECT_EQ(13, wrap.first.speculate<&vfTableKnownGetA>(tableAB, 3));
+    EXPECT_EQ(2, vfTableKnownCalls);
+
+    // Mismatches fall back to the virtual call.
+    obj1.vftable = tableBA;
+    EXPECT_EQ(20, wrap.first(2));
+    EXPECT_EQ(20, wrap.first.speculate<&vfTableKnownGetA>(tableAB, 2));
+    EXPECT_EQ(2, vfTableKnownCalls);
+
+    wrap.first.expect(nullptr, nullptr);
+    obj1.vftable = tableAB;
+    EXPECT_EQ(11, wrap.first(1));
+    EXPECT_EQ(2, vfTableKnownCalls);
+}
+
+// ============================================================================================== //
+// [Hook] testing                                                                                 //
+// ============================================================================================== //
+
+#if defined(REMODEL_HOOK_SUPPORTED)
+
+#if defined(ZYCORE_MSVC)
+#   define REMODEL_TEST_NOINLINE __declspec(noinline)
+#else
+#   define REMODEL_TEST_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+
+REMODEL_TEST_NOINLINE int hookTestTarget(int a, int b)
+{
+    volatile int scaled = a * 3;
+    return scaled + b;
+}
+
+// Called through a volatile pointer, so calls aren't inlined or constant-folded.
+int (*volatile hookTestTargetPtr)(int, int) = &hookTestTarget;
+
+Hook<int(*)(int, int)>* hookTestHook = nullptr;
+
+int hookTestDetour(int a, int b)
+{
+    return hookTestHook->original()(a, b) + 1000;
+}
+
+} // anonymous namespace
+
+class HookTest : public testing::Test
+{
+protected:
+    static internal::Instruction decode(const char* code)
+    {
+        internal::Instruction insn;
+        EXPECT_TRUE(internal::decodeInstruction(reinterpret_cast<const uint8_t*>(code), insn));
+        return insn;
+    }
+
+    static bool rejects(const char* code)
+    {
+        internal::Instruction insn;
+        return !internal::decodeInstruction(reinterpret_cast<const uint8_t*>(code), insn);
+    }
+public:
+    HookTest() = default;
+};
+
+TEST_F(HookTest, DecoderTest)
+{
+    EXPECT_EQ(1,  decode("\x55").length);                                   // push ebp
+    EXPECT_EQ(2,  decode("\x8B\xEC").length);                               // mov ebp, esp
+    EXPECT_EQ(3,  decode("\x83\xEC\x20").length);                           // sub esp, 20h
+    EXPECT_EQ(6,  decode("\x81\xEC\x00\x01\x00\x00").length);               // sub esp, 100h
+    EXPECT_EQ(4,  decode("\x8B\x44\x24\x08").length);                       // mov eax, [esp+8]
+    EXPECT_EQ(7,  decode("\x8B\x04\x85\x00\x00\x00\x00").length);           // mov eax, [eax*4+0]
+    EXPECT_EQ(6,  decode("\x66\x0F\x1F\x44\x00\x00").length);               // nop word [eax+eax]
+    EXPECT_EQ(6,  decode("\xF7\xC1\x01\x00\x00\x00").length);               // test ecx, 1
+    EXPECT_EQ(2,  decode("\xF7\xD8").length);                               // neg eax
+    EXPECT_EQ(4,  decode("\x0F\x28\x04\x24").length);                       // movaps xmm0, [esp]
+    EXPECT_EQ(6,  decode("\xC4\xE3\x79\x0F\xC1\x08").length);               // vpalignr
+    EXPECT_EQ(3,  decode("\xC2\x08\x00").length);                           // ret 8
+    EXPECT_TRUE(decode("\xC3").terminates);                                 // ret
+    EXPECT_TRUE(decode("\xFF\x25\x00\x00\x00\x00").terminates);             // jmp [mem]
+    EXPECT_FALSE(decode("\xFF\x15\x00\x00\x00\x00").terminates);            // call [mem]
+
+    auto jcc = decode("\x0F\x84\x10\x00\x00\x00");                          // je rel32
+    EXPECT_EQ(6, jcc.length);
+    EXPECT_EQ(internal::Instruction::Branch::Conditional, jcc.branch);
+    EXPECT_EQ(4, jcc.condition);
+    EXPECT_EQ(4, jcc.relSize);
+
+    auto jmp = decode("\xEB\x10");                                          // jmp rel8
+    EXPECT_EQ(internal::Instruction::Branch::Jump, jmp.branch);
+    EXPECT_EQ(1, jmp.relSize);
+    EXPECT_TRUE(jmp.terminates);
+
+    EXPECT_TRUE(rejects("\xE3\x10"));                                       // jecxz
+    EXPECT_TRUE(rejects("\x67\x8B\x00"));                                   // address size
+
+#   if defined(REMODEL_HOOK_X64)
+        EXPECT_EQ(3,  decode("\x48\x89\xE5").length);                       // mov rbp, rsp
+        EXPECT_EQ(4,  decode("\xF3\x0F\x1E\xFA").length);                   // endbr64
+        EXPECT_EQ(10, decode("\x48\xB8\x00\x00\x00\x00\x00\x00\x00\x00").length); // mov rax, imm64
+        EXPECT_EQ(7,  decode("\x48\xC7\xC0\x01\x00\x00\x00").length);       // mov rax, 1
+        EXPECT_EQ(3,  decode("\xC5\xF8\x77").length);                       // vzeroupper
+
+        auto rip = decode("\x48\x8B\x05\x00\x00\x00\x00");                  // mov rax, [rip]
+        EXPECT_EQ(7, rip.length);
+        EXPECT_EQ(3, rip.ripOffset);
+        EXPECT_TRUE(rejects("\x06"));                                       // push es
+#   endif
+}
+
+TEST_F(HookTest, RelocationTest)
+{
+    std::vector<uint8_t> buffer(512, 0xCC);
+    uint8_t* source = buffer.data();
+    uint8_t* dest   = buffer.data() + 256;
+
+    // je +7Fh; push ebp; mov ebp, esp
+    std::memcpy(source, "\x74\x7F\x55\x8B\xEC\x90", 6);
+    std::size_t copied = 0;
+    auto written = internal::relocateCode(source, 5, dest, 64, copied);
+    ASSERT_EQ(6 + 3 + 5, written);
+    EXPECT_EQ(5, copied);
+
+    // The short branch is widened and still reaches its target.
+    auto jcc = decode(reinterpret_cast<const char*>(dest));
+    EXPECT_EQ(6, jcc.length);
+    EXPECT_EQ(4, jcc.condition);
+    int32_t displacement;
+    std::memcpy(&displacement, dest + 2, sizeof(displacement));
+    EXPECT_EQ(source + 2 + 0x7F, dest + 6 + displacement);
+    EXPECT_EQ(0, std::memcmp(dest + 6, source + 2, 3));
+
+    // Followed by a jump back behind the copied code.
+    EXPECT_EQ(0xE9, dest[9]);
+    std::memcpy(&displacement, dest + 10, sizeof(displacement));
+    EXPECT_EQ(source + 5, dest + 14 + displacement);
+
+#   if defined(REMODEL_HOOK_X64)
+        // mov rax, [rip+10h]
+        std::memcpy(source, "\x48\x8B\x05\x10\x00\x00\x00", 7);
+        ASSERT_NE(0, internal::relocateCode(source, 5, dest, 64, copied));
+        EXPECT_EQ(7, copied);
+        std::memcpy(&displacement, dest + 3, sizeof(displacement));
+        EXPECT_EQ(source + 7 + 0x10, dest + 7 + displacement);
+#   endif
+
+    // Branches back into the copied bytes can't be relocated.
+    std::memcpy(source, "\x74\x01\x90\x90\x90\x90", 6);
+    EXPECT_EQ(0, internal::relocateCode(source, 5, dest, 64, copied));
+
+    // Neither can functions shorter than the jump.
+    std::memcpy(source, "\x31\xC0\xC3", 3);
+    EXPECT_EQ(0, internal::relocateCode(source, 5, dest, 64, copied));
+}
+
+TEST_F(HookTest, InstallTest)
+{
+    ASSERT_EQ(9, hookTestTargetPtr(2, 3));
+
+    {
+        Hook<int(*)(int, int)> hook{Function<int(*)(int, int)>{&hookTestTarget}, &hookTestDetour};
+        hookTestHook = &hook;
+        ASSERT_TRUE(hook.isValid());
+        EXPECT_FALSE(hook.isInstalled());
+        EXPECT_EQ(9, hookTestTargetPtr(2, 3));
+
+        ASSERT_TRUE(hook.install());
+        EXPECT_TRUE(hook.isInstalled());
+        EXPECT_EQ(1009, hookTestTargetPtr(2, 3));
+        EXPECT_EQ(9,    hook.original()(2, 3));
+
+        ASSERT_TRUE(hook.remove());
+        EXPECT_EQ(9, hookTestTargetPtr(2, 3));
+        ASSERT_TRUE(hook.install());
+        EXPECT_EQ(1012, hookTestTargetPtr(3, 3));
+    }
+
+    // Destroying the hook removes it.
+    EXPECT_EQ(9, hookTestTargetPtr(2, 3));
+    hookTestHook = nullptr;
+}
+
+TEST_F(HookTest, RelocatedAddressTest)
+{
+    Hook<int(*)(int, int)> hook{&hookTestTarget, &hookTestDetour};
+    ASSERT_TRUE(hook.isValid());
+    const auto target = reinterpret_cast<uintptr_t>(&hookTestTarget);
+    const auto trampoline = reinterpret_cast<uintptr_t>(hook.original().get());
+
+    // Instructions following the first one are moved to their copy in the trampoline.
+    auto first = decode(reinterpret_cast<const char*>(target));
+    EXPECT_EQ(target, hook.relocatedAddress(target));
+    EXPECT_EQ(target + 5, hook.relocatedAddress(target + 5));
+    if (first.length < 5 && first.branch == internal::Instruction::Branch::None)
+    {
+        EXPECT_EQ(trampoline + first.length, hook.relocatedAddress(target + first.length));
+    }
+}
+
+#if defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32) || defined(__linux__)
+
+TEST_F(HookTest, SuspendedThreadsTest)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> counter{0};
+    std::thread worker{[&] { while (!stop) ++counter; }};
+    while (!counter) std::this_thread::yield();
+
+    {
+        platform::SuspendedThreads threads;
+        ASSERT_TRUE(threads.isValid());
+        EXPECT_LE(1, threads.size());
+
+        const auto frozen = counter.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(frozen, counter.load());
+
+        std::size_t numIps = 0;
+        threads.forEachInstructionPointer([&](uintptr_t& ip) { numIps += ip != 0; });
+        EXPECT_EQ(threads.size(), numIps);
+    }
+
+    // Resumed.
+    const auto resumed = counter.load();
+    while (counter == resumed) std::this_thread::yield();
+    stop = true;
+    worker.join();
+}
+
+TEST_F(HookTest, TransactionTest)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<int> last{0};
+    std::thread worker{[&] { while (!stop) last = hookTestTargetPtr(2, 3); }};
+    while (last != 9) std::this_thread::yield();
+
+    // A shadow vftable set up like in `ShadowVfTableTest`, with a single entry.
+    struct Object
+    {
+        const void* const* vftable;
+    };
+    auto entry = &hookTestTarget;
+    const void* table[] = {nullptr, *reinterpret_cast<void**>(&entry)};
+    Object object{table + 1};
+    ShadowVfTable shadow{object.vftable, 1, 1};
+
+    Hook<int(*)(int, int)> hook{&hookTestTarget, &hookTestDetour};
+    hookTestHook = &hook;
+    ASSERT_TRUE(hook.isValid());
+
+    HookTransaction transaction;
+    transaction.install(hook);
+    transaction.attach(shadow, &object);
+    EXPECT_EQ(2, transaction.size());
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_EQ(0, transaction.size());
+    EXPECT_TRUE(hook.isInstalled());
+    EXPECT_TRUE(shadow.isAttached(&object));
+    while (last != 1009) std::this_thread::yield();
+
+    transaction.remove(hook);
+    transaction.detach(shadow, &object);
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_FALSE(hook.isInstalled());
+    EXPECT_EQ(table + 1, object.vftable);
+    while (last != 9) std::this_thread::yield();
+
+    stop = true;
+    worker.join();
+    hookTestHook = nullptr;
+}
+
+#endif // defined(ZYCORE_WINDOWS) || defined(ZYCORE_WIN32) || defined(__linux__)
+
+#endif // defined(REMODEL_HOOK_SUPPORTED)
+
+#if defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+namespace
+{
+
+ImportHook<pid_t(*)()>* importTestHook = nullptr;
+
+pid_t importTestDetour()
+{
+    return importTestHook->original()() + 1;
+}
+
+pid_t importTestParentDetour()
+{
+    return 42;
+}
+
+} // anonymous namespace
+
+TEST_F(ModuleTest, ImportTest)
+{
+    auto main = Module::getModule(nullptr);
+    ASSERT_TRUE(main.hasValue());
+
+    // Our own calls to `getpid` go through the GOT of the main module.
+    std::vector<platform::ImportInfo> imports;
+    ASSERT_TRUE(platform::obtainImports(main.value().addressOfObj(), imports));
+    auto import = std::find_if(imports.begin(), imports.end(),
+        [](const platform::ImportInfo& cur) { return !std::strcmp(cur.name, "getpid"); });
+    ASSERT_TRUE(import != imports.end());
+    EXPECT_EQ(nullptr, import->module);
+
+    auto slot = main.value().importSlot(nullptr, "getpid");
+    ASSERT_TRUE(slot.hasValue());
+    EXPECT_EQ(import->slot, slot.value());
+    EXPECT_FALSE(main.value().importSlot(nullptr, "remodel_no_such_symbol").hasValue());
+}
+
+TEST_F(ModuleTest, ImportHookTest)
+{
+    const pid_t pid = getpid();
+    const pid_t parent = getppid();
+    auto main = Module::getModule(nullptr).value();
+
+    ImportHook<pid_t(*)()> hook{main, nullptr, "getpid", &importTestDetour};
+    ImportHook<pid_t(*)()> parentHook{main, nullptr, "getppid", &importTestParentDetour};
+    ImportHook<pid_t(*)()> missing{main, nullptr, "remodel_no_such_symbol", &importTestDetour};
+    importTestHook = &hook;
+    ASSERT_TRUE(hook.isValid() && parentHook.isValid());
+    EXPECT_FALSE(missing.isValid());
+    EXPECT_FALSE(missing.install());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(dlsym(RTLD_DEFAULT, "getpid")),
+        reinterpret_cast<uintptr_t>(hook.original().get()));
+
+    ASSERT_TRUE(hook.install());
+    EXPECT_EQ(pid + 1, getpid());
+    ASSERT_TRUE(hook.remove());
+    EXPECT_EQ(pid, getpid());
+
+    // Both entries are installed in one batch; a failing hook leaves all entries untouched.
+    HookTransaction transaction;
+    transaction.install(hook);
+    transaction.install(parentHook);
+    transaction.install(missing);
+    EXPECT_FALSE(transaction.commit());
+    EXPECT_FALSE(hook.isInstalled());
+    EXPECT_EQ(pid, getpid());
+
+    transaction.clear();
+    transaction.install(hook);
+    transaction.install(parentHook);
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_TRUE(hook.isInstalled() && parentHook.isInstalled());
+    EXPECT_EQ(pid + 1, getpid());
+    EXPECT_EQ(42, getppid());
+
+    transaction.remove(hook);
+    transaction.remove(parentHook);
+    ASSERT_TRUE(transaction.commit());
+    EXPECT_EQ(pid, getpid());
+    EXPECT_EQ(parent, getppid());
+    importTestHook = nullptr;
+}
+
+#endif // defined(ZYCORE_POSIX) && !defined(__APPLE__)
+
+namespace
+{
+
+const ShadowVfTable* shadowTestTable = nullptr;
+int shadowTestTypeInfo = 0;
+
+} // anonymous namespace
+
+// Uses hand-made vftables like `VfTableCacheTest`, with a single entry in front standing in for
+// the RTTI.
+class ShadowVfTableTest : public testing::Test
+{
+protected:
+    struct Object
+    {
+        int pad;
+        const void* const* vftable;
+        int value;
+    };
+
+    using Entry = int (*)(void*, int);
+
+    static int getA(void* thiz, int x) { return static_cast<Object*>(thiz)->value + x; }
+    static int getB(void* thiz, int x) { return static_cast<Object*>(thiz)->value * x; }
+    static int detourA(void* thiz, int x)
+    {
+        return shadowTestTable->original<Entry>(0)(thiz, x) + 100;
+    }
+
+    class Wrap : public ClassWrapper
+    {
+        REMODEL_WRAPPER(Wrap)
+    public:
+        VfTableCache vftable{offsetof(Object, vftable), VfTableCache::Mode::AssumeStable};
+        VirtualFunction<int (*)(int)> first{this, vftable, 0};
+        VirtualFunction<int (*)(int)> second{this, vftable, 1};
+    };
+
+    Entry a = &getA;
+    Entry b = &getB;
+    std::vector<const void*> table{
+        &shadowTestTypeInfo, *reinterpret_cast<void**>(&a), *reinterpret_cast<void**>(&b)};
+    const void* const* tableAB = table.data() + 1;
+    Object obj1{0, tableAB, 10};
+    Object obj2{0, tableAB, 20};
+};
+
+TEST_F(ShadowVfTableTest, ShadowVfTableTest)
+{
+    auto wrap = wrapper_cast<Wrap>(&obj1);
+    EXPECT_EQ(11, wrap.first(1));
+
+    ShadowVfTable shadow{&obj1, wrap.vftable, 2, 1};
+    shadowTestTable = &shadow;
+    EXPECT_EQ(tableAB, shadow.originalVfTable());
+    EXPECT_EQ(2, shadow.size());
+    EXPECT_EQ(&shadowTestTypeInfo, shadow.vftable()[-1]);
+
+    shadow.replace(0, &detourA);
+    EXPECT_TRUE(shadow.isReplaced(0));
+    EXPECT_FALSE(shadow.isReplaced(1));
+
+    // Only attached objects are hooked; the cache is invalidated on attaching.
+    EXPECT_TRUE(shadow.attach(&obj1, wrap.vftable));
+    EXPECT_TRUE(shadow.isAttached(&obj1, offsetof(Object, vftable)));
+    EXPECT_FALSE(shadow.isAttached(&obj2, offsetof(Object, vftable)));
+    EXPECT_EQ(111, wrap.first(1));
+    EXPECT_EQ(20,  wrap.second(2));
+    EXPECT_EQ(21,  getA(&obj2, 1));
+
+    // All attached objects share the table.
+    EXPECT_TRUE(shadow.attach(&obj2, offsetof(Object, vftable)));
+    EXPECT_EQ(obj1.vftable, obj2.vftable);
+    // Wrappers remember entries until their cache is invalidated.
+    shadow.restore(0);
+    shadow.replace(1, &getA);
+    EXPECT_EQ(111, wrap.first(1));
+    wrap.vftable.invalidate();
+    EXPECT_EQ(11, wrap.first(1));
+    EXPECT_EQ(12, wrap.second(2));
+
+    // Objects using another vftable are left alone.
+    Object other{0, shadow.vftable() + 1, 30};
+    EXPECT_FALSE(shadow.attach(&other, offsetof(Object, vftable)));
+    EXPECT_FALSE(shadow.detach(&other, offsetof(Object, vftable)));
+
+    EXPECT_TRUE(shadow.detach(&obj1, wrap.vftable));
+    EXPECT_TRUE(shadow.detach(&obj2, offsetof(Object, vftable)));
+    EXPECT_EQ(tableAB, obj1.vftable);
+    EXPECT_EQ(20, wrap.second(2));
+    shadowTestTable = nullptr;
+}
+
+// ============================================================================================== //
+// [CallTracer] testing                                                                           //
+// ============================================================================================== //
+
+class CallTracerTest : public testing::Test
+{
+protected:
+    enum class Color { Red = 3 };
+
+    static int scale(int x, double factor, Color, const char*, int extra)
+    {
+        return static_cast<int>(x * factor) + extra;
+    }
+
+    Function<int(*)(int, double, Color, const char*, int)> wrapScale{&scale};
+    CallTracer tracer{8};
+
+    std::vector<CallRecord> drain()
+    {
+        std::vector<CallRecord> records;
+        tracer.drain([&](const CallRecord& record) { records.push_back(record); });
+        return records;
+    }
+};
+
+TEST_F(CallTracerTest, RecordTest)
+{
+    const auto id = tracer.registerFunction("scale");
+    EXPECT_EQ("scale", tracer.functionName(id));
+    EXPECT_EQ("", tracer.functionName(id + 1));
+    auto tracedScale = traced(wrapScale, id, tracer);
+
+    // Disabled tracers don't record.
+    EXPECT_EQ(8, tracedScale(4, 1.5, Color::Red, "x", 2));
+    EXPECT_TRUE(drain().empty());
+
+    tracer.enable();
+    const char* text = "text";
+    const auto before = CallTracer::now();
+    EXPECT_EQ(8, tracedScale(4, 1.5, Color::Red, text, 2));
+    auto records = drain();
+    ASSERT_EQ(1, records.size());
+
+    const auto& record = records[0];
+    EXPECT_EQ(id, record.functionId);
+    EXPECT_EQ(platform::currentThreadId(), record.threadId);
+    EXPECT_LE(before, record.timestamp);
+    ASSERT_EQ(std::min(5, REMODEL_TRACE_ARGS), static_cast<int>(record.numArgs));
+    EXPECT_EQ(4, record.args[0]);
+    double factor;
+    std::memcpy(&factor, &record.args[1], sizeof(factor));
+    EXPECT_EQ(1.5, factor);
+    EXPECT_EQ(3, record.args[2]);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(text), record.args[3]);
+
+    // Scopes record with the same tracer.
+    {
+        TraceScope scope{tracer, id, 7};
+    }
+    records = drain();
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ(1, records[0].numArgs);
+    EXPECT_EQ(7, records[0].args[0]);
+}
+
+TEST_F(CallTracerTest, OverflowTest)
+{
+    tracer.enable();
+    for (int i = 0; i < 10; ++i) TraceScope{tracer, 0, i};
+    EXPECT_EQ(2, tracer.dropped());
+
+    // The oldest calls are kept.
+    auto records = drain();
+    ASSERT_EQ(8, records.size());
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(i, records[i].args[0]);
+
+    TraceScope{tracer, 0, 10};
+    EXPECT_EQ(1, drain().size());
+}
+
+TEST_F(CallTracerTest, DrainerTest)
+{
+    CallTracer bigTracer{1 << 12};
+    std::mutex mutex;
+    std::vector<uint32_t> threadIds;
+    std::size_t numRecords = 0;
+    bigTracer.startDrainer([&](const CallRecord& record)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (!numRecords++ || threadIds.back() != record.threadId)
+        {
+            threadIds.push_back(record.threadId);
+        }
+    }, std::chrono::milliseconds(1));
+    bigTracer.enable();
+
+    auto work = [&] { for (int i = 0; i < 1000; ++i) TraceScope{bigTracer, 0, i}; };
+    std::thread first{work};
+    std::thread second{work};
+    first.join();
+    second.join();
+    bigTracer.stopDrainer();
+
+    EXPECT_EQ(2000, numRecords);
+    EXPECT_EQ(0, bigTracer.dropped());
+    std::sort(threadIds.begin(), threadIds.end());
+    threadIds.erase(std::unique(threadIds.begin(), threadIds.end()), threadIds.end());
+    EXPECT_EQ(2, threadIds.size());
+}
+
+// ============================================================================================== //
+// [Instrumented] testing                                                                         //
+// ============================================================================================== //
+
+class InstrumentedTest : public testing::Test
+{
+protected:
+    static int scale(int x, int factor) { return x * factor; }
+
+    Function<int (*)(int, int)> wrapScale{&scale};
+};
+
+TEST_F(InstrumentedTest, CallTest)
+{
+    auto instrumentedScale = instrumented(wrapScale, "InstrumentedTest::scale", 16);
+    EXPECT_EQ(12, instrumentedScale(3, 4));
+    EXPECT_EQ("InstrumentedTest::scale", instrumentedScale.site().name());
+    EXPECT_EQ(16, instrumentedScale.site().codeSize());
+
+    // Sites are shared by name.
+    EXPECT_EQ(&instrumentedScale.site(), &ZoneSite::intern("InstrumentedTest::scale"));
+    EXPECT_EQ(12, instrumented(&scale, "InstrumentedTest::rawScale")(2, 6));
+
+    ZoneScope zone{ZoneSite::intern("InstrumentedTest::scope")};
+}
+
+#if defined(REMODEL_PERF_MAP_SUPPORTED)
+
+TEST_F(InstrumentedTest, PerfMapTest)
+{
+    const std::string path = "remodel_test_perf.map";
+    std::remove(path.c_str());
+    auto instrumentedScale = instrumented(wrapScale, "InstrumentedTest::mappedScale", 0x20);
+
+    ASSERT_TRUE(PerfMap::global().enable(path));
+    // Only the first call maps the code.
+    EXPECT_EQ(6, instrumentedScale(2, 3));
+    EXPECT_EQ(6, instrumentedScale(3, 2));
+    PerfMap::global().disable();
+    EXPECT_FALSE(PerfMap::global().isEnabled());
+
+    char expected[64];
+    std::snprintf(expected, sizeof(expected), "%llx 20 InstrumentedTest::mappedScale\n",
+        static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(&scale)));
+    std::string contents;
+    auto file = std::fopen(path.c_str(), "r");
+    ASSERT_NE(nullptr, file);
+    char buffer[256];
+    while (std::fgets(buffer, sizeof(buffer), file)) contents += buffer;
+    std::fclose(file);
+    std::remove(path.c_str());
+    EXPECT_EQ(expected, contents);
+}
+
+#endif // defined(REMODEL_PERF_MAP_SUPPORTED)
+
+// ============================================================================================== //
+// [Callback] testing                                                                             //
+// ============================================================================================== //
+
+#ifdef REMODEL_CALLBACK_SUPPORTED
+
+class CallbackTest : public testing::Test
+{
+protected:
+    using Visitor = void (*)(int);
+
+    struct Pair
+    {
+        float first;
+        float second;
+    };
+
+    // Stand-in for APIs only taking function pointers, like `Stable::traverseHorses`.
+    static REMODEL_TEST_NOINLINE void traverse(Visitor visitor, int count)
+    {
+        for (int i = 0; i < count; ++i) visitor(i);
+    }
+};
+
+TEST_F(CallbackTest, CaptureTest)
+{
+    int sum = 0;
+    int calls = 0;
+    auto summer = makeCallback<Visitor>([&](int x) { sum += x; });
+    auto counter = makeCallback<Visitor>([&](int) { ++calls; });
+    ASSERT_TRUE(summer.isValid());
+    ASSERT_TRUE(counter.isValid());
+    EXPECT_NE(summer.get(), counter.get());
+
+    traverse(summer.get(), 5);
+    traverse(counter.get(), 3);
+    EXPECT_EQ(10, sum);
+    EXPECT_EQ(3, calls);
+
+    // Callbacks may invoke other callbacks.
+    auto nested = makeCallback<Visitor>([&](int x) { traverse(counter.get(), x); sum -= x; });
+    traverse(nested.get(), 4);
+    EXPECT_EQ(4, sum);
+    EXPECT_EQ(9, calls);
+
+    Callback<Visitor> moved{std::move(summer)};
+    EXPECT_FALSE(summer.isValid());
+    EXPECT_EQ(nullptr, summer.get());
+    traverse(moved.get(), 2);
+    EXPECT_EQ(5, sum);
+    moved.reset();
+    EXPECT_FALSE(moved.isValid());
+}
+
+TEST_F(CallbackTest, ArgumentTest)
+{
+    // Enough arguments to spill to the stack, floats in vector registers and a struct by value.
+    using Mixed = double (*)(int, double, int, int, int, int, int, int, float, Pair);
+    const double offset = 0.5;
+    auto mixed = makeCallback<Mixed>(
+        [offset](int a, double b, int c, int d, int e, int f, int g, int h, float i, Pair j) 
+    {
+        return a + b + c + d + e + f + g + h + i + j.first * j.second + offset;
+    });
+    auto func = mixed.get();
+    EXPECT_EQ(1 + 2.25 + 3 + 4 + 5 + 6 + 7 + 8 + 9.5 + 6.0 + 0.5, 
+        func(1, 2.25, 3, 4, 5, 6, 7, 8, 9.5f, Pair{2.f, 3.f}));
+
+    std::string text;
+    auto appender = makeCallback<const char* (*)(const char*, std::size_t)>(
+        [&text](const char* str, std::size_t len) 
+    {
+        text.append(str, len);
+        return text.c_str();
+    });
+    EXPECT_STREQ("hello", appender.get()("hello world", 5));
+    EXPECT_STREQ("hello there", appender.get()(" there", 6));
+}
+
+TEST_F(CallbackTest, ArenaTest)
+{
+    std::vector<Visitor> thunks;
+    {
+        std::vector<Callback<Visitor>> callbacks;
+        for (int i = 0; i < 500; ++i)
+        {
+            callbacks.push_back(makeCallback<Visitor>([i](int x) { EXPECT_EQ(i, x); }));
+            thunks.push_back(callbacks.back().get());
+        }
+        for (int i = 0; i < 500; ++i) callbacks[i].get()(i);
+    }
+
+    // Released thunks are reused.
+    std::sort(thunks.begin(), thunks.end());
+    for (int i = 0; i < 500; ++i)
+    {
+        auto callback = makeCallback<Visitor>([](int) {});
+        EXPECT_TRUE(std::binary_search(thunks.begin(), thunks.end(), callback.get()));
+    }
+}
+
+TEST_F(CallbackTest, ThreadTest)
+{
+    std::atomic<int> total{0};
+    auto work = [&](int id)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            int sum = 0;
+            auto callback = makeCallback<Visitor>([&sum, id](int x) { sum += x * id; });
+            traverse(callback.get(), 10);
+            total += sum;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int id = 1; id <= 4; ++id) threads.emplace_back(work, id);
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(200 * 45 * (1 + 2 + 3 + 4), total.load());
+}
+
+#endif // REMODEL_CALLBACK_SUPPORTED
+
+// ============================================================================================== //
+// [Stl layouts] testing                                                                          //
+// ============================================================================================== //
+
+class StlLayoutTest : public testing::Test
+{
+protected:
+    struct Record
+    {
+        int id;
+        std::string name;
+        std::vector<int> values;
+    };
+
+    struct WrapRecord : AdvancedClassWrapper<sizeof(Record)>
+    {
+        REMODEL_ADV_WRAPPER(WrapRecord)
+    public:
+        Field<int>                  id    {this, offsetof(Record, id)};
+        Field<LibstdcxxString>      name  {this, offsetof(Record, name)};
+        Field<LibstdcxxVector<int>> values{this, offsetof(Record, values)};
+    };
+
+    struct Name
+    {
+        uint32_t id;
+        const char* data;
+        uint32_t length;
+    };
+
+    struct WrapName : AdvancedClassWrapper<sizeof(Name)>
+    {
+        REMODEL_ADV_WRAPPER(WrapName)
+    public:
+        Field<uint32_t> id{this, offsetof(Name, id)};
+        BasicStringViewField<char, uint32_t> name{this, offsetof(Name, data),
+            offsetof(Name, length)};
+    };
+};
+
+#if defined(__GLIBCXX__) && _GLIBCXX_USE_CXX11_ABI
+TEST_F(StlLayoutTest, LibstdcxxTest)
+{
+    Record record{1, "short", {1, 2, 3}};
+    auto wrapper = wrapper_cast<WrapRecord>(&record);
+    EXPECT_TRUE(wrapper.name->isSmall());
+    EXPECT_EQ(record.name.data(), wrapper.name->data());
+    EXPECT_TRUE(wrapper.name->ref() == "short");
+    EXPECT_EQ(15, wrapper.name->capacity());
+
+    record.name.assign(100, 'x');
+    EXPECT_FALSE(wrapper.name->isSmall());
+    EXPECT_EQ(100, wrapper.name->size());
+    EXPECT_EQ(record.name.capacity(), wrapper.name->capacity());
+    EXPECT_EQ(record.name, wrapper.name->str());
+
+    EXPECT_EQ(3, wrapper.values->size());
+    EXPECT_EQ(record.values.capacity(), wrapper.values->capacity());
+    EXPECT_EQ(6, std::accumulate(wrapper.values->begin(), wrapper.values->end(), 0));
+    wrapper.values.get()[1] = 20;
+    EXPECT_EQ(20, record.values[1]);
+}
+#endif
+
+TEST_F(StlLayoutTest, MsvcStringTest)
+{
+    // Built by hand: inline buffer or pointer, size, capacity.
+    struct { union { char buf[16]; const char* ptr; }; std::size_t size, capacity; } raw;
+    std::strcpy(raw.buf, "inline");
+    raw.size = 6;
+    raw.capacity = 15;
+    auto str = reinterpret_cast<MsvcString*>(&raw);
+    EXPECT_TRUE(str->isSmall());
+    EXPECT_TRUE(str->ref() == "inline");
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&raw), 
+        str->dataAddress(reinterpret_cast<uintptr_t>(&raw)));
+
+    const char* text = "a string too long for the buffer";
+    raw.ptr = text;
+    raw.size = std::strlen(text);
+    raw.capacity = 47;
+    EXPECT_FALSE(str->isSmall());
+    EXPECT_EQ(text, str->data());
+    EXPECT_EQ(std::string{text}, str->str());
+    EXPECT_TRUE(str->ref() != "inline");
+
+    // Wide strings switch to the heap at 8 characters.
+    static_assert(MsvcWString::kBufSize == 8, "");
+    static_assert(sizeof(MsvcString) == 16 + 2 * sizeof(std::size_t), "");
+}
+
+TEST_F(StlLayoutTest, CowStringTest)
+{
+    struct { std::size_t size, capacity, refcount; char data[8]; } raw{3, 7, 0, "cow"};
+    auto ptr = raw.data;
+    auto str = reinterpret_cast<LibstdcxxCowString*>(&ptr);
+    EXPECT_EQ(3, str->size());
+    EXPECT_EQ(7, str->capacity());
+    EXPECT_TRUE(str->ref() == "cow");
+}
+
+TEST_F(StlLayoutTest, StringViewFieldTest)
+{
+    const char text[] = "RexFluffyRexy";
+    std::vector<Name> names(1000);
+    for (uint32_t i = 0; i < names.size(); ++i) names[i] = {i, text + 3, 6};
+    names[10] = {10, text, 3};
+    names[700] = {700, text + 9, 4};
+    names[900] = {900, text, 3};
+
+    auto wrapper = wrapper_cast<WrapName>(&names[10]);
+    EXPECT_EQ(offsetof(Name, length), wrapper.name.sizeOffset());
+    EXPECT_EQ(3, wrapper.name.size());
+    EXPECT_EQ(text, wrapper.name.data());
+    EXPECT_TRUE(wrapper.name == "Rex");
+    EXPECT_TRUE(wrapper.name != "Rexy");
+    EXPECT_EQ("Rex", wrapper.name.str());
+    const StringRef ref = wrapper.name;
+    EXPECT_TRUE(ref == "Rex");
+#   if defined(REMODEL_STL_STRING_VIEW)
+        const std::string_view view = wrapper.name.get();
+        EXPECT_EQ("Rex", view);
+#   endif
+
+    // Bulk mode, without wrappers.
+    WrapperRange<WrapName> range{names.data(), names.size()};
+    auto span = makeStringSpan(range, &WrapName::name);
+    ASSERT_EQ(names.size(), span.size());
+    EXPECT_TRUE(span[0] == "Fluffy");
+    EXPECT_EQ(10, span.find("Rex"));
+    EXPECT_EQ(700, span.find("Rexy"));
+    EXPECT_EQ(0, span.find("Fluffy"));
+    EXPECT_EQ(StringSpan::npos, span.find("Fluff"));
+
+    std::vector<uint32_t> sizes(span.size());
+    span.gatherSizes(sizes.data());
+    EXPECT_EQ(6 * 997 + 3 + 4 + 3, std::accumulate(sizes.begin(), sizes.end(), 0u));
+
+    std::vector<uint64_t> hashes(span.size());
+    span.hashes(hashes.data());
+    EXPECT_EQ(hashes[10], hashes[900]);
+    EXPECT_NE(hashes[10], hashes[700]);
+
+    std::vector<StringRef> all;
+    span.copyTo(all);
+    EXPECT_TRUE(all[700] == "Rexy");
+}
+
+// ============================================================================================== //
+// [MyWrapperType::Instantiable] testing                                                          //
+// ============================================================================================== //
+
+int* hackyGlobalPtr = nullptr;
+
+class InstantiableTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int    a;
+        float  b;
+        double c;
+    };
+
+    struct WrapA
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapA)
+    public:
+        Field<int>    a{this, offsetof(A, a)};
+        Field<float>  b{this, offsetof(A, b)};
+        Field<double> c{this, offsetof(A, c)};
+    };
+
+    struct WrapACustomCtor
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapACustomCtor)
+    public:
+        Field<int>    a{this, offsetof(A, a)};
+        Field<float>  b{this, offsetof(A, b)};
+        Field<double> c{this, offsetof(A, c)};
+    
+        void construct(int a_, float b_, double c_)
+        {
+            a = a_;
+            b = b_;
+            c = c_;
+        }
+    };
+
+    struct WrapACustomDtor
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapACustomDtor)
+    public:
+        Field<int>    a{this, offsetof(A, a)};
+        Field<float>  b{this, offsetof(A, b)};
+        Field<double> c{this, offsetof(A, c)};
+
+        int* hackyPublicPtr = nullptr;
+
+        void destruct()
+        {
+            *hackyPublicPtr = 42;
+        }
+    };
+
+    static void pseudoCtor(int& ref)
+    {
+        ref = 42;
+    }
+
+    static void pseudoDtor()
+    {
+        *hackyGlobalPtr = 42;
+    }
+    
+    struct WrapACustomWrappedCtor
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapACustomWrappedCtor)
+    public:
+        Function<void(*)(int&)> construct{&pseudoCtor};
+    };
+
+    struct WrapACustomWrappedDtor
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapACustomWrappedDtor)
+    public:
+        Function<void(*)()> destruct{&pseudoDtor};
+    };
+
+    struct WrapRelocatable
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapRelocatable)
+    public:
+        using IsRelocatable = void;
+
+        Field<int>  a{this, offsetof(A, a)};
+        Field<int*> counter{this, offsetof(A, c)};
+
+        void construct(int a_, int* counter_)
+        {
+            a = a_;
+            counter = counter_;
+            ++*counter;
+        }
+
+        void destruct()
+        {
+            --*counter;
+        }
+    };
+
+    struct alignas(32) Wide
+    {
+        float a[8];
+        int   b;
+    };
+
+    struct WrapWide
+        : AdvancedClassWrapper<sizeof(Wide), alignof(Wide)>
+    {
+        REMODEL_ADV_WRAPPER(WrapWide)
+    public:
+        Field<float[8]> a{this, offsetof(Wide, a)};
+        Field<int>      b{this, offsetof(Wide, b)};
+    };
+protected:
+    InstantiableTest() = default;
+};
+
+TEST_F(InstantiableTest, InstantiableTest)
+{
+    WrapA::Instantiable simple;
+    // Nothing more to check with the simple version, just create an instance here to force 
+    // compilation and to detect any possible compiler-time errors.
+    (void)simple;
+
+    WrapACustomCtor::Instantiable customCtor{42, 43.f, 44.};
+    EXPECT_EQ       (42,   customCtor->a);
+    EXPECT_FLOAT_EQ (43.f, customCtor->b);
+    EXPECT_DOUBLE_EQ(44.,  customCtor->c);
+
+    // The destructor alters the target of the pointer to 42 in case everything is working.
+    int x = 0;
+    {
+        WrapACustomDtor::Instantiable customDtor;
+        customDtor.hackyPublicPtr = &x;
+    }
+    EXPECT_EQ(42, x);
+}
+
+TEST_F(InstantiableTest, WrappedFunctionUsage)
+{
+    int a = 0;
+    WrapACustomWrappedCtor::Instantiable customCtor{a};
+    (void)customCtor;
+    EXPECT_EQ(42, a);
+
+    a = 0;
+    {
+        WrapACustomWrappedDtor::Instantiable customDtor;
+        hackyGlobalPtr = &a;
+    }
+    EXPECT_EQ(42, a);
+}
+
+TEST_F(InstantiableTest, AlignmentTest)
+{
+    // Defaults follow the size.
+    static_assert(AdvancedClassWrapper<24>::kObjAlign == 8, "");
+    static_assert(AdvancedClassWrapper<6>::kObjAlign == 2, "");
+    static_assert(AdvancedClassWrapper<3>::kObjAlign == 1, "");
+
+    WrapWide::Instantiable wide;
+    WrapWide::Snapshot snapshot{wide.addressOfObj()};
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(wide.addressOfObj()) % alignof(Wide));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(snapshot.addressOfObj()) % alignof(Wide));
+
+    wide->b = 5;
+    snapshot.refresh();
+    EXPECT_EQ(5, snapshot->b);
+
+    InstantiablePool<WrapWide> pool;
+    auto pooled = pool.create();
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pooled->addressOfObj()) % alignof(Wide));
+}
+
+TEST_F(InstantiableTest, PlacementTest)
+{
+    // Constructs in place, no copy of the buffer involved.
+    A buffer{};
+    auto wrapper = WrapACustomCtor::constructAt(&buffer, 42, 43.f, 44.);
+    EXPECT_EQ(&buffer, wrapper.addressOfObj());
+    EXPECT_EQ(42, buffer.a);
+    EXPECT_FLOAT_EQ(43.f, buffer.b);
+    EXPECT_DOUBLE_EQ(44., wrapper.c);
+
+    int a = 0;
+    WrapACustomWrappedCtor::constructAt(&buffer, a);
+    EXPECT_EQ(42, a);
+
+    a = 0;
+    hackyGlobalPtr = &a;
+    WrapACustomWrappedDtor::destructAt(&buffer);
+    EXPECT_EQ(42, a);
+
+    // Wrappers without routines accept the calls, too.
+    WrapA::constructAt(&buffer);
+    WrapA::destructAt(&buffer);
+    EXPECT_EQ(42, buffer.a);
+}
+
+TEST_F(InstantiableTest, RelocationTest)
+{
+    static_assert(!IsTriviallyRelocatable<WrapA>::value, "");
+    static_assert(IsTriviallyRelocatable<WrapRelocatable>::value, "");
+
+    int numLive = 0;
+    {
+        std::vector<WrapRelocatable::Instantiable> instances;
+        for (int i = 0; i < 100; ++i) instances.emplace_back(i, &numLive);
+        EXPECT_EQ(100, numLive);
+        for (int i = 0; i < 100; ++i) EXPECT_EQ(i, instances[i].a);
+
+        WrapRelocatable::Instantiable moved{std::move(instances[10])};
+        EXPECT_EQ(10, moved.a);
+        instances.erase(instances.begin() + 10);
+        EXPECT_EQ(100, numLive);
+
+        // Assignment destructs the object assigned to.
+        instances[0] = std::move(moved);
+        EXPECT_EQ(99, numLive);
+        EXPECT_EQ(10, instances[0].a);
+        EXPECT_EQ(11, instances[10].a);
+    }
+    EXPECT_EQ(0, numLive);
+}
+
+TEST_F(InstantiableTest, CompactTest)
+{
+    static_assert(sizeof(WrapACustomCtor::Compact) == sizeof(A), "");
+    static_assert(sizeof(WrapWide::Compact) == sizeof(Wide), "");
+    static_assert(std::is_trivially_copyable<WrapACustomCtor::Compact>::value, "");
+
+    std::vector<WrapACustomCtor::Compact> compacts;
+    for (int i = 0; i < 100; ++i) compacts.emplace_back(i, 1.5f, 2.5);
+    EXPECT_EQ(sizeof(A), reinterpret_cast<uintptr_t>(&compacts[1]) 
+        - reinterpret_cast<uintptr_t>(&compacts[0]));
+
+    // Data survives reallocations of the vector.
+    for (int i = 0; i < 100; ++i)
+    {
+        auto view = compacts[i].view();
+        EXPECT_EQ(i, view.a);
+        EXPECT_FLOAT_EQ(1.5f, view.b);
+        EXPECT_EQ(compacts[i].addressOfObj(), compacts[i].weakPtr());
+    }
+
+    int sum = 0;
+    for (auto& wrapper : WrapperRange<WrapACustomCtor>{compacts.data(), compacts.size()})
+    {
+        wrapper.c = 1.;
+        sum += wrapper.a;
+    }
+    EXPECT_EQ(99 * 100 / 2, sum);
+    EXPECT_DOUBLE_EQ(1., compacts[50].view().c);
+
+    auto copy = compacts[7];
+    copy.view().a = 70;
+    EXPECT_EQ(7, compacts[7].view().a);
+    EXPECT_EQ(70, copy.weakPtr()->toStrong().a);
+
+    // Without a custom constructor, the object starts out zeroed.
+    std::vector<WrapWide::Compact> wides(3);
+    EXPECT_EQ(0, wides[2].view().b);
+}
+
+class InstantiablePoolTest : public InstantiableTest
+{
+protected:
+    static int numLive;
+
+    struct WrapCounted
+        : AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapCounted)
+    public:
+        Field<int> a{this, offsetof(A, a)};
+
+        void construct(int a_)
+        {
+            a = a_;
+            ++numLive;
+        }
+
+        void destruct()
+        {
+            --numLive;
+        }
+    };
+
+    using Pool = InstantiablePool<WrapCounted>;
+
+    InstantiablePoolTest() { numLive = 0; }
+};
+
+int InstantiablePoolTest::numLive = 0;
+
+TEST_F(InstantiablePoolTest, CreateDestroyTest)
+{
+    Pool pool{16};
+    std::vector<Pool::Instantiable*> instances;
+    for (int i = 0; i < 40; ++i) instances.push_back(pool.create(i));
+    EXPECT_EQ(40, numLive);
+    // Threads take slots in batches of 32.
+    EXPECT_EQ(4, pool.numSlabs());
+
+    for (int i = 0; i < 40; ++i)
+    {
+        auto instance = instances[i];
+        EXPECT_EQ(i, (*instance)->a);
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(instance) % Pool::kSlotAlignment);
+        EXPECT_EQ(instance->addressOfObj(), instance->weakPtr());
+        EXPECT_EQ(i, instance->weakPtr()->toStrong().a);
+    }
+
+    // Destroyed slots are reused before new slabs are allocated.
+    for (auto instance : instances) pool.destroy(instance);
+    EXPECT_EQ(0, numLive);
+    std::sort(instances.begin(), instances.end());
+    for (int i = 0; i < 40; ++i)
+    {
+        auto instance = pool.create(i);
+        EXPECT_TRUE(std::binary_search(instances.begin(), instances.end(), instance));
+    }
+    EXPECT_EQ(4, pool.numSlabs());
+}
+
+TEST_F(InstantiablePoolTest, ResetTest)
+{
+    {
+        Pool pool{16};
+        for (int i = 0; i < 20; ++i) pool.create(i);
+        pool.destroy(pool.create(99));
+        EXPECT_EQ(20, numLive);
+
+        pool.reset();
+        EXPECT_EQ(0, numLive);
+        for (int i = 0; i < 30; ++i) pool.create(i);
+        EXPECT_EQ(2, pool.numSlabs());
+        EXPECT_EQ(30, numLive);
+    }
+
+    // Destroying the pool destroys the remaining instances.
+    EXPECT_EQ(0, numLive);
+}
+
+TEST_F(InstantiablePoolTest, ThreadTest)
+{
+    // Instances created on one thread and destroyed on another end up in that thread's cache.
+    Pool pool;
+    std::vector<Pool::Instantiable*> handover(1000);
+    std::thread producer{[&] { for (auto& instance : handover) instance = pool.create(1); }};
+    producer.join();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&pool, &handover, t]
+        {
+            for (int i = t; i < 1000; i += 4) pool.destroy(handover[i]);
+            for (int i = 0; i < 10000; ++i) pool.destroy(pool.create(i));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(0, numLive);
+}
+
+// ============================================================================================== //
+// [CallScope] testing                                                                            //
+// ============================================================================================== //
+
+class CallScopeTest : public InstantiablePoolTest {};
+
+TEST_F(CallScopeTest, TemporaryTest)
+{
+    {
+        CallScope scope;
+        auto first = scope.make<WrapCounted>(1);
+        auto second = scope.make<WrapCounted>(2);
+        EXPECT_EQ(2, numLive);
+        EXPECT_EQ(1, first->weakPtr()->toStrong().a);
+        EXPECT_EQ(2, (*second)->a);
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % alignof(WrapCounted::Instantiable));
+
+        auto count = scope.out<uint32_t>();
+        EXPECT_EQ(0, *count);
+        EXPECT_EQ(5, *scope.out(5));
+        auto obj = scope.outObj<WrapCounted>();
+        EXPECT_EQ(0, obj->toStrong().a);
+        EXPECT_EQ(2, numLive);
+    }
+    EXPECT_EQ(0, numLive);
+}
+
+TEST_F(CallScopeTest, NestingTest)
+{
+    CallScope outer;
+    auto kept = outer.make<WrapCounted>(42);
+
+    const void* reused;
+    {
+        CallScope inner;
+        reused = inner.make<WrapCounted>(0);
+        for (int i = 1; i < 10000; ++i) inner.make<WrapCounted>(i);
+        EXPECT_EQ(10001, numLive);
+    }
+    EXPECT_EQ(1, numLive);
+    EXPECT_EQ(42, (*kept)->a);
+
+    // The memory of the inner scope is handed out again, without allocating.
+    const auto numChunks = internal::CallArena::current().numChunks();
+    {
+        CallScope inner;
+        EXPECT_EQ(reused, inner.make<WrapCounted>(0));
+        for (int i = 1; i < 10000; ++i) inner.make<WrapCounted>(i);
+    }
+    EXPECT_EQ(numChunks, internal::CallArena::current().numChunks());
+
+    // Allocations larger than a chunk.
+    auto large = outer.allocate(internal::CallArena::kChunkSize * 2, 256);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(large) % 256);
+    std::memset(large, 0xCC, internal::CallArena::kChunkSize * 2);
+}
+
+TEST_F(CallScopeTest, ThreadTest)
+{
+    // Every thread has its own arena.
+    std::vector<uint32_t*> values(4);
+    std::vector<std::thread> threads;
+    std::atomic<int> numReady{0};
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&values, &numReady, t]
+        {
+            CallScope scope;
+            values[t] = scope.out(t);
+            ++numReady;
+            while (numReady != 4) std::this_thread::yield();
+            EXPECT_EQ(t, *values[t]);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values.end(), std::unique(values.begin(), values.end()));
+}
+
+// ============================================================================================== //
+// [Traversal] testing                                                                            //
+// ============================================================================================== //
+
+class TraversalTest : public testing::Test
+{
+protected:
+    struct Node
+    {
+        int value;
+        Node* next;
+    };
+
+    struct TreeNode
+    {
+        int value;
+        TreeNode* left;
+        TreeNode* right;
+    };
+
+    struct Link
+    {
+        Link* next;
+    };
+
+    struct Entry
+    {
+        int value;
+        Link link;
+    };
+
+    struct WrapNode : AdvancedClassWrapper<sizeof(Node)>
+    {
+        REMODEL_ADV_WRAPPER(WrapNode)
+    public:
+        Field<int>   value{this, offsetof(Node, value)};
+        Field<Node*> next {this, offsetof(Node, next)};
+    };
+
+    struct WrapTreeNode : AdvancedClassWrapper<sizeof(TreeNode)>
+    {
+        REMODEL_ADV_WRAPPER(WrapTreeNode)
+    public:
+        Field<int>       value{this, offsetof(TreeNode, value)};
+        Field<TreeNode*> left {this, offsetof(TreeNode, left)};
+        Field<TreeNode*> right{this, offsetof(TreeNode, right)};
+    };
+
+    struct WrapEntry : AdvancedClassWrapper<sizeof(Entry)>
+    {
+        REMODEL_ADV_WRAPPER(WrapEntry)
+    public:
+        Field<int>   value{this, offsetof(Entry, value)};
+        Field<Link*> next {this, offsetof(Entry, link)};
+    };
+
+    Node nodes[5];
+    //       0
+    //     1   2
+    //    3   4 5
+    TreeNode tree[6];
+
+    void SetUp() override
+    {
+        for (int i = 0; i < 5; ++i) nodes[i] = {i + 1, i < 4 ? &nodes[i + 1] : nullptr};
+        for (int i = 0; i < 6; ++i) tree[i] = {i, nullptr, nullptr};
+        tree[0].left  = &tree[1];
+        tree[0].right = &tree[2];
+        tree[1].left  = &tree[3];
+        tree[2].left  = &tree[4];
+        tree[2].right = &tree[5];
+    }
+};
+
+TEST_F(TraversalTest, ListRangeTest)
+{
+    std::vector<int> values;
+    for (auto& node : makeListRange(&nodes[0], &WrapNode::next)) values.push_back(node.value);
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5}), values);
+
+    for (auto& node : makeListRange(&nodes[0], &WrapNode::next)) node.value *= 10;
+    EXPECT_EQ(30, nodes[2].value);
+
+    auto empty = makeListRange(nullptr, &WrapNode::next);
+    EXPECT_TRUE(empty.begin() == empty.end());
+
+    // Circular list of embedded links, ended by the head's link.
+    Entry entries[3];
+    for (int i = 0; i < 3; ++i) entries[i] = {i, {&entries[(i + 1) % 3].link}};
+    values.clear();
+    for (auto& entry : makeListRange(
+            &entries[0], &WrapEntry::next, offsetof(Entry, link), &entries[0].link))
+    {
+        values.push_back(entry.value);
+    }
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), values);
+}
+
+TEST_F(TraversalTest, WalkTreeTest)
+{
+    std::vector<int> values;
+    auto count = walkTree(&tree[0], [&](WrapTreeNode& node) {
+        values.push_back(node.value);
+    }, &WrapTreeNode::left, &WrapTreeNode::right);
+    EXPECT_EQ(6, count);
+    EXPECT_EQ((std::vector<int>{0, 1, 3, 2, 4, 5}), values);
+
+    EXPECT_EQ(0, walkTree(nullptr, [](WrapTreeNode&) {}, &WrapTreeNode::left));
+}
+
+TEST_F(TraversalTest, RemoteTest)
+{
+    struct CountingMemory : LocalMemory
+    {
+        int submits = 0;
+        bool readBatch(const platform::IoRange* ranges, std::size_t count) override
+        {
+            ++submits;
+            return LocalMemory::readBatch(ranges, count);
+        }
+    };
+    CountingMemory memory;
+
+    std::vector<int> values;
+    EXPECT_TRUE(walkRemoteList(memory, reinterpret_cast<uintptr_t>(&nodes[0]), 
+        [&](WrapNode& node) { values.push_back(node.value); }, &WrapNode::next));
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5}), values);
+
+    // Breadth-first, one batch per level.
+    values.clear();
+    EXPECT_TRUE(walkRemoteTree(memory, reinterpret_cast<uintptr_t>(&tree[0]), 
+        [&](WrapTreeNode& node) { values.push_back(node.value); },
+        &WrapTreeNode::left, &WrapTreeNode::right));
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5}), values);
+    EXPECT_EQ(3, memory.submits);
+}
+
+TEST_F(TraversalTest, CrawlerTest)
+{
+    // A cyclic graph: every node links to two others, all reachable from node 0.
+    const int kNumNodes = 5000;
+    std::vector<TreeNode> graph(kNumNodes);
+    for (int i = 0; i < kNumNodes; ++i)
+    {
+        graph[i] = {i, &graph[(i + 1) % kNumNodes], &graph[(i * 7 + 3) % kNumNodes]};
+    }
+
+    auto crawl = [&](Crawler& crawler, unsigned numThreads)
+    {
+        std::atomic<int> visits{0};
+        std::atomic<int64_t> sum{0};
+        crawler.on<WrapTreeNode>([&](WrapTreeNode& node, Crawler::Edges& edges)
+        {
+            ++visits;
+            sum += node.value;
+            edges.follow<WrapTreeNode>(node.left);
+            edges.follow<WrapTreeNode>(node.right);
+        });
+        crawler.on<WrapNode>([&](WrapNode& node, Crawler::Edges& edges)
+        {
+            ++visits;
+            sum += node.value;
+            edges.follow<WrapNode>(node.next);
+        });
+        crawler.addRoot<WrapTreeNode>(&graph[0]);
+        crawler.addRoot<WrapNode>(&nodes[0]);
+        EXPECT_EQ(kNumNodes + 5, crawler.run(numThreads));
+        EXPECT_EQ(kNumNodes + 5, visits);
+        EXPECT_EQ(int64_t{kNumNodes} * (kNumNodes - 1) / 2 + 15, sum);
+        EXPECT_TRUE(crawler.contains(reinterpret_cast<uintptr_t>(&graph[kNumNodes - 1])));
+        EXPECT_FALSE(crawler.isTruncated());
+    };
+
+    Crawler local;
+    crawl(local, 4);
+    Crawler single;
+    crawl(single, 1);
+
+    LocalMemory memory;
+    Crawler remote{1 << 16, &memory};
+    crawl(remote, 4);
+    EXPECT_EQ(0, remote.failed());
+
+    // Already visited roots are rejected, unknown types ignored.
+    EXPECT_FALSE(remote.addRoot<WrapTreeNode>(&graph[1]));
+    EXPECT_FALSE(remote.addRoot<WrapEntry>(&graph[1]));
+
+    // Crawls stop at the object limit.
+    Crawler limited{10};
+    limited.on<WrapTreeNode>([&](WrapTreeNode& node, Crawler::Edges& edges)
+    {
+        edges.follow<WrapTreeNode>(node.left);
+    });
+    limited.addRoot<WrapTreeNode>(&graph[0]);
+    EXPECT_EQ(10, limited.run(2));
+    EXPECT_TRUE(limited.isTruncated());
+}
+
+// ============================================================================================== //
+// [ForeignHashMap] testing                                                                       //
+// ============================================================================================== //
+
+class ForeignHashMapTest : public testing::Test
+{
+protected:
+    struct Entity
+    {
+        int id;
+        int health;
+        Entity* next;
+    };
+
+    struct Registry
+    {
+        Entity** buckets;
+        uint32_t numBuckets;
+    };
+
+    struct Slot
+    {
+        int key;
+        int value;
+    };
+
+    struct OpenTable
+    {
+        std::size_t numSlots;
+        Slot* slots;
+    };
+
+    struct WrapEntity : AdvancedClassWrapper<sizeof(Entity)>
+    {
+        REMODEL_ADV_WRAPPER(WrapEntity)
+    public:
+        Field<int> id    {this, offsetof(Entity, id)};
+        Field<int> health{this, offsetof(Entity, health)};
+    };
+
+    struct WrapRegistry : AdvancedClassWrapper<sizeof(Registry)>
+    {
+        REMODEL_ADV_WRAPPER(WrapRegistry)
+    public:
+        Field<Entity**> buckets   {this, offsetof(Registry, buckets)};
+        Field<uint32_t> numBuckets{this, offsetof(Registry, numBuckets)};
+    };
+
+    struct WrapSlot : AdvancedClassWrapper<sizeof(Slot)>
+    {
+        REMODEL_ADV_WRAPPER(WrapSlot)
+    public:
+        Field<int> key  {this, offsetof(Slot, key)};
+        Field<int> value{this, offsetof(Slot, value)};
+    };
+
+    struct WrapOpenTable : AdvancedClassWrapper<sizeof(OpenTable)>
+    {
+        REMODEL_ADV_WRAPPER(WrapOpenTable)
+    public:
+        Field<std::size_t> numSlots{this, offsetof(OpenTable, numSlots)};
+        Field<Slot*>       slots   {this, offsetof(OpenTable, slots)};
+    };
+
+    static int numHashes;
+
+    static uint32_t hashId(int id)
+    {
+        ++numHashes;
+        return static_cast<uint32_t>(id) * 7u;
+    }
+
+    void SetUp() override
+    {
+        numHashes = 0;
+    }
+};
+
+int ForeignHashMapTest::numHashes = 0;
+
+TEST_F(ForeignHashMapTest, ChainedTest)
+{
+    Entity entities[8];
+    Entity* buckets[5] = {};
+    for (int i = 0; i < 8; ++i)
+    {
+        auto& bucket = buckets[hashId(i * 3) % 5];
+        entities[i] = {i * 3, 100 + i, bucket};
+        bucket = &entities[i];
+    }
+    Registry registry{buckets, 5};
+
+    Function<uint32_t(*)(int)> hash{&hashId};
+    auto wrapper = wrapper_cast<WrapRegistry>(&registry);
+    auto map = makeChainedHashMap<WrapEntity>(
+        wrapper.buckets, wrapper.numBuckets, offsetof(Entity, next), hash, 
+        [](WrapEntity& entity, int id) { return entity.id == id; });
+
+    numHashes = 0;
+    auto found = map.find(12);
+    ASSERT_TRUE(found.hasValue());
+    EXPECT_EQ(104, found.value().health);
+    found.value().health = 1;
+    EXPECT_EQ(1, entities[4].health);
+    EXPECT_EQ(1, numHashes);
+
+    EXPECT_TRUE(map.contains(21));
+    EXPECT_FALSE(map.contains(4));
+
+    // The table is re-read on every lookup.
+    registry.numBuckets = 0;
+    EXPECT_FALSE(map.contains(12));
+}
+
+TEST_F(ForeignHashMapTest, OpenAddressingTest)
+{
+    // Keys 0 mark empty slots, -1 deleted ones.
+    Slot slots[8] = {};
+    auto insert = [&](int key, int value) {
+        auto i = hashId(key) & 7;
+        while (slots[i].key > 0) i = (i + 1) & 7;
+        slots[i] = {key, value};
+    };
+    insert(1, 10);
+    insert(9, 90);
+    insert(17, 170);
+    // All keys collide, deleting 9 leaves a tombstone between 1 and 17.
+    slots[0].key = -1;
+    OpenTable table{8, slots};
+
+    Function<uint32_t(*)(int)> hash{&hashId};
+    auto wrapper = wrapper_cast<WrapOpenTable>(&table);
+    auto map = makeOpenHashMap<WrapSlot>(
+        wrapper.slots, wrapper.numSlots, hash, 
+        [](WrapSlot& slot, int key) { return slot.key == key; },
+        [](WrapSlot& slot) { return slot.key == 0; });
+
+    auto found = map.find(17);
+    ASSERT_TRUE(found.hasValue());
+    EXPECT_EQ(170, found.value().value);
+    EXPECT_TRUE(map.contains(1));
+    EXPECT_FALSE(map.contains(9));
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_FALSE(map.contains(25));
+}
+
+// ============================================================================================== //
+// [Packet] testing                                                                               //
+// ============================================================================================== //
+
+class PacketTest : public testing::Test
+{
+protected:
+    class EthernetHeader : public AdvancedClassWrapper<14>
+    {
+        REMODEL_ADV_WRAPPER(EthernetHeader)
+    public:
+        StaticField<uint8_t[6], 0>           destination{this};
+        StaticField<BigEndian<uint16_t>, 12> etherType  {this};
+    };
+
+    static void fillFrame(uint8_t* data, uint16_t etherType)
+    {
+        std::memset(data, 0xFF, 12);
+        data[12] = static_cast<uint8_t>(etherType >> 8);
+        data[13] = static_cast<uint8_t>(etherType);
+    }
+};
+
+TEST_F(PacketTest, FrameArrayTest)
+{
+    uint8_t buffers[3][64];
+    fillFrame(buffers[0], 0x0800);
+    fillFrame(buffers[1], 0x86DD);
+    fillFrame(buffers[2], 0x0806);
+    Frame frames[] = {{buffers[0], 64}, {buffers[1], 8}, {buffers[2], 60}};
+
+    std::vector<uint16_t> types;
+    EXPECT_EQ(2, forEachFrame<EthernetHeader>(frames, 3, [&](EthernetHeader& eth, const Frame&) {
+        types.push_back(eth.etherType);
+    }));
+    EXPECT_EQ((std::vector<uint16_t>{0x0800, 0x0806}), types);
+}
+
+#if defined(REMODEL_PACKET_RING_SUPPORTED)
+TEST_F(PacketTest, RingBlockTest)
+{
+    // A block as laid out by the kernel: descriptor, then frames linked by their next offsets.
+    alignas(16) uint8_t block[1024] = {};
+    auto& desc = reinterpret_cast<tpacket_block_desc*>(block)->hdr.bh1;
+    desc.num_pkts = 3;
+    desc.offset_to_first_pkt = 64;
+
+    const uint32_t lengths[] = {60, 10, 100};
+    const uint16_t types[] = {0x0800, 0x86DD, 0x0806};
+    auto cur = block + 64;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto hdr = reinterpret_cast<tpacket3_hdr*>(cur);
+        hdr->tp_mac = 64;
+        hdr->tp_snaplen = lengths[i];
+        hdr->tp_next_offset = i < 2 ? 64 + 128 : 0;
+        fillFrame(cur + hdr->tp_mac, types[i]);
+        cur += hdr->tp_next_offset;
+    }
+
+    std::vector<uint16_t> seen;
+    std::vector<std::size_t> seenLengths;
+    auto count = forEachBlockFrame<EthernetHeader>(block, [&](EthernetHeader& eth, const Frame& f) {
+        seen.push_back(eth.etherType);
+        seenLengths.push_back(f.length);
+        EXPECT_EQ(0xFF, eth.destination[5]);
+    });
+    EXPECT_EQ(2, count);
+    EXPECT_EQ((std::vector<uint16_t>{0x0800, 0x0806}), seen);
+    EXPECT_EQ((std::vector<std::size_t>{60, 100}), seenLengths);
+
+    PacketRing invalid{"remodel-none0"};
+    EXPECT_FALSE(invalid.isValid());
+    EXPECT_EQ(nullptr, invalid.nextBlock(0));
+}
+#endif
+
+// ============================================================================================== //
+// [Snapshot] testing                                                                             //
+// ============================================================================================== //
+
+class GraphSnapshotTest : public testing::Test
+{
+protected:
+    static const char* const kPath;
+    static const char* const kOtherPath;
+
+    struct Node
+    {
+        uint32_t value;
+        Node* left;
+        Node* right;
+        Node* parent;
+    };
+
+    struct WrapNode : AdvancedClassWrapper<sizeof(Node)>
+    {
+        REMODEL_ADV_WRAPPER(WrapNode)
+    public:
+        Field<uint32_t> value {this, offsetof(Node, value)};
+        Field<Node*>    left  {this, offsetof(Node, left)};
+        Field<Node*>    right {this, offsetof(Node, right)};
+        Field<Node*>    parent{this, offsetof(Node, parent)};
+    };
+
+    struct WrapOther : AdvancedClassWrapper<sizeof(Node) + 8>
+    {
+        REMODEL_ADV_WRAPPER(WrapOther)
+    };
+
+    class NodeFields : public AdvancedClassWrapper<sizeof(Node)>
+    {
+        REMODEL_ADV_WRAPPER(NodeFields)
+    public:
+        REMODEL_FIELDS(
+            (value,  uint32_t, offsetof(Node, value)),
+            (left,   Node*,    offsetof(Node, left)),
+            (right,  Node*,    offsetof(Node, right)),
+            (parent, Node*,    offsetof(Node, parent))
+        )
+    };
+
+    LocalMemory memory;
+    // Children of 0 are 1 and 2, children of 1 are 3 and 2, plus links to the parents.
+    Node nodes[5];
+
+    GraphSnapshotTest()
+        : nodes{
+            {10, &nodes[1], &nodes[2], nullptr},
+            {11, &nodes[3], &nodes[2], &nodes[0]},
+            {12, nullptr,   nullptr,   &nodes[0]},
+            {13, nullptr,   nullptr,   &nodes[1]},
+            {14, nullptr,   nullptr,   &nodes[3]},
+        }
+    {}
+
+    void TearDown() override
+    {
+        std::remove(kPath);
+        std::remove(kOtherPath);
+    }
+
+    bool save(const char* path)
+    {
+        SnapshotBuilder<WrapNode> builder{memory};
+        return builder.capture(&nodes[0], &WrapNode::left, &WrapNode::right, &WrapNode::parent)
+            && builder.save(path);
+    }
+};
+
+const char* const GraphSnapshotTest::kPath = "remodel_test_snapshot.bin";
+const char* const GraphSnapshotTest::kOtherPath = "remodel_test_snapshot2.bin";
+
+TEST_F(GraphSnapshotTest, RoundTripTest)
+{
+    SnapshotBuilder<WrapNode> builder{memory};
+    ASSERT_TRUE(builder.capture(&nodes[0], &WrapNode::left, &WrapNode::right, &WrapNode::parent));
+    // Shared and cyclic links don't duplicate objects.
+    EXPECT_EQ(4, builder.size());
+    EXPECT_EQ(7, builder.numEdges());
+    ASSERT_TRUE(builder.capture(&nodes[3], &WrapNode::left));
+    EXPECT_EQ(4, builder.size());
+    ASSERT_TRUE(builder.save(kPath));
+
+    // Mutating the originals doesn't affect the snapshot.
+    nodes[2].value = 99;
+
+    SnapshotFile<WrapNode> snap{kPath};
+    ASSERT_TRUE(snap.isValid());
+    ASSERT_EQ(4, snap.size());
+    ASSERT_EQ(2, snap.numRoots());
+
+    auto root = snap.root(0);
+    EXPECT_EQ(10, root.value);
+    EXPECT_EQ(nullptr, *root.parent.addressOfObj());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&nodes[0]), snap.source(0));
+
+    // Links point into the mapping.
+    auto left = wrapper_cast<WrapNode>(root.left);
+    auto right = wrapper_cast<WrapNode>(root.right);
+    EXPECT_EQ(11, left.value);
+    EXPECT_EQ(12, right.value);
+    EXPECT_EQ(root.addressOfObj(), left.parent);
+    EXPECT_EQ(right.addressOfObj(), left.right);
+    EXPECT_EQ(13, wrapper_cast<WrapNode>(left.left).value);
+    EXPECT_EQ(13, snap.root(1).value);
+
+    auto idx = snap.indexOf(root.right);
+    ASSERT_TRUE(idx.hasValue());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&nodes[2]), snap.source(idx.value()));
+    EXPECT_FALSE(snap.indexOf(&nodes[0]).hasValue());
+}
+
+TEST_F(GraphSnapshotTest, ValidationTest)
+{
+    SnapshotBuilder<WrapNode> builder{memory};
+    EXPECT_FALSE(builder.capture(nullptr, &WrapNode::left));
+    ASSERT_TRUE(builder.capture(&nodes[1], &WrapNode::left, &WrapNode::right));
+    EXPECT_EQ(3, builder.size());
+    auto data = builder.serialize();
+
+    auto load = [&](const std::vector<uint8_t>& contents)
+    {
+        auto f = std::fopen(kPath, "wb");
+        std::fwrite(contents.data(), 1, contents.size(), f);
+        std::fclose(f);
+        return SnapshotFile<WrapNode>{kPath}.isValid();
+    };
+    EXPECT_TRUE(load(data));
+
+    // Truncated.
+    EXPECT_FALSE(load({data.begin(), data.end() - 1}));
+
+    // Link pointing past the objects.
+    uint64_t slot;
+    std::memcpy(&slot, data.data() + data.size() - 16, sizeof(slot));
+    auto corrupt = data;
+    const uintptr_t target = data.size();
+    std::memcpy(corrupt.data() + slot, &target, sizeof(target));
+    EXPECT_FALSE(load(corrupt));
+
+    // Different object size.
+    std::remove(kPath);
+    ASSERT_TRUE(builder.save(kPath));
+    EXPECT_FALSE(SnapshotFile<WrapOther>{kPath}.isValid());
+    EXPECT_FALSE(SnapshotFile<WrapNode>{"remodel_test_missing.bin"}.isValid());
+}
+
+TEST_F(GraphSnapshotTest, DiffTest)
+{
+    ASSERT_TRUE(save(kPath));
+    // Detaches 2, attaches 4 below 3 and moves 3 to the right of 0.
+    nodes[0].right = &nodes[3];
+    nodes[1].right = nullptr;
+    nodes[1].value = 21;
+    nodes[3].left = &nodes[4];
+    ASSERT_TRUE(save(kOtherPath));
+
+    SnapshotFile<WrapNode> before{kPath};
+    SnapshotFile<WrapNode> after{kOtherPath};
+    ASSERT_TRUE(before.isValid() && after.isValid());
+    ASSERT_EQ(4, after.size());
+
+    auto result = diff(before, after, NodeFields::fieldInfos(), NodeFields::Layout::kNumFields);
+    auto describe = [&](const FieldChange& change)
+    {
+        return std::to_string(before.object(change.lhsObject).value) + "."
+            + NodeFields::fieldInfos()[change.field].name;
+    };
+    std::vector<std::string> changed;
+    for (const auto& change : result.changed)
+    {
+        EXPECT_EQ(before.source(change.lhsObject), after.source(change.rhsObject));
+        changed.push_back(describe(change));
+    }
+    // Links to the same objects compare equal, although they point into different mappings.
+    EXPECT_EQ((std::vector<std::string>{"10.right", "11.value", "11.right", "13.left"}), changed);
+    EXPECT_EQ(std::vector<std::size_t>{2}, result.removed);
+    ASSERT_EQ(1, result.added.size());
+    EXPECT_EQ(14, after.object(result.added[0]).value);
+
+    // Equal snapshots.
+    result = diff(after, after, NodeFields::fieldInfos(), NodeFields::Layout::kNumFields);
+    EXPECT_TRUE(result.changed.empty() && result.removed.empty() && result.added.empty());
+}
+
+TEST_F(GraphSnapshotTest, MismatchTest)
+{
+    uint8_t a[100], b[100];
+    for (int i = 0; i < 100; ++i) a[i] = b[i] = static_cast<uint8_t>(i);
+    b[3] ^= 1;
+    b[31] ^= 1;
+    b[70] ^= 1;
+    b[99] ^= 1;
+
+    std::vector<std::size_t> offsets;
+    std::vector<uint32_t> masks;
+    simd::forEachMismatch(a, b, sizeof(a), [&](std::size_t offset, uint32_t mask)
+    {
+        offsets.push_back(offset);
+        masks.push_back(mask);
+    });
+    EXPECT_EQ((std::vector<std::size_t>{0, 64, 96}), offsets);
+    EXPECT_EQ((std::vector<uint32_t>{1u << 3 | 1u << 31, 1u << 6, 1u << 3}), masks);
+}
+
+TEST_F(GraphSnapshotTest, IndexTest)
+{
+    ASSERT_TRUE(save(kPath));
+    nodes[0].right = &nodes[3];
+    nodes[1].right = nullptr;
+    nodes[1].value = 21;
+    nodes[3].left = &nodes[4];
+    ASSERT_TRUE(save(kOtherPath));
+
+    SnapshotFile<WrapNode> before{kPath};
+    SnapshotFile<WrapNode> after{kOtherPath};
+    ASSERT_TRUE(before.isValid() && after.isValid());
+
+    auto byValue = [](WrapNode& node) { return uint32_t{node.value}; };
+    SnapshotHashIndex<WrapNode, uint32_t> hashIndex{byValue};
+    SnapshotSortedIndex<WrapNode, uint32_t> sortedIndex{byValue};
+    hashIndex.build(before, 2);
+    sortedIndex.build(before, 2);
+    ASSERT_TRUE(hashIndex.find(12).hasValue());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&nodes[2]), before.source(hashIndex.find(12).value()));
+    EXPECT_EQ(4, sortedIndex.size());
+
+    // 13 moved in the order of discovery, 12 was removed, 14 added and 11 changed its key.
+    auto changes = diff(before, after, NodeFields::fieldInfos(), NodeFields::Layout::kNumFields);
+    EXPECT_FALSE(changes.moved.empty());
+    hashIndex.update(before, after, changes);
+    sortedIndex.update(before, after, changes);
+
+    SnapshotSortedIndex<WrapNode, uint32_t> rebuilt{byValue};
+    rebuilt.build(after);
+    ASSERT_EQ(rebuilt.size(), sortedIndex.size());
+    EXPECT_EQ(rebuilt.size(), hashIndex.size());
+    for (std::size_t i = 0; i < rebuilt.size(); ++i)
+    {
+        const auto& cur = rebuilt.entries()[i];
+        EXPECT_EQ(cur.key, sortedIndex.entries()[i].key);
+        EXPECT_EQ(cur.object, sortedIndex.entries()[i].object);
+        ASSERT_TRUE(hashIndex.find(cur.key).hasValue());
+        EXPECT_EQ(cur.object, hashIndex.find(cur.key).value());
+    }
+    EXPECT_FALSE(hashIndex.find(11).hasValue());
+    EXPECT_FALSE(sortedIndex.find(12).hasValue());
+
+    std::vector<uint32_t> values;
+    sortedIndex.forEachInRange(11, 21, [&](std::size_t idx)
+    {
+        values.push_back(after.object(idx).value);
+    });
+    EXPECT_EQ((std::vector<uint32_t>{13, 14}), values);
+}
+
+TEST_F(GraphSnapshotTest, CompressedTest)
+{
+    // A long chain of nodes, spanning several blocks.
+    std::vector<Node> chain(10000);
+    for (std::size_t i = 0; i < chain.size(); ++i)
+    {
+        chain[i] = {static_cast<uint32_t>(i % 100), i + 1 < chain.size() ? &chain[i + 1] : nullptr,
+            nullptr, i ? &chain[i - 1] : nullptr};
+    }
+
+    SnapshotBuilder<WrapNode> builder{memory};
+    ASSERT_TRUE(builder.capture(chain.data(), &WrapNode::left, &WrapNode::parent));
+    ASSERT_TRUE(builder.save(kPath));
+    ASSERT_TRUE(builder.save(kOtherPath, SnapshotCompression::Lz4));
+    EXPECT_EQ(builder.serialize(SnapshotCompression::Lz4), builder.serialize(
+        SnapshotCompression::Lz4));
+
+    SnapshotFile<WrapNode> plain{kPath};
+    CompressedSnapshotFile<WrapNode> snap{kOtherPath, 2};
+    ASSERT_TRUE(snap.isValid());
+    EXPECT_FALSE(SnapshotFile<WrapNode>{kOtherPath}.isValid());
+    EXPECT_FALSE(CompressedSnapshotFile<WrapNode>{kPath}.isValid());
+    ASSERT_EQ(chain.size(), snap.size());
+    EXPECT_LT(1, snap.numBlocks());
+    EXPECT_EQ(1, snap.numRoots());
+    EXPECT_EQ(0, snap.numMisses());
+
+    // Accessing an object decompresses its block only, hot blocks stay cached.
+    EXPECT_EQ(57, snap.object(5557).value);
+    EXPECT_EQ(1, snap.numMisses());
+    auto root = snap.root(0);
+    EXPECT_EQ(0, root.value);
+    EXPECT_EQ(56, snap.object(5556).value);
+    EXPECT_EQ(2, snap.numMisses());
+
+    auto next = snap.indexOf(snap.object(5557).left);
+    ASSERT_TRUE(next.hasValue());
+    EXPECT_EQ(5558, next.value());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&chain[5558]), snap.source(next.value()));
+    EXPECT_FALSE(snap.indexOf(snap.object(9999).left).hasValue());
+    EXPECT_FALSE(snap.indexOf(&chain[0]).hasValue());
+
+    for (std::size_t i = 0; i < snap.size(); i += 7)
+    {
+        EXPECT_EQ(plain.object(i).value, snap.object(i).value);
+        EXPECT_EQ(plain.source(i), snap.source(i));
+    }
+
+    // The links and addresses are highly regular, so the data compresses well.
+    const auto plainSize = builder.serialize().size();
+    const auto compressedSize = builder.serialize(SnapshotCompression::Lz4).size();
+    EXPECT_LT(compressedSize * 5, plainSize);
+
+    // Truncated, the block index doesn't match the file size anymore.
+    auto data = builder.serialize(SnapshotCompression::Lz4);
+    data.pop_back();
+    auto f = std::fopen(kOtherPath, "wb");
+    std::fwrite(data.data(), 1, data.size(), f);
+    std::fclose(f);
+    EXPECT_FALSE(CompressedSnapshotFile<WrapNode>{kOtherPath}.isValid());
+}
+
+TEST_F(GraphSnapshotTest, Lz4Test)
+{
+    std::vector<uint8_t> data(100000);
+    uint32_t state = 1;
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        // Runs, repeats at varying distances and noise.
+        state = state * 1103515245 + 12345;
+        data[i] = i % 1000 < 300 ? 0 : i % 1000 < 700 ? data[i - 250] : (state >> 16) & 0xFF;
+    }
+
+    for (std::size_t size : {0, 1, 12, 13, 100, 5000, 100000})
+    {
+        std::vector<uint8_t> compressed;
+        internal::lz4Compress(data.data(), size, compressed);
+        std::vector<uint8_t> decompressed(size + 1, 0xCC);
+        ASSERT_TRUE(internal::lz4Decompress(compressed.data(), compressed.size(),
+            decompressed.data(), size));
+        EXPECT_TRUE(std::equal(data.begin(), data.begin() + size, decompressed.begin()));
+        EXPECT_EQ(0xCC, decompressed[size]);
+        if (size == 100000)
+        {
+            EXPECT_LT(compressed.size(), size / 2);
+        }
+
+        // Sizes not matching the contents are rejected.
+        EXPECT_FALSE(internal::lz4Decompress(compressed.data(), compressed.size(),
+            decompressed.data(), size + 1));
+        if (size)
+        {
+            EXPECT_FALSE(internal::lz4Decompress(compressed.data(), compressed.size() - 1,
+                decompressed.data(), size));
+        }
+    }
+}
+
+// ============================================================================================== //
+// [RegionSnapshot] testing                                                                       //
+// ============================================================================================== //
+
+class RegionSnapshotTest : public testing::Test
+{
+protected:
+    // Simulates write tracking for writes made through `poke`.
+    struct TrackingMemory : LocalMemory
+    {
+        bool tracking = true;
+        std::vector<uintptr_t> dirty;
+        std::size_t pagesRead = 0;
+
+        void poke(uint8_t* ptr, uint8_t value)
+        {
+            *ptr = value;
+            dirty.push_back(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t{0xFFF});
+        }
+
+        bool readBatch(const platform::IoRange* ranges, std::size_t count) override
+        {
+            for (std::size_t i = 0; i < count; ++i) pagesRead += ranges[i].size / 0x1000;
+            return LocalMemory::readBatch(ranges, count);
+        }
+
+        bool resetDirtyPages(uintptr_t, std::size_t) override
+        {
+            dirty.clear();
+            return tracking;
+        }
+
+        bool queryDirtyPages(uintptr_t, std::size_t, std::vector<uintptr_t>& pages) override
+        {
+            pages = dirty;
+            std::sort(pages.begin(), pages.end());
+            pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+            return tracking;
+        }
+    };
+
+    static const std::size_t kHeapSize = 16 * 0x1000;
+
+    // Over-aligned allocations aren't supported before C++17, so the pages are aligned by hand.
+    std::vector<uint8_t> storage = std::vector<uint8_t>(kHeapSize + 0x1000);
+    uint8_t* heap = reinterpret_cast<uint8_t*>(
+        (reinterpret_cast<uintptr_t>(storage.data()) + 0xFFF) & ~uintptr_t{0xFFF});
+    TrackingMemory memory;
+
+    std::vector<std::pair<uintptr_t, std::size_t>> changes(const RegionSnapshot& snap)
+    {
+        std::vector<std::pair<uintptr_t, std::size_t>> result;
+        snap.forEachChange([&](uintptr_t address, std::size_t size)
+        {
+            result.emplace_back(address - reinterpret_cast<uintptr_t>(heap), size);
+        });
+        return result;
+    }
+};
+
+TEST_F(RegionSnapshotTest, TrackedTest)
+{
+    RegionSnapshot snap{memory, reinterpret_cast<uintptr_t>(heap), kHeapSize};
+    ASSERT_TRUE(snap.capture());
+    EXPECT_TRUE(snap.isTracking());
+
+    memory.poke(&heap[0x1000], 1);
+    memory.poke(&heap[0x1001], 2);
+    memory.poke(&heap[0x1003], 3);
+    memory.poke(&heap[0x5FFF], 4);
+    // Rewriting the same value dirties the page without changing it.
+    memory.poke(&heap[0x9000], 0);
+
+    memory.pagesRead = 0;
+    ASSERT_TRUE(snap.refresh());
+    EXPECT_EQ(3, snap.numRefreshedPages());
+    EXPECT_EQ(3, memory.pagesRead);
+    EXPECT_EQ(2, *static_cast<uint8_t*>(snap.translate(
+        reinterpret_cast<uintptr_t>(&heap[0x1001]))));
+    using Change = std::pair<uintptr_t, std::size_t>;
+    EXPECT_EQ((std::vector<Change>{{0x1000, 2}, {0x1003, 1}, {0x5FFF, 1}}), changes(snap));
+
+    // Nothing written since.
+    ASSERT_TRUE(snap.refresh());
+    EXPECT_EQ(0, snap.numRefreshedPages());
+    EXPECT_TRUE(changes(snap).empty());
+}
+
+TEST_F(RegionSnapshotTest, UntrackedTest)
+{
+    memory.tracking = false;
+    RegionSnapshot snap{memory, reinterpret_cast<uintptr_t>(heap) + 10, 0x2000};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(heap), snap.address());
+    EXPECT_EQ(0x3000, snap.size());
+    ASSERT_TRUE(snap.capture());
+    EXPECT_FALSE(snap.isTracking());
+
+    heap[0x2FFF] = 7;
+    ASSERT_TRUE(snap.refresh());
+    EXPECT_EQ(3, snap.numRefreshedPages());
+    using Change = std::pair<uintptr_t, std::size_t>;
+    EXPECT_EQ((std::vector<Change>{{0x2FFF, 1}}), changes(snap));
+    EXPECT_EQ(nullptr, snap.translate(snap.address() + 0x2FFF, 2));
+
+    // The platform's tracking, if available, finds at least the pages written to.
+    LocalMemory local;
+    RegionSnapshot live{local, reinterpret_cast<uintptr_t>(heap), kHeapSize};
+    ASSERT_TRUE(live.capture());
+    heap[0x4000] = 9;
+    ASSERT_TRUE(live.refresh());
+    EXPECT_EQ((std::vector<Change>{{0x4000, 1}}), changes(live));
+}
+
+// ============================================================================================== //
+// [WatchSet] testing                                                                             //
+// ============================================================================================== //
+
+class WatchSetTest : public testing::Test
+{
+protected:
+    struct Dog
+    {
+        int32_t age;
+        float weight;
+        uint8_t padding[200];
+        int64_t tag;
+    };
+
+    struct WrapDog : AdvancedClassWrapper<sizeof(Dog)>
+    {
+        REMODEL_ADV_WRAPPER(WrapDog)
+    public:
+        Field<int32_t> age   {this, offsetof(Dog, age)};
+        Field<float>   weight{this, offsetof(Dog, weight)};
+        Field<int64_t> tag   {this, offsetof(Dog, tag)};
+    };
+
+    struct CountingMemory : LocalMemory
+    {
+        int submits = 0;
+        bool readBatch(const platform::IoRange* ranges, std::size_t count) override
+        {
+            ++submits;
+            return LocalMemory::readBatch(ranges, count);
+        }
+    };
+
+    CountingMemory memory;
+};
+
+TEST_F(WatchSetTest, LocalTest)
+{
+    alignas(64) Dog dogs[2] = {};
+    auto dog = wrapper_cast<WrapDog>(&dogs[0]);
+    auto other = wrapper_cast<WrapDog>(&dogs[1]);
+
+    WatchSet watches{memory};
+    std::vector<std::string> events;
+    watches.watch(dog.age, [&](int32_t oldAge, int32_t newAge) {
+        events.push_back("age " + std::to_string(oldAge) + " -> " + std::to_string(newAge));
+    });
+    watches.watch(dog.weight, [&](float, float) { events.push_back("weight"); });
+    auto tagId = watches.watch(dog.tag, [&](int64_t, int64_t) { events.push_back("tag"); });
+    watches.watch(other.age, [&](int32_t, int32_t) { events.push_back("other age"); });
+    EXPECT_EQ(4, watches.size());
+    // Age and weight share the first line, the tag and the other dog's age the fourth one.
+    EXPECT_EQ(2 * 64, watches.bytesPerPoll());
+
+    // The first poll only records the values.
+    dogs[0].age = 3;
+    ASSERT_TRUE(watches.poll());
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(1, memory.submits);
+
+    dogs[0].age = 4;
+    dogs[0].tag = 7;
+    ASSERT_TRUE(watches.poll());
+    EXPECT_EQ((std::vector<std::string>{"age 3 -> 4", "tag"}), events);
+    EXPECT_EQ(2, memory.submits);
+
+    // Changes made while watches are removed aren't lost.
+    events.clear();
+    dogs[0].weight = 1.5f;
+    dogs[1].age = 1;
+    EXPECT_TRUE(watches.unwatch(tagId));
+    EXPECT_FALSE(watches.unwatch(tagId));
+    ASSERT_TRUE(watches.poll());
+    EXPECT_EQ((std::vector<std::string>{"weight", "other age"}), events);
+
+    events.clear();
+    ASSERT_TRUE(watches.poll());
+    EXPECT_TRUE(events.empty());
+}
+
+TEST_F(WatchSetTest, RemoteTest)
+{
+    Dog dogs[64] = {};
+    std::vector<RemoteSnapshot<WrapDog>> snaps;
+    for (auto& cur : dogs) snaps.emplace_back(memory, reinterpret_cast<uintptr_t>(&cur));
+
+    // Per page, so all dogs are read with a single range.
+    WatchSet watches{memory, 4096};
+    int changes = 0;
+    for (auto& snap : snaps) watches.watch(snap, snap.age, [&](int32_t, int32_t) { ++changes; });
+    ASSERT_TRUE(watches.poll());
+
+    for (std::size_t i = 0; i < 64; i += 3) ++dogs[i].age;
+    ASSERT_TRUE(watches.poll());
+    EXPECT_EQ(22, changes);
+    EXPECT_EQ(2, memory.submits);
+}
+
+// ============================================================================================== //
+// [HardwareWatch] testing                                                                        //
+// ============================================================================================== //
+
+class HardwareWatchTest : public testing::Test
+{
+protected:
+    struct Cat
+    {
+        int32_t lives;
+        uint8_t mood;
+        int16_t misaligned[2];
+    };
+
+    struct WrapCat : AdvancedClassWrapper<sizeof(Cat)>
+    {
+        REMODEL_ADV_WRAPPER(WrapCat)
+    public:
+        Field<int32_t> lives{this, offsetof(Cat, lives)};
+        Field<uint8_t> mood {this, offsetof(Cat, mood)};
+    };
+};
+
+#if defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+
+TEST_F(HardwareWatchTest, WriteTest)
+{
+    alignas(8) Cat cat = {};
+    auto wrapped = wrapper_cast<WrapCat>(&cat);
+
+    HardwareWatch watch;
+    static std::atomic<int> hits, lastLives;
+    hits = 0;
+    lastLives = 0;
+    auto id = watch.watch(wrapped.lives, [](int32_t lives) { ++hits; lastLives = lives; });
+    if (!id.hasValue()) return; // Perf events not permitted (e.g. in sandboxes).
+
+    wrapped.lives = 9;
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(9, lastLives);
+
+    std::thread{[&] { wrapped.lives = 8; }}.join();
+    EXPECT_EQ(2, hits);
+    EXPECT_EQ(8, lastLives);
+
+    // Reads and writes of other fields don't trigger.
+    int32_t lives = wrapped.lives;
+    wrapped.mood = 1;
+    EXPECT_EQ(8, lives);
+    EXPECT_EQ(2, hits);
+
+    EXPECT_TRUE(watch.unwatch(id.value()));
+    EXPECT_FALSE(watch.unwatch(id.value()));
+    wrapped.lives = 7;
+    EXPECT_EQ(2, hits);
+}
+
+TEST_F(HardwareWatchTest, LimitTest)
+{
+    alignas(8) Cat cats[HardwareWatch::kNumSlots + 1] = {};
+
+    HardwareWatch watch;
+    auto first = watch.watch(reinterpret_cast<uintptr_t>(&cats[0].lives), 4, [](uintptr_t) {});
+    if (!first.hasValue()) return;
+    for (std::size_t i = 1; i < HardwareWatch::kNumSlots; ++i)
+    {
+        EXPECT_TRUE(watch.watch(
+            reinterpret_cast<uintptr_t>(&cats[i].lives), 4, [](uintptr_t) {}).hasValue());
+    }
+    EXPECT_EQ(std::size_t{HardwareWatch::kNumSlots}, watch.size());
+    EXPECT_FALSE(watch.watch(
+        reinterpret_cast<uintptr_t>(&cats[HardwareWatch::kNumSlots].lives), 4,
+        [](uintptr_t) {}).hasValue());
+
+    // Slots are freed on unwatch and destruction.
+    EXPECT_TRUE(watch.unwatch(first.value()));
+    {
+        HardwareWatch other;
+        EXPECT_TRUE(other.watch(reinterpret_cast<uintptr_t>(&cats[0].lives), 4,
+            [](uintptr_t) {}).hasValue());
+        EXPECT_FALSE(watch.watch(reinterpret_cast<uintptr_t>(&cats[0].mood), 1,
+            [](uintptr_t) {}).hasValue());
+    }
+    EXPECT_TRUE(watch.watch(reinterpret_cast<uintptr_t>(&cats[0].mood), 1,
+        [](uintptr_t) {}).hasValue());
+}
+
+#endif // defined(REMODEL_HARDWARE_WATCH_SUPPORTED)
+
+TEST_F(HardwareWatchTest, RejectTest)
+{
+    alignas(8) Cat cat = {};
+    HardwareWatch watch;
+
+    // Unaligned or oddly sized ranges are left to polling.
+    auto address = reinterpret_cast<uintptr_t>(&cat.misaligned[0]) + 1;
+    EXPECT_FALSE(watch.watch(address, 2, [](uintptr_t) {}).hasValue());
+    EXPECT_FALSE(watch.watch(reinterpret_cast<uintptr_t>(&cat), 3, [](uintptr_t) {}).hasValue());
+    EXPECT_FALSE(watch.watch(reinterpret_cast<uintptr_t>(&cat), 16, [](uintptr_t) {}).hasValue());
+    EXPECT_EQ(0, watch.size());
+}
+
+// ============================================================================================== //
+// [Profile] testing                                                                              //
+// ============================================================================================== //
+
+#if defined(REMODEL_PROFILE)
+
+class ProfileTest : public testing::Test
+{
+protected:
+    struct Cat
+    {
+        int32_t lives;
+        int32_t mood;
+    };
+
+    class WrapCat : public AdvancedClassWrapper<sizeof(Cat)>
+    {
+        REMODEL_ADV_WRAPPER(WrapCat)
+    public:
+        Field<int32_t> lives{this, offsetof(Cat, lives)};
+        StaticField<int32_t, offsetof(Cat, mood)> mood{this};
+    };
+
+    static int purr(int x) { return x + 1; }
+
+    static uint64_t countOf(
+        const std::vector<profile::Entry>& entries, const char* wrapper, std::ptrdiff_t offset)
+    {
+        for (const auto& entry : entries)
+        {
+            if (entry.wrapper == wrapper && entry.offset == offset) return entry.count;
+        }
+        return 0;
+    }
+
+    void SetUp() override { profile::reset(); }
+};
+
+TEST_F(ProfileTest, CountTest)
+{
+    Cat cat = {9, 0};
+    auto wrapper = wrapper_cast<WrapCat>(&cat);
+    for (int i = 0; i < 3; ++i) wrapper.mood += wrapper.lives;
+    EXPECT_EQ(27, cat.mood);
+
+    // Exited threads keep their counts.
+    std::thread{[&] { EXPECT_EQ(9, wrapper.lives); }}.join();
+
+    Function<int (*)(int)> wrapPurr{&purr};
+    EXPECT_EQ(2, wrapPurr(1));
+
+    auto entries = profile::collect();
+    EXPECT_EQ(4, countOf(entries, "WrapCat", offsetof(Cat, lives)));
+    EXPECT_EQ(3, countOf(entries, "WrapCat", offsetof(Cat, mood)));
+    EXPECT_EQ(1, countOf(entries, "", reinterpret_cast<intptr_t>(&purr)));
+    ASSERT_FALSE(entries.empty());
+    EXPECT_EQ(4, entries.front().count);
+
+    profile::reset();
+    EXPECT_TRUE(profile::collect().empty());
+}
+
+TEST_F(ProfileTest, ExportTest)
+{
+    Cat cat = {9, 0};
+    auto wrapper = wrapper_cast<WrapCat>(&cat);
+    wrapper.mood = 1;
+
+    auto entries = profile::collect();
+    ASSERT_EQ(1, entries.size());
+    EXPECT_EQ("kind,wrapper,offset,count\nfield,WrapCat,0x4,1\n", profile::toCsv(entries));
+    EXPECT_EQ(
+        "{\"traceEvents\":[{\"name\":\"WrapCat+0x4\",\"cat\":\"field\",\"ph\":\"C\","
+        "\"ts\":0,\"pid\":0,\"args\":{\"count\":1}}]}",
+        profile::toChromeTrace(entries));
+}
+
+#endif // defined(REMODEL_PROFILE)
+
+// ============================================================================================== //
+// [Checked] testing                                                                              //
+// ============================================================================================== //
+
+#if defined(REMODEL_CHECKED)
+
+class CheckedTest : public testing::Test
+{
+protected:
+    struct Cat
+    {
+        int32_t lives;
+        int32_t mood;
+        uint16_t whiskers[4];
+    };
+
+    class WrapCat : public AdvancedClassWrapper<sizeof(Cat)>
+    {
+        REMODEL_ADV_WRAPPER(WrapCat)
+    public:
+        Field<int32_t> lives{this, offsetof(Cat, lives)};
+        Field<int32_t> mood{this, offsetof(Cat, mood)};
+        Field<uint16_t[4]> whiskers{this, offsetof(Cat, whiskers)};
+    };
+
+    // Describes a `Cat` with a wrong offset and an object size that is too small.
+    class WrapBrokenCat : public AdvancedClassWrapper<6>
+    {
+        REMODEL_ADV_WRAPPER(WrapBrokenCat)
+    public:
+        Field<int32_t> lives{this, 4};
+        StaticField<int32_t, offsetof(Cat, mood)> mood{this};
+    };
+
+    class WrapPackedCat : public AdvancedClassWrapper<sizeof(Cat)>
+    {
+        REMODEL_ADV_WRAPPER(WrapPackedCat)
+    public:
+        Field<int32_t, OffsGetter, access::Unaligned> lives{this, offsetof(Cat, lives)};
+    };
+
+    static std::vector<checked::Violation>& violations()
+    {
+        static std::vector<checked::Violation> recorded;
+        return recorded;
+    }
+
+    static void record(checked::Violation violation, const void*)
+    {
+        violations().push_back(violation);
+    }
+
+    void SetUp() override
+    {
+        violations().clear();
+        m_previous = checked::setFailureHandler(&record);
+    }
+
+    void TearDown() override
+    {
+        checked::setFailureHandler(m_previous);
+    }
+
+    checked::FailureHandler m_previous = nullptr;
+};
+
+TEST_F(CheckedTest, ValidLayoutTest)
+{
+    Cat cat = {9, 3, {1, 2, 3, 4}};
+    auto wrapper = wrapper_cast<WrapCat>(&cat);
+    wrapper.lives = 8;
+    EXPECT_EQ(3, wrapper.mood);
+    EXPECT_EQ(4, wrapper.whiskers[3]);
+    EXPECT_EQ(8, cat.lives);
+    EXPECT_TRUE(violations().empty());
+}
+
+TEST_F(CheckedTest, BoundsTest)
+{
+    Cat cat = {9, 3, {}};
+    auto wrapper = wrapper_cast<WrapBrokenCat>(&cat);
+    EXPECT_EQ(
+        (std::vector<checked::Violation>{checked::Violation::Bounds, checked::Violation::Bounds}),
+        violations());
+
+    // Accesses of fields starting inside the object are checked as well.
+    violations().clear();
+    wrapper.lives = 1;
+    EXPECT_EQ(std::vector<checked::Violation>{checked::Violation::Bounds}, violations());
+}
+
+TEST_F(CheckedTest, AlignmentTest)
+{
+    alignas(8) uint8_t bytes[16] = {};
+    auto wrapper = wrapper_cast<WrapCat>(bytes + 1);
+    (void)static_cast<int32_t>(wrapper.lives);
+    EXPECT_EQ(std::vector<checked::Violation>{checked::Violation::Alignment}, violations());
+
+    // Unaligned accesses are declared as such.
+    violations().clear();
+    wrapper_cast<WrapPackedCat>(bytes + 1).lives = 5;
+    EXPECT_TRUE(violations().empty());
+}
+
+TEST_F(CheckedTest, IndexTest)
+{
+    Cat cats[3] = {};
+    auto wrapper = wrapper_cast<WrapCat>(&cats[0]);
+    (void)static_cast<uint16_t>(wrapper.whiskers[3]);
+    EXPECT_TRUE(violations().empty());
+    (void)static_cast<uint16_t>(wrapper.whiskers[4]);
+    EXPECT_EQ(std::vector<checked::Violation>{checked::Violation::Index}, violations());
+
+    violations().clear();
+    WrapperRange<WrapCat> range{cats, 3};
+    range[2].lives = 1;
+    EXPECT_TRUE(violations().empty());
+    auto past = range[3];
+    (void)past;
+    EXPECT_EQ(std::vector<checked::Violation>{checked::Violation::Index}, violations());
+}
+
+#endif // defined(REMODEL_CHECKED)
+
+// ============================================================================================== //
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// ============================================================================================== //
+// [RemoteCallBatch] testing                                                                      //
+// ============================================================================================== //
+
+class RemoteCallTest : public testing::Test
+{
+protected:
+    static uintptr_t answer() { return 42; }
+    static uintptr_t add(uintptr_t a, uintptr_t b) { return a + b; }
+    static uintptr_t sum6(uintptr_t a, uintptr_t b, uintptr_t c, uintptr_t d, uintptr_t e, 
+        uintptr_t f)
+    {
+        return a + b + c + d + e + f;
+    }
+
+    LocalMemory memory;
+    std::vector<uint64_t> buffer = std::vector<uint64_t>(
+        RemoteCallBatch::bufferSize(4) / sizeof(uint64_t));
+    int executions = 0;
+
+    RemoteCallBatch::Executor executor()
+    {
+        return [this](uintptr_t address)
+        {
+            ++executions;
+            runRemoteCallBatch(reinterpret_cast<void*>(address));
+            return true;
+        };
+    }
+};
+
+TEST_F(RemoteCallTest, BatchTest)
+{
+    RemoteCallBatch batch{memory, reinterpret_cast<uintptr_t>(buffer.data()), 4, executor()};
+    EXPECT_TRUE(batch.add(reinterpret_cast<uintptr_t>(&answer)));
+    EXPECT_TRUE(batch.add(reinterpret_cast<uintptr_t>(&add), 1, 2));
+    EXPECT_TRUE(batch.add(reinterpret_cast<uintptr_t>(&add), Ptr32<void>{0x1000}, -1));
+    EXPECT_TRUE(batch.add(reinterpret_cast<uintptr_t>(&sum6), 1, 2, 3, 4, 5, 6));
+    EXPECT_FALSE(batch.add(reinterpret_cast<uintptr_t>(&answer)));
+    EXPECT_EQ(4u, batch.size());
+
+    ASSERT_TRUE(batch.run());
+    EXPECT_EQ(1, executions);
+    EXPECT_EQ(42u, batch.result(0));
+    EXPECT_EQ(3u, batch.result(1));
+    EXPECT_EQ(0xFFFu, static_cast<uintptr_t>(batch.result(2)));
+    EXPECT_EQ(21u, batch.result(3));
+
+    batch.clear();
+    EXPECT_TRUE(batch.run());
+    EXPECT_EQ(2, executions);
+}
+
+TEST_F(RemoteCallTest, FailureTest)
+{
+    RemoteCallBatch batch{memory, reinterpret_cast<uintptr_t>(buffer.data()), 4, 
+        [](uintptr_t) { return false; }};
+    EXPECT_TRUE(batch.add(reinterpret_cast<uintptr_t>(&answer)));
+    EXPECT_FALSE(batch.run());
+}
+
+// ============================================================================================== //
+// [parallelForEach] testing                                                                      //
+// ============================================================================================== //
+
+class ParallelTest : public testing::Test
+{
+protected:
+    struct A
+    {
+        int32_t x;
+        int16_t y;
+    };
+
+    class WrapA : public AdvancedClassWrapper<sizeof(A)>
+    {
+        REMODEL_ADV_WRAPPER(WrapA)
+    public:
+        StaticField<int32_t, offsetof(A, x)> x{this};
+        StaticField<int16_t, offsetof(A, y)> y{this};
+    };
+protected:
+    std::vector<A> a = std::vector<A>(100000);
+};
+
+TEST_F(ParallelTest, WrapperRangeTest)
+{
+    for (std::size_t i = 0; i < a.size(); ++i) a[i].x = static_cast<int32_t>(i);
+
+    WrapperRange<WrapA> range{a.data() + 1, a.size() - 2};
+    parallelForEach(range, [](WrapA& cur) { cur.x = cur.x * 2; }, 8);
+    EXPECT_EQ(0, a.front().x);
+    EXPECT_EQ(static_cast<int32_t>(a.size() - 1), a.back().x);
+    for (std::size_t i = 1; i < a.size() - 1; ++i)
+    {
+        ASSERT_EQ(static_cast<int32_t>(i * 2), a[i].x);
+    }
+
+    // Objects larger than chunks.
+    std::vector<uint8_t> large(10 * 5000);
+    std::atomic<int> visited{0};
+    parallelForEach(WrapperRange<WrapA>{large.data(), 10, 5000}, 
+        [&](WrapA& cur) { ++cur.x; ++visited; }, 4);
+    EXPECT_EQ(10, visited);
+    EXPECT_EQ(1, wrapper_cast<WrapA>(&large[9 * 5000]).x);
+
+    parallelForEach(WrapperRange<WrapA>{a.data(), 0}, [](WrapA&) { FAIL(); });
+}
+
+TEST_F(ParallelTest, FieldSpanTest)
+{
+    auto ys = makeFieldSpan(WrapperRange<WrapA>{a.data(), a.size()}, &WrapA::y);
+    parallelForEach(ys, [](int16_t& y) { y += 3; }, 8);
+    EXPECT_TRUE(std::all_of(a.begin(), a.end(), [](const A& cur) { return cur.y == 3; }));
+}
+
+// ============================================================================================== //
+// [Query] testing                                                                                //
+// ============================================================================================== //
+
+class QueryTest : public testing::Test
+{
+protected:
+    struct E
+    {
+        int32_t hp;
+        uint8_t team;
+        float   speed;
+    };
+
+    class WrapE : public AdvancedClassWrapper<sizeof(E)>
+    {
+        REMODEL_ADV_WRAPPER(WrapE)
+    public:
+        StaticField<int32_t, offsetof(E, hp)>    hp   {this};
+        StaticField<uint8_t, offsetof(E, team)>  team {this};
+        StaticField<float,   offsetof(E, speed)> speed{this};
+    };
+protected:
+    QueryTest()
+    {
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            e[i] = {i % 50, static_cast<uint8_t>(i % 3), static_cast<float>(i) / 4.f};
+        }
+    }
+protected:
+    E e[1000];
+    WrapperRange<WrapE> range{e, 1000};
+};
+
+TEST_F(QueryTest, PredicateTest)
+{
+    auto span = [&](auto field) { return makeFieldSpan(range, field); };
+    auto query = where(span(&WrapE::hp) < 10).and_(span(&WrapE::team) == 2);
+
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        if (e[i].hp < 10 && e[i].team == 2) expected.push_back(i);
+    }
+    EXPECT_EQ(expected, query.indices());
+    EXPECT_EQ(expected.size(), query.count());
+
+    query.or_(span(&WrapE::speed) >= 249.5f);
+    EXPECT_TRUE(query.matches(998));
+    EXPECT_TRUE(query.matches(999));
+    EXPECT_FALSE(query.matches(997));
+    EXPECT_EQ(expected.size() + 2, query.count());
+
+    int32_t sum = 0;
+    query.forEach(range, [&](WrapE& cur) { sum += cur.hp; });
+    int32_t expectedSum = 48 + 49;
+    for (auto idx : expected) expectedSum += e[idx].hp;
+    EXPECT_EQ(expectedSum, sum);
+
+    EXPECT_EQ(1000u, where(span(&WrapE::hp) != 50).count());
+    EXPECT_EQ(20u, where(span(&WrapE::hp) <= 0).count());
+    EXPECT_EQ(0u, where(span(&WrapE::speed) > 1000.f).count());
+}
+
+TEST_F(QueryTest, CompareMaskTest)
+{
+    const int32_t ints[6] = {1, 5, 3, 5, -7, 9};
+    EXPECT_EQ(0x15u, simd::compareMask(ints, 6, simd::CompareOp::Less, 5));
+    EXPECT_EQ(0x1Fu, simd::compareMask(ints, 6, simd::CompareOp::LessEqual, 5));
+    EXPECT_EQ(0x20u, simd::compareMask(ints, 6, simd::CompareOp::Greater, 5));
+    EXPECT_EQ(0x2Au, simd::compareMask(ints, 6, simd::CompareOp::GreaterEqual, 5));
+    EXPECT_EQ(0x0Au, simd::compareMask(ints, 6, simd::CompareOp::Equal, 5));
+    EXPECT_EQ(0x35u, simd::compareMask(ints, 6, simd::CompareOp::NotEqual, 5));
+
+    std::vector<uint16_t> shorts(64, 7);
+    EXPECT_EQ(~uint64_t{0}, simd::compareMask(shorts.data(), 64, simd::CompareOp::Equal, 
+        uint16_t{7}));
+}
+
+// ============================================================================================== //
+// [Table] testing                                                                                //
+// ============================================================================================== //
+
+class TableTest : public testing::Test
+{
+protected:
+    struct E
+    {
+        int32_t hp;
+        uint8_t team;
+        float   speed;
+        int32_t ticks;
+    };
+
+    class WrapE : public AdvancedClassWrapper<sizeof(E)>
+    {
+        REMODEL_ADV_WRAPPER(WrapE)
+    public:
+        StaticField<int32_t, offsetof(E, hp)>   hp  {this};
+        StaticField<uint8_t, offsetof(E, team)> team{this};
+
+        REMODEL_FIELDS(
+            (speed, float,   offsetof(E, speed)),
+            (ticks, int32_t, offsetof(E, ticks))
+        )
+    };
+protected:
+    TableTest()
+    {
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            e[i] = {i % 50, static_cast<uint8_t>(i % 3), static_cast<float>(i) / 4.f, 0};
+        }
+    }
+protected:
+    E e[1000];
+    Table<WrapE> table{e, 1000};
+};
+
+TEST_F(TableTest, RowTest)
+{
+    EXPECT_EQ(1000u, table.size());
+    EXPECT_EQ(sizeof(E), table.stride());
+    EXPECT_EQ(7, table[7].hp);
+    EXPECT_FLOAT_EQ(2.f, table[8].speed());
+
+    int32_t sum = 0;
+    for (auto& row : table.slice(10, 5)) sum += row.hp;
+    EXPECT_EQ(10 + 11 + 12 + 13 + 14, sum);
+    EXPECT_EQ(e + 990, table.slice(990, 10).base());
+}
+
+TEST_F(TableTest, ColumnTest)
+{
+    auto hps = table.column(&WrapE::hp);
+    EXPECT_EQ(1000u, hps.size());
+    EXPECT_EQ(49, hps[49]);
+
+    // Columns of the `REMODEL_FIELDS` layout and raw ones.
+    auto speeds = table.column<0>();
+    static_assert(std::is_same<FieldSpan<float>, decltype(speeds)>::value, "bad column type");
+    EXPECT_FLOAT_EQ(249.75f, speeds[999]);
+    EXPECT_EQ(2, table.column<uint8_t>(offsetof(E, team))[5]);
+
+    auto fast = where(table.column<0>() >= 249.5f).and_(table.column(&WrapE::team) == 0);
+    EXPECT_EQ(1u, fast.count());
+    table.forEach(fast, [](WrapE& row) { row.hp = 100; });
+    EXPECT_EQ(100, e[999].hp);
+    EXPECT_EQ(48, e[998].hp);
+}
+
+TEST_F(TableTest, ParallelTest)
+{
+    parallelForEach(table, [](WrapE& row) { row.ticks() += row.hp; });
+    int64_t sum = 0;
+    for (const auto& cur : e) sum += cur.ticks;
+    EXPECT_EQ(20 * (49 * 50 / 2), sum);
+}
+
+// ============================================================================================== //
+// [StreamingTable] testing                                                                       //
+// ============================================================================================== //
+
+class StreamingTableTest : public TableTest
+{
+protected:
+    // Records which threads read, failing reads at and beyond an address.
+    struct ReaderMemory : LocalMemory
+    {
+        std::atomic<uintptr_t> failAt{~uintptr_t{0}};
+        std::atomic<int> numReads{0};
+        std::atomic<int> numForeignReads{0};
+        std::thread::id mainThread = std::this_thread::get_id();
+
+        bool read(uintptr_t address, void* out, std::size_t size) override
+        {
+            ++numReads;
+            if (std::this_thread::get_id() != mainThread) ++numForeignReads;
+            if (address + size > failAt) return false;
+            return LocalMemory::read(address, out, size);
+        }
+    };
+
+    ReaderMemory memory;
+};
+
+TEST_F(StreamingTableTest, ScanTest)
+{
+    StreamingTable<WrapE> stream{memory, reinterpret_cast<uintptr_t>(e), 1000, sizeof(E), 64};
+    EXPECT_EQ(sizeof(E), stream.stride());
+    EXPECT_EQ(16, stream.numChunks());
+
+    std::vector<std::size_t> firsts;
+    int32_t sum = 0;
+    ASSERT_TRUE(stream.forEachChunk([&](const Table<WrapE>& chunk, std::size_t first)
+    {
+        firsts.push_back(first);
+        EXPECT_EQ(first + 64 <= 1000 ? 64 : 1000 - first, chunk.size());
+        EXPECT_NE(static_cast<void*>(&e[first]), chunk.base());
+        for (auto& row : chunk) sum += row.hp;
+    }));
+    ASSERT_EQ(16, firsts.size());
+    EXPECT_EQ(960, firsts.back());
+    EXPECT_EQ(20 * (49 * 50 / 2), sum);
+    EXPECT_EQ(16, memory.numReads);
+    EXPECT_EQ(16, memory.numForeignReads);
+
+    // Changes to the copies don't reach the array.
+    float speed = 0.f;
+    ASSERT_TRUE(stream.forEach([&](WrapE& cur)
+    {
+        speed += cur.speed();
+        cur.hp = -1;
+    }));
+    EXPECT_FLOAT_EQ(999.f * 1000.f / 2.f / 4.f, speed);
+    EXPECT_EQ(49, e[999].hp);
+
+    // A single chunk is read without a reader thread.
+    StreamingTable<WrapE> small{memory, reinterpret_cast<uintptr_t>(e), 10};
+    EXPECT_EQ(1, small.numChunks());
+    int numRows = 0;
+    ASSERT_TRUE(small.forEach([&](WrapE&) { ++numRows; }));
+    EXPECT_EQ(10, numRows);
+    EXPECT_EQ(2 * 16, memory.numForeignReads);
+
+    StreamingTable<WrapE> empty{memory, reinterpret_cast<uintptr_t>(e), 0};
+    EXPECT_TRUE(empty.forEach([&](WrapE&) { ADD_FAILURE(); }));
+}
+
+TEST_F(StreamingTableTest, FailureTest)
+{
+    // Reading the fifth chunk fails, the four before it are processed.
+    memory.failAt = reinterpret_cast<uintptr_t>(&e[4 * 100 + 50]);
+    StreamingTable<WrapE> stream{memory, reinterpret_cast<uintptr_t>(e), 1000, sizeof(E), 100};
+    std::vector<std::size_t> firsts;
+    EXPECT_FALSE(stream.forEachChunk([&](const Table<WrapE>&, std::size_t first)
+    {
+        firsts.push_back(first);
+    }));
+    EXPECT_EQ((std::vector<std::size_t>{0, 100, 200, 300}), firsts);
+
+    // The failure isn't sticky.
+    memory.failAt = ~uintptr_t{0};
+    memory.numReads = 0;
+    EXPECT_TRUE(stream.forEachChunk([&](const Table<WrapE>&, std::size_t) {}));
+    EXPECT_EQ(10, memory.numReads);
+}
+
+// ============================================================================================== //
+// [WrapperStats] testing                                                                         //
+// ============================================================================================== //
+
+class WrapperStatsTest : public testing::Test
+{
+protected:
+    struct WrapStatic : AdvancedClassWrapper<16>
+    {
+        REMODEL_ADV_WRAPPER(WrapStatic)
+    public:
+        StaticField<int, 0> a{this};
+        StaticField<int, 4> b{this};
+    };
+
+    struct WrapDynamic : ClassWrapper
+    {
+        REMODEL_WRAPPER(WrapDynamic)
+    public:
+        Field<int> a{this, 0};
+        Field<int> b{this, 4};
+        Field<int, OffsGetter> c{this, 8};
+    };
+
+    static uint64_t fakeAllocations()
+    {
+        static uint64_t numCalls = 0;
+        return numCalls++ * 500;
+    }
+};
+
+TEST_F(WrapperStatsTest, StatsTest)
+{
+    auto fixed = stats<WrapStatic>("WrapStatic");
+    EXPECT_EQ("WrapStatic", fixed.name);
+    EXPECT_EQ(sizeof(WrapStatic), fixed.wrapperSize);
+    EXPECT_EQ(sizeof(WrapStatic) - sizeof(internal::WrapperBase), fixed.fieldBytes);
+    EXPECT_EQ(16, fixed.objSize);
+    EXPECT_EQ(sizeof(WrapStatic::Instantiable), fixed.instantiableSize);
+    EXPECT_EQ(sizeof(WrapStatic::Instantiable) - 16, fixed.instantiableOverhead());
+    EXPECT_LT(fixed.allocationsPerCast, 0.);
+    EXPECT_GE(fixed.castNanoseconds, 0.);
+
+    auto dynamic = stats<WrapDynamic>("WrapDynamic", &fakeAllocations, 1000);
+    EXPECT_EQ(0, dynamic.objSize);
+    EXPECT_EQ(0, dynamic.instantiableOverhead());
+    EXPECT_DOUBLE_EQ(0.5, dynamic.allocationsPerCast);
+    EXPECT_GT(dynamic.fieldBytes, fixed.fieldBytes);
+
+#   if defined(REMODEL_PROFILE)
+        EXPECT_TRUE(fixed.hasFieldCounts);
+        EXPECT_EQ(2, fixed.numFields);
+        EXPECT_EQ(0, fixed.getterBytes);
+        EXPECT_EQ(3, dynamic.numFields);
+        // Plain `Field`s store a type-erased getter.
+        EXPECT_EQ(2 * sizeof(std::function<void*(void*)>) + sizeof(OffsGetter),
+            dynamic.getterBytes);
+#   else
+        EXPECT_FALSE(fixed.hasFieldCounts);
+#   endif
+
+    const auto text = toText({fixed, dynamic});
+    EXPECT_EQ(3, std::count(text.begin(), text.end(), '\n'));
+    EXPECT_NE(std::string::npos, text.find("WrapStatic"));
+    EXPECT_NE(std::string::npos, text.find("0.50"));
+}
+
+// ============================================================================================== //
+// [Recorder] testing                                                                             //
+// ============================================================================================== //
+
+class RecorderTest : public testing::Test
+{
+protected:
+    struct E
+    {
+        int32_t  hp;
+        uint16_t flags;
+        float    x;
+    };
+
+    class WrapE : public AdvancedClassWrapper<sizeof(E)>
+    {
+        REMODEL_ADV_WRAPPER(WrapE)
+    public:
+        StaticField<int32_t,  offsetof(E, hp)>    hp   {this};
+        StaticField<uint16_t, offsetof(E, flags)> flags{this};
+        StaticField<float,    offsetof(E, x)>     x    {this};
+    };
+protected:
+    void step(uint64_t tick)
+    {
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            e[i] = {hpAt(i, tick), static_cast<uint16_t>(tick % 7 ? 0xFFFF : i),
+                static_cast<float>(tick) * 0.5f - i};
+        }
+    }
+
+    static int32_t hpAt(int32_t object, uint64_t tick)
+    {
+        return 1000 - object * 3 - static_cast<int32_t>(tick) * (object % 2 ? 1 : -1);
+    }
+protected:
+    E e[100];
+    WrapperRange<WrapE> range{e, 100};
+};
+
+TEST_F(RecorderTest, RoundTripTest)
+{
+    Recorder<WrapE> recorder{range, 4, 16};
+    auto hp = recorder.record(&WrapE::hp);
+    auto flags = recorder.record(&WrapE::flags);
+    auto x = recorder.record(&WrapE::x);
+
+    std::size_t sunk = 0;
+    recorder.setSink([&](const RecorderBlock& block)
+    {
+        EXPECT_EQ(16u, block.numTicks);
+        EXPECT_EQ(100u, block.numObjects());
+        ++sunk;
+    });
+
+    for (uint64_t tick = 0; tick < 100; ++tick)
+    {
+        step(tick);
+        recorder.sample();
+    }
+    EXPECT_EQ(100u, recorder.ticks());
+    EXPECT_EQ(18u, sunk);
+
+    // 6 blocks completed, the 2 oldest were dropped; ticks 96..99 are still raw.
+    EXPECT_EQ(32u, recorder.firstRetainedTick());
+    std::vector<int32_t> hps;
+    EXPECT_FALSE(recorder.query(hp, 5, 31, 40, hps));
+    EXPECT_TRUE(hps.empty());
+    EXPECT_FALSE(recorder.query(hp, 5, 40, 101, hps));
+
+    ASSERT_TRUE(recorder.query(hp, 5, 40, 100, hps));
+    ASSERT_EQ(60u, hps.size());
+    for (uint64_t tick = 40; tick < 100; ++tick)
+    {
+        EXPECT_EQ(hpAt(5, tick), hps[tick - 40]);
+    }
+
+    std::vector<uint16_t> flagValues;
+    ASSERT_TRUE(recorder.query(flags, 9, 60, 65, flagValues));
+    EXPECT_EQ((std::vector<uint16_t>{0xFFFF, 0xFFFF, 0xFFFF, 9, 0xFFFF}), flagValues);
+
+    std::vector<float> xs;
+    ASSERT_TRUE(recorder.query(x, 99, 90, 100, xs));
+    ASSERT_EQ(10u, xs.size());
+    EXPECT_EQ(45.f - 99, xs.front());
+    EXPECT_EQ(49.5f - 99, xs.back());
+}
+
+TEST_F(RecorderTest, BoundedTest)
+{
+    Recorder<WrapE> recorder{range, 2, 64};
+    auto hp = recorder.record(&WrapE::hp);
+
+    std::size_t peak = 0;
+    for (uint64_t tick = 0; tick < 64 * 10; ++tick)
+    {
+        step(tick);
+        recorder.sample();
+        peak = (std::max)(peak, recorder.memoryUsage());
+    }
+    EXPECT_EQ(peak, recorder.memoryUsage());
+
+    // Slowly changing values encode to a byte per sample, plus one for the first of each object.
+    EXPECT_EQ(64u * 100 * 8 + 2 * (65 * 100 + 101 * 4), recorder.memoryUsage());
+
+    recorder.flush();
+    std::vector<int32_t> hps;
+    EXPECT_TRUE(recorder.query(hp, 0, 64 * 8, 64 * 10, hps));
+    EXPECT_EQ(hpAt(0, 64 * 10 - 1), hps.back());
 }